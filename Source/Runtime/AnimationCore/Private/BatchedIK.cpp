@@ -0,0 +1,342 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BatchedIK.h"
+#include "Async/ParallelFor.h"
+#include "TwoBoneIK.h"
+
+namespace AnimationCore
+{
+	namespace BatchedIK
+	{
+		// Number of vector registers of chains solved by each parallel task
+		static const int32 NumGroupsPerTask = 16;
+
+		// Positions of NumLanes chains
+		struct FVector3Lanes
+		{
+			VectorRegister4Double X;
+			VectorRegister4Double Y;
+			VectorRegister4Double Z;
+		};
+
+		static FORCEINLINE FVector3Lanes Load(const FIKPositionStreams& Streams, int32 Index)
+		{
+			return { VectorLoad(&Streams.X[Index]), VectorLoad(&Streams.Y[Index]), VectorLoad(&Streams.Z[Index]) };
+		}
+
+		static FORCEINLINE void Store(const FVector3Lanes& V, FIKPositionStreams& Streams, int32 Index)
+		{
+			VectorStore(V.X, &Streams.X[Index]);
+			VectorStore(V.Y, &Streams.Y[Index]);
+			VectorStore(V.Z, &Streams.Z[Index]);
+		}
+
+		static FORCEINLINE FVector3Lanes Subtract(const FVector3Lanes& A, const FVector3Lanes& B)
+		{
+			return { VectorSubtract(A.X, B.X), VectorSubtract(A.Y, B.Y), VectorSubtract(A.Z, B.Z) };
+		}
+
+		static FORCEINLINE FVector3Lanes Scale(const FVector3Lanes& V, const VectorRegister4Double& S)
+		{
+			return { VectorMultiply(V.X, S), VectorMultiply(V.Y, S), VectorMultiply(V.Z, S) };
+		}
+
+		// Returns A + V * S
+		static FORCEINLINE FVector3Lanes MultiplyAdd(const FVector3Lanes& V, const VectorRegister4Double& S, const FVector3Lanes& A)
+		{
+			return { VectorMultiplyAdd(V.X, S, A.X), VectorMultiplyAdd(V.Y, S, A.Y), VectorMultiplyAdd(V.Z, S, A.Z) };
+		}
+
+		static FORCEINLINE VectorRegister4Double Dot(const FVector3Lanes& A, const FVector3Lanes& B)
+		{
+			return VectorMultiplyAdd(A.X, B.X, VectorMultiplyAdd(A.Y, B.Y, VectorMultiply(A.Z, B.Z)));
+		}
+
+		static FORCEINLINE FVector3Lanes Cross(const FVector3Lanes& A, const FVector3Lanes& B)
+		{
+			return {
+				VectorSubtract(VectorMultiply(A.Y, B.Z), VectorMultiply(A.Z, B.Y)),
+				VectorSubtract(VectorMultiply(A.Z, B.X), VectorMultiply(A.X, B.Z)),
+				VectorSubtract(VectorMultiply(A.X, B.Y), VectorMultiply(A.Y, B.X))
+			};
+		}
+
+		static FORCEINLINE FVector3Lanes Select(const VectorRegister4Double& Mask, const FVector3Lanes& A, const FVector3Lanes& B)
+		{
+			return { VectorSelect(Mask, A.X, B.X), VectorSelect(Mask, A.Y, B.Y), VectorSelect(Mask, A.Z, B.Z) };
+		}
+
+		// Returns V / |V|, like FVector::GetUnsafeNormal
+		static FORCEINLINE FVector3Lanes UnsafeNormal(const FVector3Lanes& V)
+		{
+			return Scale(V, VectorReciprocalSqrt(Dot(V, V)));
+		}
+
+		// Solves NumLanes chains starting at Index, see SolveTwoBoneIK
+		static void SolveTwoBoneIKLanes(FTwoBoneIKBatch& Batch, int32 Index, bool bAllowStretching, double StartStretchRatio, double MaxStretchScale)
+		{
+			const VectorRegister4Double SmallNumber = VectorSetFloat1(DOUBLE_KINDA_SMALL_NUMBER);
+			const VectorRegister4Double SmallNumberSquared = VectorSetFloat1(FMath::Square(DOUBLE_KINDA_SMALL_NUMBER));
+			const VectorRegister4Double Zero = VectorZeroDouble();
+			const VectorRegister4Double One = VectorOneDouble();
+
+			const FVector3Lanes RootPos = Load(Batch.RootPos, Index);
+			const FVector3Lanes Effector = Load(Batch.Effector, Index);
+			VectorRegister4Double UpperLimbLength = VectorLoad(&Batch.UpperLimbLength[Index]);
+			VectorRegister4Double LowerLimbLength = VectorLoad(&Batch.LowerLimbLength[Index]);
+
+			const FVector3Lanes DesiredDelta = Subtract(Effector, RootPos);
+			const VectorRegister4Double DesiredLength = VectorSqrt(Dot(DesiredDelta, DesiredDelta));
+			const FVector3Lanes JointTargetDelta = Subtract(Load(Batch.JointTarget, Index), RootPos);
+
+			// Degenerate chains pick fallback directions, solve them one at a time
+			const FVector3Lanes DesiredDir = Scale(DesiredDelta, VectorDivide(One, DesiredLength));
+			const FVector3Lanes JointPlaneNormal = Cross(DesiredDir, JointTargetDelta);
+			const VectorRegister4Double DegenerateMask = VectorBitwiseOr(VectorCompareLT(DesiredLength, SmallNumber),
+				VectorBitwiseOr(VectorCompareLT(Dot(JointTargetDelta, JointTargetDelta), SmallNumberSquared), VectorCompareLT(Dot(JointPlaneNormal, JointPlaneNormal), SmallNumberSquared)));
+			if (VectorMaskBits(DegenerateMask))
+			{
+				const int32 EndIndex = FMath::Min(Index + FIKPositionStreams::NumLanes, Batch.Num());
+				for (int32 ChainIndex = Index; ChainIndex < EndIndex; ++ChainIndex)
+				{
+					FVector OutJointPos, OutEndPos;
+					SolveTwoBoneIK(Batch.RootPos.Get(ChainIndex), Batch.JointPos.Get(ChainIndex), FVector::ZeroVector, Batch.JointTarget.Get(ChainIndex), Batch.Effector.Get(ChainIndex),
+						OutJointPos, OutEndPos, Batch.UpperLimbLength[ChainIndex], Batch.LowerLimbLength[ChainIndex], bAllowStretching, StartStretchRatio, MaxStretchScale);
+					Batch.OutJointPos.Set(ChainIndex, OutJointPos);
+					Batch.OutEndPos.Set(ChainIndex, OutEndPos);
+				}
+				return;
+			}
+
+			// Remove any component of JointTargetDelta along DesiredDir
+			FVector3Lanes JointBendDir = MultiplyAdd(DesiredDir, VectorNegate(Dot(JointTargetDelta, DesiredDir)), JointTargetDelta);
+			JointBendDir = UnsafeNormal(JointBendDir);
+
+			VectorRegister4Double MaxLimbLength = VectorAdd(LowerLimbLength, UpperLimbLength);
+
+			if (bAllowStretching)
+			{
+				const double ScaleRange = MaxStretchScale - StartStretchRatio;
+				if (ScaleRange > DOUBLE_KINDA_SMALL_NUMBER)
+				{
+					const VectorRegister4Double ReachRatio = VectorDivide(DesiredLength, MaxLimbLength);
+					const VectorRegister4Double Alpha = VectorMin(VectorMax(VectorDivide(VectorSubtract(ReachRatio, VectorSetFloat1(StartStretchRatio)), VectorSetFloat1(ScaleRange)), Zero), One);
+					const VectorRegister4Double ScalingFactor = VectorMultiply(VectorSetFloat1(MaxStretchScale - 1.0), Alpha);
+					const VectorRegister4Double StretchMask = VectorBitwiseAnd(VectorCompareGT(MaxLimbLength, SmallNumber), VectorCompareGT(ScalingFactor, SmallNumber));
+					const VectorRegister4Double Stretch = VectorSelect(StretchMask, VectorAdd(One, ScalingFactor), One);
+					LowerLimbLength = VectorMultiply(LowerLimbLength, Stretch);
+					UpperLimbLength = VectorMultiply(UpperLimbLength, Stretch);
+					MaxLimbLength = VectorMultiply(MaxLimbLength, Stretch);
+				}
+			}
+
+			// Out of reach, extend the limb fully towards the effector
+			const VectorRegister4Double OutOfReachMask = VectorCompareGE(DesiredLength, MaxLimbLength);
+			const FVector3Lanes ReachEndPos = MultiplyAdd(DesiredDir, MaxLimbLength, RootPos);
+			const FVector3Lanes ReachJointPos = MultiplyAdd(DesiredDir, UpperLimbLength, RootPos);
+
+			// Within reach, solve the triangle of known side lengths. Sin(Acos(CosAngle)) is computed as Sqrt(1 - CosAngle^2).
+			const VectorRegister4Double TwoAB = VectorMultiply(VectorSetFloat1(2.0), VectorMultiply(UpperLimbLength, DesiredLength));
+			const VectorRegister4Double Numerator = VectorSubtract(VectorMultiplyAdd(UpperLimbLength, UpperLimbLength, VectorMultiply(DesiredLength, DesiredLength)), VectorMultiply(LowerLimbLength, LowerLimbLength));
+			VectorRegister4Double CosAngle = VectorSelect(VectorCompareNE(TwoAB, Zero), VectorDivide(Numerator, TwoAB), Zero);
+			CosAngle = VectorMin(VectorMax(CosAngle, VectorNegate(One)), One);
+			const VectorRegister4Double SinAngle = VectorSqrt(VectorMax(VectorSubtract(One, VectorMultiply(CosAngle, CosAngle)), Zero));
+			const VectorRegister4Double JointLineDist = VectorMultiply(UpperLimbLength, SinAngle);
+			const VectorRegister4Double ProjJointDist = VectorMultiply(UpperLimbLength, CosAngle);
+			const FVector3Lanes SolvedJointPos = MultiplyAdd(JointBendDir, JointLineDist, MultiplyAdd(DesiredDir, ProjJointDist, RootPos));
+
+			Store(Select(OutOfReachMask, ReachEndPos, Effector), Batch.OutEndPos, Index);
+			Store(Select(OutOfReachMask, ReachJointPos, SolvedJointPos), Batch.OutJointPos, Index);
+		}
+
+		// Solves NumLanes chains starting at Index, see SolveFabrik
+		static void SolveFabrikLanes(FFabrikBatch& Batch, int32 Index, double Precision, int32 MaxIterations)
+		{
+			const int32 NumLinks = Batch.NumLinks();
+			const int32 TipBoneLinkIndex = NumLinks - 1;
+			const VectorRegister4Double PrecisionLanes = VectorSetFloat1(Precision);
+
+			const FVector3Lanes TargetPosition = Load(Batch.TargetPosition, Index);
+			const VectorRegister4Double MaximumReach = VectorLoad(&Batch.MaximumReach[Index]);
+
+			auto LoadLength = [&Batch, Index](int32 LinkIndex)
+			{
+				return VectorLoad(&Batch.Lengths[LinkIndex][Index]);
+			};
+
+			// Moves the links selected by Mask to Length from Anchor, towards their current position or Direction
+			auto PlaceLink = [&Batch, Index](const VectorRegister4Double& Mask, int32 LinkIndex, const FVector3Lanes& Anchor, const FVector3Lanes& Direction, const VectorRegister4Double& Length)
+			{
+				const FVector3Lanes Position = Load(Batch.Positions[LinkIndex], Index);
+				Store(Select(Mask, MultiplyAdd(UnsafeNormal(Direction), Length, Anchor), Position), Batch.Positions[LinkIndex], Index);
+			};
+
+			// If the effector is further away than the distance from root to tip, simply move all bones in a line from root to effector location
+			const FVector3Lanes RootToTarget = Subtract(Load(Batch.Positions[0], Index), TargetPosition);
+			const VectorRegister4Double OutOfReachMask = VectorCompareGT(Dot(RootToTarget, RootToTarget), VectorMultiply(MaximumReach, MaximumReach));
+			if (VectorMaskBits(OutOfReachMask))
+			{
+				for (int32 LinkIndex = 1; LinkIndex < NumLinks; LinkIndex++)
+				{
+					const FVector3Lanes ParentPosition = Load(Batch.Positions[LinkIndex - 1], Index);
+					PlaceLink(OutOfReachMask, LinkIndex, ParentPosition, Subtract(TargetPosition, ParentPosition), LoadLength(LinkIndex));
+				}
+			}
+
+			// Effector is within reach, iterate chains whose tip is not at the effector yet
+			const FVector3Lanes TipToTarget = Subtract(Load(Batch.Positions[TipBoneLinkIndex], Index), TargetPosition);
+			VectorRegister4Double Slop = VectorSqrt(Dot(TipToTarget, TipToTarget));
+			const VectorRegister4Double SolveMask = VectorBitwiseAnd(VectorCompareLE(Dot(RootToTarget, RootToTarget), VectorMultiply(MaximumReach, MaximumReach)), VectorCompareGT(Slop, PrecisionLanes));
+			if (VectorMaskBits(SolveMask))
+			{
+				Store(Select(SolveMask, TargetPosition, Load(Batch.Positions[TipBoneLinkIndex], Index)), Batch.Positions[TipBoneLinkIndex], Index);
+
+				const VectorRegister4Double TipLength = LoadLength(TipBoneLinkIndex);
+				VectorRegister4Double IterateMask = SolveMask;
+				int32 IterationCount = 0;
+				while (VectorMaskBits(IterateMask) && (IterationCount++ < MaxIterations))
+				{
+					// "Forward Reaching" stage - adjust bones from end effector.
+					for (int32 LinkIndex = TipBoneLinkIndex - 1; LinkIndex > 0; LinkIndex--)
+					{
+						const FVector3Lanes ChildPosition = Load(Batch.Positions[LinkIndex + 1], Index);
+						PlaceLink(IterateMask, LinkIndex, ChildPosition, Subtract(Load(Batch.Positions[LinkIndex], Index), ChildPosition), LoadLength(LinkIndex + 1));
+					}
+
+					// "Backward Reaching" stage - adjust bones from root.
+					for (int32 LinkIndex = 1; LinkIndex < TipBoneLinkIndex; LinkIndex++)
+					{
+						const FVector3Lanes ParentPosition = Load(Batch.Positions[LinkIndex - 1], Index);
+						PlaceLink(IterateMask, LinkIndex, ParentPosition, Subtract(Load(Batch.Positions[LinkIndex], Index), ParentPosition), LoadLength(LinkIndex));
+					}
+
+					// Re-check distance between the tip's parent and the effector
+					const FVector3Lanes ParentToTarget = Subtract(Load(Batch.Positions[TipBoneLinkIndex - 1], Index), TargetPosition);
+					Slop = VectorSelect(IterateMask, VectorAbs(VectorSubtract(TipLength, VectorSqrt(Dot(ParentToTarget, ParentToTarget)))), Slop);
+					IterateMask = VectorBitwiseAnd(IterateMask, VectorCompareGT(Slop, PrecisionLanes));
+				}
+
+				// Place tip bone based on how close we got to target.
+				const FVector3Lanes ParentPosition = Load(Batch.Positions[TipBoneLinkIndex - 1], Index);
+				PlaceLink(SolveMask, TipBoneLinkIndex, ParentPosition, Subtract(Load(Batch.Positions[TipBoneLinkIndex], Index), ParentPosition), TipLength);
+			}
+
+			const int32 ModifiedMask = VectorMaskBits(VectorBitwiseOr(OutOfReachMask, SolveMask));
+			const int32 EndIndex = FMath::Min(Index + FIKPositionStreams::NumLanes, Batch.Num());
+			for (int32 ChainIndex = Index; ChainIndex < EndIndex; ++ChainIndex)
+			{
+				Batch.bModified[ChainIndex] = (ModifiedMask & (1 << (ChainIndex - Index))) != 0;
+			}
+		}
+
+		// Runs Solve on every group of NumLanes chains, NumGroupsPerTask groups per task
+		template<typename SolveType>
+		static void ForEachLaneGroup(int32 NumChains, bool bAllowParallel, SolveType Solve)
+		{
+			const int32 NumGroups = FMath::DivideAndRoundUp(NumChains, FIKPositionStreams::NumLanes);
+			const int32 NumTasks = FMath::DivideAndRoundUp(NumGroups, NumGroupsPerTask);
+			ParallelFor(NumTasks, [NumGroups, &Solve](int32 TaskIndex)
+			{
+				const int32 EndGroup = FMath::Min((TaskIndex + 1) * NumGroupsPerTask, NumGroups);
+				for (int32 Group = TaskIndex * NumGroupsPerTask; Group < EndGroup; ++Group)
+				{
+					Solve(Group * FIKPositionStreams::NumLanes);
+				}
+			}, bAllowParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+		}
+
+		static void SetNumPadded(TArray<double>& Stream, int32 Num)
+		{
+			Stream.Reset();
+			Stream.SetNumZeroed(Align(Num, FIKPositionStreams::NumLanes));
+		}
+	}
+
+	void FIKPositionStreams::SetNum(int32 InNumPositions)
+	{
+		NumPositions = InNumPositions;
+		BatchedIK::SetNumPadded(X, InNumPositions);
+		BatchedIK::SetNumPadded(Y, InNumPositions);
+		BatchedIK::SetNumPadded(Z, InNumPositions);
+	}
+
+	void FTwoBoneIKBatch::SetNum(int32 NumChains)
+	{
+		RootPos.SetNum(NumChains);
+		JointPos.SetNum(NumChains);
+		JointTarget.SetNum(NumChains);
+		Effector.SetNum(NumChains);
+		BatchedIK::SetNumPadded(UpperLimbLength, NumChains);
+		BatchedIK::SetNumPadded(LowerLimbLength, NumChains);
+		OutJointPos.SetNum(NumChains);
+		OutEndPos.SetNum(NumChains);
+	}
+
+	void FTwoBoneIKBatch::SetChain(int32 Index, const FVector& InRootPos, const FVector& InJointPos, const FVector& InEndPos, const FVector& InJointTarget, const FVector& InEffector)
+	{
+		SetChain(Index, InRootPos, InJointPos, InJointTarget, InEffector, (InJointPos - InRootPos).Size(), (InEndPos - InJointPos).Size());
+	}
+
+	void FTwoBoneIKBatch::SetChain(int32 Index, const FVector& InRootPos, const FVector& InJointPos, const FVector& InJointTarget, const FVector& InEffector, double InUpperLimbLength, double InLowerLimbLength)
+	{
+		RootPos.Set(Index, InRootPos);
+		JointPos.Set(Index, InJointPos);
+		JointTarget.Set(Index, InJointTarget);
+		Effector.Set(Index, InEffector);
+		UpperLimbLength[Index] = InUpperLimbLength;
+		LowerLimbLength[Index] = InLowerLimbLength;
+	}
+
+	void FFabrikBatch::SetNum(int32 NumChains, int32 InNumLinks)
+	{
+		check(InNumLinks >= 2);
+		Positions.SetNum(InNumLinks);
+		Lengths.SetNum(InNumLinks);
+		for (int32 LinkIndex = 0; LinkIndex < InNumLinks; ++LinkIndex)
+		{
+			Positions[LinkIndex].SetNum(NumChains);
+			BatchedIK::SetNumPadded(Lengths[LinkIndex], NumChains);
+		}
+		TargetPosition.SetNum(NumChains);
+		BatchedIK::SetNumPadded(MaximumReach, NumChains);
+		bModified.Reset();
+		bModified.SetNumZeroed(NumChains);
+	}
+
+	void FFabrikBatch::SetChain(int32 Index, const TArray<FFABRIKChainLink>& Chain, const FVector& InTargetPosition, double InMaximumReach)
+	{
+		check(Chain.Num() == NumLinks());
+		for (int32 LinkIndex = 0; LinkIndex < Chain.Num(); ++LinkIndex)
+		{
+			Positions[LinkIndex].Set(Index, Chain[LinkIndex].Position);
+			Lengths[LinkIndex][Index] = Chain[LinkIndex].Length;
+		}
+		TargetPosition.Set(Index, InTargetPosition);
+		MaximumReach[Index] = InMaximumReach;
+	}
+
+	void FFabrikBatch::GetChain(int32 Index, TArray<FFABRIKChainLink>& InOutChain) const
+	{
+		check(InOutChain.Num() == NumLinks());
+		for (int32 LinkIndex = 0; LinkIndex < InOutChain.Num(); ++LinkIndex)
+		{
+			InOutChain[LinkIndex].Position = Positions[LinkIndex].Get(Index);
+		}
+	}
+
+	void SolveTwoBoneIKBatch(FTwoBoneIKBatch& Batch, bool bAllowStretching, double StartStretchRatio, double MaxStretchScale, bool bAllowParallel)
+	{
+		BatchedIK::ForEachLaneGroup(Batch.Num(), bAllowParallel, [&Batch, bAllowStretching, StartStretchRatio, MaxStretchScale](int32 Index)
+		{
+			BatchedIK::SolveTwoBoneIKLanes(Batch, Index, bAllowStretching, StartStretchRatio, MaxStretchScale);
+		});
+	}
+
+	void SolveFabrikBatch(FFabrikBatch& Batch, double Precision, int32 MaxIterations, bool bAllowParallel)
+	{
+		BatchedIK::ForEachLaneGroup(Batch.Num(), bAllowParallel, [&Batch, Precision, MaxIterations](int32 Index)
+		{
+			BatchedIK::SolveFabrikLanes(Batch, Index, Precision, MaxIterations);
+		});
+	}
+}
@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AnimationCore.h"
+#include "BatchedIK.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "TwoBoneIK.h"
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+namespace AnimationCore::BatchedIKBenchmark
+{
+	static const int32 NumFabrikLinks = 4;
+
+	// Random leg-like chains, with effectors both within and out of reach.
+	static void InitChains(FRandomStream& Random, int32 NumChains, FTwoBoneIKBatch& OutTwoBoneBatch, FFabrikBatch& OutFabrikBatch, TArray<TArray<FFABRIKChainLink>>& OutFabrikChains)
+	{
+		OutTwoBoneBatch.SetNum(NumChains);
+		OutFabrikBatch.SetNum(NumChains, NumFabrikLinks);
+		OutFabrikChains.SetNum(NumChains);
+		for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+		{
+			const FVector RootPos(Random.FRandRange(-1000.f, 1000.f), Random.FRandRange(-1000.f, 1000.f), 100.f);
+			const FVector JointPos = RootPos + FVector(Random.FRandRange(-5.f, 5.f), Random.FRandRange(5.f, 10.f), -45.f);
+			const FVector EndPos = JointPos + FVector(Random.FRandRange(-5.f, 5.f), Random.FRandRange(-10.f, -5.f), -45.f);
+			const FVector Effector = EndPos + Random.GetUnitVector() * Random.FRandRange(0.f, 40.f);
+			OutTwoBoneBatch.SetChain(ChainIndex, RootPos, JointPos, EndPos, JointPos + FVector(0.f, 50.f, 0.f), Effector);
+
+			TArray<FFABRIKChainLink>& Chain = OutFabrikChains[ChainIndex];
+			Chain.Reset();
+			double MaximumReach = 0.0;
+			FVector Position = RootPos;
+			for (int32 LinkIndex = 0; LinkIndex < NumFabrikLinks; ++LinkIndex)
+			{
+				const double Length = LinkIndex > 0 ? Random.FRandRange(20.f, 40.f) : 0.0;
+				Position += Random.GetUnitVector() * Length;
+				Chain.Add(FFABRIKChainLink(Position, Length, LinkIndex, LinkIndex));
+				MaximumReach += Length;
+			}
+			OutFabrikBatch.SetChain(ChainIndex, Chain, Position + Random.GetUnitVector() * Random.FRandRange(0.f, 60.f), MaximumReach);
+		}
+	}
+
+	static double GetTwoBoneMaxError(const FTwoBoneIKBatch& Batch, bool bAllowStretching)
+	{
+		double MaxError = 0.0;
+		for (int32 ChainIndex = 0; ChainIndex < Batch.Num(); ++ChainIndex)
+		{
+			FVector OutJointPos, OutEndPos;
+			SolveTwoBoneIK(Batch.RootPos.Get(ChainIndex), Batch.JointPos.Get(ChainIndex), FVector::ZeroVector, Batch.JointTarget.Get(ChainIndex), Batch.Effector.Get(ChainIndex),
+				OutJointPos, OutEndPos, Batch.UpperLimbLength[ChainIndex], Batch.LowerLimbLength[ChainIndex], bAllowStretching, 0.9, 1.1);
+			MaxError = FMath::Max(MaxError, (OutJointPos - Batch.OutJointPos.Get(ChainIndex)).GetAbsMax());
+			MaxError = FMath::Max(MaxError, (OutEndPos - Batch.OutEndPos.Get(ChainIndex)).GetAbsMax());
+		}
+		return MaxError;
+	}
+
+	static double GetFabrikMaxError(const FFabrikBatch& Batch, const TArray<TArray<FFABRIKChainLink>>& Chains)
+	{
+		double MaxError = 0.0;
+		for (int32 ChainIndex = 0; ChainIndex < Batch.Num(); ++ChainIndex)
+		{
+			for (int32 LinkIndex = 0; LinkIndex < Batch.NumLinks(); ++LinkIndex)
+			{
+				MaxError = FMath::Max(MaxError, (Chains[ChainIndex][LinkIndex].Position - Batch.Positions[LinkIndex].Get(ChainIndex)).GetAbsMax());
+			}
+		}
+		return MaxError;
+	}
+
+	static void RunBatchedIKBenchmark(const TArray<FString>& Args)
+	{
+		int32 Iterations = 100;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Iterations="), Iterations);
+		}
+		Iterations = FMath::Clamp(Iterations, 1, 100000);
+
+		const double Precision = 1.0;
+		const int32 MaxIterations = 10;
+
+		UE_LOG(LogAnimationCore, Display, TEXT("Batched IK benchmark: two bone chains and FABRIK chains of %d links, %d iterations. Cost is the average time per batch, in microseconds."),
+			NumFabrikLinks, Iterations);
+		UE_LOG(LogAnimationCore, Display, TEXT("%8s %10s %10s %10s %10s %10s %10s %10s %10s"), TEXT("Chains"), TEXT("TwoBone"), TEXT("Batched"), TEXT("Parallel"), TEXT("Error"),
+			TEXT("FABRIK"), TEXT("Batched"), TEXT("Parallel"), TEXT("Error"));
+
+		for (const int32 NumChains : { 100, 500, 1000, 5000 })
+		{
+			FRandomStream Random(1234);
+			FTwoBoneIKBatch TwoBoneBatch;
+			FFabrikBatch FabrikBatch;
+			TArray<TArray<FFABRIKChainLink>> FabrikChains;
+			InitChains(Random, NumChains, TwoBoneBatch, FabrikBatch, FabrikChains);
+
+			// Two bone IK doesn't modify its inputs, so every run solves the same chains.
+			const double TwoBoneCost = UE::TimeAverageDuration(Iterations, [&]()
+			{
+				for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+				{
+					FVector OutJointPos, OutEndPos;
+					SolveTwoBoneIK(TwoBoneBatch.RootPos.Get(ChainIndex), TwoBoneBatch.JointPos.Get(ChainIndex), FVector::ZeroVector, TwoBoneBatch.JointTarget.Get(ChainIndex), TwoBoneBatch.Effector.Get(ChainIndex),
+						OutJointPos, OutEndPos, TwoBoneBatch.UpperLimbLength[ChainIndex], TwoBoneBatch.LowerLimbLength[ChainIndex], true, 0.9, 1.1);
+					TwoBoneBatch.OutJointPos.Set(ChainIndex, OutJointPos);
+					TwoBoneBatch.OutEndPos.Set(ChainIndex, OutEndPos);
+				}
+			});
+			const double TwoBoneBatchedCost = UE::TimeAverageDuration(Iterations, [&]() { SolveTwoBoneIKBatch(TwoBoneBatch, true, 0.9, 1.1, false); });
+			const double TwoBoneParallelCost = UE::TimeAverageDuration(Iterations, [&]() { SolveTwoBoneIKBatch(TwoBoneBatch, true, 0.9, 1.1, true); });
+			const double TwoBoneError = GetTwoBoneMaxError(TwoBoneBatch, true);
+
+			// FABRIK solves in place, so every run restores the initial chains first. Copying is included in all costs.
+			const FFabrikBatch InitialFabrikBatch = FabrikBatch;
+			const TArray<TArray<FFABRIKChainLink>> InitialFabrikChains = FabrikChains;
+			const double FabrikCost = UE::TimeAverageDuration(Iterations, [&]()
+			{
+				for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+				{
+					FabrikChains[ChainIndex] = InitialFabrikChains[ChainIndex];
+					SolveFabrik(FabrikChains[ChainIndex], InitialFabrikBatch.TargetPosition.Get(ChainIndex), InitialFabrikBatch.MaximumReach[ChainIndex], Precision, MaxIterations);
+				}
+			});
+			const double FabrikBatchedCost = UE::TimeAverageDuration(Iterations, [&]()
+			{
+				FabrikBatch.Positions = InitialFabrikBatch.Positions;
+				SolveFabrikBatch(FabrikBatch, Precision, MaxIterations, false);
+			});
+			const double FabrikParallelCost = UE::TimeAverageDuration(Iterations, [&]()
+			{
+				FabrikBatch.Positions = InitialFabrikBatch.Positions;
+				SolveFabrikBatch(FabrikBatch, Precision, MaxIterations, true);
+			});
+			const double FabrikError = GetFabrikMaxError(FabrikBatch, FabrikChains);
+
+			UE_LOG(LogAnimationCore, Display, TEXT("%8d %10.2f %10.2f %10.2f %10.1e %10.2f %10.2f %10.2f %10.1e"), NumChains, TwoBoneCost * 1000000.0, TwoBoneBatchedCost * 1000000.0, TwoBoneParallelCost * 1000000.0, TwoBoneError,
+				FabrikCost * 1000000.0, FabrikBatchedCost * 1000000.0, FabrikParallelCost * 1000000.0, FabrikError);
+		}
+	}
+}
+
+static FAutoConsoleCommand BatchedIKBenchmarkCmd(
+	TEXT("a.BatchedIK.Benchmark"),
+	TEXT("Compares the cost of solving 100 to 5000 two bone and FABRIK chains one at a time, batched, and batched in parallel. Usage: a.BatchedIK.Benchmark [Iterations=100]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&AnimationCore::BatchedIKBenchmark::RunBatchedIKBenchmark));
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
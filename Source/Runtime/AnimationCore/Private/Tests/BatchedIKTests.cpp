@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BatchedIK.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "TwoBoneIK.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchedIKTestTwoBone, "System.AnimationCore.BatchedIK.TwoBone", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool FBatchedIKTestTwoBone::RunTest(const FString& Parameters)
+{
+	using namespace AnimationCore;
+
+	// Not a multiple of the lane count, with some degenerate chains solved one at a time
+	const int32 NumChains = 103;
+	FRandomStream Random(1234);
+	FTwoBoneIKBatch Batch;
+	Batch.SetNum(NumChains);
+	for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+	{
+		const FVector RootPos = Random.GetUnitVector() * 100.f;
+		const FVector JointPos = RootPos + Random.GetUnitVector() * Random.FRandRange(10.f, 50.f);
+		const FVector EndPos = JointPos + Random.GetUnitVector() * Random.FRandRange(10.f, 50.f);
+		const FVector Effector = ChainIndex % 17 == 0 ? RootPos : RootPos + Random.GetUnitVector() * Random.FRandRange(0.f, 120.f);
+		const FVector JointTarget = ChainIndex % 13 == 0 ? RootPos : JointPos + Random.GetUnitVector() * 50.f;
+		Batch.SetChain(ChainIndex, RootPos, JointPos, EndPos, JointTarget, Effector);
+	}
+
+	for (const bool bAllowStretching : { false, true })
+	{
+		SolveTwoBoneIKBatch(Batch, bAllowStretching, 0.9, 1.2);
+		for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+		{
+			FVector OutJointPos, OutEndPos;
+			SolveTwoBoneIK(Batch.RootPos.Get(ChainIndex), Batch.JointPos.Get(ChainIndex), FVector::ZeroVector, Batch.JointTarget.Get(ChainIndex), Batch.Effector.Get(ChainIndex),
+				OutJointPos, OutEndPos, Batch.UpperLimbLength[ChainIndex], Batch.LowerLimbLength[ChainIndex], bAllowStretching, 0.9, 1.2);
+			UTEST_TRUE(TEXT("Batched two bone IK joint position"), OutJointPos.Equals(Batch.OutJointPos.Get(ChainIndex), 1.e-6));
+			UTEST_TRUE(TEXT("Batched two bone IK end position"), OutEndPos.Equals(Batch.OutEndPos.Get(ChainIndex), 1.e-6));
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchedIKTestFabrik, "System.AnimationCore.BatchedIK.Fabrik", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool FBatchedIKTestFabrik::RunTest(const FString& Parameters)
+{
+	using namespace AnimationCore;
+
+	const int32 NumChains = 37;
+	const int32 NumLinks = 5;
+	const double Precision = 0.01;
+	const int32 MaxIterations = 20;
+
+	FRandomStream Random(4321);
+	FFabrikBatch Batch;
+	Batch.SetNum(NumChains, NumLinks);
+	TArray<TArray<FFABRIKChainLink>> Chains;
+	Chains.SetNum(NumChains);
+	for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+	{
+		TArray<FFABRIKChainLink>& Chain = Chains[ChainIndex];
+		FVector Position = Random.GetUnitVector() * 100.f;
+		double MaximumReach = 0.0;
+		for (int32 LinkIndex = 0; LinkIndex < NumLinks; ++LinkIndex)
+		{
+			const double Length = LinkIndex > 0 ? Random.FRandRange(10.f, 30.f) : 0.0;
+			Position += Random.GetUnitVector() * Length;
+			Chain.Add(FFABRIKChainLink(Position, Length, LinkIndex, LinkIndex));
+			MaximumReach += Length;
+		}
+
+		// Some targets are out of reach and some are already reached
+		const FVector TargetPosition = ChainIndex % 7 == 0 ? Position : Position + Random.GetUnitVector() * Random.FRandRange(0.f, 80.f);
+		Batch.SetChain(ChainIndex, Chain, TargetPosition, MaximumReach);
+	}
+
+	SolveFabrikBatch(Batch, Precision, MaxIterations);
+
+	TArray<FFABRIKChainLink> BatchedChain;
+	for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+	{
+		TArray<FFABRIKChainLink>& Chain = Chains[ChainIndex];
+		const bool bModified = SolveFabrik(Chain, Batch.TargetPosition.Get(ChainIndex), Batch.MaximumReach[ChainIndex], Precision, MaxIterations);
+		UTEST_EQUAL(TEXT("Batched FABRIK modified chain"), Batch.bModified[ChainIndex], bModified);
+
+		BatchedChain = Chain;
+		Batch.GetChain(ChainIndex, BatchedChain);
+		for (int32 LinkIndex = 0; LinkIndex < NumLinks; ++LinkIndex)
+		{
+			UTEST_TRUE(TEXT("Batched FABRIK link position"), Chain[LinkIndex].Position.Equals(BatchedChain[LinkIndex].Position, 1.e-6));
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
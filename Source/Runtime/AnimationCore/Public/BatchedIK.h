@@ -0,0 +1,135 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FABRIK.h"
+
+namespace AnimationCore
+{
+	/**
+	 * Positions of many independent chains stored as a structure of arrays, with one array per component. Arrays are
+	 * padded to a multiple of NumLanes so batched solvers process NumLanes chains per vector register.
+	 */
+	struct FIKPositionStreams
+	{
+		/** Number of chains processed together. Padding holds zero positions, which are solved but never read back. */
+		static constexpr int32 NumLanes = 4;
+
+		TArray<double> X;
+		TArray<double> Y;
+		TArray<double> Z;
+
+		int32 Num() const
+		{
+			return NumPositions;
+		}
+
+		/** Resizes the streams, setting all positions to zero */
+		ANIMATIONCORE_API void SetNum(int32 InNumPositions);
+
+		FVector Get(int32 Index) const
+		{
+			return FVector(X[Index], Y[Index], Z[Index]);
+		}
+
+		void Set(int32 Index, const FVector& Position)
+		{
+			X[Index] = Position.X;
+			Y[Index] = Position.Y;
+			Z[Index] = Position.Z;
+		}
+
+	private:
+		int32 NumPositions = 0;
+	};
+
+	/** Independent two bone IK chains, solved together by SolveTwoBoneIKBatch */
+	struct FTwoBoneIKBatch
+	{
+		FIKPositionStreams RootPos;
+		FIKPositionStreams JointPos;
+		FIKPositionStreams JointTarget;
+		FIKPositionStreams Effector;
+		TArray<double> UpperLimbLength;
+		TArray<double> LowerLimbLength;
+
+		/** Solved positions */
+		FIKPositionStreams OutJointPos;
+		FIKPositionStreams OutEndPos;
+
+		int32 Num() const
+		{
+			return RootPos.Num();
+		}
+
+		/** Resizes the batch, setting all chains to zero */
+		ANIMATIONCORE_API void SetNum(int32 NumChains);
+
+		/** Sets the inputs of a chain, with limb lengths measured from its current positions like SolveTwoBoneIK */
+		ANIMATIONCORE_API void SetChain(int32 Index, const FVector& InRootPos, const FVector& InJointPos, const FVector& InEndPos, const FVector& InJointTarget, const FVector& InEffector);
+
+		/** Sets the inputs of a chain with explicit limb lengths */
+		ANIMATIONCORE_API void SetChain(int32 Index, const FVector& InRootPos, const FVector& InJointPos, const FVector& InJointTarget, const FVector& InEffector, double InUpperLimbLength, double InLowerLimbLength);
+	};
+
+	/** Independent FABRIK chains with the same number of links, solved together by SolveFabrikBatch */
+	struct FFabrikBatch
+	{
+		/** Positions of every chain, indexed by link */
+		TArray<FIKPositionStreams> Positions;
+
+		/** Distance of each link to its parent, indexed by link then chain */
+		TArray<TArray<double>> Lengths;
+
+		FIKPositionStreams TargetPosition;
+		TArray<double> MaximumReach;
+
+		/** Whether the solver modified each chain, like the result of SolveFabrik */
+		TArray<bool> bModified;
+
+		int32 Num() const
+		{
+			return TargetPosition.Num();
+		}
+
+		int32 NumLinks() const
+		{
+			return Positions.Num();
+		}
+
+		/** Resizes the batch, setting all chains to zero. Chains need at least 2 links. */
+		ANIMATIONCORE_API void SetNum(int32 NumChains, int32 InNumLinks);
+
+		/** Sets the inputs of a chain from the links passed to SolveFabrik, which must have NumLinks links */
+		ANIMATIONCORE_API void SetChain(int32 Index, const TArray<FFABRIKChainLink>& Chain, const FVector& InTargetPosition, double InMaximumReach);
+
+		/** Copies the solved positions of a chain to its links */
+		ANIMATIONCORE_API void GetChain(int32 Index, TArray<FFABRIKChainLink>& InOutChain) const;
+	};
+
+	/**
+	 * Solves every chain of the batch like SolveTwoBoneIK, several chains per vector register and across task graph workers.
+	 * Chains whose effector or joint target is degenerate are solved with SolveTwoBoneIK. Results match SolveTwoBoneIK
+	 * within floating point tolerance.
+	 *
+	 * @param	Batch				Chains to solve. Solved positions are written to OutJointPos and OutEndPos.
+	 * @param	bAllowStretching	whether or not to allow stretching or not
+	 * @param	StartStretchRatio	When should it start stretch -i.e. 1 means its own length without any stretch
+	 * @param	MaxStretchScale		How much it can stretch to in ratio
+	 * @param	bAllowParallel		Whether chains can be solved on task graph workers
+	 */
+	ANIMATIONCORE_API void SolveTwoBoneIKBatch(FTwoBoneIKBatch& Batch, bool bAllowStretching, double StartStretchRatio, double MaxStretchScale, bool bAllowParallel = true);
+
+	/**
+	 * Solves every chain of the batch like SolveFabrik, several chains per vector register and across task graph workers.
+	 * Chains keep iterating until all chains sharing their vector register have converged, but converged chains are not
+	 * modified. Results match SolveFabrik within floating point tolerance.
+	 *
+	 * @param	Batch				Chains to solve. Positions are solved in place.
+	 * @param	Precision			Precision
+	 * @param	MaxIterations		Number of Max Iteration
+	 * @param	bAllowParallel		Whether chains can be solved on task graph workers
+	 */
+	ANIMATIONCORE_API void SolveFabrikBatch(FFabrikBatch& Batch, double Precision, int32 MaxIterations, bool bAllowParallel = true);
+};
@@ -0,0 +1,522 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AssetRegistry/MappedAssetRegistryState.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "AssetRegistry/AssetRegistryState.h"
+#include "AssetRegistryPrivate.h"
+#include "Async/MappedFileHandle.h"
+#include "Containers/StringConv.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/StringBuilder.h"
+#include "Serialization/Archive.h"
+#include "UObject/NameBatchSerialization.h"
+#include "UObject/SoftObjectPath.h"
+
+namespace UE::AssetRegistry::Mapped
+{
+
+static_assert(sizeof(FMappedHeader) % 8 == 0, "Sections following the header must stay 8-byte aligned");
+static_assert(sizeof(FMappedAssetRecord) % 8 == 0, "Asset records must stay 8-byte aligned");
+static_assert(sizeof(FMappedHashEntry) == 16, "Hash entries are written as raw memory");
+
+/** Case insensitive hash of a path string, matching FName comparison semantics */
+static uint64 HashPath(FStringView Path)
+{
+	TStringBuilder<FName::StringBufferSize> Lower;
+	Lower << Path;
+	for (TCHAR& Char : MakeArrayView(Lower.GetData(), Lower.Len()))
+	{
+		Char = FChar::ToLower(Char);
+	}
+	FTCHARToUTF8 Utf8(Lower.ToString(), Lower.Len());
+	return CityHash64(Utf8.Get(), Utf8.Length());
+}
+
+static uint64 HashObjectPath(const UE::AssetRegistry::Private::FCachedAssetKey& Key)
+{
+	TStringBuilder<FName::StringBufferSize> Path;
+	Key.AppendString(Path);
+	return HashPath(Path);
+}
+
+static uint64 HashPackageName(FName PackageName)
+{
+	TStringBuilder<FName::StringBufferSize> Path;
+	PackageName.AppendString(Path);
+	return HashPath(Path);
+}
+
+static bool IsSectionValid(TConstArrayView<uint8> Data, uint64 Offset, uint64 Size)
+{
+	return Offset % 8 == 0 && Offset <= static_cast<uint64>(Data.Num()) && Size <= static_cast<uint64>(Data.Num()) - Offset;
+}
+
+template<typename T>
+static TConstArrayView<T> GetSection(TConstArrayView<uint8> Data, uint64 Offset, uint32 Num)
+{
+	return TConstArrayView<T>(reinterpret_cast<const T*>(Data.GetData() + Offset), Num);
+}
+
+/**
+ * Checks every index and offset stored in the records, tags and hash indices against the sections they point into,
+ * so queries never have to. Costs a linear pass over records and tags on open.
+ */
+static bool AreRecordsValid(const FMappedHeader& Header, TConstArrayView<uint8> Data)
+{
+	auto IsNameValid = [&Header](FMappedName Name)
+	{
+		return Name.Index < Header.NumNames;
+	};
+	auto IsRangeValid = [](uint32 First, uint32 Num, uint64 Max)
+	{
+		return uint64(First) + Num <= Max;
+	};
+
+	for (const FMappedAssetRecord& Record : GetSection<FMappedAssetRecord>(Data, Header.AssetsOffset, Header.NumAssets))
+	{
+		if (!IsNameValid(Record.PackageName) || !IsNameValid(Record.PackagePath) || !IsNameValid(Record.AssetName) ||
+			!IsNameValid(Record.ClassPackageName) || !IsNameValid(Record.ClassAssetName) || !IsNameValid(Record.OuterPath) ||
+			!IsRangeValid(Record.FirstTag, Record.NumTags, Header.NumTags) ||
+			!IsRangeValid(Record.FirstChunkId, Record.NumChunkIds, Header.NumChunkIds))
+		{
+			return false;
+		}
+	}
+
+	for (const FMappedTag& Tag : GetSection<FMappedTag>(Data, Header.TagsOffset, Header.NumTags))
+	{
+		if (!IsNameValid(Tag.Key) || !IsRangeValid(Tag.ValueOffset, Tag.ValueLen, Header.StringsSize))
+		{
+			return false;
+		}
+	}
+
+	for (const uint64 IndexOffset : { Header.ObjectPathIndexOffset, Header.PackageIndexOffset })
+	{
+		for (const FMappedHashEntry& Entry : GetSection<FMappedHashEntry>(Data, IndexOffset, Header.NumAssets))
+		{
+			if (Entry.AssetIndex >= Header.NumAssets)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#if ALLOW_NAME_BATCH_SAVING
+
+/** Accumulates the sections of a mapped registry in a single buffer, keeping every section 8-byte aligned */
+class FSectionWriter
+{
+public:
+	FSectionWriter()
+	{
+		Buffer.AddZeroed(sizeof(FMappedHeader));
+	}
+
+	template<typename T>
+	uint64 Append(TConstArrayView<T> Items)
+	{
+		return AppendBytes(Items.GetData(), Items.Num() * sizeof(T));
+	}
+
+	uint64 AppendBytes(const void* Bytes, int64 Num)
+	{
+		Buffer.AddZeroed(Align(Buffer.Num(), 8) - Buffer.Num());
+		const uint64 Offset = Buffer.Num();
+		Buffer.Append(static_cast<const uint8*>(Bytes), Num);
+		return Offset;
+	}
+
+	TArray64<uint8>& GetBuffer() { return Buffer; }
+
+private:
+	TArray64<uint8> Buffer;
+};
+
+#endif // ALLOW_NAME_BATCH_SAVING
+
+} // namespace UE::AssetRegistry::Mapped
+
+FMappedAssetRegistryState::FMappedAssetRegistryState() = default;
+
+FMappedAssetRegistryState::~FMappedAssetRegistryState()
+{
+	Close();
+}
+
+#if ALLOW_NAME_BATCH_SAVING
+
+bool FMappedAssetRegistryState::Save(const FAssetRegistryState& State, FArchive& Ar)
+{
+	using namespace UE::AssetRegistry::Mapped;
+	using UE::AssetRegistry::Private::FCachedAssetKey;
+
+	TArray<const FAssetData*> Assets;
+	Assets.Reserve(State.GetNumAssets());
+	for (const FAssetData* AssetData : State.GetAssetDataMap())
+	{
+		Assets.Add(AssetData);
+	}
+
+	// Sort by object path hash so the output is deterministic and the object path index is the identity
+	TArray<FMappedHashEntry> ObjectPathIndex;
+	ObjectPathIndex.Reserve(Assets.Num());
+	for (int32 Index = 0; Index < Assets.Num(); ++Index)
+	{
+		ObjectPathIndex.Add({ HashObjectPath(FCachedAssetKey(Assets[Index])), static_cast<uint32>(Index) });
+	}
+	Algo::SortBy(ObjectPathIndex, &FMappedHashEntry::Hash);
+	{
+		TArray<const FAssetData*> SortedAssets;
+		SortedAssets.Reserve(Assets.Num());
+		for (FMappedHashEntry& Entry : ObjectPathIndex)
+		{
+			Entry.AssetIndex = static_cast<uint32>(SortedAssets.Add(Assets[Entry.AssetIndex]));
+		}
+		Assets = MoveTemp(SortedAssets);
+	}
+
+	TArray<FDisplayNameEntryId> NameEntries;
+	TMap<FDisplayNameEntryId, uint32> NameIndices;
+	auto MapName = [&NameEntries, &NameIndices](FName Name) -> FMappedName
+	{
+		const FDisplayNameEntryId Entry(Name);
+		uint32* ExistingIndex = NameIndices.Find(Entry);
+		const uint32 Index = ExistingIndex ? *ExistingIndex : NameIndices.Add(Entry, static_cast<uint32>(NameEntries.Add(Entry)));
+		return { Index, static_cast<uint32>(Name.GetNumber()) };
+	};
+
+	TArray<FMappedAssetRecord> Records;
+	TArray<FMappedTag> Tags;
+	TArray<int32> ChunkIds;
+	TArray<uint8> Strings;
+	TArray<FMappedHashEntry> PackageIndex;
+	Records.Reserve(Assets.Num());
+	PackageIndex.Reserve(Assets.Num());
+
+	for (int32 AssetIndex = 0; AssetIndex < Assets.Num(); ++AssetIndex)
+	{
+		const FAssetData& AssetData = *Assets[AssetIndex];
+
+		FMappedAssetRecord& Record = Records.AddDefaulted_GetRef();
+		Record.PackageName = MapName(AssetData.PackageName);
+		Record.PackagePath = MapName(AssetData.PackagePath);
+		Record.AssetName = MapName(AssetData.AssetName);
+		Record.ClassPackageName = MapName(AssetData.AssetClassPath.GetPackageName());
+		Record.ClassAssetName = MapName(AssetData.AssetClassPath.GetAssetName());
+		Record.OuterPath = MapName(FCachedAssetKey(AssetData).OuterPath);
+		Record.PackageFlags = AssetData.PackageFlags;
+
+		Record.FirstTag = Tags.Num();
+		AssetData.EnumerateTags([&](TPair<FName, FAssetTagValueRef> Pair)
+		{
+			FTCHARToUTF8 Value(*Pair.Value.GetStorageString());
+			FMappedTag& Tag = Tags.AddDefaulted_GetRef();
+			Tag.Key = MapName(Pair.Key);
+			Tag.ValueOffset = Strings.Num();
+			Tag.ValueLen = Value.Length();
+			Strings.Append(reinterpret_cast<const uint8*>(Value.Get()), Value.Length());
+		});
+		Record.NumTags = Tags.Num() - Record.FirstTag;
+
+		FAssetData::FChunkArrayView AssetChunkIds = AssetData.GetChunkIDs();
+		Record.FirstChunkId = ChunkIds.Num();
+		Record.NumChunkIds = AssetChunkIds.Num();
+		ChunkIds.Append(AssetChunkIds.GetData(), AssetChunkIds.Num());
+
+		PackageIndex.Add({ HashPackageName(AssetData.PackageName), static_cast<uint32>(AssetIndex) });
+	}
+	Algo::SortBy(PackageIndex, &FMappedHashEntry::Hash);
+
+	TArray<uint8> NameData;
+	TArray<uint8> NameHashData;
+	SaveNameBatch(NameEntries, NameData, NameHashData);
+
+	FMappedHeader Header;
+	Header.Magic = FMappedHeader::MagicValue;
+	Header.Version = FMappedHeader::CurrentVersion;
+	Header.NumNames = NameEntries.Num();
+	Header.NumAssets = Records.Num();
+	Header.NumTags = Tags.Num();
+	Header.NumChunkIds = ChunkIds.Num();
+
+	FSectionWriter Writer;
+	Header.NameDataOffset = Writer.Append<uint8>(NameData);
+	Header.NameDataSize = NameData.Num();
+	Header.NameHashOffset = Writer.Append<uint8>(NameHashData);
+	Header.NameHashSize = NameHashData.Num();
+	Header.AssetsOffset = Writer.Append<FMappedAssetRecord>(Records);
+	Header.ObjectPathIndexOffset = Writer.Append<FMappedHashEntry>(ObjectPathIndex);
+	Header.PackageIndexOffset = Writer.Append<FMappedHashEntry>(PackageIndex);
+	Header.TagsOffset = Writer.Append<FMappedTag>(Tags);
+	Header.ChunkIdsOffset = Writer.Append<int32>(ChunkIds);
+	Header.StringsOffset = Writer.Append<uint8>(Strings);
+	Header.StringsSize = Strings.Num();
+
+	TArray64<uint8>& Buffer = Writer.GetBuffer();
+	FMemory::Memcpy(Buffer.GetData(), &Header, sizeof(Header));
+	Ar.Serialize(Buffer.GetData(), Buffer.Num());
+	return !Ar.IsError();
+}
+
+#endif // ALLOW_NAME_BATCH_SAVING
+
+bool FMappedAssetRegistryState::Open(const TCHAR* InPath)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMappedAssetRegistryState::Open);
+	Close();
+
+	TUniquePtr<IMappedFileHandle> LocalFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(InPath));
+	if (!LocalFile || LocalFile->GetFileSize() < static_cast<int64>(sizeof(UE::AssetRegistry::Mapped::FMappedHeader)))
+	{
+		return false;
+	}
+
+	TUniquePtr<IMappedFileRegion> LocalRegion(LocalFile->MapRegion(0, LocalFile->GetFileSize()));
+	if (!LocalRegion)
+	{
+		return false;
+	}
+
+	// Offsets are 64 bit but the mapped view is indexed with int32
+	if (LocalRegion->GetMappedSize() > MAX_int32)
+	{
+		UE_LOG(LogAssetRegistry, Warning, TEXT("Mapped AssetRegistry %s is larger than 2GB, ignoring it."), InPath);
+		return false;
+	}
+
+	if (!OpenFromMemory(TConstArrayView<uint8>(LocalRegion->GetMappedPtr(), static_cast<int32>(LocalRegion->GetMappedSize()))))
+	{
+		return false;
+	}
+
+	MappedFile = MoveTemp(LocalFile);
+	MappedRegion = MoveTemp(LocalRegion);
+	return true;
+}
+
+bool FMappedAssetRegistryState::OpenFromMemory(TConstArrayView<uint8> InData)
+{
+	using namespace UE::AssetRegistry::Mapped;
+
+	Close();
+
+	if (InData.Num() < sizeof(FMappedHeader) || !IsAligned(InData.GetData(), 8))
+	{
+		return false;
+	}
+
+	const FMappedHeader& Header = *reinterpret_cast<const FMappedHeader*>(InData.GetData());
+	if (Header.Magic != FMappedHeader::MagicValue || Header.Version != FMappedHeader::CurrentVersion)
+	{
+		UE_LOG(LogAssetRegistry, Warning, TEXT("Mapped AssetRegistry has an unsupported header, ignoring it."));
+		return false;
+	}
+
+	const bool bValid =
+		IsSectionValid(InData, Header.NameDataOffset, Header.NameDataSize) &&
+		IsSectionValid(InData, Header.NameHashOffset, Header.NameHashSize) &&
+		IsSectionValid(InData, Header.AssetsOffset, uint64(Header.NumAssets) * sizeof(FMappedAssetRecord)) &&
+		IsSectionValid(InData, Header.ObjectPathIndexOffset, uint64(Header.NumAssets) * sizeof(FMappedHashEntry)) &&
+		IsSectionValid(InData, Header.PackageIndexOffset, uint64(Header.NumAssets) * sizeof(FMappedHashEntry)) &&
+		IsSectionValid(InData, Header.TagsOffset, uint64(Header.NumTags) * sizeof(FMappedTag)) &&
+		IsSectionValid(InData, Header.ChunkIdsOffset, uint64(Header.NumChunkIds) * sizeof(int32)) &&
+		IsSectionValid(InData, Header.StringsOffset, Header.StringsSize);
+	if (!bValid)
+	{
+		UE_LOG(LogAssetRegistry, Warning, TEXT("Mapped AssetRegistry is truncated or corrupt, ignoring it."));
+		return false;
+	}
+
+	Data = InData;
+	LoadNameBatch(Names,
+		GetArray<uint8>(Header.NameDataOffset, static_cast<uint32>(Header.NameDataSize)),
+		GetArray<uint8>(Header.NameHashOffset, static_cast<uint32>(Header.NameHashSize)));
+	if (Names.Num() != Header.NumNames || !AreRecordsValid(Header, Data))
+	{
+		UE_LOG(LogAssetRegistry, Warning, TEXT("Mapped AssetRegistry has out of range names or offsets, ignoring it."));
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FMappedAssetRegistryState::Close()
+{
+	{
+		FScopeLock Lock(&MaterializedLock);
+		MaterializedAssets.Empty();
+	}
+	Names.Empty();
+	Data = TConstArrayView<uint8>();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+const UE::AssetRegistry::Mapped::FMappedAssetRecord& FMappedAssetRegistryState::GetRecord(int32 AssetIndex) const
+{
+	const UE::AssetRegistry::Mapped::FMappedHeader& Header = GetHeader();
+	return GetArray<UE::AssetRegistry::Mapped::FMappedAssetRecord>(Header.AssetsOffset, Header.NumAssets)[AssetIndex];
+}
+
+FName FMappedAssetRegistryState::ToName(UE::AssetRegistry::Mapped::FMappedName Name) const
+{
+	return Names[Name.Index].ToName(Name.Number);
+}
+
+bool FMappedAssetRegistryState::NameEquals(UE::AssetRegistry::Mapped::FMappedName MappedName, FName Name) const
+{
+	return MappedName.Number == static_cast<uint32>(Name.GetNumber()) && ToName(MappedName) == Name;
+}
+
+int32 FMappedAssetRegistryState::FindAssetIndex(const FSoftObjectPath& ObjectPath) const
+{
+	using namespace UE::AssetRegistry::Mapped;
+	using UE::AssetRegistry::Private::FCachedAssetKey;
+
+	const FCachedAssetKey Key(ObjectPath);
+	if (!IsOpen() || Key.ObjectName.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	const FMappedHeader& Header = GetHeader();
+	TConstArrayView<FMappedHashEntry> Index = GetArray<FMappedHashEntry>(Header.ObjectPathIndexOffset, Header.NumAssets);
+	const uint64 Hash = HashObjectPath(Key);
+	for (int32 EntryIndex = Algo::LowerBoundBy(Index, Hash, &FMappedHashEntry::Hash); EntryIndex < Index.Num() && Index[EntryIndex].Hash == Hash; ++EntryIndex)
+	{
+		// Assets with the same name in different packages only differ by their outer
+		const int32 AssetIndex = static_cast<int32>(Index[EntryIndex].AssetIndex);
+		const FMappedAssetRecord& Record = GetRecord(AssetIndex);
+		if (NameEquals(Record.AssetName, Key.ObjectName) && NameEquals(Record.OuterPath, Key.OuterPath))
+		{
+			return AssetIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void FMappedAssetRegistryState::FindAssetIndicesByPackageName(FName PackageName, TArray<int32>& OutIndices) const
+{
+	using namespace UE::AssetRegistry::Mapped;
+
+	if (!IsOpen() || PackageName.IsNone())
+	{
+		return;
+	}
+
+	const FMappedHeader& Header = GetHeader();
+	TConstArrayView<FMappedHashEntry> Index = GetArray<FMappedHashEntry>(Header.PackageIndexOffset, Header.NumAssets);
+	const uint64 Hash = HashPackageName(PackageName);
+	for (int32 EntryIndex = Algo::LowerBoundBy(Index, Hash, &FMappedHashEntry::Hash); EntryIndex < Index.Num() && Index[EntryIndex].Hash == Hash; ++EntryIndex)
+	{
+		const int32 AssetIndex = static_cast<int32>(Index[EntryIndex].AssetIndex);
+		if (NameEquals(GetRecord(AssetIndex).PackageName, PackageName))
+		{
+			OutIndices.Add(AssetIndex);
+		}
+	}
+}
+
+FName FMappedAssetRegistryState::GetPackageName(int32 AssetIndex) const
+{
+	return ToName(GetRecord(AssetIndex).PackageName);
+}
+
+FName FMappedAssetRegistryState::GetAssetName(int32 AssetIndex) const
+{
+	return ToName(GetRecord(AssetIndex).AssetName);
+}
+
+FTopLevelAssetPath FMappedAssetRegistryState::GetAssetClassPath(int32 AssetIndex) const
+{
+	const UE::AssetRegistry::Mapped::FMappedAssetRecord& Record = GetRecord(AssetIndex);
+	return FTopLevelAssetPath(ToName(Record.ClassPackageName), ToName(Record.ClassAssetName));
+}
+
+FAssetData FMappedAssetRegistryState::MaterializeAssetData(int32 AssetIndex) const
+{
+	using namespace UE::AssetRegistry::Mapped;
+
+	const FMappedHeader& Header = GetHeader();
+	const FMappedAssetRecord& Record = GetRecord(AssetIndex);
+	TConstArrayView<FMappedTag> AllTags = GetArray<FMappedTag>(Header.TagsOffset, Header.NumTags);
+	TConstArrayView<int32> AllChunkIds = GetArray<int32>(Header.ChunkIdsOffset, Header.NumChunkIds);
+	const ANSICHAR* Strings = reinterpret_cast<const ANSICHAR*>(Data.GetData() + Header.StringsOffset);
+
+	FAssetDataTagMap Tags;
+	Tags.Reserve(Record.NumTags);
+	for (const FMappedTag& Tag : AllTags.Slice(Record.FirstTag, Record.NumTags))
+	{
+		FUTF8ToTCHAR Value(Strings + Tag.ValueOffset, Tag.ValueLen);
+		Tags.Add(ToName(Tag.Key), FString(Value.Length(), Value.Get()));
+	}
+
+	return FAssetData(ToName(Record.PackageName), ToName(Record.PackagePath), ToName(Record.AssetName),
+		FTopLevelAssetPath(ToName(Record.ClassPackageName), ToName(Record.ClassAssetName)),
+		MoveTemp(Tags), AllChunkIds.Slice(Record.FirstChunkId, Record.NumChunkIds), Record.PackageFlags);
+}
+
+const FAssetData* FMappedAssetRegistryState::GetAssetData(int32 AssetIndex) const
+{
+	if (AssetIndex < 0 || AssetIndex >= GetNumAssets())
+	{
+		return nullptr;
+	}
+
+	FScopeLock Lock(&MaterializedLock);
+	TUniquePtr<FAssetData>& AssetData = MaterializedAssets.FindOrAdd(AssetIndex);
+	if (!AssetData)
+	{
+		AssetData = MakeUnique<FAssetData>(MaterializeAssetData(AssetIndex));
+	}
+	return AssetData.Get();
+}
+
+const FAssetData* FMappedAssetRegistryState::GetAssetByObjectPath(const FSoftObjectPath& ObjectPath) const
+{
+	return GetAssetData(FindAssetIndex(ObjectPath));
+}
+
+void FMappedAssetRegistryState::EnumerateAssetsByClass(FTopLevelAssetPath ClassPathName, TFunctionRef<bool(const FAssetData&)> Callback) const
+{
+	const int32 NumAssets = GetNumAssets();
+	for (int32 AssetIndex = 0; AssetIndex < NumAssets; ++AssetIndex)
+	{
+		const UE::AssetRegistry::Mapped::FMappedAssetRecord& Record = GetRecord(AssetIndex);
+		if (NameEquals(Record.ClassAssetName, ClassPathName.GetAssetName()) && NameEquals(Record.ClassPackageName, ClassPathName.GetPackageName()))
+		{
+			if (!Callback(*GetAssetData(AssetIndex)))
+			{
+				return;
+			}
+		}
+	}
+}
+
+SIZE_T FMappedAssetRegistryState::GetAllocatedSize() const
+{
+	FScopeLock Lock(&MaterializedLock);
+	SIZE_T Size = Names.GetAllocatedSize() + MaterializedAssets.GetAllocatedSize() + MaterializedAssets.Num() * sizeof(FAssetData);
+
+	// Materialized tags are loose maps, which own their value strings
+	FAssetDataTagMapSharedView::FMemoryCounter TagMemory;
+	for (const TPair<int32, TUniquePtr<FAssetData>>& Pair : MaterializedAssets)
+	{
+		TagMemory.Include(Pair.Value->TagsAndValues);
+	}
+	return Size + TagMemory.GetLooseSize() + TagMemory.GetFixedSize();
+}
+
+int32 FMappedAssetRegistryState::GetNumMaterializedAssets() const
+{
+	FScopeLock Lock(&MaterializedLock);
+	return MaterializedAssets.Num();
+}
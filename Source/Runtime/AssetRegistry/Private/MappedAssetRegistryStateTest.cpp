@@ -0,0 +1,264 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "UObject/NameBatchSerialization.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && ALLOW_NAME_BATCH_SAVING
+
+#include "AssetRegistry/AssetRegistryState.h"
+#include "AssetRegistry/MappedAssetRegistryState.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/LargeMemoryWriter.h"
+#include "Serialization/MemoryWriter.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMappedAssetRegistryStateTest, "System.AssetRegistry.MappedState", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter);
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMappedAssetRegistryStateCorruptTest, "System.AssetRegistry.MappedState.Corrupt", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter);
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMappedAssetRegistryStateCollisionTest, "System.AssetRegistry.MappedState.Collision", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter);
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMappedAssetRegistryStateBenchmark, "System.AssetRegistry.MappedState.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter);
+
+namespace UE::AssetRegistry::MappedStateTest
+{
+	static const FTopLevelAssetPath TextureClass(TEXT("/Script/Engine.Texture2D"));
+	static const FTopLevelAssetPath MaterialClass(TEXT("/Script/Engine.Material"));
+
+	static void FillState(FAssetRegistryState& State, int32 NumAssets)
+	{
+		for (int32 Index = 0; Index < NumAssets; ++Index)
+		{
+			const FString PackagePath = FString::Printf(TEXT("/Game/Folder%d"), Index % 64);
+			const FString PackageName = FString::Printf(TEXT("%s/Asset_%d"), *PackagePath, Index);
+
+			FAssetDataTagMap Tags;
+			Tags.Add(TEXT("Index"), LexToString(Index));
+			Tags.Add(TEXT("Category"), FString::Printf(TEXT("Category_%d"), Index % 16));
+
+			const int32 ChunkIds[] = { Index % 4 };
+			State.AddAssetData(new FAssetData(FName(*PackageName), FName(*PackagePath), FName(*FString::Printf(TEXT("Asset_%d"), Index)),
+				(Index % 2) ? TextureClass : MaterialClass, MoveTemp(Tags), ChunkIds, 0));
+		}
+	}
+
+	static FString GetTempFilename()
+	{
+		return FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("MappedAssetRegistry"), TEXT(".bin"));
+	}
+
+	static bool SaveMapped(const FAssetRegistryState& State, const FString& Filename)
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+		return Writer && FMappedAssetRegistryState::Save(State, *Writer) && Writer->Close();
+	}
+}
+
+bool FMappedAssetRegistryStateTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::AssetRegistry::MappedStateTest;
+
+	constexpr int32 NumAssets = 1000;
+	FAssetRegistryState State;
+	FillState(State, NumAssets);
+
+	const FString Filename = GetTempFilename();
+	if (!TestTrue(TEXT("Mapped registry saved"), SaveMapped(State, Filename)))
+	{
+		return false;
+	}
+	ON_SCOPE_EXIT { IFileManager::Get().Delete(*Filename); };
+
+	TArray<uint8> FileData;
+	FMappedAssetRegistryState Mapped;
+	if (!Mapped.Open(*Filename))
+	{
+		// Platforms without file mapping fall back to reading the whole file
+		TestTrue(TEXT("Read mapped registry"), FFileHelper::LoadFileToArray(FileData, *Filename));
+		Mapped.OpenFromMemory(FileData);
+		if (!TestTrue(TEXT("Opened mapped registry"), Mapped.IsOpen()))
+		{
+			return false;
+		}
+	}
+
+	TestEqual(TEXT("Asset count"), Mapped.GetNumAssets(), NumAssets);
+	TestEqual(TEXT("Nothing materialized on open"), Mapped.GetNumMaterializedAssets(), 0);
+
+	for (const FAssetData* Expected : State.GetAssetDataMap())
+	{
+		const FAssetData* Actual = Mapped.GetAssetByObjectPath(Expected->GetSoftObjectPath());
+		if (!TestNotNull(TEXT("Asset found by object path"), Actual))
+		{
+			continue;
+		}
+		TestEqual(TEXT("PackageName"), Actual->PackageName, Expected->PackageName);
+		TestEqual(TEXT("PackagePath"), Actual->PackagePath, Expected->PackagePath);
+		TestEqual(TEXT("AssetClassPath"), Actual->AssetClassPath, Expected->AssetClassPath);
+		TestTrue(TEXT("ChunkIDs"), Actual->HasSameChunkIDs(*Expected));
+		TestTrue(TEXT("Tags"), Actual->TagsAndValues == Expected->TagsAndValues.CopyMap());
+	}
+
+	TArray<int32> Indices;
+	Mapped.FindAssetIndicesByPackageName(TEXT("/Game/Folder1/Asset_1"), Indices);
+	TestEqual(TEXT("Assets by package"), Indices.Num(), 1);
+	TestEqual(TEXT("Missing asset"), Mapped.FindAssetIndex(FSoftObjectPath(TEXT("/Game/Missing.Missing"))), INDEX_NONE);
+
+	int32 NumTextures = 0;
+	Mapped.EnumerateAssetsByClass(TextureClass, [&NumTextures](const FAssetData&) { ++NumTextures; return true; });
+	TestEqual(TEXT("Assets by class"), NumTextures, NumAssets / 2);
+
+	return true;
+}
+
+bool FMappedAssetRegistryStateCorruptTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::AssetRegistry::Mapped;
+	using namespace UE::AssetRegistry::MappedStateTest;
+
+	FAssetRegistryState State;
+	FillState(State, 16);
+
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	if (!TestTrue(TEXT("Mapped registry saved"), FMappedAssetRegistryState::Save(State, Writer)))
+	{
+		return false;
+	}
+
+	FMappedHeader Header;
+	FMemory::Memcpy(&Header, FileData.GetData(), sizeof(Header));
+	auto GetRecord = [&FileData, &Header](int32 AssetIndex) -> FMappedAssetRecord&
+	{
+		return reinterpret_cast<FMappedAssetRecord*>(FileData.GetData() + Header.AssetsOffset)[AssetIndex];
+	};
+
+	FMappedAssetRegistryState Mapped;
+	TestTrue(TEXT("Valid registry opens"), Mapped.OpenFromMemory(FileData));
+
+	// Every corruption must be rejected on open rather than read out of bounds by a later query
+	const FMappedAssetRecord ValidRecord = GetRecord(3);
+	GetRecord(3).AssetName.Index = Header.NumNames;
+	TestFalse(TEXT("Out of range name rejected"), Mapped.OpenFromMemory(FileData));
+	TestFalse(TEXT("Rejected registry is closed"), Mapped.IsOpen());
+
+	GetRecord(3) = ValidRecord;
+	GetRecord(3).FirstTag = Header.NumTags - GetRecord(3).NumTags + 1;
+	TestFalse(TEXT("Out of range tags rejected"), Mapped.OpenFromMemory(FileData));
+
+	GetRecord(3) = ValidRecord;
+	reinterpret_cast<FMappedHashEntry*>(FileData.GetData() + Header.PackageIndexOffset)[5].AssetIndex = Header.NumAssets;
+	TestFalse(TEXT("Out of range asset index rejected"), Mapped.OpenFromMemory(FileData));
+
+	return true;
+}
+
+bool FMappedAssetRegistryStateCollisionTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::AssetRegistry::Mapped;
+	using namespace UE::AssetRegistry::MappedStateTest;
+
+	// Two assets with the same name in different packages
+	const FSoftObjectPath PathA(TEXT("/Game/A/Same.Same"));
+	const FSoftObjectPath PathB(TEXT("/Game/B/Same.Same"));
+	FAssetRegistryState State;
+	State.AddAssetData(new FAssetData(FName(TEXT("/Game/A/Same")), FName(TEXT("/Game/A")), FName(TEXT("Same")), TextureClass));
+	State.AddAssetData(new FAssetData(FName(TEXT("/Game/B/Same")), FName(TEXT("/Game/B")), FName(TEXT("Same")), TextureClass));
+
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	if (!TestTrue(TEXT("Mapped registry saved"), FMappedAssetRegistryState::Save(State, Writer)))
+	{
+		return false;
+	}
+
+	FMappedAssetRegistryState Mapped;
+	if (!TestTrue(TEXT("Valid registry opens"), Mapped.OpenFromMemory(FileData)))
+	{
+		return false;
+	}
+	const int32 IndexA = Mapped.FindAssetIndex(PathA);
+	const int32 IndexB = Mapped.FindAssetIndex(PathB);
+	if (!TestTrue(TEXT("Both assets found"), IndexA != INDEX_NONE && IndexB != INDEX_NONE && IndexA != IndexB))
+	{
+		return false;
+	}
+
+	// Make B's entry collide with A's hash and come first, so only the outer tells the hash hits apart
+	FMappedHeader Header;
+	FMemory::Memcpy(&Header, FileData.GetData(), sizeof(Header));
+	FMappedHashEntry* ObjectPathIndex = reinterpret_cast<FMappedHashEntry*>(FileData.GetData() + Header.ObjectPathIndexOffset);
+	const uint64 HashA = ObjectPathIndex[0].AssetIndex == static_cast<uint32>(IndexA) ? ObjectPathIndex[0].Hash : ObjectPathIndex[1].Hash;
+	ObjectPathIndex[0] = { HashA, static_cast<uint32>(IndexB) };
+	ObjectPathIndex[1] = { HashA, static_cast<uint32>(IndexA) };
+
+	if (!TestTrue(TEXT("Colliding registry opens"), Mapped.OpenFromMemory(FileData)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Colliding hash resolves to the matching outer"), Mapped.FindAssetIndex(PathA), IndexA);
+	TestEqual(TEXT("Asset without an index entry is not found"), Mapped.FindAssetIndex(PathB), static_cast<int32>(INDEX_NONE));
+
+	return true;
+}
+
+bool FMappedAssetRegistryStateBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace UE::AssetRegistry::MappedStateTest;
+
+	const int32 NumAssets = Parameters.IsEmpty() ? 200000 : FCString::Atoi(*Parameters);
+	const FSoftObjectPath FirstQuery(FString::Printf(TEXT("/Game/Folder%d/Asset_%d.Asset_%d"), (NumAssets / 2) % 64, NumAssets / 2, NumAssets / 2));
+
+	FAssetRegistryState Source;
+	FillState(Source, NumAssets);
+
+	// Both formats are read from a file, so each path pays for its own file access
+	FLargeMemoryWriter ClassicData;
+	Source.Save(ClassicData, FAssetRegistrySerializationOptions(UE::AssetRegistry::ESerializationTarget::ForGame));
+	const FString ClassicFilename = GetTempFilename();
+	if (!TestTrue(TEXT("Classic registry saved"), FFileHelper::SaveArrayToFile(TArrayView<const uint8>(ClassicData.GetData(), static_cast<int32>(ClassicData.TotalSize())), *ClassicFilename)))
+	{
+		return false;
+	}
+	ON_SCOPE_EXIT { IFileManager::Get().Delete(*ClassicFilename); };
+
+	const FString Filename = GetTempFilename();
+	if (!TestTrue(TEXT("Mapped registry saved"), SaveMapped(Source, Filename)))
+	{
+		return false;
+	}
+	ON_SCOPE_EXIT { IFileManager::Get().Delete(*Filename); };
+
+	double ClassicSeconds = 0.0;
+	SIZE_T ClassicBytes = 0;
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		FAssetRegistryState Loaded;
+		TestTrue(TEXT("Classic registry loaded"), FAssetRegistryState::LoadFromDisk(*ClassicFilename, FAssetRegistryLoadOptions(), Loaded));
+		TestNotNull(TEXT("Classic query"), Loaded.GetAssetByObjectPath(FirstQuery));
+		ClassicSeconds = FPlatformTime::Seconds() - StartTime;
+		ClassicBytes = Loaded.GetAllocatedSize();
+	}
+
+	double MappedSeconds = 0.0;
+	SIZE_T MappedBytes = 0;
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		FMappedAssetRegistryState Mapped;
+		if (!Mapped.Open(*Filename))
+		{
+			AddWarning(TEXT("Platform file does not support mapping, skipping mapped registry benchmark."));
+			return true;
+		}
+		TestNotNull(TEXT("Mapped query"), Mapped.GetAssetByObjectPath(FirstQuery));
+		MappedSeconds = FPlatformTime::Seconds() - StartTime;
+		MappedBytes = Mapped.GetAllocatedSize();
+	}
+
+	AddInfo(FString::Printf(TEXT("%d assets: classic load + first query %.2fms, %.1fKiB resident; mapped open + first query %.2fms, %.1fKiB resident (+%.1fKiB mapped)"),
+		NumAssets, ClassicSeconds * 1000.0, ClassicBytes / 1024.0, MappedSeconds * 1000.0, MappedBytes / 1024.0, IFileManager::Get().FileSize(*Filename) / 1024.0));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && ALLOW_NAME_BATCH_SAVING
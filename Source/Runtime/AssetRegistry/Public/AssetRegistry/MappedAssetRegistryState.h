@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "AssetRegistry/AssetData.h"
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+#include "Containers/Map.h"
+#include "Containers/StringFwd.h"
+#include "CoreTypes.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/NameBatchSerialization.h"
+#include "UObject/NameTypes.h"
+#include "UObject/TopLevelAssetPath.h"
+
+class FArchive;
+class FAssetRegistryState;
+class IMappedFileHandle;
+class IMappedFileRegion;
+struct FSoftObjectPath;
+
+namespace UE::AssetRegistry::Mapped
+{
+	/** Name reference into the shared name batch, stored as (batch index, FName number) */
+	struct FMappedName
+	{
+		uint32 Index = 0;
+		uint32 Number = 0;
+	};
+
+	/** Fixed size per-asset record, everything variable sized is referenced by offset */
+	struct FMappedAssetRecord
+	{
+		FMappedName PackageName;
+		FMappedName PackagePath;
+		FMappedName AssetName;
+		FMappedName ClassPackageName;
+		FMappedName ClassAssetName;
+		/** Outer of the asset in the object path: the package name for top level assets, the full outer path otherwise */
+		FMappedName OuterPath;
+		uint32 PackageFlags = 0;
+		uint32 FirstTag = 0;
+		uint32 NumTags = 0;
+		uint32 FirstChunkId = 0;
+		uint32 NumChunkIds = 0;
+		uint32 Pad = 0;
+	};
+
+	/** Tag key plus a UTF-8 storage string located in the string blob */
+	struct FMappedTag
+	{
+		FMappedName Key;
+		uint32 ValueOffset = 0;
+		uint32 ValueLen = 0;
+	};
+
+	/** Hash index entry, arrays of these are sorted by Hash to support binary search lookups */
+	struct FMappedHashEntry
+	{
+		uint64 Hash = 0;
+		uint32 AssetIndex = 0;
+		uint32 Pad = 0;
+	};
+
+	/** File header, all offsets are relative to the start of the file and 8-byte aligned */
+	struct FMappedHeader
+	{
+		static constexpr uint64 MagicValue = 0x4D41505245474953; // "MAPREGIS"
+		static constexpr uint32 CurrentVersion = 2;
+
+		uint64 Magic = 0;
+		uint32 Version = 0;
+		uint32 NumNames = 0;
+		uint64 NameDataOffset = 0;
+		uint64 NameDataSize = 0;
+		uint64 NameHashOffset = 0;
+		uint64 NameHashSize = 0;
+		uint32 NumAssets = 0;
+		uint32 NumTags = 0;
+		uint64 AssetsOffset = 0;
+		uint64 ObjectPathIndexOffset = 0;
+		uint64 PackageIndexOffset = 0;
+		uint64 TagsOffset = 0;
+		uint32 NumChunkIds = 0;
+		uint32 Pad = 0;
+		uint64 ChunkIdsOffset = 0;
+		uint64 StringsOffset = 0;
+		uint64 StringsSize = 0;
+	};
+}
+
+/**
+ * Read-only asset registry that is queried in place from a flat, memory-mapped file.
+ *
+ * The file is written from an existing FAssetRegistryState by Save and contains fixed size asset records,
+ * hash indices sorted for binary search, a shared FNameBatchSerialization name table and a string blob for tag values.
+ * Opening the file maps it and only loads the name batch, FAssetData is materialized on demand and cached.
+ * This is a standalone query object, it does not back UAssetRegistryImpl or FAssetRegistryState::LoadFromDisk.
+ */
+class FMappedAssetRegistryState
+{
+public:
+	ASSETREGISTRY_API FMappedAssetRegistryState();
+	ASSETREGISTRY_API ~FMappedAssetRegistryState();
+
+	FMappedAssetRegistryState(const FMappedAssetRegistryState&) = delete;
+	FMappedAssetRegistryState& operator=(const FMappedAssetRegistryState&) = delete;
+
+#if ALLOW_NAME_BATCH_SAVING
+	/** Write the assets of State in the mapped layout. Dependencies and package data are not part of the mapped format. */
+	static ASSETREGISTRY_API bool Save(const FAssetRegistryState& State, FArchive& Ar);
+#endif
+
+	/** Map the file at InPath and load its name table. Returns false if the file can't be mapped or is not a mapped registry. */
+	ASSETREGISTRY_API bool Open(const TCHAR* InPath);
+
+	/** Initialize from memory that outlives this object, for example a region mapped by the caller */
+	ASSETREGISTRY_API bool OpenFromMemory(TConstArrayView<uint8> InData);
+
+	/** Unmap the file and release all materialized asset data */
+	ASSETREGISTRY_API void Close();
+
+	bool IsOpen() const { return Data.Num() > 0; }
+
+	/** Returns the number of assets in the mapped file */
+	int32 GetNumAssets() const { return IsOpen() ? static_cast<int32>(GetHeader().NumAssets) : 0; }
+
+	/** Returns the index of the asset with the given object path, or INDEX_NONE. Hash hits are confirmed against the asset name and its outer. */
+	ASSETREGISTRY_API int32 FindAssetIndex(const FSoftObjectPath& ObjectPath) const;
+
+	/** Appends the indices of all assets in the given package */
+	ASSETREGISTRY_API void FindAssetIndicesByPackageName(FName PackageName, TArray<int32>& OutIndices) const;
+
+	/** Read individual fields of an asset without materializing it */
+	ASSETREGISTRY_API FName GetPackageName(int32 AssetIndex) const;
+	ASSETREGISTRY_API FName GetAssetName(int32 AssetIndex) const;
+	ASSETREGISTRY_API FTopLevelAssetPath GetAssetClassPath(int32 AssetIndex) const;
+
+	/** Returns the asset data at AssetIndex, materializing it on first access. The returned pointer is valid until Close. */
+	ASSETREGISTRY_API const FAssetData* GetAssetData(int32 AssetIndex) const;
+
+	/** Convenience lookup combining FindAssetIndex and GetAssetData */
+	ASSETREGISTRY_API const FAssetData* GetAssetByObjectPath(const FSoftObjectPath& ObjectPath) const;
+
+	/** Calls Callback for every asset of the given class, materializing only the matching assets. Return false from Callback to stop. */
+	ASSETREGISTRY_API void EnumerateAssetsByClass(FTopLevelAssetPath ClassPathName, TFunctionRef<bool(const FAssetData&)> Callback) const;
+
+	/** Returns the heap memory owned by this object, including the tag values of materialized assets and excluding the mapped file itself */
+	ASSETREGISTRY_API SIZE_T GetAllocatedSize() const;
+
+	/** Returns the number of FAssetData materialized so far */
+	ASSETREGISTRY_API int32 GetNumMaterializedAssets() const;
+
+private:
+	const UE::AssetRegistry::Mapped::FMappedHeader& GetHeader() const
+	{
+		return *reinterpret_cast<const UE::AssetRegistry::Mapped::FMappedHeader*>(Data.GetData());
+	}
+
+	template<typename T>
+	TConstArrayView<T> GetArray(uint64 Offset, uint32 Num) const
+	{
+		return TConstArrayView<T>(reinterpret_cast<const T*>(Data.GetData() + Offset), Num);
+	}
+
+	const UE::AssetRegistry::Mapped::FMappedAssetRecord& GetRecord(int32 AssetIndex) const;
+	FName ToName(UE::AssetRegistry::Mapped::FMappedName Name) const;
+	bool NameEquals(UE::AssetRegistry::Mapped::FMappedName MappedName, FName Name) const;
+	FAssetData MaterializeAssetData(int32 AssetIndex) const;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TConstArrayView<uint8> Data;
+	TArray<FDisplayNameEntryId> Names;
+
+	mutable FCriticalSection MaterializedLock;
+	mutable TMap<int32, TUniquePtr<FAssetData>> MaterializedAssets;
+};
@@ -53,6 +53,14 @@ FAutoConsoleVariableRef CVarDisableHPFiltering(
 	TEXT("0: Not Disabled, 1: Disabled"),
 	ECVF_Default);
 
+static int32 BatchSourceFiltersCvar = 1;
+FAutoConsoleVariableRef CVarBatchSourceFilters(
+	TEXT("au.BatchSourceFilters"),
+	BatchSourceFiltersCvar,
+	TEXT("Processes the per-source lowpass and highpass filters of all sources together, several filters at a time with SIMD.\n")
+	TEXT("0: Filter each source separately, 1: Batch filters"),
+	ECVF_Default);
+
 static int32 DisableEnvelopeFollowingCvar = 0;
 FAutoConsoleVariableRef CVarDisableEnvelopeFollowing(
 	TEXT("au.DisableEnvelopeFollowing"),
@@ -697,6 +705,8 @@ namespace Audio
 
 		SourceInfo.LowPassFilter.Reset();
 		SourceInfo.HighPassFilter.Reset();
+		SourceInfo.LowPassFilterStates.Reset();
+		SourceInfo.HighPassFilterStates.Reset();
 		SourceInfo.CurrentPCMBuffer = nullptr;
 		SourceInfo.CurrentAudioChunkNumFrames = 0;
 		SourceInfo.SourceBuffer.Reset();
@@ -930,6 +940,10 @@ namespace Audio
 			// Initialize the number of per-source LPF filters based on input channels
 			SourceInfo.LowPassFilter.Init(MixerDevice->SampleRate, InitParams.NumInputChannels);
 			SourceInfo.HighPassFilter.Init(MixerDevice->SampleRate, InitParams.NumInputChannels);
+			SourceInfo.LowPassFilterStates.Reset();
+			SourceInfo.LowPassFilterStates.SetNum(InitParams.NumInputChannels);
+			SourceInfo.HighPassFilterStates.Reset();
+			SourceInfo.HighPassFilterStates.SetNum(InitParams.NumInputChannels);
 
 			Audio::FInlineEnvelopeFollowerInitParams EnvelopeFollowerInitParams;
 			EnvelopeFollowerInitParams.SampleRate = MixerDevice->SampleRate / NumOutputFrames;
@@ -2581,13 +2595,37 @@ namespace Audio
 		}
 	}
 
-	void FMixerSourceManager::ComputePostSourceEffectBufferForIdRange(bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd)
+	// Adds every channel of a source filter to a batch. The delay terms of the channels are kept in InOutStates.
+	template<typename FilterType>
+	static void AddSourceFilterToBatch(const FilterType& InFilter, TArray<Audio::FBiquadFilterState>& InOutStates, const float* InBuffer, float* OutBuffer, Audio::FBiquadFilterBatch& OutBatch)
+	{
+		Audio::FBiquadBatchChannel Channel;
+		InFilter.GetBiquadCoefficients(Channel.StartCoefficients, Channel.EndCoefficients);
+		Channel.Stride = InOutStates.Num();
+
+		for (int32 ChannelIndex = 0; ChannelIndex < InOutStates.Num(); ++ChannelIndex)
+		{
+			Channel.Input = InBuffer + ChannelIndex;
+			Channel.Output = OutBuffer + ChannelIndex;
+			Channel.State = &InOutStates[ChannelIndex];
+			OutBatch.AddChannel(Channel);
+		}
+	}
+
+	void FMixerSourceManager::ComputePostSourceEffectBufferForIdRange(bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd, FSourceFilterBatch& InFilterBatch)
 	{
 		CSV_SCOPED_TIMING_STAT(Audio, SourceEffectsBuffers);
 		CONDITIONAL_SCOPE_CYCLE_COUNTER(STAT_AudioMixerSourceEffectBuffers, (SourceIdStart < SourceIdEnd));
 
 		const bool bIsDebugModeEnabled = DebugSoloSources.Num() > 0;
 
+		// When batching, filters are only set up in the loop below. Distance attenuation and plugin sends
+		// are computed once all the filters of the range have been processed together.
+		const bool bBatchFilters = BatchSourceFiltersCvar != 0;
+		InFilterBatch.LowPass.Reset();
+		InFilterBatch.HighPass.Reset();
+		InFilterBatch.SourceIds.Reset();
+
 		for (int32 SourceId = SourceIdStart; SourceId < SourceIdEnd; ++SourceId)
 		{
 			FSourceInfo& SourceInfo = SourceInfos[SourceId];
@@ -2818,13 +2856,27 @@ namespace Audio
 					HpfInputBuffer = SourceBuffer;
 
 					// process LPF audio block
-					SourceInfo.LowPassFilter.ProcessAudioBuffer(PreDistanceAttenBufferPtr, SourceBuffer, NumOutputSamplesThisSource);
+					if (bBatchFilters)
+					{
+						AddSourceFilterToBatch(SourceInfo.LowPassFilter, SourceInfo.LowPassFilterStates, PreDistanceAttenBufferPtr, SourceBuffer, InFilterBatch.LowPass);
+					}
+					else
+					{
+						SourceInfo.LowPassFilter.ProcessAudioBuffer(PreDistanceAttenBufferPtr, SourceBuffer, NumOutputSamplesThisSource);
+					}
 				}
 
 				if (!bBypassHPF)
 				{
 					// process HPF audio block
-					SourceInfo.HighPassFilter.ProcessAudioBuffer(HpfInputBuffer, SourceBuffer, NumOutputSamplesThisSource);
+					if (bBatchFilters)
+					{
+						AddSourceFilterToBatch(SourceInfo.HighPassFilter, SourceInfo.HighPassFilterStates, HpfInputBuffer, SourceBuffer, InFilterBatch.HighPass);
+					}
+					else
+					{
+						SourceInfo.HighPassFilter.ProcessAudioBuffer(HpfInputBuffer, SourceBuffer, NumOutputSamplesThisSource);
+					}
 				}
 
 #if UE_AUDIO_PROFILERTRACE_ENABLED
@@ -2867,28 +2919,55 @@ namespace Audio
 				}
 			}
 
-			if (SourceInfo.IsRenderingToSubmixes() || SpatialInterfaceInfo.bSpatializationIsExternalSend)
+			if (bBatchFilters)
 			{
-				// Apply distance attenuation
-				ApplyDistanceAttenuation(SourceInfo, NumSamples);
-
-				FMixerSourceSubmixOutputBuffer& SourceSubmixOutputBuffer = SourceSubmixOutputBuffers[SourceId];
-
-				// Send source audio to plugins
-				ComputePluginAudio(SourceInfo, SourceSubmixOutputBuffer, SourceId, NumSamples);
+				InFilterBatch.SourceIds.Add(SourceId);
 			}
+			else
+			{
+				ComputePostFilterBuffer(SourceId);
+			}
+		}
 
-			// Check the source effect tails condition
-			if (SourceInfo.bIsLastBuffer && SourceInfo.bEffectTailsDone)
+		if (bBatchFilters)
+		{
+			// The HPF of a source reads the output of its LPF, so all LPFs are processed first
+			InFilterBatch.LowPass.ProcessAudio(NumOutputFrames);
+			InFilterBatch.HighPass.ProcessAudio(NumOutputFrames);
+
+			for (const int32 SourceId : InFilterBatch.SourceIds)
 			{
-				// If we're done and our tails our done, clear everything out
-				SourceInfo.CurrentFrameValues.Reset();
-				SourceInfo.NextFrameValues.Reset();
-				SourceInfo.CurrentPCMBuffer = nullptr;
+				ComputePostFilterBuffer(SourceId);
 			}
 		}
 	}
 
+	void FMixerSourceManager::ComputePostFilterBuffer(const int32 SourceId)
+	{
+		FSourceInfo& SourceInfo = SourceInfos[SourceId];
+		const int32 NumSamples = SourceInfo.PreDistanceAttenuationBuffer.Num();
+
+		if (SourceInfo.IsRenderingToSubmixes() || SpatialInterfaceInfo.bSpatializationIsExternalSend)
+		{
+			// Apply distance attenuation
+			ApplyDistanceAttenuation(SourceInfo, NumSamples);
+
+			FMixerSourceSubmixOutputBuffer& SourceSubmixOutputBuffer = SourceSubmixOutputBuffers[SourceId];
+
+			// Send source audio to plugins
+			ComputePluginAudio(SourceInfo, SourceSubmixOutputBuffer, SourceId, NumSamples);
+		}
+
+		// Check the source effect tails condition
+		if (SourceInfo.bIsLastBuffer && SourceInfo.bEffectTailsDone)
+		{
+			// If we're done and our tails our done, clear everything out
+			SourceInfo.CurrentFrameValues.Reset();
+			SourceInfo.NextFrameValues.Reset();
+			SourceInfo.CurrentPCMBuffer = nullptr;
+		}
+	}
+
 	void FMixerSourceManager::ComputeOutputBuffersForIdRange(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd)
 	{
 		CSV_SCOPED_TIMING_STAT(Audio, SourceOutputBuffers);
@@ -2919,14 +2998,14 @@ namespace Audio
 		}
 	}
 
-	void FMixerSourceManager::GenerateSourceAudio(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd)
+	void FMixerSourceManager::GenerateSourceAudio(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd, FSourceFilterBatch& InFilterBatch)
 	{
 		// Buses generate their input buffers independently
 		// Get the next block of frames from the source buffers
 		ComputeSourceBuffersForIdRange(bGenerateBuses, SourceIdStart, SourceIdEnd);
 
 		// Compute the audio source buffers after their individual effect chain processing
-		ComputePostSourceEffectBufferForIdRange(bGenerateBuses, SourceIdStart, SourceIdEnd);
+		ComputePostSourceEffectBufferForIdRange(bGenerateBuses, SourceIdStart, SourceIdEnd, InFilterBatch);
 
 		// Get the audio for the output buffers
 		ComputeOutputBuffersForIdRange(bGenerateBuses, SourceIdStart, SourceIdEnd);
@@ -2962,7 +3041,7 @@ namespace Audio
 		}
 		else
 		{
-			GenerateSourceAudio(bGenerateBuses, 0, NumTotalSources);
+			GenerateSourceAudio(bGenerateBuses, 0, NumTotalSources, SourceFilterBatch);
 		}
 	}
 
@@ -9,6 +9,7 @@
 #include "AudioMixerSubmix.h"
 #include "AudioMixerTrace.h"
 #include "Containers/MpscQueue.h"
+#include "DSP/BiQuadFilterBatch.h"
 #include "DSP/BufferVectorOperations.h"
 #include "DSP/EnvelopeFollower.h"
 #include "DSP/InterpolatedOnePole.h"
@@ -317,11 +318,22 @@ namespace Audio
 		void ResetSourceEffectChain(const int32 SourceId);
 		void ReadSourceFrame(const int32 SourceId);
 
+		// Per-source filters of a range of sources, processed together once the effect chains of the range are done
+		struct FSourceFilterBatch
+		{
+			Audio::FBiquadFilterBatch LowPass;
+			Audio::FBiquadFilterBatch HighPass;
+
+			// Sources waiting for their filtered audio before computing distance attenuation and plugin sends
+			TArray<int32> SourceIds;
+		};
+
 		void GenerateSourceAudio(const bool bGenerateBuses);
-		void GenerateSourceAudio(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd);
+		void GenerateSourceAudio(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd, FSourceFilterBatch& InFilterBatch);
 
 		void ComputeSourceBuffersForIdRange(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd);
-		void ComputePostSourceEffectBufferForIdRange(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd);
+		void ComputePostSourceEffectBufferForIdRange(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd, FSourceFilterBatch& InFilterBatch);
+		void ComputePostFilterBuffer(const int32 SourceId);
 		void ComputeOutputBuffersForIdRange(const bool bGenerateBuses, const int32 SourceIdStart, const int32 SourceIdEnd);
 
 		void ComputeBuses();
@@ -364,6 +376,7 @@ namespace Audio
 			int32 StartSourceId;
 			int32 EndSourceId;
 			bool bGenerateBuses;
+			FSourceFilterBatch FilterBatch;
 
 		public:
 			FAudioMixerSourceWorker(FMixerSourceManager* InSourceManager, const int32 InStartSourceId, const int32 InEndSourceId)
@@ -381,7 +394,7 @@ namespace Audio
 
 			void DoWork()
 			{
-				SourceManager->GenerateSourceAudio(bGenerateBuses, StartSourceId, EndSourceId);
+				SourceManager->GenerateSourceAudio(bGenerateBuses, StartSourceId, EndSourceId, FilterBatch);
 			}
 
 			FORCEINLINE TStatId GetStatId() const
@@ -486,6 +499,10 @@ namespace Audio
 			Audio::FInterpolatedLPF LowPassFilter;
 			Audio::FInterpolatedHPF HighPassFilter;
 
+			// Delay terms of each channel of the LPF and HPF when they are processed in a batch with other sources
+			TArray<Audio::FBiquadFilterState> LowPassFilterStates;
+			TArray<Audio::FBiquadFilterState> HighPassFilterStates;
+
 			// Source effect instances
 			uint32 SourceEffectChainId;
 			TArray<TSoundEffectSourcePtr> SourceEffects;
@@ -608,6 +625,9 @@ namespace Audio
 		// Async task workers for processing sources in parallel
 		TArray<FAsyncTask<FAudioMixerSourceWorker>*> SourceWorkers;
 
+		// Filter batch used when sources are not processed by the source workers
+		FSourceFilterBatch SourceFilterBatch;
+
 		// Array of task data waiting to finished. Processed on audio render thread.
 		TArray<TSharedPtr<FMixerSourceBuffer, ESPMode::ThreadSafe>> PendingSourceBuffers;
 
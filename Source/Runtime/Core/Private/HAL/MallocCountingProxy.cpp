@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HAL/MallocCountingProxy.h"
+
+CORE_API bool GMallocCountingProxyEnabled = false;
+
+static FMallocCountingProxy* GMallocCountingProxy = nullptr;
+
+/** Allocations made by the thread through the proxy. Wraps around, FScopedMallocCount only looks at differences. */
+static thread_local uint32 GThreadAllocationCount = 0;
+
+uint32 FMallocCountingProxy::GetThreadAllocationCount()
+{
+	return GThreadAllocationCount;
+}
+
+bool FMallocCountingProxy::IsEnabled()
+{
+	return GMallocCountingProxy != nullptr;
+}
+
+void* FMallocCountingProxy::Malloc(SIZE_T Size, uint32 Alignment)
+{
+	++GThreadAllocationCount;
+	return UsedMalloc->Malloc(Size, Alignment);
+}
+
+void* FMallocCountingProxy::Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment)
+{
+	// Reallocating to 0 is a free
+	if (NewSize != 0)
+	{
+		++GThreadAllocationCount;
+	}
+	return UsedMalloc->Realloc(Ptr, NewSize, Alignment);
+}
+
+FMalloc* FMallocCountingProxy::OverrideIfEnabled(FMalloc* InUsedAlloc)
+{
+	if (GMallocCountingProxyEnabled && !GMallocCountingProxy)
+	{
+		GMallocCountingProxy = new FMallocCountingProxy(InUsedAlloc);
+		return GMallocCountingProxy;
+	}
+	return InUsedAlloc;
+}
@@ -36,6 +36,7 @@
 #include "Containers/Map.h"
 #include "Containers/StringView.h"
 #include "Containers/UnrealString.h"
+#include "Async/ParallelFor.h"
 #include "HAL/FileManager.h"
 #include "HAL/IConsoleManager.h"
 #include "Misc/App.h"
@@ -62,6 +63,8 @@
 const TCHAR* GDefaultChannels = TEXT("cpu,gpu,frame,log,bookmark,screenshot,region");
 const TCHAR* GMemoryChannels = TEXT("memtag,memalloc,callstack,module");
 const TCHAR* GTraceConfigSection = TEXT("Trace.Config");
+UE::Trace::ECodec GTraceCodec = UE::Trace::ECodec::Lz4;
+uint32 GTraceTailSeconds = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 CSV_DEFINE_CATEGORY(Trace, true);
@@ -708,6 +711,7 @@ void FTraceAuxiliaryImpl::UpdateCsvStats() const
 		CSV_CUSTOM_STAT(Trace, MemoryUsedMb,	double(Stats.MemoryUsed) / 1024.0 / 1024.0, ECsvCustomStatOp::Set);
 		CSV_CUSTOM_STAT(Trace, CacheUsedMb,		double(Stats.CacheUsed) / 1024.0 / 1024.0, ECsvCustomStatOp::Set);
 		CSV_CUSTOM_STAT(Trace, CacheWasteMb,	double(Stats.CacheWaste) / 1024.0 / 1024.0, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Trace, BlockPoolUsedMb,	double(Stats.BlockPoolUsed) / 1024.0 / 1024.0, ECsvCustomStatOp::Set);
 	}
 #endif
 }
@@ -776,6 +780,39 @@ void OnMessageCallback(const UE::Trace::FMessageEvent& Message)
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+static bool ParseTraceCodec(const TCHAR* Name, UE::Trace::ECodec& OutCodec)
+{
+	if (FCString::Stricmp(Name, TEXT("Lz4")) == 0)
+	{
+		OutCodec = UE::Trace::ECodec::Lz4;
+	}
+	else if (FCString::Stricmp(Name, TEXT("Lz4Fast")) == 0)
+	{
+		OutCodec = UE::Trace::ECodec::Lz4Fast;
+	}
+	else if (FCString::Stricmp(Name, TEXT("None")) == 0)
+	{
+		OutCodec = UE::Trace::ECodec::None;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static const TCHAR* LexTraceCodec(UE::Trace::ECodec Codec)
+{
+	switch (Codec)
+	{
+	case UE::Trace::ECodec::Lz4Fast:	return TEXT("Lz4Fast");
+	case UE::Trace::ECodec::None:		return TEXT("None");
+	default:							return TEXT("Lz4");
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 static void SetupInitFromConfig(UE::Trace::FInitializeDesc& OutDesc)
 {
@@ -798,6 +835,24 @@ static void SetupInitFromConfig(UE::Trace::FInitializeDesc& OutDesc)
 	{
 		OutDesc.TailSizeBytes = TailSizeBytesConfig;
 	}
+
+	int32 TailSecondsConfig = 0;
+	if (GConfig->GetInt(GTraceConfigSection, TEXT("TailSeconds"), TailSecondsConfig, GEngineIni))
+	{
+		OutDesc.TailSeconds = FMath::Max(TailSecondsConfig, 0);
+	}
+
+	FString CodecConfig;
+	if (GConfig->GetString(GTraceConfigSection, TEXT("Codec"), CodecConfig, GEngineIni))
+	{
+		if (!ParseTraceCodec(*CodecConfig, OutDesc.Codec))
+		{
+			UE_LOG(LogTrace, Warning, TEXT("Unknown trace codec '%s', expected Lz4, Lz4Fast or None"), *CodecConfig);
+		}
+	}
+
+	GTraceCodec = OutDesc.Codec;
+	GTraceTailSeconds = OutDesc.TailSeconds;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -935,6 +990,21 @@ static void TraceAuxiliaryStatus()
 		double(Stats.CacheWaste) * MiB);
 	UE_LOG(LogConsoleResponse, Display, TEXT("- Sent: %.02f MiB"),
 		double(Stats.BytesSent) * MiB);
+	UE_LOG(LogConsoleResponse, Display, TEXT("- Codec: %s, %.02f MiB encoded to %.02f MiB (%.02f ns/byte)"),
+		LexTraceCodec(GTraceCodec),
+		double(Stats.BytesEncoded) * MiB,
+		double(Stats.BytesEncodedOutput) * MiB,
+		Stats.BytesEncoded ? double(Stats.EncodeTimeNs) / double(Stats.BytesEncoded) : 0.0);
+	UE_LOG(LogConsoleResponse, Display, TEXT("- Block pool: %.02f MiB (%.02f MiB used, %.02f MiB peak | %u growths, %u waits)"),
+		double(Stats.BlockPoolAllocated) * MiB,
+		double(Stats.BlockPoolUsed) * MiB,
+		double(Stats.BlockPoolPeakUsed) * MiB,
+		Stats.BlockPoolGrowths,
+		Stats.BlockPoolWaits);
+	if (GTraceTailSeconds != 0)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("- Tail: last %u seconds"), GTraceTailSeconds);
+	}
 
 	// Channels
 	struct EnumerateType
@@ -1054,6 +1124,134 @@ static void TraceBookmark(const TArray<FString>& Args)
 	TRACE_BOOKMARK(TEXT("%s"), Args.Num() ? *Args[0] : TEXT(""));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+static void TraceAuxiliarySetCodec(const TArray<FString>& Args)
+{
+	if (Args.Num() != 1 || !ParseTraceCodec(*Args[0], GTraceCodec))
+	{
+		UE_LOG(LogConsoleResponse, Warning, TEXT("Invalid arguments. Usage: Trace.Codec <Lz4|Lz4Fast|None>"));
+		return;
+	}
+
+	UE::Trace::SetCodec(GTraceCodec);
+	UE_LOG(LogConsoleResponse, Display, TEXT("Trace codec: %s"), LexTraceCodec(GTraceCodec));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void TraceAuxiliarySetTailSeconds(const TArray<FString>& Args)
+{
+	int32 Seconds = -1;
+	if (Args.Num() != 1 || !LexTryParseString(Seconds, *Args[0]) || Seconds < 0)
+	{
+		UE_LOG(LogConsoleResponse, Warning, TEXT("Invalid arguments. Usage: Trace.TailSeconds <Seconds>"));
+		return;
+	}
+
+	GTraceTailSeconds = Seconds;
+	UE::Trace::SetTailSeconds(GTraceTailSeconds);
+	UE_LOG(LogConsoleResponse, Display, TEXT("Trace tail: %s"), Seconds ? *FString::Printf(TEXT("last %d seconds"), Seconds) : TEXT("unbounded"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+UE_TRACE_CHANNEL_DEFINE(TraceBenchmarkChannel)
+
+UE_TRACE_EVENT_BEGIN(TraceBenchmark, Event, NoSync)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Index)
+	UE_TRACE_EVENT_FIELD(uint32, Value)
+UE_TRACE_EVENT_END()
+
+////////////////////////////////////////////////////////////////////////////////
+static void TraceAuxiliaryBenchmark(const TArray<FString>& Args)
+{
+	int32 NumThreads = 4;
+	float Seconds = 1.0f;
+	if (Args.Num() >= 1)
+	{
+		LexFromString(NumThreads, *Args[0]);
+	}
+	if (Args.Num() >= 2)
+	{
+		LexFromString(Seconds, *Args[1]);
+	}
+	NumThreads = FMath::Clamp(NumThreads, 1, 64);
+	Seconds = FMath::Clamp(Seconds, 0.1f, 60.0f);
+
+	const bool bWasEnabled = TraceBenchmarkChannel.IsEnabled();
+	TraceBenchmarkChannel.Toggle(true);
+
+	// Events only reach the codec when they are being sent or kept in the tail.
+	UE_LOG(LogConsoleResponse, Display, TEXT("Trace benchmark: %d threads writing events for %.1f seconds%s"),
+		NumThreads, Seconds, UE::Trace::IsTracing() ? TEXT("") : TEXT(" (not tracing, only the tail is encoded)"));
+
+	auto RunStorm = [NumThreads, Seconds] (const TCHAR* Label, UE::Trace::ECodec Codec, uint32 TailSeconds)
+	{
+		UE::Trace::SetCodec(Codec);
+		UE::Trace::SetTailSeconds(TailSeconds);
+
+		UE::Trace::FStatistics Before;
+		UE::Trace::GetStatistics(Before);
+
+		std::atomic<uint64> NumEvents(0);
+		const double EndTime = FPlatformTime::Seconds() + Seconds;
+		ParallelFor(NumThreads, [&NumEvents, EndTime] (int32 ThreadIndex)
+		{
+			// Mimics timing events; the value has some redundancy but isn't constant.
+			uint64 Count = 0;
+			uint32 Value = ThreadIndex;
+			while (FPlatformTime::Seconds() < EndTime)
+			{
+				for (uint32 i = 0; i < 1024; ++i, ++Count)
+				{
+					Value = (Value * 1103515245u) + 12345u;
+					UE_TRACE_LOG(TraceBenchmark, Event, TraceBenchmarkChannel)
+						<< Event.Cycle(FPlatformTime::Cycles64())
+						<< Event.Index(i)
+						<< Event.Value(Value >> 24);
+				}
+			}
+			NumEvents += Count;
+		}, EParallelForFlags::Unbalanced);
+
+		// Wait for the worker to drain what was written so it is accounted for.
+		UE::Trace::FStatistics After;
+		for (int32 Retry = 0; Retry < 200; ++Retry)
+		{
+			UE::Trace::GetStatistics(After);
+			if (After.BlockPoolUsed <= Before.BlockPoolUsed)
+			{
+				break;
+			}
+			FPlatformProcess::Sleep(0.01f);
+		}
+
+		const double EncodedBytes = double(After.BytesEncoded - Before.BytesEncoded);
+		const double EncodedOutput = double(After.BytesEncodedOutput - Before.BytesEncodedOutput);
+		const double EncodeNs = double(After.EncodeTimeNs - Before.EncodeTimeNs);
+		UE_LOG(LogConsoleResponse, Display, TEXT("%-16s %8.2f Mevents/s  %8.2f MiB traced  encode %.3f ns/byte, ratio %.3f  pool %u growths, %u waits, %.2f MiB peak"),
+			Label,
+			double(NumEvents.load()) / (Seconds * 1000000.0),
+			double(After.BytesTraced - Before.BytesTraced) / (1024.0 * 1024.0),
+			EncodedBytes > 0.0 ? EncodeNs / EncodedBytes : 0.0,
+			EncodedBytes > 0.0 ? EncodedOutput / EncodedBytes : 1.0,
+			After.BlockPoolGrowths - Before.BlockPoolGrowths,
+			After.BlockPoolWaits - Before.BlockPoolWaits,
+			double(After.BlockPoolPeakUsed) / (1024.0 * 1024.0));
+	};
+
+	RunStorm(TEXT("Lz4"), UE::Trace::ECodec::Lz4, 0);
+	RunStorm(TEXT("Lz4Fast"), UE::Trace::ECodec::Lz4Fast, 0);
+	RunStorm(TEXT("None"), UE::Trace::ECodec::None, 0);
+	RunStorm(TEXT("Lz4 tail 1s"), UE::Trace::ECodec::Lz4, 1);
+
+	UE::Trace::SetCodec(GTraceCodec);
+	UE::Trace::SetTailSeconds(GTraceTailSeconds);
+	if (!bWasEnabled)
+	{
+		TraceBenchmarkChannel.Toggle(false);
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 static FAutoConsoleCommand TraceAuxiliarySendCmd(
 	TEXT("Trace.Send"),
@@ -1146,6 +1344,30 @@ static FAutoConsoleCommand TraceAuxiliarySnapshotSendCmd(
 	FConsoleCommandWithArgsDelegate::CreateStatic(TraceAuxiliarySnapshotSend)
 );
 
+////////////////////////////////////////////////////////////////////////////////
+static FAutoConsoleCommand TraceAuxiliaryCodecCmd(
+	TEXT("Trace.Codec"),
+	TEXT("<Lz4|Lz4Fast|None> - Sets how trace data is compressed. Lz4Fast encodes faster but compresses less, None sends data uncompressed."
+	),
+	FConsoleCommandWithArgsDelegate::CreateStatic(TraceAuxiliarySetCodec)
+);
+
+////////////////////////////////////////////////////////////////////////////////
+static FAutoConsoleCommand TraceAuxiliaryTailSecondsCmd(
+	TEXT("Trace.TailSeconds"),
+	TEXT("<Seconds> - Limits the in-memory tail buffer to events of the last N seconds, so snapshots only hold those. 0 keeps as much as fits."
+	),
+	FConsoleCommandWithArgsDelegate::CreateStatic(TraceAuxiliarySetTailSeconds)
+);
+
+////////////////////////////////////////////////////////////////////////////////
+static FAutoConsoleCommand TraceAuxiliaryBenchmarkCmd(
+	TEXT("Trace.Benchmark"),
+	TEXT("[Threads] [Seconds] - Writes a storm of small events from several threads with each codec, and with a time bounded tail, and reports the throughput, encoding cost and block pool pressure."
+	),
+	FConsoleCommandWithArgsDelegate::CreateStatic(TraceAuxiliaryBenchmark)
+);
+
 ////////////////////////////////////////////////////////////////////////////////
 static FAutoConsoleCommand TraceBookmarkCmd(
 	TEXT("Trace.Bookmark"),
@@ -1946,6 +1946,12 @@ public:
 	template<class... Args> FAutoConsoleCommandWithWorldArgsAndOutputDevice(const Args&...) {}
 };
 
+class FAutoConsoleCommandWithArgsAndOutputDevice
+{
+public:
+	template<class... Args> FAutoConsoleCommandWithArgsAndOutputDevice(const Args&...) {}
+};
+
 #endif
 
 CORE_API DECLARE_LOG_CATEGORY_EXTERN(LogConsoleResponse, Log, All);
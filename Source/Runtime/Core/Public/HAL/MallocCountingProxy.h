@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "HAL/MemoryBase.h"
+
+/**
+ * FMalloc proxy that counts the allocations made by each thread, so code can measure the heap allocations made by a
+ * scope with FScopedMallocCount. Installed with -malloccounting on the command line.
+ */
+class FMallocCountingProxy : public FMalloc
+{
+private:
+	/** Malloc we're based on, aka using under the hood */
+	FMalloc* UsedMalloc;
+
+public:
+	explicit FMallocCountingProxy(FMalloc* InMalloc)
+		: UsedMalloc(InMalloc)
+	{
+		checkf(UsedMalloc, TEXT("FMallocCountingProxy is used without a valid malloc!"));
+	}
+
+	/** Number of allocations and reallocations the calling thread has made through the proxy */
+	static CORE_API uint32 GetThreadAllocationCount();
+
+	/** Whether the proxy is installed, i.e. whether allocations are being counted */
+	static CORE_API bool IsEnabled();
+
+	static CORE_API FMalloc* OverrideIfEnabled(FMalloc* InUsedAlloc);
+
+	// FMalloc interface begin
+	virtual void InitializeStatsMetadata() override
+	{
+		UsedMalloc->InitializeStatsMetadata();
+	}
+
+	CORE_API virtual void* Malloc(SIZE_T Size, uint32 Alignment) override;
+	CORE_API virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override;
+
+	virtual void Free(void* Ptr) override
+	{
+		UsedMalloc->Free(Ptr);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return UsedMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual void UpdateStats() override
+	{
+		UsedMalloc->UpdateStats();
+	}
+
+	virtual void GetAllocatorStats(FGenericMemoryStats& out_Stats) override
+	{
+		UsedMalloc->GetAllocatorStats(out_Stats);
+	}
+
+	virtual void DumpAllocatorStats(class FOutputDevice& Ar) override
+	{
+		UsedMalloc->DumpAllocatorStats(Ar);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return UsedMalloc->IsInternallyThreadSafe();
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return UsedMalloc->ValidateHeap();
+	}
+
+#if UE_ALLOW_EXEC_COMMANDS
+	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar) override
+	{
+		return UsedMalloc->Exec(InWorld, Cmd, Ar);
+	}
+#endif // UE_ALLOW_EXEC_COMMANDS
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return UsedMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return UsedMalloc->GetDescriptiveName();
+	}
+
+	virtual void Trim(bool bTrimThreadCaches) override
+	{
+		UsedMalloc->Trim(bTrimThreadCaches);
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual void OnMallocInitialized() override
+	{
+		UsedMalloc->OnMallocInitialized();
+	}
+
+	virtual void OnPreFork() override
+	{
+		UsedMalloc->OnPreFork();
+	}
+
+	virtual void OnPostFork() override
+	{
+		UsedMalloc->OnPostFork();
+	}
+	// FMalloc interface end
+};
+
+/**
+ * Counts the allocations the current thread makes while the scope is open. Always 0 when FMallocCountingProxy isn't installed.
+ * Counts are per thread: allocations made by tasks the scope launches or waits on run on other threads and are not counted,
+ * unless the waiting thread ends up running them itself.
+ */
+struct FScopedMallocCount
+{
+	FScopedMallocCount()
+		: StartCount(FMallocCountingProxy::GetThreadAllocationCount())
+	{
+	}
+
+	/** Number of allocations and reallocations made by this thread since the scope was opened */
+	uint32 GetNumAllocations() const
+	{
+		return FMallocCountingProxy::GetThreadAllocationCount() - StartCount;
+	}
+
+private:
+	uint32 StartCount;
+};
+
+extern CORE_API bool GMallocCountingProxyEnabled;
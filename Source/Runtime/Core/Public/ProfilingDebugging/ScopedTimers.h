@@ -240,6 +240,21 @@ private:
 	double& TotalTime;
 };
 
+namespace UE
+{
+	/** Runs an operation Iterations times, returning the average duration of a run in seconds */
+	template<typename OperationType>
+	double TimeAverageDuration(int32 Iterations, OperationType&& Operation)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Operation();
+		}
+		return (FPlatformTime::Seconds() - StartTime) / Iterations;
+	}
+}
+
 #if NO_LOGGING
 #define UE_SCOPED_TIMER(Title, Category, Verbosity)
 #else
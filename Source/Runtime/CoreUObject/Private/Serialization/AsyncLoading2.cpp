@@ -65,6 +65,7 @@
 #include "ProfilingDebugging/CountersTrace.h"
 #include "ProfilingDebugging/AssetMetadataTrace.h"
 #include "Async/Async.h"
+#include "Async/Fundamental/Task.h"
 #include "Async/ParallelFor.h"
 #include "HAL/LowLevelMemStats.h"
 #include "HAL/IPlatformFileOpenLogWrapper.h"
@@ -78,6 +79,7 @@
 #include "IO/IoPriorityQueue.h"
 #include "UObject/CoreRedirects.h"
 #include "ZenPackageHeader.h"
+#include "AsyncPackageTimings.h"
 
 #include <atomic>
 
@@ -407,6 +409,53 @@ static FAutoConsoleVariableRef CVarGOnlyProcessRequiredPackagesWhenSyncLoading(
 	ECVF_Default
 );
 
+static bool GParallelAsyncPostLoad = false;
+static FAutoConsoleVariableRef CVarGParallelAsyncPostLoad(
+	TEXT("s.ParallelAsyncPostLoad"),
+	GParallelAsyncPostLoad,
+	TEXT("Route PostLoad of IsPostLoadThreadSafe exports on task workers in parallel instead of one by one on the thread that PostLoads them: ")
+	TEXT("the async loading thread with s.AsyncPostLoadEnabled, the game thread's deferred PostLoad otherwise. ")
+	TEXT("Exports are scheduled after their outer and archetype, PostLoad must not PostLoad any other object of the same package."),
+	ECVF_Default
+);
+
+static int32 GParallelAsyncPostLoadMinExports = 8;
+static FAutoConsoleVariableRef CVarGParallelAsyncPostLoadMinExports(
+	TEXT("s.ParallelAsyncPostLoad.MinExports"),
+	GParallelAsyncPostLoadMinExports,
+	TEXT("Minimum number of exports in an export bundle that can be PostLoaded in parallel for s.ParallelAsyncPostLoad to be used."),
+	ECVF_Default
+);
+
+struct FAsyncPackage2;
+
+/** Set on task workers while they route PostLoad to an export for s.ParallelAsyncPostLoad */
+struct FParallelPostLoadContext
+{
+	FAsyncPackage2* Package = nullptr;
+
+	/**
+	 * Task running the PostLoad. Tasks the worker picks up while PostLoad busy-waits run as other low level tasks and don't see
+	 * the context. Tasks retracted and run inline by a wait in PostLoad do, like the tasks the async loading thread runs inline.
+	 */
+	const LowLevelTasks::FTask* LowLevelTask = nullptr;
+};
+static thread_local const FParallelPostLoadContext* GParallelPostLoadContext = nullptr;
+
+/** Guards FAsyncPackage2::ConstructedObjects against objects constructed from parallel PostLoad */
+static FCriticalSection GParallelAsyncPostLoadCritical;
+
+/** Returns the package the current task routes a parallel PostLoad for, null outside of it including from unrelated work run inline by the worker */
+static FAsyncPackage2* GetParallelPostLoadPackage()
+{
+	const FParallelPostLoadContext* Context = GParallelPostLoadContext;
+	if (Context && Context->LowLevelTask == LowLevelTasks::FTask::GetActiveTask())
+	{
+		return Context->Package;
+	}
+	return nullptr;
+}
+
 CSV_DECLARE_CATEGORY_MODULE_EXTERN(CORE_API, Basic);
 CSV_DECLARE_CATEGORY_MODULE_EXTERN(CORE_API, FileIO);
 
@@ -494,6 +543,8 @@ struct FPackageRequest
 	FPackagePath PackagePath;
 	TUniquePtr<FLoadPackageAsyncDelegate> PackageLoadedDelegate;
 	FPackageRequest* Next = nullptr;
+	// Time the request was queued, only set when recording package timings
+	double QueuedTime = 0.0;
 
 	FLinkerInstancingContext* GetInstancingContext()
 	{
@@ -521,7 +572,8 @@ struct FPackageRequest
 			CustomName,
 			PackagePath,
 			MoveTemp(PackageLoadedDelegate),
-			nullptr
+			nullptr,
+			UE::AsyncLoading::PackageTimings::IsEnabled() ? FPlatformTime::Seconds() : 0.0
 		};
 	}
 };
@@ -2630,6 +2682,9 @@ struct FAsyncPackage2
 	/** Creates GC clusters from loaded objects */
 	EAsyncPackageState::Type CreateClusters(FAsyncLoadingThreadState2& ThreadState);
 
+	/** Routes PostLoad to the thread safe exports of an export bundle on task workers, returns false if there were too few to go parallel */
+	bool ParallelPostLoadExports(const FAsyncPackageHeaderData& Header);
+
 	void ImportPackagesRecursive(FAsyncLoadingThreadState2& ThreadState, FIoBatch& IoBatch, FPackageStore& PackageStore);
 	void StartLoading(FAsyncLoadingThreadState2& ThreadState, FIoBatch& IoBatch);
 
@@ -2810,6 +2865,9 @@ private:
 	/** Set when the package is being loaded as an instance; null otherwise. */
 	TUniquePtr<FLinkerInstancingContext> InstanceContext;
 
+	/** Phase timings reported by s.DumpPackageTimings */
+	UE::AsyncLoading::PackageTimings::FAsyncPackageTimings Timings;
+
 public:
 
 	FAsyncLoadingThread2& GetAsyncLoadingThread()
@@ -3164,6 +3222,7 @@ public:
 			// to make it behave exactly like the non-threaded version
 			uint32 CurrentThreadId = FPlatformTLS::GetCurrentThreadId();
 			if (CurrentThreadId == AsyncLoadingThreadID ||
+				GetParallelPostLoadPackage() != nullptr ||
 				(IsInGameThread() && GetIsInAsyncLoadingTick()))
 			{
 				return true;
@@ -4163,6 +4222,10 @@ bool FAsyncLoadingThread2::CreateAsyncPackagesFromQueue(FAsyncLoadingThreadState
 				{
 					UE_ASYNC_PACKAGE_LOG(Verbose, PackageDesc, TEXT("CreateAsyncPackages: AddPackage"),
 						TEXT("Start loading package."));
+					if (Package->Timings.bEnabled && Request.QueuedTime > 0.0)
+					{
+						Package->Timings.QueuedTime = Request.QueuedTime;
+					}
 #if !UE_BUILD_SHIPPING
 					if (FileOpenLogWrapper)
 					{
@@ -4991,6 +5054,7 @@ void FAsyncPackage2::StartLoading(FAsyncLoadingThreadState2& ThreadState, FIoBat
 	TRACE_CPUPROFILER_EVENT_SCOPE(StartLoading);
 
 	LoadStartTime = FPlatformTime::Seconds();
+	Timings.StartLoadingTime = LoadStartTime;
 
 	AsyncPackageLoadingState = EAsyncPackageLoadingState2::WaitingForIo;
 
@@ -5049,6 +5113,7 @@ void FAsyncPackage2::StartLoading(FAsyncLoadingThreadState2& ThreadState, FIoBat
 			{
 				TRACE_COUNTER_ADD(AsyncLoadingTotalLoaded, Result.ValueOrDie().DataSize());
 				CSV_CUSTOM_STAT_DEFINED(FrameCompletedExportBundleLoadsKB, float((double)Result.ValueOrDie().DataSize() / 1024.0), ECsvCustomStatOp::Accumulate);
+				Timings.IoBytes = Result.ValueOrDie().DataSize();
 			}
 			else
 			{
@@ -5056,6 +5121,10 @@ void FAsyncPackage2::StartLoading(FAsyncLoadingThreadState2& ThreadState, FIoBat
 					TEXT("Failed reading chunk for package: %s"), *Result.Status().ToString());
 				bLoadHasFailed = true;
 			}
+			if (Timings.bEnabled)
+			{
+				Timings.IoCompletedTime = FPlatformTime::Seconds();
+			}
 			int32 LocalPendingIoRequestsCounter = AsyncLoadingThread.PendingIoRequestsCounter.DecrementExchange() - 1;
 			TRACE_COUNTER_SET(AsyncLoadingPendingIoRequests, LocalPendingIoRequestsCounter);
 			FAsyncLoadingThread2& LocalAsyncLoadingThread = AsyncLoadingThread;
@@ -5570,6 +5639,7 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_ProcessPackageSummary(FAsync
 	Package->AsyncPackageLoadingState = EAsyncPackageLoadingState2::ProcessPackageSummary;
 
 	FAsyncPackageScope2 Scope(Package);
+	UE::AsyncLoading::PackageTimings::FPhaseScope TimingScope(Package->Timings, Package->Timings.SummarySeconds);
 
 #if WITH_EDITOR
 	UE::Core::Private::FPlayInEditorLoadingScope PlayInEditorIDScope(Package->Desc.PIEInstanceID);
@@ -5668,6 +5738,9 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_ProcessPackageSummary(FAsync
 		}
 
 		TRACE_LOADTIME_PACKAGE_SUMMARY(Package, Package->HeaderData.PackageName, Package->HeaderData.PackageSummary->HeaderSize, Package->HeaderData.ImportMap.Num(), Package->HeaderData.ExportMap.Num());
+		Package->Timings.ImportCount = Package->HeaderData.ImportMap.Num();
+		Package->Timings.ImportedPackageCount = Package->HeaderData.ImportedPackageIds.Num();
+		Package->Timings.ExportCount = Package->HeaderData.ExportMap.Num();
 	}
 
 	Package->AsyncLoadingThread.FinishInitializeAsyncPackage(ThreadState, Package);
@@ -5736,6 +5809,7 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_ProcessExportBundle(FAsyncLo
 	Package->AsyncPackageLoadingState = EAsyncPackageLoadingState2::ProcessExportBundles;
 
 	FAsyncPackageScope2 Scope(Package);
+	UE::AsyncLoading::PackageTimings::FPhaseScope TimingScope(Package->Timings, Package->Timings.SerializeSeconds);
 #if WITH_EDITOR
 	UE::Core::Private::FPlayInEditorLoadingScope PlayInEditorIDScope(Package->Desc.PIEInstanceID);
 #endif
@@ -6688,6 +6762,7 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_PostLoadExportBundle(FAsyncL
 	check(Package->ExternalReadDependencies.Num() == 0);
 
 	FAsyncPackageScope2 PackageScope(Package);
+	UE::AsyncLoading::PackageTimings::FPhaseScope TimingScope(Package->Timings, Package->Timings.PostLoadSeconds);
 
 #if ALT2_ENABLE_LINKERLOAD_SUPPORT
 	if (Package->LinkerLoadState.IsSet())
@@ -6760,6 +6835,13 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_PostLoadExportBundle(FAsyncL
 #endif
 
 		TRACE_LOADTIME_POSTLOAD_SCOPE;
+		if (GParallelAsyncPostLoad && (!bIsMultithreaded || bAsyncPostLoadEnabled) && Package->ExportBundleEntryIndex == 0 &&
+			Package->ParallelPostLoadExports(*HeaderData) && bIsMultithreaded)
+		{
+			// Everything that can be PostLoaded on this thread is done, the rest is left for the deferred PostLoad.
+			// Without the async loading thread the loop below PostLoads the rest and skips the exports already PostLoaded.
+			Package->ExportBundleEntryIndex = HeaderData->ExportBundleEntriesCopyForPostLoad.Num();
+		}
 		while (Package->ExportBundleEntryIndex < HeaderData->ExportBundleEntriesCopyForPostLoad.Num())
 		{
 			const FExportBundleEntry& BundleEntry = HeaderData->ExportBundleEntriesCopyForPostLoad[Package->ExportBundleEntryIndex];
@@ -6834,6 +6916,164 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_PostLoadExportBundle(FAsyncL
 	return EEventLoadNodeExecutionResult::Complete;
 }
 
+bool FAsyncPackage2::ParallelPostLoadExports(const FAsyncPackageHeaderData& Header)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(ParallelPostLoadExports);
+
+	// Per local export: the wave it is PostLoaded in, or one of these states
+	enum : int32
+	{
+		NotThreadSafe = -1,
+		Unvisited = -2,
+		Visiting = -3,
+		Sequential = -4,
+	};
+
+	TArray<int32, TInlineAllocator<256>> Waves;
+	Waves.Init(NotThreadSafe, Header.ExportsView.Num());
+	TArray<int32, TInlineAllocator<256>> Candidates;
+	for (const FExportBundleEntry& BundleEntry : Header.ExportBundleEntriesCopyForPostLoad)
+	{
+		if (BundleEntry.CommandType != FExportBundleEntry::ExportCommandType_Serialize)
+		{
+			continue;
+		}
+		const FExportObject& Export = Header.ExportsView[BundleEntry.LocalExportIndex];
+		if (Export.bFiltered | Export.bExportLoadFailed)
+		{
+			continue;
+		}
+		UObject* Object = Export.Object;
+		check(Object);
+		if (Object->HasAnyFlags(RF_NeedPostLoad) && CanPostLoadOnAsyncLoadingThread(Object))
+		{
+			check(Object->IsReadyForAsyncPostLoad());
+			Waves[BundleEntry.LocalExportIndex] = Unvisited;
+			Candidates.Add(BundleEntry.LocalExportIndex);
+		}
+	}
+	if (Candidates.Num() < GParallelAsyncPostLoadMinExports)
+	{
+		return false;
+	}
+
+	// ConditionalPostLoad routes PostLoad to the archetype first, and the sequential pass PostLoads outers before their inners
+	// because the bundle lists them in that order. An export is scheduled in a later wave than those of its outer and archetype
+	// that still need PostLoad to keep both orders. Exports depending on anything that is not scheduled run sequentially afterwards.
+	struct FWaveBuilder
+	{
+		const FAsyncPackageHeaderData& Header;
+		TArray<int32, TInlineAllocator<256>>& Waves;
+
+		int32 GetDependencyWave(FPackageObjectIndex DependencyIndex, UObject* Dependency)
+		{
+			if (DependencyIndex.IsExport())
+			{
+				const int32 LocalDependencyIndex = DependencyIndex.ToExport();
+				if (Waves[LocalDependencyIndex] != NotThreadSafe)
+				{
+					return GetWave(LocalDependencyIndex);
+				}
+				Dependency = Header.ExportsView[LocalDependencyIndex].Object;
+			}
+			return (Dependency && Dependency->HasAnyFlags(RF_NeedPostLoad)) ? Sequential : -1;
+		}
+
+		int32 GetWave(int32 LocalExportIndex)
+		{
+			int32& Wave = Waves[LocalExportIndex];
+			if (Wave != Unvisited)
+			{
+				// Visiting means the dependencies are circular, leave those to the sequential pass
+				return Wave == Visiting ? Sequential : Wave;
+			}
+			Wave = Visiting;
+			const FExportMapEntry& ExportMapEntry = Header.ExportMap[LocalExportIndex];
+			const FExportObject& Export = Header.ExportsView[LocalExportIndex];
+			const int32 OuterWave = GetDependencyWave(ExportMapEntry.OuterIndex, Export.Object->GetOuter());
+			const int32 TemplateWave = OuterWave == Sequential ? Sequential : GetDependencyWave(ExportMapEntry.TemplateIndex, Export.TemplateObject);
+			const int32 Result = TemplateWave == Sequential ? Sequential : FMath::Max(OuterWave, TemplateWave) + 1;
+			Waves[LocalExportIndex] = Result;
+			return Result;
+		}
+	};
+
+	FWaveBuilder WaveBuilder{ Header, Waves };
+	int32 MaxWave = -1;
+	int32 ParallelCount = 0;
+	for (int32 LocalExportIndex : Candidates)
+	{
+		const int32 Wave = WaveBuilder.GetWave(LocalExportIndex);
+		if (Wave >= 0)
+		{
+			MaxWave = FMath::Max(MaxWave, Wave);
+			++ParallelCount;
+		}
+	}
+	if (ParallelCount < GParallelAsyncPostLoadMinExports)
+	{
+		return false;
+	}
+
+	TArray<UObject*, TInlineAllocator<256>> WaveObjects;
+	for (int32 Wave = 0; Wave <= MaxWave; ++Wave)
+	{
+		WaveObjects.Reset();
+		for (int32 LocalExportIndex : Candidates)
+		{
+			if (Waves[LocalExportIndex] == Wave)
+			{
+				WaveObjects.Add(Header.ExportsView[LocalExportIndex].Object);
+			}
+		}
+		ParallelFor(TEXT("ParallelPostLoadTask"), WaveObjects.Num(), 1, [this, &WaveObjects](int32 Index)
+		{
+			UObject* Object = WaveObjects[Index];
+
+			// PostLoad must not PostLoad other exports of the package, which may be PostLoading on another worker right now
+			if (!ensureMsgf(Object->HasAnyFlags(RF_NeedPostLoad), TEXT("%s was PostLoaded by another export of its package during parallel PostLoad"), *Object->GetFullName()))
+			{
+				return;
+			}
+
+			const FParallelPostLoadContext Context{ this, LowLevelTasks::FTask::GetActiveTask() };
+			TGuardValue<const FParallelPostLoadContext*> GuardContext(GParallelPostLoadContext, &Context);
+			FAsyncPackageScope2 PackageScope(this);
+
+			// Like the sequential PostLoad, loads started from PostLoad see a load in progress on this thread
+			BeginAsyncLoad();
+			{
+				TGuardValue<bool> GuardIsRoutingPostLoad(PackageScope.ThreadContext.IsRoutingPostLoad, true);
+				TGuardValue<UObject*> GuardCurrentlyPostLoadedObject(PackageScope.ThreadContext.CurrentlyPostLoadedObjectByALT, Object);
+				Object->ConditionalPostLoad();
+			}
+			EndAsyncLoad();
+		});
+
+		for (int32 LocalExportIndex : Candidates)
+		{
+			const int32 ExportWave = Waves[LocalExportIndex];
+			UObject* Object = Header.ExportsView[LocalExportIndex].Object;
+			ensureMsgf((ExportWave >= 0 && ExportWave <= Wave) || Object->HasAnyFlags(RF_NeedPostLoad),
+				TEXT("%s was PostLoaded by another export of its package during parallel PostLoad"), *Object->GetFullName());
+		}
+	}
+
+	FUObjectThreadContext& ThreadContext = FUObjectThreadContext::Get();
+	for (int32 LocalExportIndex : Candidates)
+	{
+		if (Waves[LocalExportIndex] == Sequential)
+		{
+			UObject* Object = Header.ExportsView[LocalExportIndex].Object;
+			ThreadContext.CurrentlyPostLoadedObjectByALT = Object;
+			Object->ConditionalPostLoad();
+			ThreadContext.CurrentlyPostLoadedObjectByALT = nullptr;
+		}
+	}
+
+	return true;
+}
+
 EEventLoadNodeExecutionResult FAsyncPackage2::Event_DeferredPostLoadExportBundle(FAsyncLoadingThreadState2& ThreadState, FAsyncPackage2* Package, int32 InExportBundleIndex)
 {
 	SCOPE_CYCLE_COUNTER(STAT_FAsyncPackage_PostLoadObjectsGameThread);
@@ -6843,6 +7083,7 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_DeferredPostLoadExportBundle
 
 	FAsyncPackageScope2 PackageScope(Package);
 	TGuardValue<bool> GuardIsRoutingPostLoad(PackageScope.ThreadContext.IsRoutingPostLoad, true);
+	UE::AsyncLoading::PackageTimings::FPhaseScope TimingScope(Package->Timings, Package->Timings.DeferredPostLoadSeconds);
 
 #if ALT2_ENABLE_LINKERLOAD_SUPPORT
 	if (Package->LinkerLoadState.IsSet())
@@ -6882,6 +7123,12 @@ EEventLoadNodeExecutionResult FAsyncPackage2::Event_DeferredPostLoadExportBundle
 #endif
 
 		TRACE_LOADTIME_POSTLOAD_SCOPE;
+		if (GParallelAsyncPostLoad && Package->ExportBundleEntryIndex == 0)
+		{
+			// Thread safe exports are only left for the game thread when the async loading thread didn't PostLoad them,
+			// the remaining exports are PostLoaded below in bundle order and skip the ones PostLoaded in parallel
+			Package->ParallelPostLoadExports(*HeaderData);
+		}
 		while (Package->ExportBundleEntryIndex < HeaderData->ExportBundleEntriesCopyForPostLoad.Num())
 		{
 			const FExportBundleEntry& BundleEntry = HeaderData->ExportBundleEntriesCopyForPostLoad[Package->ExportBundleEntryIndex];
@@ -7254,6 +7501,11 @@ EAsyncPackageState::Type FAsyncLoadingThread2::ProcessLoadedPackagesFromGameThre
 
 			Package->FinishUPackage();
 
+			if (Package->Timings.bEnabled)
+			{
+				UE::AsyncLoading::PackageTimings::AddRecord(Package->Desc.UPackageName, Package->Timings, FPlatformTime::Seconds(), Package->bLoadHasFailed);
+			}
+
 			{
 				FScopeLock LockAsyncPackages(&AsyncPackagesCritical);
 				AsyncPackageLookup.Remove(Package->Desc.UPackageId);
@@ -8061,7 +8313,15 @@ void FAsyncLoadingThread2::NotifyConstructedDuringAsyncLoading(UObject* Object,
 		Object->SetInternalFlags(EInternalObjectFlags::AsyncLoading);
 	}
 	FAsyncPackage2* AsyncPackage2 = (FAsyncPackage2*)ThreadContext.AsyncPackage;
-	AsyncPackage2->AddConstructedObject(Object, bSubObjectThatAlreadyExists);
+	if (GetParallelPostLoadPackage() == AsyncPackage2)
+	{
+		FScopeLock Lock(&GParallelAsyncPostLoadCritical);
+		AsyncPackage2->AddConstructedObject(Object, bSubObjectThatAlreadyExists);
+	}
+	else
+	{
+		AsyncPackage2->AddConstructedObject(Object, bSubObjectThatAlreadyExists);
+	}
 }
 
 void FAsyncLoadingThread2::NotifyRegistrationEvent(
@@ -8110,6 +8370,12 @@ FAsyncPackage2::FAsyncPackage2(
 	TRACE_LOADTIME_NEW_ASYNC_PACKAGE(this);
 	AddRequestID(Desc.RequestID);
 
+	Timings.bEnabled = UE::AsyncLoading::PackageTimings::IsEnabled();
+	if (Timings.bEnabled)
+	{
+		Timings.QueuedTime = FPlatformTime::Seconds();
+	}
+
 	CreatePackageNodes(EventSpecs);
 
 	ImportStore.AddPackageReference(Desc);
@@ -8759,3 +9025,57 @@ IAsyncPackageLoader* MakeAsyncPackageLoader2(FIoDispatcher& InIoDispatcher, IAsy
 {
 	return new FAsyncLoadingThread2(InIoDispatcher, InUncookedPackageLoader);
 }
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelAsyncPostLoadBenchmark, "System.Core.Loading.ParallelAsyncPostLoad.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter);
+
+/** Loads the packages given as space separated parameters with s.ParallelAsyncPostLoad off and on, and compares the load times */
+bool FParallelAsyncPostLoadBenchmark::RunTest(const FString& Parameters)
+{
+	TArray<FString> PackageNames;
+	Parameters.ParseIntoArrayWS(PackageNames);
+	if (PackageNames.IsEmpty())
+	{
+		AddWarning(TEXT("No packages to load, pass the long package names of packages with many thread safe exports as parameters."));
+		return true;
+	}
+
+	constexpr int32 NumIterations = 5;
+	double Seconds[2] = { 0.0, 0.0 };
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		for (bool bParallel : { false, true })
+		{
+			TGuardValue<bool> GuardParallelAsyncPostLoad(GParallelAsyncPostLoad, bParallel);
+
+			// Each load starts from unloaded packages so that both modes PostLoad every export
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			for (const FString& PackageName : PackageNames)
+			{
+				if (FindObjectFast<UPackage>(nullptr, FName(*PackageName)))
+				{
+					AddWarning(FString::Printf(TEXT("%s is still loaded and is not PostLoaded again."), *PackageName));
+				}
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (const FString& PackageName : PackageNames)
+			{
+				LoadPackageAsync(PackageName);
+			}
+			FlushAsyncLoading();
+			Seconds[bParallel] += FPlatformTime::Seconds() - StartTime;
+		}
+	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	AddInfo(FString::Printf(TEXT("%d packages, average of %d loads: sequential PostLoad %.2fms, parallel PostLoad %.2fms (s.AsyncPostLoadEnabled=%s)"),
+		PackageNames.Num(), NumIterations, Seconds[false] * 1000.0 / NumIterations, Seconds[true] * 1000.0 / NumIterations,
+		FAsyncLoadingThreadSettings::Get().bAsyncPostLoadEnabled ? TEXT("true") : TEXT("false")));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,238 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncPackageTimings.h"
+#include "Containers/StringConv.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/StringBuilder.h"
+#include "Serialization/CompactBinaryWriter.h"
+#include "Templates/UniquePtr.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPackageTimings, Log, All);
+
+namespace UE::AsyncLoading::PackageTimings
+{
+
+static bool GRecordPackageTimings = false;
+static FAutoConsoleVariableRef CVarRecordPackageTimings(
+	TEXT("s.RecordPackageTimings"),
+	GRecordPackageTimings,
+	TEXT("Record per-package phase timings (queue wait, I/O, serialization, PostLoad, deferred PostLoad) for packages loaded by the async loading thread. Use s.DumpPackageTimings to write the report."),
+	ECVF_Default
+);
+
+static int32 GMaxRecordedPackageTimings = 100000;
+static FAutoConsoleVariableRef CVarMaxRecordedPackageTimings(
+	TEXT("s.RecordPackageTimings.MaxRecords"),
+	GMaxRecordedPackageTimings,
+	TEXT("Maximum number of packages kept in the package timings report, packages completing after the limit is reached are dropped."),
+	ECVF_Default
+);
+
+struct FRecord
+{
+	FName PackageName;
+	float QueueWaitMs = 0.0f;
+	float IoMs = 0.0f;
+	float SummaryMs = 0.0f;
+	float SerializeMs = 0.0f;
+	float PostLoadMs = 0.0f;
+	float DeferredPostLoadMs = 0.0f;
+	float TotalMs = 0.0f;
+	uint64 IoBytes = 0;
+	int32 ImportCount = 0;
+	int32 ImportedPackageCount = 0;
+	int32 ExportCount = 0;
+	bool bFailed = false;
+};
+
+struct FRecords
+{
+	FCriticalSection CriticalSection;
+	TArray<FRecord> Records;
+	int32 DroppedCount = 0;
+};
+
+static FRecords& GetRecords()
+{
+	static FRecords Records;
+	return Records;
+}
+
+static float ToMs(double Seconds)
+{
+	return static_cast<float>(FMath::Max(Seconds, 0.0) * 1000.0);
+}
+
+bool IsEnabled()
+{
+	return GRecordPackageTimings;
+}
+
+void AddRecord(FName PackageName, const FAsyncPackageTimings& Timings, double CompletedTime, bool bFailed)
+{
+	if (!Timings.bEnabled)
+	{
+		return;
+	}
+
+	FRecord Record;
+	Record.PackageName = PackageName;
+	if (Timings.StartLoadingTime > 0.0)
+	{
+		Record.QueueWaitMs = ToMs(Timings.StartLoadingTime - Timings.QueuedTime);
+		if (Timings.IoCompletedTime > 0.0)
+		{
+			Record.IoMs = ToMs(Timings.IoCompletedTime - Timings.StartLoadingTime);
+		}
+	}
+	Record.SummaryMs = ToMs(Timings.SummarySeconds);
+	Record.SerializeMs = ToMs(Timings.SerializeSeconds);
+	Record.PostLoadMs = ToMs(Timings.PostLoadSeconds);
+	Record.DeferredPostLoadMs = ToMs(Timings.DeferredPostLoadSeconds);
+	Record.TotalMs = ToMs(CompletedTime - Timings.QueuedTime);
+	Record.IoBytes = Timings.IoBytes;
+	Record.ImportCount = Timings.ImportCount;
+	Record.ImportedPackageCount = Timings.ImportedPackageCount;
+	Record.ExportCount = Timings.ExportCount;
+	Record.bFailed = bFailed;
+
+	FRecords& Records = GetRecords();
+	FScopeLock Lock(&Records.CriticalSection);
+	if (Records.Records.Num() < GMaxRecordedPackageTimings)
+	{
+		Records.Records.Add(MoveTemp(Record));
+	}
+	else
+	{
+		++Records.DroppedCount;
+	}
+}
+
+void Reset()
+{
+	FRecords& Records = GetRecords();
+	FScopeLock Lock(&Records.CriticalSection);
+	Records.Records.Empty();
+	Records.DroppedCount = 0;
+}
+
+static void WriteLine(FArchive& Ar, FStringView Line)
+{
+	FTCHARToUTF8 Utf8(Line.GetData(), Line.Len());
+	Ar.Serialize((void*)Utf8.Get(), Utf8.Length());
+}
+
+void WriteCsv(FArchive& Ar)
+{
+	FRecords& Records = GetRecords();
+	FScopeLock Lock(&Records.CriticalSection);
+
+	WriteLine(Ar, TEXTVIEW("Package,QueueWaitMs,IoMs,SummaryMs,SerializeMs,PostLoadMs,DeferredPostLoadMs,TotalMs,IoBytes,Imports,ImportedPackages,Exports,Failed\n"));
+	TStringBuilder<512> Line;
+	for (const FRecord& Record : Records.Records)
+	{
+		Line.Reset();
+		Line << Record.PackageName;
+		Line.Appendf(TEXT(",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu,%d,%d,%d,%d\n"),
+			Record.QueueWaitMs, Record.IoMs, Record.SummaryMs, Record.SerializeMs, Record.PostLoadMs, Record.DeferredPostLoadMs, Record.TotalMs,
+			Record.IoBytes, Record.ImportCount, Record.ImportedPackageCount, Record.ExportCount, Record.bFailed ? 1 : 0);
+		WriteLine(Ar, Line);
+	}
+}
+
+void WriteCompactBinary(FArchive& Ar)
+{
+	FRecords& Records = GetRecords();
+	FScopeLock Lock(&Records.CriticalSection);
+
+	FCbWriter Writer;
+	Writer.BeginObject();
+	Writer.AddInteger(UTF8TEXTVIEW("DroppedCount"), Records.DroppedCount);
+	Writer.BeginArray(UTF8TEXTVIEW("Packages"));
+	TStringBuilder<256> PackageName;
+	for (const FRecord& Record : Records.Records)
+	{
+		PackageName.Reset();
+		PackageName << Record.PackageName;
+
+		Writer.BeginObject();
+		Writer.AddString(UTF8TEXTVIEW("Package"), PackageName.ToView());
+		Writer.AddFloat(UTF8TEXTVIEW("QueueWaitMs"), Record.QueueWaitMs);
+		Writer.AddFloat(UTF8TEXTVIEW("IoMs"), Record.IoMs);
+		Writer.AddFloat(UTF8TEXTVIEW("SummaryMs"), Record.SummaryMs);
+		Writer.AddFloat(UTF8TEXTVIEW("SerializeMs"), Record.SerializeMs);
+		Writer.AddFloat(UTF8TEXTVIEW("PostLoadMs"), Record.PostLoadMs);
+		Writer.AddFloat(UTF8TEXTVIEW("DeferredPostLoadMs"), Record.DeferredPostLoadMs);
+		Writer.AddFloat(UTF8TEXTVIEW("TotalMs"), Record.TotalMs);
+		Writer.AddInteger(UTF8TEXTVIEW("IoBytes"), Record.IoBytes);
+		Writer.AddInteger(UTF8TEXTVIEW("Imports"), Record.ImportCount);
+		Writer.AddInteger(UTF8TEXTVIEW("ImportedPackages"), Record.ImportedPackageCount);
+		Writer.AddInteger(UTF8TEXTVIEW("Exports"), Record.ExportCount);
+		Writer.AddBool(UTF8TEXTVIEW("Failed"), Record.bFailed);
+		Writer.EndObject();
+	}
+	Writer.EndArray();
+	Writer.EndObject();
+	Writer.Save(Ar);
+}
+
+static void DumpPackageTimings(const TArray<FString>& Args)
+{
+	bool bCompactBinary = false;
+	FString Filename;
+	for (const FString& Arg : Args)
+	{
+		if (Arg.Equals(TEXT("CB"), ESearchCase::IgnoreCase))
+		{
+			bCompactBinary = true;
+		}
+		else
+		{
+			FParse::Value(*Arg, TEXT("File="), Filename);
+		}
+	}
+	if (Filename.IsEmpty())
+	{
+		Filename = FPaths::ProfilingDir() / TEXT("PackageTimings") / FString::Printf(TEXT("PackageTimings-%s.%s"),
+			*FDateTime::Now().ToString(), bCompactBinary ? TEXT("ucb") : TEXT("csv"));
+	}
+
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Ar)
+	{
+		UE_LOG(LogPackageTimings, Error, TEXT("Failed to open '%s' for writing package timings"), *Filename);
+		return;
+	}
+	if (bCompactBinary)
+	{
+		WriteCompactBinary(*Ar);
+	}
+	else
+	{
+		WriteCsv(*Ar);
+	}
+	Ar->Close();
+
+	FRecords& Records = GetRecords();
+	FScopeLock Lock(&Records.CriticalSection);
+	UE_LOG(LogPackageTimings, Display, TEXT("Wrote timings of %d packages (%d dropped) to '%s'"), Records.Records.Num(), Records.DroppedCount, *Filename);
+}
+
+static FAutoConsoleCommand CVarDumpPackageTimings(
+	TEXT("s.DumpPackageTimings"),
+	TEXT("Writes the packages recorded with s.RecordPackageTimings to a report. Usage: s.DumpPackageTimings [CB] [File=<path>], CSV unless CB is specified."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpPackageTimings)
+);
+
+static FAutoConsoleCommand CVarResetPackageTimings(
+	TEXT("s.ResetPackageTimings"),
+	TEXT("Discards all packages recorded with s.RecordPackageTimings."),
+	FConsoleCommandDelegate::CreateStatic(&Reset)
+);
+
+} // namespace UE::AsyncLoading::PackageTimings
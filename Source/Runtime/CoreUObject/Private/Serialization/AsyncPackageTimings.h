@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/NameTypes.h"
+
+class FArchive;
+
+namespace UE::AsyncLoading::PackageTimings
+{
+
+/** Returns true if per-package timings should be recorded for packages created from now on (s.RecordPackageTimings) */
+bool IsEnabled();
+
+/**
+ * Phase timings of a single package loaded by the async loading thread.
+ * Timestamps are FPlatformTime::Seconds() values, durations are accumulated over all time-sliced executions of a phase.
+ */
+struct FAsyncPackageTimings
+{
+	/** Time the load request was queued, or the time the package was created for imported packages */
+	double QueuedTime = 0.0;
+	/** Time the package I/O was issued */
+	double StartLoadingTime = 0.0;
+	/** Time the package I/O completed, includes decompression done by the I/O dispatcher */
+	double IoCompletedTime = 0.0;
+	double SummarySeconds = 0.0;
+	double SerializeSeconds = 0.0;
+	double PostLoadSeconds = 0.0;
+	double DeferredPostLoadSeconds = 0.0;
+	uint64 IoBytes = 0;
+	int32 ImportCount = 0;
+	int32 ImportedPackageCount = 0;
+	int32 ExportCount = 0;
+	bool bEnabled = false;
+};
+
+/** Accumulates the time spent in its scope into a phase duration, does nothing when timings are not recorded for the package */
+class FPhaseScope
+{
+public:
+	FPhaseScope(const FAsyncPackageTimings& Timings, double& InSeconds)
+		: Seconds(Timings.bEnabled ? &InSeconds : nullptr)
+		, StartTime(Seconds ? FPlatformTime::Seconds() : 0.0)
+	{
+	}
+
+	~FPhaseScope()
+	{
+		if (Seconds)
+		{
+			*Seconds += FPlatformTime::Seconds() - StartTime;
+		}
+	}
+
+private:
+	double* Seconds;
+	double StartTime;
+};
+
+/** Adds the timings of a completed package to the report */
+void AddRecord(FName PackageName, const FAsyncPackageTimings& Timings, double CompletedTime, bool bFailed);
+
+/** Discards all recorded packages */
+void Reset();
+
+/** Writes all recorded packages as CSV, one row per package */
+void WriteCsv(FArchive& Ar);
+
+/** Writes all recorded packages as a compact binary object with a "Packages" array */
+void WriteCompactBinary(FArchive& Ar);
+
+} // namespace UE::AsyncLoading::PackageTimings
@@ -10,8 +10,10 @@
 #include "Containers/StaticBitArray.h"
 #include "HAL/ThreadSafeBool.h"
 #include "Misc/TimeGuard.h"
+#include "Misc/ScopeExit.h"
 #include "HAL/IConsoleManager.h"
 #include "Misc/App.h"
+#include "Misc/Parse.h"
 #include "Misc/CoreDelegates.h"
 #include "Tasks/Task.h"
 #include "UObject/ScriptInterface.h"
@@ -31,6 +33,7 @@
 #include "HAL/LowLevelMemTracker.h"
 #include "UObject/GarbageCollectionVerification.h"
 #include "UObject/Package.h"
+#include "UObject/ObjectRedirector.h"
 #include "Async/ParallelFor.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "HAL/Runnable.h"
@@ -88,6 +91,8 @@ static bool GObjCurrentPurgeObjectIndexNeedsReset = true;
 static TArray<FUObjectItem*> GUnreachableObjects;
 static FCriticalSection GUnreachableObjectsCritical;
 static int32 GUnrechableObjectIndex = 0;
+/** Index in GUnreachableObjects of the first object of each destroyed cluster, the objects of a cluster are stored contiguously */
+static TArray<int32> GUnreachableClusterStarts;
 
 struct FGCTimingInfo
 {
@@ -198,6 +203,25 @@ static FAutoConsoleVariableRef CMultithreadedDestructionEnabled(
 	ECVF_Default
 );
 
+static int32 GParallelDestructionEnabled = 0;
+static FAutoConsoleVariableRef CParallelDestructionEnabled(
+	TEXT("gc.ParallelDestructionEnabled"),
+	GParallelDestructionEnabled,
+	TEXT("If true and gc.MultithreadedDestructionEnabled is set, objects that are IsParallelDestructionSafe are destroyed and freed by task workers in parallel"),
+	ECVF_Default
+);
+
+static int32 GParallelDestructionBatchSize = 1024;
+static FAutoConsoleVariableRef CParallelDestructionBatchSize(
+	TEXT("gc.ParallelDestructionBatchSize"),
+	GParallelDestructionBatchSize,
+	TEXT("Number of objects destroyed per task with gc.ParallelDestructionEnabled. Clusters are never split across tasks."),
+	ECVF_Default
+);
+
+/** Set on task workers while they destroy objects for gc.ParallelDestructionEnabled */
+static thread_local bool GIsInParallelDestruction = false;
+
 static UObjectReachabilityStressData* GReachabilityStressData;
 static void AllocateReachabilityStressData(FOutputDevice&)
 {
@@ -488,6 +512,9 @@ class FAsyncPurge : public FRunnable
 	int32 LastUnreachableObjectsCount;
 	/** Stats for the number of objects destroyed */
 	int32 ObjectsDestroyedSinceLastMarkPhase;
+	/** Number of objects, and packages among them, destroyed by task workers during the last parallel purge */
+	int32 LastParallelPurgedObjects;
+	int32 LastParallelPurgedPackages;
 
 	/** [PURGE/GAME THREAD] Destroys objects that are unreachable */
 	template <bool bMultithreaded> // Having this template argument lets the compiler strip unnecessary checks
@@ -590,6 +617,107 @@ class FAsyncPurge : public FRunnable
 		return bFinishedDestroyingObjects;
 	}
 
+	/**
+	 * [PURGE THREAD] Destroys objects that are IsParallelDestructionSafe with a parallel for, then objects that are
+	 * IsDestructionThreadSafe one at a time. Objects that are neither are left for the game thread.
+	 */
+	void ParallelDestroyObjects()
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FAsyncPurge::ParallelDestroyObjects);
+		const double StartTime = FPlatformTime::Seconds();
+		const int32 NumObjects = GUnreachableObjects.Num();
+		const int32 BatchSize = FMath::Max(1, GParallelDestructionBatchSize);
+
+		// Unclustered objects are split in batches of BatchSize, small clusters are merged into one batch but never split
+		// so that a cluster, which is usually allocated together, is freed by a single worker
+		TArray<TPair<int32, int32>, TInlineAllocator<256>> Batches;
+		const int32 ClusteredObjectsStart = GUnreachableClusterStarts.Num() ? GUnreachableClusterStarts[0] : NumObjects;
+		for (int32 Start = ObjCurrentPurgeObjectIndex; Start < ClusteredObjectsStart; Start += BatchSize)
+		{
+			Batches.Emplace(Start, FMath::Min(Start + BatchSize, ClusteredObjectsStart));
+		}
+		for (int32 ClusterIndex = 0; ClusterIndex < GUnreachableClusterStarts.Num(); ++ClusterIndex)
+		{
+			const int32 Start = GUnreachableClusterStarts[ClusterIndex];
+			const int32 End = ClusterIndex + 1 < GUnreachableClusterStarts.Num() ? GUnreachableClusterStarts[ClusterIndex + 1] : NumObjects;
+			if (Batches.Num() && Batches.Last().Key >= ClusteredObjectsStart && End - Batches.Last().Key <= BatchSize)
+			{
+				Batches.Last().Value = End;
+			}
+			else
+			{
+				Batches.Emplace(Start, End);
+			}
+		}
+
+		std::atomic<int32> NumParallelObjects = 0;
+		std::atomic<int32> NumParallelPackages = 0;
+		ParallelFor(TEXT("GC.ParallelDestroyObjects"), Batches.Num(), 1, [&Batches, &NumParallelObjects, &NumParallelPackages](int32 BatchIndex)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(ParallelDestroyObjectsTask);
+			TGuardValue<bool> GuardIsInParallelDestruction(GIsInParallelDestruction, true);
+			// Destructors run concurrently, only freeing the object index takes the object array lock
+			FUObjectArray::FScopedLockOnFreeUObjectIndex LockOnFreeUObjectIndex;
+			int32 LocalNumParallelObjects = 0;
+			int32 LocalNumParallelPackages = 0;
+
+			for (int32 ObjectIndex = Batches[BatchIndex].Key; ObjectIndex < Batches[BatchIndex].Value; ++ObjectIndex)
+			{
+				FUObjectItem* ObjectItem = GUnreachableObjects[ObjectIndex];
+				check(ObjectItem->IsUnreachable());
+
+				UObject* Object = (UObject*)ObjectItem->Object;
+				check(Object->HasAllFlags(RF_FinishDestroyed | RF_BeginDestroyed));
+				if (Object->IsParallelDestructionSafe())
+				{
+					LocalNumParallelPackages += Object->IsA<UPackage>() ? 1 : 0;
+					Object->~UObject();
+					GUObjectAllocator.FreeUObject(Object);
+					GUnreachableObjects[ObjectIndex] = nullptr;
+					++LocalNumParallelObjects;
+				}
+			}
+			NumParallelObjects.fetch_add(LocalNumParallelObjects, std::memory_order_relaxed);
+			NumParallelPackages.fetch_add(LocalNumParallelPackages, std::memory_order_relaxed);
+		});
+		const double ParallelEndTime = FPlatformTime::Seconds();
+
+		// Objects that are only safe to destroy off the game thread one at a time are destroyed here, the rest is left for the game thread
+		int32 NumGameThreadObjects = 0;
+		for (int32 ObjectIndex = ObjCurrentPurgeObjectIndex; ObjectIndex < NumObjects; ++ObjectIndex)
+		{
+			if (FUObjectItem* ObjectItem = GUnreachableObjects[ObjectIndex])
+			{
+				UObject* Object = (UObject*)ObjectItem->Object;
+				if (Object->IsDestructionThreadSafe())
+				{
+					GUObjectArray.LockInternalArray();
+					Object->~UObject();
+					GUObjectArray.UnlockInternalArray();
+					GUObjectAllocator.FreeUObject(Object);
+					GUnreachableObjects[ObjectIndex] = nullptr;
+				}
+				else
+				{
+					++NumGameThreadObjects;
+				}
+			}
+		}
+
+		ObjectsDestroyedSinceLastMarkPhase += NumObjects - ObjCurrentPurgeObjectIndex;
+		ObjCurrentPurgeObjectIndex = NumObjects;
+		// Only publish the objects left for the game thread once all workers are done, the game thread
+		// must not scan GUnreachableObjects while workers are still destroying objects in it
+		NumObjectsToDestroyOnGameThread.store(NumGameThreadObjects, std::memory_order_release);
+
+		LastParallelPurgedObjects = NumParallelObjects.load(std::memory_order_relaxed);
+		LastParallelPurgedPackages = NumParallelPackages.load(std::memory_order_relaxed);
+		CSV_CUSTOM_STAT(GC, ParallelPurgeMs, float((ParallelEndTime - StartTime) * 1000.0), ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(GC, ParallelPurgedObjects, LastParallelPurgedObjects, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(GC, ParallelPurgedPackages, LastParallelPurgedPackages, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(GC, SequentialPurgeMs, float((FPlatformTime::Seconds() - ParallelEndTime) * 1000.0), ECsvCustomStatOp::Accumulate);
+	}
+
 	/** Waits for the worker thread to finish destroying objects */
 	void WaitForAsyncDestructionToFinish()
 	{
@@ -613,6 +741,8 @@ public:
 		, ObjCurrentPurgeObjectIndexOnGameThread(0)
 		, LastUnreachableObjectsCount(0)
 		, ObjectsDestroyedSinceLastMarkPhase(0)
+		, LastParallelPurgedObjects(0)
+		, LastParallelPurgedPackages(0)
 	{
 		BeginPurgeEvent = FPlatformProcess::GetSynchEventFromPool(true);
 		FinishedPurgeEvent = FPlatformProcess::GetSynchEventFromPool(true);
@@ -707,13 +837,20 @@ public:
 		ObjectsDestroyedSinceLastMarkPhase = 0;
 	}
 
+	/** Returns the number of objects, and packages among them, destroyed by task workers during the last parallel purge */
+	void GetLastParallelPurgeStats(int32& OutObjects, int32& OutPackages) const
+	{
+		OutObjects = LastParallelPurgedObjects;
+		OutPackages = LastParallelPurgedPackages;
+	}
+
 	/** 
 	  * Returns true if this function is called from the async destruction thread. 
 	  * It will also return true if we're running single-threaded and this function is called on the game thread
 	  */
 	bool IsInAsyncPurgeThread() const
 	{
-		return AsyncPurgeThreadId == FPlatformTLS::GetCurrentThreadId();
+		return AsyncPurgeThreadId == FPlatformTLS::GetCurrentThreadId() || GIsInParallelDestruction;
 	}
 
 	/* Returns true if it can run multi-threaded destruction */
@@ -737,7 +874,14 @@ public:
 			if (BeginPurgeEvent->Wait(15, true))
 			{
 				BeginPurgeEvent->Reset();
-				TickDestroyObjects<true>(/* bUseTimeLimit = */ false, /* TimeLimit = */ 0.0f, /* StartTime = */ 0.0);
+				if (GParallelDestructionEnabled)
+				{
+					ParallelDestroyObjects();
+				}
+				else
+				{
+					TickDestroyObjects<true>(/* bUseTimeLimit = */ false, /* TimeLimit = */ 0.0f, /* StartTime = */ 0.0);
+				}
 				FinishedPurgeEvent->Trigger();
 			}
 		}
@@ -770,6 +914,63 @@ bool IsInGarbageCollectorThread()
 	return GAsyncPurge ? GAsyncPurge->IsInAsyncPurgeThread() : IsInGameThread();
 }
 
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelDestructionTest, "System.CoreUObject.GarbageCollection.ParallelDestruction", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter);
+
+bool FParallelDestructionTest::RunTest(const FString& Parameters)
+{
+	if (!TestFalse(TEXT("Redirectors are only destroyed off the game thread with gc.ParallelDestructionEnabled"), GetDefault<UObjectRedirector>()->IsDestructionThreadSafe()) ||
+		!TestTrue(TEXT("Redirectors are parallel destruction safe"), GetDefault<UObjectRedirector>()->IsParallelDestructionSafe()))
+	{
+		return false;
+	}
+	if (!GAsyncPurge || !GAsyncPurge->IsMultithreaded() || !FApp::ShouldUseThreadingForPerformance())
+	{
+		AddWarning(TEXT("The purge is not multithreaded, skipping parallel destruction."));
+		return true;
+	}
+
+	// Unreferenced redirectors and packages, both IsParallelDestructionSafe, are destroyed by the next full purge
+	constexpr int32 NumObjects = 10000;
+	constexpr int32 NumPackages = 100;
+	TArray<TWeakObjectPtr<UObject>> Objects;
+	for (int32 Index = 0; Index < NumObjects; ++Index)
+	{
+		Objects.Add(NewObject<UObjectRedirector>(GetTransientPackage(), NAME_None, RF_Transient));
+	}
+	for (int32 Index = 0; Index < NumPackages; ++Index)
+	{
+		Objects.Add(CreatePackage(nullptr));
+	}
+
+	{
+		TGuardValue<int32> GuardMultithreadedDestruction(GMultithreadedDestructionEnabled, 1);
+		TGuardValue<int32> GuardParallelDestruction(GParallelDestructionEnabled, 1);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	}
+
+	int32 NumAlive = 0;
+	for (const TWeakObjectPtr<UObject>& Object : Objects)
+	{
+		NumAlive += Object.IsValid(/*bEvenIfPendingKill*/ true) ? 1 : 0;
+	}
+	TestEqual(TEXT("Objects alive after the purge"), NumAlive, 0);
+
+	// Other unreferenced objects may have been destroyed by the same purge
+	int32 ParallelPurgedObjects = 0;
+	int32 ParallelPurgedPackages = 0;
+	GAsyncPurge->GetLastParallelPurgeStats(ParallelPurgedObjects, ParallelPurgedPackages);
+	TestTrue(TEXT("Task workers destroyed the redirectors and packages"), ParallelPurgedObjects >= NumObjects + NumPackages);
+	TestTrue(TEXT("Task workers destroyed the packages"), ParallelPurgedPackages >= NumPackages);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
+
 //////////////////////////////////////////////////////////////////////////
 
 namespace UE::GC {
@@ -3903,6 +4104,13 @@ void IncrementalPurgeGarbage(bool bUseTimeLimit, double TimeLimit)
 	SCOPED_NAMED_EVENT(IncrementalPurgeGarbage, FColor::Red);
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("IncrementalPurgeGarbage"), STAT_IncrementalPurgeGarbage, STATGROUP_GC);
 	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(GarbageCollection);
+#if CSV_PROFILER
+	const double PurgeStartTime = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT
+	{
+		CSV_CUSTOM_STAT(GC, PurgeGameThreadMs, float((FPlatformTime::Seconds() - PurgeStartTime) * 1000.0), ECsvCustomStatOp::Accumulate);
+	};
+#endif
 
 	bool bCompleted = false;
 
@@ -4339,6 +4547,7 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 	const double StartTime = FPlatformTime::Seconds();
 
 	GUnreachableObjects.Reset();
+	GUnreachableClusterStarts.Reset();
 	GUnrechableObjectIndex = 0;
 
 	int32 MaxNumberOfObjects = GUObjectArray.GetObjectArrayNum() - (GExitPurge ? 0 : GUObjectArray.GetFirstGCIndex());
@@ -4391,6 +4600,7 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 
 			const int32 ClusterIndex = ClusterRootItem->GetClusterIndex();
 			FUObjectCluster& Cluster = GUObjectClusters[ClusterIndex];
+			const int32 ClusterStart = GUnreachableObjects.Num();
 			for (int32 ClusterObjectIndex : Cluster.Objects)
 			{
 				FUObjectItem* ClusterObjectItem = GUObjectArray.IndexToObjectUnsafeForGC(ClusterObjectIndex);
@@ -4403,6 +4613,10 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 					GUnreachableObjects.Add(ClusterObjectItem);
 				}
 			}
+			if (GUnreachableObjects.Num() > ClusterStart)
+			{
+				GUnreachableClusterStarts.Add(ClusterStart);
+			}
 			GUObjectClusters.FreeCluster(ClusterIndex);
 		}
 	}
@@ -4941,6 +5155,11 @@ bool UObject::IsDestructionThreadSafe() const
 	return false;
 }
 
+bool UObject::IsParallelDestructionSafe() const
+{
+	return false;
+}
+
 /*-----------------------------------------------------------------------------
 	Implementation of realtime garbage collection helper functions in 
 	FProperty, UClass, ...
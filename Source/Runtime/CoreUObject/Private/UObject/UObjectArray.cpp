@@ -15,6 +15,9 @@ DEFINE_LOG_CATEGORY_STATIC(LogUObjectArray, Log, All);
 
 FUObjectClusterContainer GUObjectClusters;
 
+/** Set by FUObjectArray::FScopedLockOnFreeUObjectIndex */
+static thread_local bool GLockOnFreeUObjectIndex = false;
+
 #if STATS || ENABLE_STATNAMEDEVENTS_UOBJECT
 void FUObjectItem::CreateStatID() const
 {
@@ -290,7 +293,12 @@ void FUObjectArray::FreeUObjectIndex(UObjectBase* Object)
 	// This should only be happening on the game thread (GC runs only on game thread when it's freeing objects)
 	check(IsInGameThread() || IsInGarbageCollectorThread());
 
-	// No need to call LockInternalArray(); here as it should already be locked by GC
+	// No need to call LockInternalArray(); here as it should already be locked by GC, unless GC destroys objects concurrently
+	const bool bLock = GLockOnFreeUObjectIndex;
+	if (bLock)
+	{
+		LockInternalArray();
+	}
 
 	int32 Index = Object->InternalIndex;
 	FUObjectItem* ObjectItem = IndexToObject(Index);
@@ -306,6 +314,22 @@ void FUObjectArray::FreeUObjectIndex(UObjectBase* Object)
 	{
 		ObjAvailableList.Add(Index);
 	}
+
+	if (bLock)
+	{
+		UnlockInternalArray();
+	}
+}
+
+FUObjectArray::FScopedLockOnFreeUObjectIndex::FScopedLockOnFreeUObjectIndex()
+	: bPreviousLockOnFree(GLockOnFreeUObjectIndex)
+{
+	GLockOnFreeUObjectIndex = true;
+}
+
+FUObjectArray::FScopedLockOnFreeUObjectIndex::~FScopedLockOnFreeUObjectIndex()
+{
+	GLockOnFreeUObjectIndex = bPreviousLockOnFree;
 }
 
 /**
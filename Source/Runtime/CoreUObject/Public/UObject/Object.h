@@ -604,6 +604,15 @@ public:
 	*/
 	COREUOBJECT_API virtual bool IsDestructionThreadSafe() const;
 
+	/**
+	* Called during garbage collection to determine if an object can have its destructor called on a task worker while
+	* other objects are being destroyed on other workers. Only used when gc.ParallelDestructionEnabled is set, in which
+	* case it also allows destruction off the game thread for objects that are not IsDestructionThreadSafe.
+	*
+	* @return	true if this object's destructor can run concurrently with the destructors of other objects
+	*/
+	COREUOBJECT_API virtual bool IsParallelDestructionSafe() const;
+
 	/**
 	* Called during cooking. Must return all objects that will be Preload()ed when this is serialized at load time. Only used by the EDL.
 	*
@@ -43,6 +43,7 @@ class UObjectRedirector : public UObject
 	{
 		return true;
 	}
+	virtual bool IsParallelDestructionSafe() const override { return true; }
 
 	/**
 	 * Callback for retrieving a textual representation of natively serialized properties.  Child classes should implement this method if they wish
@@ -330,6 +330,7 @@ public:
 	virtual bool NeedsLoadForServer() const override { return true; }
 	virtual bool IsPostLoadThreadSafe() const override;
 	virtual bool IsDestructionThreadSafe() const override { return true; }
+	virtual bool IsParallelDestructionSafe() const override { return true; }
 
 #if WITH_EDITORONLY_DATA
 	/** Sets the bLoadedByEditorPropertiesOnly flag */
@@ -725,6 +725,19 @@ public:
 	 */
 	COREUOBJECT_API void FreeUObjectIndex(class UObjectBase* Object);
 
+	/**
+	 * While in scope, FreeUObjectIndex takes the internal array lock itself on the current thread. Used by threads that
+	 * destroy objects concurrently, so the lock is only held while the array is modified instead of around the whole destructor.
+	 */
+	struct FScopedLockOnFreeUObjectIndex
+	{
+		COREUOBJECT_API FScopedLockOnFreeUObjectIndex();
+		COREUOBJECT_API ~FScopedLockOnFreeUObjectIndex();
+
+	private:
+		bool bPreviousLockOnFree;
+	};
+
 	/**
 	 * Returns the index of a UObject. Be advised this is only for very low level use.
 	 *
@@ -75,7 +75,7 @@ namespace UE
 				AttributeIdentifiers = Other.AttributeIdentifiers;
 				UniqueTypedBoneIndices = Other.UniqueTypedBoneIndices;
 				UniqueTypes = Other.UniqueTypes;
-				Values.Empty(Other.Values.Num());
+				Values.Reset(Other.Values.Num());
 				const int32 NumTypes = UniqueTypes.Num();
 				for (int32 TypeIndex = 0; TypeIndex < NumTypes; ++TypeIndex)
 				{
@@ -97,15 +97,15 @@ namespace UE
 			void CopyFrom(const TAttributeContainer<OtherBoneIndexType, OtherAllocator>& Other, const FBoneContainer& BoneContainer)
 			{
 				UniqueTypes = Other.UniqueTypes;
-				AttributeIdentifiers.Empty(Other.AttributeIdentifiers.Num());
-				UniqueTypedBoneIndices.Empty(Other.UniqueTypedBoneIndices.Num());
-				Values.Empty(Other.Values.Num());
+				AttributeIdentifiers.Reset(Other.AttributeIdentifiers.Num());
+				UniqueTypedBoneIndices.Reset(Other.UniqueTypedBoneIndices.Num());
+				Values.Reset(Other.Values.Num());
 				
 				const int32 NumTypes = Other.UniqueTypedBoneIndices.Num();
 				for (int32 TypeIndex = 0; TypeIndex < NumTypes; ++TypeIndex)
 				{
-					// Generate mapping for all contained unique bones to other container its index type
-					TMap<int32, BoneIndexType> IndexMapping;
+					// Generate mapping for all contained unique bones to other container its index type, inline so copies made every evaluation don't allocate
+					TMap<int32, BoneIndexType, TInlineSetAllocator<32>> IndexMapping;
 					const TArray<int32>& OtherTypeBoneIndices = Other.UniqueTypedBoneIndices[TypeIndex];
 					for (int32 Index : OtherTypeBoneIndices)
 					{
@@ -155,7 +155,7 @@ namespace UE
 					AttributeIdentifiers = Other.AttributeIdentifiers;
 					UniqueTypedBoneIndices = Other.UniqueTypedBoneIndices;
 					UniqueTypes = Other.UniqueTypes;
-					Values.Empty(Other.Values.Num());
+					Values.Reset(Other.Values.Num());
 
 					const int32 NumTypes = UniqueTypes.Num();
 					for (int32 TypeIndex = 0; TypeIndex < NumTypes; ++TypeIndex)
@@ -197,6 +197,15 @@ namespace UE
 				UniqueTypes.Empty();
 			}
 
+			/** Cleans out all contained entries and types, keeping the memory of the arrays indexed by type */
+			void Reset()
+			{
+				AttributeIdentifiers.Reset();
+				UniqueTypedBoneIndices.Reset();
+				Values.Reset();
+				UniqueTypes.Reset();
+			}
+
 			bool operator!=(const TAttributeContainer<BoneIndexType, InAllocator>& Other)
 			{
 				/** Number of types should match */
@@ -207,6 +207,12 @@ class UHierarchicalInstancedStaticMeshComponent : public UInstancedStaticMeshCom
 	bool bConcurrentChanges : 1;
 	bool bAutoRebuildTreeOnInstanceChanges : 1;
 
+	// Number of free render slots under each node of the cluster tree, left by instances removed without rebuilding the tree
+	TArray<int32> ClusterFreeSlots;
+
+	// Number of instances added and removed without rebuilding the tree since the last build, see foliage.IncrementalTreeUpdates
+	int32 NumIncrementalTreeChanges;
+
 #if WITH_EDITOR
 	// in Editor mode we might disable the density scaling for edition
 	bool bCanEnableDensityScaling : 1;
@@ -306,6 +312,17 @@ protected:
 
 	/** Removes specified instances */ 
 	ENGINE_API void RemoveInstancesInternal(const int32* InstanceIndices, int32 Num);
+
+	/** True if instances can be added to and removed from the built tree without rebuilding it */
+	ENGINE_API bool CanUpdateTreeIncrementally() const;
+	/** True if enough instances were added and removed incrementally that the tree should be rebuilt */
+	ENGINE_API bool NeedsTreeRebalance() const;
+	/** Inserts a new instance into a free render slot of the closest leaf of the tree. Returns false if no leaf can take it without growing too much. */
+	ENGINE_API bool InsertInstanceIntoTree(int32 InstanceIndex, const FBox& InstanceBounds);
+	/** Frees the render slot of a removed built instance, so it can be reused by InsertInstanceIntoTree */
+	ENGINE_API void ReleaseTreeSlot(int32 RenderIndex);
+	/** Forgets the state of the incremental updates, when the tree is replaced */
+	ENGINE_API void ResetIncrementalTreeState();
 	
 	/** Gets and approximate number of verts for each LOD to generate heuristics **/
 	ENGINE_API int32 GetVertsForLOD(int32 LODIndex);
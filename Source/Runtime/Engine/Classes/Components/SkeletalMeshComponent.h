@@ -776,6 +776,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = Optimization)
 	uint8 bSkipBoundsUpdateWhenInterpolating:1;
 
+	/**
+	 * Bones to evaluate on dedicated servers when a.ServerEvaluation.Enable is set. Only these bones, the root, the bones of
+	 * physics bodies, animated sockets, sockets needed to fill component space transforms and shadow shapes, and their
+	 * parents are evaluated, instead of every bone of the current LOD.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = Optimization)
+	TArray<FName> ServerEvaluationBones;
+
 protected:
 
 	/** Whether the clothing simulation is suspended (not the same as disabled, we no longer run the sim but keep the last valid sim data around) */
@@ -1665,6 +1673,12 @@ public:
 	// Get the bones required for shadow shapes
 	static ENGINE_API void GetShadowShapeRequiredBones(const USkeletalMeshComponent* SkeletalMeshComponent, TArray<FBoneIndexType>& OutRequiredBones);
 
+	/** Whether this component only evaluates ServerEvaluationBones, on dedicated servers when a.ServerEvaluation.Enable is set */
+	ENGINE_API bool UsesServerEvaluationBones() const;
+
+	// Get the root and the ServerEvaluationBones of the component
+	static ENGINE_API void GetServerEvaluationRequiredBones(const USkeletalMeshComponent* SkeletalMeshComponent, const USkeletalMesh* SkeletalMesh, TArray<FBoneIndexType>& OutRequiredBones);
+
 	/**
 	* Recalculates the AnimCurveUids array in RequiredBone of this SkeletalMeshComponent based on current required bone set
 	* Is called when Skeleton->IsRequiredCurvesUpToDate() = false
@@ -2410,6 +2424,30 @@ private:
 	//Data for parallel evaluation of animation
 	FAnimationEvaluationContext AnimEvaluationContext;
 
+public:
+	/** Memory used by an evaluation of a component using ServerEvaluationBones. See a.ServerEvaluation.Stats */
+	struct FServerEvaluationStats
+	{
+		/** Anim stack bytes held by the evaluated pose */
+		int32 StackBytes = 0;
+
+		/** Heap allocations made by the evaluating thread, only counted when running with -malloccounting */
+		uint32 NumAllocations = 0;
+	};
+
+	/** Stats of the last evaluation, published on the game thread once the evaluation is complete */
+	FServerEvaluationStats LastServerEvaluationStats;
+
+private:
+	/** Stats measured by the evaluation in flight, which may run on a worker thread */
+	FServerEvaluationStats PendingServerEvaluationStats;
+
+	/** Attributes evaluated when using ServerEvaluationBones, reset rather than reallocated by each evaluation */
+	UE::Anim::FHeapAttributeContainer ServerEvaluationAttributes;
+
+	/** Whether RequiredBones were computed with ServerEvaluationBones. Set on the game thread when no evaluation is in flight, read by the evaluation. */
+	bool bEvaluatingServerEvaluationBones = false;
+
 public:
 	// Parallel evaluation wrappers
 	ENGINE_API void ParallelAnimationEvaluation();
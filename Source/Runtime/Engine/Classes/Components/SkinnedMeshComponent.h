@@ -1841,6 +1841,12 @@ public:
 	/** Animation Update Rate optimization parameters. */
 	struct FAnimUpdateRateParameters* AnimUpdateRateParams;
 
+	/** Time spent processing the animation of this component the last time it was evaluated, in seconds. Used by the animation budget, see a.Budget.Enabled. */
+	float LastAnimationEvaluationSeconds;
+
+	/** Value of GFrameCounter when LastAnimationEvaluationSeconds was measured */
+	uint64 LastAnimationEvaluationFrame;
+
 	virtual bool IsPlayingRootMotion() const { return false; }
 	virtual bool IsPlayingNetworkedRootMotionMontage() const { return false; }
 	virtual bool IsPlayingRootMotionFromEverything() const { return false; }
@@ -50,5 +50,9 @@ class UCurveFloat : public UCurveBase
 
 	/** Determine if Curve is the same */
 	ENGINE_API bool operator == (const UCurveFloat& Curve) const;
+
+	//~ UObject interface
+	/** Curves only own their key data, so they can be destroyed concurrently with other objects */
+	virtual bool IsParallelDestructionSafe() const override { return true; }
 };
 
@@ -57,6 +57,9 @@ class UCurveLinearColor : public UCurveBase
 	/** Determine if Curve is the same */
 	ENGINE_API bool operator == (const UCurveLinearColor& Curve) const;
 
+	//~ UObject interface
+	virtual bool IsParallelDestructionSafe() const override { return true; }
+
 public:
 #if WITH_EDITOR
 
@@ -47,4 +47,7 @@ class UCurveVector : public UCurveBase
 	ENGINE_API bool operator == (const UCurveVector& Curve) const;
 
 	virtual bool IsValidCurve( FRichCurveEditInfo CurveInfo ) override;
+
+	//~ UObject interface
+	virtual bool IsParallelDestructionSafe() const override { return true; }
 };
@@ -0,0 +1,137 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/Function.h"
+#include "Templates/SubclassOf.h"
+#include "Templates/UniquePtr.h"
+
+#include "ActorRegistrySubsystem.generated.h"
+
+class AActor;
+class ULevel;
+
+/**
+ * Keeps the actors of registered classes in densely packed arrays, one per class, so systems that visit every actor
+ * of a class each frame don't walk the object hash or the level actor lists. A class's array holds the actors of
+ * the class and of its subclasses, like TActorIterator, and is kept up to date as actors are spawned and destroyed
+ * and as levels are added to and removed from the world.
+ *
+ * Classes are registered the first time they are iterated, or explicitly with RegisterActorClass. Arrays can optionally
+ * be sorted by spatial cell (see ActorRegistry.CellSize), so actors that are close in the world are close in memory.
+ *
+ * Only created for game worlds. Tracked actors are weak references for the garbage collector: the registry doesn't keep
+ * alive an actor that leaves the world without being destroyed or removed with its level, and drops it once it is collected.
+ */
+UCLASS(MinimalAPI)
+class UActorRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	ENGINE_API virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	ENGINE_API virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~UWorldSubsystem interface
+	ENGINE_API virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+	ENGINE_API static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	/**
+	 * Starts tracking the actors of a class and its subclasses, gathering the actors already in the world.
+	 *
+	 * @param	Class				Class to track
+	 * @param	bSortBySpatialCell	Whether the actors are periodically sorted by spatial cell, see ActorRegistry.SortInterval
+	 */
+	ENGINE_API void RegisterActorClass(TSubclassOf<AActor> Class, bool bSortBySpatialCell = false);
+
+	/** Stops tracking the actors of a class. Must not be called while iterating the class. */
+	ENGINE_API void UnregisterActorClass(TSubclassOf<AActor> Class);
+
+	ENGINE_API bool IsActorClassRegistered(TSubclassOf<AActor> Class) const;
+
+	/** Returns the number of actors of a registered class, 0 if the class isn't registered */
+	ENGINE_API int32 GetNumActors(TSubclassOf<AActor> Class) const;
+
+	/**
+	 * Calls Func for every actor of the class, registering the class if needed. Actors can be spawned and destroyed
+	 * from Func. Destroyed actors are not visited, spawned actors are visited by the next iteration.
+	 */
+	ENGINE_API void ForEachActor(TSubclassOf<AActor> Class, TFunctionRef<void(AActor&)> Func);
+
+	/**
+	 * Calls Func for contiguous batches of at most BatchSize actors of the class, in parallel on task graph workers,
+	 * registering the class if needed. BatchIndex ranges from 0 to DivideAndRoundUp(GetNumActors(Class), BatchSize).
+	 * Actors must not be spawned or destroyed from Func, and this must not be called from ForEachActor on the same class.
+	 */
+	ENGINE_API void ParallelForEachActorBatch(TSubclassOf<AActor> Class, int32 BatchSize, TFunctionRef<void(int32 BatchIndex, TArrayView<const TObjectPtr<AActor>> Actors)> Func);
+
+	template<typename ActorType>
+	void ForEachActor(TFunctionRef<void(ActorType&)> Func)
+	{
+		ForEachActor(ActorType::StaticClass(), [&Func](AActor& Actor) { Func(static_cast<ActorType&>(Actor)); });
+	}
+
+	/** Calls Func for every actor of the class, in parallel on task graph workers. Same restrictions as ParallelForEachActorBatch. */
+	template<typename ActorType>
+	void ParallelForEachActor(TFunctionRef<void(ActorType&)> Func, int32 BatchSize = 256)
+	{
+		ParallelForEachActorBatch(ActorType::StaticClass(), BatchSize, [&Func](int32 BatchIndex, TArrayView<const TObjectPtr<AActor>> Actors)
+		{
+			for (AActor* Actor : Actors)
+			{
+				Func(static_cast<ActorType&>(*Actor));
+			}
+		});
+	}
+
+	/** Sorts the actors of a registered class by spatial cell now, whether or not the class is periodically sorted */
+	ENGINE_API void SortBySpatialCell(TSubclassOf<AActor> Class);
+
+private:
+	struct FClassActors
+	{
+		/**
+		 * Actors of the class and its subclasses. Slots of actors destroyed while iterating are null until the iteration ends,
+		 * slots of actors the garbage collector cleared are null until the garbage collection ends.
+		 */
+		TArray<TObjectPtr<AActor>> Actors;
+
+		/** Index of each actor in Actors */
+		TMap<AActor*, int32> ActorIndices;
+
+		/** Number of ForEachActor calls in progress on this class */
+		int32 IterationDepth = 0;
+
+		bool bHasNullActors = false;
+		bool bSortBySpatialCell = false;
+		uint64 LastSortFrame = 0;
+	};
+
+	FClassActors& FindOrRegisterClass(UClass* Class);
+	void PrepareForIteration(FClassActors& ClassActors);
+	void SortBySpatialCell(FClassActors& ClassActors);
+	static void Compact(FClassActors& ClassActors);
+
+	void AddActor(AActor* Actor);
+	void RemoveActor(AActor* Actor);
+
+	void OnActorSpawned(AActor* Actor);
+	void OnActorDestroyed(AActor* Actor);
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnPreLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+	void OnPostGarbageCollect();
+
+	/** Tracked actors, by registered class. Values are allocated separately so they stay put while classes are registered during iteration. */
+	TMap<const UClass*, TUniquePtr<FClassActors>> ClassActorsMap;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle PreLevelRemovedHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+};
@@ -216,6 +216,10 @@ public:
 	/** If false, this tick will run on the game thread, otherwise it will run on any thread in parallel with the game thread and in parallel with other "async ticks" **/
 	uint8 bRunOnAnyThread:1;
 
+	/** If false, this tick function always gets its own task, even when it could be batched with the tick functions of other objects of the same class. See tick.AllowBatchedTicks. */
+	UPROPERTY(EditDefaultsOnly, Category="Tick", AdvancedDisplay)
+	uint8 bAllowTickBatching:1;
+
 private:
 
 	enum class ETickState : uint8
@@ -414,6 +418,14 @@ private:
 	{
 		return NAME_None;
 	}
+	/**
+	 * Returns the class of the object ticked by this function. Tick functions of the same class, tick groups and prerequisites
+	 * may be executed by a single batched task. Tick functions without a class are never batched.
+	 */
+	virtual UClass* GetTickBatchClass() const
+	{
+		return nullptr;
+	}
 	
 	friend class FTickTaskSequencer;
 	friend class FTickTaskManager;
@@ -456,6 +468,7 @@ struct FActorTickFunction : public FTickFunction
 	/** Abstract function to describe this tick. Used to print messages about illegal cycles in the dependency graph **/
 	ENGINE_API virtual FString DiagnosticMessage() override;
 	ENGINE_API virtual FName DiagnosticContext(bool bDetailed) override;
+	ENGINE_API virtual UClass* GetTickBatchClass() const override;
 };
 
 template<>
@@ -489,6 +502,7 @@ struct FActorComponentTickFunction : public FTickFunction
 	/** Abstract function to describe this tick. Used to print messages about illegal cycles in the dependency graph **/
 	ENGINE_API virtual FString DiagnosticMessage() override;
 	ENGINE_API virtual FName DiagnosticContext(bool bDetailed) override;
+	ENGINE_API virtual UClass* GetTickBatchClass() const override;
 
 	/**
 	 * Conditionally calls ExecuteTickFunc if registered and a bunch of other criteria are met
@@ -2364,6 +2364,11 @@ public:
 	UPROPERTY()
 	int32 SkippedEvalFrames;
 
+	/** Significance used to rank the owner of these parameters under the animation budget, higher values are throttled last.
+	 * Negative values use the largest screen size of the meshes. Can be set from OnAnimUpdateRateParamsCreated or by game code
+	 * such as a significance manager. See a.Budget.Enabled. */
+	float BudgetSignificance;
+
 public:
 
 	/** Default constructor. */
@@ -2384,6 +2389,7 @@ public:
 		, MaxEvalRateForInterpolation(4)
 		, SkippedUpdateFrames(0)
 		, SkippedEvalFrames(0)
+		, BudgetSignificance(-1.f)
 	{ 
 		BaseVisibleDistanceFactorThesholds.Add(0.24f);
 		BaseVisibleDistanceFactorThesholds.Add(0.12f);
@@ -2454,6 +2454,45 @@ public:
 	 */
 	FTraceHandle	AsyncOverlapByProfile(const FVector& Pos, const FQuat& Rot, FName ProfileName, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FOverlapDelegate* InDelegate = nullptr, uint32 UserData = 0);
 
+	/**
+	 * Interface for Async batches of line traces
+	 * Queries share the same collision parameters and are traced on several worker threads, without delegate
+	 * Use QueryBatchTraceData to get the results - the data is available only in the next frame after request is made
+	 *
+	 *	@param	InTraceType		Indicates if you want a single hit result per query, or just yes/no (no hit information). Multi is not supported.
+	 *  @param  Queries         Start and end locations of the rays
+	 *  @param  TraceChannel    The 'channel' that the rays are in, used to determine which components to hit
+	 *  @param  Params          Additional parameters used for the traces
+	 * 	@param 	ResponseParam	ResponseContainer to be used for the traces
+	 *	@param	UserData		UserData
+	 */
+	FTraceHandle	AsyncBatchLineTraceByChannel(EAsyncTraceType InTraceType, TConstArrayView<FBatchTraceQuery> Queries, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam, uint32 UserData = 0);
+
+	/**
+	 * Interface for Async batches of sweeps
+	 * Queries share the same shape and collision parameters and are traced on several worker threads, without delegate
+	 * Use QueryBatchTraceData to get the results - the data is available only in the next frame after request is made
+	 *
+	 *	@param	InTraceType		Indicates if you want a single hit result per query, or just yes/no (no hit information). Multi is not supported.
+	 *  @param  Queries         Start and end locations of the shape
+	 *  @param  TraceChannel    The 'channel' that the sweeps are in, used to determine which components to hit
+	 *  @param	CollisionShape	CollisionShape - supports Box, Sphere, Capsule
+	 *  @param  Params          Additional parameters used for the traces
+	 * 	@param 	ResponseParam	ResponseContainer to be used for the traces
+	 *	@param	UserData		UserData
+	 */
+	FTraceHandle	AsyncBatchSweepByChannel(EAsyncTraceType InTraceType, TConstArrayView<FBatchTraceQuery> Queries, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam, uint32 UserData = 0);
+
+	/**
+	 * Traces a batch of line traces or sweeps sharing the same shape and collision parameters on several worker threads, and waits for the results
+	 *
+	 *	@param	InTraceType		Indicates if you want a single hit result per query, or just yes/no (no hit information). Multi is not supported.
+	 *  @param  Queries         Start and end locations of the rays or shape
+	 *  @param  OutHits         One hit per query, in the order of Queries, with bBlockingHit set if the query hit something
+	 *  @return Number of queries that hit something
+	 */
+	int32			BatchTraceByChannel(EAsyncTraceType InTraceType, TConstArrayView<FBatchTraceQuery> Queries, TArray<struct FHitResult>& OutHits, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam) const;
+
 	/**
 	 * Query function 
 	 * return true if already done and returning valid result - can be hit or no hit
@@ -2462,6 +2501,13 @@ public:
 	 */
 	bool QueryTraceData(const FTraceHandle& Handle, FTraceDatum& OutData);
 
+	/**
+	 * Query function for batches
+	 * return the batch if already done - its OutHits has one result per query, valid until the end of the frame
+	 * return nullptr if either expired or not yet evaluated or invalid
+	 */
+	const FBatchTraceDatum* QueryBatchTraceData(const FTraceHandle& Handle);
+
 	/**
 	 * Query function 
 	 * return true if already done and returning valid result - can be hit or no hit
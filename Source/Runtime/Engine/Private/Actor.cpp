@@ -272,6 +272,11 @@ FName FActorTickFunction::DiagnosticContext(bool bDetailed)
 	}
 }
 
+UClass* FActorTickFunction::GetTickBatchClass() const
+{
+	return Target ? Target->GetClass() : nullptr;
+}
+
 bool AActor::CheckDefaultSubobjectsInternal() const
 {
 	bool Result = Super::CheckDefaultSubobjectsInternal();
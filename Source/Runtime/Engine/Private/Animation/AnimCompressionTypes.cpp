@@ -4,6 +4,7 @@
 #include "Animation/AnimSequence.h"
 #include "AnimationUtils.h"
 #include "Animation/AnimSequenceDecompressionContext.h"
+#include "Animation/AnimationDecompression.h"
 #include "Interfaces/ITargetPlatform.h"
 #include "Animation/AnimBoneCompressionCodec.h"
 #include "Animation/AnimBoneCompressionSettings.h"
@@ -41,6 +42,11 @@ ICompressedAnimData::ICompressedAnimData(const ICompressedAnimData&) = default;
 ICompressedAnimData& ICompressedAnimData::operator=(const ICompressedAnimData&) = default;
 PRAGMA_ENABLE_DEPRECATION_WARNINGS
 
+ICompressedAnimData::~ICompressedAnimData()
+{
+	UE::Anim::Decompression::InvalidateDecompressionCache(this);
+}
+
 #if WITH_EDITOR
 
 PRAGMA_DISABLE_DEPRECATION_WARNINGS
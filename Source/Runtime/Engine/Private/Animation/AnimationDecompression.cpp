@@ -9,13 +9,48 @@
 #include "AnimEncoding.h"
 #include "Animation/SkeletonRemappingRegistry.h"
 #include "Animation/SkeletonRemapping.h"
+#include "Algo/Sort.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
 
 CSV_DECLARE_CATEGORY_MODULE_EXTERN(ENGINE_API, Animation);
 DECLARE_CYCLE_STAT(TEXT("Build Anim Track Pairs"), STAT_BuildAnimTrackPairs, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("Extract Pose From Anim Data"), STAT_ExtractPoseFromAnimData, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Decompression Cache Hits"), STAT_DecompressionCacheHits, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Decompression Cache Misses"), STAT_DecompressionCacheMisses, STATGROUP_Anim);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Decompression Cache Saved ms"), STAT_DecompressionCacheSavedMs, STATGROUP_Anim);
 
 namespace UE::Anim::Decompression {
-	
+
+static void ClearDecompressionCache();
+
+static void OnDecompressionCacheSettingsChanged(IConsoleVariable* Variable)
+{
+	ClearDecompressionCache();
+}
+
+static int32 GDecompressionCacheEnable = 0;
+static FAutoConsoleVariableRef CVarDecompressionCacheEnable(
+	TEXT("a.DecompressionCache.Enable"),
+	GDecompressionCacheEnable,
+	TEXT("Set to 1 to share decompressed poses between all evaluations of a sequence at the same time sample. Sample times are quantized to a.DecompressionCache.SamplesPerKey samples between keys."),
+	FConsoleVariableDelegate::CreateStatic(&OnDecompressionCacheSettingsChanged));
+
+static int32 GDecompressionCacheSamplesPerKey = 4;
+static FAutoConsoleVariableRef CVarDecompressionCacheSamplesPerKey(
+	TEXT("a.DecompressionCache.SamplesPerKey"),
+	GDecompressionCacheSamplesPerKey,
+	TEXT("Number of cached samples between two keys of linearly interpolated sequences. Sequences with step interpolation cache one sample per key."),
+	FConsoleVariableDelegate::CreateStatic(&OnDecompressionCacheSettingsChanged));
+
+static int32 GDecompressionCacheMaxEntries = 1024;
+static FAutoConsoleVariableRef CVarDecompressionCacheMaxEntries(
+	TEXT("a.DecompressionCache.MaxEntries"),
+	GDecompressionCacheMaxEntries,
+	TEXT("Maximum number of cached poses. The oldest poses are evicted first."),
+	FConsoleVariableDelegate::CreateStatic(&OnDecompressionCacheSettingsChanged));
+
 struct FGetBonePoseScratchArea : public TThreadSingleton<FGetBonePoseScratchArea>
 {
 	BoneTrackArray RotationScalePairs;
@@ -23,8 +58,303 @@ struct FGetBonePoseScratchArea : public TThreadSingleton<FGetBonePoseScratchArea
 	BoneTrackArray AnimScaleRetargetingPairs;
 	BoneTrackArray AnimRelativeRetargetingPairs;
 	BoneTrackArray OrientAndScaleRetargetingPairs;
+	BoneTrackArray AllTrackPairs;
+	TArray<FTransform> DecodedTracks;
 };
 
+/** Time sample of compressed data in the decompression cache */
+struct FDecompressionCacheKey
+{
+	const ICompressedAnimData* CompressedAnimData = nullptr;
+	int32 Sample = 0;
+
+	/** Samples between two keys, or 0 for step interpolation */
+	int32 SamplesPerKey = 0;
+
+	bool operator==(const FDecompressionCacheKey& Other) const
+	{
+		return CompressedAnimData == Other.CompressedAnimData && Sample == Other.Sample && SamplesPerKey == Other.SamplesPerKey;
+	}
+
+	friend uint32 GetTypeHash(const FDecompressionCacheKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.CompressedAnimData), GetTypeHash(Key.Sample * 16 + Key.SamplesPerKey));
+	}
+};
+
+/** All decoded tracks of a cached sample */
+struct FDecompressionCacheEntry
+{
+	TArray<FTransform> Tracks;
+
+	/** Cost of decoding the tracks, saved by every cache hit */
+	uint64 DecodeCycles = 0;
+};
+
+/**
+ * Decoded poses shared by all evaluations of the same compressed data. Entries are spread over shards, each with its own
+ * lock, so worker threads evaluating different sequences rarely contend. Each shard evicts its oldest entries first.
+ */
+struct FDecompressionCache
+{
+	static constexpr int32 NumShards = 16;
+
+	struct FShard
+	{
+		FRWLock Lock;
+		TMap<FDecompressionCacheKey, FDecompressionCacheEntry> Entries;
+
+		/** Keys in insertion order, as a ring buffer once the shard is full. Invalidate removes the keys of the entries it removes. */
+		TArray<FDecompressionCacheKey> InsertionOrder;
+		int32 NextInsertion = 0;
+	};
+
+	FShard Shards[NumShards];
+	std::atomic<int32> NumEntries = 0;
+
+	std::atomic<int64> NumHits = 0;
+	std::atomic<int64> NumMisses = 0;
+	std::atomic<uint64> SavedCycles = 0;
+
+	FShard& GetShard(const FDecompressionCacheKey& Key)
+	{
+		return Shards[GetTypeHash(Key) % NumShards];
+	}
+
+	/** Adds decoded tracks to a shard, evicting its oldest entry when the shard is full. The shard must be write locked. */
+	void Add(FShard& Shard, const FDecompressionCacheKey& Key, const TArray<FTransform>& Tracks, uint64 DecodeCycles)
+	{
+		if (Shard.Entries.Contains(Key))
+		{
+			// Another thread decoded the same sample
+			return;
+		}
+
+		const int32 ShardCapacity = FMath::Max(GDecompressionCacheMaxEntries / NumShards, 1);
+		if (Shard.InsertionOrder.Num() < ShardCapacity)
+		{
+			Shard.InsertionOrder.Add(Key);
+		}
+		else
+		{
+			NumEntries -= Shard.Entries.Remove(Shard.InsertionOrder[Shard.NextInsertion]);
+			Shard.InsertionOrder[Shard.NextInsertion] = Key;
+			Shard.NextInsertion = (Shard.NextInsertion + 1) % ShardCapacity;
+		}
+
+		FDecompressionCacheEntry& Entry = Shard.Entries.Add(Key);
+		Entry.Tracks = Tracks;
+		Entry.DecodeCycles = DecodeCycles;
+		++NumEntries;
+	}
+
+	void Invalidate(const ICompressedAnimData* CompressedAnimData)
+	{
+		for (FShard& Shard : Shards)
+		{
+			FWriteScopeLock WriteLock(Shard.Lock);
+			int32 NumRemoved = 0;
+			for (auto It = Shard.Entries.CreateIterator(); It; ++It)
+			{
+				if (It.Key().CompressedAnimData == CompressedAnimData)
+				{
+					It.RemoveCurrent();
+					--NumEntries;
+					++NumRemoved;
+				}
+			}
+
+			if (NumRemoved > 0)
+			{
+				// Rebuild the ring oldest first without the removed keys, a stale slot would evict the key if it is added again
+				TArray<FDecompressionCacheKey> InsertionOrder;
+				InsertionOrder.Reserve(Shard.InsertionOrder.Num() - NumRemoved);
+				for (int32 Offset = 0; Offset < Shard.InsertionOrder.Num(); ++Offset)
+				{
+					const FDecompressionCacheKey& Key = Shard.InsertionOrder[(Shard.NextInsertion + Offset) % Shard.InsertionOrder.Num()];
+					if (Key.CompressedAnimData != CompressedAnimData)
+					{
+						InsertionOrder.Add(Key);
+					}
+				}
+				Shard.InsertionOrder = MoveTemp(InsertionOrder);
+				Shard.NextInsertion = 0;
+			}
+		}
+	}
+
+	void Clear()
+	{
+		for (FShard& Shard : Shards)
+		{
+			FWriteScopeLock WriteLock(Shard.Lock);
+			NumEntries -= Shard.Entries.Num();
+			Shard.Entries.Empty();
+			Shard.InsertionOrder.Empty();
+			Shard.NextInsertion = 0;
+		}
+	}
+};
+
+// Never destroyed, compressed data can be destroyed during static destruction
+static FDecompressionCache& GetDecompressionCache()
+{
+	static FDecompressionCache* DecompressionCache = new FDecompressionCache();
+	return *DecompressionCache;
+}
+
+static void ClearDecompressionCache()
+{
+	GetDecompressionCache().Clear();
+}
+
+void InvalidateDecompressionCache(const ICompressedAnimData* CompressedAnimData)
+{
+	FDecompressionCache& DecompressionCache = GetDecompressionCache();
+	if (DecompressionCache.NumEntries.load(std::memory_order_relaxed) > 0)
+	{
+		DecompressionCache.Invalidate(CompressedAnimData);
+	}
+}
+
+// Returns the cached sample used to evaluate DecompressionContext at Time, and the time of that sample. Linearly interpolated
+// sequences round to the nearest of SamplesPerKey samples between keys. Step interpolated sequences are sampled halfway
+// between keys, which evaluates to the same key as Time.
+static bool GetDecompressionCacheKey(const FAnimSequenceDecompressionContext& DecompressionContext, double Time, FDecompressionCacheKey& OutKey, double& OutSampleTime)
+{
+	const double PlayableLength = DecompressionContext.GetPlayableLength();
+	const int32 NumKeys = DecompressionContext.CompressedAnimData.CompressedNumberOfKeys;
+	if (PlayableLength <= 0.0 || NumKeys < 2)
+	{
+		return false;
+	}
+
+	const double KeyRate = (NumKeys - 1) / PlayableLength;
+	OutKey.CompressedAnimData = &DecompressionContext.CompressedAnimData;
+	if (DecompressionContext.Interpolation == EAnimInterpolationType::Step)
+	{
+		OutKey.SamplesPerKey = 0;
+		OutKey.Sample = FMath::Clamp(FMath::FloorToInt32(Time * KeyRate), 0, NumKeys - 1);
+		OutSampleTime = FMath::Min((OutKey.Sample + 0.5) / KeyRate, PlayableLength);
+	}
+	else
+	{
+		OutKey.SamplesPerKey = FMath::Clamp(GDecompressionCacheSamplesPerKey, 1, 1024);
+		const double SampleRate = KeyRate * OutKey.SamplesPerKey;
+		OutKey.Sample = FMath::Clamp(FMath::RoundToInt32(Time * SampleRate), 0, (NumKeys - 1) * OutKey.SamplesPerKey);
+		OutSampleTime = OutKey.Sample / SampleRate;
+	}
+	return true;
+}
+
+// Decodes every track of the compressed data at SampleTime, indexed by track
+static void DecodeTracks(const FCompressedAnimSequence& CompressedData, FAnimSequenceDecompressionContext& DecompressionContext, double SampleTime, TArray<FTransform>& OutTracks)
+{
+	const int32 NumTracks = CompressedData.CompressedTrackToSkeletonMapTable.Num();
+
+	BoneTrackArray& AllTrackPairs = FGetBonePoseScratchArea::Get().AllTrackPairs;
+	AllTrackPairs.Reset(NumTracks);
+	for (int32 TrackIndex = 0; TrackIndex < NumTracks; TrackIndex++)
+	{
+		AllTrackPairs.Add(BoneTrackPair(TrackIndex, TrackIndex));
+	}
+
+	OutTracks.Reset(NumTracks);
+	OutTracks.AddUninitialized(NumTracks);
+	for (FTransform& Track : OutTracks)
+	{
+		Track = FTransform::Identity;
+	}
+
+	DecompressionContext.Seek(SampleTime);
+	TArrayView<FTransform> OutAtoms(OutTracks);
+	CompressedData.BoneCompressionCodec->DecompressPose(DecompressionContext, AllTrackPairs, AllTrackPairs, AllTrackPairs, OutAtoms);
+}
+
+// Copies the cached tracks of Key to OutTracks, decoding and caching them on a miss
+static void GetCachedTracks(const FDecompressionCacheKey& Key, double SampleTime, const FCompressedAnimSequence& CompressedData, FAnimSequenceDecompressionContext& DecompressionContext, TArray<FTransform>& OutTracks)
+{
+	FDecompressionCache& DecompressionCache = GetDecompressionCache();
+	FDecompressionCache::FShard& Shard = DecompressionCache.GetShard(Key);
+	{
+		FReadScopeLock ReadLock(Shard.Lock);
+		if (const FDecompressionCacheEntry* Entry = Shard.Entries.Find(Key))
+		{
+			OutTracks.Reset();
+			OutTracks.Append(Entry->Tracks);
+
+			DecompressionCache.NumHits++;
+			DecompressionCache.SavedCycles += Entry->DecodeCycles;
+			INC_DWORD_STAT(STAT_DecompressionCacheHits);
+			INC_FLOAT_STAT_BY(STAT_DecompressionCacheSavedMs, static_cast<float>(FPlatformTime::ToMilliseconds64(Entry->DecodeCycles)));
+			CSV_CUSTOM_STAT(Animation, DecompressionCacheHits, 1, ECsvCustomStatOp::Accumulate);
+			return;
+		}
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	DecodeTracks(CompressedData, DecompressionContext, SampleTime, OutTracks);
+	const uint64 DecodeCycles = FPlatformTime::Cycles64() - StartCycles;
+
+	DecompressionCache.NumMisses++;
+	INC_DWORD_STAT(STAT_DecompressionCacheMisses);
+	CSV_CUSTOM_STAT(Animation, DecompressionCacheMisses, 1, ECsvCustomStatOp::Accumulate);
+
+	FWriteScopeLock WriteLock(Shard.Lock);
+	DecompressionCache.Add(Shard, Key, OutTracks, DecodeCycles);
+}
+
+// Copies decoded tracks to the bones of a pose, like UAnimBoneCompressionCodec::DecompressPose
+static void CopyDecodedTracks(const TArray<FTransform>& Tracks, const BoneTrackArray& RotationScalePairs, const BoneTrackArray& TranslationPairs, TArrayView<FTransform> OutAtoms)
+{
+	for (const BoneTrackPair& Pair : RotationScalePairs)
+	{
+		const FTransform& Track = Tracks[Pair.TrackIndex];
+		FTransform& Atom = OutAtoms[Pair.AtomIndex];
+		Atom.SetRotation(Track.GetRotation());
+		Atom.SetScale3D(Track.GetScale3D());
+	}
+
+	for (const BoneTrackPair& Pair : TranslationPairs)
+	{
+		OutAtoms[Pair.AtomIndex].SetTranslation(Tracks[Pair.TrackIndex].GetTranslation());
+	}
+}
+
+static void DumpDecompressionCacheStats(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	FDecompressionCache& DecompressionCache = GetDecompressionCache();
+	const int64 NumHits = DecompressionCache.NumHits;
+	const int64 NumMisses = DecompressionCache.NumMisses;
+	Ar.Logf(TEXT("Decompression cache: %s, %d samples per key, %d/%d entries"), GDecompressionCacheEnable ? TEXT("enabled") : TEXT("disabled"),
+		GDecompressionCacheSamplesPerKey, DecompressionCache.NumEntries.load(), GDecompressionCacheMaxEntries);
+	if (NumHits + NumMisses > 0)
+	{
+		Ar.Logf(TEXT("%lld hits, %lld misses (%.1f%% hit rate), %.3fms of decoding saved"), NumHits, NumMisses,
+			100.0 * NumHits / (NumHits + NumMisses), FPlatformTime::ToMilliseconds64(DecompressionCache.SavedCycles));
+	}
+
+	if (Args.Contains(TEXT("Reset")))
+	{
+		DecompressionCache.NumHits = 0;
+		DecompressionCache.NumMisses = 0;
+		DecompressionCache.SavedCycles = 0;
+	}
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice DumpDecompressionCacheStatsCmd(
+	TEXT("a.DecompressionCache.Stats"),
+	TEXT("Prints the hit rate of the decompression cache and the decoding time it saved. Usage: a.DecompressionCache.Stats [Reset]"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&DumpDecompressionCacheStats));
+
+static void DecompressPoseInternal(FCompactPose& OutPose,
+	const FCompressedAnimSequence& CompressedData,
+	const FAnimExtractContext& ExtractionContext,
+	FAnimSequenceDecompressionContext& DecompressionContext,
+	const TArray<FTransform>& RetargetTransforms,
+	const FRootMotionReset& RootMotionReset,
+	const TArray<FTransform>* DecodedTracks);
+
 void DecompressPose(FCompactPose& OutPose,
 								const FCompressedAnimSequence& CompressedData,
 								const FAnimExtractContext& ExtractionContext,
@@ -42,6 +372,96 @@ void DecompressPose(FCompactPose& OutPose,
 	FAnimSequenceDecompressionContext& DecompressionContext,
 	const TArray<FTransform>& RetargetTransforms,
 	const FRootMotionReset& RootMotionReset)
+{
+	DecompressPoseInternal(OutPose, CompressedData, ExtractionContext, DecompressionContext, RetargetTransforms, RootMotionReset, nullptr);
+}
+
+void DecompressPoses(TArrayView<const FDecompressPoseRequest> Requests)
+{
+	struct FSortedRequest
+	{
+		const FDecompressPoseRequest* Request;
+		FDecompressionCacheKey Key;
+		double SampleTime;
+		bool bCached;
+	};
+
+	TArray<FSortedRequest, TInlineAllocator<64>> SortedRequests;
+	SortedRequests.Reserve(Requests.Num());
+	for (const FDecompressPoseRequest& Request : Requests)
+	{
+		FSortedRequest& SortedRequest = SortedRequests.AddDefaulted_GetRef();
+		SortedRequest.Request = &Request;
+		SortedRequest.bCached = GDecompressionCacheEnable && GetDecompressionCacheKey(*Request.DecompressionContext, Request.ExtractionContext->CurrentTime, SortedRequest.Key, SortedRequest.SampleTime);
+		if (!SortedRequest.bCached)
+		{
+			SortedRequest.Key.CompressedAnimData = &Request.DecompressionContext->CompressedAnimData;
+			SortedRequest.Key.SamplesPerKey = Request.DecompressionContext->Interpolation == EAnimInterpolationType::Step ? 0 : 1;
+			SortedRequest.SampleTime = Request.ExtractionContext->CurrentTime;
+		}
+	}
+
+	// Group requests sampling the same compressed data at the same time
+	Algo::Sort(SortedRequests, [](const FSortedRequest& A, const FSortedRequest& B)
+	{
+		if (A.Key.CompressedAnimData != B.Key.CompressedAnimData)
+		{
+			return A.Key.CompressedAnimData < B.Key.CompressedAnimData;
+		}
+		if (A.SampleTime != B.SampleTime)
+		{
+			return A.SampleTime < B.SampleTime;
+		}
+		return A.Key.SamplesPerKey < B.Key.SamplesPerKey;
+	});
+
+	for (int32 GroupStart = 0; GroupStart < SortedRequests.Num();)
+	{
+		const FSortedRequest& First = SortedRequests[GroupStart];
+		int32 GroupEnd = GroupStart + 1;
+		while (GroupEnd < SortedRequests.Num() && SortedRequests[GroupEnd].Key.CompressedAnimData == First.Key.CompressedAnimData
+			&& SortedRequests[GroupEnd].SampleTime == First.SampleTime && SortedRequests[GroupEnd].Key.SamplesPerKey == First.Key.SamplesPerKey)
+		{
+			GroupEnd++;
+		}
+
+		if (GroupEnd - GroupStart == 1)
+		{
+			const FDecompressPoseRequest& Request = *First.Request;
+			DecompressPoseInternal(*Request.OutPose, *Request.CompressedData, *Request.ExtractionContext, *Request.DecompressionContext, *Request.RetargetTransforms, *Request.RootMotionReset, nullptr);
+		}
+		else
+		{
+			// Decode all tracks once for the whole group, each pose then copies the tracks it needs
+			TArray<FTransform>& DecodedTracks = FGetBonePoseScratchArea::Get().DecodedTracks;
+			const FDecompressPoseRequest& FirstRequest = *First.Request;
+			if (First.bCached)
+			{
+				GetCachedTracks(First.Key, First.SampleTime, *FirstRequest.CompressedData, *FirstRequest.DecompressionContext, DecodedTracks);
+			}
+			else
+			{
+				DecodeTracks(*FirstRequest.CompressedData, *FirstRequest.DecompressionContext, First.SampleTime, DecodedTracks);
+			}
+
+			for (int32 Index = GroupStart; Index < GroupEnd; Index++)
+			{
+				const FDecompressPoseRequest& Request = *SortedRequests[Index].Request;
+				DecompressPoseInternal(*Request.OutPose, *Request.CompressedData, *Request.ExtractionContext, *Request.DecompressionContext, *Request.RetargetTransforms, *Request.RootMotionReset, &DecodedTracks);
+			}
+		}
+
+		GroupStart = GroupEnd;
+	}
+}
+
+static void DecompressPoseInternal(FCompactPose& OutPose,
+	const FCompressedAnimSequence& CompressedData,
+	const FAnimExtractContext& ExtractionContext,
+	FAnimSequenceDecompressionContext& DecompressionContext,
+	const TArray<FTransform>& RetargetTransforms,
+	const FRootMotionReset& RootMotionReset,
+	const TArray<FTransform>* DecodedTracks)
 {
 	const FBoneContainer& RequiredBones = OutPose.GetBoneContainer();
 	const int32 NumTracks = CompressedData.CompressedTrackToSkeletonMapTable.Num();
@@ -125,6 +545,19 @@ void DecompressPose(FCompactPose& OutPose,
 		CSV_SCOPED_TIMING_STAT(Animation, ExtractPoseFromAnimData);
 		CSV_CUSTOM_STAT(Animation, NumberOfExtractedAnimations, 1, ECsvCustomStatOp::Accumulate);
 
+		// Use the tracks of the cached sample nearest to the current time, decoding all tracks on a miss
+		if (DecodedTracks == nullptr && GDecompressionCacheEnable)
+		{
+			FDecompressionCacheKey CacheKey;
+			double SampleTime;
+			if (GetDecompressionCacheKey(DecompressionContext, ExtractionContext.CurrentTime, CacheKey, SampleTime))
+			{
+				TArray<FTransform>& CachedTracks = FGetBonePoseScratchArea::Get().DecodedTracks;
+				GetCachedTracks(CacheKey, SampleTime, CompressedData, DecompressionContext, CachedTracks);
+				DecodedTracks = &CachedTracks;
+			}
+		}
+
 		DecompressionContext.Seek(ExtractionContext.CurrentTime);
 
 		// Handle Root Bone separately
@@ -134,7 +567,14 @@ void DecompressPose(FCompactPose& OutPose,
 			FCompactPoseBoneIndex RootBone(0);
 			FTransform& RootAtom = OutPose[RootBone];
 
-			CompressedData.BoneCompressionCodec->DecompressBone(DecompressionContext, TrackIndex, RootAtom);
+			if (DecodedTracks)
+			{
+				RootAtom = (*DecodedTracks)[TrackIndex];
+			}
+			else
+			{
+				CompressedData.BoneCompressionCodec->DecompressBone(DecompressionContext, TrackIndex, RootAtom);
+			}
 
 			// Retarget the root onto the target skeleton (correcting for differences in rest poses)
 			if (SkeletonRemapping.RequiresReferencePoseRetarget())
@@ -167,7 +607,14 @@ void DecompressPose(FCompactPose& OutPose,
 		{
 			// get the remaining bone atoms
 			TArrayView<FTransform> OutPoseBones = OutPose.GetMutableBones();
-			CompressedData.BoneCompressionCodec->DecompressPose(DecompressionContext, RotationScalePairs, TranslationPairs, RotationScalePairs, OutPoseBones);
+			if (DecodedTracks)
+			{
+				CopyDecodedTracks(*DecodedTracks, RotationScalePairs, TranslationPairs, OutPoseBones);
+			}
+			else
+			{
+				CompressedData.BoneCompressionCodec->DecompressPose(DecompressionContext, RotationScalePairs, TranslationPairs, RotationScalePairs, OutPoseBones);
+			}
 		}
 	}
 
@@ -290,3 +737,178 @@ void DecompressPose(FCompactPose& OutPose,
 	}
 }
 }
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Animation/AnimSequence.h"
+#include "UObject/UObjectIterator.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDecompressionCacheInvalidateTest, "System.Engine.Animation.DecompressionCache.Invalidate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FDecompressionCacheInvalidateTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Anim::Decompression;
+
+	// Three entries per shard. Keys only compare the compressed data pointers, so the compressed data can be empty.
+	TGuardValue<int32> MaxEntriesGuard(GDecompressionCacheMaxEntries, 3 * FDecompressionCache::NumShards);
+	FUECompressedAnimDataMutable CompressedDataA;
+	FUECompressedAnimDataMutable CompressedDataB;
+
+	FDecompressionCache DecompressionCache;
+	FDecompressionCacheKey KeyA;
+	KeyA.CompressedAnimData = &CompressedDataA;
+	KeyA.SamplesPerKey = 1;
+	FDecompressionCache::FShard& Shard = DecompressionCache.GetShard(KeyA);
+
+	// Keys of CompressedDataB from FirstSample on that land in the same shard as KeyA
+	auto MakeKeyInShard = [&DecompressionCache, &Shard, &CompressedDataB](int32 FirstSample)
+	{
+		FDecompressionCacheKey Key;
+		Key.CompressedAnimData = &CompressedDataB;
+		Key.SamplesPerKey = 1;
+		Key.Sample = FirstSample;
+		while (&DecompressionCache.GetShard(Key) != &Shard)
+		{
+			++Key.Sample;
+		}
+		return Key;
+	};
+	const FDecompressionCacheKey KeyB = MakeKeyInShard(0);
+	const FDecompressionCacheKey KeyC = MakeKeyInShard(KeyB.Sample + 1);
+	const FDecompressionCacheKey KeyD = MakeKeyInShard(KeyC.Sample + 1);
+
+	const TArray<FTransform> Tracks = { FTransform::Identity };
+	auto Add = [&DecompressionCache, &Shard, &Tracks](const FDecompressionCacheKey& Key)
+	{
+		FWriteScopeLock WriteLock(Shard.Lock);
+		DecompressionCache.Add(Shard, Key, Tracks, 0);
+	};
+
+	Add(KeyA);
+	Add(KeyB);
+	DecompressionCache.Invalidate(&CompressedDataA);
+	TestFalse(TEXT("Invalidate removes the entries of the compressed data"), Shard.Entries.Contains(KeyA));
+
+	// KeyA was added again after KeyB, so filling the shard must not evict it
+	Add(KeyA);
+	Add(KeyC);
+	TestTrue(TEXT("An entry added again after being invalidated is not evicted early"), Shard.Entries.Contains(KeyA));
+
+	Add(KeyD);
+	TestFalse(TEXT("The oldest entry is evicted first"), Shard.Entries.Contains(KeyB));
+	TestTrue(TEXT("Newer entries are kept"), Shard.Entries.Contains(KeyA) && Shard.Entries.Contains(KeyC) && Shard.Entries.Contains(KeyD));
+	TestEqual(TEXT("Number of entries"), DecompressionCache.NumEntries.load(), 3);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDecompressPosesTest, "System.Engine.Animation.DecompressPoses", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FDecompressPosesTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Anim::Decompression;
+
+	// Decompress the sequence passed as parameter, or the first loaded sequence with compressed bone tracks
+	UAnimSequence* AnimSequence = nullptr;
+	if (!Parameters.IsEmpty())
+	{
+		AnimSequence = LoadObject<UAnimSequence>(nullptr, *Parameters);
+	}
+	else
+	{
+		for (TObjectIterator<UAnimSequence> It; It; ++It)
+		{
+			if (It->GetSkeleton() && It->IsCompressedDataValid() && It->CompressedData.BoneCompressionCodec && It->CompressedData.CompressedTrackToSkeletonMapTable.Num() > 0)
+			{
+				AnimSequence = *It;
+				break;
+			}
+		}
+	}
+
+	if (!AnimSequence || !AnimSequence->GetSkeleton() || !AnimSequence->IsCompressedDataValid() || !AnimSequence->CompressedData.BoneCompressionCodec)
+	{
+		AddWarning(TEXT("No animation sequence with compressed data to decompress, pass the path of one as parameter"));
+		return true;
+	}
+
+	USkeleton* Skeleton = AnimSequence->GetSkeleton();
+	const FCompressedAnimSequence& CompressedData = AnimSequence->CompressedData;
+
+	TArray<FBoneIndexType> RequiredBoneIndexArray;
+	RequiredBoneIndexArray.AddUninitialized(Skeleton->GetReferenceSkeleton().GetNum());
+	for (int32 BoneIndex = 0; BoneIndex < RequiredBoneIndexArray.Num(); ++BoneIndex)
+	{
+		RequiredBoneIndexArray[BoneIndex] = static_cast<FBoneIndexType>(BoneIndex);
+	}
+	FBoneContainer RequiredBones(RequiredBoneIndexArray, UE::Anim::FCurveFilterSettings(UE::Anim::ECurveFilterMode::None), *Skeleton);
+
+	const FRootMotionReset RootMotionReset(false, ERootMotionRootLock::RefPose, false, FTransform::Identity, AnimSequence->IsValidAdditive());
+	const FFrameRate SamplingFrameRate = AnimSequence->GetSamplingFrameRate();
+	const int32 NumFrames = SamplingFrameRate.AsFrameTime(AnimSequence->GetPlayLength()).RoundToFrame().Value;
+
+	// Pairs of requests at the same time share decoded tracks, the others decompress on their own
+	const double PlayLength = AnimSequence->GetPlayLength();
+	const double Times[] = { 0.0, 0.0, PlayLength * 0.25, PlayLength * 0.25, PlayLength * 0.4, PlayLength * 0.6, PlayLength };
+	constexpr int32 NumRequests = UE_ARRAY_COUNT(Times);
+
+	// Compact poses allocate their bones on the mem stack
+	FMemMark Mark(FMemStack::Get());
+
+	TArray<FAnimExtractContext> ExtractionContexts;
+	TArray<TUniquePtr<FAnimSequenceDecompressionContext>> DecompressionContexts;
+	TArray<FCompactPose> ExpectedPoses;
+	TArray<FCompactPose> Poses;
+	ExpectedPoses.SetNum(NumRequests);
+	Poses.SetNum(NumRequests);
+	for (int32 Index = 0; Index < NumRequests; ++Index)
+	{
+		ExtractionContexts.Emplace(Times[Index]);
+		DecompressionContexts.Add(MakeUnique<FAnimSequenceDecompressionContext>(SamplingFrameRate, NumFrames, AnimSequence->Interpolation, AnimSequence->GetRetargetTransformsSourceName(),
+			*CompressedData.CompressedDataStructure, Skeleton->GetRefLocalPoses(), CompressedData.CompressedTrackToSkeletonMapTable, Skeleton, AnimSequence->IsValidAdditive()));
+		ExpectedPoses[Index].SetBoneContainer(&RequiredBones);
+		Poses[Index].SetBoneContainer(&RequiredBones);
+	}
+
+	TGuardValue<int32> CacheEnableGuard(GDecompressionCacheEnable, 0);
+	for (int32 CacheEnable = 0; CacheEnable < 2; ++CacheEnable)
+	{
+		GDecompressionCacheEnable = CacheEnable;
+		ClearDecompressionCache();
+
+		TArray<FDecompressPoseRequest> Requests;
+		for (int32 Index = 0; Index < NumRequests; ++Index)
+		{
+			ExpectedPoses[Index].ResetToRefPose();
+			DecompressPose(ExpectedPoses[Index], CompressedData, ExtractionContexts[Index], *DecompressionContexts[Index], AnimSequence->GetRetargetTransforms(), RootMotionReset);
+
+			Poses[Index].ResetToRefPose();
+			FDecompressPoseRequest& Request = Requests.AddDefaulted_GetRef();
+			Request.OutPose = &Poses[Index];
+			Request.CompressedData = &CompressedData;
+			Request.ExtractionContext = &ExtractionContexts[Index];
+			Request.DecompressionContext = DecompressionContexts[Index].Get();
+			Request.RetargetTransforms = &AnimSequence->GetRetargetTransforms();
+			Request.RootMotionReset = &RootMotionReset;
+		}
+
+		DecompressPoses(Requests);
+
+		for (int32 Index = 0; Index < NumRequests; ++Index)
+		{
+			for (FCompactPoseBoneIndex BoneIndex(0); BoneIndex < Poses[Index].GetNumBones(); ++BoneIndex)
+			{
+				if (!Poses[Index][BoneIndex].Equals(ExpectedPoses[Index][BoneIndex], UE_KINDA_SMALL_NUMBER))
+				{
+					AddError(FString::Printf(TEXT("%s: bone %d at %.3fs differs from DecompressPose with a.DecompressionCache.Enable %d"),
+						*AnimSequence->GetName(), BoneIndex.GetInt(), Times[Index], CacheEnable));
+					break;
+				}
+			}
+		}
+	}
+
+	ClearDecompressionCache();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
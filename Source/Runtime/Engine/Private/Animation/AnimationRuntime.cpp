@@ -18,6 +18,7 @@
 #include "Animation/MirrorDataTable.h"
 #include "Animation/SkeletonRemappingRegistry.h"
 #include "Animation/SkeletonRemapping.h"
+#include "Animation/CompactPoseSoA.h"
 
 DEFINE_LOG_CATEGORY(LogAnimation);
 DEFINE_LOG_CATEGORY(LogRootMotion);
@@ -100,6 +101,13 @@ static FAutoConsoleVariableRef CVarBlendPosesPerBoneFilter(TEXT("a.BlendPosesPer
 
 #endif // INTEL_ISPC
 
+#if UE_BUILD_SHIPPING
+static constexpr bool bAnim_PoseSoA_Enabled = true;
+#else
+static bool bAnim_PoseSoA_Enabled = true;
+static FAutoConsoleVariableRef CVarAnimPoseSoAEnabled(TEXT("a.PoseSoA"), bAnim_PoseSoA_Enabled, TEXT("Whether to blend, accumulate additive and mirror poses as a structure of arrays, converting bone transforms only once per operation"));
+#endif
+
 void FAnimationRuntime::NormalizeRotations(const FBoneContainer& RequiredBones, /*inout*/ FTransformArrayA2& Atoms)
 {
 	check( Atoms.Num() == RequiredBones.GetNumBones() );
@@ -193,6 +201,22 @@ FORCEINLINE void BlendPose<ETransformBlendMode::Accumulate>(const FCompactPose&
 	}
 }
 
+/** Blends poses into a structure of arrays pose, writing the normalized result back to OutPose once */
+template<typename GetSourcePoseType, typename GetSourceWeightType>
+static void BlendPosesTogetherSoA(int32 NumPoses, GetSourcePoseType GetSourcePose, GetSourceWeightType GetSourceWeight, FCompactPose& OutPose)
+{
+	FCompactPoseSoA BlendedPose;
+	BlendedPose.BlendOverwrite(GetSourcePose(0).GetBones(), GetSourceWeight(0));
+
+	for (int32 PoseIndex = 1; PoseIndex < NumPoses; ++PoseIndex)
+	{
+		BlendedPose.BlendAccumulate(GetSourcePose(PoseIndex).GetBones(), GetSourceWeight(PoseIndex));
+	}
+
+	BlendedPose.NormalizeRotations();
+	BlendedPose.CopyTo(OutPose.GetMutableBones());
+}
+
 FORCEINLINE void BlendCurves(const TArrayView<const FBlendedCurve> SourceCurves, const TArrayView<const float> SourceWeights, const TArrayView<const int32> SourceWeightsIndices, FBlendedCurve& OutCurve)
 {
 	if (SourceCurves.Num() > 0)
@@ -348,17 +372,24 @@ void FAnimationRuntime::BlendPosesTogether(TArrayView<const FCompactPose> Source
 	FBlendedCurve& OutCurve = OutAnimationPoseData.GetCurve();
 	UE::Anim::FStackAttributeContainer& OutAttributes = OutAnimationPoseData.GetAttributes();
 
-	BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[0]);
-
-	for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+	if (bAnim_PoseSoA_Enabled && SourcePoses.Num() > 1)
 	{
-		BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
+		BlendPosesTogetherSoA(SourcePoses.Num(), [&SourcePoses](int32 PoseIndex) -> const FCompactPose& { return SourcePoses[PoseIndex]; }, [&SourceWeights](int32 PoseIndex) { return SourceWeights[PoseIndex]; }, OutPose);
 	}
-
-	// Ensure that all of the resulting rotations are normalized
-	if (SourcePoses.Num() > 1)
+	else
 	{
-		OutPose.NormalizeRotations();
+		BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[0]);
+
+		for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+		{
+			BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		if (SourcePoses.Num() > 1)
+		{
+			OutPose.NormalizeRotations();
+		}
 	}
 
 	// curve blending if exists
@@ -396,17 +427,24 @@ void FAnimationRuntime::BlendPosesTogether(TArrayView<const FCompactPose> Source
 	FBlendedCurve& OutCurve = OutAnimationPoseData.GetCurve();
 	UE::Anim::FStackAttributeContainer& OutAttributes = OutAnimationPoseData.GetAttributes();
 
-	BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[SourceWeightsIndices[0]]);
-
-	for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+	if (bAnim_PoseSoA_Enabled && SourcePoses.Num() > 1)
 	{
-		BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[SourceWeightsIndices[PoseIndex]]);
+		BlendPosesTogetherSoA(SourcePoses.Num(), [&SourcePoses](int32 PoseIndex) -> const FCompactPose& { return SourcePoses[PoseIndex]; }, [&SourceWeights, &SourceWeightsIndices](int32 PoseIndex) { return SourceWeights[SourceWeightsIndices[PoseIndex]]; }, OutPose);
 	}
-
-	// Ensure that all of the resulting rotations are normalized
-	if (SourcePoses.Num() > 1)
+	else
 	{
-		OutPose.NormalizeRotations();
+		BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[SourceWeightsIndices[0]]);
+
+		for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+		{
+			BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[SourceWeightsIndices[PoseIndex]]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		if (SourcePoses.Num() > 1)
+		{
+			OutPose.NormalizeRotations();
+		}
 	}
 
 	// curve blending if exists
@@ -442,17 +480,24 @@ void FAnimationRuntime::BlendPosesTogetherIndirect(TArrayView<const FCompactPose
 	FBlendedCurve& OutCurve = OutAnimationPoseData.GetCurve();
 	UE::Anim::FStackAttributeContainer& OutAttributes = OutAnimationPoseData.GetAttributes();
 	
-	BlendPose<ETransformBlendMode::Overwrite>(*SourcePoses[0], OutPose, SourceWeights[0]);
-
-	for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+	if (bAnim_PoseSoA_Enabled && SourcePoses.Num() > 1)
 	{
-		BlendPose<ETransformBlendMode::Accumulate>(*SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
+		BlendPosesTogetherSoA(SourcePoses.Num(), [&SourcePoses](int32 PoseIndex) -> const FCompactPose& { return *SourcePoses[PoseIndex]; }, [&SourceWeights](int32 PoseIndex) { return SourceWeights[PoseIndex]; }, OutPose);
 	}
-
-	// Ensure that all of the resulting rotations are normalized
-	if (SourcePoses.Num() > 1)
+	else
 	{
-		OutPose.NormalizeRotations();
+		BlendPose<ETransformBlendMode::Overwrite>(*SourcePoses[0], OutPose, SourceWeights[0]);
+
+		for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+		{
+			BlendPose<ETransformBlendMode::Accumulate>(*SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		if (SourcePoses.Num() > 1)
+		{
+			OutPose.NormalizeRotations();
+		}
 	}
 
 	if (SourceCurves.Num() > 0)
@@ -493,11 +538,20 @@ void FAnimationRuntime::BlendTwoPosesTogether(const FAnimationPoseData& SourcePo
 
 	const float WeightOfPoseTwo = 1.f - WeightOfPoseOne;
 
-	BlendPose<ETransformBlendMode::Overwrite>(SourcePoseOneData.GetPose(), OutPose, WeightOfPoseOne);
-	BlendPose<ETransformBlendMode::Accumulate>(SourcePoseTwoData.GetPose(), OutPose, WeightOfPoseTwo);
+	if (bAnim_PoseSoA_Enabled)
+	{
+		const FCompactPose* SourcePoses[] = { &SourcePoseOneData.GetPose(), &SourcePoseTwoData.GetPose() };
+		const float SourceWeights[] = { WeightOfPoseOne, WeightOfPoseTwo };
+		BlendPosesTogetherSoA(2, [&SourcePoses](int32 PoseIndex) -> const FCompactPose& { return *SourcePoses[PoseIndex]; }, [&SourceWeights](int32 PoseIndex) { return SourceWeights[PoseIndex]; }, OutPose);
+	}
+	else
+	{
+		BlendPose<ETransformBlendMode::Overwrite>(SourcePoseOneData.GetPose(), OutPose, WeightOfPoseOne);
+		BlendPose<ETransformBlendMode::Accumulate>(SourcePoseTwoData.GetPose(), OutPose, WeightOfPoseTwo);
 
-	// Ensure that all of the resulting rotations are normalized
-	OutPose.NormalizeRotations();
+		// Ensure that all of the resulting rotations are normalized
+		OutPose.NormalizeRotations();
+	}
 
 	OutCurve.Lerp(SourcePoseOneData.GetCurve(), SourcePoseTwoData.GetCurve(), WeightOfPoseTwo);
 	UE::Anim::Attributes::BlendAttributes({ SourcePoseOneData.GetAttributes(), SourcePoseTwoData.GetAttributes() }, { WeightOfPoseOne, WeightOfPoseTwo }, { 0, 1 }, OutAttributes);
@@ -1102,10 +1156,22 @@ void FAnimationRuntime::AccumulateMeshSpaceRotationAdditiveToLocalPose(FAnimatio
 
 void FAnimationRuntime::AccumulateAdditivePose(FAnimationPoseData& BaseAnimationPoseData, const FAnimationPoseData& AdditiveAnimationPoseData, float Weight, enum EAdditiveAnimationType AdditiveType)
 {
+	bool bRotationsNormalized = false;
 	if (AdditiveType == AAT_RotationOffsetMeshSpace)
 	{
 		AccumulateMeshSpaceRotationAdditiveToLocalPoseInternal(BaseAnimationPoseData.GetPose(), AdditiveAnimationPoseData.GetPose(), Weight);
 	}
+	else if (bAnim_PoseSoA_Enabled && FAnimWeight::IsRelevant(Weight))
+	{
+		// Apply the additive pose and normalize as a structure of arrays, converting the base pose once
+		FCompactPose& BasePose = BaseAnimationPoseData.GetPose();
+		FCompactPoseSoA AccumulatedPose;
+		AccumulatedPose.CopyFrom(BasePose.GetBones());
+		AccumulatedPose.AccumulateAdditive(AdditiveAnimationPoseData.GetPose().GetBones(), Weight);
+		AccumulatedPose.NormalizeRotations();
+		AccumulatedPose.CopyTo(BasePose.GetMutableBones());
+		bRotationsNormalized = true;
+	}
 	else
 	{
 		AccumulateLocalSpaceAdditivePoseInternal(BaseAnimationPoseData.GetPose(), AdditiveAnimationPoseData.GetPose(), Weight);
@@ -1117,7 +1183,10 @@ void FAnimationRuntime::AccumulateAdditivePose(FAnimationPoseData& BaseAnimation
 	UE::Anim::Attributes::AccumulateAttributes(AdditiveAnimationPoseData.GetAttributes(), BaseAnimationPoseData.GetAttributes(), Weight, AdditiveType);
 	
 	// normalize
-	BaseAnimationPoseData.GetPose().NormalizeRotations();
+	if (!bRotationsNormalized)
+	{
+		BaseAnimationPoseData.GetPose().NormalizeRotations();
+	}
 }
 
 void FAnimationRuntime::AccumulateLocalSpaceAdditivePoseInternal(FCompactPose& BasePose, const FCompactPose& AdditivePose, float Weight)
@@ -1248,6 +1317,16 @@ void FAnimationRuntime::MirrorPose(FCompactPose& Pose, EAxis::Type MirrorAxis, c
 		return;
 	}
 
+	if (bAnim_PoseSoA_Enabled)
+	{
+		FCompactPoseSoA SourcePose;
+		FCompactPoseSoA MirroredPose;
+		SourcePose.CopyFrom(Pose.GetBones());
+		MirroredPose.Mirror(SourcePose, BoneContainer, MirrorAxis, CompactPoseMirrorBones, ComponentSpaceRefRotations);
+		MirroredPose.CopyTo(Pose.GetMutableBones());
+		return;
+	}
+
 	// Mirroring is authored in object space and as such we must transform the local space transforms in object space in order
 	// to apply the object space mirroring axis. To facilitate this, we use object space transforms for the bind pose which can be cached.
 	// We ignore the translation/scale part of the bind pose as they don't impact mirroring.
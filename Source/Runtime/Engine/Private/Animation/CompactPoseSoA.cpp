@@ -0,0 +1,547 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Animation/CompactPoseSoA.h"
+#include "AnimationRuntime.h"
+#include "BoneContainer.h"
+
+namespace UE::Anim::CompactPoseSoA::Private
+{
+	static constexpr int32 NumStreams = FCompactPoseSoA::NumStreams;
+	static constexpr int32 NumLanes = FCompactPoseSoA::NumLanes;
+
+	/** One component of NumLanes consecutive bones per register */
+	struct FBoneRegisters
+	{
+		VectorRegister4Double Streams[NumStreams];
+
+		VectorRegister4Double* Rotation()
+		{
+			return &Streams[FCompactPoseSoA::RotationX];
+		}
+
+		VectorRegister4Double* Translation()
+		{
+			return &Streams[FCompactPoseSoA::TranslationX];
+		}
+
+		VectorRegister4Double* Scale()
+		{
+			return &Streams[FCompactPoseSoA::ScaleX];
+		}
+	};
+
+	static int32 GetNumBones(const FCompactPoseSoA& Pose)
+	{
+		return Pose.Num();
+	}
+
+	static int32 GetNumBones(TArrayView<const FTransform> Bones)
+	{
+		return Bones.Num();
+	}
+
+	static FORCEINLINE void LoadBones(const FCompactPoseSoA& Pose, int32 FirstBone, FBoneRegisters& OutBones)
+	{
+		for (int32 Stream = 0; Stream < NumStreams; Stream++)
+		{
+			OutBones.Streams[Stream] = VectorLoad(Pose.GetStream((FCompactPoseSoA::EStream)Stream) + FirstBone);
+		}
+	}
+
+	/** Gathers the components of transforms, repeating the last bone in the lanes past the end of the array */
+	static FORCEINLINE void LoadBones(TArrayView<const FTransform> Bones, int32 FirstBone, FBoneRegisters& OutBones)
+	{
+		alignas(32) double Values[NumStreams][NumLanes];
+		for (int32 Lane = 0; Lane < NumLanes; Lane++)
+		{
+			const FTransform& Bone = Bones[FMath::Min(FirstBone + Lane, Bones.Num() - 1)];
+			const FQuat Rotation = Bone.GetRotation();
+			const FVector Translation = Bone.GetTranslation();
+			const FVector Scale = Bone.GetScale3D();
+
+			Values[FCompactPoseSoA::RotationX][Lane] = Rotation.X;
+			Values[FCompactPoseSoA::RotationY][Lane] = Rotation.Y;
+			Values[FCompactPoseSoA::RotationZ][Lane] = Rotation.Z;
+			Values[FCompactPoseSoA::RotationW][Lane] = Rotation.W;
+			Values[FCompactPoseSoA::TranslationX][Lane] = Translation.X;
+			Values[FCompactPoseSoA::TranslationY][Lane] = Translation.Y;
+			Values[FCompactPoseSoA::TranslationZ][Lane] = Translation.Z;
+			Values[FCompactPoseSoA::ScaleX][Lane] = Scale.X;
+			Values[FCompactPoseSoA::ScaleY][Lane] = Scale.Y;
+			Values[FCompactPoseSoA::ScaleZ][Lane] = Scale.Z;
+		}
+
+		for (int32 Stream = 0; Stream < NumStreams; Stream++)
+		{
+			OutBones.Streams[Stream] = VectorLoadAligned(Values[Stream]);
+		}
+	}
+
+	static FORCEINLINE void StoreBones(FCompactPoseSoA& Pose, int32 FirstBone, const FBoneRegisters& Bones)
+	{
+		for (int32 Stream = 0; Stream < NumStreams; Stream++)
+		{
+			VectorStore(Bones.Streams[Stream], Pose.GetStream((FCompactPoseSoA::EStream)Stream) + FirstBone);
+		}
+	}
+
+	/** OutQ = A * B for the X, Y, Z and W registers of NumLanes quaternions. OutQ must not alias A or B. */
+	static FORCEINLINE void QuaternionMultiply(const VectorRegister4Double* A, const VectorRegister4Double* B, VectorRegister4Double* RESTRICT OutQ)
+	{
+		OutQ[0] = VectorNegateMultiplyAdd(A[2], B[1], VectorMultiplyAdd(A[1], B[2], VectorMultiplyAdd(A[0], B[3], VectorMultiply(A[3], B[0]))));
+		OutQ[1] = VectorMultiplyAdd(A[2], B[0], VectorMultiplyAdd(A[1], B[3], VectorNegateMultiplyAdd(A[0], B[2], VectorMultiply(A[3], B[1]))));
+		OutQ[2] = VectorMultiplyAdd(A[2], B[3], VectorNegateMultiplyAdd(A[1], B[0], VectorMultiplyAdd(A[0], B[1], VectorMultiply(A[3], B[2]))));
+		OutQ[3] = VectorNegateMultiplyAdd(A[2], B[2], VectorNegateMultiplyAdd(A[1], B[1], VectorNegateMultiplyAdd(A[0], B[0], VectorMultiply(A[3], B[3]))));
+	}
+
+	/** OutV = Q.RotateVector(V) for NumLanes quaternions and vectors. OutV must not alias V. */
+	static FORCEINLINE void QuaternionRotateVector(const VectorRegister4Double* Q, const VectorRegister4Double* V, VectorRegister4Double* RESTRICT OutV)
+	{
+		// T = 2 * cross(Q.XYZ, V), V' = V + W * T + cross(Q.XYZ, T)
+		const VectorRegister4Double Two = VectorSetFloat1(2.0);
+		const VectorRegister4Double T0 = VectorMultiply(Two, VectorNegateMultiplyAdd(Q[2], V[1], VectorMultiply(Q[1], V[2])));
+		const VectorRegister4Double T1 = VectorMultiply(Two, VectorNegateMultiplyAdd(Q[0], V[2], VectorMultiply(Q[2], V[0])));
+		const VectorRegister4Double T2 = VectorMultiply(Two, VectorNegateMultiplyAdd(Q[1], V[0], VectorMultiply(Q[0], V[1])));
+
+		OutV[0] = VectorAdd(VectorMultiplyAdd(Q[3], T0, V[0]), VectorNegateMultiplyAdd(Q[2], T1, VectorMultiply(Q[1], T2)));
+		OutV[1] = VectorAdd(VectorMultiplyAdd(Q[3], T1, V[1]), VectorNegateMultiplyAdd(Q[0], T2, VectorMultiply(Q[2], T0)));
+		OutV[2] = VectorAdd(VectorMultiplyAdd(Q[3], T2, V[2]), VectorNegateMultiplyAdd(Q[1], T0, VectorMultiply(Q[0], T1)));
+	}
+
+	/** Normalizes NumLanes quaternions, using identity for quaternions too small to be normalized, like VectorNormalizeSafe */
+	static FORCEINLINE void QuaternionNormalizeSafe(VectorRegister4Double* Q)
+	{
+		const VectorRegister4Double SquareSum = VectorMultiplyAdd(Q[3], Q[3], VectorMultiplyAdd(Q[2], Q[2], VectorMultiplyAdd(Q[1], Q[1], VectorMultiply(Q[0], Q[0]))));
+		const VectorRegister4Double NonZeroMask = VectorCompareGE(SquareSum, GlobalVectorConstants::DoubleSmallLengthThreshold);
+		const VectorRegister4Double InvLength = VectorReciprocalSqrtAccurate(SquareSum);
+
+		const VectorRegister4Double Zero = VectorZeroDouble();
+		Q[0] = VectorSelect(NonZeroMask, VectorMultiply(Q[0], InvLength), Zero);
+		Q[1] = VectorSelect(NonZeroMask, VectorMultiply(Q[1], InvLength), Zero);
+		Q[2] = VectorSelect(NonZeroMask, VectorMultiply(Q[2], InvLength), Zero);
+		Q[3] = VectorSelect(NonZeroMask, VectorMultiply(Q[3], InvLength), VectorOneDouble());
+	}
+}
+
+void FCompactPoseSoA::SetNum(int32 InNumBones)
+{
+	check(InNumBones >= 0);
+
+	NumBones = InNumBones;
+	StreamNum = Align(InNumBones, NumLanes);
+	Data.SetNumUninitialized(NumStreams * StreamNum, false);
+
+	for (int32 BoneIndex = NumBones; BoneIndex < StreamNum; BoneIndex++)
+	{
+		for (int32 Stream = 0; Stream < NumStreams; Stream++)
+		{
+			const bool bIsOne = Stream == RotationW || Stream >= ScaleX;
+			GetStream((EStream)Stream)[BoneIndex] = bIsOne ? 1.0 : 0.0;
+		}
+	}
+}
+
+FTransform FCompactPoseSoA::GetTransform(int32 BoneIndex) const
+{
+	check(BoneIndex >= 0 && BoneIndex < NumBones);
+
+	return FTransform(
+		FQuat(GetStream(RotationX)[BoneIndex], GetStream(RotationY)[BoneIndex], GetStream(RotationZ)[BoneIndex], GetStream(RotationW)[BoneIndex]),
+		FVector(GetStream(TranslationX)[BoneIndex], GetStream(TranslationY)[BoneIndex], GetStream(TranslationZ)[BoneIndex]),
+		FVector(GetStream(ScaleX)[BoneIndex], GetStream(ScaleY)[BoneIndex], GetStream(ScaleZ)[BoneIndex]));
+}
+
+void FCompactPoseSoA::CopyFrom(TArrayView<const FTransform> Bones)
+{
+	SetNum(Bones.Num());
+
+	double* RESTRICT Streams[NumStreams];
+	for (int32 Stream = 0; Stream < NumStreams; Stream++)
+	{
+		Streams[Stream] = GetStream((EStream)Stream);
+	}
+
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	{
+		const FTransform& Bone = Bones[BoneIndex];
+		const FQuat Rotation = Bone.GetRotation();
+		const FVector Translation = Bone.GetTranslation();
+		const FVector Scale = Bone.GetScale3D();
+
+		Streams[RotationX][BoneIndex] = Rotation.X;
+		Streams[RotationY][BoneIndex] = Rotation.Y;
+		Streams[RotationZ][BoneIndex] = Rotation.Z;
+		Streams[RotationW][BoneIndex] = Rotation.W;
+		Streams[TranslationX][BoneIndex] = Translation.X;
+		Streams[TranslationY][BoneIndex] = Translation.Y;
+		Streams[TranslationZ][BoneIndex] = Translation.Z;
+		Streams[ScaleX][BoneIndex] = Scale.X;
+		Streams[ScaleY][BoneIndex] = Scale.Y;
+		Streams[ScaleZ][BoneIndex] = Scale.Z;
+	}
+}
+
+void FCompactPoseSoA::CopyTo(TArrayView<FTransform> Bones) const
+{
+	check(Bones.Num() == NumBones);
+
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	{
+		Bones[BoneIndex] = GetTransform(BoneIndex);
+	}
+}
+
+template<typename SourceType>
+void FCompactPoseSoA::BlendOverwriteInternal(const SourceType& Source, float BlendWeight)
+{
+	using namespace UE::Anim::CompactPoseSoA::Private;
+
+	SetNum(GetNumBones(Source));
+
+	const VectorRegister4Double Weight = VectorSetFloat1((double)BlendWeight);
+	for (int32 FirstBone = 0; FirstBone < NumBones; FirstBone += NumLanes)
+	{
+		FBoneRegisters Bones;
+		LoadBones(Source, FirstBone, Bones);
+
+		for (int32 Stream = 0; Stream < NumStreams; Stream++)
+		{
+			Bones.Streams[Stream] = VectorMultiply(Bones.Streams[Stream], Weight);
+		}
+
+		StoreBones(*this, FirstBone, Bones);
+	}
+}
+
+void FCompactPoseSoA::BlendOverwrite(const FCompactPoseSoA& Source, float BlendWeight)
+{
+	BlendOverwriteInternal(Source, BlendWeight);
+}
+
+void FCompactPoseSoA::BlendOverwrite(TArrayView<const FTransform> Source, float BlendWeight)
+{
+	BlendOverwriteInternal(Source, BlendWeight);
+}
+
+template<typename SourceType>
+void FCompactPoseSoA::BlendAccumulateInternal(const SourceType& Source, float BlendWeight)
+{
+	using namespace UE::Anim::CompactPoseSoA::Private;
+
+	check(GetNumBones(Source) == NumBones);
+
+	const VectorRegister4Double Weight = VectorSetFloat1((double)BlendWeight);
+	const VectorRegister4Double Zero = VectorZeroDouble();
+	for (int32 FirstBone = 0; FirstBone < NumBones; FirstBone += NumLanes)
+	{
+		FBoneRegisters SourceBones;
+		FBoneRegisters Bones;
+		LoadBones(Source, FirstBone, SourceBones);
+		LoadBones(*this, FirstBone, Bones);
+
+		// Accumulate rotations in the shortest direction, like VectorAccumulateQuaternionShortestPath
+		VectorRegister4Double* Rotation = Bones.Rotation();
+		VectorRegister4Double BlendedRotation[4];
+		VectorRegister4Double RotationDot = Zero;
+		for (int32 Component = 0; Component < 4; Component++)
+		{
+			BlendedRotation[Component] = VectorMultiply(SourceBones.Rotation()[Component], Weight);
+			RotationDot = VectorMultiplyAdd(Rotation[Component], BlendedRotation[Component], RotationDot);
+		}
+
+		const VectorRegister4Double RotationDirMask = VectorCompareGE(RotationDot, Zero);
+		for (int32 Component = 0; Component < 4; Component++)
+		{
+			Rotation[Component] = VectorAdd(Rotation[Component], VectorSelect(RotationDirMask, BlendedRotation[Component], VectorNegate(BlendedRotation[Component])));
+		}
+
+		for (int32 Component = 0; Component < 3; Component++)
+		{
+			Bones.Translation()[Component] = VectorMultiplyAdd(SourceBones.Translation()[Component], Weight, Bones.Translation()[Component]);
+			Bones.Scale()[Component] = VectorMultiplyAdd(SourceBones.Scale()[Component], Weight, Bones.Scale()[Component]);
+		}
+
+		StoreBones(*this, FirstBone, Bones);
+	}
+}
+
+void FCompactPoseSoA::BlendAccumulate(const FCompactPoseSoA& Source, float BlendWeight)
+{
+	BlendAccumulateInternal(Source, BlendWeight);
+}
+
+void FCompactPoseSoA::BlendAccumulate(TArrayView<const FTransform> Source, float BlendWeight)
+{
+	BlendAccumulateInternal(Source, BlendWeight);
+}
+
+void FCompactPoseSoA::NormalizeRotations()
+{
+	using namespace UE::Anim::CompactPoseSoA::Private;
+
+	double* RESTRICT Rotations[4] = { GetStream(RotationX), GetStream(RotationY), GetStream(RotationZ), GetStream(RotationW) };
+	for (int32 FirstBone = 0; FirstBone < NumBones; FirstBone += NumLanes)
+	{
+		VectorRegister4Double Rotation[4];
+		for (int32 Component = 0; Component < 4; Component++)
+		{
+			Rotation[Component] = VectorLoad(Rotations[Component] + FirstBone);
+		}
+
+		QuaternionNormalizeSafe(Rotation);
+
+		for (int32 Component = 0; Component < 4; Component++)
+		{
+			VectorStore(Rotation[Component], Rotations[Component] + FirstBone);
+		}
+	}
+}
+
+template<typename SourceType>
+void FCompactPoseSoA::AccumulateAdditiveInternal(const SourceType& Additive, float BlendWeight)
+{
+	using namespace UE::Anim::CompactPoseSoA::Private;
+
+	check(GetNumBones(Additive) == NumBones);
+
+	if (!FAnimWeight::IsRelevant(BlendWeight))
+	{
+		return;
+	}
+
+	const bool bFullWeight = FAnimWeight::IsFullWeight(BlendWeight);
+	const VectorRegister4Double Weight = VectorSetFloat1((double)BlendWeight);
+	const VectorRegister4Double OneMinusWeight = VectorSetFloat1(1.0 - (double)BlendWeight);
+	const VectorRegister4Double One = VectorOneDouble();
+	const VectorRegister4Double Zero = VectorZeroDouble();
+	const VectorRegister4Double RotationSignificantThreshold = VectorSetFloat1(1.0 - UE_DELTA * UE_DELTA);
+
+	for (int32 FirstBone = 0; FirstBone < NumBones; FirstBone += NumLanes)
+	{
+		FBoneRegisters AdditiveBones;
+		FBoneRegisters Bones;
+		LoadBones(Additive, FirstBone, AdditiveBones);
+		LoadBones(*this, FirstBone, Bones);
+
+		VectorRegister4Double* AdditiveRotation = AdditiveBones.Rotation();
+		VectorRegister4Double BlendedRotation[4];
+		if (bFullWeight)
+		{
+			// Like FTransform::AccumulateWithAdditiveScale, only rotate bones whose additive rotation is significant
+			for (int32 Component = 0; Component < 4; Component++)
+			{
+				BlendedRotation[Component] = VectorMultiply(AdditiveRotation[Component], Weight);
+			}
+
+			VectorRegister4Double AccumulatedRotation[4];
+			QuaternionMultiply(BlendedRotation, Bones.Rotation(), AccumulatedRotation);
+
+			const VectorRegister4Double SignificantMask = VectorCompareGT(RotationSignificantThreshold, VectorMultiply(BlendedRotation[3], BlendedRotation[3]));
+			for (int32 Component = 0; Component < 4; Component++)
+			{
+				Bones.Rotation()[Component] = VectorSelect(SignificantMask, AccumulatedRotation[Component], Bones.Rotation()[Component]);
+			}
+		}
+		else
+		{
+			// Like FTransform::BlendFromIdentityAndAccumulate, blend from identity in the direction of the additive rotation
+			const VectorRegister4Double Bias = VectorSelect(VectorCompareGE(AdditiveRotation[3], Zero), One, VectorNegate(One));
+			BlendedRotation[0] = VectorMultiply(AdditiveRotation[0], Weight);
+			BlendedRotation[1] = VectorMultiply(AdditiveRotation[1], Weight);
+			BlendedRotation[2] = VectorMultiply(AdditiveRotation[2], Weight);
+			BlendedRotation[3] = VectorMultiplyAdd(Bias, OneMinusWeight, VectorMultiply(AdditiveRotation[3], Weight));
+			QuaternionNormalizeSafe(BlendedRotation);
+
+			VectorRegister4Double AccumulatedRotation[4];
+			QuaternionMultiply(BlendedRotation, Bones.Rotation(), AccumulatedRotation);
+			for (int32 Component = 0; Component < 4; Component++)
+			{
+				Bones.Rotation()[Component] = AccumulatedRotation[Component];
+			}
+		}
+
+		// Translation += Additive.Translation * Weight, Scale *= 1 + Additive.Scale * Weight
+		for (int32 Component = 0; Component < 3; Component++)
+		{
+			Bones.Translation()[Component] = VectorMultiplyAdd(AdditiveBones.Translation()[Component], Weight, Bones.Translation()[Component]);
+			Bones.Scale()[Component] = VectorMultiply(Bones.Scale()[Component], VectorMultiplyAdd(AdditiveBones.Scale()[Component], Weight, One));
+		}
+
+		StoreBones(*this, FirstBone, Bones);
+	}
+}
+
+void FCompactPoseSoA::AccumulateAdditive(const FCompactPoseSoA& Additive, float BlendWeight)
+{
+	AccumulateAdditiveInternal(Additive, BlendWeight);
+}
+
+void FCompactPoseSoA::AccumulateAdditive(TArrayView<const FTransform> Additive, float BlendWeight)
+{
+	AccumulateAdditiveInternal(Additive, BlendWeight);
+}
+
+void FCompactPoseSoA::Mirror(const FCompactPoseSoA& Source, const FBoneContainer& BoneContainer, EAxis::Type MirrorAxis, TArrayView<const FCompactPoseBoneIndex> CompactPoseMirrorBones, TArrayView<const FQuat> ComponentSpaceRefRotations)
+{
+	using namespace UE::Anim::CompactPoseSoA::Private;
+
+	check(&Source != this);
+	check(CompactPoseMirrorBones.Num() >= Source.Num() && ComponentSpaceRefRotations.Num() >= Source.Num());
+
+	SetNum(Source.Num());
+	if (MirrorAxis == EAxis::None || NumBones == 0)
+	{
+		FMemory::Memcpy(Data.GetData(), Source.Data.GetData(), Data.Num() * sizeof(double));
+		return;
+	}
+
+	// Find the bone mirrored into each bone, visiting bones in the same order as FAnimationRuntime::MirrorPose
+	// so pairs of bones are swapped the same way. Bones without a mirror bone keep their transform.
+	TArray<int32, FAnimStackAllocator> SourceBones;
+	SourceBones.Init(INDEX_NONE, StreamNum);
+	if (CompactPoseMirrorBones[0].IsValid())
+	{
+		SourceBones[0] = 0;
+	}
+
+	for (int32 TargetBone = 1; TargetBone < NumBones; TargetBone++)
+	{
+		const int32 SourceBone = CompactPoseMirrorBones[TargetBone].GetInt();
+		if (SourceBone == TargetBone)
+		{
+			SourceBones[TargetBone] = TargetBone;
+		}
+		else if (SourceBone > TargetBone)
+		{
+			SourceBones[TargetBone] = SourceBone;
+			SourceBones[SourceBone] = TargetBone;
+		}
+	}
+
+	// Reference rotations applied to each bone, as quaternion streams: the component space rotation of the source
+	// bone's parent, the inverse component space rotation of the target bone's parent, and the rotation correcting
+	// the mirrored source bone to the target bone's reference orientation.
+	enum EReferenceStream
+	{
+		SourceParentRotation = 0,
+		TargetParentInverseRotation = 4,
+		CorrectionRotation = 8,
+		NumReferenceStreams = 12
+	};
+
+	TArray<double, FAnimStackAllocator> ReferenceRotations;
+	ReferenceRotations.SetNumUninitialized(NumReferenceStreams * StreamNum);
+
+	TArray<int32, FAnimStackAllocator> KeptBones;
+	for (int32 TargetBone = 0; TargetBone < StreamNum; TargetBone++)
+	{
+		FQuat SourceParentRefRotation = FQuat::Identity;
+		FQuat TargetParentRefRotation = FQuat::Identity;
+		FQuat Correction = FQuat::Identity;
+
+		const int32 SourceBone = SourceBones[TargetBone];
+		if (SourceBone != INDEX_NONE)
+		{
+			const FCompactPoseBoneIndex SourceBoneIndex(SourceBone);
+			const FCompactPoseBoneIndex TargetBoneIndex(TargetBone);
+			if (TargetBone != 0)
+			{
+				SourceParentRefRotation = ComponentSpaceRefRotations[BoneContainer.GetParentBoneIndex(SourceBoneIndex).GetInt()];
+				TargetParentRefRotation = ComponentSpaceRefRotations[BoneContainer.GetParentBoneIndex(TargetBoneIndex).GetInt()];
+			}
+			Correction = FAnimationRuntime::MirrorQuat(ComponentSpaceRefRotations[SourceBone], MirrorAxis).Inverse() * ComponentSpaceRefRotations[TargetBone];
+		}
+		else
+		{
+			// Mirror the bone (or padding) onto itself with identity rotations, and restore its transform afterwards
+			SourceBones[TargetBone] = FMath::Min(TargetBone, NumBones - 1);
+			if (TargetBone < NumBones)
+			{
+				KeptBones.Add(TargetBone);
+			}
+		}
+
+		const FQuat TargetParentInverseRefRotation = TargetParentRefRotation.Inverse();
+		const FQuat* Rotations[] = { &SourceParentRefRotation, &TargetParentInverseRefRotation, &Correction };
+		for (int32 RotationIndex = 0; RotationIndex < 3; RotationIndex++)
+		{
+			double* Stream = ReferenceRotations.GetData() + RotationIndex * 4 * StreamNum;
+			Stream[0 * StreamNum + TargetBone] = Rotations[RotationIndex]->X;
+			Stream[1 * StreamNum + TargetBone] = Rotations[RotationIndex]->Y;
+			Stream[2 * StreamNum + TargetBone] = Rotations[RotationIndex]->Z;
+			Stream[3 * StreamNum + TargetBone] = Rotations[RotationIndex]->W;
+		}
+	}
+
+	// Mirroring negates the axis component of vectors, and the other two components of quaternions (see FAnimationRuntime::MirrorQuat)
+	VectorRegister4Double VectorMirror[3] = { VectorOneDouble(), VectorOneDouble(), VectorOneDouble() };
+	VectorRegister4Double QuatMirror[4] = { VectorOneDouble(), VectorOneDouble(), VectorOneDouble(), VectorOneDouble() };
+	const int32 MirrorComponent = MirrorAxis == EAxis::X ? 0 : (MirrorAxis == EAxis::Y ? 1 : 2);
+	for (int32 Component = 0; Component < 3; Component++)
+	{
+		if (Component == MirrorComponent)
+		{
+			VectorMirror[Component] = VectorNegate(VectorOneDouble());
+		}
+		else
+		{
+			QuatMirror[Component] = VectorNegate(VectorOneDouble());
+		}
+	}
+
+	for (int32 FirstBone = 0; FirstBone < NumBones; FirstBone += NumLanes)
+	{
+		// Gather the mirror bones
+		alignas(32) double Values[NumStreams][NumLanes];
+		for (int32 Lane = 0; Lane < NumLanes; Lane++)
+		{
+			const int32 SourceBone = SourceBones[FirstBone + Lane];
+			for (int32 Stream = 0; Stream < NumStreams; Stream++)
+			{
+				Values[Stream][Lane] = Source.GetStream((EStream)Stream)[SourceBone];
+			}
+		}
+
+		FBoneRegisters Bones;
+		for (int32 Stream = 0; Stream < NumStreams; Stream++)
+		{
+			Bones.Streams[Stream] = VectorLoadAligned(Values[Stream]);
+		}
+
+		VectorRegister4Double References[NumReferenceStreams];
+		for (int32 Stream = 0; Stream < NumReferenceStreams; Stream++)
+		{
+			References[Stream] = VectorLoad(ReferenceRotations.GetData() + Stream * StreamNum + FirstBone);
+		}
+
+		// Translation: rotate into object space, mirror, and rotate into the space of the target parent
+		VectorRegister4Double Translation[3];
+		QuaternionRotateVector(&References[SourceParentRotation], Bones.Translation(), Translation);
+		for (int32 Component = 0; Component < 3; Component++)
+		{
+			Translation[Component] = VectorMultiply(Translation[Component], VectorMirror[Component]);
+		}
+		QuaternionRotateVector(&References[TargetParentInverseRotation], Translation, Bones.Translation());
+
+		// Rotation: rotate into object space, mirror, correct to the target bone's reference orientation and rotate into the space of the target parent
+		VectorRegister4Double Rotation[4];
+		VectorRegister4Double CorrectedRotation[4];
+		QuaternionMultiply(&References[SourceParentRotation], Bones.Rotation(), Rotation);
+		for (int32 Component = 0; Component < 4; Component++)
+		{
+			Rotation[Component] = VectorMultiply(Rotation[Component], QuatMirror[Component]);
+		}
+		QuaternionMultiply(Rotation, &References[CorrectionRotation], CorrectedRotation);
+		QuaternionMultiply(&References[TargetParentInverseRotation], CorrectedRotation, Bones.Rotation());
+
+		StoreBones(*this, FirstBone, Bones);
+	}
+
+	for (const int32 BoneIndex : KeptBones)
+	{
+		for (int32 Stream = 0; Stream < NumStreams; Stream++)
+		{
+			GetStream((EStream)Stream)[BoneIndex] = Source.GetStream((EStream)Stream)[BoneIndex];
+		}
+	}
+}
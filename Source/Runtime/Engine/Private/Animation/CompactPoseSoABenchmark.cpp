@@ -0,0 +1,225 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Animation/CompactPoseSoA.h"
+#include "AnimationRuntime.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/Parse.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+
+#if INTEL_ISPC
+#include "AnimationRuntime.ispc.generated.h"
+#include "BonePose.ispc.generated.h"
+#endif
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+namespace UE::Anim::CompactPoseSoABenchmark
+{
+	// Number of source poses of the multi pose blend, like a blend space sampling a 2D grid.
+	static const int32 NumBlendPoses = 4;
+
+	static void InitPose(TArray<FTransform>& OutPose, int32 NumBones, FRandomStream& Random)
+	{
+		OutPose.SetNumUninitialized(NumBones);
+		for (FTransform& Bone : OutPose)
+		{
+			const FQuat Rotation = FQuat(FRotator(Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f)));
+			const FVector Translation(Random.FRandRange(-50.f, 50.f), Random.FRandRange(-50.f, 50.f), Random.FRandRange(-50.f, 50.f));
+			const FVector Scale(Random.FRandRange(0.8f, 1.2f), Random.FRandRange(0.8f, 1.2f), Random.FRandRange(0.8f, 1.2f));
+			Bone = FTransform(Rotation, Translation, Scale);
+		}
+	}
+
+	static double GetMaxError(const TArray<FTransform>& Expected, const TArray<FTransform>& Bones)
+	{
+		double MaxError = 0.0;
+		for (int32 BoneIndex = 0; BoneIndex < Bones.Num(); ++BoneIndex)
+		{
+			const FTransform& A = Expected[BoneIndex];
+			const FTransform& B = Bones[BoneIndex];
+			MaxError = FMath::Max(MaxError, FMath::Abs(A.GetRotation().X - B.GetRotation().X));
+			MaxError = FMath::Max(MaxError, FMath::Abs(A.GetRotation().Y - B.GetRotation().Y));
+			MaxError = FMath::Max(MaxError, FMath::Abs(A.GetRotation().Z - B.GetRotation().Z));
+			MaxError = FMath::Max(MaxError, FMath::Abs(A.GetRotation().W - B.GetRotation().W));
+			MaxError = FMath::Max(MaxError, (A.GetTranslation() - B.GetTranslation()).GetAbsMax());
+			MaxError = FMath::Max(MaxError, (A.GetScale3D() - B.GetScale3D()).GetAbsMax());
+		}
+		return MaxError;
+	}
+
+	static void BlendOverwrite(const TArray<FTransform>& Source, TArray<FTransform>& Result, float Weight, bool bUseISPC)
+	{
+#if INTEL_ISPC
+		if (bUseISPC)
+		{
+			ispc::BlendTransformOverwrite((ispc::FTransform*)Source.GetData(), (ispc::FTransform*)Result.GetData(), Weight, Source.Num());
+			return;
+		}
+#endif
+		for (int32 BoneIndex = 0; BoneIndex < Source.Num(); ++BoneIndex)
+		{
+			BlendTransform<ETransformBlendMode::Overwrite>(Source[BoneIndex], Result[BoneIndex], Weight);
+		}
+	}
+
+	static void BlendAccumulate(const TArray<FTransform>& Source, TArray<FTransform>& Result, float Weight, bool bUseISPC)
+	{
+#if INTEL_ISPC
+		if (bUseISPC)
+		{
+			ispc::BlendTransformAccumulate((ispc::FTransform*)Source.GetData(), (ispc::FTransform*)Result.GetData(), Weight, Source.Num());
+			return;
+		}
+#endif
+		for (int32 BoneIndex = 0; BoneIndex < Source.Num(); ++BoneIndex)
+		{
+			BlendTransform<ETransformBlendMode::Accumulate>(Source[BoneIndex], Result[BoneIndex], Weight);
+		}
+	}
+
+	static void NormalizeRotations(TArray<FTransform>& Bones, bool bUseISPC)
+	{
+#if INTEL_ISPC
+		if (bUseISPC)
+		{
+			ispc::NormalizeRotations((ispc::FTransform*)Bones.GetData(), Bones.Num());
+			return;
+		}
+#endif
+		for (FTransform& Bone : Bones)
+		{
+			Bone.NormalizeRotation();
+		}
+	}
+
+	static void BlendPoses(const TArray<FTransform>* Sources, const float* Weights, TArray<FTransform>& Result, bool bUseISPC)
+	{
+		BlendOverwrite(Sources[0], Result, Weights[0], bUseISPC);
+		for (int32 PoseIndex = 1; PoseIndex < NumBlendPoses; ++PoseIndex)
+		{
+			BlendAccumulate(Sources[PoseIndex], Result, Weights[PoseIndex], bUseISPC);
+		}
+		NormalizeRotations(Result, bUseISPC);
+	}
+
+	static void RunCompactPoseSoABenchmark(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		int32 NumBones = 200;
+		int32 Iterations = 10000;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Bones="), NumBones);
+			FParse::Value(*Arg, TEXT("Iterations="), Iterations);
+		}
+		NumBones = FMath::Clamp(NumBones, 1, 10000);
+		Iterations = FMath::Clamp(Iterations, 1, 1000000);
+
+		FMemMark Mark(FMemStack::Get());
+
+		FRandomStream Random(1234);
+		TArray<FTransform> Sources[NumBlendPoses];
+		for (TArray<FTransform>& Source : Sources)
+		{
+			InitPose(Source, NumBones, Random);
+		}
+		const float Weights[NumBlendPoses] = { 0.4f, 0.3f, 0.2f, 0.1f };
+
+		TArray<FTransform> Expected;
+		TArray<FTransform> Result;
+		Expected.SetNumUninitialized(NumBones);
+		Result.SetNumUninitialized(NumBones);
+
+		FCompactPoseSoA SoAPose;
+		FCompactPoseSoA SoASource;
+		SoASource.CopyFrom(Sources[1]);
+
+		Ar.Logf(TEXT("Compact pose SoA benchmark: %d bones, %d iterations. Cost is the average time per pose, in microseconds."), NumBones, Iterations);
+		Ar.Logf(TEXT("%-12s %10s %10s %10s %10s"), TEXT("Operation"), TEXT("Transform"), TEXT("ISPC"), TEXT("SoA"), TEXT("Error"));
+
+		const bool bHasISPC = INTEL_ISPC != 0;
+		auto LogRow = [&Ar, bHasISPC](const TCHAR* Operation, double TransformCost, double ISPCCost, double SoACost, double MaxError)
+		{
+			if (bHasISPC)
+			{
+				Ar.Logf(TEXT("%-12s %10.3f %10.3f %10.3f %10.1e"), Operation, TransformCost * 1000000.0, ISPCCost * 1000000.0, SoACost * 1000000.0, MaxError);
+			}
+			else
+			{
+				Ar.Logf(TEXT("%-12s %10.3f %10s %10.3f %10.1e"), Operation, TransformCost * 1000000.0, TEXT("-"), SoACost * 1000000.0, MaxError);
+			}
+		};
+
+		// Overwrite: sources are read as transforms and the result stays in streams, like the first pose of a blend.
+		{
+			BlendOverwrite(Sources[0], Expected, Weights[0], false);
+			const double TransformCost = UE::TimeAverageDuration(Iterations, [&]() { BlendOverwrite(Sources[0], Result, Weights[0], false); });
+			const double ISPCCost = bHasISPC ? UE::TimeAverageDuration(Iterations, [&]() { BlendOverwrite(Sources[0], Result, Weights[0], true); }) : 0.0;
+			const double SoACost = UE::TimeAverageDuration(Iterations, [&]() { SoAPose.BlendOverwrite(Sources[0], Weights[0]); });
+			SoAPose.CopyTo(Result);
+			LogRow(TEXT("Overwrite"), TransformCost, ISPCCost, SoACost, GetMaxError(Expected, Result));
+		}
+
+		// Accumulate: the same weighted source is accumulated repeatedly into the pose.
+		{
+			const TArray<FTransform> Initial = Expected;
+			BlendAccumulate(Sources[1], Expected, Weights[1], false);
+
+			Result = Initial;
+			const double TransformCost = UE::TimeAverageDuration(Iterations, [&]() { BlendAccumulate(Sources[1], Result, Weights[1], false); });
+			Result = Initial;
+			const double ISPCCost = bHasISPC ? UE::TimeAverageDuration(Iterations, [&]() { BlendAccumulate(Sources[1], Result, Weights[1], true); }) : 0.0;
+
+			SoAPose.CopyFrom(Initial);
+			const double SoACost = UE::TimeAverageDuration(Iterations, [&]() { SoAPose.BlendAccumulate(SoASource, Weights[1]); });
+
+			// Measure the error of a single accumulation
+			SoAPose.CopyFrom(Initial);
+			SoAPose.BlendAccumulate(Sources[1], Weights[1]);
+			SoAPose.CopyTo(Result);
+			LogRow(TEXT("Accumulate"), TransformCost, ISPCCost, SoACost, GetMaxError(Expected, Result));
+		}
+
+		// Normalize: rotations are already normalized after the first run, which doesn't change the cost.
+		{
+			Expected = Sources[2];
+			NormalizeRotations(Expected, false);
+
+			Result = Sources[2];
+			const double TransformCost = UE::TimeAverageDuration(Iterations, [&]() { NormalizeRotations(Result, false); });
+			Result = Sources[2];
+			const double ISPCCost = bHasISPC ? UE::TimeAverageDuration(Iterations, [&]() { NormalizeRotations(Result, true); }) : 0.0;
+
+			SoAPose.CopyFrom(Sources[2]);
+			const double SoACost = UE::TimeAverageDuration(Iterations, [&]() { SoAPose.NormalizeRotations(); });
+			SoAPose.CopyTo(Result);
+			LogRow(TEXT("Normalize"), TransformCost, ISPCCost, SoACost, GetMaxError(Expected, Result));
+		}
+
+		// Blend of NumBlendPoses poses, including the conversion of the result back to transforms.
+		{
+			BlendPoses(Sources, Weights, Expected, false);
+			const double TransformCost = UE::TimeAverageDuration(Iterations, [&]() { BlendPoses(Sources, Weights, Result, false); });
+			const double ISPCCost = bHasISPC ? UE::TimeAverageDuration(Iterations, [&]() { BlendPoses(Sources, Weights, Result, true); }) : 0.0;
+			const double SoACost = UE::TimeAverageDuration(Iterations, [&]()
+			{
+				SoAPose.BlendOverwrite(Sources[0], Weights[0]);
+				for (int32 PoseIndex = 1; PoseIndex < NumBlendPoses; ++PoseIndex)
+				{
+					SoAPose.BlendAccumulate(Sources[PoseIndex], Weights[PoseIndex]);
+				}
+				SoAPose.NormalizeRotations();
+				SoAPose.CopyTo(Result);
+			});
+			LogRow(TEXT("Blend 4"), TransformCost, ISPCCost, SoACost, GetMaxError(Expected, Result));
+		}
+	}
+}
+
+static FAutoConsoleCommand CompactPoseSoABenchmarkCmd(
+	TEXT("a.PoseSoA.Benchmark"),
+	TEXT("Compares the cost of blending, accumulating and normalizing poses as FTransform arrays, with ISPC and as a structure of arrays. Usage: a.PoseSoA.Benchmark [Bones=200] [Iterations=10000]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&UE::Anim::CompactPoseSoABenchmark::RunCompactPoseSoABenchmark));
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -536,6 +536,7 @@ protected:
 AsyncTraceData::AsyncTraceData()
 	: NumQueuedTraceData(0)
 	, NumQueuedOverlapData(0)
+	, NumQueuedBatchTraceData(0)
 	, bAsyncAllowed(false)
 	, bAsyncTasksCompleted(false)
 {}
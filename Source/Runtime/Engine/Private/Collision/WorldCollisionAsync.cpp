@@ -5,10 +5,17 @@
 =============================================================================*/
 
 #include "Engine/World.h"
+#include "Algo/Count.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
 #include "Async/TaskGraphInterfaces.h"
 #include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
 #include "Misc/App.h"
 #include "Misc/Fork.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/Parse.h"
 #include "Physics/Experimental/PhysInterface_Chaos.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 
@@ -44,6 +51,26 @@ namespace AsyncTraceCVars
 	{
 		return RunAsyncTraceOnWorkerThread != 0 && (FApp::ShouldUseThreadingForPerformance() || FForkProcessHelper::IsForkedMultithreadInstance());
 	}
+
+	static int32 AsyncBatchTraceChunkSize = 256;
+	static FAutoConsoleVariableRef CVarAsyncBatchTraceChunkSize(
+		TEXT("AsyncBatchTraceChunkSize"),
+		AsyncBatchTraceChunkSize,
+		TEXT("Number of queries of a batch of traces that are traced by each worker thread task."),
+		ECVF_Default);
+
+	static int32 AsyncBatchTraceSortQueries = 1;
+	static FAutoConsoleVariableRef CVarAsyncBatchTraceSortQueries(
+		TEXT("AsyncBatchTraceSortQueries"),
+		AsyncBatchTraceSortQueries,
+		TEXT("Whether to sort the queries of a batch of traces along a Morton curve, so that each task traces queries close to each other which traverse the same parts of the acceleration structure. \n")
+		TEXT("0: Trace in the order of the queries, 1: Sort queries"),
+		ECVF_Default);
+
+	int32 GetAsyncBatchTraceChunkSize()
+	{
+		return FMath::Max(AsyncBatchTraceChunkSize, 1);
+	}
 }
 
 namespace
@@ -213,6 +240,98 @@ namespace
 		}
 	}
 
+	// Spreads the low 10 bits of a value so that there are 2 zero bits between each bit, for 3D Morton codes
+	FORCEINLINE uint32 SpreadMortonBits(uint32 Value)
+	{
+		Value &= 0x000003ff;
+		Value = (Value ^ (Value << 16)) & 0xff0000ff;
+		Value = (Value ^ (Value << 8)) & 0x0300f00f;
+		Value = (Value ^ (Value << 4)) & 0x030c30c3;
+		Value = (Value ^ (Value << 2)) & 0x09249249;
+		return Value;
+	}
+
+	/**
+	 * Sorts the queries of a batch along a Morton curve of their midpoints. Chaos traverses its acceleration structure one query at a time,
+	 * so consecutive queries close to each other visit the same nodes while they are still in cache. Batches traced by a single task are not sorted.
+	 */
+	void SortBatchTraceQueries(TConstArrayView<FBatchTraceQuery> Queries, TArray<uint64>& OutQueryOrder)
+	{
+		OutQueryOrder.Reset();
+		if (AsyncTraceCVars::AsyncBatchTraceSortQueries == 0 || Queries.Num() <= AsyncTraceCVars::GetAsyncBatchTraceChunkSize())
+		{
+			return;
+		}
+
+		FBox Bounds(ForceInit);
+		for (const FBatchTraceQuery& Query : Queries)
+		{
+			Bounds += (Query.Start + Query.End) * 0.5;
+		}
+
+		const FVector Size = Bounds.GetSize();
+		const FVector Scale(1023.0 / FMath::Max(Size.X, (double)UE_KINDA_SMALL_NUMBER), 1023.0 / FMath::Max(Size.Y, (double)UE_KINDA_SMALL_NUMBER), 1023.0 / FMath::Max(Size.Z, (double)UE_KINDA_SMALL_NUMBER));
+
+		OutQueryOrder.SetNumUninitialized(Queries.Num(), false);
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			const FVector Cell = ((Queries[QueryIndex].Start + Queries[QueryIndex].End) * 0.5 - Bounds.Min) * Scale;
+			const uint32 Key = SpreadMortonBits((uint32)Cell.X) | (SpreadMortonBits((uint32)Cell.Y) << 1) | (SpreadMortonBits((uint32)Cell.Z) << 2);
+			OutQueryOrder[QueryIndex] = ((uint64)Key << 32) | (uint32)QueryIndex;
+		}
+
+		Algo::Sort(OutQueryOrder);
+	}
+
+	/** Traces NumQueries queries of a batch from FirstQuery, in the order of QueryOrder if it's not empty. Returns the number of queries that hit something. */
+	int32 RunBatchTrace(const UWorld* World, const FCollisionParameters& CollisionParams, ECollisionChannel TraceChannel, const FQuat& Rot, EAsyncTraceType TraceType,
+		TConstArrayView<FBatchTraceQuery> Queries, TConstArrayView<uint64> QueryOrder, TArrayView<FHitResult> OutHits, int32 FirstQuery, int32 NumQueries)
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_RunBatchTrace);
+
+		const FCollisionShape& CollisionShape = CollisionParams.CollisionShape;
+		const bool bLineTrace = (CollisionShape.ShapeType == ECollisionShape::Line) || CollisionShape.IsNearlyZero();
+
+		int32 NumHits = 0;
+		for (int32 OrderIndex = FirstQuery; OrderIndex < FirstQuery + NumQueries; ++OrderIndex)
+		{
+			const int32 QueryIndex = QueryOrder.Num() > 0 ? (int32)(QueryOrder[OrderIndex] & MAX_uint32) : OrderIndex;
+			const FBatchTraceQuery& Query = Queries[QueryIndex];
+			FHitResult& Hit = OutHits[QueryIndex];
+			Hit = FHitResult(Query.Start, Query.End);
+
+			if (!World)
+			{
+				continue;
+			}
+
+			bool bHit;
+			if (TraceType == EAsyncTraceType::Test)
+			{
+				bHit = bLineTrace
+					? FPhysicsInterface::RaycastTest(World, Query.Start, Query.End, TraceChannel, CollisionParams.CollisionQueryParam, CollisionParams.ResponseParam, CollisionParams.ObjectQueryParam)
+					: FPhysicsInterface::GeomSweepTest(World, CollisionShape, Rot, Query.Start, Query.End, TraceChannel, CollisionParams.CollisionQueryParam, CollisionParams.ResponseParam, CollisionParams.ObjectQueryParam);
+			}
+			else
+			{
+				bHit = bLineTrace
+					? FPhysicsInterface::RaycastSingle(World, Hit, Query.Start, Query.End, TraceChannel, CollisionParams.CollisionQueryParam, CollisionParams.ResponseParam, CollisionParams.ObjectQueryParam)
+					: FPhysicsInterface::GeomSweepSingle(World, CollisionShape, Rot, Hit, Query.Start, Query.End, TraceChannel, CollisionParams.CollisionQueryParam, CollisionParams.ResponseParam, CollisionParams.ObjectQueryParam);
+			}
+
+			Hit.bBlockingHit = bHit;
+			NumHits += bHit ? 1 : 0;
+		}
+
+		return NumHits;
+	}
+
+	void RunBatchTraceTask(FBatchTraceDatum& BatchTraceData, int32 FirstQuery, int32 NumQueries)
+	{
+		RunBatchTrace(BatchTraceData.PhysWorld.Get(), BatchTraceData.CollisionParams, BatchTraceData.TraceChannel, BatchTraceData.Rot, BatchTraceData.TraceType,
+			BatchTraceData.Queries, BatchTraceData.QueryOrder, BatchTraceData.OutHits, FirstQuery, NumQueries);
+	}
+
 	FAutoConsoleTaskPriority CPrio_FAsyncTraceTask(
 		TEXT("TaskGraph.TaskPriorities.AsyncTraceTask"),
 		TEXT("Task and thread priority for async traces."),
@@ -285,6 +404,41 @@ namespace
 		}
 	};
 
+	/** Helper class define the task tracing a range of queries of a batch **/
+	class FAsyncBatchTraceTask
+	{
+		FBatchTraceDatum* BatchTraceData;
+		int32 FirstQuery;
+		int32 NumQueries;
+
+	public:
+		FAsyncBatchTraceTask(FBatchTraceDatum* InBatchTraceData, int32 InFirstQuery, int32 InNumQueries)
+			: BatchTraceData(InBatchTraceData)
+			, FirstQuery(InFirstQuery)
+			, NumQueries(InNumQueries)
+		{
+			check(InBatchTraceData);
+			check(InNumQueries > 0);
+		}
+
+		static FORCEINLINE TStatId GetStatId()
+		{
+			RETURN_QUICK_DECLARE_CYCLE_STAT(FAsyncBatchTraceTask, STATGROUP_TaskGraphTasks);
+		}
+		static FORCEINLINE ENamedThreads::Type GetDesiredThread()
+		{
+			return CPrio_FAsyncTraceTask.Get();
+		}
+		static FORCEINLINE ESubsequentsMode::Type GetSubsequentsMode()
+		{ 
+			return ESubsequentsMode::TrackSubsequents; 
+		}
+		void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+		{
+			RunBatchTraceTask(*BatchTraceData, FirstQuery, NumQueries);
+		}
+	};
+
 	// This runs each chunk whenever filled up to GAsyncChunkSizeToIncrement OR when ExecuteAll is true
 	template <typename DatumType>
 	void ExecuteAsyncTraceIfAvailable(FWorldAsyncTraceState& State, bool bExecuteAll)
@@ -352,6 +506,50 @@ namespace
 
 		return Result;
 	}
+
+	FTraceHandle StartNewBatchTrace(UWorld* World, FWorldAsyncTraceState& State, EAsyncTraceType InTraceType, TConstArrayView<FBatchTraceQuery> Queries, const FQuat& Rot, ECollisionChannel TraceChannel,
+		const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParam, uint32 UserData)
+	{
+		// Using async traces outside of the game thread can cause memory corruption
+		check(IsInGameThread());
+
+		AsyncTraceData& DataBuffer = State.GetBufferForCurrentFrame();
+		check(DataBuffer.bAsyncAllowed);
+
+		// Batches are persistent, so the arrays of a batch are reused by the batch with the same index two frames later
+		if (DataBuffer.NumQueuedBatchTraceData == DataBuffer.BatchTraceData.Num())
+		{
+			DataBuffer.BatchTraceData.Add(MakeUnique<FBatchTraceDatum>());
+		}
+		const int32 BatchIndex = DataBuffer.NumQueuedBatchTraceData++;
+
+		FBatchTraceDatum& BatchTraceData = *DataBuffer.BatchTraceData[BatchIndex];
+		BatchTraceData.Set(World, CollisionShape, Params, ResponseParam, FCollisionObjectQueryParams::DefaultObjectQueryParam, TraceChannel, UserData, State.CurrentFrame);
+		BatchTraceData.Queries.Reset();
+		BatchTraceData.Queries.Append(Queries.GetData(), Queries.Num());
+		BatchTraceData.Rot = Rot;
+		BatchTraceData.TraceType = ensureMsgf(InTraceType != EAsyncTraceType::Multi, TEXT("Batches of traces don't support multi traces")) ? InTraceType : EAsyncTraceType::Single;
+		BatchTraceData.OutHits.SetNum(Queries.Num(), false);
+		SortBatchTraceQueries(Queries, BatchTraceData.QueryOrder);
+
+		// The whole batch is known, so its tasks are dispatched right away instead of waiting for the end of the frame
+		const int32 ChunkSize = AsyncTraceCVars::GetAsyncBatchTraceChunkSize();
+		const bool bRunAsyncTraceOnWorkerThread = AsyncTraceCVars::IsAsyncTraceOnWorkerThreads();
+		for (int32 FirstQuery = 0; FirstQuery < Queries.Num(); FirstQuery += ChunkSize)
+		{
+			const int32 NumQueries = FMath::Min(ChunkSize, Queries.Num() - FirstQuery);
+			if (bRunAsyncTraceOnWorkerThread)
+			{
+				DataBuffer.AsyncTraceCompletionEvent.Emplace(TGraphTask<FAsyncBatchTraceTask>::CreateTask(NULL, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(&BatchTraceData, FirstQuery, NumQueries));
+			}
+			else
+			{
+				RunBatchTraceTask(BatchTraceData, FirstQuery, NumQueries);
+			}
+		}
+
+		return FTraceHandle(State.CurrentFrame, BatchIndex);
+	}
 }
 
 FWorldAsyncTraceState::FWorldAsyncTraceState()
@@ -419,6 +617,42 @@ FTraceHandle UWorld::AsyncOverlapByProfile(const FVector& Pos, const FQuat& Rot,
 	return StartNewTrace(AsyncTraceState, FOverlapDatum(this, CollisionShape, Params, ResponseParam, FCollisionObjectQueryParams::DefaultObjectQueryParam, TraceChannel, UserData, Pos, Rot, InDelegate, AsyncTraceState.CurrentFrame));
 }
 
+FTraceHandle UWorld::AsyncBatchLineTraceByChannel(EAsyncTraceType InTraceType, TConstArrayView<FBatchTraceQuery> Queries, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params /* = FCollisionQueryParams::DefaultQueryParam */, const FCollisionResponseParams& ResponseParam /* = FCollisionResponseParams::DefaultResponseParam */, uint32 UserData /* = 0 */)
+{
+	return StartNewBatchTrace(this, AsyncTraceState, InTraceType, Queries, FQuat::Identity, TraceChannel, FCollisionShape::LineShape, Params, ResponseParam, UserData);
+}
+
+FTraceHandle UWorld::AsyncBatchSweepByChannel(EAsyncTraceType InTraceType, TConstArrayView<FBatchTraceQuery> Queries, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params /* = FCollisionQueryParams::DefaultQueryParam */, const FCollisionResponseParams& ResponseParam /* = FCollisionResponseParams::DefaultResponseParam */, uint32 UserData /* = 0 */)
+{
+	return StartNewBatchTrace(this, AsyncTraceState, InTraceType, Queries, Rot, TraceChannel, CollisionShape, Params, ResponseParam, UserData);
+}
+
+int32 UWorld::BatchTraceByChannel(EAsyncTraceType InTraceType, TConstArrayView<FBatchTraceQuery> Queries, TArray<FHitResult>& OutHits, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params /* = FCollisionQueryParams::DefaultQueryParam */, const FCollisionResponseParams& ResponseParam /* = FCollisionResponseParams::DefaultResponseParam */) const
+{
+	FCollisionParameters CollisionParams;
+	CollisionParams.CollisionQueryParam = Params;
+	CollisionParams.ResponseParam = ResponseParam;
+	CollisionParams.ObjectQueryParam = FCollisionObjectQueryParams::DefaultObjectQueryParam;
+	CollisionParams.CollisionShape = CollisionShape;
+
+	const EAsyncTraceType TraceType = ensureMsgf(InTraceType != EAsyncTraceType::Multi, TEXT("Batches of traces don't support multi traces")) ? InTraceType : EAsyncTraceType::Single;
+
+	TArray<uint64> QueryOrder;
+	SortBatchTraceQueries(Queries, QueryOrder);
+	OutHits.SetNum(Queries.Num(), false);
+
+	const int32 ChunkSize = AsyncTraceCVars::GetAsyncBatchTraceChunkSize();
+	const int32 NumChunks = FMath::DivideAndRoundUp(Queries.Num(), ChunkSize);
+	std::atomic<int32> NumHits(0);
+	ParallelFor(NumChunks, [this, &CollisionParams, TraceChannel, &Rot, TraceType, Queries, &QueryOrder, &OutHits, ChunkSize, &NumHits](int32 ChunkIndex)
+	{
+		const int32 FirstQuery = ChunkIndex * ChunkSize;
+		NumHits += RunBatchTrace(this, CollisionParams, TraceChannel, Rot, TraceType, Queries, QueryOrder, OutHits, FirstQuery, FMath::Min(ChunkSize, Queries.Num() - FirstQuery));
+	}, AsyncTraceCVars::IsAsyncTraceOnWorkerThreads() ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	return NumHits;
+}
+
 bool UWorld::IsTraceHandleValid(const FTraceHandle& Handle, bool bOverlapTrace)
 {
 	// only valid if it's previous frame or current frame
@@ -465,6 +699,23 @@ bool UWorld::QueryTraceData(const FTraceHandle& Handle, FTraceDatum& OutData)
 	return false;
 }
 
+const FBatchTraceDatum* UWorld::QueryBatchTraceData(const FTraceHandle& Handle)
+{
+	// valid if previous frame request
+	if (Handle._Data.FrameNumber != AsyncTraceState.CurrentFrame - 1)
+	{
+		return nullptr;
+	}
+
+	AsyncTraceData& DataBuffer = AsyncTraceState.GetBufferForPreviousFrame();
+	if (!DataBuffer.bAsyncTasksCompleted || Handle._Data.Index >= (uint32)DataBuffer.NumQueuedBatchTraceData)
+	{
+		return nullptr;
+	}
+
+	return DataBuffer.BatchTraceData[Handle._Data.Index].Get();
+}
+
 bool UWorld::QueryOverlapData(const FTraceHandle& Handle, FOverlapDatum& OutData)
 {
 	if (Handle._Data.FrameNumber != AsyncTraceState.CurrentFrame - 1)
@@ -542,7 +793,167 @@ void UWorld::FinishAsyncTrace()
 	NewAsyncBuffer.bAsyncAllowed = true;
 	NewAsyncBuffer.NumQueuedTraceData = 0;
 	NewAsyncBuffer.NumQueuedOverlapData = 0;
+	NewAsyncBuffer.NumQueuedBatchTraceData = 0;
 	NewAsyncBuffer.bAsyncTasksCompleted = false;
 
 }
 
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+namespace AsyncBatchTraceBenchmark
+{
+	// Rays of agents looking around them like AI perception, every agent tracing RaysPerAgent rays from its location. Queries are shuffled, as if issued by many systems.
+	static void InitQueries(TArray<FBatchTraceQuery>& OutQueries, int32 NumTraces, float Radius, float Length)
+	{
+		const int32 RaysPerAgent = 32;
+		FRandomStream Random(1234);
+
+		OutQueries.Reset(NumTraces);
+		FVector Start = FVector::ZeroVector;
+		for (int32 TraceIndex = 0; TraceIndex < NumTraces; ++TraceIndex)
+		{
+			if (TraceIndex % RaysPerAgent == 0)
+			{
+				Start = FVector(Random.FRandRange(-Radius, Radius), Random.FRandRange(-Radius, Radius), Random.FRandRange(0.f, 500.f));
+			}
+			OutQueries.Add(FBatchTraceQuery(Start, Start + Random.GetUnitVector() * Length));
+		}
+
+		for (int32 TraceIndex = NumTraces - 1; TraceIndex > 0; --TraceIndex)
+		{
+			OutQueries.Swap(TraceIndex, Random.RandHelper(TraceIndex + 1));
+		}
+	}
+
+	static int32 CountMismatches(const TArray<FHitResult>& Expected, const TArray<FHitResult>& Hits)
+	{
+		int32 NumMismatches = 0;
+		for (int32 HitIndex = 0; HitIndex < Hits.Num(); ++HitIndex)
+		{
+			if (Expected[HitIndex].bBlockingHit != Hits[HitIndex].bBlockingHit || FMath::Abs(Expected[HitIndex].Distance - Hits[HitIndex].Distance) > 0.1f)
+			{
+				++NumMismatches;
+			}
+		}
+		return NumMismatches;
+	}
+
+	static void RunAsyncBatchTraceBenchmark(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		int32 NumTraces = 20000;
+		int32 Iterations = 10;
+		float Radius = 10000.f;
+		float Length = 5000.f;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Traces="), NumTraces);
+			FParse::Value(*Arg, TEXT("Iterations="), Iterations);
+			FParse::Value(*Arg, TEXT("Radius="), Radius);
+			FParse::Value(*Arg, TEXT("Length="), Length);
+		}
+		NumTraces = FMath::Clamp(NumTraces, 1, 1000000);
+		Iterations = FMath::Clamp(Iterations, 1, 1000);
+
+		if (!World || !World->GetPhysicsScene())
+		{
+			Ar.Logf(TEXT("AsyncBatchTraceBenchmark requires a world with a physics scene."));
+			return;
+		}
+
+		TArray<FBatchTraceQuery> Queries;
+		InitQueries(Queries, NumTraces, Radius, Length);
+
+		const ECollisionChannel TraceChannel = ECC_Visibility;
+		const FCollisionQueryParams Params(SCENE_QUERY_STAT(AsyncBatchTraceBenchmark), false);
+
+		Ar.Logf(TEXT("Async batch trace benchmark: %d single line traces from agents within %.0f units of the origin, %.0f units long, %d iterations. Cost is the average time per iteration, in milliseconds."),
+			NumTraces, Radius, Length, Iterations);
+		Ar.Logf(TEXT("%-14s %10s %12s %8s %10s"), TEXT("Mode"), TEXT("Cost"), TEXT("Traces/ms"), TEXT("Hits"), TEXT("Mismatches"));
+
+		auto LogRow = [&Ar, NumTraces, Iterations](const TCHAR* Mode, double Seconds, const TArray<FHitResult>& Hits, int32 NumMismatches)
+		{
+			const double Milliseconds = Seconds * 1000.0 / Iterations;
+			const int32 NumHits = Algo::CountIf(Hits, [](const FHitResult& Hit) { return Hit.bBlockingHit; });
+			Ar.Logf(TEXT("%-14s %10.3f %12.1f %8d %10d"), Mode, Milliseconds, NumTraces / FMath::Max(Milliseconds, UE_DOUBLE_SMALL_NUMBER), NumHits, NumMismatches);
+		};
+
+		// One synchronous trace after another on the game thread
+		TArray<FHitResult> Expected;
+		Expected.SetNum(NumTraces);
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				for (int32 TraceIndex = 0; TraceIndex < NumTraces; ++TraceIndex)
+				{
+					World->LineTraceSingleByChannel(Expected[TraceIndex], Queries[TraceIndex].Start, Queries[TraceIndex].End, TraceChannel, Params);
+				}
+			}
+			LogRow(TEXT("Sync"), FPlatformTime::Seconds() - StartTime, Expected, 0);
+		}
+
+		// A datum per trace, traced by tasks of ASYNC_TRACE_BUFFER_SIZE traces like the async trace buffers
+		{
+			TArray<FTraceDatum> TraceData;
+			TraceData.SetNum(NumTraces);
+			TArray<FHitResult> Hits;
+			Hits.SetNum(NumTraces);
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				for (int32 TraceIndex = 0; TraceIndex < NumTraces; ++TraceIndex)
+				{
+					TraceData[TraceIndex] = FTraceDatum(World, FCollisionShape::LineShape, Params, FCollisionResponseParams::DefaultResponseParam, FCollisionObjectQueryParams::DefaultObjectQueryParam,
+						TraceChannel, 0, EAsyncTraceType::Single, Queries[TraceIndex].Start, Queries[TraceIndex].End, FQuat::Identity, nullptr, 0);
+				}
+
+				FGraphEventArray CompletionEvents;
+				for (int32 FirstTrace = 0; FirstTrace < NumTraces; FirstTrace += ASYNC_TRACE_BUFFER_SIZE)
+				{
+					const int32 Count = FMath::Min(ASYNC_TRACE_BUFFER_SIZE, NumTraces - FirstTrace);
+					if (AsyncTraceCVars::IsAsyncTraceOnWorkerThreads())
+					{
+						CompletionEvents.Emplace(TGraphTask<FAsyncTraceTask>::CreateTask(NULL, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(&TraceData[FirstTrace], Count));
+					}
+					else
+					{
+						RunTraceTask(&TraceData[FirstTrace], Count);
+					}
+				}
+				FTaskGraphInterface::Get().WaitUntilTasksComplete(CompletionEvents, ENamedThreads::GameThread);
+			}
+			const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+			for (int32 TraceIndex = 0; TraceIndex < NumTraces; ++TraceIndex)
+			{
+				Hits[TraceIndex] = TraceData[TraceIndex].OutHits.Num() > 0 ? TraceData[TraceIndex].OutHits[0] : FHitResult();
+			}
+			LogRow(TEXT("Async"), Seconds, Hits, CountMismatches(Expected, Hits));
+		}
+
+		// Batches, in the order of the queries and sorted along a Morton curve
+		const int32 PreviousSortQueries = AsyncTraceCVars::AsyncBatchTraceSortQueries;
+		for (const int32 SortQueries : { 0, 1 })
+		{
+			AsyncTraceCVars::AsyncBatchTraceSortQueries = SortQueries;
+
+			TArray<FHitResult> Hits;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				World->BatchTraceByChannel(EAsyncTraceType::Single, Queries, Hits, FQuat::Identity, TraceChannel, FCollisionShape::LineShape, Params);
+			}
+			LogRow(SortQueries ? TEXT("Batch sorted") : TEXT("Batch"), FPlatformTime::Seconds() - StartTime, Hits, CountMismatches(Expected, Hits));
+		}
+		AsyncTraceCVars::AsyncBatchTraceSortQueries = PreviousSortQueries;
+	}
+}
+
+static FAutoConsoleCommand AsyncBatchTraceBenchmarkCmd(
+	TEXT("AsyncBatchTraceBenchmark"),
+	TEXT("Compares the throughput of line traces traced one at a time, through async trace buffers and in batches. Usage: AsyncBatchTraceBenchmark [Traces=20000] [Iterations=10] [Radius=10000] [Length=5000]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&AsyncBatchTraceBenchmark::RunAsyncBatchTraceBenchmark));
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -1112,6 +1112,11 @@ FName FActorComponentTickFunction::DiagnosticContext(bool bDetailed)
 	}
 }
 
+UClass* FActorComponentTickFunction::GetTickBatchClass() const
+{
+	return Target ? Target->GetClass() : nullptr;
+}
+
 
 bool UActorComponent::SetupActorComponentTickFunction(struct FTickFunction* TickFunction)
 {
@@ -15,6 +15,7 @@
 #include "AI/NavigationSystemHelpers.h"
 #include "Engine/SkinnedAsset.h"
 #include "PhysicsEngine/PhysicsSettings.h"
+#include "HAL/MallocCountingProxy.h"
 #include "Misc/Fork.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Physics/Experimental/PhysScene_Chaos.h"
@@ -99,6 +100,23 @@ static FAutoConsoleVariableRef CVarParallelAnimCompletionTaskHighPriority(
 	ECVF_Default
 );
 
+static void OnServerEvaluationChanged(IConsoleVariable* Variable)
+{
+	for (TObjectIterator<USkeletalMeshComponent> It; It; ++It)
+	{
+		It->bRequiredBonesUpToDate = false;
+	}
+}
+
+static int32 GServerEvaluationEnabled = 0;
+static FAutoConsoleVariableRef CVarServerEvaluationEnabled(
+	TEXT("a.ServerEvaluation.Enable"),
+	GServerEvaluationEnabled,
+	TEXT("Set to 1 to only evaluate the root, the ServerEvaluationBones, and the bones of physics bodies, sockets and shadow shapes of skeletal meshes on dedicated servers."),
+	FConsoleVariableDelegate::CreateStatic(&OnServerEvaluationChanged),
+	ECVF_Default
+);
+
 FAutoConsoleTaskPriority CPrio_ParallelAnimationEvaluationTask(
 	TEXT("TaskGraph.TaskPriorities.ParallelAnimationEvaluationTask"),
 	TEXT("Task and thread priority for FParallelAnimationEvaluationTask"),
@@ -1745,10 +1763,18 @@ void USkeletalMeshComponent::ComputeRequiredBones(TArray<FBoneIndexType>& OutReq
 
 	// The list of bones we want is taken from the predicted LOD level.
 	FSkeletalMeshLODRenderData& LODData = SkelMeshRenderData->LODRenderData[LODIndex];
-	OutRequiredBones = LODData.RequiredBones;
+	if (UsesServerEvaluationBones())
+	{
+		// Servers don't render, only keep the bones gameplay needs
+		GetServerEvaluationRequiredBones(this, SkelMesh, OutRequiredBones);
+	}
+	else
+	{
+		OutRequiredBones = LODData.RequiredBones;
 
-	// Add virtual bones
-	GetRequiredVirtualBones(SkelMesh, OutRequiredBones);
+		// Add virtual bones
+		GetRequiredVirtualBones(SkelMesh, OutRequiredBones);
+	}
 
 	const UPhysicsAsset* const PhysicsAsset = GetPhysicsAsset();
 	// If we have a PhysicsAsset, we also need to make sure that all the bones used by it are always updated, as its used
@@ -1847,6 +1873,74 @@ void USkeletalMeshComponent::ComputeRequiredBones(TArray<FBoneIndexType>& OutReq
 }
 
 
+bool USkeletalMeshComponent::UsesServerEvaluationBones() const
+{
+	return GServerEvaluationEnabled != 0 && IsNetMode(NM_DedicatedServer);
+}
+
+/*static*/ void USkeletalMeshComponent::GetServerEvaluationRequiredBones(const USkeletalMeshComponent* SkeletalMeshComponent, const USkeletalMesh* SkeletalMesh, TArray<FBoneIndexType>& OutRequiredBones)
+{
+	check(SkeletalMeshComponent != nullptr);
+	check(SkeletalMesh != nullptr);
+
+	// Root bone, for root motion. Bones are added in place, OutRequiredBones keeps its memory between calls.
+	OutRequiredBones.Reset();
+	OutRequiredBones.Add(0);
+
+	const FReferenceSkeleton& RefSkeleton = SkeletalMesh->GetRefSkeleton();
+	for (const FName& BoneName : SkeletalMeshComponent->ServerEvaluationBones)
+	{
+		const int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+		if (BoneIndex != INDEX_NONE)
+		{
+			OutRequiredBones.AddUnique(static_cast<FBoneIndexType>(BoneIndex));
+		}
+	}
+
+	OutRequiredBones.Sort();
+}
+
+static void DumpServerEvaluationStats(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("Server evaluation: %s"), GServerEvaluationEnabled ? TEXT("enabled") : TEXT("disabled"));
+	if (!FMallocCountingProxy::IsEnabled())
+	{
+		Ar.Logf(TEXT("Run with -malloccounting to count heap allocations."));
+	}
+	Ar.Logf(TEXT("%-48s %8s %8s %10s %12s %12s"), TEXT("Component"), TEXT("Bones"), TEXT("Mesh"), TEXT("Cost (ms)"), TEXT("Stack (KB)"), TEXT("Allocations"));
+
+	int32 NumComponents = 0;
+	double TotalMs = 0.0;
+	uint64 TotalAllocations = 0;
+	for (TObjectIterator<USkeletalMeshComponent> It; It; ++It)
+	{
+		const USkeletalMeshComponent* Component = *It;
+		const USkeletalMesh* SkeletalMesh = Component->GetSkeletalMeshAsset();
+		if (!SkeletalMesh || !Component->IsRegistered() || !Component->UsesServerEvaluationBones())
+		{
+			continue;
+		}
+
+		const double CostMs = Component->LastAnimationEvaluationSeconds * 1000.0;
+		const USkeletalMeshComponent::FServerEvaluationStats& Stats = Component->LastServerEvaluationStats;
+		Ar.Logf(TEXT("%-48s %8d %8d %10.3f %12.1f %12u"), *Component->GetReadableName().Left(48), Component->RequiredBones.Num(), SkeletalMesh->GetRefSkeleton().GetNum(),
+			CostMs, Stats.StackBytes / 1024.0, Stats.NumAllocations);
+		TotalMs += CostMs;
+		TotalAllocations += Stats.NumAllocations;
+		++NumComponents;
+	}
+
+	if (NumComponents > 0)
+	{
+		Ar.Logf(TEXT("%d components, %.3fms total, %.3fms average, %llu allocations"), NumComponents, TotalMs, TotalMs / NumComponents, TotalAllocations);
+	}
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice DumpServerEvaluationStatsCmd(
+	TEXT("a.ServerEvaluation.Stats"),
+	TEXT("Prints the evaluated bones, the cost of the last evaluation, the anim stack used by the pose and the heap allocations of every skeletal mesh evaluated with a.ServerEvaluation.Enable."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&DumpServerEvaluationStats));
+
 void USkeletalMeshComponent::RecalcRequiredBones(int32 LODIndex)
 {
 	if (!GetSkeletalMeshAsset())
@@ -1865,6 +1959,8 @@ void USkeletalMeshComponent::RecalcRequiredBones(int32 LODIndex)
 	// and they might be in use
 	HandleExistingParallelEvaluationTask(true, false);
 
+	bEvaluatingServerEvaluationBones = UsesServerEvaluationBones();
+
 	// If we had cached our shared bone container, reset it
 	if (SharedRequiredBones)
 	{
@@ -2037,15 +2133,27 @@ void USkeletalMeshComponent::PerformAnimationProcessing(const USkeletalMesh* InS
 	// Do nothing more if no bones in skeleton.
 	if(bInDoEvaluation && OutSpaceBases.Num() > 0)
 	{
+		// Memory used by the evaluation, when evaluating a minimal set of bones on servers
+		const int32 StackBytesBefore = bEvaluatingServerEvaluationBones ? FMemStack::Get().GetByteCount() : 0;
+		FScopedMallocCount MallocCount;
+
 		FMemMark Mark(FMemStack::Get());
 		FCompactPose EvaluatedPose;
 
-		UE::Anim::FHeapAttributeContainer Attributes;		
+		// Servers reuse the component's attribute container, other evaluations may run outside of the component's evaluation task
+		UE::Anim::FHeapAttributeContainer LocalAttributes;
+		UE::Anim::FHeapAttributeContainer& Attributes = bEvaluatingServerEvaluationBones ? ServerEvaluationAttributes : LocalAttributes;
+		Attributes.Reset();
 
 		// evaluate pure animations, and fill up BoneSpaceTransforms
 		EvaluateAnimation(InSkeletalMesh, InAnimInstance, OutRootBoneTranslation, OutCurve, EvaluatedPose, Attributes);
 		EvaluatePostProcessMeshInstance(OutBoneSpaceTransforms, EvaluatedPose, OutCurve, InSkeletalMesh, OutRootBoneTranslation, Attributes);
 
+		if (bEvaluatingServerEvaluationBones)
+		{
+			PendingServerEvaluationStats.StackBytes = FMemStack::Get().GetByteCount() - StackBytesBefore;
+		}
+
 		// Finalize the transforms from the evaluation
 		FinalizePoseEvaluationResult(InSkeletalMesh, OutBoneSpaceTransforms, OutRootBoneTranslation, EvaluatedPose);
 
@@ -2056,6 +2164,11 @@ void USkeletalMeshComponent::PerformAnimationProcessing(const USkeletalMesh* InS
 
 		// Fill SpaceBases from LocalAtoms
 		InSkeletalMesh->FillComponentSpaceTransforms(OutBoneSpaceTransforms, FillComponentSpaceTransformsRequiredBones, OutSpaceBases);
+
+		if (bEvaluatingServerEvaluationBones)
+		{
+			PendingServerEvaluationStats.NumAllocations = MallocCount.GetNumAllocations();
+		}
 	}
 }
 
@@ -2499,6 +2612,8 @@ void USkeletalMeshComponent::DoParallelEvaluationTasks_OnGameThread()
 	ParallelAnimationEvaluation();
 
 	SwapEvaluationContextBuffers();
+
+	LastServerEvaluationStats = PendingServerEvaluationStats;
 }
 
 void USkeletalMeshComponent::DispatchParallelTickPose(FActorComponentTickFunction* TickFunction)
@@ -3962,6 +4077,8 @@ void USkeletalMeshComponent::SendRenderDynamicData_Concurrent()
 
 void USkeletalMeshComponent::ParallelAnimationEvaluation() 
 {
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
 	if (AnimEvaluationContext.bDoInterpolation)
 	{
 		PerformAnimationProcessing(AnimEvaluationContext.SkeletalMesh, AnimEvaluationContext.AnimInstance, AnimEvaluationContext.bDoEvaluation, AnimEvaluationContext.CachedComponentSpaceTransforms, AnimEvaluationContext.CachedBoneSpaceTransforms, AnimEvaluationContext.RootBoneTranslation, AnimEvaluationContext.CachedCurve, AnimEvaluationContext.CachedCustomAttributes);
@@ -3971,6 +4088,13 @@ void USkeletalMeshComponent::ParallelAnimationEvaluation()
 		PerformAnimationProcessing(AnimEvaluationContext.SkeletalMesh, AnimEvaluationContext.AnimInstance, AnimEvaluationContext.bDoEvaluation, AnimEvaluationContext.ComponentSpaceTransforms, AnimEvaluationContext.BoneSpaceTransforms, AnimEvaluationContext.RootBoneTranslation, AnimEvaluationContext.Curve, AnimEvaluationContext.CustomAttributes);
 	}
 
+	// Cost of a full evaluation, used to estimate the cost of this component under the animation budget
+	if (AnimEvaluationContext.bDoEvaluation)
+	{
+		LastAnimationEvaluationSeconds = (float)FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+		LastAnimationEvaluationFrame = GFrameCounter;
+	}
+
 	ParallelDuplicateAndInterpolate(AnimEvaluationContext);
 
 	if(AnimEvaluationContext.bDoEvaluation || AnimEvaluationContext.bDoInterpolation)
@@ -4058,6 +4182,9 @@ void USkeletalMeshComponent::CompleteParallelAnimationEvaluation(bool bDoPostAni
 	SCOPED_NAMED_EVENT(USkeletalMeshComponent_CompleteParallelAnimationEvaluation, FColor::Yellow);
 	ParallelAnimationEvaluationTask.SafeRelease(); //We are done with this task now, clean up!
 
+	// The evaluation task is done, its stats can be read on the game thread
+	LastServerEvaluationStats = PendingServerEvaluationStats;
+
 	if (bDoPostAnimEvaluation && (AnimEvaluationContext.AnimInstance == AnimScriptInstance) && (AnimEvaluationContext.SkeletalMesh == GetSkeletalMeshAsset()) && (AnimEvaluationContext.ComponentSpaceTransforms.Num() == GetNumComponentSpaceTransforms()))
 	{
 		SwapEvaluationContextBuffers();
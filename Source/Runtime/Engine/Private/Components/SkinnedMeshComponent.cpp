@@ -39,9 +39,17 @@
 #include "HAL/LowLevelMemTracker.h"
 #include "HAL/LowLevelMemStats.h"
 #include "UObject/Package.h"
+#include "Algo/Sort.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogSkinnedMeshComp, Log, All);
 
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(ENGINE_API, Animation);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Anim Budget Measured (ms)"), STAT_AnimBudgetMeasuredMs, STATGROUP_Anim);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Anim Budget Estimated (ms)"), STAT_AnimBudgetEstimatedMs, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim Budget Throttled"), STAT_AnimBudgetThrottled, STATGROUP_Anim);
+
 int32 GSkeletalMeshLODBias = 0;
 FAutoConsoleVariableRef CVarSkeletalMeshLODBias(
 	TEXT("r.SkeletalMeshLODBias"),
@@ -122,7 +130,30 @@ namespace FAnimUpdateRateManager
 		/** List of all USkinnedMeshComponents that use this set of parameters */
 		TArray<USkinnedMeshComponent*> RegisteredComponents;
 
-		FAnimUpdateRateParametersTracker() : AnimUpdateRateFrameCount(0), AnimUpdateRateShiftTag(0) {}
+		/** Evaluation rate picked by the update rate rules, before the animation budget is applied */
+		int32 DesiredEvaluationRate;
+
+		/** Evaluation rate the animation budget throttles this tracker to, 1 when it isn't throttled */
+		int32 BudgetEvaluationRate;
+
+		/** Smoothed time spent evaluating all registered components, in seconds */
+		float EvaluationCost;
+
+		/** Significance used to sort trackers under the animation budget, higher values are throttled last */
+		float Significance;
+
+		/** True if the budget can't throttle the registered components: human controlled meshes, and visible meshes that need every frame */
+		bool bBudgetExempt;
+
+		FAnimUpdateRateParametersTracker()
+			: AnimUpdateRateFrameCount(0)
+			, AnimUpdateRateShiftTag(0)
+			, DesiredEvaluationRate(1)
+			, BudgetEvaluationRate(1)
+			, EvaluationCost(0.f)
+			, Significance(0.f)
+			, bBudgetExempt(false)
+		{}
 
 		uint8 GetAnimUpdateRateShiftTag(const EUpdateRateShiftBucket& ShiftBucket)
 		{
@@ -213,6 +244,188 @@ namespace FAnimUpdateRateManager
 		0,
 		TEXT("Set to 1 to disable interpolation"));
 
+	static TAutoConsoleVariable<int32> CVarAnimBudgetEnabled(
+		TEXT("a.Budget.Enabled"),
+		0,
+		TEXT("Set to 1 to throttle the evaluation rate of the least significant skinned meshes, so animation evaluation stays within a.Budget.BudgetMs."));
+
+	static TAutoConsoleVariable<float> CVarAnimBudgetMs(
+		TEXT("a.Budget.BudgetMs"),
+		4.f,
+		TEXT("Time per frame, in milliseconds summed across all threads, that animation evaluation should fit in when a.Budget.Enabled is set."));
+
+	static TAutoConsoleVariable<int32> CVarAnimBudgetMaxEvaluationRate(
+		TEXT("a.Budget.MaxEvaluationRate"),
+		6,
+		TEXT("Maximum evaluation rate the animation budget throttles skinned meshes to. Rates of MaxEvalRateForInterpolation and above skip frames instead of interpolating."));
+
+	/** Budget adherence since the last a.Budget.Stats Reset */
+	struct FAnimBudgetStats
+	{
+		int32 NumFrames = 0;
+		int32 NumFramesWithinBudget = 0;
+		double TotalMeasuredMs = 0.0;
+		float MaxMeasuredMs = 0.f;
+		int32 MaxThrottled = 0;
+	};
+	static FAnimBudgetStats AnimBudgetStats;
+
+	/** Frame the animation budget was last allocated on */
+	static uint64 AnimBudgetFrame = 0;
+	static bool bAnimBudgetWasEnabled = false;
+
+	/** Reused array of the trackers sorted by significance */
+	static TArray<FAnimUpdateRateParametersTracker*> AnimBudgetTrackers;
+
+	// Updates the measured cost of the trackers evaluated during the previous frame and throttles the evaluation rate of the
+	// least significant ones, so the estimated cost of this frame fits in the budget. Trackers are sorted by significance and
+	// get the lowest rate that still leaves enough budget to evaluate all less significant trackers at the max rate.
+	void UpdateAnimationBudget()
+	{
+		const bool bEnabled = CVarAnimBudgetEnabled.GetValueOnGameThread() != 0;
+		if (!bEnabled)
+		{
+			if (bAnimBudgetWasEnabled)
+			{
+				for (const TPair<UObject*, FAnimUpdateRateParametersTracker*>& Pair : ActorToUpdateRateParams)
+				{
+					Pair.Value->BudgetEvaluationRate = 1;
+				}
+				bAnimBudgetWasEnabled = false;
+			}
+			return;
+		}
+		bAnimBudgetWasEnabled = true;
+
+		const uint64 PreviousFrame = GFrameCounter - 1;
+		const uint32 PreviousFrame32 = uint32(PreviousFrame % MAX_uint32);
+		const float BudgetSeconds = FMath::Max(CVarAnimBudgetMs.GetValueOnGameThread(), 0.f) / 1000.f;
+		const int32 MaxRate = FMath::Max(CVarAnimBudgetMaxEvaluationRate.GetValueOnGameThread(), 1);
+
+		float MeasuredSeconds = 0.f;
+		float FixedSeconds = 0.f;
+		AnimBudgetTrackers.Reset();
+		for (const TPair<UObject*, FAnimUpdateRateParametersTracker*>& Pair : ActorToUpdateRateParams)
+		{
+			FAnimUpdateRateParametersTracker* Tracker = Pair.Value;
+			if (Tracker->AnimUpdateRateFrameCount != PreviousFrame32)
+			{
+				// Not ticking, the budget is allocated again when it ticks
+				Tracker->BudgetEvaluationRate = 1;
+				continue;
+			}
+
+			float TrackerSeconds = 0.f;
+			bool bEvaluated = false;
+			for (const USkinnedMeshComponent* Component : Tracker->RegisteredComponents)
+			{
+				if (Component->LastAnimationEvaluationFrame == PreviousFrame)
+				{
+					TrackerSeconds += Component->LastAnimationEvaluationSeconds;
+					bEvaluated = true;
+				}
+			}
+
+			if (bEvaluated)
+			{
+				MeasuredSeconds += TrackerSeconds;
+				Tracker->EvaluationCost = Tracker->EvaluationCost > 0.f ? FMath::Lerp(Tracker->EvaluationCost, TrackerSeconds, 0.25f) : TrackerSeconds;
+			}
+
+			if (Tracker->bBudgetExempt)
+			{
+				Tracker->BudgetEvaluationRate = 1;
+				FixedSeconds += Tracker->EvaluationCost;
+			}
+			else
+			{
+				AnimBudgetTrackers.Add(Tracker);
+			}
+		}
+
+		Algo::Sort(AnimBudgetTrackers, [](const FAnimUpdateRateParametersTracker* A, const FAnimUpdateRateParametersTracker* B)
+		{
+			return A->Significance > B->Significance;
+		});
+
+		// Cost of evaluating every tracker at the max rate, or at its own rate if that is lower
+		float MinSeconds = FixedSeconds;
+		for (const FAnimUpdateRateParametersTracker* Tracker : AnimBudgetTrackers)
+		{
+			MinSeconds += Tracker->EvaluationCost / FMath::Max(Tracker->DesiredEvaluationRate, MaxRate);
+		}
+
+		float AvailableSeconds = BudgetSeconds - MinSeconds;
+		float EstimatedSeconds = FixedSeconds;
+		int32 MinThrottledRate = 1;
+		int32 NumThrottled = 0;
+		for (FAnimUpdateRateParametersTracker* Tracker : AnimBudgetTrackers)
+		{
+			const int32 DesiredRate = FMath::Max(Tracker->DesiredEvaluationRate, 1);
+			const float MinTrackerSeconds = Tracker->EvaluationCost / FMath::Max(DesiredRate, MaxRate);
+
+			// Less significant trackers are never evaluated more often than more significant throttled ones
+			int32 Rate = FMath::Max(DesiredRate, MinThrottledRate);
+			while (Rate < MaxRate && Tracker->EvaluationCost / Rate - MinTrackerSeconds > AvailableSeconds)
+			{
+				++Rate;
+			}
+
+			const float TrackerSeconds = Tracker->EvaluationCost / Rate;
+			AvailableSeconds -= TrackerSeconds - MinTrackerSeconds;
+			EstimatedSeconds += TrackerSeconds;
+
+			if (Rate > DesiredRate)
+			{
+				Tracker->BudgetEvaluationRate = Rate;
+				MinThrottledRate = Rate;
+				++NumThrottled;
+			}
+			else
+			{
+				Tracker->BudgetEvaluationRate = 1;
+			}
+		}
+
+		const float MeasuredMs = MeasuredSeconds * 1000.f;
+		const float EstimatedMs = EstimatedSeconds * 1000.f;
+		SET_FLOAT_STAT(STAT_AnimBudgetMeasuredMs, MeasuredMs);
+		SET_FLOAT_STAT(STAT_AnimBudgetEstimatedMs, EstimatedMs);
+		SET_DWORD_STAT(STAT_AnimBudgetThrottled, NumThrottled);
+		CSV_CUSTOM_STAT(Animation, BudgetMeasuredMs, MeasuredMs, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Animation, BudgetEstimatedMs, EstimatedMs, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Animation, BudgetThrottled, NumThrottled, ECsvCustomStatOp::Set);
+
+		AnimBudgetStats.NumFrames++;
+		AnimBudgetStats.NumFramesWithinBudget += MeasuredSeconds <= BudgetSeconds ? 1 : 0;
+		AnimBudgetStats.TotalMeasuredMs += MeasuredMs;
+		AnimBudgetStats.MaxMeasuredMs = FMath::Max(AnimBudgetStats.MaxMeasuredMs, MeasuredMs);
+		AnimBudgetStats.MaxThrottled = FMath::Max(AnimBudgetStats.MaxThrottled, NumThrottled);
+	}
+
+	static void DumpAnimationBudgetStats(const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		const FAnimBudgetStats& Stats = AnimBudgetStats;
+		Ar.Logf(TEXT("Animation budget: %s, %.2fms, max evaluation rate %d"), CVarAnimBudgetEnabled.GetValueOnGameThread() ? TEXT("enabled") : TEXT("disabled"),
+			CVarAnimBudgetMs.GetValueOnGameThread(), CVarAnimBudgetMaxEvaluationRate.GetValueOnGameThread());
+		if (Stats.NumFrames > 0)
+		{
+			Ar.Logf(TEXT("%d frames, %d within budget (%.1f%%), measured %.3fms average, %.3fms max, at most %d throttled meshes"),
+				Stats.NumFrames, Stats.NumFramesWithinBudget, 100.0 * Stats.NumFramesWithinBudget / Stats.NumFrames,
+				Stats.TotalMeasuredMs / Stats.NumFrames, Stats.MaxMeasuredMs, Stats.MaxThrottled);
+		}
+
+		if (Args.Contains(TEXT("Reset")))
+		{
+			AnimBudgetStats = FAnimBudgetStats();
+		}
+	}
+
+	static FAutoConsoleCommandWithArgsAndOutputDevice DumpAnimationBudgetStatsCmd(
+		TEXT("a.Budget.Stats"),
+		TEXT("Prints how often animation evaluation stayed within a.Budget.BudgetMs. Usage: a.Budget.Stats [Reset]"),
+		FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&DumpAnimationBudgetStats));
+
 	void AnimUpdateRateSetParams(FAnimUpdateRateParametersTracker* Tracker, float DeltaTime, bool bRecentlyRendered, float MaxDistanceFactor, int32 MinLod, bool bNeedsValidRootMotion, bool bUsingRootMotionFromEverything)
 	{
 		// default rules for setting update rates
@@ -222,16 +435,21 @@ namespace FAnimUpdateRateManager
 
 		bool bNeedsEveryFrame = bNeedsValidRootMotion && !bUsingRootMotionFromEverything;
 
+		// Player controlled meshes are never throttled by the budget, rendered or not; the non rendered update rate rules below still apply
+		Tracker->bBudgetExempt = bHumanControlled || (bRecentlyRendered && bNeedsEveryFrame);
+
 		// Not rendered, including dedicated servers. we can skip the Evaluation part.
 		if (!bRecentlyRendered)
 		{
 			const int32 NewUpdateRate = ((bHumanControlled || bNeedsEveryFrame) ? 1 : Tracker->UpdateRateParameters.BaseNonRenderedUpdateRate);
-			const int32 NewEvaluationRate = Tracker->UpdateRateParameters.BaseNonRenderedUpdateRate;
+			Tracker->DesiredEvaluationRate = Tracker->UpdateRateParameters.BaseNonRenderedUpdateRate;
+			const int32 NewEvaluationRate = FMath::Max(Tracker->DesiredEvaluationRate, Tracker->BudgetEvaluationRate);
 			Tracker->UpdateRateParameters.SetTrailMode(DeltaTime, Tracker->GetAnimUpdateRateShiftTag(Tracker->UpdateRateParameters.ShiftBucket), NewUpdateRate, NewEvaluationRate, false);
 		}
 		// Visible controlled characters or playing root motion. Need evaluation and ticking done every frame.
 		else  if (bHumanControlled || bNeedsEveryFrame)
 		{
+			Tracker->DesiredEvaluationRate = 1;
 			Tracker->UpdateRateParameters.SetTrailMode(DeltaTime, Tracker->GetAnimUpdateRateShiftTag(Tracker->UpdateRateParameters.ShiftBucket), 1, 1, false);
 		}
 		else
@@ -290,6 +508,10 @@ namespace FAnimUpdateRateManager
 				DesiredEvaluationRate = ForceAnimRate;
 			}
 
+			// Throttled by the animation budget. Rates of MaxEvalRateForInterpolation and above skip frames instead of interpolating.
+			Tracker->DesiredEvaluationRate = DesiredEvaluationRate;
+			DesiredEvaluationRate = FMath::Max(DesiredEvaluationRate, Tracker->BudgetEvaluationRate);
+
 			if (bUsingRootMotionFromEverything && DesiredEvaluationRate > 1)
 			{
 				//Use look ahead mode that allows us to rate limit updates even when using root motion
@@ -323,6 +545,9 @@ namespace FAnimUpdateRateManager
 
 		bNeedsValidRootMotion &= bPlayingNetworkedRootMotionMontage;
 
+		const float BudgetSignificance = Tracker->UpdateRateParameters.BudgetSignificance;
+		Tracker->Significance = BudgetSignificance >= 0.f ? BudgetSignificance : (bRecentlyRendered ? MaxDistanceFactor : 0.f);
+
 		// Figure out which update rate should be used.
 		AnimUpdateRateSetParams(Tracker, DeltaTime, bRecentlyRendered, MaxDistanceFactor, MinLod, bNeedsValidRootMotion, bUsingRootMotionFromEverything);
 	}
@@ -337,6 +562,13 @@ namespace FAnimUpdateRateManager
 		// Convert current frame counter from 64 to 32 bits.
 		const uint32 CurrentFrame32 = uint32(GFrameCounter % MAX_uint32);
 
+		// Allocate the budget once per frame, before any tracker of this frame updates its rates
+		if (AnimBudgetFrame != GFrameCounter)
+		{
+			AnimBudgetFrame = GFrameCounter;
+			UpdateAnimationBudget();
+		}
+
 		UObject* TrackerIndex = GetMapIndexForComponent(SkinnedComponent);
 		FAnimUpdateRateParametersTracker* Tracker = ActorToUpdateRateParams.FindChecked(TrackerIndex);
 
@@ -395,6 +627,8 @@ USkinnedMeshComponent::USkinnedMeshComponent(const FObjectInitializer& ObjectIni
 	, MeshObjectFactory(nullptr)
 	, MeshObjectFactoryUserData(nullptr)
 	, AnimUpdateRateParams(nullptr)
+	, LastAnimationEvaluationSeconds(0.f)
+	, LastAnimationEvaluationFrame(0)
 {
 	bAutoActivate = true;
 	PrimaryComponentTick.bCanEverTick = true;
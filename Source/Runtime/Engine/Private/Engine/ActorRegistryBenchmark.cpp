@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Engine/ActorRegistrySubsystem.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/Parse.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+namespace UE::ActorRegistry::Private
+{
+	static void RunActorRegistryBenchmark(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		UActorRegistrySubsystem* ActorRegistry = World ? World->GetSubsystem<UActorRegistrySubsystem>() : nullptr;
+		if (!ActorRegistry || !World->IsGameWorld())
+		{
+			Ar.Logf(TEXT("ActorRegistry.Benchmark needs a game world."));
+			return;
+		}
+
+		int32 NumActors = 100000;
+		int32 Iterations = 10;
+		int32 BatchSize = 256;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Actors="), NumActors);
+			FParse::Value(*Arg, TEXT("Iterations="), Iterations);
+			FParse::Value(*Arg, TEXT("BatchSize="), BatchSize);
+		}
+		NumActors = FMath::Clamp(NumActors, 1, 1000000);
+		Iterations = FMath::Clamp(Iterations, 1, 1000);
+		BatchSize = FMath::Clamp(BatchSize, 1, NumActors);
+
+		// Actors scattered over a 2km square, spawned in random order so memory order doesn't follow world position
+		FRandomStream Random(1234);
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		TArray<AActor*> SpawnedActors;
+		SpawnedActors.Reserve(NumActors);
+		const double SpawnCost = UE::TimeAverageDuration(1, [&]()
+		{
+			for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+			{
+				const FVector Location(Random.FRandRange(-100000.f, 100000.f), Random.FRandRange(-100000.f, 100000.f), 0.f);
+				SpawnedActors.Add(World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParameters));
+			}
+		});
+
+		// Every run sums the location of every actor, which reads each actor and its root component
+		FVector Sum = FVector::ZeroVector;
+		const double IteratorCost = UE::TimeAverageDuration(Iterations, [&]()
+		{
+			for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
+			{
+				Sum += It->GetActorLocation();
+			}
+		});
+
+		const double RegisterCost = UE::TimeAverageDuration(1, [&]() { ActorRegistry->RegisterActorClass(AStaticMeshActor::StaticClass()); });
+		const int32 NumRegisteredActors = ActorRegistry->GetNumActors(AStaticMeshActor::StaticClass());
+
+		auto TimeRegistry = [&](double& OutCost, double& OutParallelCost)
+		{
+			OutCost = UE::TimeAverageDuration(Iterations, [&]()
+			{
+				ActorRegistry->ForEachActor<AStaticMeshActor>([&Sum](AStaticMeshActor& Actor) { Sum += Actor.GetActorLocation(); });
+			});
+
+			TArray<FVector> BatchSums;
+			BatchSums.SetNumZeroed(FMath::DivideAndRoundUp(NumRegisteredActors, BatchSize));
+			OutParallelCost = UE::TimeAverageDuration(Iterations, [&]()
+			{
+				ActorRegistry->ParallelForEachActorBatch(AStaticMeshActor::StaticClass(), BatchSize, [&BatchSums](int32 BatchIndex, TArrayView<const TObjectPtr<AActor>> Actors)
+				{
+					for (const AActor* Actor : Actors)
+					{
+						BatchSums[BatchIndex] += Actor->GetActorLocation();
+					}
+				});
+			});
+		};
+
+		double RegistryCost, RegistryParallelCost;
+		TimeRegistry(RegistryCost, RegistryParallelCost);
+
+		const double SortCost = UE::TimeAverageDuration(1, [&]() { ActorRegistry->SortBySpatialCell(AStaticMeshActor::StaticClass()); });
+		double SortedCost, SortedParallelCost;
+		TimeRegistry(SortedCost, SortedParallelCost);
+
+		const double DestroyCost = UE::TimeAverageDuration(1, [&]()
+		{
+			for (AActor* Actor : SpawnedActors)
+			{
+				World->DestroyActor(Actor);
+			}
+		});
+
+		Ar.Logf(TEXT("Actor registry benchmark: %d static mesh actors (%d registered), %d iterations, batches of %d. Costs in milliseconds, iteration costs are per iteration."),
+			NumActors, NumRegisteredActors, Iterations, BatchSize);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("Spawn"), SpawnCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("Register class"), RegisterCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("TActorIterator"), IteratorCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("ForEachActor"), RegistryCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("ParallelForEachActorBatch"), RegistryParallelCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("Sort by spatial cell"), SortCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("ForEachActor sorted"), SortedCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("ParallelForEachActorBatch sorted"), SortedParallelCost * 1000.0);
+		Ar.Logf(TEXT("%-32s %10.3f"), TEXT("Destroy"), DestroyCost * 1000.0);
+		Ar.Logf(TEXT("Checksum %f, %d registered actors left"), Sum.X + Sum.Y, ActorRegistry->GetNumActors(AStaticMeshActor::StaticClass()));
+	}
+}
+
+static FAutoConsoleCommand ActorRegistryBenchmarkCmd(
+	TEXT("ActorRegistry.Benchmark"),
+	TEXT("Spawns static mesh actors and compares iterating them with TActorIterator and with the actor registry, sequentially, in parallel and sorted by spatial cell. Usage: ActorRegistry.Benchmark [Actors=100000] [Iterations=10] [BatchSize=256]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&UE::ActorRegistry::Private::RunActorRegistryBenchmark));
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -0,0 +1,396 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Engine/ActorRegistrySubsystem.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ActorRegistrySubsystem)
+
+static float GActorRegistryCellSize = 10000.f;
+static FAutoConsoleVariableRef CVarActorRegistryCellSize(
+	TEXT("ActorRegistry.CellSize"),
+	GActorRegistryCellSize,
+	TEXT("Size of the grid cells, in world units, that the actor registry sorts actors by when a class is sorted by spatial cell."),
+	ECVF_Default
+);
+
+static int32 GActorRegistrySortInterval = 30;
+static FAutoConsoleVariableRef CVarActorRegistrySortInterval(
+	TEXT("ActorRegistry.SortInterval"),
+	GActorRegistrySortInterval,
+	TEXT("Minimum number of frames between two sorts of the actors of a class sorted by spatial cell. Actors are sorted before being iterated, so moving actors end up back in their cell."),
+	ECVF_Default
+);
+
+namespace UE::ActorRegistry::Private
+{
+	/** Spreads the bits of a 32 bit value over the even bits of a 64 bit value */
+	static uint64 SpreadBits(uint32 Value)
+	{
+		uint64 Bits = Value;
+		Bits = (Bits | (Bits << 16)) & 0x0000FFFF0000FFFFull;
+		Bits = (Bits | (Bits << 8)) & 0x00FF00FF00FF00FFull;
+		Bits = (Bits | (Bits << 4)) & 0x0F0F0F0F0F0F0F0Full;
+		Bits = (Bits | (Bits << 2)) & 0x3333333333333333ull;
+		Bits = (Bits | (Bits << 1)) & 0x5555555555555555ull;
+		return Bits;
+	}
+
+	/** Morton code of the horizontal grid cell containing a location, so nearby cells get nearby keys */
+	static uint64 GetCellKey(const FVector& Location, double InvCellSize)
+	{
+		// Flipping the sign bit orders negative cells before positive ones
+		const uint32 CellX = (uint32)FMath::FloorToInt32(Location.X * InvCellSize) ^ 0x80000000u;
+		const uint32 CellY = (uint32)FMath::FloorToInt32(Location.Y * InvCellSize) ^ 0x80000000u;
+		return SpreadBits(CellX) | (SpreadBits(CellY) << 1);
+	}
+}
+
+void UActorRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* World = GetWorld();
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UActorRegistrySubsystem::OnActorSpawned));
+	ActorDestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UActorRegistrySubsystem::OnActorDestroyed));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UActorRegistrySubsystem::OnLevelAddedToWorld);
+	PreLevelRemovedHandle = FWorldDelegates::PreLevelRemovedFromWorld.AddUObject(this, &UActorRegistrySubsystem::OnPreLevelRemovedFromWorld);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UActorRegistrySubsystem::OnPostGarbageCollect);
+}
+
+void UActorRegistrySubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		World->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::PreLevelRemovedFromWorld.Remove(PreLevelRemovedHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	ClassActorsMap.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UActorRegistrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UActorRegistrySubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UActorRegistrySubsystem* This = CastChecked<UActorRegistrySubsystem>(InThis);
+	for (TPair<const UClass*, TUniquePtr<FClassActors>>& Pair : This->ClassActorsMap)
+	{
+		// Weak references, the garbage collector clears the actors it collects, see OnPostGarbageCollect.
+		// Collectors that don't support weak references don't see the actors at all.
+		for (TObjectPtr<AActor>& Actor : Pair.Value->Actors)
+		{
+			if (Actor)
+			{
+				Collector.MarkWeakObjectReferenceForClearing(reinterpret_cast<UObject**>(&UE::Core::Private::Unsafe::Decay(Actor)));
+			}
+		}
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UActorRegistrySubsystem::RegisterActorClass(TSubclassOf<AActor> Class, bool bSortBySpatialCell)
+{
+	FClassActors& ClassActors = FindOrRegisterClass(Class);
+	if (bSortBySpatialCell && !ClassActors.bSortBySpatialCell)
+	{
+		ClassActors.bSortBySpatialCell = true;
+		if (ClassActors.IterationDepth == 0)
+		{
+			SortBySpatialCell(ClassActors);
+		}
+	}
+}
+
+void UActorRegistrySubsystem::UnregisterActorClass(TSubclassOf<AActor> Class)
+{
+	check(IsInGameThread());
+
+	if (const TUniquePtr<FClassActors>* ClassActors = ClassActorsMap.Find(Class))
+	{
+		checkf((*ClassActors)->IterationDepth == 0, TEXT("Unregistering %s while iterating its actors"), *Class->GetName());
+		ClassActorsMap.Remove(Class);
+	}
+}
+
+bool UActorRegistrySubsystem::IsActorClassRegistered(TSubclassOf<AActor> Class) const
+{
+	return ClassActorsMap.Contains(Class);
+}
+
+int32 UActorRegistrySubsystem::GetNumActors(TSubclassOf<AActor> Class) const
+{
+	const TUniquePtr<FClassActors>* ClassActors = ClassActorsMap.Find(Class);
+	return ClassActors ? (*ClassActors)->ActorIndices.Num() : 0;
+}
+
+void UActorRegistrySubsystem::ForEachActor(TSubclassOf<AActor> Class, TFunctionRef<void(AActor&)> Func)
+{
+	FClassActors& ClassActors = FindOrRegisterClass(Class);
+	PrepareForIteration(ClassActors);
+
+	// Actors spawned from Func are appended past NumActors, actors destroyed from Func leave a null slot
+	++ClassActors.IterationDepth;
+	const int32 NumActors = ClassActors.Actors.Num();
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		if (AActor* Actor = ClassActors.Actors[ActorIndex])
+		{
+			Func(*Actor);
+		}
+	}
+	--ClassActors.IterationDepth;
+
+	if (ClassActors.IterationDepth == 0 && ClassActors.bHasNullActors)
+	{
+		Compact(ClassActors);
+	}
+}
+
+void UActorRegistrySubsystem::ParallelForEachActorBatch(TSubclassOf<AActor> Class, int32 BatchSize, TFunctionRef<void(int32 BatchIndex, TArrayView<const TObjectPtr<AActor>> Actors)> Func)
+{
+	FClassActors& ClassActors = FindOrRegisterClass(Class);
+	checkf(ClassActors.IterationDepth == 0, TEXT("Iterating %s in parallel while iterating its actors"), *Class->GetName());
+	PrepareForIteration(ClassActors);
+
+	BatchSize = FMath::Max(BatchSize, 1);
+	const int32 NumActors = ClassActors.Actors.Num();
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumActors, BatchSize);
+	const TObjectPtr<AActor>* Actors = ClassActors.Actors.GetData();
+
+	++ClassActors.IterationDepth;
+	ParallelFor(TEXT("ActorRegistry.ParallelForEachActorBatch"), NumBatches, 1, [&Func, Actors, NumActors, BatchSize](int32 BatchIndex)
+	{
+		const int32 StartIndex = BatchIndex * BatchSize;
+		Func(BatchIndex, TArrayView<const TObjectPtr<AActor>>(Actors + StartIndex, FMath::Min(BatchSize, NumActors - StartIndex)));
+	});
+	--ClassActors.IterationDepth;
+}
+
+void UActorRegistrySubsystem::SortBySpatialCell(TSubclassOf<AActor> Class)
+{
+	check(IsInGameThread());
+
+	if (const TUniquePtr<FClassActors>* ClassActors = ClassActorsMap.Find(Class))
+	{
+		checkf((*ClassActors)->IterationDepth == 0, TEXT("Sorting %s while iterating its actors"), *Class->GetName());
+		SortBySpatialCell(**ClassActors);
+	}
+}
+
+UActorRegistrySubsystem::FClassActors& UActorRegistrySubsystem::FindOrRegisterClass(UClass* Class)
+{
+	check(IsInGameThread());
+	check(Class != nullptr);
+
+	if (TUniquePtr<FClassActors>* ExistingClassActors = ClassActorsMap.Find(Class))
+	{
+		return **ExistingClassActors;
+	}
+
+	FClassActors& ClassActors = *ClassActorsMap.Add(Class, MakeUnique<FClassActors>());
+	for (TActorIterator<AActor> It(GetWorld(), Class); It; ++It)
+	{
+		ClassActors.ActorIndices.Add(*It, ClassActors.Actors.Add(*It));
+	}
+	return ClassActors;
+}
+
+void UActorRegistrySubsystem::PrepareForIteration(FClassActors& ClassActors)
+{
+	if (ClassActors.IterationDepth > 0)
+	{
+		return;
+	}
+
+	if (ClassActors.bHasNullActors)
+	{
+		Compact(ClassActors);
+	}
+
+	if (ClassActors.bSortBySpatialCell && GFrameCounter >= ClassActors.LastSortFrame + (uint64)FMath::Max(GActorRegistrySortInterval, 1))
+	{
+		SortBySpatialCell(ClassActors);
+	}
+}
+
+void UActorRegistrySubsystem::SortBySpatialCell(FClassActors& ClassActors)
+{
+	using namespace UE::ActorRegistry::Private;
+
+	check(ClassActors.IterationDepth == 0 && !ClassActors.bHasNullActors);
+
+	const double InvCellSize = 1.0 / FMath::Max((double)GActorRegistryCellSize, 1.0);
+	TArray<TPair<uint64, AActor*>> SortedActors;
+	SortedActors.Reserve(ClassActors.Actors.Num());
+	for (AActor* Actor : ClassActors.Actors)
+	{
+		SortedActors.Emplace(GetCellKey(Actor->GetActorLocation(), InvCellSize), Actor);
+	}
+	Algo::Sort(SortedActors, [](const TPair<uint64, AActor*>& A, const TPair<uint64, AActor*>& B) { return A.Key < B.Key; });
+
+	for (int32 ActorIndex = 0; ActorIndex < SortedActors.Num(); ++ActorIndex)
+	{
+		AActor* Actor = SortedActors[ActorIndex].Value;
+		ClassActors.Actors[ActorIndex] = Actor;
+		ClassActors.ActorIndices[Actor] = ActorIndex;
+	}
+	ClassActors.LastSortFrame = GFrameCounter;
+}
+
+void UActorRegistrySubsystem::Compact(FClassActors& ClassActors)
+{
+	// Keeps the order of the remaining actors, so sorted classes stay sorted
+	ClassActors.Actors.RemoveAll([](const TObjectPtr<AActor>& Actor) { return Actor == nullptr; });
+	for (int32 ActorIndex = 0; ActorIndex < ClassActors.Actors.Num(); ++ActorIndex)
+	{
+		ClassActors.ActorIndices[ClassActors.Actors[ActorIndex]] = ActorIndex;
+	}
+	ClassActors.bHasNullActors = false;
+}
+
+void UActorRegistrySubsystem::AddActor(AActor* Actor)
+{
+	for (const UClass* Class = Actor->GetClass(); Class; Class = Class->GetSuperClass())
+	{
+		if (TUniquePtr<FClassActors>* ClassActors = ClassActorsMap.Find(Class))
+		{
+			FClassActors& ClassActorsRef = **ClassActors;
+			if (!ClassActorsRef.ActorIndices.Contains(Actor))
+			{
+				ClassActorsRef.ActorIndices.Add(Actor, ClassActorsRef.Actors.Add(Actor));
+			}
+		}
+	}
+}
+
+void UActorRegistrySubsystem::RemoveActor(AActor* Actor)
+{
+	for (const UClass* Class = Actor->GetClass(); Class; Class = Class->GetSuperClass())
+	{
+		if (TUniquePtr<FClassActors>* ClassActors = ClassActorsMap.Find(Class))
+		{
+			FClassActors& ClassActorsRef = **ClassActors;
+			int32 ActorIndex = INDEX_NONE;
+			if (!ClassActorsRef.ActorIndices.RemoveAndCopyValue(Actor, ActorIndex))
+			{
+				continue;
+			}
+
+			if (ClassActorsRef.IterationDepth > 0)
+			{
+				// Don't move actors under the iteration, compacted once it ends
+				ClassActorsRef.Actors[ActorIndex] = nullptr;
+				ClassActorsRef.bHasNullActors = true;
+			}
+			else
+			{
+				ClassActorsRef.Actors.RemoveAtSwap(ActorIndex, 1, false);
+				if (ActorIndex < ClassActorsRef.Actors.Num())
+				{
+					ClassActorsRef.ActorIndices[ClassActorsRef.Actors[ActorIndex]] = ActorIndex;
+				}
+			}
+		}
+	}
+}
+
+void UActorRegistrySubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (!ClassActorsMap.IsEmpty())
+	{
+		AddActor(Actor);
+	}
+}
+
+void UActorRegistrySubsystem::OnActorDestroyed(AActor* Actor)
+{
+	if (!ClassActorsMap.IsEmpty())
+	{
+		RemoveActor(Actor);
+	}
+}
+
+void UActorRegistrySubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (!Level || World != GetWorld() || ClassActorsMap.IsEmpty())
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (IsValid(Actor))
+		{
+			AddActor(Actor);
+		}
+	}
+}
+
+void UActorRegistrySubsystem::OnPostGarbageCollect()
+{
+	// Actors that left the world without notifying the registry were cleared by the garbage collector. Their keys are
+	// stale and are dropped, as their addresses can be reused by new actors.
+	for (TPair<const UClass*, TUniquePtr<FClassActors>>& Pair : ClassActorsMap)
+	{
+		FClassActors& ClassActors = *Pair.Value;
+		int32 NumActors = 0;
+		for (const TObjectPtr<AActor>& Actor : ClassActors.Actors)
+		{
+			NumActors += Actor != nullptr ? 1 : 0;
+		}
+		if (NumActors == ClassActors.ActorIndices.Num())
+		{
+			continue;
+		}
+
+		// Don't move actors under an iteration, compacted once it ends
+		if (ClassActors.IterationDepth > 0)
+		{
+			ClassActors.bHasNullActors = true;
+		}
+		else
+		{
+			ClassActors.Actors.RemoveAll([](const TObjectPtr<AActor>& Actor) { return Actor == nullptr; });
+			ClassActors.bHasNullActors = false;
+		}
+
+		ClassActors.ActorIndices.Reset();
+		for (int32 ActorIndex = 0; ActorIndex < ClassActors.Actors.Num(); ++ActorIndex)
+		{
+			if (AActor* Actor = ClassActors.Actors[ActorIndex])
+			{
+				ClassActors.ActorIndices.Add(Actor, ActorIndex);
+			}
+		}
+	}
+}
+
+void UActorRegistrySubsystem::OnPreLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (!Level || World != GetWorld() || ClassActorsMap.IsEmpty())
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor)
+		{
+			RemoveActor(Actor);
+		}
+	}
+}
@@ -23,6 +23,9 @@
 #include "UObject/ReleaseObjectVersion.h"
 #include "ComponentRecreateRenderStateContext.h"
 #include "Algo/AnyOf.h"
+#include "Misc/Parse.h"
+#include "Math/RandomStream.h"
+#include "Engine/World.h"
 #include "UObject/UnrealType.h"
 #if WITH_EDITOR
 #include "Rendering/StaticLightingSystemInterface.h"
@@ -136,6 +139,26 @@ static TAutoConsoleVariable<int32> CVarFoliageUseInstanceRuns(
 	0,
 	TEXT("Whether to use the InstanceRuns feature of FMeshBatch to compress foliage draw call data sent to the renderer.  Not supported by the Mesh Draw Command pipeline."));
 
+static TAutoConsoleVariable<int32> CVarIncrementalTreeUpdates(
+	TEXT("foliage.IncrementalTreeUpdates"),
+	1,
+	TEXT("If set, instances added to and removed from a built tree in game worlds reuse free slots of its leaves instead of rebuilding the whole tree."));
+
+static TAutoConsoleVariable<float> CVarIncrementalTreeMaxLeafGrowth(
+	TEXT("foliage.IncrementalTreeMaxLeafGrowth"),
+	0.5f,
+	TEXT("Maximum relative growth of the volume of a leaf when an instance is inserted into it incrementally. Instances that don't fit any leaf are rendered as unbuilt instances until the next build."));
+
+static TAutoConsoleVariable<float> CVarIncrementalTreeRebalanceRatio(
+	TEXT("foliage.IncrementalTreeRebalanceRatio"),
+	0.25f,
+	TEXT("The tree is rebuilt once the number of instances added and removed incrementally reaches this fraction of the built instances."));
+
+static TAutoConsoleVariable<int32> CVarIncrementalTreeMaxUnbuiltInstances(
+	TEXT("foliage.IncrementalTreeMaxUnbuiltInstances"),
+	4096,
+	TEXT("The tree is rebuilt once this many unbuilt instances are rendered, for instances added incrementally that didn't fit any leaf."));
+
 #if RHI_RAYTRACING
 static TAutoConsoleVariable<int32> CVarRayTracingHISM(
 	TEXT("r.RayTracing.Geometry.HierarchicalInstancedStaticMesh"),
@@ -2088,6 +2111,7 @@ UHierarchicalInstancedStaticMeshComponent::UHierarchicalInstancedStaticMeshCompo
 	, bIsOutOfDate(false)
 	, bConcurrentChanges(false)
 	, bAutoRebuildTreeOnInstanceChanges(true)
+	, NumIncrementalTreeChanges(0)
 #if WITH_EDITOR
 	, bCanEnableDensityScaling(true)
 #endif
@@ -2159,10 +2183,10 @@ void UHierarchicalInstancedStaticMeshComponent::Serialize(FArchive& Ar)
 
 	Ar.UsingCustomVersion(FReleaseObjectVersion::GUID);
 
-	// Make sure to build tree before Save/Duplicate
+	// Make sure to build tree before Save/Duplicate, without the free slots of incremental updates
 	if (Ar.IsSaving() && Ar.IsPersistent())
 	{
-		BuildTreeIfOutdated(/*Async*/false, /*ForceUpdate*/false);
+		BuildTreeIfOutdated(/*Async*/false, /*ForceUpdate*/NumIncrementalTreeChanges > 0);
 	}
 
 	Super::Serialize(Ar);
@@ -2170,6 +2194,7 @@ void UHierarchicalInstancedStaticMeshComponent::Serialize(FArchive& Ar)
 	if (Ar.IsLoading())
 	{
 		ClusterTreePtr = MakeShareable(new TArray<FClusterNode>);
+		ResetIncrementalTreeState();
 	}
 
 	if (Ar.IsLoading() && Ar.CustomVer(FReleaseObjectVersion::GUID) < FReleaseObjectVersion::HISMCClusterTreeMigration)
@@ -2226,9 +2251,180 @@ void UHierarchicalInstancedStaticMeshComponent::PostLoad()
 	Super::PostLoad();
 }
 
+static float GetClusterVolume(const FVector3f& BoundMin, const FVector3f& BoundMax)
+{
+	const FVector3f Size = BoundMax - BoundMin;
+	return Size.X * Size.Y * Size.Z;
+}
+
+bool UHierarchicalInstancedStaticMeshComponent::CanUpdateTreeIncrementally() const
+{
+	// Editor worlds rebuild the tree for hit proxies, selection and static lighting
+	const UWorld* World = GetWorld();
+	return CVarIncrementalTreeUpdates.GetValueOnAnyThread() != 0
+		&& World && World->IsGameWorld()
+		&& !bIsOutOfDate
+		&& !IsAsyncBuilding()
+		&& NumBuiltRenderInstances > 0
+		// Density scaling offsets the render index of unbuilt instances
+		&& NumBuiltInstances == NumBuiltRenderInstances
+		&& SortedInstances.Num() == NumBuiltRenderInstances
+		&& ClusterTreePtr.IsValid() && ClusterTreePtr->Num() > 0
+		&& PerInstanceRenderData.IsValid() && PerInstanceRenderData->InstanceBuffer.RequireCPUAccess
+		&& !NeedsTreeRebalance();
+}
+
+bool UHierarchicalInstancedStaticMeshComponent::NeedsTreeRebalance() const
+{
+	if (NumIncrementalTreeChanges == 0)
+	{
+		return false;
+	}
+
+	const int32 MaxChanges = FMath::Max(1, FMath::CeilToInt(NumBuiltRenderInstances * CVarIncrementalTreeRebalanceRatio.GetValueOnAnyThread()));
+	return NumIncrementalTreeChanges >= MaxChanges || UnbuiltInstanceBoundsList.Num() >= CVarIncrementalTreeMaxUnbuiltInstances.GetValueOnAnyThread();
+}
+
+void UHierarchicalInstancedStaticMeshComponent::ResetIncrementalTreeState()
+{
+	ClusterFreeSlots.Reset();
+	NumIncrementalTreeChanges = 0;
+}
+
+void UHierarchicalInstancedStaticMeshComponent::ReleaseTreeSlot(int32 RenderIndex)
+{
+	// Unbuilt instances stay hidden at the end of the instance buffer until the next build
+	if (!SortedInstances.IsValidIndex(RenderIndex))
+	{
+		return;
+	}
+
+	SortedInstances[RenderIndex] = INDEX_NONE;
+
+	// Slots are only freed here, so all nodes of a tree without free slots have none
+	const TArray<FClusterNode>& ClusterTree = *ClusterTreePtr;
+	if (ClusterFreeSlots.Num() != ClusterTree.Num())
+	{
+		ClusterFreeSlots.Init(0, ClusterTree.Num());
+	}
+
+	// Children cover consecutive ranges of their parent's instances
+	int32 NodeIndex = 0;
+	++ClusterFreeSlots[NodeIndex];
+	while (ClusterTree[NodeIndex].FirstChild >= 0)
+	{
+		const FClusterNode& Node = ClusterTree[NodeIndex];
+		NodeIndex = Node.FirstChild;
+		while (NodeIndex < Node.LastChild && ClusterTree[NodeIndex].LastInstance < RenderIndex)
+		{
+			++NodeIndex;
+		}
+		++ClusterFreeSlots[NodeIndex];
+	}
+}
+
+bool UHierarchicalInstancedStaticMeshComponent::InsertInstanceIntoTree(int32 InstanceIndex, const FBox& InstanceBounds)
+{
+	check(InstanceIndex == InstanceReorderTable.Num());
+
+	if (ClusterFreeSlots.Num() == 0 || ClusterFreeSlots[0] == 0)
+	{
+		return false;
+	}
+
+	// The tree is built in translated space
+	const FBox TreeInstanceBounds = InstanceBounds.ShiftBy(-TranslatedInstanceSpaceOrigin);
+	const FVector3f InstanceMin(TreeInstanceBounds.Min);
+	const FVector3f InstanceMax(TreeInstanceBounds.Max);
+
+	// Descend towards the children with free slots that grow the least
+	TArray<int32, TInlineAllocator<16>> Path;
+	{
+		const TArray<FClusterNode>& ClusterTree = *ClusterTreePtr;
+		int32 NodeIndex = 0;
+		Path.Add(NodeIndex);
+		while (ClusterTree[NodeIndex].FirstChild >= 0)
+		{
+			const FClusterNode& Node = ClusterTree[NodeIndex];
+			int32 BestChild = INDEX_NONE;
+			float BestGrowth = MAX_flt;
+			float BestVolume = MAX_flt;
+			for (int32 ChildIndex = Node.FirstChild; ChildIndex <= Node.LastChild; ChildIndex++)
+			{
+				if (ClusterFreeSlots[ChildIndex] > 0)
+				{
+					const FClusterNode& Child = ClusterTree[ChildIndex];
+					const float Volume = GetClusterVolume(Child.BoundMin, Child.BoundMax);
+					const float Growth = GetClusterVolume(Child.BoundMin.ComponentMin(InstanceMin), Child.BoundMax.ComponentMax(InstanceMax)) - Volume;
+					if (Growth < BestGrowth || (Growth == BestGrowth && Volume < BestVolume))
+					{
+						BestChild = ChildIndex;
+						BestGrowth = Growth;
+						BestVolume = Volume;
+					}
+				}
+			}
+			check(BestChild != INDEX_NONE);
+			NodeIndex = BestChild;
+			Path.Add(NodeIndex);
+		}
+
+		// Instances far from any free slot would make the leaf much larger and hurt culling, they are rendered as unbuilt instances instead
+		const FClusterNode& Leaf = ClusterTree[NodeIndex];
+		const float LeafVolume = GetClusterVolume(Leaf.BoundMin, Leaf.BoundMax);
+		const float NewLeafVolume = GetClusterVolume(Leaf.BoundMin.ComponentMin(InstanceMin), Leaf.BoundMax.ComponentMax(InstanceMax));
+		if (NewLeafVolume > LeafVolume * (1.0f + FMath::Max(CVarIncrementalTreeMaxLeafGrowth.GetValueOnAnyThread(), 0.0f)))
+		{
+			return false;
+		}
+	}
+
+	// The scene proxy shares the tree, copy it on the first change since the proxy was created
+	if (!ClusterTreePtr.IsUnique())
+	{
+		ClusterTreePtr = MakeShareable(new TArray<FClusterNode>(*ClusterTreePtr));
+	}
+	TArray<FClusterNode>& ClusterTree = *ClusterTreePtr;
+
+	const FClusterNode& Leaf = ClusterTree[Path.Last()];
+	int32 RenderIndex = Leaf.FirstInstance;
+	while (SortedInstances[RenderIndex] != INDEX_NONE)
+	{
+		RenderIndex++;
+	}
+	check(RenderIndex <= Leaf.LastInstance);
+
+	const FMatrix& InstanceTransform = PerInstanceSMData[InstanceIndex].Transform;
+	const FVector3f InstanceScale(InstanceTransform.GetScaleVector());
+	for (const int32 NodeIndex : Path)
+	{
+		FClusterNode& Node = ClusterTree[NodeIndex];
+		Node.BoundMin = Node.BoundMin.ComponentMin(InstanceMin);
+		Node.BoundMax = Node.BoundMax.ComponentMax(InstanceMax);
+		Node.MinInstanceScale = Node.MinInstanceScale.ComponentMin(InstanceScale);
+		Node.MaxInstanceScale = Node.MaxInstanceScale.ComponentMax(InstanceScale);
+		--ClusterFreeSlots[NodeIndex];
+	}
+
+	SortedInstances[RenderIndex] = InstanceIndex;
+	InstanceReorderTable.Add(RenderIndex);
+	BuiltInstanceBounds += InstanceBounds;
+
+	// The slot was hidden when its instance was removed, commands are applied in order
+	InstanceUpdateCmdBuffer.UpdateInstance(RenderIndex, InstanceTransform.ConcatTranslation(-TranslatedInstanceSpaceOrigin));
+	if (NumCustomDataFloats > 0)
+	{
+		InstanceUpdateCmdBuffer.SetCustomData(RenderIndex, MakeArrayView(&PerInstanceSMCustomData[InstanceIndex * NumCustomDataFloats], NumCustomDataFloats));
+	}
+
+	return true;
+}
+
 void UHierarchicalInstancedStaticMeshComponent::RemoveInstancesInternal(const int32* InstanceIndices, int32 Num)
 {
-	if ( Num > 0)
+	// Built instances are hidden and their slot is reused by the next instances added, see foliage.IncrementalTreeUpdates
+	const bool bIncremental = Num > 0 && CanUpdateTreeIncrementally();
+	if (Num > 0 && !bIncremental)
 	{
 		bIsOutOfDate = true;
 		bConcurrentChanges |= IsAsyncBuilding();
@@ -2248,9 +2444,24 @@ void UHierarchicalInstancedStaticMeshComponent::RemoveInstancesInternal(const in
 			if (RenderIndex != INDEX_NONE)
 			{
 				InstanceUpdateCmdBuffer.HideInstance(RenderIndex);
+
+				if (bIncremental)
+				{
+					ReleaseTreeSlot(RenderIndex);
+				}
 			}
 			
 			InstanceReorderTable.RemoveAtSwap(InstanceIndex, 1, false);
+
+			// The last instance was moved to InstanceIndex
+			if (bIncremental && InstanceReorderTable.IsValidIndex(InstanceIndex))
+			{
+				const int32 MovedRenderIndex = InstanceReorderTable[InstanceIndex];
+				if (SortedInstances.IsValidIndex(MovedRenderIndex))
+				{
+					SortedInstances[MovedRenderIndex] = InstanceIndex;
+				}
+			}
 		}
 			
 		PerInstanceSMData.RemoveAtSwap(InstanceIndex, 1, false);
@@ -2316,6 +2527,11 @@ void UHierarchicalInstancedStaticMeshComponent::RemoveInstancesInternal(const in
 		}
 	}
 
+	if (bIncremental)
+	{
+		NumIncrementalTreeChanges += Num;
+	}
+
 	PerInstanceSMData.Shrink();
 	// InstanceReorderTable is not shrink as the build tree will override it so we save the cost of the realloc
 }
@@ -2594,24 +2810,37 @@ int32 UHierarchicalInstancedStaticMeshComponent::AddInstance(const FTransform& I
 	{	
 		check(InstanceIndex == InstanceReorderTable.Num());
 
-		bIsOutOfDate = true;
-		bConcurrentChanges |= IsAsyncBuilding();
-	
-		int32 InitialBufferOffset = InstanceCountToRender - InstanceReorderTable.Num(); // Until the build is done, we need to always add at the end of the buffer/reorder table
-		InstanceReorderTable.Add(InitialBufferOffset + InstanceIndex); // add to the end until the build is completed
-
-		// CPU access is required for in-place render data modifications
-		if (PerInstanceRenderData.IsValid() && PerInstanceRenderData->InstanceBuffer.RequireCPUAccess)
+		// Instances close to a free slot of a leaf are inserted into the built tree, see foliage.IncrementalTreeUpdates
+		const bool bIncremental = CanUpdateTreeIncrementally();
+		if (!bIncremental)
 		{
-			++InstanceCountToRender;
+			bIsOutOfDate = true;
+			bConcurrentChanges |= IsAsyncBuilding();
 		}
 
-		// CmdBuffer takes final render transforms so should include the translated space.
-		InstanceUpdateCmdBuffer.AddInstance(PerInstanceSMData[InstanceIndex].Transform.ConcatTranslation(-TranslatedInstanceSpaceOrigin));
-
 		const FBox NewInstanceBounds = GetStaticMesh()->GetBounds().GetBox().TransformBy(PerInstanceSMData[InstanceIndex].Transform);
-		UnbuiltInstanceBounds += NewInstanceBounds;
-		UnbuiltInstanceBoundsList.Add(NewInstanceBounds);
+		if (!bIncremental || !InsertInstanceIntoTree(InstanceIndex, NewInstanceBounds))
+		{
+			int32 InitialBufferOffset = InstanceCountToRender - InstanceReorderTable.Num(); // Until the build is done, we need to always add at the end of the buffer/reorder table
+			InstanceReorderTable.Add(InitialBufferOffset + InstanceIndex); // add to the end until the build is completed
+
+			// CPU access is required for in-place render data modifications
+			if (PerInstanceRenderData.IsValid() && PerInstanceRenderData->InstanceBuffer.RequireCPUAccess)
+			{
+				++InstanceCountToRender;
+			}
+
+			// CmdBuffer takes final render transforms so should include the translated space.
+			InstanceUpdateCmdBuffer.AddInstance(PerInstanceSMData[InstanceIndex].Transform.ConcatTranslation(-TranslatedInstanceSpaceOrigin));
+
+			UnbuiltInstanceBounds += NewInstanceBounds;
+			UnbuiltInstanceBoundsList.Add(NewInstanceBounds);
+		}
+
+		if (bIncremental)
+		{
+			++NumIncrementalTreeChanges;
+		}
 
 		if (bAutoRebuildTreeOnInstanceChanges)
 		{
@@ -2631,10 +2860,39 @@ TArray<int32> UHierarchicalInstancedStaticMeshComponent::AddInstances(const TArr
 	// The tree will be fully rebuilt once the static mesh compilation is finished, no need for incremental update in that case.
 	if (InstanceIndices.Num() > 0 && GetStaticMesh() && !GetStaticMesh()->IsCompiling() && GetStaticMesh()->HasValidRenderData(false))
 	{
+		const int32 Count = InstanceIndices.Num();
+
+		// Instances close to a free slot of a leaf are inserted into the built tree, see foliage.IncrementalTreeUpdates
+		if (CanUpdateTreeIncrementally())
+		{
+			InstanceReorderTable.Reserve(InstanceReorderTable.Num() + Count);
+
+			for (const int32 InstanceIndex : InstanceIndices)
+			{
+				const FBox NewInstanceBounds = GetStaticMesh()->GetBounds().GetBox().TransformBy(PerInstanceSMData[InstanceIndex].Transform);
+				if (!InsertInstanceIntoTree(InstanceIndex, NewInstanceBounds))
+				{
+					// Render slots of unbuilt instances follow each other even when some instances were inserted into the tree
+					InstanceReorderTable.Add(InstanceCountToRender++);
+					InstanceUpdateCmdBuffer.AddInstance(PerInstanceSMData[InstanceIndex].Transform.ConcatTranslation(-TranslatedInstanceSpaceOrigin));
+
+					UnbuiltInstanceBounds += NewInstanceBounds;
+					UnbuiltInstanceBoundsList.Add(NewInstanceBounds);
+				}
+			}
+
+			NumIncrementalTreeChanges += Count;
+
+			if (bAutoRebuildTreeOnInstanceChanges)
+			{
+				BuildTreeIfOutdated(/*Async*/true, /*ForceUpdate*/false);
+			}
+
+			return bShouldReturnIndices ? InstanceIndices : TArray<int32>();
+		}
+
 		bIsOutOfDate = true;
 		bConcurrentChanges |= IsAsyncBuilding();
-
-		const int32 Count = InstanceIndices.Num();
 		
 		InstanceReorderTable.Reserve(InstanceReorderTable.Num() + Count);
 		UnbuiltInstanceBoundsList.Reserve(UnbuiltInstanceBoundsList.Num() + Count);
@@ -2673,6 +2931,7 @@ void UHierarchicalInstancedStaticMeshComponent::ClearInstances()
 	SortedInstances.Empty();
 	UnbuiltInstanceBounds.Init();
 	UnbuiltInstanceBoundsList.Empty();
+	ResetIncrementalTreeState();
 
 	if (ProxySize)
 	{
@@ -2891,6 +3150,7 @@ void UHierarchicalInstancedStaticMeshComponent::AcceptPrebuiltTree(TArray<FInsta
 	UnbuiltInstanceBounds.Init();
 	UnbuiltInstanceBoundsList.Empty();
 	ClusterTreePtr = MakeShareable(new TArray<FClusterNode>);
+	ResetIncrementalTreeState();
 	InstanceReorderTable.Empty();
 	SortedInstances.Empty();
 	OcclusionLayerNumNodes = InOcclusionLayerNumNodes;
@@ -2957,6 +3217,7 @@ void UHierarchicalInstancedStaticMeshComponent::ApplyEmpty()
 {
 	bIsOutOfDate = false;
 	ClusterTreePtr = MakeShareable(new TArray<FClusterNode>);
+	ResetIncrementalTreeState();
 	NumBuiltInstances = 0;
 	NumBuiltRenderInstances = 0;
 	InstanceCountToRender = 0;
@@ -2987,6 +3248,7 @@ void UHierarchicalInstancedStaticMeshComponent::ApplyBuildTree(FClusterBuilder&
 	NumBuiltRenderInstances = Builder.Result->SortedInstances.Num();
 
 	ClusterTreePtr = MakeShareable(new TArray<FClusterNode>(MoveTemp(Builder.Result->Nodes)));
+	ResetIncrementalTreeState();
 
 	InstanceReorderTable = MoveTemp(Builder.Result->InstanceReorderTable);
 	SortedInstances = MoveTemp(Builder.Result->SortedInstances);
@@ -3041,13 +3303,16 @@ bool UHierarchicalInstancedStaticMeshComponent::BuildTreeIfOutdated(bool Async,
 
 	TRACE_CPUPROFILER_EVENT_SCOPE(UHierarchicalInstancedStaticMeshComponent::BuildTreeIfOutdated);
 
+	// Instances added and removed incrementally keep the tree up to date until it needs to be rebalanced
+	const bool bHasPendingChanges = (NumIncrementalTreeChanges > 0 && !bIsOutOfDate)
+		? NeedsTreeRebalance()
+		: (InstanceUpdateCmdBuffer.NumTotalCommands() != 0 || NumBuiltInstances != PerInstanceSMData.Num() || UnbuiltInstanceBoundsList.Num() > 0);
+
 	if (ForceUpdate 
 		|| bIsOutOfDate
-		|| InstanceUpdateCmdBuffer.NumTotalCommands() != 0
+		|| bHasPendingChanges
 		|| InstanceReorderTable.Num() != PerInstanceSMData.Num()
-		|| NumBuiltInstances != PerInstanceSMData.Num() 
 		|| (GetStaticMesh() != nullptr && CacheMeshExtendedBounds != GetStaticMesh()->GetBounds())
-		|| UnbuiltInstanceBoundsList.Num() > 0
 		|| GetLinkerUEVersion() < VER_UE4_REBUILD_HIERARCHICAL_INSTANCE_TREES
 		|| GetLinkerCustomVersion(FReleaseObjectVersion::GUID) < FReleaseObjectVersion::HISMCClusterTreeMigration)
 	{
@@ -3453,6 +3718,11 @@ static void GatherInstanceTransformsInArea(const UHierarchicalInstancedStaticMes
 				for (int32 i = ChildNode.FirstInstance; i <= ChildNode.LastInstance; ++i)
 				{
 					int32 SortedIdx = bUseRemaping ? Component.SortedInstances[i] : i;
+					if (SortedIdx == INDEX_NONE)
+					{
+						// Free slot of an instance removed since the tree was built
+						continue;
+					}
 
 					FTransform InstanceToComponent;
 					if (Component.PerInstanceSMData.IsValidIndex(SortedIdx))
@@ -3765,3 +4035,130 @@ static FAutoConsoleCommand RebuildFoliageTreesCmd(
 	FConsoleCommandWithArgsDelegate::CreateStatic(&RebuildFoliageTrees)
 	);
 
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+static double GetTreeLeafVolume(const UHierarchicalInstancedStaticMeshComponent& Component)
+{
+	double Volume = 0.0;
+	for (const FClusterNode& Node : *Component.ClusterTreePtr)
+	{
+		if (Node.FirstChild < 0)
+		{
+			Volume += GetClusterVolume(Node.BoundMin, Node.BoundMax);
+		}
+	}
+	return Volume;
+}
+
+// Removes Churn random instances and adds as many close to them every iteration, like foliage regrowing, with the tree built synchronously after each iteration
+static void RunTreeChurn(UWorld* World, UStaticMesh* StaticMesh, int32 NumInstances, int32 Churn, int32 Iterations, bool bIncremental, FOutputDevice& Ar)
+{
+	const float Spacing = 200.f;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags = RF_Transient;
+	AActor* Actor = World->SpawnActor<AActor>(SpawnParameters);
+
+	UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(Actor, NAME_None, RF_Transient);
+	Component->bAutoRebuildTreeOnInstanceChanges = false;
+	Component->SetStaticMesh(StaticMesh);
+	Actor->SetRootComponent(Component);
+	Component->RegisterComponent();
+
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumInstances));
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(NumInstances);
+	for (int32 Index = 0; Index < NumInstances; ++Index)
+	{
+		Transforms.Add(FTransform(FVector((Index % GridSize) * Spacing, (Index / GridSize) * Spacing, 0.f)));
+	}
+	Component->AddInstances(Transforms, /*bShouldReturnIndices*/false);
+	Component->BuildTreeIfOutdated(/*Async*/false, /*ForceUpdate*/true);
+
+	IConsoleVariable* IncrementalTreeUpdates = CVarIncrementalTreeUpdates.AsVariable();
+	const int32 PreviousIncrementalTreeUpdates = IncrementalTreeUpdates->GetInt();
+	IncrementalTreeUpdates->Set(bIncremental ? 1 : 0, ECVF_SetByConsole);
+
+	FRandomStream Random(1234);
+	TSet<int32> RemovedSet;
+	TArray<FTransform> Added;
+	double Seconds = 0.0;
+	int32 NumBuilds = 0;
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		const int32 InstanceCount = Component->GetInstanceCount();
+		RemovedSet.Reset();
+		while (RemovedSet.Num() < FMath::Min(Churn, InstanceCount))
+		{
+			RemovedSet.Add(Random.RandHelper(InstanceCount));
+		}
+		const TArray<int32> Removed = RemovedSet.Array();
+
+		Added.Reset();
+		for (const int32 InstanceIndex : Removed)
+		{
+			FTransform Transform;
+			Component->GetInstanceTransform(InstanceIndex, Transform);
+			Transform.AddToTranslation(FVector(Random.FRandRange(-0.25f, 0.25f) * Spacing, Random.FRandRange(-0.25f, 0.25f) * Spacing, 0.f));
+			Added.Add(Transform);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		Component->RemoveInstances(Removed);
+		Component->AddInstances(Added, /*bShouldReturnIndices*/false);
+		NumBuilds += Component->BuildTreeIfOutdated(/*Async*/false, /*ForceUpdate*/false) ? 1 : 0;
+		Seconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	IncrementalTreeUpdates->Set(PreviousIncrementalTreeUpdates, ECVF_SetByConsole);
+
+	// Compare the leaves with those of a tree built from scratch, larger leaves cull worse
+	const int32 NumUnbuilt = Component->UnbuiltInstanceBoundsList.Num();
+	const double LeafVolume = GetTreeLeafVolume(*Component);
+	Component->BuildTreeIfOutdated(/*Async*/false, /*ForceUpdate*/true);
+	const double BuiltLeafVolume = GetTreeLeafVolume(*Component);
+
+	Ar.Logf(TEXT("%-12s %12.3f %8d %10d %12.3f"), bIncremental ? TEXT("Incremental") : TEXT("Rebuild"),
+		Seconds * 1000.0 / Iterations, NumBuilds, NumUnbuilt, BuiltLeafVolume > 0.0 ? LeafVolume / BuiltLeafVolume : 1.0);
+
+	Actor->Destroy();
+}
+
+static void RunTreeChurnBenchmark(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	int32 NumInstances = 1000000;
+	int32 Churn = 10000;
+	int32 Iterations = 10;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("Instances="), NumInstances);
+		FParse::Value(*Arg, TEXT("Churn="), Churn);
+		FParse::Value(*Arg, TEXT("Iterations="), Iterations);
+	}
+	NumInstances = FMath::Clamp(NumInstances, 1000, 10000000);
+	Churn = FMath::Clamp(Churn, 1, NumInstances);
+	Iterations = FMath::Clamp(Iterations, 1, 1000);
+
+	UStaticMesh* StaticMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!World || !World->IsGameWorld() || !StaticMesh)
+	{
+		Ar.Logf(TEXT("foliage.TreeChurnBenchmark requires a game world and /Engine/BasicShapes/Cube."));
+		return;
+	}
+
+	Ar.Logf(TEXT("Tree churn benchmark: %d instances, %d removed and added per iteration, %d iterations. Cost is the average time per iteration, in milliseconds, including the tree builds."),
+		NumInstances, Churn, Iterations);
+	Ar.Logf(TEXT("%-12s %12s %8s %10s %12s"), TEXT("Mode"), TEXT("Cost"), TEXT("Builds"), TEXT("Unbuilt"), TEXT("LeafVolume"));
+
+	RunTreeChurn(World, StaticMesh, NumInstances, Churn, Iterations, /*bIncremental*/false, Ar);
+	RunTreeChurn(World, StaticMesh, NumInstances, Churn, Iterations, /*bIncremental*/true, Ar);
+}
+
+static FAutoConsoleCommand TreeChurnBenchmarkCmd(
+	TEXT("foliage.TreeChurnBenchmark"),
+	TEXT("Compares rebuilding the tree of a HISM with incremental tree updates when instances are removed and added. Usage: foliage.TreeChurnBenchmark [Instances=1000000] [Churn=10000] [Iterations=10]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&RunTreeChurnBenchmark)
+	);
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -15,6 +15,13 @@
 #include "RenderCore.h"
 #include "SceneInterface.h"
 #include "Stats/StatsTrace.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "Engine/SkeletalMesh.h"
+#include "UObject/UObjectIterator.h"
+#include "EngineLogs.h"
 
 #if RHI_RAYTRACING
 #include "Engine/SkinnedAssetCommon.h"
@@ -22,8 +29,14 @@
 
 struct FMorphTargetDelta;
 
-template<typename VertexType, int32 NumberOfUVs>
-static void SkinVertices(FFinalSkinVertex* DestVertex, FMatrix44f* ReferenceToLocal, int32 LODIndex, FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer, const FMorphTargetWeightMap& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, const TMap<int32, FClothSimulData>& ClothSimulUpdateData, float ClothBlendWeight, const FMatrix& WorldToLocal, const FVector& WorldScale);
+static TAutoConsoleVariable<int32> CVarCPUSkinVerticesPerTask(
+	TEXT("r.CPUSkin.VerticesPerTask"),
+	2048,
+	TEXT("Number of vertices skinned by each task when a CPU skinned mesh is updated. Sections are split in ranges of this many vertices, which are skinned in parallel.\n")
+	TEXT("0: skin all vertices on the calling thread"),
+	ECVF_Default);
+
+static void SkinLODVertices(FFinalSkinVertex* DestVertex, FMatrix44f* ReferenceToLocal, int32 LODIndex, FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer, const FMorphTargetWeightMap& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, const TMap<int32, FClothSimulData>& ClothSimulUpdateData, float ClothBlendWeight, const FMatrix& WorldToLocal, const FVector& WorldScale, int32 VerticesPerTask);
 
 #define INFLUENCE_0		0
 #define INFLUENCE_1		1
@@ -198,29 +211,6 @@ void FSkeletalMeshObjectCPUSkin::UpdateDynamicData_RenderThread(FRHICommandListI
 	CacheVertices(DynamicData->LODIndex,true);
 }
 
-#define SKIN_LOD_VERTICES(VertexType, NumUVs) \
-{\
-	switch( NumUVs )\
-    {\
-        case 1:\
-			SkinVertices<VertexType<1>, 1>( DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights, DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal, WorldScale); \
-          	break;\
-        case 2:\
-			SkinVertices<VertexType<2>, 2>( DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights, DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal, WorldScale); \
-          	break;\
-        case 3:\
-			SkinVertices<VertexType<3>, 3>( DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights, DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal, WorldScale); \
-          	break;\
-        case 4:\
-			SkinVertices<VertexType<4>, 4>( DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights, DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal, WorldScale); \
-          	break;\
-        default:\
-          	checkf(false, TEXT("Invalid number of UV sets.  Must be between 1 and 4") );\
-			break;\
-    }\
-}\
-	
-
 void FSkeletalMeshObjectCPUSkin::CacheVertices(int32 LODIndex, bool bForce) const
 {
 	SCOPE_CYCLE_COUNTER( STAT_CPUSkinUpdateRTTime);
@@ -254,14 +244,7 @@ void FSkeletalMeshObjectCPUSkin::CacheVertices(int32 LODIndex, bool bForce) cons
 			SCOPE_CYCLE_COUNTER(STAT_SkinningTime);
 
 			// do actual skinning
-			if (LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetUseFullPrecisionUVs())
-			{
-				SKIN_LOD_VERTICES(TGPUSkinVertexFloat32Uvs, LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords());
-			}
-			else
-			{
-				SKIN_LOD_VERTICES(TGPUSkinVertexFloat16Uvs, LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords());
-			}
+			SkinLODVertices(DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights, DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal, WorldScale, CVarCPUSkinVerticesPerTask.GetValueOnAnyThread());
 
 			if (bRenderOverlayMaterial)
 			{
@@ -565,126 +548,66 @@ FDynamicSkelMeshObjectDataCPUSkin::~FDynamicSkelMeshObjectDataCPUSkin() = defaul
 	FSkeletalMeshObjectCPUSkin - morph target blending implementation
 -----------------------------------------------------------------------------*/
 
-/** Struct used to hold temporary info during morph target blending */
-struct FMorphTargetInfo
+/** Weighted morph target deltas of every vertex of a LOD, accumulated before skinning */
+struct FMorphTargetVertexDeltas
 {
-	/** The index into the morph weight list */
-	int32						WeightIndex = INDEX_NONE;
-	
-	/** Index of next delta to try applying. This prevents us looking at every delta for every vertex. */
-	int32						NextDeltaIndex = INDEX_NONE;
-	/** Array of deltas to apply to mesh, sorted based on the index of the base mesh vert that they affect. */
-	const FMorphTargetDelta*	Deltas = nullptr;
-	/** How many deltas are in array */
-	int32						NumDeltas = 0;
+	TArray<FVector3f> PositionDeltas;
+	TArray<FVector3f> TangentZDeltas;
 };
 
 /**
- *	Init set of info structs to hold temporary state while blending morph targets in.
- * @return							number of active morphs that are valid
+ * Accumulate the deltas of all active morph targets for each vertex of a LOD, in a single pass over each morph target.
+ * @return							true if at least one morph target is valid and OutDeltas has a delta for every vertex
  */
-static uint32 InitEvalInfos(const FMorphTargetWeightMap& InActiveMorphTargets, const TArray<float>& MorphTargetWeights, int32 LODIndex, TArray<FMorphTargetInfo>& OutEvalInfos)
+static bool AccumulateMorphTargetDeltas(const FMorphTargetWeightMap& InActiveMorphTargets, const TArray<float>& MorphTargetWeights, int32 LODIndex, int32 NumVertices, FMorphTargetVertexDeltas& OutDeltas)
 {
-	uint32 NumValidMorphTargets=0;
+	bool bHasValidMorphTargets = false;
 
 	for(const TTuple<const UMorphTarget*, int32>& MorphItem: InActiveMorphTargets)
 	{
-		FMorphTargetInfo NewInfo;
 		const UMorphTarget* MorphTarget = MorphItem.Key;
-		const int32 WeightIndex = MorphItem.Value;
+		const float Weight = MorphTargetWeights[MorphItem.Value];
+		const float ActiveMorphAbsVertexWeight = FMath::Abs(Weight);
 
-		const float ActiveMorphAbsVertexWeight = FMath::Abs(MorphTargetWeights[WeightIndex]);
-
-		if( MorphTarget != nullptr &&
-			ActiveMorphAbsVertexWeight >= MinMorphTargetBlendWeight &&
-			ActiveMorphAbsVertexWeight <= MaxMorphTargetBlendWeight &&
-			MorphItem.Key->HasDataForLOD(LODIndex) )
+		if( MorphTarget == nullptr ||
+			ActiveMorphAbsVertexWeight < MinMorphTargetBlendWeight ||
+			ActiveMorphAbsVertexWeight > MaxMorphTargetBlendWeight ||
+			!MorphTarget->HasDataForLOD(LODIndex) )
 		{
-			// start at the first vertex since they affect base mesh verts in ascending order
-			NewInfo.WeightIndex = WeightIndex;
-			NewInfo.NextDeltaIndex = 0;
-			NewInfo.Deltas = MorphTarget->GetMorphTargetDelta(LODIndex, NewInfo.NumDeltas);
-
-			NumValidMorphTargets++;
+			continue;
 		}
 
-		OutEvalInfos.Add(NewInfo);
-	}
-	return NumValidMorphTargets;
-}
-
-/** Release any state for the morphs being evaluated */
-void TermEvalInfos(TArray<FMorphTargetInfo>& EvalInfos)
-{
-	EvalInfos.Empty();
-}
-
-/** 
-* Derive the tanget/binormal using the new normal and the base tangent vectors for a vertex 
-*/
-template<typename VertexType>
-FORCEINLINE void RebuildTangentBasis( VertexType& DestVertex )
-{
-	// derive the new tangent by orthonormalizing the new normal against
-	// the base tangent vector (assuming these are normalized)
-	FVector Tangent = DestVertex.TangentX.ToFVector();
-	FVector Normal = DestVertex.TangentZ.ToFVector();
-	Tangent = Tangent - ((Tangent | Normal) * Normal);
-	Tangent.Normalize();
-	DestVertex.TangentX = Tangent;
-}
-
-/**
-* Applies the vertex deltas to a vertex.
-*/
-template<typename VertexType>
-FORCEINLINE void ApplyMorphBlend( VertexType& DestVertex, const FMorphTargetDelta& SrcMorph, float Weight )
-{
-	// Add position offset 
-	DestVertex.Position += SrcMorph.PositionDelta * Weight;
-
-	// Save W before = operator. That overwrites W to be 127.
-	int8 W = DestVertex.TangentZ.Vector.W;
-
-	FVector TanZ = DestVertex.TangentZ.ToFVector();
-
-	// add normal offset. can only apply normal deltas up to a weight of 1
-	DestVertex.TangentZ = (TanZ + FVector(SrcMorph.TangentZDelta * FMath::Min(Weight,1.0f))).GetUnsafeNormal();
-	// Recover W
-	DestVertex.TangentZ.Vector.W = W;
-} 
+		if (!bHasValidMorphTargets)
+		{
+			OutDeltas.PositionDeltas.Reset();
+			OutDeltas.PositionDeltas.SetNumZeroed(NumVertices);
+			OutDeltas.TangentZDeltas.Reset();
+			OutDeltas.TangentZDeltas.SetNumZeroed(NumVertices);
+			bHasValidMorphTargets = true;
+		}
 
-/**
-* Blends the source vertex with all the active morph targets.
-*/
-template<typename VertexType>
-FORCEINLINE void UpdateMorphedVertex( VertexType& MorphedVertex, const VertexType& SrcVertex, int32 CurBaseVertIdx, int32 LODIndex, TArray<FMorphTargetInfo>& EvalInfos, const TArray<float>& MorphWeights )
-{
-	MorphedVertex = SrcVertex;
+		FVector3f* RESTRICT PositionDeltas = OutDeltas.PositionDeltas.GetData();
+		FVector3f* RESTRICT TangentZDeltas = OutDeltas.TangentZDeltas.GetData();
 
-	// iterate over all active morphs
-	for( int32 MorphIdx=0; MorphIdx < EvalInfos.Num(); MorphIdx++ )
-	{
-		FMorphTargetInfo& Info = EvalInfos[MorphIdx];
+		// can only apply normal deltas up to a weight of 1
+		const float TangentZWeight = FMath::Min(Weight, 1.0f);
 
-		// if the next delta to use matches the current vertex, apply it
-		if( Info.NextDeltaIndex != INDEX_NONE &&
-			Info.NextDeltaIndex < Info.NumDeltas &&
-			Info.Deltas[Info.NextDeltaIndex].SourceIdx == CurBaseVertIdx )
+		int32 NumDeltas = 0;
+		const FMorphTargetDelta* Deltas = MorphTarget->GetMorphTargetDelta(LODIndex, NumDeltas);
+		for (int32 DeltaIndex = 0; DeltaIndex < NumDeltas; DeltaIndex++)
 		{
-			ApplyMorphBlend( MorphedVertex, Info.Deltas[Info.NextDeltaIndex], MorphWeights[Info.WeightIndex] );
-
-			// Update 'next delta to use'
-			Info.NextDeltaIndex += 1;
+			const FMorphTargetDelta& Delta = Deltas[DeltaIndex];
+			if (Delta.SourceIdx < (uint32)NumVertices)
+			{
+				PositionDeltas[Delta.SourceIdx] += Delta.PositionDelta * Weight;
+				TangentZDeltas[Delta.SourceIdx] += Delta.TangentZDelta * TangentZWeight;
+			}
 		}
 	}
 
-	// rebuild orthonormal tangents
-	RebuildTangentBasis( MorphedVertex );
+	return bHasValidMorphTargets;
 }
 
-
-
 /*-----------------------------------------------------------------------------
 	FSkeletalMeshObjectCPUSkin - optimized skinning code
 -----------------------------------------------------------------------------*/
@@ -696,18 +619,19 @@ const VectorRegister		VECTOR_0001				= DECLARE_VECTOR_REGISTER(0.f, 0.f, 0.f, 1.
 
 #define FIXED_VERTEX_INDEX 0xFFFF
 
-template<typename VertexType, int32 NumberOfUVs>
-static void SkinVertexSection(
-	FFinalSkinVertex*& DestVertex,
-	TArray<FMorphTargetInfo>& MorphEvalInfos,
-	const TArray<float>& MorphWeights,
+/** Number of vertices loaded and morphed before being skinned */
+static constexpr int32 SkinVertexBatchSize = 64;
+
+/** Skin NumVertices vertices of a section starting at FirstVertex, the first of which is written to DestVertex. */
+template<int32 NumberOfUVs>
+static void SkinVertexRange(
+	FFinalSkinVertex* RESTRICT DestVertex,
+	const FMorphTargetVertexDeltas* MorphDeltas,
 	const FSkelMeshRenderSection& Section,
 	const FSkeletalMeshLODRenderData &LOD,
-	FSkinWeightVertexBuffer& WeightBuffer,
-	int32 VertexBufferBaseIndex, 
-	uint32 NumValidMorphs, 
-	int32 &CurBaseVertIdx, 
-	int32 LODIndex, 
+	const FSkinWeightVertexBuffer& WeightBuffer,
+	int32 FirstVertex,
+	int32 NumVertices,
 	const FMatrix44f* RESTRICT ReferenceToLocal, 
 	const FClothSimulData* ClothSimData, 
 	float ClothBlendWeight, 
@@ -715,10 +639,10 @@ static void SkinVertexSection(
 	const FVector& WorldScaleAbs )
 {
 	static constexpr VectorRegister VECTOR_INV_65535 = MakeVectorRegisterDoubleConstant(1.0 / 65535, 1.0 / 65535, 1.0 / 65535, 1.0 / 65535);
-	
-	// VertexCopy for morph. Need to allocate right struct
-	// To avoid re-allocation, create 2 statics, and assign right struct
-	VertexType  VertexCopy;
+
+	// Ranges may be skinned on task threads, which have their own control register
+	uint32 StatusRegister = VectorGetControlRegister();
+	VectorSetControlRegister( StatusRegister | VECTOR_ROUND_TOWARD_ZERO );
 
 	// Prefetch all bone indices
 	const FBoneIndexType* BoneMap = Section.BoneMap.GetData();
@@ -727,35 +651,54 @@ static void SkinVertexSection(
 
 	const int32 MaxSectionBoneInfluences = WeightBuffer.GetMaxBoneInfluences();
 	const bool bLODUsesCloth = LOD.HasClothData() && ClothSimData != nullptr && ClothBlendWeight > 0.0f;
-	const int32 NumSoftVertices = Section.GetNumVertices();
-	if (NumSoftVertices > 0)
+	const FPositionVertexBuffer& PositionVertexBuffer = LOD.StaticVertexBuffers.PositionVertexBuffer;
+	const FStaticMeshVertexBuffer& StaticMeshVertexBuffer = LOD.StaticVertexBuffers.StaticMeshVertexBuffer;
+
+	// Source position and tangents of a batch of vertices, after morph targets are applied
+	VectorRegister SrcPositions[SkinVertexBatchSize];
+	VectorRegister SrcTangentX[SkinVertexBatchSize];
+	VectorRegister SrcTangentZ[SkinVertexBatchSize];
+
+	for (int32 BatchStart = 0; BatchStart < NumVertices; BatchStart += SkinVertexBatchSize)
 	{
-		INC_DWORD_STAT_BY(STAT_CPUSkinVertices,NumSoftVertices);
-		for(int32 VertexIndex = VertexBufferBaseIndex;VertexIndex < NumSoftVertices;VertexIndex++,DestVertex++)
+		const int32 BatchNumVertices = FMath::Min(SkinVertexBatchSize, NumVertices - BatchStart);
+		const int32 BatchVertexBufferIndex = Section.GetVertexBufferIndex() + FirstVertex + BatchStart;
+
+		for (int32 BatchIndex = 0; BatchIndex < BatchNumVertices; BatchIndex++)
 		{
-			const int32 VertexBufferIndex = Section.GetVertexBufferIndex() + VertexIndex;
-
-			VertexType SrcSoftVertex;
-			const FVector& VertexPosition = (FVector)LOD.StaticVertexBuffers.PositionVertexBuffer.VertexPosition(VertexBufferIndex);
-			FPlatformMisc::Prefetch(&VertexPosition, PLATFORM_CACHE_LINE_SIZE);	// Prefetch next vertices
-			
-			SrcSoftVertex.Position = (FVector3f)VertexPosition;
-			SrcSoftVertex.TangentX = LOD.StaticVertexBuffers.StaticMeshVertexBuffer.VertexTangentX(VertexBufferIndex);
-			SrcSoftVertex.TangentZ = LOD.StaticVertexBuffers.StaticMeshVertexBuffer.VertexTangentZ(VertexBufferIndex);
-			for (uint32 j = 0; j < VertexType::NumTexCoords; j++)
-			{
-				SrcSoftVertex.UVs[j] = LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetVertexUV_Typed<VertexType::StaticMeshVertexUVType>(VertexBufferIndex, j);
-			}
+			const int32 VertexBufferIndex = BatchVertexBufferIndex + BatchIndex;
+			const FVector4f TangentX = StaticMeshVertexBuffer.VertexTangentX(VertexBufferIndex);
+			const FVector4f TangentZ = StaticMeshVertexBuffer.VertexTangentZ(VertexBufferIndex);
 
-			VertexType* MorphedVertex = &SrcSoftVertex;
+			SrcPositions[BatchIndex] = VectorLoadFloat3_W1( &PositionVertexBuffer.VertexPosition(VertexBufferIndex) );
+			SrcTangentX[BatchIndex] = VectorSet_W0( VectorLoad( &TangentX.X ) );
+			SrcTangentZ[BatchIndex] = VectorLoad( &TangentZ.X );
+		}
 
-			FSkinWeightInfo SrcWeights = WeightBuffer.GetVertexSkinWeights(VertexBufferIndex);
+		// Apply morph target deltas to the batch as a separate pass, so the skinning loop below is the same with or without morph targets
+		if (MorphDeltas)
+		{
+			const FVector3f* RESTRICT PositionDeltas = MorphDeltas->PositionDeltas.GetData() + BatchVertexBufferIndex;
+			const FVector3f* RESTRICT TangentZDeltas = MorphDeltas->TangentZDeltas.GetData() + BatchVertexBufferIndex;
 
-			if( NumValidMorphs ) 
+			for (int32 BatchIndex = 0; BatchIndex < BatchNumVertices; BatchIndex++)
 			{
-				MorphedVertex = &VertexCopy;
-				UpdateMorphedVertex<VertexType>( *MorphedVertex, SrcSoftVertex, CurBaseVertIdx, LODIndex, MorphEvalInfos, MorphWeights);
+				SrcPositions[BatchIndex] = VectorAdd( SrcPositions[BatchIndex], VectorLoadFloat3_W0( &PositionDeltas[BatchIndex] ) );
+
+				// Add the normal offset and renormalize, keeping W (sign of basis determinant)
+				const VectorRegister TangentZ = VectorNormalize( VectorSet_W0( VectorAdd( SrcTangentZ[BatchIndex], VectorLoadFloat3_W0( &TangentZDeltas[BatchIndex] ) ) ) );
+				SrcTangentZ[BatchIndex] = VectorSelect( GlobalVectorConstants::XYZMask(), TangentZ, SrcTangentZ[BatchIndex] );
+
+				// Derive the new tangent by orthonormalizing the new normal against the base tangent vector
+				const VectorRegister TangentX = VectorNegateMultiplyAdd( VectorDot3( SrcTangentX[BatchIndex], TangentZ ), TangentZ, SrcTangentX[BatchIndex] );
+				SrcTangentX[BatchIndex] = VectorNormalizeSafe( TangentX, SrcTangentX[BatchIndex] );
 			}
+		}
+
+		for (int32 BatchIndex = 0; BatchIndex < BatchNumVertices; BatchIndex++, DestVertex++)
+		{
+			const int32 VertexIndex = FirstVertex + BatchStart + BatchIndex;
+			const int32 VertexBufferIndex = BatchVertexBufferIndex + BatchIndex;
 
 			const FMeshToMeshVertData* ClothVertData = nullptr;
 			if (bLODUsesCloth)
@@ -765,14 +708,15 @@ static void SkinVertexSection(
 				FPlatformMisc::Prefetch(ClothVertData, PLATFORM_CACHE_LINE_SIZE);	// Prefetch next cloth vertex
 			}
 
+			FSkinWeightInfo SrcWeights = WeightBuffer.GetVertexSkinWeights(VertexBufferIndex);
 			const FBoneIndexType* RESTRICT BoneIndices = SrcWeights.InfluenceBones;
 			const uint16* RESTRICT BoneWeights = SrcWeights.InfluenceWeights;
 
-			static VectorRegister	SrcNormals[3];
+			VectorRegister			SrcNormals[3];
 			VectorRegister			DstNormals[3];
-			SrcNormals[0] = VectorLoadFloat3_W1( &MorphedVertex->Position);
-			SrcNormals[1] = Unpack3( &MorphedVertex->TangentX.Vector.Packed );
-			SrcNormals[2] = Unpack4( &MorphedVertex->TangentZ.Vector.Packed );
+			SrcNormals[0] = SrcPositions[BatchIndex];
+			SrcNormals[1] = SrcTangentX[BatchIndex];
+			SrcNormals[2] = SrcTangentZ[BatchIndex];
 			VectorRegister Weights = VectorMultiply( VectorLoadURGBA16N(BoneWeights), VECTOR_INV_65535 );
 			VectorRegister ExtraWeights = MakeVectorRegister(0.f, 0.f, 0.f, 0.f);
 			VectorRegister ExtraWeights2 = MakeVectorRegister(0.f, 0.f, 0.f, 0.f);
@@ -908,7 +852,6 @@ static void SkinVertexSection(
 			VectorRegister N_zzzz = VectorReplicate( SrcNormals[0], 2 );
 			DstNormals[0] = VectorMultiplyAdd( N_xxxx, M00, VectorMultiplyAdd( N_yyyy, M10, VectorMultiplyAdd( N_zzzz, M20, M30 ) ) );
 
-			DstNormals[1] = VectorZero();
 			N_xxxx = VectorReplicate( SrcNormals[1], 0 );
 			N_yyyy = VectorReplicate( SrcNormals[1], 1 );
 			N_zzzz = VectorReplicate( SrcNormals[1], 2 );
@@ -917,7 +860,6 @@ static void SkinVertexSection(
 			N_xxxx = VectorReplicate( SrcNormals[2], 0 );
 			N_yyyy = VectorReplicate( SrcNormals[2], 1 );
 			N_zzzz = VectorReplicate( SrcNormals[2], 2 );
-			DstNormals[2] = VectorZero();
 			DstNormals[2] = VectorNormalize(VectorMultiplyAdd( N_xxxx, M00, VectorMultiplyAdd( N_yyyy, M10, VectorMultiply( N_zzzz, M20 ) ) ));
 
 
@@ -1015,15 +957,15 @@ static void SkinVertexSection(
 			// Copy UVs.
 			for (int32 UVIndex = 0; UVIndex < NumberOfUVs; ++UVIndex)
 			{
-				DestVertex->TextureCoordinates[UVIndex] = FVector2D(LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetVertexUV(Section.GetVertexBufferIndex() + VertexIndex, UVIndex));
+				DestVertex->TextureCoordinates[UVIndex] = FVector2D(StaticMeshVertexBuffer.GetVertexUV(VertexBufferIndex, UVIndex));
 			}
-
-			CurBaseVertIdx++;
 		}
 	}
+
+	VectorSetControlRegister( StatusRegister );
 }
 
-template<typename VertexType, int32 NumberOfUVs>
+template<int32 NumberOfUVs>
 static void SkinVertices(
 	FFinalSkinVertex* DestVertex, 
 	FMatrix44f* ReferenceToLocal, 
@@ -1035,14 +977,12 @@ static void SkinVertices(
 	const TMap<int32, FClothSimulData>& ClothSimulUpdateData, 
 	float ClothBlendWeight, 
 	const FMatrix& WorldToLocal,
-	const FVector& WorldScale)
+	const FVector& WorldScale,
+	int32 VerticesPerTask)
 {
-	uint32 StatusRegister = VectorGetControlRegister();
-	VectorSetControlRegister( StatusRegister | VECTOR_ROUND_TOWARD_ZERO );
-
-	// Create array to track state during morph blending
-	TArray<FMorphTargetInfo> MorphEvalInfos;
-	uint32 NumValidMorphs = InitEvalInfos(InActiveMorphTargets, MorphTargetWeights, LODIndex, MorphEvalInfos);
+	// Blend all morph targets before skinning, instead of searching the deltas of each morph target for every vertex
+	FMorphTargetVertexDeltas MorphDeltas;
+	const bool bHasMorphDeltas = AccumulateMorphTargetDeltas(InActiveMorphTargets, MorphTargetWeights, LODIndex, LOD.GetNumVertices(), MorphDeltas);
 
 	const uint32 MaxGPUSkinBones = FGPUBaseSkinVertexFactory::GetMaxGPUSkinBones();
 	check(MaxGPUSkinBones <= FGPUBaseSkinVertexFactory::GHardwareMaxGPUSkinBones);
@@ -1053,22 +993,76 @@ static void SkinVertices(
 		FPlatformMisc::Prefetch( ReferenceToLocal + MatrixIndex );
 	}
 
-	int32 CurBaseVertIdx = 0;
-
-	int32 VertexBufferBaseIndex=0;
-
 	const FVector WorldScaleAbs = WorldScale.GetAbs();  // World scale can't be used mirrored to calculate the clothing positions and tangents since the cloth normals are then reversed
 
+	// Split the sections in ranges of vertices which can be skinned independently
+	struct FVertexRange
+	{
+		int32 SectionIndex;
+		int32 FirstVertex;
+		int32 NumVertices;
+		int32 DestVertexIndex;
+	};
+	TArray<FVertexRange, TInlineAllocator<32>> VertexRanges;
+
+	const int32 NumVerticesPerRange = VerticesPerTask > 0 ? VerticesPerTask : MAX_int32;
+	int32 DestVertexIndex = 0;
 	for(int32 SectionIndex= 0;SectionIndex< LOD.RenderSections.Num();SectionIndex++)
 	{
-		FSkelMeshRenderSection& Section = LOD.RenderSections[SectionIndex];
+		const int32 NumSoftVertices = LOD.RenderSections[SectionIndex].GetNumVertices();
+		INC_DWORD_STAT_BY(STAT_CPUSkinVertices, NumSoftVertices);
+
+		for (int32 FirstVertex = 0; FirstVertex < NumSoftVertices; FirstVertex += NumVerticesPerRange)
+		{
+			const int32 NumVertices = FMath::Min(NumVerticesPerRange, NumSoftVertices - FirstVertex);
+			VertexRanges.Add({ SectionIndex, FirstVertex, NumVertices, DestVertexIndex + FirstVertex });
+		}
+		DestVertexIndex += NumSoftVertices;
+	}
 
+	ParallelFor(TEXT("CPUSkinVertices"), VertexRanges.Num(), 1, [&](int32 RangeIndex)
+	{
+		const FVertexRange& Range = VertexRanges[RangeIndex];
+		const FSkelMeshRenderSection& Section = LOD.RenderSections[Range.SectionIndex];
 		const FClothSimulData* ClothSimData = ClothSimulUpdateData.Find(Section.CorrespondClothAssetIndex);
 
-		SkinVertexSection<VertexType, NumberOfUVs>(DestVertex, MorphEvalInfos, MorphTargetWeights, Section, LOD, WeightBuffer, VertexBufferBaseIndex, NumValidMorphs, CurBaseVertIdx, LODIndex, ReferenceToLocal, ClothSimData, ClothBlendWeight, WorldToLocal, WorldScaleAbs);
-	}
+		SkinVertexRange<NumberOfUVs>(DestVertex + Range.DestVertexIndex, bHasMorphDeltas ? &MorphDeltas : nullptr, Section, LOD, WeightBuffer, Range.FirstVertex, Range.NumVertices, ReferenceToLocal, ClothSimData, ClothBlendWeight, WorldToLocal, WorldScaleAbs);
+	}, VertexRanges.Num() > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+}
 
-	VectorSetControlRegister( StatusRegister );
+/** Skin the vertices of a LOD, choosing the template for its number of UVs. */
+static void SkinLODVertices(
+	FFinalSkinVertex* DestVertex, 
+	FMatrix44f* ReferenceToLocal, 
+	int32 LODIndex, 
+	FSkeletalMeshLODRenderData& LOD,
+	FSkinWeightVertexBuffer& WeightBuffer,
+	const FMorphTargetWeightMap& InActiveMorphTargets, 
+	const TArray<float>& MorphTargetWeights, 
+	const TMap<int32, FClothSimulData>& ClothSimulUpdateData, 
+	float ClothBlendWeight, 
+	const FMatrix& WorldToLocal,
+	const FVector& WorldScale,
+	int32 VerticesPerTask)
+{
+	switch (LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords())
+	{
+	case 1:
+		SkinVertices<1>(DestVertex, ReferenceToLocal, LODIndex, LOD, WeightBuffer, InActiveMorphTargets, MorphTargetWeights, ClothSimulUpdateData, ClothBlendWeight, WorldToLocal, WorldScale, VerticesPerTask);
+		break;
+	case 2:
+		SkinVertices<2>(DestVertex, ReferenceToLocal, LODIndex, LOD, WeightBuffer, InActiveMorphTargets, MorphTargetWeights, ClothSimulUpdateData, ClothBlendWeight, WorldToLocal, WorldScale, VerticesPerTask);
+		break;
+	case 3:
+		SkinVertices<3>(DestVertex, ReferenceToLocal, LODIndex, LOD, WeightBuffer, InActiveMorphTargets, MorphTargetWeights, ClothSimulUpdateData, ClothBlendWeight, WorldToLocal, WorldScale, VerticesPerTask);
+		break;
+	case 4:
+		SkinVertices<4>(DestVertex, ReferenceToLocal, LODIndex, LOD, WeightBuffer, InActiveMorphTargets, MorphTargetWeights, ClothSimulUpdateData, ClothBlendWeight, WorldToLocal, WorldScale, VerticesPerTask);
+		break;
+	default:
+		checkf(false, TEXT("Invalid number of UV sets.  Must be between 1 and 4") );
+		break;
+	}
 }
 
 /**
@@ -1206,3 +1200,108 @@ PRAGMA_ENABLE_DEPRECATION_WARNINGS
 
 
 MSVC_PRAGMA(warning(pop))
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+/** Skin LOD0 of a skeletal mesh with CPU accessible vertex data for a crowd of meshes, serially and in parallel */
+static void RunCPUSkinBenchmark(const TArray<FString>& Args)
+{
+	int32 NumMeshes = 100;
+	int32 NumFrames = 10;
+	bool bMorphTargets = true;
+	FString MeshName;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("Meshes="), NumMeshes);
+		FParse::Value(*Arg, TEXT("Frames="), NumFrames);
+		FParse::Bool(*Arg, TEXT("Morphs="), bMorphTargets);
+		FParse::Value(*Arg, TEXT("Mesh="), MeshName);
+	}
+	NumMeshes = FMath::Clamp(NumMeshes, 1, 10000);
+	NumFrames = FMath::Clamp(NumFrames, 1, 1000);
+
+	USkeletalMesh* SkeletalMesh = nullptr;
+	for (TObjectIterator<USkeletalMesh> It; It; ++It)
+	{
+		const FSkeletalMeshRenderData* RenderData = It->GetResourceForRendering();
+		if (RenderData == nullptr || RenderData->LODRenderData.Num() == 0 || (!MeshName.IsEmpty() && It->GetName() != MeshName))
+		{
+			continue;
+		}
+
+		const FSkeletalMeshLODRenderData& LOD = RenderData->LODRenderData[0];
+		if (LOD.StaticVertexBuffers.PositionVertexBuffer.GetAllowCPUAccess() &&
+			LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetAllowCPUAccess() &&
+			LOD.GetSkinWeightVertexBuffer()->GetNeedsCPUAccess())
+		{
+			SkeletalMesh = *It;
+			break;
+		}
+	}
+
+	if (SkeletalMesh == nullptr)
+	{
+		UE_LOG(LogSkeletalMesh, Warning, TEXT("CPU skin benchmark: no loaded skeletal mesh keeps its vertex data on the CPU. Load a mesh used by a CPU skinned component, or pass Mesh=Name."));
+		return;
+	}
+
+	FSkeletalMeshLODRenderData& LOD = SkeletalMesh->GetResourceForRendering()->LODRenderData[0];
+	FSkinWeightVertexBuffer& WeightBuffer = *LOD.GetSkinWeightVertexBuffer();
+
+	FMorphTargetWeightMap ActiveMorphTargets;
+	TArray<float> MorphTargetWeights;
+	if (bMorphTargets)
+	{
+		for (const UMorphTarget* MorphTarget : SkeletalMesh->GetMorphTargets())
+		{
+			ActiveMorphTargets.Add(MorphTarget, MorphTargetWeights.Add(0.5f));
+		}
+	}
+
+	// Bone matrices of each mesh, slightly moved from the reference pose so every mesh is skinned differently
+	const int32 NumMatrices = FMath::Max<int32>(SkeletalMesh->GetRefSkeleton().GetNum(), FGPUBaseSkinVertexFactory::GetMaxGPUSkinBones());
+	TArray<TArray<FMatrix44f>> ReferenceToLocal;
+	ReferenceToLocal.SetNum(NumMeshes);
+	for (int32 MeshIndex = 0; MeshIndex < NumMeshes; MeshIndex++)
+	{
+		ReferenceToLocal[MeshIndex].SetNumUninitialized(NumMatrices);
+		for (int32 BoneIndex = 0; BoneIndex < NumMatrices; BoneIndex++)
+		{
+			ReferenceToLocal[MeshIndex][BoneIndex] = FTranslationMatrix44f(FVector3f(MeshIndex * 0.01f, BoneIndex * 0.01f, 0.0f));
+		}
+	}
+
+	TArray<FFinalSkinVertex> Vertices;
+	Vertices.SetNumUninitialized(LOD.GetNumVertices());
+
+	const TMap<int32, FClothSimulData> ClothSimulUpdateData;
+	auto RunFrames = [&](int32 VerticesPerTask)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			for (int32 MeshIndex = 0; MeshIndex < NumMeshes; MeshIndex++)
+			{
+				SkinLODVertices(Vertices.GetData(), ReferenceToLocal[MeshIndex].GetData(), 0, LOD, WeightBuffer, ActiveMorphTargets, MorphTargetWeights, ClothSimulUpdateData, 0.0f, FMatrix::Identity, FVector::OneVector, VerticesPerTask);
+			}
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumFrames;
+	};
+
+	const int32 VerticesPerTask = FMath::Max(CVarCPUSkinVerticesPerTask.GetValueOnAnyThread(), 1);
+	const double SerialMilliseconds = RunFrames(0);
+	const double ParallelMilliseconds = RunFrames(VerticesPerTask);
+
+	UE_LOG(LogSkeletalMesh, Display, TEXT("CPU skin benchmark: %d x %s (%d vertices, %d sections, %d morph targets), %d frames"),
+		NumMeshes, *SkeletalMesh->GetName(), LOD.GetNumVertices(), LOD.RenderSections.Num(), ActiveMorphTargets.Num(), NumFrames);
+	UE_LOG(LogSkeletalMesh, Display, TEXT("%24s %12s %12s"), TEXT(""), TEXT("ms/frame"), TEXT("us/mesh"));
+	UE_LOG(LogSkeletalMesh, Display, TEXT("%24s %12.3f %12.2f"), TEXT("Serial"), SerialMilliseconds, SerialMilliseconds * 1000.0 / NumMeshes);
+	UE_LOG(LogSkeletalMesh, Display, TEXT("%24s %12.3f %12.2f"), *FString::Printf(TEXT("%d vertices per task"), VerticesPerTask), ParallelMilliseconds, ParallelMilliseconds * 1000.0 / NumMeshes);
+}
+
+static FAutoConsoleCommand CPUSkinBenchmarkCmd(
+	TEXT("r.CPUSkin.Benchmark"),
+	TEXT("Measures the cost of CPU skinning a crowd of meshes, serially and with r.CPUSkin.VerticesPerTask vertices per task. Usage: r.CPUSkin.Benchmark [Meshes=100] [Frames=10] [Morphs=1] [Mesh=Name]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunCPUSkinBenchmark));
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
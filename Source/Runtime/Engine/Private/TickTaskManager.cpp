@@ -6,6 +6,10 @@
 
 #include "Engine/Level.h"
 #include "Engine/World.h"
+#include "Algo/Sort.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "Misc/Parse.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "Stats/StatsTrace.h"
 #include "TickTaskManagerInterface.h"
@@ -22,6 +26,9 @@ DECLARE_CYCLE_STAT(TEXT("Finalize Parallel Queue"),STAT_FinalizeParallelQueue,ST
 DECLARE_CYCLE_STAT(TEXT("Do Deferred Removes"),STAT_DoDeferredRemoves,STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("Schedule cooldowns"), STAT_ScheduleCooldowns,STATGROUP_Game);
 DECLARE_DWORD_COUNTER_STAT(TEXT("Ticks Queued"),STAT_TicksQueued,STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tick Batches"),STAT_TickBatches,STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Ticks"),STAT_BatchedTicks,STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Tick Batch"),STAT_TickBatch,STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("TG_NewlySpawned"), STAT_TG_NewlySpawned, STATGROUP_TickGroups);
 DECLARE_CYCLE_STAT(TEXT("ReleaseTickGroup"), STAT_ReleaseTickGroup, STATGROUP_TickGroups);
 DECLARE_CYCLE_STAT(TEXT("ReleaseTickGroup Block"), STAT_ReleaseTickGroup_Block, STATGROUP_TickGroups);
@@ -64,6 +71,16 @@ static TAutoConsoleVariable<int32> CVarAllowAsyncTickCleanup(
 	0,
 	TEXT("If true, ticks are cleaned up in a task thread."));
 
+static TAutoConsoleVariable<int32> CVarAllowBatchedTicks(
+	TEXT("tick.AllowBatchedTicks"),
+	1,
+	TEXT("If true, tick functions of the same class, tick groups and prerequisites are executed by a single task instead of one task each. Only applies when ticks are queued on the game thread, see tick.AllowConcurrentTickQueue."));
+
+static TAutoConsoleVariable<int32> CVarMaxTickBatchSize(
+	TEXT("tick.MaxBatchSize"),
+	128,
+	TEXT("Maximum number of tick functions executed by a single batched tick task."));
+
 static float GTimeguardThresholdMS = 0.0f;
 static FAutoConsoleVariableRef CVarLightweightTimeguardThresholdMS(
 	TEXT("tick.LightweightTimeguardThresholdMS"), 
@@ -210,14 +227,27 @@ struct FTickContext
 
 
 
+/** Tick functions executed by a single task. They share the class, tick groups, thread and prerequisites of the first tick function. **/
+struct FTickFunctionBatch
+{
+	/** Class of the objects ticked by this batch **/
+	UClass* Class = nullptr;
+	/** Task executing the batch, held until the start tick group of the batch is dispatched **/
+	TGraphTask<class FTickFunctionTask>* Task = nullptr;
+	/** Tick functions to execute, in the order they were queued **/
+	TArray<FTickFunction*> TickFunctions;
+};
+
 /**
  * Class that handles the actual tick tasks and starting and completing tick groups
  */
 /** Helper class define the task of ticking a component **/
 class FTickFunctionTask
 {
-	/** Actor to tick **/
+	/** Actor to tick, null for a batch **/
 	FTickFunction*			Target;
+	/** Batch of tick functions to tick, null for a single tick function **/
+	FTickFunctionBatch*		Batch;
 	/** tick context, here thread is desired execution thread **/
 	FTickContext			Context;
 	/** If true, log each tick **/
@@ -231,11 +261,24 @@ public:
 	**/
 	FORCEINLINE FTickFunctionTask(FTickFunction* InTarget, const FTickContext* InContext, bool InbLogTick, bool bInLogTicksShowPrerequistes)
 		: Target(InTarget)
+		, Batch(nullptr)
 		, Context(*InContext)
 		, bLogTick(InbLogTick)
 	, bLogTicksShowPrerequistes(bInLogTicksShowPrerequistes)
 	{
 	}
+	/** Constructor
+		* @param InBatch - Batch of functions to tick. Tick functions may be added to the batch until the task is unlocked.
+		* @param InContext - context to tick in, here thread is desired execution thread
+	**/
+	FORCEINLINE FTickFunctionTask(FTickFunctionBatch* InBatch, const FTickContext* InContext, bool InbLogTick, bool bInLogTicksShowPrerequistes)
+		: Target(nullptr)
+		, Batch(InBatch)
+		, Context(*InContext)
+		, bLogTick(InbLogTick)
+		, bLogTicksShowPrerequistes(bInLogTicksShowPrerequistes)
+	{
+	}
 	static FORCEINLINE TStatId GetStatId()
 	{
 		RETURN_QUICK_DECLARE_CYCLE_STAT(FTickFunctionTask, STATGROUP_TaskGraphTasks);
@@ -256,26 +299,47 @@ public:
 		*	However, MyCompletionGraphEvent can be useful for passing to other routines or when it is handy to set up subsequents before you actually do work.
 		**/
 	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		if (Batch)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_TickBatch);
+			FScopeCycleCounterUObject BatchScope(Batch->Class);
+			if (bLogTick)
+			{
+				UE_LOG(LogTick, Log, TEXT("tick batch %s %6llu %2d %d tick functions"), *GetNameSafe(Batch->Class), (uint64)GFrameCounter, (int32)CurrentThread, Batch->TickFunctions.Num());
+			}
+			for (FTickFunction* TickFunction : Batch->TickFunctions)
+			{
+				ExecuteTickFunction(TickFunction, CurrentThread, MyCompletionGraphEvent);
+			}
+		}
+		else
+		{
+			ExecuteTickFunction(Target, CurrentThread, MyCompletionGraphEvent);
+		}
+	}
+private:
+	void ExecuteTickFunction(FTickFunction* TickFunction, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
 	{
 		if (bLogTick)
 		{
-			UE_LOG(LogTick, Log, TEXT("tick %s [%1d, %1d] %6llu %2d %s"), Target->bHighPriority ? TEXT("*") : TEXT(" "), (int32)Target->GetActualTickGroup(), (int32)Target->GetActualEndTickGroup(), (uint64)GFrameCounter, (int32)CurrentThread, *Target->DiagnosticMessage());
+			UE_LOG(LogTick, Log, TEXT("tick %s [%1d, %1d] %6llu %2d %s"), TickFunction->bHighPriority ? TEXT("*") : TEXT(" "), (int32)TickFunction->GetActualTickGroup(), (int32)TickFunction->GetActualEndTickGroup(), (uint64)GFrameCounter, (int32)CurrentThread, *TickFunction->DiagnosticMessage());
 			if (bLogTicksShowPrerequistes)
 			{
-				Target->ShowPrerequistes();
+				TickFunction->ShowPrerequistes();
 			}
 		}
-		if (Target->IsTickFunctionEnabled())
+		if (TickFunction->IsTickFunctionEnabled())
 		{
 #if DO_TIMEGUARD
-			FTimerNameDelegate NameFunction = FTimerNameDelegate::CreateLambda( [&]{ return FString::Printf(TEXT("Slowtick %s "), *Target->DiagnosticMessage()); } );
+			FTimerNameDelegate NameFunction = FTimerNameDelegate::CreateLambda( [&]{ return FString::Printf(TEXT("Slowtick %s "), *TickFunction->DiagnosticMessage()); } );
 			SCOPE_TIME_GUARD_DELEGATE_MS(NameFunction, 4);
 #endif
 			LIGHTWEIGHT_TIME_GUARD_BEGIN(FTickFunctionTask, GTimeguardThresholdMS);
-			Target->ExecuteTick(Target->CalculateDeltaTime(Context), Context.TickType, CurrentThread, MyCompletionGraphEvent);
-			LIGHTWEIGHT_TIME_GUARD_END(FTickFunctionTask, Target->DiagnosticMessage());
+			TickFunction->ExecuteTick(TickFunction->CalculateDeltaTime(Context), Context.TickType, CurrentThread, MyCompletionGraphEvent);
+			LIGHTWEIGHT_TIME_GUARD_END(FTickFunctionTask, TickFunction->DiagnosticMessage());
 		}
-		Target->InternalData->TaskPointer = nullptr;  // This is stale and a good time to clear it for safety
+		TickFunction->InternalData->TaskPointer = nullptr;  // This is stale and a good time to clear it for safety
 	}
 };
 
@@ -367,6 +431,45 @@ class FTickTaskSequencer
 	/** LowPri Held tasks for each tick group. */
 	TArrayWithThreadsafeAdd<TGraphTask<FTickFunctionTask>*> TickTasks[TG_MAX][TG_MAX];
 
+	/** Maximum number of distinct prerequisites of a batched tick task **/
+	static constexpr int32 MaxTickBatchPrerequisites = 4;
+
+	/** Identifies the tick functions that can be executed by the same batched task **/
+	struct FTickBatchKey
+	{
+		UClass* Class = nullptr;
+		ENamedThreads::Type Thread = ENamedThreads::GameThread;
+		TEnumAsByte<ETickingGroup> EndTickGroup = TG_PrePhysics;
+		bool bHighPriority = false;
+		/** Sorted completion events of the prerequisites **/
+		TArray<FGraphEvent*, TInlineAllocator<MaxTickBatchPrerequisites>> Prerequisites;
+
+		bool operator==(const FTickBatchKey& Other) const
+		{
+			return Class == Other.Class && Thread == Other.Thread && EndTickGroup == Other.EndTickGroup && bHighPriority == Other.bHighPriority && Prerequisites == Other.Prerequisites;
+		}
+
+		friend uint32 GetTypeHash(const FTickBatchKey& Key)
+		{
+			uint32 Hash = HashCombine(GetTypeHash(Key.Class), GetTypeHash((uint32)Key.Thread));
+			Hash = HashCombine(Hash, GetTypeHash(((uint32)Key.EndTickGroup.GetValue() << 1) | (Key.bHighPriority ? 1 : 0)));
+			for (FGraphEvent* Prerequisite : Key.Prerequisites)
+			{
+				Hash = HashCombine(Hash, GetTypeHash(Prerequisite));
+			}
+			return Hash;
+		}
+	};
+
+	/** Batches that can still take tick functions, by start tick group. Batches are closed when their start tick group is dispatched. */
+	TMap<FTickBatchKey, FTickFunctionBatch*> OpenTickBatches[TG_MAX];
+
+	/** Batches of the current frame, followed by unused batches kept from previous frames **/
+	TArray<TUniquePtr<FTickFunctionBatch>> TickBatches;
+
+	/** Number of batches used in the current frame **/
+	int32 NumTickBatches;
+
 	/** These are waited for at the end of the frame; they are not on the critical path, but they have to be done before we leave the frame. */
 	FGraphEventArray CleanupTasks;
 
@@ -376,6 +479,12 @@ class FTickTaskSequencer
 	/** If true, allow concurrent ticks **/
 	bool				bAllowConcurrentTicks;
 
+	/** If true, batch tick functions queued on the game thread **/
+	bool				bAllowBatchedTicks;
+
+	/** Maximum number of tick functions of a batch **/
+	int32				MaxTickBatchSize;
+
 	/** If true, log each tick **/
 	bool				bLogTicks;
 	/** If true, log each tick **/
@@ -421,26 +530,28 @@ public:
 		checkSlow(TickFunction->InternalData->ActualStartTickGroup >=0 && TickFunction->InternalData->ActualStartTickGroup < TG_MAX);
 
 		FTickContext UseContext = TickContext;
+		UseContext.Thread = GetTickTaskThread(TickFunction);
+
+		TickFunction->InternalData->TaskPointer = TGraphTask<FTickFunctionTask>::CreateTask(Prerequisites, TickContext.Thread).ConstructAndHold(TickFunction, &UseContext, bLogTicks, bLogTicksShowPrerequistes);
+	}
 
+	/** Returns the desired execution thread of the task of a tick function **/
+	FORCEINLINE ENamedThreads::Type GetTickTaskThread(const FTickFunction* TickFunction) const
+	{
 		bool bIsOriginalTickGroup = (TickFunction->InternalData->ActualStartTickGroup == TickFunction->TickGroup);
 
 		if (TickFunction->bRunOnAnyThread && bAllowConcurrentTicks && bIsOriginalTickGroup)
 		{
 			if (TickFunction->bHighPriority)
 			{
-				UseContext.Thread = CPrio_HiPriAsyncTickTaskPriority.Get();
+				return CPrio_HiPriAsyncTickTaskPriority.Get();
 			}
 			else
 			{
-				UseContext.Thread = CPrio_NormalAsyncTickTaskPriority.Get();
+				return CPrio_NormalAsyncTickTaskPriority.Get();
 			}
 		}
-		else
-		{
-			UseContext.Thread = ENamedThreads::SetTaskPriority(ENamedThreads::GameThread, TickFunction->bHighPriority ? ENamedThreads::HighTaskPriority : ENamedThreads::NormalTaskPriority);
-		}
-
-		TickFunction->InternalData->TaskPointer = TGraphTask<FTickFunctionTask>::CreateTask(Prerequisites, TickContext.Thread).ConstructAndHold(TickFunction, &UseContext, bLogTicks, bLogTicksShowPrerequistes);
+		return ENamedThreads::SetTaskPriority(ENamedThreads::GameThread, TickFunction->bHighPriority ? ENamedThreads::HighTaskPriority : ENamedThreads::NormalTaskPriority);
 	}
 
 	/** Add a completion handle to a tick group **/
@@ -495,11 +606,72 @@ public:
 	{
 		checkSlow(TickFunction->InternalData);
 		checkSlow(TickContext.Thread == ENamedThreads::GameThread);
+		if (bAllowBatchedTicks && TickFunction->bAllowTickBatching && QueueBatchedTickTask(Prerequisites, TickFunction, TickContext))
+		{
+			return;
+		}
 		StartTickTask(Prerequisites, TickFunction, TickContext);
 		TGraphTask<FTickFunctionTask>* Task = (TGraphTask<FTickFunctionTask>*)TickFunction->InternalData->TaskPointer;
 		AddTickTaskCompletion(TickFunction->InternalData->ActualStartTickGroup, TickFunction->InternalData->ActualEndTickGroup, Task, TickFunction->bHighPriority);
 	}
 
+	/**
+	 * Add a tick function to the open batch of tick functions of the same class, tick groups, thread and prerequisites,
+	 * starting a new batched task if there is none or it is full. Dependent tick functions wait for the whole batch.
+	 *
+	 * @param	InPrerequisites - prerequisites that must be completed before this tick can begin
+	 * @param	TickFunction - the tick function to queue
+	 * @param	Context - tick context to tick in. Thread here is the current thread.
+	 * @return	false if the tick function can't be batched and needs its own task
+	 */
+	bool QueueBatchedTickTask(const FGraphEventArray* Prerequisites, FTickFunction* TickFunction, const FTickContext& TickContext)
+	{
+		UClass* BatchClass = TickFunction->GetTickBatchClass();
+		if (!BatchClass || Prerequisites->Num() > MaxTickBatchPrerequisites)
+		{
+			return false;
+		}
+
+		const ETickingGroup StartTickGroup = TickFunction->InternalData->ActualStartTickGroup;
+		const ETickingGroup EndTickGroup = TickFunction->InternalData->ActualEndTickGroup;
+
+		FTickBatchKey Key;
+		Key.Class = BatchClass;
+		Key.Thread = GetTickTaskThread(TickFunction);
+		Key.EndTickGroup = EndTickGroup;
+		Key.bHighPriority = TickFunction->bHighPriority;
+		for (const FGraphEventRef& Prerequisite : *Prerequisites)
+		{
+			// Prerequisites in the same batch share a completion event
+			Key.Prerequisites.AddUnique(Prerequisite.GetReference());
+		}
+		Algo::Sort(Key.Prerequisites);
+
+		FTickContext UseContext = TickContext;
+		UseContext.Thread = Key.Thread;
+
+		FTickFunctionBatch*& Batch = OpenTickBatches[StartTickGroup].FindOrAdd(MoveTemp(Key));
+		if (!Batch || Batch->TickFunctions.Num() >= MaxTickBatchSize)
+		{
+			if (NumTickBatches == TickBatches.Num())
+			{
+				TickBatches.Add(MakeUnique<FTickFunctionBatch>());
+			}
+			Batch = TickBatches[NumTickBatches++].Get();
+			Batch->Class = BatchClass;
+			Batch->TickFunctions.Reset();
+			Batch->Task = TGraphTask<FTickFunctionTask>::CreateTask(Prerequisites, TickContext.Thread).ConstructAndHold(Batch, &UseContext, bLogTicks, bLogTicksShowPrerequistes);
+			AddTickTaskCompletion(StartTickGroup, EndTickGroup, Batch->Task, TickFunction->bHighPriority);
+			INC_DWORD_STAT(STAT_TickBatches);
+			CSV_CUSTOM_STAT(Basic, TickBatches, 1, ECsvCustomStatOp::Accumulate);
+		}
+
+		Batch->TickFunctions.Add(TickFunction);
+		TickFunction->InternalData->TaskPointer = Batch->Task;
+		INC_DWORD_STAT(STAT_BatchedTicks);
+		return true;
+	}
+
 	/**
 	 * Start a component tick task and add the completion handle
 	 *
@@ -596,8 +768,14 @@ public:
 			bAllowConcurrentTicks = !!CVarAllowAsyncComponentTicks.GetValueOnGameThread();
 		}
 
+		bAllowBatchedTicks = !!CVarAllowBatchedTicks.GetValueOnGameThread();
+		MaxTickBatchSize = FMath::Max(CVarMaxTickBatchSize.GetValueOnGameThread(), 1);
+
 		WaitForCleanup();
 
+		// Batches of the previous frame are complete once the cleanup is done
+		NumTickBatches = 0;
+
 		for (int32 Index = 0; Index < TG_MAX; Index++)
 		{
 			check(!TickCompletionEvents[Index].Num());  // we should not be adding to these outside of a ticking proper and they were already cleared after they were ticked
@@ -608,6 +786,7 @@ public:
 				TickTasks[Index][IndexInner].Reset();
 				HiPriTickTasks[Index][IndexInner].Reset();
 			}
+			OpenTickBatches[Index].Reset();
 		}
 		WaitForTickGroup = (ETickingGroup)0;
 	}
@@ -624,7 +803,10 @@ public:
 private:
 
 	FTickTaskSequencer()
-		: bAllowConcurrentTicks(false)
+		: NumTickBatches(0)
+		, bAllowConcurrentTicks(false)
+		, bAllowBatchedTicks(false)
+		, MaxTickBatchSize(1)
 		, bLogTicks(false)
 		, bLogTicksShowPrerequistes(false)
 	{
@@ -658,6 +840,10 @@ private:
 	void DispatchTickGroup(ENamedThreads::Type CurrentThread, ETickingGroup WorldTickGroup)
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_DispatchTickGroup);
+
+		// Batches can't take more tick functions once their tasks are unlocked
+		OpenTickBatches[WorldTickGroup].Reset();
+
 		for (int32 IndexInner = 0; IndexInner < TG_MAX; IndexInner++)
 		{
 			TArray<TGraphTask<FTickFunctionTask>*>& TickArray = HiPriTickTasks[WorldTickGroup][IndexInner]; //-V781
@@ -1807,6 +1993,7 @@ FTickFunction::FTickFunction()
 	, bAllowTickOnDedicatedServer(true)
 	, bHighPriority(false)
 	, bRunOnAnyThread(false)
+	, bAllowTickBatching(true)
 	, TickState(ETickState::Enabled)
 	, TickInterval(0.f)
 {
@@ -2290,3 +2477,95 @@ static FAutoConsoleCommandWithWorldAndArgs AddIndirectTestTickFunctionsCmd(
 
 
 
+
+static TArray<TWeakObjectPtr<AActor>> TestTickActors;
+
+static void RemoveTestTickActors(const TArray<FString>& Args)
+{
+	if (TestTickActors.Num())
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Removing %d Test Tick Actors."), TestTickActors.Num());
+		for (const TWeakObjectPtr<AActor>& Actor : TestTickActors)
+		{
+			if (Actor.IsValid())
+			{
+				Actor->Destroy();
+			}
+		}
+		TestTickActors.Empty();
+	}
+}
+
+static void AddTestTickActors(const TArray<FString>& Args, UWorld* InWorld)
+{
+	RemoveTestTickActors(Args);
+
+	int32 NumActors = 5000;
+	int32 NumComponents = 1;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("Num="), NumActors);
+		FParse::Value(*Arg, TEXT("Components="), NumComponents);
+	}
+	NumActors = FMath::Clamp(NumActors, 1, 100000);
+	NumComponents = FMath::Clamp(NumComponents, 0, 16);
+
+	if (!InWorld || !InWorld->HasBegunPlay())
+	{
+		UE_LOG(LogConsoleResponse, Warning, TEXT("Test Tick Actors only tick in a world that has begun play."));
+		return;
+	}
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("Adding %d Test Tick Actors with %d ticking components each. Compare stat game with tick.AllowBatchedTicks 0 and 1."), NumActors, NumComponents);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.bDeferConstruction = true;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+
+	TestTickActors.Reserve(NumActors);
+	for (int32 Index = 0; Index < NumActors; Index++)
+	{
+		AActor* Actor = InWorld->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		if (!Actor)
+		{
+			continue;
+		}
+
+		// Plain actors and scene components whose tick does nearly no work, so the cost is the tick infrastructure
+		Actor->PrimaryActorTick.bCanEverTick = true;
+		Actor->PrimaryActorTick.bStartWithTickEnabled = true;
+		Actor->FinishSpawning(FTransform::Identity);
+
+		// Components registered after the actor has begun play register their tick functions
+		for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ComponentIndex++)
+		{
+			USceneComponent* Component = NewObject<USceneComponent>(Actor, NAME_None, RF_Transient);
+			Component->PrimaryComponentTick.bCanEverTick = true;
+			Component->PrimaryComponentTick.bStartWithTickEnabled = true;
+			if (!Actor->GetRootComponent())
+			{
+				Actor->SetRootComponent(Component);
+			}
+			else
+			{
+				Component->SetupAttachment(Actor->GetRootComponent());
+			}
+			Actor->AddInstanceComponent(Component);
+			Component->RegisterComponent();
+		}
+		TestTickActors.Add(Actor);
+	}
+}
+
+static FAutoConsoleCommand RemoveTestTickActorsCmd(
+	TEXT("tick.RemoveTestTickActors"),
+	TEXT("Destroy the actors spawned by tick.AddTestTickActors."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RemoveTestTickActors)
+	);
+
+static FAutoConsoleCommandWithWorldAndArgs AddTestTickActorsCmd(
+	TEXT("tick.AddTestTickActors"),
+	TEXT("Spawn actors with trivial actor and component ticks to test performance of ticking infrastructure and tick batching. Usage: tick.AddTestTickActors [Num=5000] [Components=1]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&AddTestTickActors)
+	);
@@ -446,8 +446,10 @@ struct ICompressedAnimData
 	ENGINE_API ICompressedAnimData(const ICompressedAnimData&);
 	ENGINE_API ICompressedAnimData& operator=(const ICompressedAnimData&);
 	
+	/** Removes the poses of this data from the decompression cache */
+	ENGINE_API virtual ~ICompressedAnimData();
+
 	/* Virtual interface codecs must implement */
-	virtual ~ICompressedAnimData() {}
 
 	ENGINE_API virtual void SerializeCompressedData(class FArchive& Ar);
 	virtual void Bind(const TArrayView<uint8> BulkData) = 0;
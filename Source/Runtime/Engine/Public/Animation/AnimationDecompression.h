@@ -9,6 +9,7 @@ struct FCompressedAnimSequence;
 struct FAnimExtractContext;
 struct FAnimSequenceDecompressionContext;
 struct FRootMotionReset;
+struct ICompressedAnimData;
 
 namespace UE::Anim::Decompression
 {
@@ -25,4 +26,25 @@ namespace UE::Anim::Decompression
 				FAnimSequenceDecompressionContext& DecompressionContext,
 				FName RetargetSource,
 				const FRootMotionReset& RootMotionReset);
-}
\ No newline at end of file
+
+	/** Pose to decompress with DecompressPoses, with the arguments of DecompressPose */
+	struct FDecompressPoseRequest
+	{
+		FCompactPose* OutPose = nullptr;
+		const FCompressedAnimSequence* CompressedData = nullptr;
+		const FAnimExtractContext* ExtractionContext = nullptr;
+		FAnimSequenceDecompressionContext* DecompressionContext = nullptr;
+		const TArray<FTransform>* RetargetTransforms = nullptr;
+		const FRootMotionReset* RootMotionReset = nullptr;
+	};
+
+	/**
+	 * Decompresses several poses, like calling DecompressPose for each request. Requests sampling the same compressed
+	 * data at the same time, or at the same cached sample when a.DecompressionCache.Enable is set, decode all tracks
+	 * once with the codec and share the result.
+	 */
+	ENGINE_API void DecompressPoses(TArrayView<const FDecompressPoseRequest> Requests);
+
+	/** Removes all cached poses of CompressedAnimData from the decompression cache, before it is modified or destroyed */
+	ENGINE_API void InvalidateDecompressionCache(const ICompressedAnimData* CompressedAnimData);
+}
@@ -0,0 +1,118 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimTypes.h"
+#include "BoneIndices.h"
+
+struct FBoneContainer;
+
+/**
+ * Bone transforms of a pose stored as a structure of arrays, with one stream per component of the rotations,
+ * translations and scales. Blend operations process the same component of 4 bones per vector register
+ * instead of one transform at a time.
+ *
+ * Poses are converted from and to FTransform arrays only at the boundaries of a sequence of operations: when
+ * blending many poses, sources are read as transforms, the accumulated pose stays in streams and only the
+ * normalized result is written back. Like FCompactPose, streams are allocated on the anim stack.
+ */
+struct FCompactPoseSoA
+{
+	/** Components stored in separate streams */
+	enum EStream : int32
+	{
+		RotationX,
+		RotationY,
+		RotationZ,
+		RotationW,
+		TranslationX,
+		TranslationY,
+		TranslationZ,
+		ScaleX,
+		ScaleY,
+		ScaleZ,
+		NumStreams
+	};
+
+	/** Number of bones processed together. Streams are padded to a multiple of this, padding holds unused but valid transforms. */
+	static constexpr int32 NumLanes = 4;
+
+	int32 Num() const
+	{
+		return NumBones;
+	}
+
+	/** Returns the padded number of elements of each stream */
+	int32 GetStreamNum() const
+	{
+		return StreamNum;
+	}
+
+	double* GetStream(EStream Stream)
+	{
+		return Data.GetData() + Stream * StreamNum;
+	}
+
+	const double* GetStream(EStream Stream) const
+	{
+		return Data.GetData() + Stream * StreamNum;
+	}
+
+	/** Resizes the pose. Bones are uninitialized and padding is set to identity. */
+	ENGINE_API void SetNum(int32 InNumBones);
+
+	/** Returns the transform of a bone */
+	ENGINE_API FTransform GetTransform(int32 BoneIndex) const;
+
+	/** Converts bone transforms to streams, resizing the pose to the number of transforms */
+	ENGINE_API void CopyFrom(TArrayView<const FTransform> Bones);
+
+	/** Converts the streams to bone transforms. Bones must have as many transforms as this pose. */
+	ENGINE_API void CopyTo(TArrayView<FTransform> Bones) const;
+
+	/** Sets this pose to Source * BlendWeight, like BlendTransform<ETransformBlendMode::Overwrite> */
+	ENGINE_API void BlendOverwrite(const FCompactPoseSoA& Source, float BlendWeight);
+	ENGINE_API void BlendOverwrite(TArrayView<const FTransform> Source, float BlendWeight);
+
+	/** Accumulates Source * BlendWeight with rotations in the shortest direction, like BlendTransform<ETransformBlendMode::Accumulate> */
+	ENGINE_API void BlendAccumulate(const FCompactPoseSoA& Source, float BlendWeight);
+	ENGINE_API void BlendAccumulate(TArrayView<const FTransform> Source, float BlendWeight);
+
+	/** Normalizes all rotations, using identity for rotations too small to be normalized */
+	ENGINE_API void NormalizeRotations();
+
+	/**
+	 * Applies a local space additive pose, like FAnimationRuntime::AccumulateLocalSpaceAdditivePoseInternal:
+	 * with full weight rotations are accumulated with FTransform::AccumulateWithAdditiveScale, otherwise with
+	 * FTransform::BlendFromIdentityAndAccumulate. Rotations are not normalized.
+	 */
+	ENGINE_API void AccumulateAdditive(const FCompactPoseSoA& Additive, float BlendWeight);
+	ENGINE_API void AccumulateAdditive(TArrayView<const FTransform> Additive, float BlendWeight);
+
+	/**
+	 * Sets this pose to the mirror of Source, like FAnimationRuntime::MirrorPose. Every bone takes the mirrored
+	 * transform of its mirror bone, in the object space of the reference pose.
+	 *
+	 * @param Source						Pose to mirror. Must not be this pose.
+	 * @param BoneContainer					Bone container of the pose, for parent bones
+	 * @param MirrorAxis					Object space axis to mirror along
+	 * @param CompactPoseMirrorBones		Mirror bone of each bone, or an invalid index to keep the bone transform
+	 * @param ComponentSpaceRefRotations	Component space rotation of each bone in the reference pose
+	 */
+	ENGINE_API void Mirror(const FCompactPoseSoA& Source, const FBoneContainer& BoneContainer, EAxis::Type MirrorAxis, TArrayView<const FCompactPoseBoneIndex> CompactPoseMirrorBones, TArrayView<const FQuat> ComponentSpaceRefRotations);
+
+private:
+	template<typename SourceType>
+	void BlendOverwriteInternal(const SourceType& Source, float BlendWeight);
+
+	template<typename SourceType>
+	void BlendAccumulateInternal(const SourceType& Source, float BlendWeight);
+
+	template<typename SourceType>
+	void AccumulateAdditiveInternal(const SourceType& Source, float BlendWeight);
+
+	int32 NumBones = 0;
+	int32 StreamNum = 0;
+	TArray<double, FAnimStackAllocator> Data;
+};
@@ -243,6 +243,48 @@ struct FOverlapDatum : FBaseTraceDatum
 	}
 };
 
+/** Start and end of a line trace or sweep of a batch, see FBatchTraceDatum */
+struct FBatchTraceQuery
+{
+	FVector Start;
+	FVector End;
+
+	FBatchTraceQuery() {}
+
+	FBatchTraceQuery(const FVector& InStart, const FVector& InEnd)
+		: Start(InStart)
+		, End(InEnd)
+	{
+	}
+};
+
+/**
+ * Batch of line traces or sweeps for async trace, sharing the same shape and collision parameters
+ * 
+ * Queries are filled up by main thread and split in ranges of queries close to each other, each range is traced by a worker thread. 
+ * There is no delegate, results are read from OutHits with UWorld::QueryBatchTraceData
+ */
+struct FBatchTraceDatum : public FBaseTraceDatum
+{
+	/** Input of the batch. Filled up by main thread */
+	TArray<FBatchTraceQuery> Queries;
+	FQuat Rot;
+
+	/** Whether to do test or single test. Multi is not supported, as queries would have different numbers of hits */
+	EAsyncTraceType TraceType;
+
+	/** 
+	 * Output of the batch, one hit per query in the order of Queries. Filled up by worker threads
+	 * bBlockingHit is set for queries that hit something, other members are only set for single traces
+	 */
+	TArray<struct FHitResult> OutHits;
+
+	/** Order in which queries are traced, as a sort key in the high bits and the query index in the low 32 bits */
+	TArray<uint64> QueryOrder;
+
+	FBatchTraceDatum() {}
+};
+
 #define ASYNC_TRACE_BUFFER_SIZE 64
 
 /**
@@ -281,6 +323,11 @@ struct AsyncTraceData : FNoncopyable
 	/** Datum entries in OverlapData are persistent for efficiency. This is the number of them that are actually in use (rather than OverlapData.Num()). */
 	int32 NumQueuedOverlapData;
 
+	/** Batches of traces, see UWorld::AsyncBatchLineTraceByChannel. Batches are persistent so their arrays are reused from frame to frame. */
+	TArray<TUniquePtr<FBatchTraceDatum>>		BatchTraceData;
+	/** Number of batches in BatchTraceData that are actually in use */
+	int32 NumQueuedBatchTraceData;
+
 	/**
 	 * if Execution is all done, set this to be true
 	 * 
@@ -0,0 +1,232 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DynamicMesh/DynamicMesh3.h"
+#include "Generators/SphereGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "Spatial/FastWinding.h"
+#include "Spatial/MeshAABBTree3.h"
+
+using namespace UE::Geometry;
+
+namespace UELocal
+{
+	using FTree = TMeshAABBTree3<FDynamicMesh3>;
+
+	// noisy sphere, approximating a closed scanned surface with roughly TargetTriCount triangles
+	static void MakeBenchmarkMesh(int32 TargetTriCount, FDynamicMesh3& Mesh)
+	{
+		FSphereGenerator Generator;
+		Generator.Radius = 100.0;
+		Generator.NumPhi = FMath::Max(3, (int32)FMath::Sqrt((double)TargetTriCount / 4.0));
+		Generator.NumTheta = 2 * Generator.NumPhi;
+		Mesh.Copy(&Generator.Generate());
+
+		FRandomStream Random(31337);
+		for (int32 VertexID : Mesh.VertexIndicesItr())
+		{
+			const FVector3d Position = Mesh.GetVertex(VertexID);
+			Mesh.SetVertex(VertexID, Position * (1.0 + 0.02 * (Random.GetFraction() - 0.5)));
+		}
+	}
+
+	static double SecondsToMs(double Seconds)
+	{
+		return Seconds * 1000.0;
+	}
+
+	static void RunTreeBenchmark(const FDynamicMesh3& Mesh, const TCHAR* Label, const FTree::FBuildOptions& Options,
+		TArrayView<const FVector3d> QueryPoints, bool bParallelWinding)
+	{
+		FTree Tree(&Mesh, false);
+		Tree.SetBuildOptions(Options);
+
+		double StartTime = FPlatformTime::Seconds();
+		Tree.Build();
+		const double BuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+		TFastWindingTree<FDynamicMesh3> Winding(&Tree, false);
+		Winding.bParallelBuild = bParallelWinding;
+		StartTime = FPlatformTime::Seconds();
+		Winding.Build(true);
+		const double WindingBuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		double SumDistSqr = 0.0;
+		for (const FVector3d& Point : QueryPoints)
+		{
+			double NearestDistSqr;
+			Tree.FindNearestTriangle(Point, NearestDistSqr);
+			SumDistSqr += NearestDistSqr;
+		}
+		const double NearestSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		int32 NumHits = 0;
+		for (const FVector3d& Point : QueryPoints)
+		{
+			const FRay3d Ray(Point, Normalized(-Point));
+			NumHits += (Tree.FindNearestHitTriangle(Ray) >= 0) ? 1 : 0;
+		}
+		const double RaySeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		int32 NumInside = 0;
+		for (const FVector3d& Point : QueryPoints)
+		{
+			NumInside += Winding.IsInside(Point) ? 1 : 0;
+		}
+		const double WindingSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogGeometry, Display, TEXT("%-24s build %8.2fms  winding build (%s) %8.2fms  | %d queries: nearest %7.2fms  ray %7.2fms (%d hits)  winding %7.2fms (%d inside)  [%.3f]"),
+			Label, SecondsToMs(BuildSeconds), bParallelWinding ? TEXT("parallel") : TEXT("serial"), SecondsToMs(WindingBuildSeconds),
+			QueryPoints.Num(), SecondsToMs(NearestSeconds), SecondsToMs(RaySeconds), NumHits, SecondsToMs(WindingSeconds), NumInside, SumDistSqr);
+	}
+
+	static void RunAABBTreeBenchmark(const TArray<FString>& Args)
+	{
+		int32 TriCount = 2000000;
+		int32 QueryCount = 100000;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Tris="), TriCount);
+			FParse::Value(*Arg, TEXT("Queries="), QueryCount);
+		}
+
+		FDynamicMesh3 Mesh;
+		MakeBenchmarkMesh(TriCount, Mesh);
+
+		FRandomStream Random(4242);
+		TArray<FVector3d> QueryPoints;
+		QueryPoints.SetNumUninitialized(FMath::Max(QueryCount, 0));
+		for (FVector3d& Point : QueryPoints)
+		{
+			Point = FVector3d(Random.GetUnitVector()) * Random.FRandRange(50.0, 150.0);
+		}
+
+		UE_LOG(LogGeometry, Display, TEXT("AABBTree benchmark: %d triangles, %d queries"), Mesh.TriangleCount(), QueryPoints.Num());
+
+		FTree::FBuildOptions Options;
+		RunTreeBenchmark(Mesh, TEXT("Midpoint"), Options, QueryPoints, false);
+		Options.bParallel = true;
+		RunTreeBenchmark(Mesh, TEXT("Midpoint parallel"), Options, QueryPoints, true);
+		Options.SplitMethod = FTree::ESplitMethod::BinnedSAH;
+		Options.bParallel = false;
+		RunTreeBenchmark(Mesh, TEXT("BinnedSAH"), Options, QueryPoints, false);
+		Options.bParallel = true;
+		RunTreeBenchmark(Mesh, TEXT("BinnedSAH parallel"), Options, QueryPoints, true);
+	}
+
+	// rays from a grid in front of the mesh, in scanline order like a baking or rendering job would issue them
+	static void MakeCoherentRays(int32 Resolution, TArray<FRay3d>& Rays, TArray<FVector3d>& Points)
+	{
+		Rays.Reset(Resolution * Resolution);
+		Points.Reset(Resolution * Resolution);
+		for (int32 Y = 0; Y < Resolution; ++Y)
+		{
+			for (int32 X = 0; X < Resolution; ++X)
+			{
+				const FVector3d GridPoint(-110.0 + 220.0 * (X + 0.5) / Resolution, -110.0 + 220.0 * (Y + 0.5) / Resolution, -150.0);
+				Rays.Emplace(GridPoint, FVector3d::UnitZ());
+				Points.Add(FVector3d(GridPoint.X, GridPoint.Y, 0.0));
+			}
+		}
+	}
+
+	static void RunQueryBenchmark(const TArray<FString>& Args)
+	{
+		int32 TriCount = 2000000;
+		int32 Resolution = 1024;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Tris="), TriCount);
+			FParse::Value(*Arg, TEXT("Res="), Resolution);
+		}
+		Resolution = FMath::Max(Resolution, 1);
+
+		FDynamicMesh3 Mesh;
+		MakeBenchmarkMesh(TriCount, Mesh);
+		FTree Tree(&Mesh);
+		TFastWindingTree<FDynamicMesh3> Winding(&Tree);
+
+		TArray<FRay3d> Rays;
+		TArray<FVector3d> Points;
+		MakeCoherentRays(Resolution, Rays, Points);
+		const int32 NumQueries = Rays.Num();
+
+		TArray<int> ScalarTIDs, PacketTIDs;
+		TArray<double> ScalarValues, PacketValues;
+		ScalarTIDs.SetNumUninitialized(NumQueries);
+		PacketTIDs.SetNumUninitialized(NumQueries);
+		ScalarValues.SetNumUninitialized(NumQueries);
+		PacketValues.SetNumUninitialized(NumQueries);
+
+		auto Report = [NumQueries](const TCHAR* Label, double Seconds)
+		{
+			UE_LOG(LogGeometry, Display, TEXT("%-32s %8.2fms  %8.2f Mqueries/s"), Label, SecondsToMs(Seconds), NumQueries / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER) / 1.0e6);
+		};
+		auto CountMismatches = [&ScalarTIDs, &PacketTIDs]()
+		{
+			int32 NumMismatches = 0;
+			for (int32 Index = 0; Index < ScalarTIDs.Num(); ++Index)
+			{
+				NumMismatches += (ScalarTIDs[Index] != PacketTIDs[Index]) ? 1 : 0;
+			}
+			return NumMismatches;
+		};
+
+		UE_LOG(LogGeometry, Display, TEXT("AABBTree query benchmark: %d triangles, %d coherent rays and points"), Mesh.TriangleCount(), NumQueries);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumQueries; ++Index)
+		{
+			Tree.FindNearestHitTriangle(Rays[Index], ScalarValues[Index], ScalarTIDs[Index]);
+		}
+		Report(TEXT("Ray scalar"), FPlatformTime::Seconds() - StartTime);
+
+		StartTime = FPlatformTime::Seconds();
+		Tree.FindNearestHitTriangles(Rays, PacketValues, PacketTIDs, IMeshSpatial::FQueryOptions(), false);
+		Report(TEXT("Ray packets"), FPlatformTime::Seconds() - StartTime);
+
+		StartTime = FPlatformTime::Seconds();
+		Tree.FindNearestHitTriangles(Rays, PacketValues, PacketTIDs);
+		Report(TEXT("Ray packets parallel"), FPlatformTime::Seconds() - StartTime);
+		UE_LOG(LogGeometry, Display, TEXT("Ray packet mismatches: %d"), CountMismatches());
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumQueries; ++Index)
+		{
+			ScalarTIDs[Index] = Tree.FindNearestTriangle(Points[Index], ScalarValues[Index]);
+		}
+		Report(TEXT("Nearest scalar"), FPlatformTime::Seconds() - StartTime);
+
+		StartTime = FPlatformTime::Seconds();
+		Tree.FindNearestTriangles(Points, PacketValues, PacketTIDs, IMeshSpatial::FQueryOptions(), false);
+		Report(TEXT("Nearest packets"), FPlatformTime::Seconds() - StartTime);
+
+		StartTime = FPlatformTime::Seconds();
+		Tree.FindNearestTriangles(Points, PacketValues, PacketTIDs);
+		Report(TEXT("Nearest packets parallel"), FPlatformTime::Seconds() - StartTime);
+		UE_LOG(LogGeometry, Display, TEXT("Nearest packet mismatches: %d"), CountMismatches());
+
+		StartTime = FPlatformTime::Seconds();
+		Winding.FastWindingNumbers(Points, ScalarValues, false);
+		Report(TEXT("Winding"), FPlatformTime::Seconds() - StartTime);
+
+		StartTime = FPlatformTime::Seconds();
+		Winding.FastWindingNumbers(Points, PacketValues);
+		Report(TEXT("Winding parallel"), FPlatformTime::Seconds() - StartTime);
+	}
+}
+
+static FAutoConsoleCommand AABBTreeQueryBenchmarkCmd(
+	TEXT("geometry.AABBTree.QueryBenchmark"),
+	TEXT("Compare scalar, packet and parallel batch query throughput of TMeshAABBTree3 and TFastWindingTree on a large generated mesh. Usage: geometry.AABBTree.QueryBenchmark [Tris=2000000] [Res=1024]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&UELocal::RunQueryBenchmark));
+
+static FAutoConsoleCommand AABBTreeBenchmarkCmd(
+	TEXT("geometry.AABBTree.Benchmark"),
+	TEXT("Build TMeshAABBTree3 and TFastWindingTree for a large generated mesh with each split method, serial and parallel, and log build and query times. Usage: geometry.AABBTree.Benchmark [Tris=2000000] [Queries=100000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&UELocal::RunAABBTreeBenchmark));
@@ -72,6 +72,9 @@ namespace FastTriWinding
 		R = FMath::Sqrt(RSq);
 	}
 
+	// Benchmarking shows parallel starts to outperform serial at around 2500 triangles or so
+	constexpr int ComputeCoeffsParallelThreshold = 3000;
+
 	/**
 	 *  precompute constant coefficients of triangle winding number approximation (evaluated in parallel for large sets of triangles)
 	 *  P: 'Center' of expansion for Triangles (area-weighted centroid avg)
@@ -82,7 +85,7 @@ namespace FastTriWinding
 	 */
 	template <class TriangleMeshType>
 	void ComputeCoeffs(const TriangleMeshType& Mesh,
-					   const TSet<int>& TriangleSet,
+					   TArrayView<const int> TriangleArray,
 					   const FMeshTriInfoCache& TriCache,
 					   FVector3d& P,
 					   double& R,
@@ -91,15 +94,12 @@ namespace FastTriWinding
 					   int NumTasks = 16)
 	{
 		// If the data is small enough, don't bother trying to parallelize
-		constexpr int ParallelThreshold = 3000;			// Benchmarking shows parallel starts to outperform serial at around 2500 triangles or so
-		if (TriangleSet.Num() < ParallelThreshold)
+		if (TriangleArray.Num() < ComputeCoeffsParallelThreshold)
 		{
-			ComputeCoeffsSerial(Mesh, TriangleSet, TriCache, P, R, Order1, Order2);
+			ComputeCoeffsSerial(Mesh, TriangleArray, TriCache, P, R, Order1, Order2);
 			return;
 		}
 
-		TArray<int> TriangleArray = TriangleSet.Array();
-
 		// First compute the area-weighted centroid
 
 		struct PData
@@ -187,6 +187,26 @@ namespace FastTriWinding
 		Order2 = Orders.Order2;
 	}
 
+	template <class TriangleMeshType>
+	void ComputeCoeffs(const TriangleMeshType& Mesh,
+					   const TSet<int>& TriangleSet,
+					   const FMeshTriInfoCache& TriCache,
+					   FVector3d& P,
+					   double& R,
+					   FVector3d& Order1,
+					   FMatrix3d& Order2,
+					   int NumTasks = 16)
+	{
+		if (TriangleSet.Num() < ComputeCoeffsParallelThreshold)
+		{
+			ComputeCoeffsSerial(Mesh, TriangleSet, TriCache, P, R, Order1, Order2);
+			return;
+		}
+
+		TArray<int> TriangleArray = TriangleSet.Array();
+		ComputeCoeffs(Mesh, TArrayView<const int>(TriangleArray), TriCache, P, R, Order1, Order2, NumTasks);
+	}
+
 
 
 
@@ -312,6 +332,12 @@ public:
 	 */
 	int FWNApproxOrder = 2;
 
+	/**
+	 * If true, the per-box expansion coefficients are computed in parallel, from a flattened triangle ordering of the tree
+	 * instead of the per-box triangle sets used by the serial build. Set before calling Build(), or construct with bAutoBuild = false.
+	 */
+	bool bParallelBuild = false;
+
 	TFastWindingTree(TMeshAABBTree3<TriangleMeshType>* TreeToRef, bool bAutoBuild = true)
 	{
 		SetTree(TreeToRef, bAutoBuild);
@@ -373,6 +399,19 @@ public:
 		return sum;
 	}
 
+	/**
+	 * Evaluate the fast winding number at each of Points, distributed over tasks if bParallel is true. Does not auto-build.
+	 */
+	void FastWindingNumbers(TArrayView<const FVector3d> Points, TArrayView<double> OutWindingNumbers, bool bParallel = true) const
+	{
+		checkSlow(IsBuilt());
+		check(OutWindingNumbers.Num() >= Points.Num());
+		ParallelFor(Points.Num(), [this, Points, OutWindingNumbers](int32 Index)
+		{
+			OutWindingNumbers[Index] = branch_fast_winding_num(Tree->RootIndex, Points[Index]);
+		}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
 	/**
 	 * @return true if fast winding number at point P is greater than winding threshold (default 0.5)
 	 */
@@ -459,6 +498,11 @@ private:
 		FMeshTriInfoCache TriCache = FMeshTriInfoCache::BuildTriInfoCache(*Tree->Mesh);
 
 		FastWindingCache.Empty(); // = TMap<int, FWNInfo>();
+		if (bParallelBuild)
+		{
+			build_fast_winding_cache_parallel(WINDING_CACHE_THRESH, TriCache);
+			return;
+		}
 		TOptional<TSet<int>> root_hash;
 		build_fast_winding_cache(Tree->RootIndex, 0, WINDING_CACHE_THRESH, root_hash, TriCache);
 	}
@@ -536,6 +580,92 @@ private:
 		}
 	}
 
+	// Builds the same cache as build_fast_winding_cache(). All Triangles below a box are contiguous in a depth-first
+	// ordering of the tree, so every cached box is a range of that ordering and the boxes can be computed independently.
+	void build_fast_winding_cache_parallel(int TriCountThresh, const FMeshTriInfoCache& TriCache)
+	{
+		TArray<int> OrderedTriangles;
+		OrderedTriangles.Reserve(Tree->Mesh->TriangleCount());
+		TArray<FIndex3i> CacheBoxes;		// (box, first triangle, triangle count)
+		collect_fast_winding_boxes(Tree->RootIndex, 0, TriCountThresh, OrderedTriangles, CacheBoxes);
+
+		TArray<FWNInfo> CacheInfos;
+		CacheInfos.SetNumUninitialized(CacheBoxes.Num());
+		auto ComputeBox = [this, &OrderedTriangles, &CacheBoxes, &CacheInfos, &TriCache](int32 Index, bool bParallelReduce)
+		{
+			const FIndex3i& CacheBox = CacheBoxes[Index];
+			TArrayView<const int> Triangles(OrderedTriangles.GetData() + CacheBox.B, CacheBox.C);
+			FWNInfo& Info = CacheInfos[Index];
+			if (bParallelReduce)
+			{
+				FastTriWinding::ComputeCoeffs(*Tree->Mesh, Triangles, TriCache, Info.Center, Info.R, Info.Order1Vec, Info.Order2Mat);
+			}
+			else
+			{
+				FastTriWinding::ComputeCoeffsSerial(*Tree->Mesh, Triangles, TriCache, Info.Center, Info.R, Info.Order1Vec, Info.Order2Mat);
+			}
+		};
+
+		// the few boxes near the root hold most of the triangles, they are reduced in parallel one at a time,
+		// while the many small boxes below them are distributed over tasks
+		TArray<int32> SmallBoxes;
+		SmallBoxes.Reserve(CacheBoxes.Num());
+		for (int32 Index = 0; Index < CacheBoxes.Num(); ++Index)
+		{
+			if (CacheBoxes[Index].C >= FastTriWinding::ComputeCoeffsParallelThreshold)
+			{
+				ComputeBox(Index, true);
+			}
+			else
+			{
+				SmallBoxes.Add(Index);
+			}
+		}
+		ParallelFor(SmallBoxes.Num(), [&SmallBoxes, &ComputeBox](int32 i)
+		{
+			ComputeBox(SmallBoxes[i], false);
+		});
+
+		FastWindingCache.Reserve(CacheBoxes.Num());
+		for (int32 Index = 0; Index < CacheBoxes.Num(); ++Index)
+		{
+			FastWindingCache.Add(CacheBoxes[Index].A, CacheInfos[Index]);
+		}
+	}
+
+	// append the Triangles below IBox to OrderedTriangles in depth-first order, and record the
+	// triangle range of each box that build_fast_winding_cache() would make a cache for
+	void collect_fast_winding_boxes(int IBox, int Depth, int TriCountThresh, TArray<int>& OrderedTriangles, TArray<FIndex3i>& CacheBoxes) const
+	{
+		const int FirstTriangle = OrderedTriangles.Num();
+		int idx = Tree->BoxToIndex[IBox];
+		if (idx < Tree->TrianglesEnd)
+		{ // triangle-list case, array is [N t1 t2 ... tN]
+			int num_tris = Tree->IndexList[idx];
+			for (int i = 1; i <= num_tris; ++i)
+			{
+				OrderedTriangles.Add(Tree->IndexList[idx + i]);
+			}
+			return;
+		}
+
+		int iChild1 = Tree->IndexList[idx];
+		if (iChild1 < 0)
+		{ // 1 child, never cached
+			collect_fast_winding_boxes((-iChild1) - 1, Depth + 1, TriCountThresh, OrderedTriangles, CacheBoxes);
+			return;
+		}
+
+		collect_fast_winding_boxes(iChild1 - 1, Depth + 1, TriCountThresh, OrderedTriangles, CacheBoxes);
+		collect_fast_winding_boxes(Tree->IndexList[idx + 1] - 1, Depth + 1, TriCountThresh, OrderedTriangles, CacheBoxes);
+
+		const int NumTriangles = OrderedTriangles.Num() - FirstTriangle;
+		if (Depth > 0 && NumTriangles > TriCountThresh)	// cannot build cache at level 0...
+		{
+			CacheBoxes.Add(FIndex3i(IBox, FirstTriangle, NumTriangles));
+		}
+	}
+
 	// check if value is in cache and far enough away from Q that we can use cached value
 	bool can_use_fast_winding_cache(int IBox, const FVector3d& Q) const
 	{
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
 #include "Util/DynamicVector.h"
 #include "Intersection/IntrRay3AxisAlignedBox3.h"
 #include "Intersection/IntrTriangle3Triangle3.h"
@@ -65,6 +67,26 @@ public:
 	using MeshType = TriangleMeshType;
 	using GetSplitAxisFunc = TUniqueFunction<int(int Depth, const FAxisAlignedBox3d& Box)>;
 
+	/** How the triangle set of a box is split into the two child boxes during the top-down build */
+	enum class ESplitMethod : uint8
+	{
+		/** Split at the midpoint of the triangle centroids, along the axis returned by the split axis function */
+		Midpoint,
+		/** Split at the cheapest bin boundary according to the surface area heuristic, over all three axes. The split axis function is not used. */
+		BinnedSAH
+	};
+
+	struct FBuildOptions
+	{
+		ESplitMethod SplitMethod = ESplitMethod::Midpoint;
+		/** Build independent subtrees on separate tasks. The split axis function must be safe to call concurrently if this is enabled. */
+		bool bParallel = false;
+		/** Meshes with fewer triangles than this are always built on the calling thread */
+		int32 MinParallelTriCount = 20000;
+		/** Number of centroid bins per axis evaluated by ESplitMethod::BinnedSAH, clamped to [2,64] */
+		int32 NumSAHBins = 16;
+	};
+
 protected:
 	const TriangleMeshType* Mesh;
 	uint64 MeshChangeStamp = 0;
@@ -80,6 +102,8 @@ protected:
 	
 	GetSplitAxisFunc GetSplitAxis = MakeDefaultSplitAxisFunc();
 
+	FBuildOptions BuildOptions;
+
 public:
 	static constexpr double DOUBLE_MAX = TNumericLimits<double>::Max();
 
@@ -133,6 +157,17 @@ public:
 		GetSplitAxis = MoveTemp(GetSplitAxisIn);
 	}
 
+	/** Set the split method and parallelism used by the next Build() */
+	void SetBuildOptions(const FBuildOptions& BuildOptionsIn)
+	{
+		BuildOptions = BuildOptionsIn;
+	}
+
+	const FBuildOptions& GetBuildOptions() const
+	{
+		return BuildOptions;
+	}
+
 	void Build()
 	{
 		BuildTopDown(false);
@@ -1162,6 +1197,377 @@ public:
 	}
 
 
+public:
+	/** Number of rays or points traced through the tree together by the packet queries */
+	static constexpr int32 QueryPacketSize = 4;
+
+	/**
+	 * Find the nearest hit triangle for a packet of up to QueryPacketSize rays. Each visited box is tested against all rays of the
+	 * packet at once with SIMD slab tests, and the packet descends into a box if any of its rays may still hit closer than its current nearest hit.
+	 * Returns the same hits as FindNearestHitTriangle for each ray (up to ties). Coherent rays, eg from neighbouring texels, share most of their traversal.
+	 * @param OutNearestT ray parameter of the nearest hit of each ray
+	 * @param OutTIDs nearest hit triangle of each ray, or InvalidID if the ray does not hit
+	 * @param OutBaryCoords optional, barycentric coordinates of the nearest hit of each ray
+	 */
+	void FindNearestHitTrianglePacket(
+		TArrayView<const FRay3d> Rays, TArrayView<double> OutNearestT, TArrayView<int> OutTIDs,
+		TArrayView<FVector3d> OutBaryCoords = TArrayView<FVector3d>(), const FQueryOptions& Options = FQueryOptions()) const
+	{
+		check(Rays.Num() <= QueryPacketSize && OutNearestT.Num() >= Rays.Num() && OutTIDs.Num() >= Rays.Num());
+		check(OutBaryCoords.Num() == 0 || OutBaryCoords.Num() >= Rays.Num());
+		if (Rays.Num() == 0)
+		{
+			return;
+		}
+
+		// see FindNearestHitTriangle for why this is not TNumericLimits<double>::Max()
+		const double MaxT = (Options.MaxDistance < TNumericLimits<float>::Max()) ? Options.MaxDistance : TNumericLimits<float>::Max();
+
+		FRayPacket Packet;
+		double NearestT[QueryPacketSize];
+		int TIDs[QueryPacketSize];
+		FVector3d BaryCoords[QueryPacketSize];
+		double Lanes[6][QueryPacketSize];
+		for (int32 Lane = 0; Lane < QueryPacketSize; ++Lane)
+		{
+			// unused lanes repeat the first ray with a negative NearestT, so they never pass a box test
+			const FRay3d& Ray = Rays[Lane < Rays.Num() ? Lane : 0];
+			Packet.Rays[Lane] = Ray;
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				// a huge finite inverse for axis-parallel rays keeps the slab test free of 0 * inf
+				const double Direction = Ray.Direction[Axis];
+				Lanes[Axis][Lane] = Ray.Origin[Axis];
+				Lanes[3 + Axis][Lane] = (Direction != 0.0) ? (1.0 / Direction) : DOUBLE_MAX;
+			}
+			NearestT[Lane] = (Lane < Rays.Num()) ? MaxT : -1.0;
+			TIDs[Lane] = IndexConstants::InvalidID;
+			BaryCoords[Lane] = FVector3d::Zero();
+		}
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Packet.Origin[Axis] = VectorLoad(Lanes[Axis]);
+			Packet.InvDirection[Axis] = VectorLoad(Lanes[3 + Axis]);
+		}
+
+		if (ensure(IsValid(Options.bAllowUnsafeModifiedMeshQueries)))
+		{
+			FindHitTrianglePacket(RootIndex, (1 << Rays.Num()) - 1, Packet, NearestT, TIDs, BaryCoords, Options);
+		}
+
+		for (int32 Lane = 0; Lane < Rays.Num(); ++Lane)
+		{
+			OutNearestT[Lane] = NearestT[Lane];
+			OutTIDs[Lane] = TIDs[Lane];
+			if (OutBaryCoords.Num() > 0)
+			{
+				OutBaryCoords[Lane] = BaryCoords[Lane];
+			}
+		}
+	}
+
+	/**
+	 * Find the triangles closest to a packet of up to QueryPacketSize points, testing each visited box against all points at once.
+	 * Returns the same triangles as FindNearestTriangle for each point (up to ties).
+	 * @param OutNearestDistSqr squared distance from each point to its nearest triangle
+	 * @param OutTIDs nearest triangle of each point, or InvalidID if none is within Options.MaxDistance
+	 */
+	void FindNearestTrianglePacket(
+		TArrayView<const FVector3d> Points, TArrayView<double> OutNearestDistSqr, TArrayView<int> OutTIDs,
+		const FQueryOptions& Options = FQueryOptions()) const
+	{
+		check(Points.Num() <= QueryPacketSize && OutNearestDistSqr.Num() >= Points.Num() && OutTIDs.Num() >= Points.Num());
+		if (Points.Num() == 0)
+		{
+			return;
+		}
+
+		const double MaxDistSqr = (Options.MaxDistance < DOUBLE_MAX) ? Options.MaxDistance * Options.MaxDistance : DOUBLE_MAX;
+
+		FPointPacket Packet;
+		double NearestDistSqr[QueryPacketSize];
+		int TIDs[QueryPacketSize];
+		double Lanes[3][QueryPacketSize];
+		for (int32 Lane = 0; Lane < QueryPacketSize; ++Lane)
+		{
+			// unused lanes repeat the first point with a negative distance, so they never pass a box test
+			const FVector3d& Point = Points[Lane < Points.Num() ? Lane : 0];
+			Packet.Points[Lane] = Point;
+			Lanes[0][Lane] = Point.X;
+			Lanes[1][Lane] = Point.Y;
+			Lanes[2][Lane] = Point.Z;
+			NearestDistSqr[Lane] = (Lane < Points.Num()) ? MaxDistSqr : -1.0;
+			TIDs[Lane] = IndexConstants::InvalidID;
+		}
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Packet.Position[Axis] = VectorLoad(Lanes[Axis]);
+		}
+
+		if (ensure(IsValid(Options.bAllowUnsafeModifiedMeshQueries)))
+		{
+			find_nearest_tri_packet(RootIndex, (1 << Points.Num()) - 1, Packet, NearestDistSqr, TIDs, Options);
+		}
+
+		for (int32 Lane = 0; Lane < Points.Num(); ++Lane)
+		{
+			OutNearestDistSqr[Lane] = NearestDistSqr[Lane];
+			OutTIDs[Lane] = TIDs[Lane];
+		}
+	}
+
+	/**
+	 * Find the nearest hit triangle of every ray, tracing packets of QueryPacketSize consecutive rays, distributed over tasks if bParallel is true.
+	 * Consecutive rays should be spatially coherent for the packets to be effective. Options.TriangleFilterF must be thread-safe if bParallel is true.
+	 */
+	void FindNearestHitTriangles(
+		TArrayView<const FRay3d> Rays, TArrayView<double> OutNearestT, TArrayView<int> OutTIDs,
+		const FQueryOptions& Options = FQueryOptions(), bool bParallel = true) const
+	{
+		check(OutNearestT.Num() >= Rays.Num() && OutTIDs.Num() >= Rays.Num());
+		const int32 NumPackets = FMath::DivideAndRoundUp(Rays.Num(), QueryPacketSize);
+		ParallelFor(NumPackets, [this, Rays, OutNearestT, OutTIDs, &Options](int32 PacketIndex)
+		{
+			const int32 First = PacketIndex * QueryPacketSize;
+			const int32 Num = FMath::Min(QueryPacketSize, Rays.Num() - First);
+			FindNearestHitTrianglePacket(Rays.Slice(First, Num), OutNearestT.Slice(First, Num), OutTIDs.Slice(First, Num), TArrayView<FVector3d>(), Options);
+		}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
+	/**
+	 * Find the nearest triangle of every point, querying packets of QueryPacketSize consecutive points, distributed over tasks if bParallel is true.
+	 * Consecutive points should be spatially coherent for the packets to be effective. Options.TriangleFilterF must be thread-safe if bParallel is true.
+	 */
+	void FindNearestTriangles(
+		TArrayView<const FVector3d> Points, TArrayView<double> OutNearestDistSqr, TArrayView<int> OutTIDs,
+		const FQueryOptions& Options = FQueryOptions(), bool bParallel = true) const
+	{
+		check(OutNearestDistSqr.Num() >= Points.Num() && OutTIDs.Num() >= Points.Num());
+		const int32 NumPackets = FMath::DivideAndRoundUp(Points.Num(), QueryPacketSize);
+		ParallelFor(NumPackets, [this, Points, OutNearestDistSqr, OutTIDs, &Options](int32 PacketIndex)
+		{
+			const int32 First = PacketIndex * QueryPacketSize;
+			const int32 Num = FMath::Min(QueryPacketSize, Points.Num() - First);
+			FindNearestTrianglePacket(Points.Slice(First, Num), OutNearestDistSqr.Slice(First, Num), OutTIDs.Slice(First, Num), Options);
+		}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
+protected:
+	struct FRayPacket
+	{
+		VectorRegister4Double Origin[3];
+		VectorRegister4Double InvDirection[3];
+		FRay3d Rays[QueryPacketSize];
+	};
+
+	struct FPointPacket
+	{
+		VectorRegister4Double Position[3];
+		FVector3d Points[QueryPacketSize];
+	};
+
+	// packet version of box_ray_intersect_t, returns the entry parameter of each ray or DOUBLE_MAX on miss
+	VectorRegister4Double box_ray_intersect_t_packet(int IBox, const FRayPacket& Packet) const
+	{
+		const FVector3d& c = BoxCenters[IBox];
+		FVector3d e = BoxExtents[IBox] + BoxEps;
+
+		VectorRegister4Double TNear = VectorZeroDouble();
+		VectorRegister4Double TFar = VectorSetFloat1(DOUBLE_MAX);
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const VectorRegister4Double T0 = VectorMultiply(VectorSubtract(VectorSetFloat1(c[Axis] - e[Axis]), Packet.Origin[Axis]), Packet.InvDirection[Axis]);
+			const VectorRegister4Double T1 = VectorMultiply(VectorSubtract(VectorSetFloat1(c[Axis] + e[Axis]), Packet.Origin[Axis]), Packet.InvDirection[Axis]);
+			TNear = VectorMax(TNear, VectorMin(T0, T1));
+			TFar = VectorMin(TFar, VectorMax(T0, T1));
+		}
+		return VectorSelect(VectorCompareLE(TNear, TFar), TNear, VectorSetFloat1(DOUBLE_MAX));
+	}
+
+	// packet version of BoxDistanceSqr
+	VectorRegister4Double BoxDistanceSqrPacket(int IBox, const FPointPacket& Packet) const
+	{
+		const FVector3d& c = BoxCenters[IBox];
+		const FVector3d& e = BoxExtents[IBox];
+
+		VectorRegister4Double DistSqr = VectorZeroDouble();
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const VectorRegister4Double Delta = VectorSubtract(VectorAbs(VectorSubtract(Packet.Position[Axis], VectorSetFloat1(c[Axis]))), VectorSetFloat1(e[Axis]));
+			const VectorRegister4Double Clamped = VectorMax(Delta, VectorZeroDouble());
+			DistSqr = VectorAdd(DistSqr, VectorMultiply(Clamped, Clamped));
+		}
+		return DistSqr;
+	}
+
+	// smallest lane of Values selected by LaneMask, or DOUBLE_MAX if LaneMask is empty
+	static double PacketMin(const VectorRegister4Double& Values, int32 LaneMask)
+	{
+		double Lanes[QueryPacketSize];
+		VectorStore(Values, Lanes);
+		double MinValue = DOUBLE_MAX;
+		for (int32 Lane = 0; Lane < QueryPacketSize; ++Lane)
+		{
+			if (LaneMask & (1 << Lane))
+			{
+				MinValue = FMath::Min(MinValue, Lanes[Lane]);
+			}
+		}
+		return MinValue;
+	}
+
+	// packet version of FindHitTriangle, LaneMask selects the rays that reached IBox
+	void FindHitTrianglePacket(
+		int IBox, int32 LaneMask, const FRayPacket& Packet, double* NearestT, int* TIDs, FVector3d* BaryCoords,
+		const FQueryOptions& Options) const
+	{
+		int idx = BoxToIndex[IBox];
+		if (idx < TrianglesEnd)
+		{ // triangle-list case, array is [N t1 t2 ... tN]
+			FTriangle3d Triangle;
+			int num_tris = IndexList[idx];
+			for (int i = 1; i <= num_tris; ++i)
+			{
+				int ti = IndexList[idx + i];
+				if (Options.TriangleFilterF != nullptr && Options.TriangleFilterF(ti) == false)
+				{
+					continue;
+				}
+
+				Mesh->GetTriVertices(ti, Triangle.V[0], Triangle.V[1], Triangle.V[2]);
+				for (int32 Lane = 0; Lane < QueryPacketSize; ++Lane)
+				{
+					if ((LaneMask & (1 << Lane)) == 0)
+					{
+						continue;
+					}
+					FIntrRay3Triangle3d Query = FIntrRay3Triangle3d(Packet.Rays[Lane], Triangle);
+					if (Query.Find() && Query.RayParameter < NearestT[Lane])
+					{
+						NearestT[Lane] = Query.RayParameter;
+						TIDs[Lane] = ti;
+						BaryCoords[Lane] = Query.TriangleBaryCoords;
+					}
+				}
+			}
+			return;
+		}
+
+		// internal node, either 1 or 2 child boxes
+		const VectorRegister4Double e = VectorSetFloat1(FMathd::ZeroTolerance);
+		auto GetHitMask = [&](const VectorRegister4Double& ChildT)
+		{
+			return LaneMask & VectorMaskBits(VectorCompareLE(ChildT, VectorAdd(VectorLoad(NearestT), e)));
+		};
+
+		int iChild1 = IndexList[idx];
+		if (iChild1 < 0)
+		{ // 1 child, descend if nearer than cur min-dist
+			iChild1 = (-iChild1) - 1;
+			const int32 ChildMask = GetHitMask(box_ray_intersect_t_packet(iChild1, Packet));
+			if (ChildMask)
+			{
+				FindHitTrianglePacket(iChild1, ChildMask, Packet, NearestT, TIDs, BaryCoords, Options);
+			}
+			return;
+		}
+
+		// 2 children, descend closest first
+		iChild1 = iChild1 - 1;
+		int iChild2 = IndexList[idx + 1] - 1;
+
+		const VectorRegister4Double Child1T = box_ray_intersect_t_packet(iChild1, Packet);
+		const VectorRegister4Double Child2T = box_ray_intersect_t_packet(iChild2, Packet);
+		const int32 Child1Mask = GetHitMask(Child1T);
+		const int32 Child2Mask = GetHitMask(Child2T);
+		const bool bChild1First = PacketMin(Child1T, Child1Mask) < PacketMin(Child2T, Child2Mask);
+		const int FirstChild = bChild1First ? iChild1 : iChild2;
+		const int SecondChild = bChild1First ? iChild2 : iChild1;
+		const int32 FirstMask = bChild1First ? Child1Mask : Child2Mask;
+		if (FirstMask)
+		{
+			FindHitTrianglePacket(FirstChild, FirstMask, Packet, NearestT, TIDs, BaryCoords, Options);
+		}
+		// NearestT may have been reduced by the first child
+		const int32 SecondMask = GetHitMask(bChild1First ? Child2T : Child1T);
+		if (SecondMask)
+		{
+			FindHitTrianglePacket(SecondChild, SecondMask, Packet, NearestT, TIDs, BaryCoords, Options);
+		}
+	}
+
+	// packet version of find_nearest_tri, LaneMask selects the points that reached IBox
+	void find_nearest_tri_packet(
+		int IBox, int32 LaneMask, const FPointPacket& Packet, double* NearestDistSqr, int* TIDs,
+		const FQueryOptions& Options) const
+	{
+		int idx = BoxToIndex[IBox];
+		if (idx < TrianglesEnd)
+		{ // triangle-list case, array is [N t1 t2 ... tN]
+			int num_tris = IndexList[idx];
+			for (int i = 1; i <= num_tris; ++i)
+			{
+				int ti = IndexList[idx + i];
+				if (Options.TriangleFilterF != nullptr && Options.TriangleFilterF(ti) == false)
+				{
+					continue;
+				}
+				for (int32 Lane = 0; Lane < QueryPacketSize; ++Lane)
+				{
+					if ((LaneMask & (1 << Lane)) == 0)
+					{
+						continue;
+					}
+					double fTriDistSqr = TMeshQueries<TriangleMeshType>::TriDistanceSqr(*Mesh, ti, Packet.Points[Lane]);
+					if (fTriDistSqr < NearestDistSqr[Lane])
+					{
+						NearestDistSqr[Lane] = fTriDistSqr;
+						TIDs[Lane] = ti;
+					}
+				}
+			}
+			return;
+		}
+
+		int iChild1 = IndexList[idx];
+		if (iChild1 < 0)
+		{ // 1 child, descend if nearer than cur min-dist
+			iChild1 = (-iChild1) - 1;
+			const int32 ChildMask = LaneMask & VectorMaskBits(VectorCompareLE(BoxDistanceSqrPacket(iChild1, Packet), VectorLoad(NearestDistSqr)));
+			if (ChildMask)
+			{
+				find_nearest_tri_packet(iChild1, ChildMask, Packet, NearestDistSqr, TIDs, Options);
+			}
+			return;
+		}
+
+		// 2 children, descend closest first
+		iChild1 = iChild1 - 1;
+		int iChild2 = IndexList[idx + 1] - 1;
+
+		const VectorRegister4Double Child1DistSqr = BoxDistanceSqrPacket(iChild1, Packet);
+		const VectorRegister4Double Child2DistSqr = BoxDistanceSqrPacket(iChild2, Packet);
+		auto GetNearerMask = [&](const VectorRegister4Double& ChildDistSqr)
+		{
+			return LaneMask & VectorMaskBits(VectorCompareLT(ChildDistSqr, VectorLoad(NearestDistSqr)));
+		};
+		const int32 Child1Mask = GetNearerMask(Child1DistSqr);
+		const int32 Child2Mask = GetNearerMask(Child2DistSqr);
+		const bool bChild1First = PacketMin(Child1DistSqr, Child1Mask) < PacketMin(Child2DistSqr, Child2Mask);
+		const int32 FirstMask = bChild1First ? Child1Mask : Child2Mask;
+		if (FirstMask)
+		{
+			find_nearest_tri_packet(bChild1First ? iChild1 : iChild2, FirstMask, Packet, NearestDistSqr, TIDs, Options);
+		}
+		// NearestDistSqr may have been reduced by the first child
+		const int32 SecondMask = GetNearerMask(bChild1First ? Child2DistSqr : Child1DistSqr);
+		if (SecondMask)
+		{
+			find_nearest_tri_packet(bChild1First ? iChild2 : iChild1, SecondMask, Packet, NearestDistSqr, TIDs, Options);
+		}
+	}
+
+
 	// storage for Box Nodes.
 	//   - BoxToIndex is a pointer into IndexList
 	//   - BoxCenters and BoxExtents are the Centers/extents of the bounding boxes
@@ -1271,9 +1677,30 @@ public:
 		FBoxesSet Tris;
 		FBoxesSet Nodes;
 		FAxisAlignedBox3d rootBox;
-		int rootnode =
+		int rootnode;
+		const bool bParallel = BuildOptions.bParallel && NumTriangles >= BuildOptions.MinParallelTriCount;
+		if (bParallel || BuildOptions.SplitMethod != ESplitMethod::Midpoint)
+		{
+			TArray<FAxisAlignedBox3d> TriBounds;
+			if (BuildOptions.SplitMethod == ESplitMethod::BinnedSAH)
+			{
+				TriBounds.SetNumUninitialized(NumTriangles);
+				ParallelFor(NumTriangles, [this, &Triangles, &TriBounds](int32 i)
+				{
+					TriBounds[i] = TMeshQueries<TriangleMeshType>::GetTriBounds(*Mesh, Triangles[i]);
+				}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+			}
+
+			FTriSetBuildData BuildData{ Triangles, Centers, TriBounds, BuildOptions.SplitMethod, TopDownLeafMaxTriCount };
+			rootnode = bParallel ?
+				SplitTriSetParallel(BuildData, NumTriangles, Tris, Nodes, rootBox) :
+				SplitTriSet(BuildData, 0, NumTriangles, 0, Tris, Nodes, rootBox);
+		}
+		else
+		{
 			//(bSorted) ? split_tri_set_sorted(Triangles, Centers, 0, NumTriangles, 0, TopDownLeafMaxTriCount, Tris, Nodes, out rootBox) :
-			SplitTriSetMidpoint(Triangles, Centers, 0, NumTriangles, 0, TopDownLeafMaxTriCount, Tris, Nodes, rootBox);
+			rootnode = SplitTriSetMidpoint(Triangles, Centers, 0, NumTriangles, 0, TopDownLeafMaxTriCount, Tris, Nodes, rootBox);
+		}
 
 		BoxToIndex = Tris.BoxToIndex;
 		BoxCenters = Tris.BoxCenters;
@@ -1344,6 +1771,36 @@ public:
 			return -(IBox + 1);
 		}
 
+		int n0 = PartitionTriSetMidpoint(Triangles, Centers, IStart, ICount, Depth, Box);
+		int n1 = ICount - n0;
+
+		// create child boxes
+		FAxisAlignedBox3d box1;
+		int child0 = SplitTriSetMidpoint(Triangles, Centers, IStart, n0, Depth + 1, MinTriCount, Tris, Nodes, Box);
+		int child1 = SplitTriSetMidpoint(Triangles, Centers, IStart + n0, n1, Depth + 1, MinTriCount, Tris, Nodes, box1);
+		Box.Contain(box1);
+
+		// append new Box
+		IBox = Nodes.IBoxCur++;
+		Nodes.BoxToIndex.InsertAt(Nodes.IIndicesCur, IBox);
+
+		Nodes.IndexList.InsertAt(child0, Nodes.IIndicesCur++);
+		Nodes.IndexList.InsertAt(child1, Nodes.IIndicesCur++);
+
+		Nodes.BoxCenters.InsertAt(Box.Center(), IBox);
+		Nodes.BoxExtents.InsertAt(Box.Extents(), IBox);
+
+		return IBox;
+	}
+
+
+	// re-sort the Centers & Triangles of [IStart, IStart+ICount) so that the Centers below the midpoint
+	// along the split axis come first, and return the number of Triangles in the first subset
+	int PartitionTriSetMidpoint(
+		TArray<int>& Triangles,
+		TArray<FVector3d>& Centers,
+		int IStart, int ICount, int Depth, const FAxisAlignedBox3d& Box) const
+	{
 		//compute interval along an axis and find midpoint
 		int axis = GetSplitAxis(Depth, Box);
 		FInterval1d interval = FInterval1d::Empty();
@@ -1353,59 +1810,209 @@ public:
 		}
 		double midpoint = interval.Center();
 
-		int n0, n1;
-		if (interval.Length() > FMathd::ZeroTolerance)
+		if (interval.Length() <= FMathd::ZeroTolerance)
+		{
+			// interval is near-empty, so no point trying to do sorting, just split half and half
+			return ICount / 2;
+		}
+
+		// we have to re-sort the Centers & Triangles lists so that Centers < midpoint
+		// are first, so that we can recurse on the two subsets. We walk in from each side,
+		// until we find two out-of-order locations, then we swap them.
+		int l = 0;
+		int r = ICount - 1;
+		while (l < r)
 		{
-			// we have to re-sort the Centers & Triangles lists so that Centers < midpoint
-			// are first, so that we can recurse on the two subsets. We walk in from each side,
-			// until we find two out-of-order locations, then we swap them.
-			int l = 0;
-			int r = ICount - 1;
-			while (l < r)
+			// TODO: is <= right here? if V.axis == midpoint, then this loop
+			//   can get stuck unless one of these has an equality test. But
+			//   I did not think enough about if this is the right thing to do...
+			while (Centers[IStart + l][axis] <= midpoint)
 			{
-				// TODO: is <= right here? if V.axis == midpoint, then this loop
-				//   can get stuck unless one of these has an equality test. But
-				//   I did not think enough about if this is the right thing to do...
-				while (Centers[IStart + l][axis] <= midpoint)
-				{
-					l++;
-				}
-				while (Centers[IStart + r][axis] > midpoint)
+				l++;
+			}
+			while (Centers[IStart + r][axis] > midpoint)
+			{
+				r--;
+			}
+			if (l >= r)
+			{
+				break; //done!
+					   //swap
+			}
+			FVector3d tmpc = Centers[IStart + l];
+			Centers[IStart + l] = Centers[IStart + r];
+			Centers[IStart + r] = tmpc;
+			int tmpt = Triangles[IStart + l];
+			Triangles[IStart + l] = Triangles[IStart + r];
+			Triangles[IStart + r] = tmpt;
+		}
+
+		checkSlow(l >= 1 && ICount - l >= 1);
+		return l;
+	}
+
+
+	// input arrays of the top-down build. TriBounds is only filled for ESplitMethod::BinnedSAH
+	struct FTriSetBuildData
+	{
+		TArray<int>& Triangles;
+		TArray<FVector3d>& Centers;
+		TArray<FAxisAlignedBox3d>& TriBounds;
+		ESplitMethod SplitMethod;
+		int MinTriCount;
+	};
+
+	int PartitionTriSet(FTriSetBuildData& Data, int IStart, int ICount, int Depth) const
+	{
+		if (Data.SplitMethod == ESplitMethod::BinnedSAH)
+		{
+			return PartitionTriSetBinnedSAH(Data, IStart, ICount);
+		}
+		return PartitionTriSetMidpoint(Data.Triangles, Data.Centers, IStart, ICount, Depth, FAxisAlignedBox3d::Empty());
+	}
+
+	// evaluate the surface area heuristic at the bin boundaries of the centroid bounds along each axis,
+	// and partition [IStart, IStart+ICount) at the cheapest one. Returns the number of Triangles in the first subset.
+	int PartitionTriSetBinnedSAH(FTriSetBuildData& Data, int IStart, int ICount) const
+	{
+		constexpr int MaxBins = 64;
+		const int NumBins = FMath::Clamp(BuildOptions.NumSAHBins, 2, MaxBins);
+
+		FAxisAlignedBox3d CentroidBox = FAxisAlignedBox3d::Empty();
+		for (int i = 0; i < ICount; ++i)
+		{
+			CentroidBox.Contain(Data.Centers[IStart + i]);
+		}
+
+		auto GetBin = [&CentroidBox, NumBins](const FVector3d& Center, int Axis)
+		{
+			const double Extent = CentroidBox.Max[Axis] - CentroidBox.Min[Axis];
+			const int Bin = (int)((Center[Axis] - CentroidBox.Min[Axis]) * ((double)NumBins / Extent));
+			return FMath::Clamp(Bin, 0, NumBins - 1);
+		};
+
+		int BestAxis = -1;
+		int BestSplit = -1;
+		double BestCost = DOUBLE_MAX;
+		for (int Axis = 0; Axis < 3; ++Axis)
+		{
+			if (CentroidBox.Max[Axis] - CentroidBox.Min[Axis] <= FMathd::ZeroTolerance)
+			{
+				continue;
+			}
+
+			FAxisAlignedBox3d BinBoxes[MaxBins];
+			int BinCounts[MaxBins] = {};
+			for (int i = 0; i < ICount; ++i)
+			{
+				const int Bin = GetBin(Data.Centers[IStart + i], Axis);
+				BinCounts[Bin]++;
+				BinBoxes[Bin].Contain(Data.TriBounds[IStart + i]);
+			}
+
+			// sweep from the right to get the cost of everything above each bin boundary
+			double RightCosts[MaxBins];
+			FAxisAlignedBox3d RightBox = FAxisAlignedBox3d::Empty();
+			int RightCount = 0;
+			for (int b = NumBins - 1; b > 0; --b)
+			{
+				RightBox.Contain(BinBoxes[b]);
+				RightCount += BinCounts[b];
+				RightCosts[b - 1] = RightBox.SurfaceArea() * RightCount;
+			}
+
+			FAxisAlignedBox3d LeftBox = FAxisAlignedBox3d::Empty();
+			int LeftCount = 0;
+			for (int b = 0; b < NumBins - 1; ++b)
+			{
+				LeftBox.Contain(BinBoxes[b]);
+				LeftCount += BinCounts[b];
+				if (LeftCount == 0 || LeftCount == ICount)
 				{
-					r--;
+					continue;
 				}
-				if (l >= r)
+				const double Cost = LeftBox.SurfaceArea() * LeftCount + RightCosts[b];
+				if (Cost < BestCost)
 				{
-					break; //done!
-						   //swap
+					BestCost = Cost;
+					BestAxis = Axis;
+					BestSplit = b;
 				}
-				FVector3d tmpc = Centers[IStart + l];
-				Centers[IStart + l] = Centers[IStart + r];
-				Centers[IStart + r] = tmpc;
-				int tmpt = Triangles[IStart + l];
-				Triangles[IStart + l] = Triangles[IStart + r];
-				Triangles[IStart + r] = tmpt;
 			}
+		}
 
-			n0 = l;
-			n1 = ICount - n0;
-			checkSlow(n0 >= 1 && n1 >= 1);
+		if (BestAxis < 0)
+		{
+			// all centroids coincide, just split half and half
+			return ICount / 2;
 		}
-		else
+
+		int Left = IStart;
+		int Right = IStart + ICount;
+		while (Left < Right)
 		{
-			// interval is near-empty, so no point trying to do sorting, just split half and half
-			n0 = ICount / 2;
-			n1 = ICount - n0;
+			if (GetBin(Data.Centers[Left], BestAxis) <= BestSplit)
+			{
+				++Left;
+			}
+			else
+			{
+				--Right;
+				Swap(Data.Centers[Left], Data.Centers[Right]);
+				Swap(Data.Triangles[Left], Data.Triangles[Right]);
+				Swap(Data.TriBounds[Left], Data.TriBounds[Right]);
+			}
+		}
+
+		checkSlow(Left > IStart && Left < IStart + ICount);
+		return Left - IStart;
+	}
+
+	// same as SplitTriSetMidpoint, but using the split method of Data
+	int SplitTriSet(
+		FTriSetBuildData& Data,
+		int IStart, int ICount, int Depth,
+		FBoxesSet& Tris, FBoxesSet& Nodes, FAxisAlignedBox3d& Box)
+	{
+		if (Data.SplitMethod == ESplitMethod::Midpoint)
+		{
+			return SplitTriSetMidpoint(Data.Triangles, Data.Centers, IStart, ICount, Depth, Data.MinTriCount, Tris, Nodes, Box);
 		}
 
+		Box = FAxisAlignedBox3d::Empty();
+		if (ICount <= Data.MinTriCount)
+		{
+			// append new Triangles Box
+			int IBox = Tris.IBoxCur++;
+			Tris.BoxToIndex.InsertAt(Tris.IIndicesCur, IBox);
+
+			Tris.IndexList.InsertAt(ICount, Tris.IIndicesCur++);
+			for (int i = 0; i < ICount; ++i)
+			{
+				Tris.IndexList.InsertAt(Data.Triangles[IStart + i], Tris.IIndicesCur++);
+				Box.Contain(Data.TriBounds[IStart + i]);
+			}
+			if (ICount == 0)
+			{
+				Box = FAxisAlignedBox3d(FVector3d::Zero(), 0.0);
+			}
+
+			Tris.BoxCenters.InsertAt(Box.Center(), IBox);
+			Tris.BoxExtents.InsertAt(Box.Extents(), IBox);
+
+			return -(IBox + 1);
+		}
+
+		int n0 = PartitionTriSet(Data, IStart, ICount, Depth);
+
 		// create child boxes
 		FAxisAlignedBox3d box1;
-		int child0 = SplitTriSetMidpoint(Triangles, Centers, IStart, n0, Depth + 1, MinTriCount, Tris, Nodes, Box);
-		int child1 = SplitTriSetMidpoint(Triangles, Centers, IStart + n0, n1, Depth + 1, MinTriCount, Tris, Nodes, box1);
+		int child0 = SplitTriSet(Data, IStart, n0, Depth + 1, Tris, Nodes, Box);
+		int child1 = SplitTriSet(Data, IStart + n0, ICount - n0, Depth + 1, Tris, Nodes, box1);
 		Box.Contain(box1);
 
 		// append new Box
-		IBox = Nodes.IBoxCur++;
+		int IBox = Nodes.IBoxCur++;
 		Nodes.BoxToIndex.InsertAt(Nodes.IIndicesCur, IBox);
 
 		Nodes.IndexList.InsertAt(child0, Nodes.IIndicesCur++);
@@ -1417,6 +2024,155 @@ public:
 		return IBox;
 	}
 
+	// a subtree built on its own task into separate box sets, merged into the final sets afterwards
+	struct FSubtreeBuild
+	{
+		int IStart = 0;
+		int ICount = 0;
+		int Depth = 0;
+		int Root = -1;
+		FAxisAlignedBox3d Box;
+		int TrisBoxOffset = 0;
+		int TrisIndexOffset = 0;
+		int NodesBoxOffset = 0;
+		int NodesIndexOffset = 0;
+	};
+
+	// partition the top levels of the tree until each subset is small enough to be a subtree task. Splits above the
+	// subtrees are appended to TopSplits in post-order. Returns the subtree index, or -(TopSplit index + 1).
+	int PlanSubtrees(FTriSetBuildData& Data, int IStart, int ICount, int Depth, int MaxSubtreeTriCount,
+		TArray<FSubtreeBuild>& Subtrees, TArray<FIndex2i>& TopSplits) const
+	{
+		if (ICount <= MaxSubtreeTriCount)
+		{
+			FSubtreeBuild& Subtree = Subtrees.AddDefaulted_GetRef();
+			Subtree.IStart = IStart;
+			Subtree.ICount = ICount;
+			Subtree.Depth = Depth;
+			return Subtrees.Num() - 1;
+		}
+
+		int n0 = PartitionTriSet(Data, IStart, ICount, Depth);
+		int Child0 = PlanSubtrees(Data, IStart, n0, Depth + 1, MaxSubtreeTriCount, Subtrees, TopSplits);
+		int Child1 = PlanSubtrees(Data, IStart + n0, ICount - n0, Depth + 1, MaxSubtreeTriCount, Subtrees, TopSplits);
+		TopSplits.Add(FIndex2i(Child0, Child1));
+		return -TopSplits.Num();
+	}
+
+	// build the tree with independent subtrees on separate tasks, producing the same Tris/Nodes layout as SplitTriSet
+	int SplitTriSetParallel(FTriSetBuildData& Data, int NumTriangles, FBoxesSet& Tris, FBoxesSet& Nodes, FAxisAlignedBox3d& Box)
+	{
+		const int NumSubtreeTasks = FMath::Max(1, 4 * FTaskGraphInterface::Get().GetNumWorkerThreads());
+		const int MaxSubtreeTriCount = FMath::Max(Data.MinTriCount, FMath::DivideAndRoundUp(NumTriangles, NumSubtreeTasks));
+
+		TArray<FSubtreeBuild> Subtrees;
+		TArray<FIndex2i> TopSplits;
+		const int RootRef = PlanSubtrees(Data, 0, NumTriangles, 0, MaxSubtreeTriCount, Subtrees, TopSplits);
+
+		TArray<FBoxesSet> SubtreeTris, SubtreeNodes;
+		SubtreeTris.SetNum(Subtrees.Num());
+		SubtreeNodes.SetNum(Subtrees.Num());
+		ParallelFor(Subtrees.Num(), [this, &Data, &Subtrees, &SubtreeTris, &SubtreeNodes](int32 SubtreeIndex)
+		{
+			FSubtreeBuild& Subtree = Subtrees[SubtreeIndex];
+			Subtree.Root = SplitTriSet(Data, Subtree.IStart, Subtree.ICount, Subtree.Depth,
+				SubtreeTris[SubtreeIndex], SubtreeNodes[SubtreeIndex], Subtree.Box);
+		});
+
+		// subtrees are concatenated in order, and the top splits are appended after all subtree nodes
+		for (int SubtreeIndex = 0; SubtreeIndex < Subtrees.Num(); ++SubtreeIndex)
+		{
+			FSubtreeBuild& Subtree = Subtrees[SubtreeIndex];
+			Subtree.TrisBoxOffset = Tris.IBoxCur;
+			Subtree.TrisIndexOffset = Tris.IIndicesCur;
+			Subtree.NodesBoxOffset = Nodes.IBoxCur;
+			Subtree.NodesIndexOffset = Nodes.IIndicesCur;
+			Tris.IBoxCur += SubtreeTris[SubtreeIndex].IBoxCur;
+			Tris.IIndicesCur += SubtreeTris[SubtreeIndex].IIndicesCur;
+			Nodes.IBoxCur += SubtreeNodes[SubtreeIndex].IBoxCur;
+			Nodes.IIndicesCur += SubtreeNodes[SubtreeIndex].IIndicesCur;
+		}
+		const int TopBoxOffset = Nodes.IBoxCur;
+		const int TopIndexOffset = Nodes.IIndicesCur;
+		Nodes.IBoxCur += TopSplits.Num();
+		Nodes.IIndicesCur += 2 * TopSplits.Num();
+
+		Tris.BoxToIndex.Resize(Tris.IBoxCur);
+		Tris.BoxCenters.Resize(Tris.IBoxCur);
+		Tris.BoxExtents.Resize(Tris.IBoxCur);
+		Tris.IndexList.Resize(Tris.IIndicesCur);
+		Nodes.BoxToIndex.Resize(Nodes.IBoxCur);
+		Nodes.BoxCenters.Resize(Nodes.IBoxCur);
+		Nodes.BoxExtents.Resize(Nodes.IBoxCur);
+		Nodes.IndexList.Resize(Nodes.IIndicesCur);
+
+		// child references are either -(triangles box + 1) or a node box index
+		auto RemapChild = [](const FSubtreeBuild& Subtree, int Child)
+		{
+			return (Child < 0) ? Child - Subtree.TrisBoxOffset : Child + Subtree.NodesBoxOffset;
+		};
+
+		ParallelFor(Subtrees.Num(), [&Subtrees, &SubtreeTris, &SubtreeNodes, &Tris, &Nodes, &RemapChild](int32 SubtreeIndex)
+		{
+			const FSubtreeBuild& Subtree = Subtrees[SubtreeIndex];
+			const FBoxesSet& LocalTris = SubtreeTris[SubtreeIndex];
+			for (int i = 0; i < LocalTris.IBoxCur; ++i)
+			{
+				Tris.BoxToIndex[Subtree.TrisBoxOffset + i] = LocalTris.BoxToIndex[i] + Subtree.TrisIndexOffset;
+				Tris.BoxCenters[Subtree.TrisBoxOffset + i] = LocalTris.BoxCenters[i];
+				Tris.BoxExtents[Subtree.TrisBoxOffset + i] = LocalTris.BoxExtents[i];
+			}
+			for (int i = 0; i < LocalTris.IIndicesCur; ++i)
+			{
+				Tris.IndexList[Subtree.TrisIndexOffset + i] = LocalTris.IndexList[i];
+			}
+
+			const FBoxesSet& LocalNodes = SubtreeNodes[SubtreeIndex];
+			for (int i = 0; i < LocalNodes.IBoxCur; ++i)
+			{
+				Nodes.BoxToIndex[Subtree.NodesBoxOffset + i] = LocalNodes.BoxToIndex[i] + Subtree.NodesIndexOffset;
+				Nodes.BoxCenters[Subtree.NodesBoxOffset + i] = LocalNodes.BoxCenters[i];
+				Nodes.BoxExtents[Subtree.NodesBoxOffset + i] = LocalNodes.BoxExtents[i];
+			}
+			for (int i = 0; i < LocalNodes.IIndicesCur; ++i)
+			{
+				Nodes.IndexList[Subtree.NodesIndexOffset + i] = RemapChild(Subtree, LocalNodes.IndexList[i]);
+			}
+		});
+
+		// TopSplits are in post-order, so children are always resolved before their parent
+		TArray<FAxisAlignedBox3d> TopBoxes;
+		TopBoxes.SetNum(TopSplits.Num());
+		auto ResolveRef = [&](int Ref, FAxisAlignedBox3d& RefBox)
+		{
+			if (Ref >= 0)
+			{
+				RefBox = Subtrees[Ref].Box;
+				return RemapChild(Subtrees[Ref], Subtrees[Ref].Root);
+			}
+			RefBox = TopBoxes[-(Ref + 1)];
+			return TopBoxOffset - (Ref + 1);
+		};
+		for (int TopIndex = 0; TopIndex < TopSplits.Num(); ++TopIndex)
+		{
+			FAxisAlignedBox3d Box0, Box1;
+			const int Child0 = ResolveRef(TopSplits[TopIndex].A, Box0);
+			const int Child1 = ResolveRef(TopSplits[TopIndex].B, Box1);
+			Box0.Contain(Box1);
+			TopBoxes[TopIndex] = Box0;
+
+			const int IBox = TopBoxOffset + TopIndex;
+			const int IIndex = TopIndexOffset + 2 * TopIndex;
+			Nodes.BoxToIndex[IBox] = IIndex;
+			Nodes.IndexList[IIndex] = Child0;
+			Nodes.IndexList[IIndex + 1] = Child1;
+			Nodes.BoxCenters[IBox] = Box0.Center();
+			Nodes.BoxExtents[IBox] = Box0.Extents();
+		}
+
+		return ResolveRef(RootRef, Box);
+	}
+
 
 	void find_nearest_triangles(
 		int iBox, TMeshAABBTree3& OtherTree, const TFunction<FVector3d(const FVector3d&)>& TransformF,
@@ -883,54 +883,6 @@ void FImage::TransformToWorkingColorSpace(const FVector2d& SourceRedChromaticity
 	return FImageCore::TransformToWorkingColorSpace(*this, SourceRedChromaticity, SourceGreenChromaticity, SourceBlueChromaticity, SourceWhiteChromaticity, Method, EqualityTolerance);
 }
 
-static FLinearColor SampleImage(const FLinearColor* Pixels, int Width, int Height, float X, float Y)
-{
-	const int64 TexelX0 = FMath::FloorToInt(X);
-	const int64 TexelY0 = FMath::FloorToInt(Y);
-	const int64 TexelX1 = FMath::Min<int64>(TexelX0 + 1, Width - 1);
-	const int64 TexelY1 = FMath::Min<int64>(TexelY0 + 1, Height - 1);
-	checkSlow(TexelX0 >= 0 && TexelX0 < Width);
-	checkSlow(TexelY0 >= 0 && TexelY0 < Height);
-
-	const float FracX1 = FMath::Frac(X);
-	const float FracY1 = FMath::Frac(Y);
-	const float FracX0 = 1.0f - FracX1;
-	const float FracY0 = 1.0f - FracY1;
-	const FLinearColor& Color00 = Pixels[TexelY0 * Width + TexelX0];
-	const FLinearColor& Color01 = Pixels[TexelY1 * Width + TexelX0];
-	const FLinearColor& Color10 = Pixels[TexelY0 * Width + TexelX1];
-	const FLinearColor& Color11 = Pixels[TexelY1 * Width + TexelX1];
-	return
-		Color00 * (FracX0 * FracY0) +
-		Color01 * (FracX0 * FracY1) +
-		Color10 * (FracX1 * FracY0) +
-		Color11 * (FracX1 * FracY1);
-}
-
-static void ResizeImage(const FImageView & SrcImage, const FImageView & DestImage)
-{
-	// Src and Dest should both now be RGBA32F and Linear gamma
-	check( SrcImage.Format == ERawImageFormat::RGBA32F );
-	check( DestImage.Format == ERawImageFormat::RGBA32F );
-	const FLinearColor* SrcPixels = (const FLinearColor*) SrcImage.RawData;
-	FLinearColor* DestPixels = (FLinearColor*) DestImage.RawData;
-	const float DestToSrcScaleX = (float)SrcImage.SizeX / (float)DestImage.SizeX;
-	const float DestToSrcScaleY = (float)SrcImage.SizeY / (float)DestImage.SizeY;
-
-	// @todo OodleImageResize : not a correct bilinear Resize?  missing 0.5 pixel center shift
-	//		deprecate this and redirect to new resizer
-	for (int64 DestY = 0; DestY < DestImage.SizeY; ++DestY)
-	{
-		const float SrcY = (float)DestY * DestToSrcScaleY;
-		for (int64 DestX = 0; DestX < DestImage.SizeX; ++DestX)
-		{
-			const float SrcX = (float)DestX * DestToSrcScaleX;
-			const FLinearColor Color = SampleImage(SrcPixels, SrcImage.SizeX, SrcImage.SizeY, SrcX, SrcY);
-			DestPixels[DestY * DestImage.SizeX + DestX] = Color;
-		}
-	}
-}
-
 /* FImage constructors
  *****************************************************************************/
  
@@ -1034,63 +986,38 @@ void FImageView::CopyTo(FImage& DestImage, ERawImageFormat::Type DestFormat, EGa
 	FImageCore::CopyImage(*this, DestImage);
 }
 
-void FImage::ResizeTo(FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace) const
+void FImage::ResizeTo(FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace, FImageCore::EResizeImageFilter Filter) const
 {
-	FImageCore::ResizeTo(*this,DestImage,DestSizeX,DestSizeY,DestFormat,DestGammaSpace);
+	FImageCore::ResizeTo(*this,DestImage,DestSizeX,DestSizeY,DestFormat,DestGammaSpace,Filter);
 }
 
-void FImageCore::ResizeTo(const FImageView & SourceImage,FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace)
+void FImageCore::ResizeTo(const FImageView & SourceImage,FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace, EResizeImageFilter Filter)
 {
 	check(SourceImage.NumSlices == 1); // only support 1 slice for now
 
-	FImage TempSrcImage;
-	FImageView SrcImageView = SourceImage;
-	if (SourceImage.Format != ERawImageFormat::RGBA32F)
-	{
-		SourceImage.CopyTo(TempSrcImage, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
-		SrcImageView = TempSrcImage;
-	}
-	else if ( SourceImage.GammaSpace != EGammaSpace::Linear )
+	// RGBA32F pixels are filtered as they are, whatever their GammaSpace says
+	if ( SourceImage.Format == ERawImageFormat::RGBA32F && SourceImage.GammaSpace != EGammaSpace::Linear )
 	{
 		UE_LOG(LogImageCore, Warning, TEXT("Resize from source Format RGBA32F was called but source GammaSpace is not Linear"));
 	}
 
-	// now SrcImagePtr should be RGBA32F and Linear
-
 	if (DestFormat == ERawImageFormat::RGBA32F)
 	{
 		if ( DestGammaSpace != EGammaSpace::Linear )
 		{
 			UE_LOG(LogImageCore, Warning, TEXT("Resize to DestFormat RGBA32F was called but DestGammaSpace is not Linear"));
 		}
-
-		DestImage.SizeX = DestSizeX;
-		DestImage.SizeY = DestSizeY;
-		DestImage.NumSlices = 1;
-		DestImage.Format = DestFormat;
-		DestImage.GammaSpace = DestGammaSpace;
-		InitImageStorage(DestImage);
-		ResizeImage(SrcImageView, DestImage);
 	}
-	else
+	else if ( DestGammaSpace == EGammaSpace::Pow22 )
 	{
-		// first resize from RGBA32F to RGBA32F
-		FImage TempDestImage;
-		TempDestImage.SizeX = DestSizeX;
-		TempDestImage.SizeY = DestSizeY;
-		TempDestImage.NumSlices = 1;
-		TempDestImage.Format = ERawImageFormat::RGBA32F;
-		TempDestImage.GammaSpace = EGammaSpace::Linear;
-		InitImageStorage(TempDestImage);
-		ResizeImage(SrcImageView, TempDestImage);
-
-		// then convert to dest format/gamma :
-		if ( DestGammaSpace == EGammaSpace::Pow22 )
-		{
-			UE_LOG(LogImageCore, Warning, TEXT("Resize incorrectly used with Pow22 Dest Gamma"));
-		}
-		TempDestImage.CopyTo(DestImage, DestFormat, DestGammaSpace);
+		// encoding from linear is always to sRGB, same as CopyTo
+		UE_LOG(LogImageCore, Warning, TEXT("Resize incorrectly used with Pow22 Dest Gamma"));
+		DestGammaSpace = EGammaSpace::sRGB;
 	}
+
+	// existing contents of DestImage are freed and replaced
+	DestImage.Init(DestSizeX,DestSizeY,1,DestFormat,DestGammaSpace);
+	ResizeImage(SourceImage, DestImage, Filter);
 }
 
 IMAGECORE_API FImageView FImageView::GetSlice(int32 SliceIndex) const
@@ -0,0 +1,598 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ImageCore.h"
+#include "ImageParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Math/VectorRegister.h"
+#include "Misc/Parse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogImageResize, Log, All);
+
+/**
+
+ResizeImage is a separable two pass resampler :
+
+pass 1 filters every needed source row horizontally into a RGBA32F temp image of DestSizeX * SrcSizeY
+pass 2 filters the temp image vertically into each dest row
+
+each dest pixel along an axis is a weighted sum of consecutive source pixels;
+the weights are computed once per axis ("polyphase" table) instead of per pixel.
+Source rows are decoded to linear float one at a time and dest rows are encoded one at a time,
+so neither image is ever converted to float as a whole.
+
+EResizeImageFilter::Legacy is the exception : it keeps the 2D bilinear loop ResizeTo always used, see ResizeImageLegacy.
+
+*/
+
+namespace UE::ImageResize
+{
+
+/**
+ * Filter weights of one axis : dest pixel I is the sum of NumTaps[I] source pixels starting at First[I]
+ * weights are stored with a stride of MaxTaps
+ */
+struct FFilterTable
+{
+	TArray<int32> First;
+	TArray<int32> NumTaps;
+	TArray<float> Weights;
+	int32 MaxTaps = 0;
+	// same size and no filtering needed, dest pixel I is source pixel I
+	bool bIdentity = false;
+
+	FORCEINLINE const float * GetWeights(int32 DestIndex) const
+	{
+		return &Weights[(int64)DestIndex * MaxTaps];
+	}
+};
+
+// radius of the filter in source pixels when not downsampling
+static double GetFilterRadius(EResizeImageFilter Filter)
+{
+	switch (Filter)
+	{
+	case EResizeImageFilter::Box:		return 0.5;
+	case EResizeImageFilter::Triangle:	return 1.0;
+	case EResizeImageFilter::Mitchell:	return 2.0;
+	case EResizeImageFilter::Lanczos:	return 3.0;
+	default:
+		check(0);
+		return 1.0;
+	}
+}
+
+static double EvaluateFilter(EResizeImageFilter Filter, double X)
+{
+	X = FMath::Abs(X);
+
+	switch (Filter)
+	{
+	case EResizeImageFilter::Box:
+		return (X <= 0.5) ? 1.0 : 0.0;
+
+	case EResizeImageFilter::Triangle:
+		return FMath::Max(1.0 - X, 0.0);
+
+	case EResizeImageFilter::Mitchell:
+		// Mitchell-Netravali cubic with B = C = 1/3
+		if (X < 1.0)
+		{
+			return (7.0 * X * X * X - 12.0 * X * X + 16.0 / 3.0) / 6.0;
+		}
+		else if (X < 2.0)
+		{
+			return (-7.0 / 3.0 * X * X * X + 12.0 * X * X - 20.0 * X + 32.0 / 3.0) / 6.0;
+		}
+		return 0.0;
+
+	case EResizeImageFilter::Lanczos:
+		if (X < UE_DOUBLE_SMALL_NUMBER)
+		{
+			return 1.0;
+		}
+		else if (X < 3.0)
+		{
+			const double PiX = UE_DOUBLE_PI * X;
+			return 3.0 * FMath::Sin(PiX) * FMath::Sin(PiX / 3.0) / (PiX * PiX);
+		}
+		return 0.0;
+
+	default:
+		check(0);
+		return 0.0;
+	}
+}
+
+// drop zero weights at both ends of a dest pixel's taps
+static void TrimTaps(FFilterTable & Table, int32 DestIndex)
+{
+	float * Weights = &Table.Weights[(int64)DestIndex * Table.MaxTaps];
+	int32 & NumTaps = Table.NumTaps[DestIndex];
+
+	while (NumTaps > 1 && Weights[NumTaps - 1] == 0.f)
+	{
+		--NumTaps;
+	}
+
+	int32 NumLeading = 0;
+	while (NumLeading < NumTaps - 1 && Weights[NumLeading] == 0.f)
+	{
+		++NumLeading;
+	}
+
+	if (NumLeading > 0)
+	{
+		NumTaps -= NumLeading;
+		FMemory::Memmove(Weights, Weights + NumLeading, NumTaps * sizeof(float));
+		Table.First[DestIndex] += NumLeading;
+	}
+}
+
+static void BuildFilterTable(FFilterTable & Table, int32 SrcSize, int32 DestSize, EResizeImageFilter Filter)
+{
+	check(SrcSize > 0 && DestSize > 0);
+	// Legacy is not separable, see ResizeImageLegacy
+	check(Filter != EResizeImageFilter::Legacy);
+
+	if (SrcSize == DestSize)
+	{
+		// every filter leaves pixel centers in place when the size does not change
+		// (Mitchell would still blur slightly, which is not what anyone wants from a same size resize)
+		Table.bIdentity = true;
+		return;
+	}
+
+	Table.First.SetNumUninitialized(DestSize);
+	Table.NumTaps.SetNumUninitialized(DestSize);
+
+	// sample at pixel centers, widen the filter by the downsampling factor so every source pixel is covered
+	const double DestToSrcScale = (double)SrcSize / (double)DestSize;
+	const double FilterScale = FMath::Max(DestToSrcScale, 1.0);
+	const double Support = GetFilterRadius(Filter) * FilterScale;
+
+	Table.MaxTaps = FMath::Min(FMath::CeilToInt32(Support * 2.0) + 1, SrcSize);
+	Table.Weights.SetNumZeroed((int64)DestSize * Table.MaxTaps);
+
+	for (int32 DestIndex = 0; DestIndex < DestSize; ++DestIndex)
+	{
+		const double Center = (DestIndex + 0.5) * DestToSrcScale - 0.5;
+		const int32 Lo = FMath::CeilToInt32(Center - Support);
+		const int32 Hi = FMath::FloorToInt32(Center + Support);
+		const int32 First = FMath::Clamp(Lo, 0, SrcSize - 1);
+		const int32 Last = FMath::Clamp(Hi, 0, SrcSize - 1);
+		check(Last - First < Table.MaxTaps);
+
+		float * Weights = &Table.Weights[(int64)DestIndex * Table.MaxTaps];
+		Table.First[DestIndex] = First;
+		Table.NumTaps[DestIndex] = Last - First + 1;
+
+		// taps past the edges are clamped, which adds their weight to the edge pixels
+		double WeightSum = 0.0;
+		for (int32 Tap = Lo; Tap <= Hi; ++Tap)
+		{
+			const double Weight = EvaluateFilter(Filter, (Tap - Center) / FilterScale);
+			Weights[FMath::Clamp(Tap, 0, SrcSize - 1) - First] += (float)Weight;
+			WeightSum += Weight;
+		}
+
+		if (FMath::Abs(WeightSum) > UE_DOUBLE_SMALL_NUMBER)
+		{
+			const float InvWeightSum = (float)(1.0 / WeightSum);
+			for (int32 Tap = 0; Tap < Table.NumTaps[DestIndex]; ++Tap)
+			{
+				Weights[Tap] *= InvWeightSum;
+			}
+		}
+		else
+		{
+			// can't happen with the filters above, but never output black for a degenerate sum
+			Table.First[DestIndex] = FMath::Clamp(FMath::RoundToInt32(Center), 0, SrcSize - 1);
+			Table.NumTaps[DestIndex] = 1;
+			Weights[0] = 1.f;
+		}
+
+		TrimTaps(Table, DestIndex);
+	}
+}
+
+static FImageView GetRow(const FImageView & Image, int32 Y)
+{
+	FImageView Row = Image;
+	Row.SizeY = 1;
+	Row.NumSlices = 1;
+	Row.RawData = Image.GetPixelPointer(0, Y);
+	return Row;
+}
+
+// index of the first row of a part made by ImageParallelFor
+static int32 GetPartStartRow(const FImageView & Part, const FImageView & Whole)
+{
+	const int64 RowBytes = Whole.SizeX * Whole.GetBytesPerPixel();
+	return (int32)(((const uint8 *)Part.RawData - (const uint8 *)Whole.RawData) / RowBytes);
+}
+
+// returns the pixels of source row Y as linear float, decoding them into RowBuffer if needed
+static const FLinearColor * GetLinearRow(const FImageView & Image, int32 Y, TArray<FLinearColor> & RowBuffer)
+{
+	const FImageView Row = GetRow(Image, Y);
+	if (Image.Format == ERawImageFormat::RGBA32F)
+	{
+		// RGBA32F is filtered as is, like ResizeTo always did
+		return (const FLinearColor *)Row.RawData;
+	}
+
+	FImageCore::CopyImage(Row, FImageView(RowBuffer.GetData(), Image.SizeX, 1));
+	return RowBuffer.GetData();
+}
+
+static void FilterRowHorizontal(FLinearColor * Out, const FLinearColor * In, const FFilterTable & Table, int32 DestSize)
+{
+	for (int32 DestX = 0; DestX < DestSize; ++DestX)
+	{
+		const float * Weights = Table.GetWeights(DestX);
+		const FLinearColor * Taps = In + Table.First[DestX];
+		const int32 NumTaps = Table.NumTaps[DestX];
+
+		VectorRegister4Float Sum = VectorMultiply(VectorLoad(&Taps[0].Component(0)), VectorSetFloat1(Weights[0]));
+		for (int32 Tap = 1; Tap < NumTaps; ++Tap)
+		{
+			Sum = VectorMultiplyAdd(VectorLoad(&Taps[Tap].Component(0)), VectorSetFloat1(Weights[Tap]), Sum);
+		}
+		VectorStore(Sum, &Out[DestX].Component(0));
+	}
+}
+
+// Temp is RGBA32F, Out gets the weighted sum of NumTaps consecutive rows of it starting at FirstRow
+static void FilterRowVertical(FLinearColor * Out, const FImageView & Temp, int32 FirstRow, int32 NumTaps, const float * Weights)
+{
+	const int64 SizeX = Temp.SizeX;
+	const FLinearColor * Rows = (const FLinearColor *)Temp.RawData + FirstRow * SizeX;
+
+	// row by row so all loads are sequential
+	const VectorRegister4Float FirstWeight = VectorSetFloat1(Weights[0]);
+	for (int64 X = 0; X < SizeX; ++X)
+	{
+		VectorStore(VectorMultiply(VectorLoad(&Rows[X].Component(0)), FirstWeight), &Out[X].Component(0));
+	}
+
+	for (int32 Tap = 1; Tap < NumTaps; ++Tap)
+	{
+		const FLinearColor * Row = Rows + Tap * SizeX;
+		const VectorRegister4Float Weight = VectorSetFloat1(Weights[Tap]);
+		for (int64 X = 0; X < SizeX; ++X)
+		{
+			VectorStore(VectorMultiplyAdd(VectorLoad(&Row[X].Component(0)), Weight, VectorLoad(&Out[X].Component(0))), &Out[X].Component(0));
+		}
+	}
+}
+
+/**
+ * The historical ResizeTo sampling : bilinear at SrcX = DestX * Scale with no pixel center shift, the next pixel clamped to the edge.
+ * This is the exact 2D loop ResizeTo always ran, same float math in the same order, so Legacy results are bit-exact with
+ * derived data built before the separable resizer existed. It only runs over dest rows in parallel and decodes source rows on demand.
+ */
+static void ResizeImageLegacy(const FImageView & SrcImage, const FImageView & DestImage)
+{
+	const float DestToSrcScaleX = (float)SrcImage.SizeX / (float)DestImage.SizeX;
+	const float DestToSrcScaleY = (float)SrcImage.SizeY / (float)DestImage.SizeY;
+	const bool bDestIsLinearFloat = DestImage.Format == ERawImageFormat::RGBA32F;
+
+	ImageParallelFor( TEXT("Texture.ResizeImage.Legacy.PF"), DestImage, [&](const FImageView & Part)
+	{
+		TArray<FLinearColor> RowBuffer0;
+		TArray<FLinearColor> RowBuffer1;
+		TArray<FLinearColor> DestBuffer;
+		if ( SrcImage.Format != ERawImageFormat::RGBA32F )
+		{
+			RowBuffer0.SetNumUninitialized(SrcImage.SizeX);
+			RowBuffer1.SetNumUninitialized(SrcImage.SizeX);
+		}
+		if ( ! bDestIsLinearFloat )
+		{
+			DestBuffer.SetNumUninitialized(DestImage.SizeX);
+		}
+
+		const int32 StartY = GetPartStartRow(Part, DestImage);
+		for (int32 DestY = StartY; DestY < StartY + Part.SizeY; ++DestY)
+		{
+			const float SrcY = (float)DestY * DestToSrcScaleY;
+			const int32 TexelY0 = FMath::FloorToInt(SrcY);
+			const int32 TexelY1 = FMath::Min(TexelY0 + 1, SrcImage.SizeY - 1);
+			const float FracY1 = FMath::Frac(SrcY);
+			const float FracY0 = 1.0f - FracY1;
+			const FLinearColor * Row0 = GetLinearRow(SrcImage, TexelY0, RowBuffer0);
+			const FLinearColor * Row1 = GetLinearRow(SrcImage, TexelY1, RowBuffer1);
+
+			const FImageView DestRow = GetRow(DestImage, DestY);
+			FLinearColor * LinearRow = bDestIsLinearFloat ? (FLinearColor *)DestRow.RawData : DestBuffer.GetData();
+			for (int32 DestX = 0; DestX < DestImage.SizeX; ++DestX)
+			{
+				const float SrcX = (float)DestX * DestToSrcScaleX;
+				const int32 TexelX0 = FMath::FloorToInt(SrcX);
+				const int32 TexelX1 = FMath::Min(TexelX0 + 1, SrcImage.SizeX - 1);
+				const float FracX1 = FMath::Frac(SrcX);
+				const float FracX0 = 1.0f - FracX1;
+				LinearRow[DestX] =
+					Row0[TexelX0] * (FracX0 * FracY0) +
+					Row1[TexelX0] * (FracX0 * FracY1) +
+					Row0[TexelX1] * (FracX1 * FracY0) +
+					Row1[TexelX1] * (FracX1 * FracY1);
+			}
+
+			if ( ! bDestIsLinearFloat )
+			{
+				CopyImage(FImageView(LinearRow, DestImage.SizeX, 1), DestRow);
+			}
+		}
+	});
+}
+
+} // namespace UE::ImageResize
+
+IMAGECORE_API void FImageCore::ResizeImage(const FImageView & SrcImage,const FImageView & DestImage, EResizeImageFilter Filter)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Texture.ResizeImage);
+	using namespace UE::ImageResize;
+
+	check( SrcImage.NumSlices == 1 && DestImage.NumSlices == 1 );
+	check( SrcImage.SizeX > 0 && SrcImage.SizeY > 0 && DestImage.SizeX > 0 && DestImage.SizeY > 0 );
+	check( SrcImage.RawData != nullptr && DestImage.RawData != nullptr );
+
+	if ( Filter == EResizeImageFilter::Legacy )
+	{
+		ResizeImageLegacy(SrcImage, DestImage);
+		return;
+	}
+
+	FFilterTable TableX;
+	FFilterTable TableY;
+	BuildFilterTable(TableX, SrcImage.SizeX, DestImage.SizeX, Filter);
+	BuildFilterTable(TableY, SrcImage.SizeY, DestImage.SizeY, Filter);
+
+	if ( TableX.bIdentity && TableY.bIdentity && SrcImage.Format != ERawImageFormat::RGBA32F )
+	{
+		// just a format change
+		CopyImage(SrcImage, DestImage);
+		return;
+	}
+
+	// pass 1 : horizontal, into Temp = DestSizeX * SrcSizeY RGBA32F
+	FImage TempImage;
+	FImageView Temp;
+	if ( TableX.bIdentity && SrcImage.Format == ERawImageFormat::RGBA32F )
+	{
+		Temp = SrcImage;
+	}
+	else
+	{
+		TempImage.Init(DestImage.SizeX, SrcImage.SizeY, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+		Temp = TempImage;
+
+		// source rows the vertical pass never reads are skipped
+		TBitArray<> RowIsUsed(TableY.bIdentity, SrcImage.SizeY);
+		if ( ! TableY.bIdentity )
+		{
+			for (int32 DestY = 0; DestY < DestImage.SizeY; ++DestY)
+			{
+				RowIsUsed.SetRange(TableY.First[DestY], TableY.NumTaps[DestY], true);
+			}
+		}
+
+		ImageParallelFor( TEXT("Texture.ResizeImage.Horizontal.PF"), Temp, [&](const FImageView & Part)
+		{
+			TArray<FLinearColor> RowBuffer;
+			RowBuffer.SetNumUninitialized(SrcImage.SizeX);
+
+			const int32 StartY = GetPartStartRow(Part, Temp);
+			for (int32 Y = StartY; Y < StartY + Part.SizeY; ++Y)
+			{
+				if ( ! RowIsUsed[Y] )
+				{
+					continue;
+				}
+
+				FLinearColor * TempRow = (FLinearColor *)Temp.GetPixelPointer(0, Y);
+				if ( TableX.bIdentity )
+				{
+					CopyImage(GetRow(SrcImage, Y), FImageView(TempRow, Temp.SizeX, 1));
+				}
+				else
+				{
+					FilterRowHorizontal(TempRow, GetLinearRow(SrcImage, Y, RowBuffer), TableX, DestImage.SizeX);
+				}
+			}
+		});
+	}
+
+	// pass 2 : vertical, then encode to the dest format
+	const bool bDestIsLinearFloat = DestImage.Format == ERawImageFormat::RGBA32F;
+	ImageParallelFor( TEXT("Texture.ResizeImage.Vertical.PF"), DestImage, [&](const FImageView & Part)
+	{
+		TArray<FLinearColor> RowBuffer;
+		if ( ! bDestIsLinearFloat )
+		{
+			RowBuffer.SetNumUninitialized(DestImage.SizeX);
+		}
+
+		const int32 StartY = GetPartStartRow(Part, DestImage);
+		for (int32 Y = StartY; Y < StartY + Part.SizeY; ++Y)
+		{
+			const FImageView DestRow = GetRow(DestImage, Y);
+			FLinearColor * LinearRow = bDestIsLinearFloat ? (FLinearColor *)DestRow.RawData : RowBuffer.GetData();
+
+			if ( TableY.bIdentity )
+			{
+				FMemory::Memcpy(LinearRow, Temp.GetPixelPointer(0, Y), DestImage.SizeX * sizeof(FLinearColor));
+			}
+			else
+			{
+				FilterRowVertical(LinearRow, Temp, TableY.First[Y], TableY.NumTaps[Y], TableY.GetWeights(Y));
+			}
+
+			if ( ! bDestIsLinearFloat )
+			{
+				CopyImage(FImageView(LinearRow, DestImage.SizeX, 1), DestRow);
+			}
+		}
+	});
+}
+
+/**
+
+ImageCore.ResizeBenchmark : compare ResizeImage with the path ResizeTo used before it,
+which converted the whole source to RGBA32F, point sampled a bilinear per dest pixel on one thread, then converted the whole result
+
+*/
+
+namespace UE::ImageResize
+{
+
+static FLinearColor ReferenceSampleImage(const FLinearColor* Pixels, int Width, int Height, float X, float Y)
+{
+	const int64 TexelX0 = FMath::FloorToInt(X);
+	const int64 TexelY0 = FMath::FloorToInt(Y);
+	const int64 TexelX1 = FMath::Min<int64>(TexelX0 + 1, Width - 1);
+	const int64 TexelY1 = FMath::Min<int64>(TexelY0 + 1, Height - 1);
+
+	const float FracX1 = FMath::Frac(X);
+	const float FracY1 = FMath::Frac(Y);
+	const float FracX0 = 1.0f - FracX1;
+	const float FracY0 = 1.0f - FracY1;
+	const FLinearColor& Color00 = Pixels[TexelY0 * Width + TexelX0];
+	const FLinearColor& Color01 = Pixels[TexelY1 * Width + TexelX0];
+	const FLinearColor& Color10 = Pixels[TexelY0 * Width + TexelX1];
+	const FLinearColor& Color11 = Pixels[TexelY1 * Width + TexelX1];
+	return
+		Color00 * (FracX0 * FracY0) +
+		Color01 * (FracX0 * FracY1) +
+		Color10 * (FracX1 * FracY0) +
+		Color11 * (FracX1 * FracY1);
+}
+
+static void ReferenceResizeTo(const FImageView & SrcImage, FImage & DestImage, int32 DestSizeX, int32 DestSizeY)
+{
+	FImage LinearSrc;
+	SrcImage.CopyTo(LinearSrc, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+
+	FImage LinearDest(DestSizeX, DestSizeY, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+	const FLinearColor* SrcPixels = (const FLinearColor*) LinearSrc.RawData.GetData();
+	FLinearColor* DestPixels = (FLinearColor*) LinearDest.RawData.GetData();
+	const float DestToSrcScaleX = (float)SrcImage.SizeX / (float)DestSizeX;
+	const float DestToSrcScaleY = (float)SrcImage.SizeY / (float)DestSizeY;
+	for (int64 DestY = 0; DestY < DestSizeY; ++DestY)
+	{
+		const float SrcY = (float)DestY * DestToSrcScaleY;
+		for (int64 DestX = 0; DestX < DestSizeX; ++DestX)
+		{
+			const float SrcX = (float)DestX * DestToSrcScaleX;
+			DestPixels[DestY * DestSizeX + DestX] = ReferenceSampleImage(SrcPixels, SrcImage.SizeX, SrcImage.SizeY, SrcX, SrcY);
+		}
+	}
+
+	LinearDest.CopyTo(DestImage, SrcImage.Format, SrcImage.GammaSpace);
+}
+
+// largest per channel difference, in linear float
+static float ComputeMaxDifference(const FImage & A, const FImage & B)
+{
+	FImage LinearA, LinearB;
+	A.CopyTo(LinearA, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+	B.CopyTo(LinearB, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+
+	float MaxDifference = 0.f;
+	TArrayView64<const FLinearColor> ColorsA = LinearA.AsRGBA32F();
+	TArrayView64<const FLinearColor> ColorsB = LinearB.AsRGBA32F();
+	for (int64 Index = 0; Index < ColorsA.Num(); ++Index)
+	{
+		for (int32 Channel = 0; Channel < 4; ++Channel)
+		{
+			MaxDifference = FMath::Max(MaxDifference, FMath::Abs(ColorsA[Index].Component(Channel) - ColorsB[Index].Component(Channel)));
+		}
+	}
+	return MaxDifference;
+}
+
+static const TCHAR * GetFilterName(EResizeImageFilter Filter)
+{
+	switch (Filter)
+	{
+	case EResizeImageFilter::Legacy:	return TEXT("Legacy");
+	case EResizeImageFilter::Box:		return TEXT("Box");
+	case EResizeImageFilter::Triangle:	return TEXT("Triangle");
+	case EResizeImageFilter::Mitchell:	return TEXT("Mitchell");
+	case EResizeImageFilter::Lanczos:	return TEXT("Lanczos");
+	default:							return TEXT("Unknown");
+	}
+}
+
+static void RunResizeBenchmark(const TArray<FString>& Args)
+{
+	int32 SrcSize = 4096;
+	int32 DestSize = 1024;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("Src="), SrcSize);
+		FParse::Value(*Arg, TEXT("Dest="), DestSize);
+	}
+	SrcSize = FMath::Max(SrcSize, 1);
+	DestSize = FMath::Max(DestSize, 1);
+
+	// noise over a gradient, so the filters have both edges and smooth areas to work on
+	FImage Source(SrcSize, SrcSize, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+	FRandomStream Random(1234);
+	TArrayView64<FLinearColor> SourceColors = Source.AsRGBA32F();
+	for (int64 Index = 0; Index < SourceColors.Num(); ++Index)
+	{
+		const float Gradient = (float)(Index % SrcSize) / SrcSize;
+		SourceColors[Index] = FLinearColor(Gradient, Random.GetFraction(), 1.f - Gradient, Random.GetFraction() < 0.5f ? 0.f : 1.f);
+	}
+
+	struct FFormatCase
+	{
+		ERawImageFormat::Type Format;
+		EGammaSpace GammaSpace;
+	};
+	const FFormatCase FormatCases[] =
+	{
+		{ ERawImageFormat::BGRA8, EGammaSpace::sRGB },
+		{ ERawImageFormat::RGBA16F, EGammaSpace::Linear },
+		{ ERawImageFormat::RGBA32F, EGammaSpace::Linear },
+	};
+	const EResizeImageFilter Filters[] = { EResizeImageFilter::Legacy, EResizeImageFilter::Box, EResizeImageFilter::Triangle, EResizeImageFilter::Mitchell, EResizeImageFilter::Lanczos };
+
+	UE_LOG(LogImageResize, Display, TEXT("Resize benchmark: %dx%d -> %dx%d"), SrcSize, SrcSize, DestSize, DestSize);
+
+	for (const FFormatCase & FormatCase : FormatCases)
+	{
+		FImage FormatSource;
+		Source.CopyTo(FormatSource, FormatCase.Format, FormatCase.GammaSpace);
+		const TCHAR * FormatName = ERawImageFormat::GetName(FormatCase.Format);
+
+		FImage Reference;
+		double StartTime = FPlatformTime::Seconds();
+		ReferenceResizeTo(FormatSource, Reference, DestSize, DestSize);
+		const double ReferenceSeconds = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogImageResize, Display, TEXT("%-8s %-10s %8.2fms"), FormatName, TEXT("Previous"), ReferenceSeconds * 1000.0);
+
+		for (EResizeImageFilter Filter : Filters)
+		{
+			FImage Dest;
+			StartTime = FPlatformTime::Seconds();
+			FormatSource.ResizeTo(Dest, DestSize, DestSize, FormatCase.Format, FormatCase.GammaSpace, Filter);
+			const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+			// Legacy must match the previous path exactly, the other filters are expected to differ
+			UE_LOG(LogImageResize, Display, TEXT("%-8s %-10s %8.2fms  %5.2fx  max difference to previous %g"),
+				FormatName, GetFilterName(Filter), Seconds * 1000.0, ReferenceSeconds / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER), ComputeMaxDifference(Reference, Dest));
+		}
+	}
+}
+
+} // namespace UE::ImageResize
+
+static FAutoConsoleCommand ImageResizeBenchmarkCmd(
+	TEXT("ImageCore.ResizeBenchmark"),
+	TEXT("Time FImageCore::ResizeImage with each filter on BGRA8, RGBA16F and RGBA32F images against the previous ResizeTo implementation. Usage: ImageCore.ResizeBenchmark [Src=4096] [Dest=1024]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&UE::ImageResize::RunResizeBenchmark));
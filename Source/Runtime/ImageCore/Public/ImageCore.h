@@ -122,6 +122,28 @@ namespace UE {
 	}
 }
 
+namespace FImageCore
+{
+	/**
+	 * Reconstruction filter used by ResizeImage / ResizeTo.
+	 * All filters except Legacy sample at pixel centers and widen the kernel when downsampling,
+	 *  so every source pixel contributes to the result.
+	 */
+	enum class EResizeImageFilter : uint8
+	{
+		// bilinear taps at DestX * Scale without pixel center shift or filter widening
+		// this is what ResizeTo has always done, it is kept bit-exact so derived data built with it does not change
+		// do not use in new code : downsampling by more than 2x skips source pixels and aliases
+		Legacy,
+		Box,
+		Triangle,
+		// Mitchell-Netravali B = C = 1/3, slight overshoot, sharper than Triangle
+		Mitchell,
+		// Lanczos with 3 lobes, sharpest, rings on hard edges
+		Lanczos,
+	};
+}
+
 /**
 * 
 * FImageInfo describes a 2d pixel surface
@@ -490,15 +512,17 @@ public:
 
 	/**
 	 * Copies and resizes the image to a destination image with the specified size and format.
-	 * Resize is done using bilinear filtering
+	 * Resize is done using the legacy bilinear sampling unless a Filter is specified, see FImageCore::EResizeImageFilter
+	 * Defaults to Legacy, see FImageCore::ResizeTo
 	 *
 	 * @param DestImage - The destination image.
 	 * @param DestSizeX - Width of the resized image
 	 * @param DestSizeY - Height of the resized image
 	 * @param DestFormat - The destination image format.
 	 * @param DestSRGB - Whether the destination image is in SRGB format.
+	 * @param Filter - The reconstruction filter.
 	 */
-	IMAGECORE_API void ResizeTo(FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace) const;
+	IMAGECORE_API void ResizeTo(FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace, FImageCore::EResizeImageFilter Filter = FImageCore::EResizeImageFilter::Legacy) const;
 
 	/**
 	 * Linearize to a RGBA32F destination image by applying the decoding function that corresponds to the specified source encoding.
@@ -765,15 +789,31 @@ IMAGECORE_API void SetAlphaOpaque(const FImageView & InImage);
 
 /**
 	* Copies and resizes the image to a destination image with the specified size and format.
-	* Resize is done using bilinear filtering
+	* Resize is done using the legacy bilinear sampling unless a Filter is specified, see EResizeImageFilter
+	* The default stays Legacy, unlike ResizeImage, because texture builds store ResizeTo output in derived data
+	*  and changing it would change their results without a DDC version bump
 	*
 	* @param DestImage - The destination image.
 	* @param DestSizeX - Width of the resized image
 	* @param DestSizeY - Height of the resized image
 	* @param DestFormat - The destination image format.
 	* @param DestSRGB - Whether the destination image is in SRGB format.
+	* @param Filter - The reconstruction filter.
 	*/
-IMAGECORE_API void ResizeTo(const FImageView & SourceImage,FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace);
+IMAGECORE_API void ResizeTo(const FImageView & SourceImage,FImage& DestImage, int32 DestSizeX, int32 DestSizeY, ERawImageFormat::Type DestFormat, EGammaSpace DestGammaSpace, EResizeImageFilter Filter = EResizeImageFilter::Legacy);
+
+/**
+ * Resize SrcImage into DestImage with a separable filter.
+ * Sizes may differ, formats and gamma may differ, Dest must already be allocated.
+ * Pixels are filtered in linear float, one row at a time, so the source is never converted to float as a whole.
+ * Runs in parallel over rows.
+ * Defaults to Triangle : ResizeImage has no existing callers whose output must stay the same, unlike ResizeTo which defaults to Legacy.
+ *
+ * @param SrcImage - The source image to resize, must be a single slice.
+ * @param DestImage - The destination image, must be a single slice. (the FImageView is const but what it points at is not)
+ * @param Filter - The reconstruction filter.
+ */
+IMAGECORE_API void ResizeImage(const FImageView & SrcImage,const FImageView & DestImage, EResizeImageFilter Filter = EResizeImageFilter::Triangle);
 
 /**
  * Compute the min/max of each channel to get value ranges
@@ -5,6 +5,7 @@
 #include "HAL/PlatformStackWalk.h"
 #include "HAL/PlatformOutputDevices.h"
 #include "HAL/LowLevelMemTracker.h"
+#include "HAL/MallocCountingProxy.h"
 #include "HAL/MallocFrameProfiler.h"
 #include "Misc/MessageDialog.h"
 #include "Misc/ScopedSlowTask.h"
@@ -2062,6 +2063,13 @@ int32 FEngineLoop::PreInitPreStartupScreen(const TCHAR* CmdLine)
 		GMallocFrameProfilerEnabled = true;
 		GMalloc = FMallocFrameProfiler::OverrideIfEnabled(GMalloc);
 	}
+
+	// Counts the allocations of each thread, for code measuring its heap allocations with FScopedMallocCount
+	if (FParse::Param(FCommandLine::Get(), TEXT("malloccounting")))
+	{
+		GMallocCountingProxyEnabled = true;
+		GMalloc = FMallocCountingProxy::OverrideIfEnabled(GMalloc);
+	}
 #endif // !UE_BUILD_SHIPPING
 
 	// Switch into executable's directory (may be required by some of the platform file overrides)
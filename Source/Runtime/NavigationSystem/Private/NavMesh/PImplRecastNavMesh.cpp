@@ -16,6 +16,7 @@
 #include "NavMesh/RecastQueryFilter.h"
 #include "NavLinkCustomInterface.h"
 #include "VisualLogger/VisualLogger.h"
+#include "HAL/IConsoleManager.h"
 
 #include "Misc/LargeWorldCoordinates.h"
 #include "DebugUtils/DebugDrawLargeWorldCoordinates.h"
@@ -33,6 +34,17 @@ static_assert(std::is_same_v<FVector::FReal, dtReal>, "FReal and dtReal must be
 static_assert(std::is_same_v<FVector::FReal, rcReal>, "FReal and rcReal must be the same type!");
 static_assert(std::is_same_v<FVector::FReal, duReal>, "FReal and duReal must be the same type!");
 
+namespace UE::NavMesh::Private
+{
+	static bool bUseHierarchicalPathfinding = false;
+	static FAutoConsoleVariableRef CVarUseHierarchicalPathfinding(TEXT("ai.nav.HierarchicalPathfinding"), bUseHierarchicalPathfinding,
+		TEXT("Find long navmesh paths on an abstract graph of the navmesh tiles, refined into short regular searches. The graph is built the next time a navmesh is loaded or its tiles change."), ECVF_Default);
+
+	static int32 HierarchicalPathfindingTilesPerCluster = 4;
+	static FAutoConsoleVariableRef CVarHierarchicalPathfindingTilesPerCluster(TEXT("ai.nav.HierarchicalPathfindingTilesPerCluster"), HierarchicalPathfindingTilesPerCluster,
+		TEXT("Width and height in tiles of the clusters forming the top level of the hierarchical pathfinding graph."), ECVF_Default);
+}
+
 /// Helper for accessing navigation query from different threads
 #define INITIALIZE_NAVQUERY_SIMPLE(NavQueryVariable, NumNodes)	\
 	dtNavMeshQuery NavQueryVariable##Private;	\
@@ -458,6 +470,8 @@ FPImplRecastNavMesh::~FPImplRecastNavMesh()
 
 void FPImplRecastNavMesh::ReleaseDetourNavMesh()
 {
+	DetourHierarchy.Reset();
+
 	// release navmesh only if we own it
 	if (DetourNavMesh != nullptr)
 	{
@@ -685,6 +699,8 @@ void FPImplRecastNavMesh::Serialize( FArchive& Ar, int32 NavMeshVersion )
 					}
 				}
 			}
+
+			RebuildHierarchy();
 		}
 	}
 	else if (Ar.IsSaving())
@@ -1074,6 +1090,7 @@ void FPImplRecastNavMesh::SetRecastMesh(dtNavMesh* NavMesh)
 
 	ReleaseDetourNavMesh();
 	DetourNavMesh = NavMesh;
+	RebuildHierarchy();
 
 	if (NavMeshOwner)
 	{
@@ -1084,6 +1101,40 @@ void FPImplRecastNavMesh::SetRecastMesh(dtNavMesh* NavMesh)
 	OnAreaCostChanged();
 }
 
+void FPImplRecastNavMesh::RebuildHierarchy()
+{
+	DetourHierarchy.Reset();
+	if (!UE::NavMesh::Private::bUseHierarchicalPathfinding || DetourNavMesh == nullptr || DetourNavMesh->getParams()->maxTiles <= 0)
+	{
+		return;
+	}
+
+	dtNavMeshHierarchyParams Params;
+	Params.tilesPerCluster = FMath::Max(UE::NavMesh::Private::HierarchicalPathfindingTilesPerCluster, 1);
+	DetourHierarchy = MakeUnique<dtNavMeshHierarchy>();
+	if (dtStatusFailed(DetourHierarchy->init(DetourNavMesh, Params)))
+	{
+		DetourHierarchy.Reset();
+	}
+}
+
+void FPImplRecastNavMesh::UpdateHierarchy(const TArray<FNavTileRef>& ChangedTiles)
+{
+	if (!UE::NavMesh::Private::bUseHierarchicalPathfinding || !DetourHierarchy.IsValid() || DetourHierarchy->getNavMesh() != DetourNavMesh)
+	{
+		RebuildHierarchy();
+		return;
+	}
+
+	TArray<dtTileRef, TInlineAllocator<64>> TileRefs;
+	TileRefs.Reserve(ChangedTiles.Num());
+	for (const FNavTileRef TileRef : ChangedTiles)
+	{
+		TileRefs.Add((dtTileRef)(uint64)TileRef);
+	}
+	DetourHierarchy->updateTiles(TileRefs.GetData(), TileRefs.Num());
+}
+
 void FPImplRecastNavMesh::Raycast(const FVector& StartLoc, const FVector& EndLoc, const FNavigationQueryFilter& InQueryFilter, const UObject* Owner, 
 	ARecastNavMesh::FRaycastResult& RaycastResult, NavNodeRef StartNode) const
 {
@@ -1179,9 +1230,11 @@ ENavigationQueryResult::Type FPImplRecastNavMesh::FindPath(const FVector& StartL
 		return ENavigationQueryResult::Error;
 	}
 
-	// get path corridor
+	// get path corridor, long paths go through the navmesh hierarchy when there is one
 	dtQueryResult PathResult;
-	const dtStatus FindPathStatus = NavQuery.findPath(StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0);
+	const dtStatus FindPathStatus = (UE::NavMesh::Private::bUseHierarchicalPathfinding && DetourHierarchy.IsValid() && DetourHierarchy->getNavMesh() == DetourNavMesh)
+		? DetourHierarchy->findPath(NavQuery, StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0)
+		: NavQuery.findPath(StartPolyID, EndPolyID, &RecastStartPos.X, &RecastEndPos.X, CostLimit, QueryFilter, PathResult, 0);
 
 	return PostProcessPathInternal(FindPathStatus, Path, NavQuery, QueryFilter, StartPolyID, EndPolyID, RecastStartPos, RecastEndPos, PathResult);
 }
@@ -2450,6 +2450,10 @@ void ARecastNavMesh::OnNavMeshTilesUpdated(const TArray<uint32>& ChangedTiles)
 
 void ARecastNavMesh::OnNavMeshTilesUpdated(const TArray<FNavTileRef>& ChangedTiles)
 {
+	if (RecastNavMeshImpl)
+	{
+		RecastNavMeshImpl->UpdateHierarchy(ChangedTiles);
+	}
 	InvalidateAffectedPaths(ChangedTiles);
 }
 
@@ -2799,6 +2803,7 @@ void ARecastNavMesh::AttachNavMeshDataChunk(URecastNavMeshDataChunk& NavDataChun
 	const TArray<FNavTileRef> AttachedIndices = NavDataChunk.AttachTiles(*this);
 	if (AttachedIndices.Num() > 0)
 	{
+		RecastNavMeshImpl->UpdateHierarchy(AttachedIndices);
 		InvalidateAffectedPaths(AttachedIndices);
 		RequestDrawingUpdate();
 	}
@@ -2830,6 +2835,7 @@ void ARecastNavMesh::DetachNavMeshDataChunk(URecastNavMeshDataChunk& NavDataChun
 	const TArray<FNavTileRef> DetachedIndices = NavDataChunk.DetachTiles(*this);
 	if (DetachedIndices.Num() > 0)
 	{
+		RecastNavMeshImpl->UpdateHierarchy(DetachedIndices);
 		InvalidateAffectedPaths(DetachedIndices);
 		RequestDrawingUpdate();
 	}
@@ -86,6 +86,39 @@ namespace UE::NavMesh::Private
 
 	static bool bKeepSteepSlopeForSingleVoxelAgent = true;
 	static FAutoConsoleVariableRef CVarKeepSteepSlopeForSingleVoxelAgent(TEXT("ai.nav.KeepSteepSlopeForSingleVoxelAgent"), bKeepSteepSlopeForSingleVoxelAgent, TEXT("Active by default. Fix too wide filtering of steep slope in Recast Heightfield filtering when the agent radius is only 1 voxel. Set to false to revert to the previous behavior."), ECVF_Default);
+
+	static int32 TileGenerationMemoryBudgetMB = 0;
+	static FAutoConsoleVariableRef CVarTileGenerationMemoryBudgetMB(TEXT("ai.nav.TileGenerationMemoryBudgetMB"), TileGenerationMemoryBudgetMB, TEXT("Peak memory (in MB) async tile generators of a navmesh are allowed to use at once. New tile tasks are held back while the estimated memory of the running ones would exceed it, one task always runs. 0 means no limit other than the number of tasks."), ECVF_Default);
+
+	static bool bLogTileGenerationStats = false;
+	static FAutoConsoleVariableRef CVarLogTileGenerationStats(TEXT("ai.nav.LogTileGenerationStats"), bLogTileGenerationStats, TEXT("Log the time spent in each tile generation phase when a full navmesh build completes."), ECVF_Default);
+
+	/** Accumulates the time elapsed between consecutive calls to Lap() into FRecastTileGenerationStats phases */
+	struct FTileGenerationPhaseTimer
+	{
+		FTileGenerationPhaseTimer() : LastTime(FPlatformTime::Seconds()) {}
+
+		void Lap(double& PhaseTime)
+		{
+			const double Now = FPlatformTime::Seconds();
+			PhaseTime += Now - LastTime;
+			LastTime = Now;
+		}
+
+	private:
+		double LastTime;
+	};
+
+	/** Adds the time spent in its scope to a FRecastTileGenerationStats phase */
+	struct FScopedTileGenerationPhase
+	{
+		explicit FScopedTileGenerationPhase(double& InPhaseTime) : PhaseTime(InPhaseTime), StartTime(FPlatformTime::Seconds()) {}
+		~FScopedTileGenerationPhase() { PhaseTime += FPlatformTime::Seconds() - StartTime; }
+
+	private:
+		double& PhaseTime;
+		double StartTime;
+	};
 }
 
 static FOodleDataCompression::ECompressor GNavmeshTileCacheCompressor = FOodleDataCompression::ECompressor::Mermaid;
@@ -1873,13 +1906,21 @@ bool FRecastTileGenerator::DoWork()
 
 	if (ParentGenerator.IsValid())
 	{
+		GenerationStats = FRecastTileGenerationStats();
+		const double StartTime = FPlatformTime::Seconds();
+
 		if (InclusionBounds.Num())
 		{
+			UE::NavMesh::Private::FScopedTileGenerationPhase GatherPhase(GenerationStats.GatherGeometry);
 			GatherGeometryFromSources();
 		}
 
 		bSuccess = GenerateTile();
 
+		GenerationStats.Total = FPlatformTime::Seconds() - StartTime;
+		GenerationStats.PeakTileMemory = FMath::Max<uint64>(GenerationStats.PeakTileMemory, UsedMemoryOnStartup);
+		GenerationStats.NumTiles = 1;
+
 		DumpAsyncData();
 	}
 
@@ -2596,6 +2637,46 @@ struct FTileRasterizationContext
 	TArray<FNavMeshTileData> Layers;
 	FRecastTileGenerator::TInlineMaskArray RasterizationMasks;
 
+	/** Estimated memory used by the heightfields and layers, in bytes */
+	uint64 GetUsedMemCount() const
+	{
+		uint64 TotalMemory = Layers.GetAllocatedSize();
+		for (const FNavMeshTileData& Layer : Layers)
+		{
+			TotalMemory += Layer.DataSize;
+		}
+
+		if (SolidHF)
+		{
+			TotalMemory += sizeof(rcSpan*) * SolidHF->width * SolidHF->height;
+			for (const rcSpanPool* Pool = SolidHF->pools; Pool; Pool = Pool->next)
+			{
+				TotalMemory += sizeof(rcSpanPool);
+			}
+#if EPIC_ADDITION_USE_NEW_RECAST_RASTERIZER
+			TotalMemory += sizeof(rcTempSpan) * (SolidHF->width + 2) * (SolidHF->height + 2);
+#endif
+		}
+
+		if (CompactHF)
+		{
+			TotalMemory += sizeof(rcCompactCell) * CompactHF->width * CompactHF->height;
+			TotalMemory += (sizeof(rcCompactSpan) + sizeof(unsigned char)) * CompactHF->spanCount;
+			TotalMemory += CompactHF->dist ? sizeof(unsigned short) * CompactHF->spanCount : 0;
+		}
+
+		if (LayerSet)
+		{
+			for (int32 LayerIdx = 0; LayerIdx < LayerSet->nlayers; LayerIdx++)
+			{
+				const rcHeightfieldLayer& Layer = LayerSet->layers[LayerIdx];
+				TotalMemory += (sizeof(unsigned short) + 2 * sizeof(unsigned char)) * Layer.width * Layer.height;
+			}
+		}
+
+		return TotalMemory;
+	}
+
 private:
 	rcRasterizationFlags RasterizationFlags;
 };
@@ -3480,6 +3561,8 @@ bool FRecastTileGenerator::GenerateCompressedLayers(FNavMeshBuildContext& BuildC
 	FTileRasterizationContext RasterContext;
 	CompressedLayers.Reset();
 
+	UE::NavMesh::Private::FTileGenerationPhaseTimer PhaseTimer;
+
 	if (!CreateHeightField(BuildContext, RasterContext))
 	{
 		return false;
@@ -3488,6 +3571,8 @@ bool FRecastTileGenerator::GenerateCompressedLayers(FNavMeshBuildContext& BuildC
 	ComputeRasterizationMasks(BuildContext, RasterContext);
 
 	RasterizeTriangles(BuildContext, RasterContext);
+	PhaseTimer.Lap(GenerationStats.Rasterization);
+
 	if (!RasterContext.SolidHF || RasterContext.SolidHF->pools == 0)
 	{
 		BuildContext.log(RC_LOG_WARNING, "GenerateCompressedLayers: empty tile - aborting");
@@ -3513,6 +3598,7 @@ bool FRecastTileGenerator::GenerateCompressedLayers(FNavMeshBuildContext& BuildC
 	{
 		ApplyVoxelFilter(RasterContext.SolidHF, TileConfig.walkableRadius);
 	}
+	PhaseTimer.Lap(GenerationStats.Rasterization);
 
 #if RECAST_INTERNAL_DEBUG_DATA
 	if (IsTileDebugActive() && TileDebugSettings.bHeightfieldPostInclusionBoundsFiltering)
@@ -3522,6 +3608,7 @@ bool FRecastTileGenerator::GenerateCompressedLayers(FNavMeshBuildContext& BuildC
 #endif
 
 	GenerateRecastFilter(BuildContext, RasterContext);
+	PhaseTimer.Lap(GenerationStats.Filtering);
 
 #if RECAST_INTERNAL_DEBUG_DATA
 	if (IsTileDebugActive() && TileDebugSettings.bHeightfieldPostHeightFiltering)
@@ -3546,6 +3633,7 @@ bool FRecastTileGenerator::GenerateCompressedLayers(FNavMeshBuildContext& BuildC
 	{
 		return false;
 	}
+	PhaseTimer.Lap(GenerationStats.CompactHeightfield);
 
 #if RECAST_INTERNAL_DEBUG_DATA
 	if (IsTileDebugActive() && TileDebugSettings.bCompactHeightfieldEroded)
@@ -3559,6 +3647,9 @@ bool FRecastTileGenerator::GenerateCompressedLayers(FNavMeshBuildContext& BuildC
 		return false;
 	}
 
+	// All the rasterization data is alive at this point, this is the peak of the tile generation
+	GenerationStats.PeakTileMemory = sizeof(FRecastTileGenerator) + GetUsedMemCount() + RasterContext.GetUsedMemCount();
+
 #if RECAST_INTERNAL_DEBUG_DATA
 	if (IsTileDebugActive())
 	{
@@ -3574,7 +3665,10 @@ bool FRecastTileGenerator::GenerateCompressedLayers(FNavMeshBuildContext& BuildC
 	}
 #endif
 	
-	return RecastBuildTileCache(BuildContext, RasterContext);
+	const bool bSuccess = RecastBuildTileCache(BuildContext, RasterContext);
+	PhaseTimer.Lap(GenerationStats.Layers);
+
+	return bSuccess;
 }
 
 struct FTileGenerationContext
@@ -3643,6 +3737,7 @@ bool FRecastTileGenerator::GenerateNavigationDataLayer(FNavMeshBuildContext& Bui
 
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Navigation_RecastBuildRegions)
+		UE::NavMesh::Private::FScopedTileGenerationPhase RegionsPhase(GenerationStats.Regions);
 
 		// Build regions
 		if (TileConfig.TileCachePartitionType == RC_REGION_MONOTONE)
@@ -3701,6 +3796,7 @@ bool FRecastTileGenerator::GenerateNavigationDataLayer(FNavMeshBuildContext& Bui
 
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Navigation_RecastBuildContours);
+		UE::NavMesh::Private::FScopedTileGenerationPhase ContoursPhase(GenerationStats.Contours);
 		// Build contour set
 		GenerationContext.ContourSet = dtAllocTileCacheContourSet(&GenNavAllocator);
 		if (GenerationContext.ContourSet == nullptr)
@@ -3749,6 +3845,7 @@ bool FRecastTileGenerator::GenerateNavigationDataLayer(FNavMeshBuildContext& Bui
 
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Navigation_RecastBuildPolyMesh);
+		UE::NavMesh::Private::FScopedTileGenerationPhase PolyMeshPhase(GenerationStats.PolyMesh);
 		// Build poly mesh
 		GenerationContext.PolyMesh = dtAllocTileCachePolyMesh(&GenNavAllocator);
 		if (GenerationContext.PolyMesh == nullptr)
@@ -3785,6 +3882,7 @@ bool FRecastTileGenerator::GenerateNavigationDataLayer(FNavMeshBuildContext& Bui
 	if (TileConfig.bGenerateDetailedMesh)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Navigation_RecastBuildPolyDetail);
+		UE::NavMesh::Private::FScopedTileGenerationPhase PolyDetailPhase(GenerationStats.PolyMesh);
 
 		// Build detail mesh.
 		GenerationContext.DetailMesh = dtAllocTileCachePolyMeshDetail(&GenNavAllocator);
@@ -4456,6 +4554,47 @@ void FRecastTileGenerator::MarkDynamicArea(const FAreaNavModifier& Modifier, con
 	}
 }
 
+//----------------------------------------------------------------------//
+// FRecastTileGenerationStats
+//----------------------------------------------------------------------//
+void FRecastTileGenerationStats::Accumulate(const FRecastTileGenerationStats& Other)
+{
+	GatherGeometry += Other.GatherGeometry;
+	Rasterization += Other.Rasterization;
+	Filtering += Other.Filtering;
+	CompactHeightfield += Other.CompactHeightfield;
+	Layers += Other.Layers;
+	Regions += Other.Regions;
+	Contours += Other.Contours;
+	PolyMesh += Other.PolyMesh;
+	Total += Other.Total;
+	PeakTileMemory = FMath::Max(PeakTileMemory, Other.PeakTileMemory);
+	NumTiles += Other.NumTiles;
+}
+
+void FRecastTileGenerationStats::Log(const TCHAR* Label) const
+{
+	const double Other = FMath::Max(Total - GatherGeometry - Rasterization - Filtering - CompactHeightfield - Layers - Regions - Contours - PolyMesh, 0.);
+	const double Scale = Total > 0. ? 100. / Total : 0.;
+
+	UE_LOG(LogNavigationDataBuild, Display, TEXT("%s: %d tiles, %.2fs of tile generation (%.2fms per tile), peak tile memory %.2fMB"),
+		Label, NumTiles, Total, NumTiles > 0 ? Total * 1000. / NumTiles : 0., PeakTileMemory / (1024. * 1024.));
+
+	auto LogPhase = [Scale](const TCHAR* Name, const double Time)
+	{
+		UE_LOG(LogNavigationDataBuild, Display, TEXT("   %-20s %9.3fs %6.2f%%"), Name, Time, Time * Scale);
+	};
+	LogPhase(TEXT("Gather geometry"), GatherGeometry);
+	LogPhase(TEXT("Rasterization"), Rasterization);
+	LogPhase(TEXT("Filtering"), Filtering);
+	LogPhase(TEXT("Compact heightfield"), CompactHeightfield);
+	LogPhase(TEXT("Layers"), Layers);
+	LogPhase(TEXT("Regions"), Regions);
+	LogPhase(TEXT("Contours"), Contours);
+	LogPhase(TEXT("Poly mesh"), PolyMesh);
+	LogPhase(TEXT("Other"), Other);
+}
+
 uint32 FRecastTileGenerator::GetUsedMemCount() const
 {
 	SIZE_T TotalMemory = 0;
@@ -5023,6 +5162,7 @@ bool FRecastNavMeshGenerator::RebuildAll()
 	else
 	{
 		RebuildAllStartTime = FPlatformTime::Seconds();
+		ResetGenerationStats();
 	}
 
 	return true;
@@ -5038,10 +5178,12 @@ void FRecastNavMeshGenerator::EnsureBuildCompletion()
 		const int32 NumTasksToProcess = (bDoAsyncDataGathering ? 1 : MaxTileGeneratorTasks) - RunningDirtyTiles.Num();
 		ProcessTileTasksAndGetUpdatedTiles(NumTasksToProcess);
 		
-		// Block until tasks are finished
-		for (FRunningTileElement& Element : RunningDirtyTiles)
+		// Block until one task is finished so its slot can be refilled while the others keep running,
+		// waiting for all of them would leave workers idle behind the slowest tile of every wave
+		const bool bHasFinishedTask = RunningDirtyTiles.ContainsByPredicate([](const FRunningTileElement& Element) { return Element.AsyncTask->IsDone(); });
+		if (!bHasFinishedTask && RunningDirtyTiles.Num() > 0)
 		{
-			Element.AsyncTask->EnsureCompletion();
+			RunningDirtyTiles[0].AsyncTask->EnsureCompletion();
 		}
 	}
 	while (GetNumRemaningBuildTasks() > 0);
@@ -5784,6 +5926,7 @@ void FRecastNavMeshGenerator::DiscardCurrentBuildingTasks()
 	ResetTimeSlicedTileGeneratorSync();
 
 	RunningDirtyTiles.Empty();
+	RunningTilesMemoryEstimate = 0;
 }
 
 bool FRecastNavMeshGenerator::HasDirtyTiles() const
@@ -6272,6 +6415,7 @@ TArray<FNavTileRef> FRecastNavMeshGenerator::ProcessTileTasksAsyncAndGetUpdatedT
 
 	TArray<FNavTileRef> UpdatedTiles;
 	const bool bGameStaticNavMesh = IsGameStaticNavMesh(DestNavMesh);
+	const uint64 MemoryBudget = (uint64)FMath::Max(UE::NavMesh::Private::TileGenerationMemoryBudgetMB, 0) * 1024 * 1024;
 
 	int32 NumProcessedTasks = 0;
 	// Submit pending tile elements
@@ -6279,6 +6423,12 @@ TArray<FNavTileRef> FRecastNavMeshGenerator::ProcessTileTasksAsyncAndGetUpdatedT
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_RecastNavMeshGenerator_ProcessTileTasks_NewTasks);
 
+		// Hold back new tasks while the running ones are expected to use the whole memory budget, one task always runs
+		if (MemoryBudget > 0 && RunningDirtyTiles.Num() > 0 && RunningTilesMemoryEstimate + AvgTilePeakMemory > MemoryBudget)
+		{
+			break;
+		}
+
 		FPendingTileElement& PendingElement = PendingDirtyTiles[ElementIdx];
 		FRunningTileElement RunningElement(PendingElement.Coord);
 		
@@ -6291,6 +6441,8 @@ TArray<FNavTileRef> FRecastNavMeshGenerator::ProcessTileTasksAsyncAndGetUpdatedT
 			// Start it in background in case it has something to build
 			if (TileTask->GetTask().TileGenerator->HasDataToBuild())
 			{
+				RunningElement.MemoryEstimate = FMath::Max<uint64>(AvgTilePeakMemory, TileTask->GetTask().TileGenerator->UsedMemoryOnStartup);
+				RunningTilesMemoryEstimate += RunningElement.MemoryEstimate;
 				RunningElement.AsyncTask = TileTask.Release();
 
 				if (!GNavmeshSynchronousTileGeneration)
@@ -6336,6 +6488,15 @@ TArray<FNavTileRef> FRecastNavMeshGenerator::ProcessTileTasksAsyncAndGetUpdatedT
 		if (Element.AsyncTask->IsDone())
 		{
 			FRecastTileGenerator& TileGenerator = *(Element.AsyncTask->GetTask().TileGenerator);
+
+			RunningTilesMemoryEstimate -= FMath::Min(RunningTilesMemoryEstimate, Element.MemoryEstimate);
+			const FRecastTileGenerationStats& TileStats = TileGenerator.GetGenerationStats();
+			if (TileStats.NumTiles > 0)
+			{
+				GenerationStats.Accumulate(TileStats);
+				// Moving average following the size of the tiles around the area being built
+				AvgTilePeakMemory = AvgTilePeakMemory > 0 ? (AvgTilePeakMemory * 7 + TileStats.PeakTileMemory) / 8 : TileStats.PeakTileMemory;
+			}
 			
 			// Add generated tiles to navmesh
 			if (!Element.bShouldDiscard)
@@ -6779,6 +6940,11 @@ TArray<FNavTileRef> FRecastNavMeshGenerator::ProcessTileTasksAndGetUpdatedTiles(
 		{
 			UE_LOG(LogNavigationDataBuild, Display, TEXT("   %s build time: %.2fs"), ANSI_TO_TCHAR(__FUNCTION__), (FPlatformTime::Seconds() - RebuildAllStartTime));
 			RebuildAllStartTime = 0;
+
+			if (UE::NavMesh::Private::bLogTileGenerationStats)
+			{
+				GenerationStats.Log(*GetNameSafe(DestNavMesh));
+			}
 		}
 		
 		DestNavMesh->OnNavMeshGenerationFinished();
@@ -7433,8 +7599,83 @@ protected:
 			}
 		}
 #endif // ALLOW_DEBUG_FILES && !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		if (FParse::Command(&Cmd, TEXT("BenchmarkNavigationBuild")))
+		{
+			BenchmarkNavigationBuild(InWorld, Cmd);
+			return true;
+		}
 		return bExported;
 	}
+
+	/**
+	 * Rebuilds every navmesh of the world serially, then in parallel under each of the given tile generation memory budgets,
+	 * and logs the build times and per-phase timings. Runs headless with -nullrhi -ExecCmds="BenchmarkNavigationBuild ..."
+	 * Usage: BenchmarkNavigationBuild [Budgets=0,1024,256] [Serial=1]
+	 */
+	static void BenchmarkNavigationBuild(UWorld* InWorld, const TCHAR* Cmd)
+	{
+		UNavigationSystemV1* NavSys = InWorld ? FNavigationSystem::GetCurrent<UNavigationSystemV1>(InWorld) : nullptr;
+		if (NavSys == nullptr)
+		{
+			UE_LOG(LogNavigation, Error, TEXT("BenchmarkNavigationBuild: missing navigation system"));
+			return;
+		}
+
+		FString BudgetsString(TEXT("0"));
+		bool bSerial = true;
+		FParse::Value(Cmd, TEXT("Budgets="), BudgetsString);
+		FParse::Bool(Cmd, TEXT("Serial="), bSerial);
+
+		TArray<FString> BudgetStrings;
+		BudgetsString.ParseIntoArray(BudgetStrings, TEXT(","));
+
+		const int32 SavedBudgetMB = UE::NavMesh::Private::TileGenerationMemoryBudgetMB;
+		const int32 SavedSynchronousTileGeneration = GNavmeshSynchronousTileGeneration;
+
+		for (ANavigationData* NavData : NavSys->NavDataSet)
+		{
+			ARecastNavMesh* NavMesh = Cast<ARecastNavMesh>(NavData);
+			FRecastNavMeshGenerator* Generator = NavMesh ? static_cast<FRecastNavMeshGenerator*>(NavMesh->GetGenerator()) : nullptr;
+			if (Generator == nullptr)
+			{
+				continue;
+			}
+
+			auto RunBuild = [NavMesh, Generator](const TCHAR* Label) -> double
+			{
+				Generator->EnsureBuildCompletion();
+				Generator->RebuildAll();
+				Generator->ResetGenerationStats();
+
+				const double StartTime = FPlatformTime::Seconds();
+				Generator->EnsureBuildCompletion();
+				const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+				Generator->GetGenerationStats().Log(*FString::Printf(TEXT("%s %s: %.2fs build"), *NavMesh->GetName(), Label, BuildTime));
+				return BuildTime;
+			};
+
+			double SerialTime = 0.;
+			if (bSerial)
+			{
+				GNavmeshSynchronousTileGeneration = 1;
+				SerialTime = RunBuild(TEXT("serial"));
+				GNavmeshSynchronousTileGeneration = SavedSynchronousTileGeneration;
+			}
+
+			for (const FString& Budget : BudgetStrings)
+			{
+				UE::NavMesh::Private::TileGenerationMemoryBudgetMB = FCString::Atoi(*Budget);
+				const FString Label = FString::Printf(TEXT("parallel, %dMB budget"), UE::NavMesh::Private::TileGenerationMemoryBudgetMB);
+				const double BuildTime = RunBuild(*Label);
+				if (SerialTime > 0.)
+				{
+					UE_LOG(LogNavigationDataBuild, Display, TEXT("%s %s: %.2fx faster than serial"), *NavMesh->GetName(), *Label, SerialTime / FMath::Max(BuildTime, UE_DOUBLE_SMALL_NUMBER));
+				}
+			}
+			UE::NavMesh::Private::TileGenerationMemoryBudgetMB = SavedBudgetMB;
+		}
+	}
 } NavigationGeomExec;
 
 #if RECAST_INTERNAL_DEBUG_DATA
@@ -24,6 +24,7 @@
 #if WITH_RECAST
 #include "Detour/DetourNavMesh.h"
 #include "Detour/DetourNavMeshQuery.h"
+#include "Detour/DetourNavMeshHierarchy.h"
 #endif
 
 class FRecastNavMeshGenerator;
@@ -227,6 +228,12 @@ public:
 	dtNavMesh* GetRecastMesh() { return DetourNavMesh; };
 	NAVIGATIONSYSTEM_API void ReleaseDetourNavMesh();
 
+	/** Rebuilds the hierarchical pathfinding graph of the whole navmesh, or releases it if ai.nav.HierarchicalPathfinding is disabled */
+	NAVIGATIONSYSTEM_API void RebuildHierarchy();
+
+	/** Updates the hierarchical pathfinding graph after tiles were added to or removed from the navmesh */
+	NAVIGATIONSYSTEM_API void UpdateHierarchy(const TArray<FNavTileRef>& ChangedTiles);
+
 	NAVIGATIONSYSTEM_API void RemoveTileCacheLayers(int32 TileX, int32 TileY);
 	NAVIGATIONSYSTEM_API void RemoveTileCacheLayer(int32 TileX, int32 TileY, int32 LayerIdx);
 	NAVIGATIONSYSTEM_API void AddTileCacheLayers(int32 TileX, int32 TileY, const TArray<FNavMeshTileData>& Layers);
@@ -272,6 +279,9 @@ public:
 	/** query used for searching data on game thread */
 	mutable dtNavMeshQuery SharedNavQuery;
 
+	/** Abstract graph over the navmesh tiles used by FindPath for long paths, null unless ai.nav.HierarchicalPathfinding is enabled */
+	TUniquePtr<dtNavMeshHierarchy> DetourHierarchy;
+
 	/** Helper function to serialize a single Recast tile. */
 	static NAVIGATIONSYSTEM_API void SerializeRecastMeshTile(FArchive& Ar, int32 NavMeshVersion, unsigned char*& TileData, int32& TileDataSize);
 
@@ -291,6 +291,36 @@ struct FRecastTileTimeSliceSettings
 	int32 FilterLedgeSpansMaxYProcess = 13;
 };
 
+/** Time spent in each tile generation phase (in seconds) and memory used by tile generators. */
+struct FRecastTileGenerationStats
+{
+	/** Gathering geometry from the prefetched sources, when done by the tile generator */
+	double GatherGeometry = 0.;
+	/** Heightfield creation, rasterization masks, triangle rasterization and voxel filtering */
+	double Rasterization = 0.;
+	/** Ledge, low height and walkable filters */
+	double Filtering = 0.;
+	/** Compact heightfield creation and walkable area erosion */
+	double CompactHeightfield = 0.;
+	/** Layer partitioning and compression */
+	double Layers = 0.;
+	/** Region partitioning of the decompressed layers */
+	double Regions = 0.;
+	/** Contour tracing and simplification */
+	double Contours = 0.;
+	/** Polygon and detail mesh building */
+	double PolyMesh = 0.;
+	/** Whole tile generation, including the phases above, area marking and navigation data creation */
+	double Total = 0.;
+	/** Largest estimated working memory of a single tile generator (in bytes) */
+	uint64 PeakTileMemory = 0;
+	/** Number of generated tiles */
+	int32 NumTiles = 0;
+
+	NAVIGATIONSYSTEM_API void Accumulate(const FRecastTileGenerationStats& Other);
+	NAVIGATIONSYSTEM_API void Log(const TCHAR* Label) const;
+};
+
 /**
  * Class handling generation of a single tile, caching data that can speed up subsequent tile generations
  */
@@ -334,6 +364,9 @@ public:
 	// Memory amount used to construct generator 
 	uint32 UsedMemoryOnStartup;
 
+	/** Phase timings of the last generation, PeakTileMemory includes UsedMemoryOnStartup and the rasterization data */
+	const FRecastTileGenerationStats& GetGenerationStats() const { return GenerationStats; }
+
 	// FGCObject begin
 	NAVIGATIONSYSTEM_API virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
 	NAVIGATIONSYSTEM_API virtual FString GetReferencerName() const override;
@@ -525,6 +558,8 @@ protected:
 
 	FRecastNavMeshTileGenerationDebug TileDebugSettings;
 
+	FRecastTileGenerationStats GenerationStats;
+
 #if RECAST_INTERNAL_DEBUG_DATA
 	FRecastInternalDebugData DebugData;
 #endif
@@ -620,6 +655,7 @@ struct FRunningTileElement
 		: Coord(FIntPoint::NoneValue)
 		, bShouldDiscard(false)
 		, AsyncTask(nullptr)
+		, MemoryEstimate(0)
 	{
 	}
 	
@@ -627,6 +663,7 @@ struct FRunningTileElement
 		: Coord(InCoord)
 		, bShouldDiscard(false)
 		, AsyncTask(nullptr)
+		, MemoryEstimate(0)
 	{
 	}
 
@@ -640,6 +677,8 @@ struct FRunningTileElement
 	/** whether generated results should be discarded */
 	bool						bShouldDiscard; 
 	FRecastTileGeneratorTask*	AsyncTask;
+	/** peak memory expected to be used by the task, counted against the tile generation memory budget */
+	uint64						MemoryEstimate;
 };
 
 struct FTileTimestamp
@@ -895,6 +934,10 @@ public:
 
 	static NAVIGATIONSYSTEM_API void CalcPolyRefBits(ARecastNavMesh* NavMeshOwner, int32& MaxTileBits, int32& MaxPolyBits);
 
+	/** Phase timings accumulated from the async tile generators since the last reset */
+	const FRecastTileGenerationStats& GetGenerationStats() const { return GenerationStats; }
+	void ResetGenerationStats() { GenerationStats = FRecastTileGenerationStats(); }
+
 protected:
 	NAVIGATIONSYSTEM_API virtual void RestrictBuildingToActiveTiles(bool InRestrictBuildingToActiveTiles);
 	
@@ -977,6 +1020,15 @@ protected:
 	/** List of dirty tiles currently being regenerated */
 	TNavStatArray<FRunningTileElement> RunningDirtyTiles;
 
+	/** Sum of the memory estimates of RunningDirtyTiles */
+	uint64 RunningTilesMemoryEstimate = 0;
+
+	/** Moving average of the peak memory used by a tile generator, 0 until a tile was generated */
+	uint64 AvgTilePeakMemory = 0;
+
+	/** Phase timings accumulated from the finished async tile generators */
+	FRecastTileGenerationStats GenerationStats;
+
 #if WITH_EDITOR
 	/** List of tiles that were recently regenerated */
 	TNavStatArray<FTileTimestamp> RecentlyBuiltTiles;
@@ -0,0 +1,210 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Detour/DetourBatchPathQuery.h"
+#include "Async/ParallelFor.h"
+#include "Detour/DetourAssert.h"
+#include "HAL/PlatformMisc.h"
+
+dtBatchPathQuery::dtBatchPathQuery()
+	: m_minSharedGoalRequests(4)
+	, m_lastSharedSearchCount(0)
+	, m_lastSingleSearchCount(0)
+{
+}
+
+dtBatchPathQuery::~dtBatchPathQuery()
+{
+	for (dtNavMeshQuery* query : m_contexts)
+	{
+		dtFreeNavMeshQuery(query);
+	}
+}
+
+dtStatus dtBatchPathQuery::init(const dtNavMesh* nav, const int maxNodes, const int maxContexts, dtQuerySpecialLinkFilter* linkFilter)
+{
+	const int contextCount = maxContexts > 0 ? maxContexts : FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	while (m_contexts.Num() > contextCount)
+	{
+		dtFreeNavMeshQuery(m_contexts.Pop());
+	}
+	while (m_contexts.Num() < contextCount)
+	{
+		dtNavMeshQuery* query = dtAllocNavMeshQuery();
+		if (!query)
+			return DT_FAILURE | DT_OUT_OF_MEMORY;
+		m_contexts.Add(query);
+	}
+
+	for (dtNavMeshQuery* query : m_contexts)
+	{
+		const dtStatus status = query->init(nav, maxNodes, linkFilter);
+		if (dtStatusFailed(status))
+			return status;
+	}
+
+	return DT_SUCCESS;
+}
+
+void dtBatchPathQuery::findSinglePath(dtNavMeshQuery& query, const dtBatchPathRequest& request, dtBatchPathResult& result) const
+{
+	query.setRequireNavigableEndLocation(request.requireNavigableEndLocation);
+	result.status = query.findPath(request.startRef, request.endRef, request.startPos, request.endPos, request.costLimit, request.filter, result.path, &result.totalCost);
+	result.sharedSearch = false;
+}
+
+void dtBatchPathQuery::findSharedGoalPaths(dtNavMeshQuery& query, const dtBatchPathRequest* requests, const dtWorkItem& item, dtBatchPathResult* results)
+{
+	const dtBatchPathRequest& goal = requests[m_sortedRequests[item.first]];
+
+	TArray<dtPolyRef, TInlineAllocator<64>> startRefs;
+	TArray<dtReal, TInlineAllocator<64 * 3>> startPos;
+	TArray<dtQueryResult*, TInlineAllocator<64>> paths;
+	TArray<dtReal, TInlineAllocator<64>> totalCosts;
+	TArray<dtStatus, TInlineAllocator<64>> statuses;
+	startRefs.SetNumUninitialized(item.count);
+	startPos.SetNumUninitialized(item.count * 3);
+	paths.SetNumUninitialized(item.count);
+	totalCosts.SetNumUninitialized(item.count);
+	statuses.SetNumUninitialized(item.count);
+
+	// Search up to the largest cost limit, paths going over their own limit are searched again below.
+	dtReal costLimit = 0.0f;
+	for (int i = 0; i < item.count; ++i)
+	{
+		const int requestIdx = m_sortedRequests[item.first + i];
+		const dtBatchPathRequest& request = requests[requestIdx];
+		startRefs[i] = request.startRef;
+		dtVcopy(&startPos[i * 3], request.startPos);
+		paths[i] = &results[requestIdx].path;
+		costLimit = dtMax(costLimit, request.costLimit);
+	}
+
+	query.findPathsToGoal(startRefs.GetData(), startPos.GetData(), item.count, goal.endRef, goal.endPos, costLimit, goal.filter,
+		paths.GetData(), totalCosts.GetData(), statuses.GetData());
+
+	for (int i = 0; i < item.count; ++i)
+	{
+		const int requestIdx = m_sortedRequests[item.first + i];
+		const dtBatchPathRequest& request = requests[requestIdx];
+		dtBatchPathResult& result = results[requestIdx];
+		if (dtStatusSucceed(statuses[i]) && totalCosts[i] <= request.costLimit)
+		{
+			result.status = statuses[i];
+			result.totalCost = totalCosts[i];
+			result.sharedSearch = true;
+		}
+		else
+		{
+			result.path.reserve(0);
+			findSinglePath(query, request, result);
+			m_lastSingleSearchCount++;
+		}
+	}
+}
+
+/// @par
+///
+/// Requests are grouped by end polygon, end position and filter. Groups of at least getMinSharedGoalRequests()
+/// requests run one shared reverse search, all other requests run a findPath() each. Searches are distributed
+/// over up to getContextCount() workers; the batch itself is not thread safe, findPaths() must not be called
+/// concurrently on the same object.
+///
+/// Shared searches evaluate the same traversal costs as findPath() but don't use a heuristic, so with a heuristic
+/// scale above 1 they can return a cheaper corridor than findPath() would for the same request.
+///
+dtStatus dtBatchPathQuery::findPaths(const dtBatchPathRequest* requests, const int requestCount, dtBatchPathResult* results, const bool parallel)
+{
+	dtAssert(m_contexts.Num() > 0);
+
+	m_lastSharedSearchCount = 0;
+	m_lastSingleSearchCount = 0;
+	if (requestCount <= 0)
+		return DT_SUCCESS;
+	if (m_contexts.Num() == 0)
+		return DT_FAILURE | DT_INVALID_PARAM;
+
+	for (int i = 0; i < requestCount; ++i)
+	{
+		results[i].path.reserve(0);
+		results[i].totalCost = 0.0f;
+		results[i].status = DT_FAILURE;
+		results[i].sharedSearch = false;
+	}
+
+	// Sort so requests sharing a goal are next to each other.
+	m_sortedRequests.SetNumUninitialized(requestCount);
+	for (int i = 0; i < requestCount; ++i)
+	{
+		m_sortedRequests[i] = i;
+	}
+	auto sameGoal = [requests](const int a, const int b)
+	{
+		const dtBatchPathRequest& ra = requests[a];
+		const dtBatchPathRequest& rb = requests[b];
+		return ra.endRef == rb.endRef && ra.filter == rb.filter
+			&& ra.endPos[0] == rb.endPos[0] && ra.endPos[1] == rb.endPos[1] && ra.endPos[2] == rb.endPos[2];
+	};
+	if (m_minSharedGoalRequests > 0)
+	{
+		m_sortedRequests.Sort([requests](const int a, const int b)
+		{
+			const dtBatchPathRequest& ra = requests[a];
+			const dtBatchPathRequest& rb = requests[b];
+			if (ra.endRef != rb.endRef) return ra.endRef < rb.endRef;
+			if (ra.filter != rb.filter) return ra.filter < rb.filter;
+			for (int j = 0; j < 3; ++j)
+			{
+				if (ra.endPos[j] != rb.endPos[j]) return ra.endPos[j] < rb.endPos[j];
+			}
+			return a < b;
+		});
+	}
+
+	m_workItems.Reset();
+	for (int first = 0; first < requestCount; )
+	{
+		int count = 1;
+		if (m_minSharedGoalRequests > 0)
+		{
+			while (first + count < requestCount && sameGoal(m_sortedRequests[first], m_sortedRequests[first + count]))
+				count++;
+		}
+
+		const dtBatchPathRequest& goal = requests[m_sortedRequests[first]];
+		if (count > 1 && count >= m_minSharedGoalRequests && goal.endRef)
+		{
+			m_workItems.Add({ first, count });
+			m_lastSharedSearchCount++;
+		}
+		else
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				m_workItems.Add({ first + i, 1 });
+			}
+			m_lastSingleSearchCount += count;
+		}
+		first += count;
+	}
+
+	// Shared searches are the most expensive items, start them first so they don't end up last on a worker.
+	m_workItems.StableSort([](const dtWorkItem& a, const dtWorkItem& b) { return a.count > b.count; });
+
+	ParallelForWithExistingTaskContext(TEXT("dtBatchPathQuery::findPaths"), MakeArrayView(m_contexts), m_workItems.Num(), 1,
+		[this, requests, results](dtNavMeshQuery*& query, int32 itemIdx)
+		{
+			const dtWorkItem& item = m_workItems[itemIdx];
+			if (item.count > 1)
+			{
+				findSharedGoalPaths(*query, requests, item, results);
+			}
+			else
+			{
+				const int requestIdx = m_sortedRequests[item.first];
+				findSinglePath(*query, requests[requestIdx], results[requestIdx]);
+			}
+		},
+		parallel ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+	return DT_SUCCESS;
+}
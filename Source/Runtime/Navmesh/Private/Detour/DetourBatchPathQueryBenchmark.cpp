@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Detour/DetourBatchPathQuery.h"
+#include "Detour/DetourBenchmarkNavMesh.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+namespace UE::Detour::BatchPathBenchmark
+{
+	using namespace UE::Detour::Benchmark;
+
+	static void RunBatchPathBenchmark(const TArray<FString>& args)
+	{
+		int32 tilesPerSide = 8;
+		int32 quadsPerSide = 32;
+		int32 requestCount = 2000;
+		int32 goalCount = 16;
+		int32 maxNodes = 16384;
+		for (const FString& arg : args)
+		{
+			FParse::Value(*arg, TEXT("Tiles="), tilesPerSide);
+			FParse::Value(*arg, TEXT("Quads="), quadsPerSide);
+			FParse::Value(*arg, TEXT("Requests="), requestCount);
+			FParse::Value(*arg, TEXT("Goals="), goalCount);
+			FParse::Value(*arg, TEXT("Nodes="), maxNodes);
+		}
+		tilesPerSide = FMath::Clamp(tilesPerSide, 1, 64);
+		quadsPerSide = FMath::Clamp(quadsPerSide, 2, 64);
+		requestCount = FMath::Max(requestCount, 1);
+		goalCount = FMath::Max(goalCount, 1);
+		maxNodes = FMath::Clamp(maxNodes, 1, 65535);
+
+		dtNavMesh* navMesh = CreateNavMesh(tilesPerSide, quadsPerSide);
+		if (!navMesh)
+		{
+			UE_LOG(LogDetour, Error, TEXT("Batch path benchmark: failed to create the navmesh"));
+			return;
+		}
+
+		dtNavMeshQuery* query = dtAllocNavMeshQuery();
+		query->init(navMesh, maxNodes);
+		query->setRequireNavigableEndLocation(true);
+		dtQueryFilter filter;
+
+		const dtReal worldSize = tilesPerSide * quadsPerSide * VoxelsPerQuad * CellSize;
+		FRandomStream random(4321);
+		TArray<dtBatchPathRequest> goals;
+		goals.SetNum(goalCount);
+		for (dtBatchPathRequest& goal : goals)
+		{
+			FindRandomPoint(*query, filter, worldSize, random, goal.endRef, goal.endPos);
+		}
+
+		TArray<dtBatchPathRequest> requests;
+		requests.SetNum(requestCount);
+		for (dtBatchPathRequest& request : requests)
+		{
+			const dtBatchPathRequest& goal = goals[random.RandHelper(goalCount)];
+			FindRandomPoint(*query, filter, worldSize, random, request.startRef, request.startPos);
+			request.endRef = goal.endRef;
+			dtVcopy(request.endPos, goal.endPos);
+			request.filter = &filter;
+		}
+
+		UE_LOG(LogDetour, Display, TEXT("Batch path benchmark: %d x %d tiles of %d x %d quads, %d requests to %d goals, %d nodes"),
+			tilesPerSide, tilesPerSide, quadsPerSide, quadsPerSide, requestCount, goalCount, maxNodes);
+
+		TArray<dtBatchPathResult> expected;
+		expected.SetNum(requestCount);
+		double startTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < requestCount; ++i)
+		{
+			const dtBatchPathRequest& request = requests[i];
+			expected[i].status = query->findPath(request.startRef, request.endRef, request.startPos, request.endPos, request.costLimit, request.filter, expected[i].path, &expected[i].totalCost);
+		}
+		const double singleSeconds = FPlatformTime::Seconds() - startTime;
+		UE_LOG(LogDetour, Display, TEXT("%-32s %9.2fms  %8.0f paths/s"), TEXT("findPath"), singleSeconds * 1000.0, requestCount / FMath::Max(singleSeconds, UE_DOUBLE_SMALL_NUMBER));
+
+		dtBatchPathQuery batch;
+		batch.init(navMesh, maxNodes);
+		TArray<dtBatchPathResult> results;
+		results.SetNum(requestCount);
+
+		auto runBatch = [&](const TCHAR* label, const int minSharedGoalRequests, const bool parallel)
+		{
+			batch.setMinSharedGoalRequests(minSharedGoalRequests);
+			const double batchStartTime = FPlatformTime::Seconds();
+			batch.findPaths(requests.GetData(), requestCount, results.GetData(), parallel);
+			const double seconds = FPlatformTime::Seconds() - batchStartTime;
+
+			// Shared searches may pick a different corridor of (nearly) the same cost, compare status and cost only.
+			int32 statusMismatches = 0;
+			double expectedCost = 0.0;
+			double batchCost = 0.0;
+			for (int32 i = 0; i < requestCount; ++i)
+			{
+				statusMismatches += expected[i].status != results[i].status ? 1 : 0;
+				if (dtStatusSucceed(expected[i].status) && dtStatusSucceed(results[i].status))
+				{
+					expectedCost += expected[i].totalCost;
+					batchCost += results[i].totalCost;
+				}
+			}
+
+			UE_LOG(LogDetour, Display, TEXT("%-32s %9.2fms  %8.0f paths/s  %.2fx  (%d shared, %d single searches, %d status mismatches, cost ratio %.4f)"),
+				label, seconds * 1000.0, requestCount / FMath::Max(seconds, UE_DOUBLE_SMALL_NUMBER), singleSeconds / FMath::Max(seconds, UE_DOUBLE_SMALL_NUMBER),
+				batch.getLastSharedSearchCount(), batch.getLastSingleSearchCount(), statusMismatches, expectedCost > 0.0 ? batchCost / expectedCost : 1.0);
+		};
+
+		runBatch(TEXT("Batch parallel"), 0, true);
+		runBatch(TEXT("Batch shared goals"), 4, false);
+		runBatch(TEXT("Batch shared goals parallel"), 4, true);
+
+		dtFreeNavMeshQuery(query);
+		dtFreeNavMesh(navMesh);
+	}
+}
+
+static FAutoConsoleCommand DetourBatchPathBenchmarkCmd(
+	TEXT("ai.nav.BatchPathBenchmark"),
+	TEXT("Compare findPath with dtBatchPathQuery, with and without shared goal searches, on a generated tiled navmesh. Usage: ai.nav.BatchPathBenchmark [Tiles=8] [Quads=32] [Requests=2000] [Goals=16] [Nodes=16384]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&UE::Detour::BatchPathBenchmark::RunBatchPathBenchmark));
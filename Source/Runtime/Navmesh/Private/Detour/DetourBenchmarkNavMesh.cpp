@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Detour/DetourBenchmarkNavMesh.h"
+#include "Detour/DetourNavMeshBuilder.h"
+#include "Math/RandomStream.h"
+
+namespace UE::Detour::Benchmark
+{
+	static const unsigned short NullIdx = 0xffff;
+
+	/// Single tile made of a grid of quads with a few random quads missing, all tile edges are portals.
+	static bool CreateTileData(const int tileX, const int tileY, const int quadsPerSide, FRandomStream& random, unsigned char** outData, int* outDataSize)
+	{
+		const int nvp = 4;
+		const int vertsPerSide = quadsPerSide + 1;
+		TArray<unsigned short> verts;
+		verts.Reserve(vertsPerSide * vertsPerSide * 3);
+		for (int z = 0; z < vertsPerSide; ++z)
+		{
+			for (int x = 0; x < vertsPerSide; ++x)
+			{
+				verts.Add((unsigned short)(x * VoxelsPerQuad));
+				verts.Add(0);
+				verts.Add((unsigned short)(z * VoxelsPerQuad));
+			}
+		}
+
+		// Keep the tile border walkable so neighbour tiles always connect.
+		TArray<int> quadToPoly;
+		quadToPoly.Init(-1, quadsPerSide * quadsPerSide);
+		int polyCount = 0;
+		for (int z = 0; z < quadsPerSide; ++z)
+		{
+			for (int x = 0; x < quadsPerSide; ++x)
+			{
+				const bool bBorder = x == 0 || z == 0 || x == quadsPerSide - 1 || z == quadsPerSide - 1;
+				if (bBorder || random.FRand() > 0.2f)
+				{
+					quadToPoly[z * quadsPerSide + x] = polyCount++;
+				}
+			}
+		}
+
+		auto neighbour = [&quadToPoly, quadsPerSide](const int x, const int z, const unsigned short portalDir) -> unsigned short
+		{
+			if (x < 0 || z < 0 || x >= quadsPerSide || z >= quadsPerSide)
+				return 0x8000 | portalDir;
+			const int poly = quadToPoly[z * quadsPerSide + x];
+			return poly >= 0 ? (unsigned short)poly : NullIdx;
+		};
+
+		TArray<unsigned short> polys;
+		polys.Reserve(polyCount * nvp * 2);
+		for (int z = 0; z < quadsPerSide; ++z)
+		{
+			for (int x = 0; x < quadsPerSide; ++x)
+			{
+				if (quadToPoly[z * quadsPerSide + x] < 0)
+					continue;
+
+				// Same winding as rcBuildPolyMesh, edge j goes from vertex j to vertex j+1.
+				polys.Add((unsigned short)(z * vertsPerSide + x));
+				polys.Add((unsigned short)((z + 1) * vertsPerSide + x));
+				polys.Add((unsigned short)((z + 1) * vertsPerSide + x + 1));
+				polys.Add((unsigned short)(z * vertsPerSide + x + 1));
+				polys.Add(neighbour(x - 1, z, 0));
+				polys.Add(neighbour(x, z + 1, 1));
+				polys.Add(neighbour(x + 1, z, 2));
+				polys.Add(neighbour(x, z - 1, 3));
+			}
+		}
+
+		TArray<unsigned short> polyFlags;
+		polyFlags.Init(1, polyCount);
+		TArray<unsigned char> polyAreas;
+		polyAreas.Init(0, polyCount);
+
+		const dtReal tileWidth = quadsPerSide * VoxelsPerQuad * CellSize;
+		dtNavMeshCreateParams params;
+		memset(&params, 0, sizeof(params));
+		params.verts = verts.GetData();
+		params.vertCount = vertsPerSide * vertsPerSide;
+		params.polys = polys.GetData();
+		params.polyFlags = polyFlags.GetData();
+		params.polyAreas = polyAreas.GetData();
+		params.polyCount = polyCount;
+		params.nvp = nvp;
+		params.tileX = tileX;
+		params.tileY = tileY;
+		dtVset(params.bmin, tileX * tileWidth, 0.0f, tileY * tileWidth);
+		dtVset(params.bmax, (tileX + 1) * tileWidth, 100.0f, (tileY + 1) * tileWidth);
+		params.walkableHeight = 200.0f;
+		params.walkableRadius = 35.0f;
+		params.walkableClimb = 50.0f;
+		params.cs = CellSize;
+		params.ch = CellSize;
+		params.buildBvTree = true;
+
+		return dtCreateNavMeshData(&params, outData, outDataSize);
+	}
+
+	dtNavMesh* CreateNavMesh(const int tilesPerSide, const int quadsPerSide)
+	{
+		dtNavMeshParams params;
+		memset(&params, 0, sizeof(params));
+		params.walkableHeight = 200.0f;
+		params.walkableRadius = 35.0f;
+		params.walkableClimb = 50.0f;
+		for (int i = 0; i < DT_RESOLUTION_COUNT; ++i)
+		{
+			params.resolutionParams[i].bvQuantFactor = 1.0f / CellSize;
+		}
+		params.tileWidth = quadsPerSide * VoxelsPerQuad * CellSize;
+		params.tileHeight = params.tileWidth;
+		params.maxTiles = tilesPerSide * tilesPerSide;
+		params.maxPolys = quadsPerSide * quadsPerSide;
+
+		dtNavMesh* navMesh = dtAllocNavMesh();
+		if (!navMesh || dtStatusFailed(navMesh->init(&params)))
+		{
+			dtFreeNavMesh(navMesh);
+			return nullptr;
+		}
+
+		FRandomStream random(1234);
+		for (int tileY = 0; tileY < tilesPerSide; ++tileY)
+		{
+			for (int tileX = 0; tileX < tilesPerSide; ++tileX)
+			{
+				unsigned char* data = nullptr;
+				int dataSize = 0;
+				if (!CreateTileData(tileX, tileY, quadsPerSide, random, &data, &dataSize)
+					|| dtStatusFailed(navMesh->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, nullptr)))
+				{
+					dtFree(data, DT_ALLOC_PERM_TILE_DATA);
+					dtFreeNavMesh(navMesh);
+					return nullptr;
+				}
+			}
+		}
+		return navMesh;
+	}
+
+	bool FindRandomPoint(const dtNavMeshQuery& query, const dtQueryFilter& filter, const dtReal worldSize, FRandomStream& random, dtPolyRef& outRef, dtReal* outPos)
+	{
+		const dtReal extents[3] = { 2.0f * VoxelsPerQuad * CellSize, 50.0f, 2.0f * VoxelsPerQuad * CellSize };
+		for (int attempt = 0; attempt < 16; ++attempt)
+		{
+			const dtReal center[3] = { random.FRand() * worldSize, 0.0f, random.FRand() * worldSize };
+			if (dtStatusSucceed(query.findNearestPoly(center, extents, &filter, &outRef, outPos)) && outRef)
+				return true;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,24 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Detour/DetourNavMesh.h"
+#include "Detour/DetourNavMeshQuery.h"
+
+class FRandomStream;
+
+/** Generated navmeshes shared by the Detour benchmark console commands. */
+namespace UE::Detour::Benchmark
+{
+	inline const dtReal CellSize = 10.0f;
+	inline const int VoxelsPerQuad = 4;
+
+	/**
+	 * Creates a flat navmesh of tilesPerSide x tilesPerSide tiles, each made of quadsPerSide x quadsPerSide quads
+	 * with about 20% of the inner quads missing. The result must be freed with dtFreeNavMesh().
+	 */
+	dtNavMesh* CreateNavMesh(const int tilesPerSide, const int quadsPerSide);
+
+	/** Finds a random location on a navmesh created by CreateNavMesh(), worldSize being its width. */
+	bool FindRandomPoint(const dtNavMeshQuery& query, const dtQueryFilter& filter, const dtReal worldSize, FRandomStream& random, dtPolyRef& outRef, dtReal* outPos);
+}
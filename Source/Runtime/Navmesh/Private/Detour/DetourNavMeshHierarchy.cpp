@@ -0,0 +1,792 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Detour/DetourNavMeshHierarchy.h"
+#include "Algo/Reverse.h"
+#include "Containers/Set.h"
+#include "Detour/DetourAssert.h"
+#include "Detour/DetourCommon.h"
+
+namespace
+{
+	static const unsigned short DT_HIERARCHY_NULL_NODE = 0xffff;
+
+	struct dtHierarchySortedEdge
+	{
+		int source;
+		uint64 target;
+		dtReal cost;
+
+		bool operator<(const dtHierarchySortedEdge& other) const
+		{
+			return source != other.source ? source < other.source : target < other.target;
+		}
+	};
+
+	struct dtHierarchySearchNode
+	{
+		uint64 key;
+		int parent;
+		dtReal cost;
+		bool closed;
+	};
+
+	struct dtHierarchyOpenNode
+	{
+		dtReal total;
+		int idx;
+
+		bool operator<(const dtHierarchyOpenNode& other) const { return total < other.total; }
+	};
+
+	/// A* over an abstract graph, getPos(key) returns the position of a node and forEachEdge(key, visitor)
+	/// calls visitor(target, cost) for all edges of a node which may be traversed.
+	template<typename TGetPos, typename TForEachEdge>
+	bool dtHierarchySearch(const uint64 startKey, const uint64 goalKey, const TGetPos& getPos, const TForEachEdge& forEachEdge, TArray<uint64>& outPath)
+	{
+		const dtReal* goalPos = getPos(goalKey);
+
+		TArray<dtHierarchySearchNode> nodes;
+		TMap<uint64, int> lookup;
+		TArray<dtHierarchyOpenNode> open;
+
+		nodes.Add({ startKey, -1, 0.0f, false });
+		lookup.Add(startKey, 0);
+		open.HeapPush({ dtVdist(getPos(startKey), goalPos), 0 });
+
+		int goalIdx = -1;
+		while (open.Num() > 0)
+		{
+			dtHierarchyOpenNode best;
+			open.HeapPop(best, false);
+
+			// Nodes are pushed again when their cost improves, skip the outdated entries.
+			if (nodes[best.idx].closed)
+				continue;
+			nodes[best.idx].closed = true;
+
+			const uint64 bestKey = nodes[best.idx].key;
+			if (bestKey == goalKey)
+			{
+				goalIdx = best.idx;
+				break;
+			}
+
+			const dtReal bestCost = nodes[best.idx].cost;
+			const int bestIdx = best.idx;
+			forEachEdge(bestKey, [&](const uint64 target, const dtReal edgeCost)
+			{
+				const dtReal cost = bestCost + edgeCost;
+				int* existingIdx = lookup.Find(target);
+				if (existingIdx)
+				{
+					dtHierarchySearchNode& existing = nodes[*existingIdx];
+					if (existing.closed || existing.cost <= cost)
+						return;
+					existing.cost = cost;
+					existing.parent = bestIdx;
+					open.HeapPush({ cost + dtVdist(getPos(target), goalPos), *existingIdx });
+				}
+				else
+				{
+					const int idx = nodes.Add({ target, bestIdx, cost, false });
+					lookup.Add(target, idx);
+					open.HeapPush({ cost + dtVdist(getPos(target), goalPos), idx });
+				}
+			});
+		}
+
+		outPath.Reset();
+		if (goalIdx < 0)
+			return false;
+
+		for (int idx = goalIdx; idx >= 0; idx = nodes[idx].parent)
+		{
+			outPath.Add(nodes[idx].key);
+		}
+		Algo::Reverse(outPath);
+		return true;
+	}
+
+	int dtFloorDiv(const int value, const int divisor)
+	{
+		return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+	}
+}
+
+dtNavMeshHierarchy::dtNavMeshHierarchy()
+	: m_nav(0)
+{
+}
+
+dtNavMeshHierarchy::~dtNavMeshHierarchy()
+{
+}
+
+dtStatus dtNavMeshHierarchy::init(const dtNavMesh* nav, const dtNavMeshHierarchyParams& params)
+{
+	m_nav = nav;
+	m_params = params;
+	m_tiles.Reset();
+	m_clusters.Reset();
+	m_clusterLookup.Reset();
+	if (!nav || params.tilesPerCluster <= 0)
+	{
+		m_nav = 0;
+		return DT_FAILURE | DT_INVALID_PARAM;
+	}
+
+	if (m_params.refineDistance <= 0.0f)
+	{
+		m_params.refineDistance = nav->getParams()->tileWidth;
+	}
+	if (m_params.minPathDistance <= 0.0f)
+	{
+		m_params.minPathDistance = 2.0f * m_params.refineDistance;
+	}
+
+	m_tiles.SetNum(nav->getMaxTiles());
+	for (dtHierarchyTile& tile : m_tiles)
+	{
+		tile.ref = 0;
+		tile.x = 0;
+		tile.y = 0;
+		tile.cluster = -1;
+	}
+
+	TArray<dtTileRef> tileRefs;
+	for (int i = 0; i < nav->getMaxTiles(); ++i)
+	{
+		const dtMeshTile* tile = nav->getTile(i);
+		if (tile && tile->header)
+		{
+			tileRefs.Add(nav->getTileRef(tile));
+		}
+	}
+	updateTiles(tileRefs.GetData(), tileRefs.Num());
+
+	return DT_SUCCESS;
+}
+
+int dtNavMeshHierarchy::getNodeCount() const
+{
+	int count = 0;
+	for (const dtHierarchyTile& tile : m_tiles)
+	{
+		count += tile.nodes.Num();
+	}
+	return count;
+}
+
+int dtNavMeshHierarchy::getClusterNodeCount() const
+{
+	int count = 0;
+	for (const dtHierarchyCluster& cluster : m_clusters)
+	{
+		count += cluster.components.Num();
+	}
+	return count;
+}
+
+int dtNavMeshHierarchy::getClusterIndex(const int tileX, const int tileY)
+{
+	const int clusterX = dtFloorDiv(tileX, m_params.tilesPerCluster);
+	const int clusterY = dtFloorDiv(tileY, m_params.tilesPerCluster);
+	const uint64 key = ((uint64)(uint32)clusterX << 32) | (uint64)(uint32)clusterY;
+	if (const int* clusterIdx = m_clusterLookup.Find(key))
+		return *clusterIdx;
+
+	const int clusterIdx = m_clusters.AddDefaulted();
+	m_clusterLookup.Add(key, clusterIdx);
+	return clusterIdx;
+}
+
+void dtNavMeshHierarchy::buildTileNodes(const int tileIdx, TArray<int>& dirtyClusters)
+{
+	dtHierarchyTile& htile = m_tiles[tileIdx];
+	const dtMeshTile* tile = m_nav->getTile(tileIdx);
+	const bool hasTile = tile && tile->header;
+
+	const int oldCluster = htile.cluster;
+	const int newCluster = hasTile ? getClusterIndex(tile->header->x, tile->header->y) : -1;
+	if (oldCluster != newCluster)
+	{
+		if (oldCluster >= 0)
+		{
+			m_clusters[oldCluster].tiles.RemoveSwap(tileIdx);
+			dirtyClusters.AddUnique(oldCluster);
+		}
+		if (newCluster >= 0)
+		{
+			m_clusters[newCluster].tiles.Add(tileIdx);
+		}
+	}
+	if (newCluster >= 0)
+	{
+		dirtyClusters.AddUnique(newCluster);
+	}
+
+	htile.cluster = newCluster;
+	htile.polyNodes.Reset();
+	htile.nodes.Reset();
+	htile.edges.Reset();
+	if (!hasTile)
+	{
+		htile.ref = 0;
+		return;
+	}
+
+	htile.ref = m_nav->getTileRef(tile);
+	htile.x = tile->header->x;
+	htile.y = tile->header->y;
+
+	// Union polygons linked to each other within the tile, ignoring link direction.
+	const int polyCount = tile->header->polyCount;
+	TArray<int, TInlineAllocator<256>> parents;
+	parents.SetNumUninitialized(polyCount);
+	for (int i = 0; i < polyCount; ++i)
+	{
+		parents[i] = i;
+	}
+	auto findRoot = [&parents](int i)
+	{
+		while (parents[i] != i)
+		{
+			parents[i] = parents[parents[i]];
+			i = parents[i];
+		}
+		return i;
+	};
+
+	for (int i = 0; i < polyCount; ++i)
+	{
+		const dtPoly& poly = tile->polys[i];
+		for (unsigned int linkIdx = poly.firstLink; linkIdx != DT_NULL_LINK; linkIdx = m_nav->getLink(tile, linkIdx).next)
+		{
+			const dtPolyRef neighbourRef = m_nav->getLink(tile, linkIdx).ref;
+			if (neighbourRef && (int)m_nav->decodePolyIdTile(neighbourRef) == tileIdx)
+			{
+				const int rootA = findRoot(i);
+				const int rootB = findRoot((int)m_nav->decodePolyIdPoly(neighbourRef));
+				parents[rootA] = rootB;
+			}
+		}
+	}
+
+	TArray<dtReal, TInlineAllocator<256 * 3>> centers;
+	centers.SetNumUninitialized(polyCount * 3);
+	htile.polyNodes.SetNumUninitialized(polyCount);
+	TArray<int, TInlineAllocator<256>> rootNodes;
+	rootNodes.Init(-1, polyCount);
+	TArray<int, TInlineAllocator<64>> nodePolyCounts;
+	for (int i = 0; i < polyCount; ++i)
+	{
+		const dtPoly& poly = tile->polys[i];
+		dtCalcPolyCenter(&centers[i * 3], poly.verts, poly.vertCount, tile->verts);
+
+		const int root = findRoot(i);
+		if (rootNodes[root] < 0)
+		{
+			rootNodes[root] = htile.nodes.AddZeroed();
+			nodePolyCounts.Add(0);
+		}
+		const int nodeIdx = rootNodes[root];
+		htile.polyNodes[i] = (unsigned short)nodeIdx;
+		dtVadd(htile.nodes[nodeIdx].pos, htile.nodes[nodeIdx].pos, &centers[i * 3]);
+		nodePolyCounts[nodeIdx]++;
+	}
+
+	// Represent each island with the ground polygon closest to its average center.
+	TArray<dtReal, TInlineAllocator<64>> bestDistances;
+	bestDistances.Init(DT_REAL_MAX, htile.nodes.Num());
+	for (int nodeIdx = 0; nodeIdx < htile.nodes.Num(); ++nodeIdx)
+	{
+		dtVscale(htile.nodes[nodeIdx].pos, htile.nodes[nodeIdx].pos, 1.0f / nodePolyCounts[nodeIdx]);
+	}
+	const dtPolyRef polyRefBase = m_nav->getPolyRefBase(tile);
+	for (int i = 0; i < polyCount; ++i)
+	{
+		dtHierarchyNode& node = htile.nodes[htile.polyNodes[i]];
+		const bool isGround = tile->polys[i].getType() == DT_POLYTYPE_GROUND;
+		const dtReal distance = dtVdistSqr(node.pos, &centers[i * 3]) + (isGround ? 0.0f : DT_REAL_MAX * 0.5f);
+		if (!node.poly || distance < bestDistances[htile.polyNodes[i]])
+		{
+			bestDistances[htile.polyNodes[i]] = distance;
+			node.poly = polyRefBase | (dtPolyRef)i;
+		}
+	}
+	for (dtHierarchyNode& node : htile.nodes)
+	{
+		dtVcopy(node.pos, &centers[m_nav->decodePolyIdPoly(node.poly) * 3]);
+		node.component = -1;
+	}
+}
+
+void dtNavMeshHierarchy::buildTileEdges(const int tileIdx)
+{
+	dtHierarchyTile& htile = m_tiles[tileIdx];
+	htile.edges.Reset();
+	if (!htile.ref)
+		return;
+
+	const dtMeshTile* tile = m_nav->getTile(tileIdx);
+	TArray<dtHierarchySortedEdge, TInlineAllocator<64>> edges;
+	for (int i = 0; i < tile->header->polyCount; ++i)
+	{
+		const dtPoly& poly = tile->polys[i];
+		const dtHierarchyNode& node = htile.nodes[htile.polyNodes[i]];
+		for (unsigned int linkIdx = poly.firstLink; linkIdx != DT_NULL_LINK; linkIdx = m_nav->getLink(tile, linkIdx).next)
+		{
+			const dtLink& link = m_nav->getLink(tile, linkIdx);
+			uint64 targetKey = 0;
+			const dtHierarchyNode* target = link.ref ? getPolyNode(link.ref, targetKey) : 0;
+			if (!target || getKeyIndex(targetKey) == tileIdx)
+				continue;
+
+			// Cross at the middle of the shared edge, off-mesh links are crossed from the polygon center.
+			dtReal portal[3];
+			if (poly.getType() == DT_POLYTYPE_GROUND && link.edge < poly.vertCount)
+			{
+				const dtReal* va = &tile->verts[poly.verts[link.edge] * 3];
+				const dtReal* vb = &tile->verts[poly.verts[(link.edge + 1) % poly.vertCount] * 3];
+				dtVlerp(portal, va, vb, 0.5f);
+			}
+			else
+			{
+				dtCalcPolyCenter(portal, poly.verts, poly.vertCount, tile->verts);
+			}
+
+			edges.Add({ htile.polyNodes[i], targetKey, dtVdist(node.pos, portal) + dtVdist(portal, target->pos) });
+		}
+	}
+
+	// Keep the cheapest edge to each target node.
+	edges.Sort();
+	for (dtHierarchyNode& node : htile.nodes)
+	{
+		node.firstEdge = 0;
+		node.edgeCount = 0;
+	}
+	for (int i = 0; i < edges.Num(); ++i)
+	{
+		const dtHierarchySortedEdge& edge = edges[i];
+		dtHierarchyNode& node = htile.nodes[edge.source];
+		if (node.edgeCount > 0 && htile.edges.Last().target == edge.target)
+		{
+			htile.edges.Last().cost = dtMin(htile.edges.Last().cost, edge.cost);
+			continue;
+		}
+		if (node.edgeCount == 0)
+		{
+			node.firstEdge = htile.edges.Num();
+		}
+		htile.edges.Add({ edge.target, edge.cost });
+		node.edgeCount++;
+	}
+}
+
+void dtNavMeshHierarchy::buildClusterComponents(const int clusterIdx)
+{
+	dtHierarchyCluster& cluster = m_clusters[clusterIdx];
+	cluster.components.Reset();
+	for (const int tileIdx : cluster.tiles)
+	{
+		for (dtHierarchyNode& node : m_tiles[tileIdx].nodes)
+		{
+			node.component = -1;
+		}
+	}
+
+	// Flood fill over the edges staying inside the cluster.
+	TArray<uint64, TInlineAllocator<64>> stack;
+	TArray<int, TInlineAllocator<64>> componentNodeCounts;
+	for (const int tileIdx : cluster.tiles)
+	{
+		for (int nodeIdx = 0; nodeIdx < m_tiles[tileIdx].nodes.Num(); ++nodeIdx)
+		{
+			if (m_tiles[tileIdx].nodes[nodeIdx].component >= 0)
+				continue;
+
+			const int componentIdx = cluster.components.AddZeroed();
+			componentNodeCounts.Add(0);
+			m_tiles[tileIdx].nodes[nodeIdx].component = componentIdx;
+			stack.Add(makeKey(tileIdx, nodeIdx));
+			while (stack.Num() > 0)
+			{
+				const uint64 key = stack.Pop(false);
+				const dtHierarchyTile& htile = m_tiles[getKeyIndex(key)];
+				const dtHierarchyNode& node = htile.nodes[getKeyNode(key)];
+				dtVadd(cluster.components[componentIdx].pos, cluster.components[componentIdx].pos, node.pos);
+				componentNodeCounts[componentIdx]++;
+
+				for (int edgeIdx = node.firstEdge; edgeIdx < node.firstEdge + node.edgeCount; ++edgeIdx)
+				{
+					const uint64 target = htile.edges[edgeIdx].target;
+					dtHierarchyTile& targetTile = m_tiles[getKeyIndex(target)];
+					dtHierarchyNode& targetNode = targetTile.nodes[getKeyNode(target)];
+					if (targetTile.cluster == clusterIdx && targetNode.component < 0)
+					{
+						targetNode.component = componentIdx;
+						stack.Add(target);
+					}
+				}
+			}
+		}
+	}
+
+	// Snap each component to its member node closest to the average position, so it stays on the navmesh.
+	TArray<dtReal, TInlineAllocator<64>> bestDistances;
+	bestDistances.Init(DT_REAL_MAX, cluster.components.Num());
+	TArray<dtReal, TInlineAllocator<64 * 3>> centers;
+	centers.SetNumUninitialized(cluster.components.Num() * 3);
+	for (int componentIdx = 0; componentIdx < cluster.components.Num(); ++componentIdx)
+	{
+		dtVscale(&centers[componentIdx * 3], cluster.components[componentIdx].pos, 1.0f / componentNodeCounts[componentIdx]);
+	}
+	for (const int tileIdx : cluster.tiles)
+	{
+		for (const dtHierarchyNode& node : m_tiles[tileIdx].nodes)
+		{
+			const dtReal distance = dtVdistSqr(node.pos, &centers[node.component * 3]);
+			if (distance < bestDistances[node.component])
+			{
+				bestDistances[node.component] = distance;
+				dtVcopy(cluster.components[node.component].pos, node.pos);
+			}
+		}
+	}
+}
+
+void dtNavMeshHierarchy::buildClusterEdges(const int clusterIdx)
+{
+	dtHierarchyCluster& cluster = m_clusters[clusterIdx];
+	cluster.edges.Reset();
+
+	TArray<dtHierarchySortedEdge, TInlineAllocator<64>> edges;
+	for (const int tileIdx : cluster.tiles)
+	{
+		const dtHierarchyTile& htile = m_tiles[tileIdx];
+		for (const dtHierarchyNode& node : htile.nodes)
+		{
+			for (int edgeIdx = node.firstEdge; edgeIdx < node.firstEdge + node.edgeCount; ++edgeIdx)
+			{
+				const dtHierarchyTile& targetTile = m_tiles[getKeyIndex(htile.edges[edgeIdx].target)];
+				const dtHierarchyNode& targetNode = targetTile.nodes[getKeyNode(htile.edges[edgeIdx].target)];
+
+				// One way links can also connect components of the same cluster.
+				if (targetTile.cluster != clusterIdx || targetNode.component != node.component)
+				{
+					const dtHierarchyComponent& targetComponent = m_clusters[targetTile.cluster].components[targetNode.component];
+					edges.Add({ node.component, makeKey(targetTile.cluster, targetNode.component),
+						dtVdist(cluster.components[node.component].pos, targetComponent.pos) });
+				}
+			}
+		}
+	}
+
+	edges.Sort();
+	for (dtHierarchyComponent& component : cluster.components)
+	{
+		component.firstEdge = 0;
+		component.edgeCount = 0;
+	}
+	for (const dtHierarchySortedEdge& edge : edges)
+	{
+		dtHierarchyComponent& component = cluster.components[edge.source];
+		if (component.edgeCount > 0 && cluster.edges.Last().target == edge.target)
+			continue;
+		if (component.edgeCount == 0)
+		{
+			component.firstEdge = cluster.edges.Num();
+		}
+		cluster.edges.Add({ edge.target, edge.cost });
+		component.edgeCount++;
+	}
+}
+
+/// @par
+///
+/// Tile edges only exist between neighbouring tiles, so the edges of the tiles around each updated tile are
+/// rebuilt, as well as the level 1 graph of every tile cluster around the updated tiles.
+///
+void dtNavMeshHierarchy::updateTiles(const dtTileRef* tileRefs, const int count)
+{
+	if (!m_nav || count <= 0)
+		return;
+
+	TArray<int> dirtyTiles;
+	for (int i = 0; i < count; ++i)
+	{
+		const int tileIdx = (int)m_nav->decodePolyIdTile(tileRefs[i]);
+		if (m_tiles.IsValidIndex(tileIdx))
+		{
+			dirtyTiles.AddUnique(tileIdx);
+		}
+	}
+
+	// Grid locations of the dirty tiles, before and after the update.
+	TArray<FIntPoint> dirtyLocations;
+	TArray<int> dirtyClusters;
+	for (const int tileIdx : dirtyTiles)
+	{
+		if (m_tiles[tileIdx].ref)
+		{
+			dirtyLocations.AddUnique(FIntPoint(m_tiles[tileIdx].x, m_tiles[tileIdx].y));
+		}
+		buildTileNodes(tileIdx, dirtyClusters);
+		if (m_tiles[tileIdx].ref)
+		{
+			dirtyLocations.AddUnique(FIntPoint(m_tiles[tileIdx].x, m_tiles[tileIdx].y));
+		}
+	}
+
+	TSet<int> edgeTiles;
+	edgeTiles.Append(dirtyTiles);
+	TArray<const dtMeshTile*, TInlineAllocator<8>> layers;
+	for (const FIntPoint& location : dirtyLocations)
+	{
+		for (int y = location.Y - 1; y <= location.Y + 1; ++y)
+		{
+			for (int x = location.X - 1; x <= location.X + 1; ++x)
+			{
+				layers.SetNumUninitialized(m_nav->getTileCountAt(x, y));
+				const int layerCount = m_nav->getTilesAt(x, y, layers.GetData(), layers.Num());
+				for (int i = 0; i < layerCount; ++i)
+				{
+					edgeTiles.Add((int)m_nav->decodePolyIdTile(m_nav->getTileRef(layers[i])));
+				}
+			}
+		}
+	}
+	for (const int tileIdx : edgeTiles)
+	{
+		buildTileEdges(tileIdx);
+	}
+
+	for (const int clusterIdx : dirtyClusters)
+	{
+		buildClusterComponents(clusterIdx);
+	}
+
+	// Rebuild the edges of every cluster which may point to a component which was just renumbered.
+	TSet<int> edgeClusters;
+	for (const int clusterIdx : dirtyClusters)
+	{
+		edgeClusters.Add(clusterIdx);
+	}
+	for (const int tileIdx : edgeTiles)
+	{
+		if (m_tiles[tileIdx].cluster >= 0)
+		{
+			edgeClusters.Add(m_tiles[tileIdx].cluster);
+		}
+	}
+	for (const int clusterIdx : dirtyClusters)
+	{
+		for (const int tileIdx : m_clusters[clusterIdx].tiles)
+		{
+			const dtHierarchyTile& htile = m_tiles[tileIdx];
+			for (int y = htile.y - 1; y <= htile.y + 1; ++y)
+			{
+				for (int x = htile.x - 1; x <= htile.x + 1; ++x)
+				{
+					layers.SetNumUninitialized(m_nav->getTileCountAt(x, y));
+					const int layerCount = m_nav->getTilesAt(x, y, layers.GetData(), layers.Num());
+					for (int i = 0; i < layerCount; ++i)
+					{
+						const int cluster = m_tiles[m_nav->decodePolyIdTile(m_nav->getTileRef(layers[i]))].cluster;
+						if (cluster >= 0)
+						{
+							edgeClusters.Add(cluster);
+						}
+					}
+				}
+			}
+		}
+	}
+	for (const int clusterIdx : edgeClusters)
+	{
+		buildClusterEdges(clusterIdx);
+	}
+}
+
+const dtNavMeshHierarchy::dtHierarchyNode* dtNavMeshHierarchy::getPolyNode(dtPolyRef ref, uint64& key) const
+{
+	const int tileIdx = (int)m_nav->decodePolyIdTile(ref);
+	if (!m_tiles.IsValidIndex(tileIdx))
+		return 0;
+
+	const dtHierarchyTile& htile = m_tiles[tileIdx];
+	const int polyIdx = (int)m_nav->decodePolyIdPoly(ref);
+	if (!htile.ref || m_nav->decodePolyIdSalt(htile.ref) != m_nav->decodePolyIdSalt(ref) || !htile.polyNodes.IsValidIndex(polyIdx))
+		return 0;
+
+	const unsigned short nodeIdx = htile.polyNodes[polyIdx];
+	if (nodeIdx == DT_HIERARCHY_NULL_NODE || !htile.nodes.IsValidIndex(nodeIdx))
+		return 0;
+
+	key = makeKey(tileIdx, nodeIdx);
+	return &htile.nodes[nodeIdx];
+}
+
+/// @par
+///
+/// The level 1 corridor limits the level 0 search, whose nodes are then used as waypoints: every segment
+/// goes to the farthest node of the abstract path within getParams().refineDistance and is found with
+/// a findPath() on @p query, so its node pool only has to cover a refine distance. Loops created where
+/// segments meet are cut from the corridor.
+///
+/// A flat findPath() is used for requests shorter than getParams().minPathDistance, requests inside a single
+/// level 1 node, and whenever the abstract search or a refined segment fails, so the result is never worse
+/// than findPath() in terms of reachability.
+///
+dtStatus dtNavMeshHierarchy::findPath(const dtNavMeshQuery& query, dtPolyRef startRef, dtPolyRef endRef,
+	const dtReal* startPos, const dtReal* endPos, const dtReal costLimit, const dtQueryFilter* filter,
+	dtQueryResult& result, dtReal* totalCost, int* segmentCount) const
+{
+	if (segmentCount)
+		*segmentCount = 0;
+
+	auto findFlatPath = [&]()
+	{
+		return query.findPath(startRef, endRef, startPos, endPos, costLimit, filter, result, totalCost);
+	};
+
+	if (!m_nav || query.getAttachedNavMesh() != m_nav || !startRef || !endRef || !startPos || !endPos || !filter
+		|| dtVdist(startPos, endPos) < m_params.minPathDistance)
+	{
+		return findFlatPath();
+	}
+
+	uint64 startKey = 0;
+	uint64 endKey = 0;
+	const dtHierarchyNode* startNode = getPolyNode(startRef, startKey);
+	const dtHierarchyNode* endNode = getPolyNode(endRef, endKey);
+	if (!startNode || !endNode)
+		return findFlatPath();
+
+	const uint64 startClusterKey = makeKey(m_tiles[getKeyIndex(startKey)].cluster, startNode->component);
+	const uint64 endClusterKey = makeKey(m_tiles[getKeyIndex(endKey)].cluster, endNode->component);
+	if (startClusterKey == endClusterKey)
+		return findFlatPath();
+
+	// Level 1 corridor.
+	TArray<uint64> clusterPath;
+	const bool foundClusterPath = dtHierarchySearch(startClusterKey, endClusterKey,
+		[this](const uint64 key) { return m_clusters[getKeyIndex(key)].components[getKeyNode(key)].pos; },
+		[this](const uint64 key, const auto& visit)
+		{
+			const dtHierarchyCluster& cluster = m_clusters[getKeyIndex(key)];
+			const dtHierarchyComponent& component = cluster.components[getKeyNode(key)];
+			for (int i = component.firstEdge; i < component.firstEdge + component.edgeCount; ++i)
+			{
+				visit(cluster.edges[i].target, cluster.edges[i].cost);
+			}
+		},
+		clusterPath);
+	if (!foundClusterPath)
+		return findFlatPath();
+
+	TSet<uint64> corridor;
+	corridor.Append(clusterPath);
+
+	// Level 0 path through the corridor.
+	TArray<uint64> nodePath;
+	const bool foundNodePath = dtHierarchySearch(startKey, endKey,
+		[this](const uint64 key) { return m_tiles[getKeyIndex(key)].nodes[getKeyNode(key)].pos; },
+		[this, &corridor](const uint64 key, const auto& visit)
+		{
+			const dtHierarchyTile& htile = m_tiles[getKeyIndex(key)];
+			const dtHierarchyNode& node = htile.nodes[getKeyNode(key)];
+			for (int i = node.firstEdge; i < node.firstEdge + node.edgeCount; ++i)
+			{
+				const dtHierarchyEdge& edge = htile.edges[i];
+				const dtHierarchyTile& targetTile = m_tiles[getKeyIndex(edge.target)];
+				if (corridor.Contains(makeKey(targetTile.cluster, targetTile.nodes[getKeyNode(edge.target)].component)))
+				{
+					visit(edge.target, edge.cost);
+				}
+			}
+		},
+		nodePath);
+	if (!foundNodePath)
+		return findFlatPath();
+
+	// Refine segment by segment.
+	TArray<dtPolyRef> refs;
+	TArray<dtReal> costs;
+	TMap<dtPolyRef, int> refIndices;
+	dtReal pathCost = 0.0f;
+	dtPolyRef currentRef = startRef;
+	dtReal currentPos[3];
+	dtVcopy(currentPos, startPos);
+	const dtReal refineDistanceSqr = dtSqr(m_params.refineDistance);
+	const int lastNode = nodePath.Num() - 1;
+	int segments = 0;
+	for (int nodeIdx = 0; ; )
+	{
+		int nextIdx = nodeIdx + 1;
+		bool isLastSegment = nextIdx >= lastNode || dtVdist2DSqr(currentPos, endPos) <= refineDistanceSqr;
+		while (!isLastSegment && nextIdx + 1 < lastNode
+			&& dtVdist2DSqr(currentPos, m_tiles[getKeyIndex(nodePath[nextIdx + 1])].nodes[getKeyNode(nodePath[nextIdx + 1])].pos) <= refineDistanceSqr)
+		{
+			nextIdx++;
+		}
+
+		const dtHierarchyNode& waypoint = m_tiles[getKeyIndex(nodePath[nextIdx])].nodes[getKeyNode(nodePath[nextIdx])];
+		const dtPolyRef targetRef = isLastSegment ? endRef : waypoint.poly;
+		const dtReal* targetPos = isLastSegment ? endPos : waypoint.pos;
+
+		// Fresh result per segment, the query appends to it.
+		dtQueryResult segment;
+		const dtReal segmentCostLimit = costLimit - pathCost;
+		const dtStatus status = segmentCostLimit > 0.0f
+			? query.findPath(currentRef, targetRef, currentPos, targetPos, segmentCostLimit, filter, segment, 0)
+			: DT_FAILURE;
+		if (dtStatusFailed(status) || dtStatusDetail(status, DT_PARTIAL_RESULT))
+			return findFlatPath();
+
+		for (int i = refs.Num() > 0 ? 1 : 0; i < segment.size(); ++i)
+		{
+			const dtPolyRef ref = segment.getRef(i);
+			const dtReal cost = segment.getCost(i);
+			if (const int* existingIdx = refIndices.Find(ref))
+			{
+				// The corridor came back to a polygon it already went through, drop the loop.
+				const int keepCount = *existingIdx + 1;
+				for (int j = keepCount; j < refs.Num(); ++j)
+				{
+					refIndices.Remove(refs[j]);
+					pathCost -= costs[j];
+				}
+				refs.SetNum(keepCount, false);
+				costs.SetNum(keepCount, false);
+				continue;
+			}
+
+			refIndices.Add(ref, refs.Num());
+			refs.Add(ref);
+			costs.Add(cost);
+			pathCost += cost;
+		}
+		segments++;
+
+		if (isLastSegment)
+			break;
+
+		currentRef = targetRef;
+		dtVcopy(currentPos, targetPos);
+		nodeIdx = nextIdx;
+	}
+
+	result.reserve(refs.Num());
+	for (int i = 0; i < refs.Num(); ++i)
+	{
+		result.addItem(refs[i], costs[i], 0, 0);
+	}
+	if (totalCost)
+		*totalCost = pathCost;
+	if (segmentCount)
+		*segmentCount = segments;
+
+	return DT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Detour/DetourNavMeshHierarchy.h"
+#include "Detour/DetourBenchmarkNavMesh.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+namespace UE::Detour::HierarchyBenchmark
+{
+	using namespace UE::Detour::Benchmark;
+
+	static void RunHierarchyBenchmark(const TArray<FString>& args)
+	{
+		int32 tilesPerSide = 32;
+		int32 quadsPerSide = 32;
+		int32 requestCount = 100;
+		int32 maxNodes = 4096;
+		int32 tilesPerCluster = 4;
+		float minDistance = 0.5f;
+		for (const FString& arg : args)
+		{
+			FParse::Value(*arg, TEXT("Tiles="), tilesPerSide);
+			FParse::Value(*arg, TEXT("Quads="), quadsPerSide);
+			FParse::Value(*arg, TEXT("Requests="), requestCount);
+			FParse::Value(*arg, TEXT("Nodes="), maxNodes);
+			FParse::Value(*arg, TEXT("Cluster="), tilesPerCluster);
+			FParse::Value(*arg, TEXT("MinDistance="), minDistance);
+		}
+		tilesPerSide = FMath::Clamp(tilesPerSide, 2, 128);
+		quadsPerSide = FMath::Clamp(quadsPerSide, 2, 64);
+		requestCount = FMath::Max(requestCount, 1);
+		maxNodes = FMath::Clamp(maxNodes, 1, 65535);
+		tilesPerCluster = FMath::Max(tilesPerCluster, 1);
+		minDistance = FMath::Clamp(minDistance, 0.0f, 1.0f);
+
+		const double buildStartTime = FPlatformTime::Seconds();
+		dtNavMesh* navMesh = CreateNavMesh(tilesPerSide, quadsPerSide);
+		if (!navMesh)
+		{
+			UE_LOG(LogDetour, Error, TEXT("Hierarchy benchmark: failed to create the navmesh"));
+			return;
+		}
+		const double navMeshSeconds = FPlatformTime::Seconds() - buildStartTime;
+
+		dtNavMeshHierarchyParams params;
+		params.tilesPerCluster = tilesPerCluster;
+		dtNavMeshHierarchy hierarchy;
+		const double hierarchyStartTime = FPlatformTime::Seconds();
+		hierarchy.init(navMesh, params);
+		const double hierarchySeconds = FPlatformTime::Seconds() - hierarchyStartTime;
+
+		UE_LOG(LogDetour, Display, TEXT("Hierarchy benchmark: %d x %d tiles of %d x %d quads, navmesh %.2fms, hierarchy %.2fms (%d nodes, %d cluster nodes)"),
+			tilesPerSide, tilesPerSide, quadsPerSide, quadsPerSide, navMeshSeconds * 1000.0, hierarchySeconds * 1000.0,
+			hierarchy.getNodeCount(), hierarchy.getClusterNodeCount());
+
+		// Rebuild a few tiles the way the navmesh generator does, removing and adding them back.
+		FRandomStream random(4321);
+		const int32 rebuiltTileCount = 16;
+		double updateSeconds = 0.0;
+		for (int32 i = 0; i < rebuiltTileCount; ++i)
+		{
+			const dtTileRef oldRef = navMesh->getTileRefAt(random.RandHelper(tilesPerSide), random.RandHelper(tilesPerSide), 0);
+			unsigned char* data = nullptr;
+			int dataSize = 0;
+			dtTileRef newRef = 0;
+			if (dtStatusFailed(navMesh->removeTile(oldRef, &data, &dataSize)))
+			{
+				continue;
+			}
+			if (dtStatusFailed(navMesh->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, &newRef)))
+			{
+				dtFree(data, DT_ALLOC_PERM_TILE_DATA);
+				continue;
+			}
+
+			const double updateStartTime = FPlatformTime::Seconds();
+			hierarchy.updateTiles(&newRef, 1);
+			updateSeconds += FPlatformTime::Seconds() - updateStartTime;
+		}
+		UE_LOG(LogDetour, Display, TEXT("Tile update: %.3fms per tile"), updateSeconds * 1000.0 / rebuiltTileCount);
+
+		dtNavMeshQuery* query = dtAllocNavMeshQuery();
+		query->init(navMesh, maxNodes);
+		dtQueryFilter filter;
+
+		// Requests between points at least MinDistance of the world width apart.
+		const dtReal worldSize = tilesPerSide * quadsPerSide * VoxelsPerQuad * CellSize;
+		struct FRequest
+		{
+			dtPolyRef startRef = 0;
+			dtPolyRef endRef = 0;
+			dtReal startPos[3];
+			dtReal endPos[3];
+		};
+		TArray<FRequest> requests;
+		requests.SetNum(requestCount);
+		for (FRequest& request : requests)
+		{
+			for (int32 attempt = 0; attempt < 64; ++attempt)
+			{
+				FindRandomPoint(*query, filter, worldSize, random, request.startRef, request.startPos);
+				FindRandomPoint(*query, filter, worldSize, random, request.endRef, request.endPos);
+				if (dtVdist2D(request.startPos, request.endPos) >= minDistance * worldSize)
+					break;
+			}
+		}
+
+		dtQueryResult path;
+		int32 flatComplete = 0;
+		double flatCost = 0.0;
+		TArray<bool> flatCompleted;
+		flatCompleted.Init(false, requestCount);
+		TArray<dtReal> flatCosts;
+		flatCosts.Init(0.0f, requestCount);
+		double startTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < requestCount; ++i)
+		{
+			const FRequest& request = requests[i];
+			const dtStatus status = query->findPath(request.startRef, request.endRef, request.startPos, request.endPos, DT_REAL_MAX, &filter, path, &flatCosts[i]);
+			flatCompleted[i] = dtStatusSucceed(status) && !dtStatusDetail(status, DT_PARTIAL_RESULT);
+			flatComplete += flatCompleted[i] ? 1 : 0;
+		}
+		const double flatSeconds = FPlatformTime::Seconds() - startTime;
+
+		int32 hierarchyComplete = 0;
+		int32 segmentTotal = 0;
+		double hierarchyCost = 0.0;
+		startTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < requestCount; ++i)
+		{
+			const FRequest& request = requests[i];
+			dtReal cost = 0.0f;
+			int segments = 0;
+			const dtStatus status = hierarchy.findPath(*query, request.startRef, request.endRef, request.startPos, request.endPos, DT_REAL_MAX, &filter, path, &cost, &segments);
+			const bool bComplete = dtStatusSucceed(status) && !dtStatusDetail(status, DT_PARTIAL_RESULT);
+			hierarchyComplete += bComplete ? 1 : 0;
+			segmentTotal += segments;
+			if (bComplete && flatCompleted[i])
+			{
+				flatCost += flatCosts[i];
+				hierarchyCost += cost;
+			}
+		}
+		const double hierarchicalSeconds = FPlatformTime::Seconds() - startTime;
+
+		UE_LOG(LogDetour, Display, TEXT("%-14s %9.3fms per path  %d/%d complete"), TEXT("findPath"),
+			flatSeconds * 1000.0 / requestCount, flatComplete, requestCount);
+		UE_LOG(LogDetour, Display, TEXT("%-14s %9.3fms per path  %d/%d complete  %.1f segments per path  cost ratio %.4f on paths both completed"), TEXT("Hierarchical"),
+			hierarchicalSeconds * 1000.0 / requestCount, hierarchyComplete, requestCount, (double)segmentTotal / requestCount,
+			flatCost > 0.0 ? hierarchyCost / flatCost : 1.0);
+
+		dtFreeNavMeshQuery(query);
+		dtFreeNavMesh(navMesh);
+	}
+}
+
+static FAutoConsoleCommand DetourHierarchyBenchmarkCmd(
+	TEXT("ai.nav.HierarchyBenchmark"),
+	TEXT("Compare findPath with hierarchical pathfinding on long requests over a generated tiled navmesh. Usage: ai.nav.HierarchyBenchmark [Tiles=32] [Quads=32] [Requests=100] [Nodes=4096] [Cluster=4] [MinDistance=0.5]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&UE::Detour::HierarchyBenchmark::RunHierarchyBenchmark));
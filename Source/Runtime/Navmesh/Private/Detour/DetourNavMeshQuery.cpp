@@ -22,6 +22,8 @@
 #include "Detour/DetourNavMeshQuery.h"
 #include "Detour/DetourNode.h"
 #include "Detour/DetourAssert.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogDebugRaycastCrash, All, All);
 
@@ -1755,6 +1757,231 @@ dtStatus dtNavMeshQuery::findPath(dtPolyRef startRef, dtPolyRef endRef,
 	return status;
 }
 
+//@UE BEGIN
+/// @par
+///
+/// Runs a Dijkstra search from the end polygon over the reversed navigation graph: a polygon is expanded into
+/// the neighbours that have a link leading into it. Detour links the land polygons and the polygon of an off-mesh
+/// connection both ways even when the connection is one-way, the direction that can't be traveled is flagged with
+/// DT_LINK_FLAG_OFFMESH_CON_BACKTRACKER. So the links of a polygon always include every polygon linking into it,
+/// and whether prev -> best can be traveled is decided by prev's own link, which is what findPath() checks too.
+/// Every node stores the cost from its exit portal to the end position, and traversal costs are evaluated with
+/// the same arguments findPath() would pass when walking the path forward.
+///
+/// Start polygons which were not settled by the search (cut by the node pool size or the cost limit, or not
+/// connected to the end polygon) get a DT_FAILURE status and an empty result, callers are expected to run
+/// findPath() for them to get the partial path.
+///
+/// Unlike findPath() the search doesn't use a heuristic, so with a heuristic scale above 1 the paths may be
+/// cheaper than the ones found by findPath().
+///
+dtStatus dtNavMeshQuery::findPathsToGoal(const dtPolyRef* startRefs, const dtReal* startPos, const int startCount,
+										 dtPolyRef endRef, const dtReal* endPos, const dtReal costLimit,
+										 const dtQueryFilter* filter,
+										 dtQueryResult* const* results, dtReal* totalCosts, dtStatus* statuses) const
+{
+	dtAssert(m_nav);
+	dtAssert(m_nodePool);
+	dtAssert(m_openList);
+
+	m_queryNodes = 0;
+
+	for (int i = 0; i < startCount; ++i)
+		statuses[i] = DT_FAILURE | DT_INVALID_PARAM;
+
+	if (!endRef || !m_nav->isValidPolyRef(endRef) || startCount <= 0)
+		return DT_FAILURE | DT_INVALID_PARAM;
+
+	// Start polygons still waiting to be settled, sorted for lookups.
+	TArray<dtPolyRef, TInlineAllocator<64>> pendingRefs;
+	pendingRefs.Reserve(startCount);
+	for (int i = 0; i < startCount; ++i)
+	{
+		if (startRefs[i] == endRef)
+		{
+			results[i]->addItem(endRef, 0.0f, 0, 0);
+			if (totalCosts)
+				totalCosts[i] = 0.0f;
+			statuses[i] = DT_SUCCESS;
+		}
+		else if (startRefs[i] && m_nav->isValidPolyRef(startRefs[i]))
+		{
+			statuses[i] = DT_FAILURE;
+			pendingRefs.Add(startRefs[i]);
+		}
+	}
+	pendingRefs.Sort();
+	pendingRefs.SetNum(Algo::Unique(pendingRefs), false);
+	int pendingCount = pendingRefs.Num();
+	if (pendingCount == 0)
+		return DT_SUCCESS;
+
+	m_nodePool->clear();
+	m_openList->clear();
+
+	dtNode* endNode = m_nodePool->getNode(endRef);
+	dtVcopy(endNode->pos, endPos);
+	endNode->pidx = 0;
+	endNode->cost = 0;
+	endNode->total = 0;
+	endNode->id = endRef;
+	endNode->flags = DT_NODE_OPEN;
+	m_openList->push(endNode);
+	m_queryNodes++;
+
+	dtStatus status = DT_SUCCESS;
+
+	while (!m_openList->empty() && pendingCount > 0)
+	{
+		// Remove node from open list and put it in closed list.
+		dtNode* bestNode = m_openList->pop();
+		bestNode->flags &= ~DT_NODE_OPEN;
+		bestNode->flags |= DT_NODE_CLOSED;
+
+		const dtPolyRef bestRef = bestNode->id;
+		const bool bIsStart = Algo::BinarySearch(pendingRefs, bestRef) != INDEX_NONE;
+		if (bIsStart)
+			pendingCount--;
+
+		const dtMeshTile* bestTile = 0;
+		const dtPoly* bestPoly = 0;
+		m_nav->getTileAndPolyByRefUnsafe(bestRef, &bestTile, &bestPoly);
+
+		// Start polygons don't have to pass the filter, but the path can't go through them if they don't.
+		if (bestNode != endNode && !(filter->passFilter(bestRef, bestTile, bestPoly) && passLinkFilterByRef(bestTile, bestRef)))
+			continue;
+
+		// The polygon the path continues to after this one, toward the end.
+		dtPolyRef nextRef = 0;
+		const dtMeshTile* nextTile = 0;
+		const dtPoly* nextPoly = 0;
+		if (bestNode->pidx)
+			nextRef = m_nodePool->getNodeAtIdx(bestNode->pidx)->id;
+		if (nextRef)
+			m_nav->getTileAndPolyByRefUnsafe(nextRef, &nextTile, &nextPoly);
+
+		for (unsigned int i = bestPoly->firstLink; i != DT_NULL_LINK; )
+		{
+			const dtLink& link = m_nav->getLink(bestTile, i);
+			i = link.next;
+
+			const dtPolyRef prevRef = link.ref;
+			if (!prevRef || prevRef == nextRef)
+				continue;
+
+			const dtMeshTile* prevTile = 0;
+			const dtPoly* prevPoly = 0;
+			m_nav->getTileAndPolyByRefUnsafe(prevRef, &prevTile, &prevPoly);
+
+			// Travel goes from prev to best, so that is the link which has to exist and pass the filter. For a one-way
+			// off-mesh connection best's link back to prev exists but only prev's link tells the direction apart.
+			unsigned int forwardLinkIdx = prevPoly->firstLink;
+			while (forwardLinkIdx != DT_NULL_LINK && m_nav->getLink(prevTile, forwardLinkIdx).ref != bestRef)
+				forwardLinkIdx = m_nav->getLink(prevTile, forwardLinkIdx).next;
+			if (forwardLinkIdx == DT_NULL_LINK || !filter->isValidLinkSide(m_nav->getLink(prevTile, forwardLinkIdx).side))
+				continue;
+
+			dtNode* prevNode = m_nodePool->getNode(prevRef);
+			if (!prevNode)
+			{
+				status |= DT_OUT_OF_NODES;
+				continue;
+			}
+			if (prevNode->flags & DT_NODE_CLOSED)
+				continue;
+
+			dtReal prevPos[3] = { 0.0f, 0.0f, 0.0f };
+			getEdgeMidPoint(prevRef, prevPoly, prevTile, bestRef, bestPoly, bestTile, prevPos);
+
+			// Cost of crossing the best polygon, from the portal with prev to the portal with next (or the end position).
+			const dtReal curCost = filter->getCost(prevPos, bestNode->pos, prevRef, prevTile, prevPoly, bestRef, bestTile, bestPoly, nextRef, nextTile, nextPoly);
+			if (curCost == DT_UNWALKABLE_POLY_COST)
+				continue;
+
+			const dtReal cost = bestNode->cost + curCost;
+			if (cost > costLimit)
+				continue;
+
+			if ((prevNode->flags & DT_NODE_OPEN) && cost >= prevNode->total)
+				continue;
+
+			prevNode->pidx = m_nodePool->getNodeIdx(bestNode);
+			prevNode->id = prevRef;
+			prevNode->cost = cost;
+			prevNode->total = cost;
+			dtVcopy(prevNode->pos, prevPos);
+
+			if (prevNode->flags & DT_NODE_OPEN)
+			{
+				m_openList->modify(prevNode);
+			}
+			else
+			{
+				prevNode->flags = DT_NODE_OPEN;
+				m_openList->push(prevNode);
+				m_queryNodes++;
+			}
+		}
+	}
+
+	// Walk from every settled start polygon toward the end, the cost up to the portal into a polygon is the
+	// total cost minus the remaining cost stored on the polygon before it.
+	const int loopLimit = m_nodePool->getMaxRuntimeNodes() + 1;
+	for (int i = 0; i < startCount; ++i)
+	{
+		if (statuses[i] != DT_FAILURE)
+			continue;
+
+		const dtNode* node = m_nodePool->findNode(startRefs[i]);
+		if (!node || !(node->flags & DT_NODE_CLOSED))
+			continue;
+
+		const dtNode* next = m_nodePool->getNodeAtIdx(node->pidx);
+		dtAssert(next);
+
+		const dtMeshTile* startTile = 0;
+		const dtPoly* startPoly = 0;
+		const dtMeshTile* nextTile = 0;
+		const dtPoly* nextPoly = 0;
+		m_nav->getTileAndPolyByRefUnsafe(node->id, &startTile, &startPoly);
+		m_nav->getTileAndPolyByRefUnsafe(next->id, &nextTile, &nextPoly);
+
+		const dtReal startCost = filter->getCost(&startPos[i*3], node->pos, 0, 0, 0, node->id, startTile, startPoly, next->id, nextTile, nextPoly);
+		const dtReal total = startCost + node->cost;
+		if (startCost == DT_UNWALKABLE_POLY_COST || total > costLimit)
+			continue;
+
+		dtQueryResult& result = *results[i];
+		result.addItem(node->id, 0.0f, 0, 0);
+
+		dtReal prevCost = 0.0f;
+		int n = 1;
+		while (next && n < loopLimit)
+		{
+			const dtReal nodeCost = next->pidx ? total - node->cost : total;
+			result.addItem(next->id, nodeCost - prevCost, 0, 0);
+			prevCost = nodeCost;
+
+			node = next;
+			next = m_nodePool->getNodeAtIdx(node->pidx);
+			n++;
+		}
+
+		if (n >= loopLimit)
+		{
+			statuses[i] = DT_FAILURE | DT_INVALID_CYCLE_PATH;
+			continue;
+		}
+
+		if (totalCosts)
+			totalCosts[i] = total;
+		statuses[i] = DT_SUCCESS;
+	}
+
+	return status;
+}
+//@UE END
+
 //@UE BEGIN
 #if WITH_NAVMESH_CLUSTER_LINKS
 dtStatus dtNavMeshQuery::testClusterPath(dtPolyRef startRef, dtPolyRef endRef) const
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Detour/DetourBatchPathQuery.h"
+#include "Detour/DetourNavMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDetourBatchPathQueryOneWayOffMeshTest, "System.Navigation.Detour.BatchPathQuery.OneWayOffMeshLink", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter);
+
+namespace UE::Detour::BatchPathQueryTest
+{
+	static const dtReal CellSize = 10.0f;
+	static const dtReal TileSize = 160.0f;
+	static const unsigned short NullIdx = 0xffff;
+
+	/// Single tile with two disconnected quads, A at x [0, 40] and B at x [120, 160], joined by an off-mesh connection going from A to B only.
+	static dtNavMesh* CreateOneWayNavMesh()
+	{
+		const unsigned short verts[] =
+		{
+			0, 0, 0,	0, 0, 4,	4, 0, 4,	4, 0, 0,
+			12, 0, 0,	12, 0, 4,	16, 0, 4,	16, 0, 0,
+		};
+		const unsigned short polys[] =
+		{
+			0, 1, 2, 3,		NullIdx, NullIdx, NullIdx, NullIdx,
+			4, 5, 6, 7,		NullIdx, NullIdx, NullIdx, NullIdx,
+		};
+		const unsigned short polyFlags[] = { 1, 1 };
+		const unsigned char polyAreas[] = { 0, 0 };
+
+		dtOffMeshLinkCreateParams offMeshCon;
+		memset(&offMeshCon, 0, sizeof(offMeshCon));
+		dtVset(offMeshCon.vertsA0, 20.0f, 0.0f, 20.0f);
+		dtVset(offMeshCon.vertsB0, 140.0f, 0.0f, 20.0f);
+		offMeshCon.snapRadius = 30.0f;
+		offMeshCon.snapHeight = 50.0f;
+		offMeshCon.polyFlag = 1;
+		offMeshCon.type = DT_OFFMESH_CON_POINT;
+
+		dtNavMeshCreateParams params;
+		memset(&params, 0, sizeof(params));
+		params.verts = verts;
+		params.vertCount = UE_ARRAY_COUNT(verts) / 3;
+		params.polys = polys;
+		params.polyFlags = polyFlags;
+		params.polyAreas = polyAreas;
+		params.polyCount = UE_ARRAY_COUNT(polyFlags);
+		params.nvp = 4;
+		params.offMeshCons = &offMeshCon;
+		params.offMeshConCount = 1;
+		dtVset(params.bmin, 0.0f, 0.0f, 0.0f);
+		dtVset(params.bmax, TileSize, 100.0f, TileSize);
+		params.walkableHeight = 200.0f;
+		params.walkableRadius = 35.0f;
+		params.walkableClimb = 50.0f;
+		params.cs = CellSize;
+		params.ch = CellSize;
+		params.buildBvTree = true;
+
+		unsigned char* data = nullptr;
+		int dataSize = 0;
+		if (!dtCreateNavMeshData(&params, &data, &dataSize))
+			return nullptr;
+
+		dtNavMeshParams navParams;
+		memset(&navParams, 0, sizeof(navParams));
+		navParams.walkableHeight = 200.0f;
+		navParams.walkableRadius = 35.0f;
+		navParams.walkableClimb = 50.0f;
+		for (int i = 0; i < DT_RESOLUTION_COUNT; ++i)
+		{
+			navParams.resolutionParams[i].bvQuantFactor = 1.0f / CellSize;
+		}
+		navParams.tileWidth = TileSize;
+		navParams.tileHeight = TileSize;
+		navParams.maxTiles = 1;
+		navParams.maxPolys = 4;
+
+		dtNavMesh* navMesh = dtAllocNavMesh();
+		if (!navMesh || dtStatusFailed(navMesh->init(&navParams)) || dtStatusFailed(navMesh->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, nullptr)))
+		{
+			dtFree(data, DT_ALLOC_PERM_TILE_DATA);
+			dtFreeNavMesh(navMesh);
+			return nullptr;
+		}
+		return navMesh;
+	}
+}
+
+bool FDetourBatchPathQueryOneWayOffMeshTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Detour::BatchPathQueryTest;
+
+	dtNavMesh* navMesh = CreateOneWayNavMesh();
+	if (!TestNotNull(TEXT("Navmesh is created"), navMesh))
+	{
+		return false;
+	}
+
+	const dtPolyRef base = navMesh->getPolyRefBase(navMesh->getTileAt(0, 0, 0));
+	const dtPolyRef refA = base | 0;
+	const dtPolyRef refB = base | 1;
+	const dtPolyRef refOffMesh = base | 2;
+	const dtReal posA[3] = { 20.0f, 0.0f, 20.0f };
+	const dtReal posB[3] = { 140.0f, 0.0f, 20.0f };
+
+	dtNavMeshQuery* query = dtAllocNavMeshQuery();
+	query->init(navMesh, 256);
+	query->setRequireNavigableEndLocation(true);
+	dtQueryFilter filter;
+
+	// With the connection: the reverse search from B has to reach A through the off-mesh polygon, and agree with findPath.
+	{
+		dtQueryResult expected;
+		dtReal expectedCost = 0.0f;
+		const dtStatus expectedStatus = query->findPath(refA, refB, posA, posB, DT_REAL_MAX, &filter, expected, &expectedCost);
+		TestTrue(TEXT("findPath A to B takes the connection"), dtStatusSucceed(expectedStatus) && !dtStatusDetail(expectedStatus, DT_PARTIAL_RESULT));
+
+		dtQueryResult result;
+		dtQueryResult* results[] = { &result };
+		dtReal totalCost = 0.0f;
+		dtStatus pathStatus = DT_FAILURE;
+		query->findPathsToGoal(&refA, posA, 1, refB, posB, DT_REAL_MAX, &filter, results, &totalCost, &pathStatus);
+		TestTrue(TEXT("findPathsToGoal A to B succeeds"), dtStatusSucceed(pathStatus));
+		if (TestEqual(TEXT("findPathsToGoal A to B corridor length"), result.size(), 3))
+		{
+			TestTrue(TEXT("Corridor starts in A"), result.getRef(0) == refA);
+			TestTrue(TEXT("Corridor crosses the connection"), result.getRef(1) == refOffMesh);
+			TestTrue(TEXT("Corridor ends in B"), result.getRef(2) == refB);
+		}
+		TestEqual(TEXT("findPathsToGoal A to B costs the same as findPath"), (double)totalCost, (double)expectedCost, 0.01);
+	}
+
+	// Against the connection: the reverse search from A must not walk the connection backward to settle B.
+	{
+		dtQueryResult result;
+		dtQueryResult* results[] = { &result };
+		dtStatus pathStatus = DT_SUCCESS;
+		query->findPathsToGoal(&refB, posB, 1, refA, posA, DT_REAL_MAX, &filter, results, nullptr, &pathStatus);
+		TestTrue(TEXT("findPathsToGoal B to A fails"), dtStatusFailed(pathStatus));
+		TestEqual(TEXT("findPathsToGoal B to A has no corridor"), result.size(), 0);
+	}
+
+	// Through the batch API, shared goal searches give the same statuses as findPath in both directions.
+	{
+		dtBatchPathQuery batch;
+		batch.init(navMesh, 256, 1);
+		batch.setMinSharedGoalRequests(2);
+
+		dtBatchPathRequest requests[4];
+		for (int i = 0; i < 4; ++i)
+		{
+			const bool bToB = i < 2;
+			requests[i].startRef = bToB ? refA : refB;
+			requests[i].endRef = bToB ? refB : refA;
+			dtVcopy(requests[i].startPos, bToB ? posA : posB);
+			dtVcopy(requests[i].endPos, bToB ? posB : posA);
+			requests[i].filter = &filter;
+		}
+
+		dtBatchPathResult results[4];
+		batch.findPaths(requests, 4, results, false);
+		TestEqual(TEXT("Both goals are solved by shared searches"), batch.getLastSharedSearchCount(), 2);
+		for (int i = 0; i < 4; ++i)
+		{
+			dtQueryResult expected;
+			const dtStatus expectedStatus = query->findPath(requests[i].startRef, requests[i].endRef, requests[i].startPos, requests[i].endPos, DT_REAL_MAX, &filter, expected, nullptr);
+			TestTrue(FString::Printf(TEXT("Batch request %d status matches findPath"), i), results[i].status == expectedStatus);
+			TestEqual(FString::Printf(TEXT("Batch request %d corridor length matches findPath"), i), results[i].path.size(), expected.size());
+		}
+	}
+
+	dtFreeNavMeshQuery(query);
+	dtFreeNavMesh(navMesh);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
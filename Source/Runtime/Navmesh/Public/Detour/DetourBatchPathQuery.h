@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "CoreMinimal.h"
+#include "Detour/DetourLargeWorldCoordinates.h"
+#include "Detour/DetourNavMesh.h"
+#include "Detour/DetourNavMeshQuery.h"
+#include "Detour/DetourStatus.h"
+
+#include <atomic>
+
+/// A single path request of a batch, same parameters as dtNavMeshQuery::findPath().
+struct dtBatchPathRequest
+{
+	dtPolyRef startRef;
+	dtPolyRef endRef;
+	dtReal startPos[3];
+	dtReal endPos[3];
+	dtReal costLimit;					///< Cost limit of nodes allowed to be added to the open list
+	const dtQueryFilter* filter;
+	bool requireNavigableEndLocation;	///< Define if the end location is required to be a valid navmesh polygon
+
+	dtBatchPathRequest() : startRef(0), endRef(0), costLimit(DT_REAL_MAX), filter(0), requireNavigableEndLocation(true)
+	{
+		dtVset(startPos, 0.0f, 0.0f, 0.0f);
+		dtVset(endPos, 0.0f, 0.0f, 0.0f);
+	}
+};
+
+/// Result of a single path request of a batch.
+struct dtBatchPathResult
+{
+	dtQueryResult path;					///< Path corridor, refs and costs for each poly from start to end
+	dtReal totalCost;
+	dtStatus status;
+	bool sharedSearch;					///< True if the path was extracted from a search shared with other requests
+
+	dtBatchPathResult() : totalCost(0.0f), status(DT_FAILURE), sharedSearch(false) {}
+};
+
+/// Finds paths for many requests at once, spreading them over task graph workers.
+///
+/// Every worker uses its own dtNavMeshQuery, so node pools are allocated once in init() and reused by all
+/// batches. Requests going to the same end polygon and position with the same filter are solved by a single
+/// reverse search from the goal (see dtNavMeshQuery::findPathsToGoal()), requests which that search could not
+/// complete fall back to a regular findPath().
+/// @ingroup detour
+class dtBatchPathQuery
+{
+public:
+	NAVMESH_API dtBatchPathQuery();
+	NAVMESH_API ~dtBatchPathQuery();
+
+	/// Initializes the per worker query objects.
+	///  @param[in]		nav			The navigation mesh to use for all queries.
+	///  @param[in]		maxNodes	Maximum number of search nodes of each worker. [Limits: 0 < value <= 65536]
+	///  @param[in]		maxContexts	Maximum number of workers running queries, number of cores if <= 0.
+	///  @param[in]		linkFilter	Special link filter used for every query
+	/// @returns The status flags for the query.
+	NAVMESH_API dtStatus init(const dtNavMesh* nav, const int maxNodes, const int maxContexts = 0, dtQuerySpecialLinkFilter* linkFilter = 0);
+
+	/// Requests sharing a goal are solved with one reverse search once there are at least this many of them,
+	/// 0 disables shared searches.
+	void setMinSharedGoalRequests(const int count) { m_minSharedGoalRequests = count; }
+	int getMinSharedGoalRequests() const { return m_minSharedGoalRequests; }
+
+	/// Finds the path of every request.
+	///  @param[in]		requests		The path requests. [(dtBatchPathRequest) * @p requestCount]
+	///  @param[in]		requestCount	The number of requests.
+	///  @param[out]	results			The result of each request. [(dtBatchPathResult) * @p requestCount]
+	///  @param[in]		parallel		Spread the searches over task graph workers.
+	/// @returns The status flags for the batch, individual path status is stored in the results.
+	NAVMESH_API dtStatus findPaths(const dtBatchPathRequest* requests, const int requestCount, dtBatchPathResult* results, const bool parallel = true);
+
+	int getContextCount() const { return m_contexts.Num(); }
+
+	/// Number of shared goal searches run by the last findPaths() call.
+	int getLastSharedSearchCount() const { return m_lastSharedSearchCount; }
+
+	/// Number of single path searches run by the last findPaths() call, including shared search fallbacks.
+	int getLastSingleSearchCount() const { return m_lastSingleSearchCount; }
+
+private:
+	struct dtWorkItem
+	{
+		int first;		///< First request index in m_sortedRequests
+		int count;		///< Number of requests, all of them share the goal if greater than 1
+	};
+
+	void findSinglePath(dtNavMeshQuery& query, const dtBatchPathRequest& request, dtBatchPathResult& result) const;
+	void findSharedGoalPaths(dtNavMeshQuery& query, const dtBatchPathRequest* requests, const dtWorkItem& item, dtBatchPathResult* results);
+
+	TArray<dtNavMeshQuery*> m_contexts;
+	TArray<int> m_sortedRequests;
+	TArray<dtWorkItem> m_workItems;
+	int m_minSharedGoalRequests;
+	int m_lastSharedSearchCount;
+	std::atomic<int> m_lastSingleSearchCount;
+
+	dtBatchPathQuery(const dtBatchPathQuery&) = delete;
+	dtBatchPathQuery& operator=(const dtBatchPathQuery&) = delete;
+};
@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "CoreMinimal.h"
+#include "Detour/DetourLargeWorldCoordinates.h"
+#include "Detour/DetourNavMesh.h"
+#include "Detour/DetourNavMeshQuery.h"
+#include "Detour/DetourStatus.h"
+
+/// Configuration of a dtNavMeshHierarchy.
+struct dtNavMeshHierarchyParams
+{
+	int tilesPerCluster;		///< Width and height of a tile cluster, in tiles. [Limit: > 0]
+	dtReal refineDistance;		///< Maximum straight distance covered by one refined path segment, one tile width if <= 0. [Unit: wu]
+	dtReal minPathDistance;		///< Requests shorter than this straight distance use a flat findPath(), two refine distances if <= 0. [Unit: wu]
+
+	dtNavMeshHierarchyParams() : tilesPerCluster(4), refineDistance(0.0f), minPathDistance(0.0f) {}
+};
+
+/// Two level abstraction of a tiled navigation mesh used to find long paths.
+///
+/// Level 0 nodes are the polygon islands of each tile, connected by the links crossing tile borders.
+/// Level 1 nodes are the connected level 0 nodes of a tile cluster (tilesPerCluster x tilesPerCluster tiles).
+/// A long path is found by a search over the level 1 graph, then over the level 0 nodes of the level 1 corridor,
+/// and is refined into polygons by short findPath() calls between consecutive abstract nodes, so no single search
+/// needs more than a few tiles worth of nodes.
+///
+/// Abstract edge costs are straight distances between nodes and ignore query filters. Refined paths honor the
+/// filter, are not guaranteed to be optimal, and fall back to a flat findPath() when a segment can't be refined.
+///
+/// The hierarchy is not updated automatically, updateTiles() must be called after tiles are added to or removed
+/// from the navigation mesh. It must not be updated while paths are being found.
+/// @ingroup detour
+class dtNavMeshHierarchy
+{
+public:
+	NAVMESH_API dtNavMeshHierarchy();
+	NAVMESH_API ~dtNavMeshHierarchy();
+
+	/// Builds the hierarchy of every tile of the navigation mesh.
+	///  @param[in]		nav			The navigation mesh to build the hierarchy of.
+	///  @param[in]		params		Hierarchy configuration.
+	/// @returns The status flags for the operation.
+	NAVMESH_API dtStatus init(const dtNavMesh* nav, const dtNavMeshHierarchyParams& params);
+
+	/// Rebuilds the nodes of the given tiles and the edges of their neighbours.
+	///  @param[in]		tileRefs	References of the added, replaced or removed tiles. Only the tile index of a reference is used,
+	///								so references of removed tiles are valid input.
+	///  @param[in]		count		The number of tile references.
+	NAVMESH_API void updateTiles(const dtTileRef* tileRefs, const int count);
+
+	/// Finds a path from the start polygon to the end polygon using the hierarchy. Short requests and requests
+	/// that can't be refined run a regular findPath() on @p query.
+	///  @param[in]		query			Query object of the same navigation mesh used to refine the path.
+	///  @param[in]		startRef		The reference id of the start polygon.
+	///  @param[in]		endRef			The reference id of the end polygon.
+	///  @param[in]		startPos		A position within the start polygon. [(x, y, z)]
+	///  @param[in]		endPos			A position within the end polygon. [(x, y, z)]
+	///  @param[in]		costLimit		Cost limit of nodes allowed to be added to the open list
+	///  @param[in]		filter			The polygon filter to apply to the query.
+	///  @param[out]	result			Results for path corridor, fills in refs and costs for each poly from start to end
+	///  @param[out]	totalCost		If provided will get filled will total cost of path
+	///  @param[out]	segmentCount	If provided receives the number of refined segments, 0 if a flat findPath() was used.
+	/// @returns The status flags for the query.
+	NAVMESH_API dtStatus findPath(const dtNavMeshQuery& query, dtPolyRef startRef, dtPolyRef endRef,
+		const dtReal* startPos, const dtReal* endPos, const dtReal costLimit, const dtQueryFilter* filter,
+		dtQueryResult& result, dtReal* totalCost, int* segmentCount = 0) const;
+
+	/// Gets the navigation mesh the hierarchy was built for.
+	const dtNavMesh* getNavMesh() const { return m_nav; }
+
+	const dtNavMeshHierarchyParams& getParams() const { return m_params; }
+
+	/// Number of level 0 nodes, one per polygon island of each tile.
+	NAVMESH_API int getNodeCount() const;
+
+	/// Number of level 1 nodes, one per connected set of level 0 nodes of each tile cluster.
+	NAVMESH_API int getClusterNodeCount() const;
+
+private:
+	struct dtHierarchyEdge
+	{
+		uint64 target;					///< Key of the target node, see makeKey()
+		dtReal cost;
+	};
+
+	/// Level 0 node, polygons of a tile connected to each other.
+	struct dtHierarchyNode
+	{
+		dtReal pos[3];					///< Center of the representative polygon
+		dtPolyRef poly;					///< Polygon closest to the center of the island
+		int firstEdge;
+		int edgeCount;
+		int component;					///< Level 1 node of the tile cluster
+	};
+
+	struct dtHierarchyTile
+	{
+		dtTileRef ref;					///< Tile the nodes were built from, 0 if empty
+		int x;
+		int y;
+		int cluster;					///< Index in m_clusters, -1 if empty
+		TArray<unsigned short> polyNodes;	///< Level 0 node of each polygon
+		TArray<dtHierarchyNode> nodes;
+		TArray<dtHierarchyEdge> edges;
+	};
+
+	/// Level 1 node, level 0 nodes of a tile cluster connected to each other.
+	struct dtHierarchyComponent
+	{
+		dtReal pos[3];
+		int firstEdge;
+		int edgeCount;
+	};
+
+	struct dtHierarchyCluster
+	{
+		TArray<int> tiles;
+		TArray<dtHierarchyComponent> components;
+		TArray<dtHierarchyEdge> edges;
+	};
+
+	static uint64 makeKey(const int index, const int node) { return ((uint64)index << 16) | (uint64)node; }
+	static int getKeyIndex(const uint64 key) { return (int)(key >> 16); }
+	static int getKeyNode(const uint64 key) { return (int)(key & 0xffff); }
+
+	int getClusterIndex(const int tileX, const int tileY);
+	void buildTileNodes(const int tileIdx, TArray<int>& dirtyClusters);
+	void buildTileEdges(const int tileIdx);
+	void buildClusterComponents(const int clusterIdx);
+	void buildClusterEdges(const int clusterIdx);
+	const dtHierarchyNode* getPolyNode(dtPolyRef ref, uint64& key) const;
+
+	const dtNavMesh* m_nav;
+	dtNavMeshHierarchyParams m_params;
+	TArray<dtHierarchyTile> m_tiles;
+	TArray<dtHierarchyCluster> m_clusters;
+	TMap<uint64, int> m_clusterLookup;	///< Packed cluster coordinates to index in m_clusters
+
+	dtNavMeshHierarchy(const dtNavMeshHierarchy&) = delete;
+	dtNavMeshHierarchy& operator=(const dtNavMeshHierarchy&) = delete;
+};
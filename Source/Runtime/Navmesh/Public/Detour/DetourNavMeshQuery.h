@@ -337,6 +337,7 @@ protected:
 	NAVMESH_API void setPos(int idx, const dtReal* pos);
 
 	friend class dtNavMeshQuery;
+	friend class dtNavMeshHierarchy; //@UE
 };
 
 /// Provides the ability to perform pathfinding related queries against
@@ -374,7 +375,28 @@ public:
 					  const dtReal* startPos, const dtReal* endPos, const dtReal costLimit, //@UE
 					  const dtQueryFilter* filter,
 					  dtQueryResult& result, dtReal* totalCost) const;
-	
+
+	//@UE BEGIN
+	/// Finds paths from several start polygons to one end polygon with a single search running backwards from the end.
+	/// Costs are evaluated in the direction of travel, so each path is laid out the same way as a findPath() result.
+	/// The search stops once every start polygon is settled, the cost limit is reached or the node pool is exhausted.
+	///  @param[in]		startRefs	The reference ids of the start polygons. [(polyRef) * @p startCount]
+	///  @param[in]		startPos	A position within each start polygon. [(x, y, z) * @p startCount]
+	///  @param[in]		startCount	The number of start polygons.
+	///  @param[in]		endRef		The reference id of the end polygon.
+	///  @param[in]		endPos		A position within the end polygon. [(x, y, z)]
+	///  @param[in]		costLimit	Cost limit of nodes allowed to be added to the open list
+	///  @param[in]		filter		The polygon filter to apply to the query.
+	///  @param[out]	results		Result receiving the path corridor of each start polygon. [(dtQueryResult*) * @p startCount]
+	///  @param[out]	totalCosts	Total cost of each path. [(cost) * @p startCount] [opt]
+	///  @param[out]	statuses	Status of each path, DT_FAILURE if the search did not reach its start polygon. [(status) * @p startCount]
+	/// @returns The status flags for the search.
+	NAVMESH_API dtStatus findPathsToGoal(const dtPolyRef* startRefs, const dtReal* startPos, const int startCount,
+							 dtPolyRef endRef, const dtReal* endPos, const dtReal costLimit,
+							 const dtQueryFilter* filter,
+							 dtQueryResult* const* results, dtReal* totalCosts, dtStatus* statuses) const;
+	//@UE END
+
 	/// Finds the straight path from the start to the end position within the polygon corridor.
 	///  @param[in]		startPos			Path start position. [(x, y, z)]
 	///  @param[in]		endPos				Path end position. [(x, y, z)]
@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "IPlatformFilePak.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
 #include "HAL/FileManager.h"
 #include "Math/GuardedInt.h"
 #include "Misc/CoreMisc.h"
@@ -5331,6 +5333,8 @@ FPakFile::FPakFile(const TCHAR* Filename, bool bIsSigned)
 	, bSigned(bIsSigned)
 	, bIsValid(false)
 	, bHasPathHashIndex(false)
+	, bUseSortedPathHashIndex(false)
+	, bLoadSortedPathHashIndex(IsPakSortedPathHashIndex())
 	, bHasFullDirectoryIndex(false)
 #if ENABLE_PAKFILE_RUNTIME_PRUNING
 	, bWillPruneDirectoryIndex(false)
@@ -5352,7 +5356,63 @@ FPakFile::FPakFile(const TCHAR* Filename, bool bIsSigned)
 }
 #endif
 
+struct FPakFile::FIndexSettings
+{
+	FIndexSettings()
+	{
+		bKeepFullDirectory = true;
+		bValidatePruning = false;
+		bDelayPruning = false;
+		bWritePathHashIndex = true;
+		bWriteFullDirectoryIndex = true;
+		bSortedPathHashIndex = false;
+
+		// Paks are mounted before config files are read, so the licensee needs to hardcode all settings used for runtime index loading rather than specifying them in ini
+		if (FPakPlatformFile::GetPakSetIndexSettingsDelegate().IsBound())
+		{
+			FPakPlatformFile::GetPakSetIndexSettingsDelegate().Execute(bKeepFullDirectory, bValidatePruning, bDelayPruning);
+		}
+
+		// Settings not used at runtime can be read from ini
+#if !UE_BUILD_SHIPPING
+		GConfig->GetBool(TEXT("Pak"), TEXT("WritePathHashIndex"), bWritePathHashIndex, GEngineIni);
+		GConfig->GetBool(TEXT("Pak"), TEXT("WriteFullDirectoryIndex"), bWriteFullDirectoryIndex, GEngineIni);
+#endif
+
+#if IS_PROGRAM || WITH_EDITOR
+		// Directory pruning is not enabled in the editor or in development programs because there is no need to save the memory in those environments and some development features require not pruning
+		bKeepFullDirectory = true;
+#else
+		bKeepFullDirectory = bKeepFullDirectory || !FPlatformProperties::RequiresCookedData();
+#endif
+#if !UE_BUILD_SHIPPING
+		const TCHAR* CommandLine = FCommandLine::Get();
+		FParse::Bool(CommandLine, TEXT("ForcePakKeepFullDirectory="), bKeepFullDirectory);
+#if ENABLE_PAKFILE_RUNTIME_PRUNING_VALIDATE
+		FParse::Bool(CommandLine, TEXT("ForcePakValidatePruning="), bValidatePruning);
+		FParse::Bool(CommandLine, TEXT("ForcePakDelayPruning="), bDelayPruning);
+#endif
+		FParse::Bool(CommandLine, TEXT("ForcePakWritePathHashIndex="), bWritePathHashIndex);
+		FParse::Bool(CommandLine, TEXT("ForcePakWriteFullDirectoryIndex="), bWriteFullDirectoryIndex);
+		FParse::Bool(CommandLine, TEXT("ForcePakSortedPathHashIndex="), bSortedPathHashIndex);
+#endif
+	}
+
+	bool bKeepFullDirectory;
+	bool bValidatePruning;
+	bool bDelayPruning;
+	bool bWritePathHashIndex;
+	bool bWriteFullDirectoryIndex;
+	/* Paks are mounted before config is read, so like bKeepFullDirectory this can only be set from code or the commandline */
+	bool bSortedPathHashIndex;
+};
+
 FPakFile::FPakFile(IPlatformFile* LowerLevel, const TCHAR* Filename, bool bIsSigned, bool bLoadIndex)
+	: FPakFile(LowerLevel, Filename, bIsSigned, bLoadIndex, GetIndexSettings())
+{
+}
+
+FPakFile::FPakFile(IPlatformFile* LowerLevel, const TCHAR* Filename, bool bIsSigned, bool bLoadIndex, const FIndexSettings& IndexSettings)
 	: PakFilename(Filename)
 	, PakFilenameName(Filename)
 	, PathHashSeed(0)
@@ -5361,6 +5421,8 @@ FPakFile::FPakFile(IPlatformFile* LowerLevel, const TCHAR* Filename, bool bIsSig
 	, bSigned(bIsSigned)
 	, bIsValid(false)
 	, bHasPathHashIndex(false)
+	, bUseSortedPathHashIndex(false)
+	, bLoadSortedPathHashIndex(IndexSettings.bSortedPathHashIndex)
 	, bHasFullDirectoryIndex(false)
 #if ENABLE_PAKFILE_RUNTIME_PRUNING
 	, bWillPruneDirectoryIndex(false)
@@ -5388,6 +5450,8 @@ FPakFile::FPakFile(FArchive* Archive)
 	, bSigned(false)
 	, bIsValid(false)
 	, bHasPathHashIndex(false)
+	, bUseSortedPathHashIndex(false)
+	, bLoadSortedPathHashIndex(IsPakSortedPathHashIndex())
 	, bHasFullDirectoryIndex(false)
 #if ENABLE_PAKFILE_RUNTIME_PRUNING
 	, bWillPruneDirectoryIndex(false)
@@ -5592,6 +5656,7 @@ void FPakFile::LoadIndex(FArchive& Reader)
 bool FPakFile::LoadIndexInternal(FArchive& Reader)
 {
 	bHasPathHashIndex = false;
+	bUseSortedPathHashIndex = false;
 	bHasFullDirectoryIndex = false;
 #if ENABLE_PAKFILE_RUNTIME_PRUNING
 	bNeedsLegacyPruning = false;
@@ -5785,6 +5850,22 @@ bool FPakFile::LoadIndexInternal(FArchive& Reader)
 			}
 		}
 
+		if (bLoadSortedPathHashIndex)
+		{
+			SCOPED_BOOT_TIMING("PakFile_SerializeSortedPathHashIndex");
+			SortedPathHashIndex.Load(PathHashIndexReader);
+			if (PathHashIndexReader.IsError())
+			{
+				UE_LOG(LogPakFile, Log, TEXT("Corrupt pak PathHashIndex detected!"));
+				UE_LOG(LogPakFile, Log, TEXT(" Filename: %s"), *PakFilename);
+				UE_LOG(LogPakFile, Log, TEXT(" Index Offset: %lld"), PathHashIndexOffset);
+				UE_LOG(LogPakFile, Log, TEXT(" Index Size: %lld"), PathHashIndexSize);
+				UE_LOG(LogPakFile, Log, TEXT(" Sorted path hash index could not be read"));
+				return false;
+			}
+			bUseSortedPathHashIndex = true;
+		}
+		else
 		{
 			SCOPED_BOOT_TIMING("PakFile_SerializePathHashIndex");
 			PathHashIndexReader << PathHashIndex;
@@ -6285,53 +6366,6 @@ FPakFile::EFindResult FPakFile::GetPakEntry(const FPakEntryLocation& PakEntryLoc
 	return bDeleted ? EFindResult::FoundDeleted : EFindResult::Found;
 }
 
-struct FPakFile::FIndexSettings
-{
-	FIndexSettings()
-	{
-		bKeepFullDirectory = true;
-		bValidatePruning = false;
-		bDelayPruning = false;
-		bWritePathHashIndex = true;
-		bWriteFullDirectoryIndex = true;
-
-		// Paks are mounted before config files are read, so the licensee needs to hardcode all settings used for runtime index loading rather than specifying them in ini
-		if (FPakPlatformFile::GetPakSetIndexSettingsDelegate().IsBound())
-		{
-			FPakPlatformFile::GetPakSetIndexSettingsDelegate().Execute(bKeepFullDirectory, bValidatePruning, bDelayPruning);
-		}
-
-		// Settings not used at runtime can be read from ini
-#if !UE_BUILD_SHIPPING
-		GConfig->GetBool(TEXT("Pak"), TEXT("WritePathHashIndex"), bWritePathHashIndex, GEngineIni);
-		GConfig->GetBool(TEXT("Pak"), TEXT("WriteFullDirectoryIndex"), bWriteFullDirectoryIndex, GEngineIni);
-#endif
-
-#if IS_PROGRAM || WITH_EDITOR
-		// Directory pruning is not enabled in the editor or in development programs because there is no need to save the memory in those environments and some development features require not pruning
-		bKeepFullDirectory = true;
-#else
-		bKeepFullDirectory = bKeepFullDirectory || !FPlatformProperties::RequiresCookedData();
-#endif
-#if !UE_BUILD_SHIPPING
-		const TCHAR* CommandLine = FCommandLine::Get();
-		FParse::Bool(CommandLine, TEXT("ForcePakKeepFullDirectory="), bKeepFullDirectory);
-#if ENABLE_PAKFILE_RUNTIME_PRUNING_VALIDATE
-		FParse::Bool(CommandLine, TEXT("ForcePakValidatePruning="), bValidatePruning);
-		FParse::Bool(CommandLine, TEXT("ForcePakDelayPruning="), bDelayPruning);
-#endif
-		FParse::Bool(CommandLine, TEXT("ForcePakWritePathHashIndex="), bWritePathHashIndex);
-		FParse::Bool(CommandLine, TEXT("ForcePakWriteFullDirectoryIndex="), bWriteFullDirectoryIndex);
-#endif
-	}
-
-	bool bKeepFullDirectory;
-	bool bValidatePruning;
-	bool bDelayPruning;
-	bool bWritePathHashIndex;
-	bool bWriteFullDirectoryIndex;
-};
-
 FPakFile::FIndexSettings& FPakFile::GetIndexSettings()
 {
 	static FIndexSettings IndexLoadParams;
@@ -6372,6 +6406,12 @@ bool FPakFile::IsPakWriteFullDirectoryIndex()
 	return IndexLoadParams.bWriteFullDirectoryIndex;
 }
 
+bool FPakFile::IsPakSortedPathHashIndex()
+{
+	FIndexSettings& IndexLoadParams = GetIndexSettings();
+	return IndexLoadParams.bSortedPathHashIndex;
+}
+
 bool FPakFile::RequiresDirectoryIndexLock() const
 {
 #if ENABLE_PAKFILE_RUNTIME_PRUNING
@@ -7217,6 +7257,78 @@ const FPakEntryLocation* FPakFile::FindLocationFromIndex(const FString& FullPath
 	return PathHashIndex.Find(PathHash);
 }
 
+const FPakEntryLocation* FPakFile::FindLocationFromIndex(const FString& FullPath, const FString& MountPoint, const FPakSortedPathHashIndex& SortedPathHashIndex, uint64 PathHashSeed, int32 PakFileVersion)
+{
+	const TCHAR* RelativePathFromMount = GetRelativeFilePathFromMountPointer(FullPath, MountPoint);
+	if (!RelativePathFromMount)
+	{
+		return nullptr;
+	}
+	uint64 PathHash = HashPath(RelativePathFromMount, PathHashSeed, PakFileVersion);
+	return SortedPathHashIndex.Find(PathHash);
+}
+
+int32 FPakSortedPathHashIndex::FindIndex(uint64 PathHash) const
+{
+	const int32 Index = Algo::LowerBound(Hashes, PathHash);
+	return Hashes.IsValidIndex(Index) && Hashes[Index] == PathHash ? Index : INDEX_NONE;
+}
+
+void FPakSortedPathHashIndex::Add(uint64 PathHash, const FPakEntryLocation& Location)
+{
+	const int32 Index = Algo::LowerBound(Hashes, PathHash);
+	if (Hashes.IsValidIndex(Index) && Hashes[Index] == PathHash)
+	{
+		Locations[Index] = Location;
+	}
+	else
+	{
+		Hashes.Insert(PathHash, Index);
+		Locations.Insert(Location, Index);
+	}
+}
+
+void FPakSortedPathHashIndex::Load(FArchive& Ar)
+{
+	Empty();
+
+	int32 NumElements = 0;
+	Ar << NumElements;
+	// Each element is a uint64 hash followed by an int32 location; reject counts the archive can't possibly hold
+	constexpr int64 SerializedElementSize = sizeof(uint64) + sizeof(int32);
+	if (NumElements < 0 || (Ar.TotalSize() >= 0 && NumElements > (Ar.TotalSize() - Ar.Tell()) / SerializedElementSize))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	TArray<TTuple<uint64, FPakEntryLocation>> Pairs;
+	Pairs.SetNum(NumElements);
+	for (TTuple<uint64, FPakEntryLocation>& Pair : Pairs)
+	{
+		Ar << Pair.Key << Pair.Value;
+	}
+	// Stable sort so that, like TMap::Add, the last of any duplicate hashes wins
+	Algo::StableSortBy(Pairs, [](const TTuple<uint64, FPakEntryLocation>& Pair) { return Pair.Key; });
+
+	Hashes.Reserve(NumElements);
+	Locations.Reserve(NumElements);
+	for (const TTuple<uint64, FPakEntryLocation>& Pair : Pairs)
+	{
+		if (Hashes.Num() > 0 && Hashes.Last() == Pair.Key)
+		{
+			Locations.Last() = Pair.Value;
+		}
+		else
+		{
+			Hashes.Add(Pair.Key);
+			Locations.Add(Pair.Value);
+		}
+	}
+	Hashes.Shrink();
+	Locations.Shrink();
+}
+
 const FPakEntryLocation* FPakFile::FindLocationFromIndex(const FString& FullPath, const FString& MountPoint, const FDirectoryIndex& DirectoryIndex)
 {
 	if (!FullPath.StartsWith(MountPoint))
@@ -7248,7 +7360,9 @@ FPakFile::EFindResult FPakFile::Find(const FString& FullPath, FPakEntry* OutEntr
 	if (IsPakValidatePruning() && bHasPathHashIndex && bHasFullDirectoryIndex)
 	{
 		const FPakEntryLocation* PathHashLocation = nullptr;
-		PathHashLocation = FindLocationFromIndex(FullPath, MountPoint, PathHashIndex, PathHashSeed, Info.Version);
+		PathHashLocation = bUseSortedPathHashIndex
+			? FindLocationFromIndex(FullPath, MountPoint, SortedPathHashIndex, PathHashSeed, Info.Version)
+			: FindLocationFromIndex(FullPath, MountPoint, PathHashIndex, PathHashSeed, Info.Version);
 
 		const FPakEntryLocation* DirectoryLocation = nullptr;
 
@@ -7273,7 +7387,11 @@ FPakFile::EFindResult FPakFile::Find(const FString& FullPath, FPakEntry* OutEntr
 	else
 #endif
 	{
-		if (bHasPathHashIndex)
+		if (bUseSortedPathHashIndex)
+		{
+			PakEntryLocation = FindLocationFromIndex(FullPath, MountPoint, SortedPathHashIndex, PathHashSeed, Info.Version);
+		}
+		else if (bHasPathHashIndex)
 		{
 			PakEntryLocation = FindLocationFromIndex(FullPath, MountPoint, PathHashIndex, PathHashSeed, Info.Version);
 		}
@@ -7332,6 +7450,11 @@ protected:
 			PlatformFile.HandleReloadPakReadersCommand(Cmd, Ar);
 			return true;
 		}
+		else if (FParse::Command(&Cmd, TEXT("PakIndexBenchmark")))
+		{
+			PlatformFile.HandlePakIndexBenchmarkCommand(Cmd, Ar);
+			return true;
+		}
 		return false;
 	}
 };
@@ -7382,6 +7505,70 @@ void FPakPlatformFile::HandleReloadPakReadersCommand(const TCHAR* Cmd, FOutputDe
 		Pak.PakFile->RecreatePakReaders(LowerLevel);
 	}
 }
+
+void FPakPlatformFile::HandlePakIndexBenchmarkCommand(const TCHAR* Cmd, FOutputDevice& Ar)
+{
+	// Reloads the index of every mounted pak with each path hash index mode and times index loading and lookups
+	int32 NumLookupPasses = 10;
+	FParse::Value(Cmd, TEXT("Passes="), NumLookupPasses);
+
+	TArray<FPakListEntry> Paks;
+	GetMountedPaks(Paks);
+
+	// Only filenames kept in the DirectoryIndex are known at runtime, those are used as lookup keys
+	TArray<FString> FullPaths;
+	for (FPakListEntry& Pak : Paks)
+	{
+		for (FPakFile::FFilenameIterator It(*Pak.PakFile); It; ++It)
+		{
+			FullPaths.Add(Pak.PakFile->GetMountPoint() + It.Filename());
+		}
+	}
+
+	// Each mode loads with a local copy of the settings, paks mounting meanwhile keep using the global ones
+	FPakFile::FIndexSettings IndexSettings = FPakFile::GetIndexSettings();
+	for (bool bSorted : { false, true })
+	{
+		IndexSettings.bSortedPathHashIndex = bSorted;
+
+		TArray<TRefCountPtr<FPakFile>> LoadedPaks;
+		SIZE_T PathHashSize = 0;
+		const double MountStartTime = FPlatformTime::Seconds();
+		for (FPakListEntry& Pak : Paks)
+		{
+			TRefCountPtr<FPakFile> LoadedPak = new FPakFile(LowerLevel, *Pak.PakFile->GetFilename(), Pak.PakFile->bSigned, true /* bLoadIndex */, IndexSettings);
+			if (LoadedPak->IsValid())
+			{
+				PathHashSize += LoadedPak->PathHashIndex.GetAllocatedSize() + LoadedPak->SortedPathHashIndex.GetAllocatedSize();
+				LoadedPaks.Add(MoveTemp(LoadedPak));
+			}
+		}
+		const double MountSeconds = FPlatformTime::Seconds() - MountStartTime;
+
+		int32 NumFound = 0;
+		const double FindStartTime = FPlatformTime::Seconds();
+		for (int32 Pass = 0; Pass < NumLookupPasses; ++Pass)
+		{
+			for (const FString& FullPath : FullPaths)
+			{
+				for (const TRefCountPtr<FPakFile>& LoadedPak : LoadedPaks)
+				{
+					if (LoadedPak->Find(FullPath, nullptr) != FPakFile::EFindResult::NotFound)
+					{
+						++NumFound;
+						break;
+					}
+				}
+			}
+		}
+		const double FindSeconds = FPlatformTime::Seconds() - FindStartTime;
+		const int32 NumLookups = FMath::Max(FullPaths.Num() * NumLookupPasses, 1);
+
+		Ar.Logf(TEXT("PakIndexBenchmark %s: %d paks loaded in %.2fms, PathHashSize=%llu bytes, %d lookups (%d found) in %.2fms, %.1fns per lookup"),
+			bSorted ? TEXT("SortedPathHashIndex") : TEXT("PathHashIndex"), LoadedPaks.Num(), MountSeconds * 1000.0, (uint64)PathHashSize,
+			NumLookups, NumFound, FindSeconds * 1000.0, FindSeconds * 1e9 / NumLookups);
+	}
+}
 #endif // !UE_BUILD_SHIPPING
 
 FPakPlatformFile::FPakPlatformFile()
@@ -7792,6 +7979,7 @@ void FPakPlatformFile::OptimizeMemoryUsageForMountedPaks()
 		}
 #endif
 		PathHashSize += PakFile->PathHashIndex.GetAllocatedSize();
+		PathHashSize += PakFile->SortedPathHashIndex.GetAllocatedSize();
 		EntriesSize += PakFile->EncodedPakEntries.GetAllocatedSize();
 		EntriesSize += PakFile->Files.GetAllocatedSize();
 	}
@@ -8514,8 +8702,13 @@ void FPakFile::AddSpecialFile(const FPakEntry& Entry, const FString& Filename)
 		NumEntries++;
 	}
 
-	FPathHashIndex* PathHashToWrite = bHasPathHashIndex ? &PathHashIndex : nullptr;
+	FPathHashIndex AddedPathHashes;
+	FPathHashIndex* PathHashToWrite = bHasPathHashIndex ? (bUseSortedPathHashIndex ? &AddedPathHashes : &PathHashIndex) : nullptr;
 	AddEntryToIndex(Filename, EntryLocation, MountPoint, PathHashSeed, &DirectoryIndex, PathHashToWrite, nullptr /* CollisionDetection */, Info.Version);
+	for (const TPair<uint64, FPakEntryLocation>& Pair : AddedPathHashes)
+	{
+		SortedPathHashIndex.Add(Pair.Key, Pair.Value);
+	}
 }
 
 void FPakPlatformFile::MakeUniquePakFilesForTheseFiles(const TArray<TArray<FString>>& InFiles)
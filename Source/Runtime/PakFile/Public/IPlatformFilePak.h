@@ -709,6 +709,59 @@ public:
 /** Pak directory type mapping a filename to an FPakEntryLocation. */
 typedef TMap<FString, FPakEntryLocation> FPakDirectory;
 
+/**
+ * Alternative storage for a pak's path hash index: hashes and locations in two parallel arrays sorted by hash.
+ * Lookups are a binary search over the contiguous hash array, and the index costs two allocations no matter how many entries
+ * it has, instead of the per-element hash buckets and sparse array slots of FPakFile::FPathHashIndex.
+ */
+struct FPakSortedPathHashIndex
+{
+	/** Lookup the location stored for the given hash, return nullptr if not found */
+	const FPakEntryLocation* Find(uint64 PathHash) const
+	{
+		const int32 Index = FindIndex(PathHash);
+		return Index != INDEX_NONE ? &Locations[Index] : nullptr;
+	}
+
+	/** Add or replace the location for the given hash, keeping the arrays sorted. Linear cost, intended for rare runtime additions. */
+	PAKFILE_API void Add(uint64 PathHash, const FPakEntryLocation& Location);
+
+	/** Read entries written in the FPakFile::FPathHashIndex (TMap) archive format and sort them */
+	PAKFILE_API void Load(FArchive& Ar);
+
+	int32 Num() const
+	{
+		return Hashes.Num();
+	}
+
+	uint64 GetHash(int32 Index) const
+	{
+		return Hashes[Index];
+	}
+
+	const FPakEntryLocation& GetLocation(int32 Index) const
+	{
+		return Locations[Index];
+	}
+
+	void Empty()
+	{
+		Hashes.Empty();
+		Locations.Empty();
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Hashes.GetAllocatedSize() + Locations.GetAllocatedSize();
+	}
+
+private:
+	PAKFILE_API int32 FindIndex(uint64 PathHash) const;
+
+	TArray<uint64> Hashes;
+	TArray<FPakEntryLocation> Locations;
+};
+
 /* Convenience struct for building FPakFile indexes from an enumeration of (Filename,FPakEntry) pairs */
 struct FPakEntryPair
 {
@@ -803,6 +856,8 @@ private:
 
 	/** Index data that provides a map from the hash of a Filename to an FPakEntryLocation */
 	FPathHashIndex PathHashIndex;
+	/** Sorted replacement for PathHashIndex, used instead of it when bUseSortedPathHashIndex is true */
+	FPakSortedPathHashIndex SortedPathHashIndex;
 	/* FPakEntries that have been serialized into a compacted format in an array of bytes. */
 	TArray<uint8> EncodedPakEntries;
 	/* The seed passed to the hash function for hashing filenames in this pak.  Differs per pack so that the same filename in different paks has different hashes */
@@ -820,6 +875,10 @@ private:
 	bool bIsValid;
 	/* True if the PathHashIndex has been populated for this PakFile */
 	bool bHasPathHashIndex;
+	/* True if the path hashes were loaded into SortedPathHashIndex rather than PathHashIndex */
+	bool bUseSortedPathHashIndex;
+	/* True if LoadIndexInternal should load the path hashes into SortedPathHashIndex, taken from the index settings at construction */
+	bool bLoadSortedPathHashIndex;
 	/* True if the DirectoryIndex has not been pruned and still contains a Filename for every FPakEntry in this PakFile */
 	bool bHasFullDirectoryIndex;
 #if ENABLE_PAKFILE_RUNTIME_PRUNING
@@ -1144,6 +1203,8 @@ public:
 		FPakDirectory::TConstIterator DirectoryIt;
 		/** Iterator when using the FPathHashIndex. */
 		FPathHashIndex::TConstIterator PathHashIt;
+		/** Position when using the FPakSortedPathHashIndex. */
+		int32 SortedPathHashIt;
 		/** The cached filename for return in Filename(). */
 		mutable FString CachedFilename;
 		/* The PakEntry for return in Info */
@@ -1162,7 +1223,7 @@ public:
 		{
 			if (bUsePathHash)
 			{
-				++PathHashIt;
+				AdvancePathHash();
 			}
 			else
 			{
@@ -1177,7 +1238,7 @@ public:
 		{
 			if (bUsePathHash)
 			{
-				return !!PathHashIt;
+				return IsPathHashValid();
 			}
 			else
 			{
@@ -1209,6 +1270,7 @@ public:
 			, DirectoryIndexIt(FDirectoryIndex())
 			, DirectoryIt(FPakDirectory())
 			, PathHashIt(PakFile.PathHashIndex)
+			, SortedPathHashIt(0)
 			, bUsePathHash(bInUsePathHash)
 			, bIncludeDeleted(bInIncludeDeleted)
 #if ENABLE_PAKFILE_RUNTIME_PRUNING
@@ -1273,7 +1335,7 @@ public:
 		{
 			if (bUsePathHash)
 			{
-				return PathHashIt.Value();
+				return PakFile.bUseSortedPathHashIndex ? PakFile.SortedPathHashIndex.GetLocation(SortedPathHashIt) : PathHashIt.Value();
 			}
 			else
 			{
@@ -1283,14 +1345,31 @@ public:
 
 	private:
 
+		FORCEINLINE bool IsPathHashValid() const
+		{
+			return PakFile.bUseSortedPathHashIndex ? SortedPathHashIt < PakFile.SortedPathHashIndex.Num() : !!PathHashIt;
+		}
+
+		FORCEINLINE void AdvancePathHash()
+		{
+			if (PakFile.bUseSortedPathHashIndex)
+			{
+				++SortedPathHashIt;
+			}
+			else
+			{
+				++PathHashIt;
+			}
+		}
+
 		/* Skips over deleted records and moves to the next Directory in the DirectoryIndex when necessary. */
 		FORCEINLINE void AdvanceToValid()
 		{
 			if (bUsePathHash)
 			{
-				while (PathHashIt && !bIncludeDeleted && Info().IsDeleteRecord())
+				while (IsPathHashValid() && !bIncludeDeleted && Info().IsDeleteRecord())
 				{
-					++PathHashIt;
+					AdvancePathHash();
 				}
 			}
 			else
@@ -1453,6 +1532,9 @@ public:
 	/** Lookup the FPakEntryLocation stored in the given PathHashIndex, return nullptr if not found */
 	static PAKFILE_API const FPakEntryLocation* FindLocationFromIndex(const FString& FullPath, const FString& MountPoint, const FPathHashIndex& PathHashIndex, uint64 PathHashSeed, int32 PakFileVersion);
 
+	/** Lookup the FPakEntryLocation stored in the given SortedPathHashIndex, return nullptr if not found */
+	static PAKFILE_API const FPakEntryLocation* FindLocationFromIndex(const FString& FullPath, const FString& MountPoint, const FPakSortedPathHashIndex& SortedPathHashIndex, uint64 PathHashSeed, int32 PakFileVersion);
+
 	/** Lookup the FPakEntryLocation stored in the given DirectoryIndex, return nullptr if not found */
 	static PAKFILE_API const FPakEntryLocation* FindLocationFromIndex(const FString& FullPath, const FString& MountPoint, const FDirectoryIndex& DirectoryIndex);
 
@@ -1607,6 +1689,9 @@ public:
 	/* Returns the global,const flag for whether UnrealPak should write a copy of the full DirectoryIndex to the PakFile */
 	static PAKFILE_API bool IsPakWriteFullDirectoryIndex();
 
+	/* Returns the global,const flag for whether PakFiles load their PathHashIndex into a FPakSortedPathHashIndex instead of a TMap */
+	static PAKFILE_API bool IsPakSortedPathHashIndex();
+
 private:
 
 	/**
@@ -1629,6 +1714,9 @@ private:
 
 	static PAKFILE_API FIndexSettings& GetIndexSettings();
 
+	/** Creates a pak file that loads its index with the given settings rather than the global ones */
+	PAKFILE_API FPakFile(IPlatformFile* LowerLevel, const TCHAR* Filename, bool bIsSigned, bool bLoadIndex, const FIndexSettings& IndexSettings);
+
 	/**
 	  * Returns the global,const flag for whether the current process should run directory queries on both the DirectoryIndex and the Pruned DirectoryIndex and log an error if they don't match.
 	  * Validation only occurs until the first call to OptimizeMemoryUsageForMountedPaks, after which the Full DirectoryIndex is dropped and there is nothing left to Validate
@@ -3138,6 +3226,7 @@ public:
 	PAKFILE_API void HandleUnmountCommand(const TCHAR* Cmd, FOutputDevice& Ar);
 	PAKFILE_API void HandlePakCorruptCommand(const TCHAR* Cmd, FOutputDevice& Ar);
 	PAKFILE_API void HandleReloadPakReadersCommand(const TCHAR* Cmd, FOutputDevice& Ar);
+	PAKFILE_API void HandlePakIndexBenchmarkCommand(const TCHAR* Cmd, FOutputDevice& Ar);
 #endif
 	// END Console commands
 	
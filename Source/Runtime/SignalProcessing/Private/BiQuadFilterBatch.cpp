@@ -0,0 +1,251 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DSP/BiQuadFilterBatch.h"
+#include "Math/UnrealMathVectorConstants.h"
+
+namespace Audio
+{
+	namespace BiquadFilterBatchPrivate
+	{
+		// Number of frames gathered into the scratch buffer at a time.
+		static constexpr int32 ChunkNumFrames = 64;
+
+		static void LoadCoefficients(const FBiquadCoefficients& InCoefficients, int32 InLane, int32 InNumLanes, float* OutCoefficients)
+		{
+			OutCoefficients[0 * InNumLanes + InLane] = InCoefficients.A0;
+			OutCoefficients[1 * InNumLanes + InLane] = InCoefficients.A1;
+			OutCoefficients[2 * InNumLanes + InLane] = InCoefficients.A2;
+			OutCoefficients[3 * InNumLanes + InLane] = InCoefficients.B1;
+			OutCoefficients[4 * InNumLanes + InLane] = InCoefficients.B2;
+		}
+
+		static bool IsInterpolating(const FBiquadBatchChannel& InChannel)
+		{
+			const FBiquadCoefficients& Start = InChannel.StartCoefficients;
+			const FBiquadCoefficients& End = InChannel.EndCoefficients;
+			return Start.A0 != End.A0 || Start.A1 != End.A1 || Start.A2 != End.A2 || Start.B1 != End.B1 || Start.B2 != End.B2;
+		}
+	}
+
+	FBiquadFilterBatch::FBiquadFilterBatch(int32 InNumLanes)
+	{
+		using namespace BiquadFilterBatchPrivate;
+
+		NumLanes = InNumLanes <= 4 ? 4 : (InNumLanes <= 8 ? 8 : 16);
+		Scratch.SetNumUninitialized(ChunkNumFrames * NumLanes);
+	}
+
+	void FBiquadFilterBatch::Reset()
+	{
+		Channels.Reset();
+	}
+
+	void FBiquadFilterBatch::AddChannel(const FBiquadBatchChannel& InChannel)
+	{
+		check(InChannel.Input && InChannel.Output && InChannel.State);
+		check(InChannel.Stride > 0);
+
+		Channels.Add(InChannel);
+	}
+
+	void FBiquadFilterBatch::ProcessAudio(int32 InNumFrames)
+	{
+		using namespace BiquadFilterBatchPrivate;
+
+		if (InNumFrames <= 0)
+		{
+			return;
+		}
+
+		for (int32 FirstChannel = 0; FirstChannel < Channels.Num(); FirstChannel += NumLanes)
+		{
+			const FBiquadBatchChannel* GroupChannels = &Channels[FirstChannel];
+			const int32 NumGroupChannels = FMath::Min(NumLanes, Channels.Num() - FirstChannel);
+
+			// Most filters keep the same coefficients for many blocks, which avoids stepping them every frame.
+			bool bInterpolate = false;
+			for (int32 i = 0; i < NumGroupChannels && !bInterpolate; i++)
+			{
+				bInterpolate = IsInterpolating(GroupChannels[i]);
+			}
+
+			switch (NumLanes)
+			{
+			case 4:
+				bInterpolate ? ProcessLanes<4, true>(GroupChannels, NumGroupChannels, InNumFrames) : ProcessLanes<4, false>(GroupChannels, NumGroupChannels, InNumFrames);
+				break;
+
+			case 8:
+				bInterpolate ? ProcessLanes<8, true>(GroupChannels, NumGroupChannels, InNumFrames) : ProcessLanes<8, false>(GroupChannels, NumGroupChannels, InNumFrames);
+				break;
+
+			default:
+				bInterpolate ? ProcessLanes<16, true>(GroupChannels, NumGroupChannels, InNumFrames) : ProcessLanes<16, false>(GroupChannels, NumGroupChannels, InNumFrames);
+				break;
+			}
+		}
+	}
+
+	template<int32 InNumLanes, bool bInterpolate>
+	void FBiquadFilterBatch::ProcessLanes(const FBiquadBatchChannel* InChannels, int32 InNumChannels, int32 InNumFrames)
+	{
+		using namespace BiquadFilterBatchPrivate;
+
+		static_assert(InNumLanes % 4 == 0, "Lanes are processed 4 at a time");
+		constexpr int32 NumRegisters = InNumLanes / 4;
+
+		// Structure of arrays copies of the coefficients and state of each lane. Unused lanes filter silence with zero coefficients.
+		alignas(16) float Coefficients[5 * InNumLanes] = {};
+		alignas(16) float Deltas[5 * InNumLanes] = {};
+		alignas(16) float State[4 * InNumLanes] = {};
+
+		for (int32 Lane = 0; Lane < InNumChannels; Lane++)
+		{
+			const FBiquadBatchChannel& Channel = InChannels[Lane];
+			LoadCoefficients(Channel.StartCoefficients, Lane, InNumLanes, Coefficients);
+
+			if constexpr (bInterpolate)
+			{
+				LoadCoefficients(Channel.EndCoefficients, Lane, InNumLanes, Deltas);
+				for (int32 i = 0; i < 5; i++)
+				{
+					float& Delta = Deltas[i * InNumLanes + Lane];
+					Delta = (Delta - Coefficients[i * InNumLanes + Lane]) / static_cast<float>(InNumFrames);
+				}
+			}
+
+			State[0 * InNumLanes + Lane] = Channel.State->X_Z1;
+			State[1 * InNumLanes + Lane] = Channel.State->X_Z2;
+			State[2 * InNumLanes + Lane] = Channel.State->Y_Z1;
+			State[3 * InNumLanes + Lane] = Channel.State->Y_Z2;
+		}
+
+		VectorRegister4Float A0[NumRegisters];
+		VectorRegister4Float A1[NumRegisters];
+		VectorRegister4Float A2[NumRegisters];
+		VectorRegister4Float B1[NumRegisters];
+		VectorRegister4Float B2[NumRegisters];
+		VectorRegister4Float A0Delta[NumRegisters];
+		VectorRegister4Float A1Delta[NumRegisters];
+		VectorRegister4Float A2Delta[NumRegisters];
+		VectorRegister4Float B1Delta[NumRegisters];
+		VectorRegister4Float B2Delta[NumRegisters];
+		VectorRegister4Float X_Z1[NumRegisters];
+		VectorRegister4Float X_Z2[NumRegisters];
+		VectorRegister4Float Y_Z1[NumRegisters];
+		VectorRegister4Float Y_Z2[NumRegisters];
+
+		for (int32 Register = 0; Register < NumRegisters; Register++)
+		{
+			const int32 Offset = Register * 4;
+			A0[Register] = VectorLoadAligned(&Coefficients[0 * InNumLanes + Offset]);
+			A1[Register] = VectorLoadAligned(&Coefficients[1 * InNumLanes + Offset]);
+			A2[Register] = VectorLoadAligned(&Coefficients[2 * InNumLanes + Offset]);
+			B1[Register] = VectorLoadAligned(&Coefficients[3 * InNumLanes + Offset]);
+			B2[Register] = VectorLoadAligned(&Coefficients[4 * InNumLanes + Offset]);
+			A0Delta[Register] = VectorLoadAligned(&Deltas[0 * InNumLanes + Offset]);
+			A1Delta[Register] = VectorLoadAligned(&Deltas[1 * InNumLanes + Offset]);
+			A2Delta[Register] = VectorLoadAligned(&Deltas[2 * InNumLanes + Offset]);
+			B1Delta[Register] = VectorLoadAligned(&Deltas[3 * InNumLanes + Offset]);
+			B2Delta[Register] = VectorLoadAligned(&Deltas[4 * InNumLanes + Offset]);
+			X_Z1[Register] = VectorLoadAligned(&State[0 * InNumLanes + Offset]);
+			X_Z2[Register] = VectorLoadAligned(&State[1 * InNumLanes + Offset]);
+			Y_Z1[Register] = VectorLoadAligned(&State[2 * InNumLanes + Offset]);
+			Y_Z2[Register] = VectorLoadAligned(&State[3 * InNumLanes + Offset]);
+		}
+
+		const VectorRegister4Float MinValue = VectorSetFloat1(FLT_MIN);
+		float* ScratchData = Scratch.GetData();
+
+		for (int32 FirstFrame = 0; FirstFrame < InNumFrames; FirstFrame += ChunkNumFrames)
+		{
+			const int32 NumChunkFrames = FMath::Min(ChunkNumFrames, InNumFrames - FirstFrame);
+
+			// Gather the chunk of every channel, one frame of all lanes per row. The whole chunk is read
+			// before any output is written, so channels can be filtered in place.
+			for (int32 Lane = 0; Lane < InNumLanes; Lane++)
+			{
+				if (Lane < InNumChannels)
+				{
+					const FBiquadBatchChannel& Channel = InChannels[Lane];
+					const float* Input = Channel.Input + FirstFrame * Channel.Stride;
+					for (int32 Frame = 0; Frame < NumChunkFrames; Frame++)
+					{
+						ScratchData[Frame * InNumLanes + Lane] = Input[Frame * Channel.Stride];
+					}
+				}
+				else
+				{
+					for (int32 Frame = 0; Frame < NumChunkFrames; Frame++)
+					{
+						ScratchData[Frame * InNumLanes + Lane] = 0.0f;
+					}
+				}
+			}
+
+			for (int32 Frame = 0; Frame < NumChunkFrames; Frame++)
+			{
+				float* FrameData = &ScratchData[Frame * InNumLanes];
+
+				for (int32 Register = 0; Register < NumRegisters; Register++)
+				{
+					if constexpr (bInterpolate)
+					{
+						A0[Register] = VectorAdd(A0[Register], A0Delta[Register]);
+						A1[Register] = VectorAdd(A1[Register], A1Delta[Register]);
+						A2[Register] = VectorAdd(A2[Register], A2Delta[Register]);
+						B1[Register] = VectorAdd(B1[Register], B1Delta[Register]);
+						B2[Register] = VectorAdd(B2[Register], B2Delta[Register]);
+					}
+
+					const VectorRegister4Float Input = VectorLoadAligned(&FrameData[Register * 4]);
+
+					// y(n) = a0*x(n) + a1*x(n-1) + a2*x(n-2) - b1*y(n-1) - b2*y(n-2)
+					VectorRegister4Float Output = VectorMultiply(A0[Register], Input);
+					Output = VectorMultiplyAdd(A1[Register], X_Z1[Register], Output);
+					Output = VectorMultiplyAdd(A2[Register], X_Z2[Register], Output);
+					Output = VectorNegateMultiplyAdd(B1[Register], Y_Z1[Register], Output);
+					Output = VectorNegateMultiplyAdd(B2[Register], Y_Z2[Register], Output);
+
+					// Clamp the output to 0.0 if in sub-normal float region
+					Output = VectorBitwiseAnd(Output, VectorCompareGE(VectorAbs(Output), MinValue));
+
+					X_Z2[Register] = X_Z1[Register];
+					X_Z1[Register] = Input;
+					Y_Z2[Register] = Y_Z1[Register];
+					Y_Z1[Register] = Output;
+
+					VectorStoreAligned(Output, &FrameData[Register * 4]);
+				}
+			}
+
+			for (int32 Lane = 0; Lane < InNumChannels; Lane++)
+			{
+				const FBiquadBatchChannel& Channel = InChannels[Lane];
+				float* Output = Channel.Output + FirstFrame * Channel.Stride;
+				for (int32 Frame = 0; Frame < NumChunkFrames; Frame++)
+				{
+					Output[Frame * Channel.Stride] = ScratchData[Frame * InNumLanes + Lane];
+				}
+			}
+		}
+
+		for (int32 Register = 0; Register < NumRegisters; Register++)
+		{
+			const int32 Offset = Register * 4;
+			VectorStoreAligned(X_Z1[Register], &State[0 * InNumLanes + Offset]);
+			VectorStoreAligned(X_Z2[Register], &State[1 * InNumLanes + Offset]);
+			VectorStoreAligned(Y_Z1[Register], &State[2 * InNumLanes + Offset]);
+			VectorStoreAligned(Y_Z2[Register], &State[3 * InNumLanes + Offset]);
+		}
+
+		for (int32 Lane = 0; Lane < InNumChannels; Lane++)
+		{
+			FBiquadFilterState& ChannelState = *InChannels[Lane].State;
+			ChannelState.X_Z1 = State[0 * InNumLanes + Lane];
+			ChannelState.X_Z2 = State[1 * InNumLanes + Lane];
+			ChannelState.Y_Z1 = State[2 * InNumLanes + Lane];
+			ChannelState.Y_Z2 = State[3 * InNumLanes + Lane];
+		}
+	}
+}
@@ -0,0 +1,203 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "DSP/BiQuadFilterBatch.h"
+#include "DSP/InterpolatedOnePole.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "SignalProcessingModule.h"
+
+namespace Audio::BiquadFilterBatchBenchmark
+{
+	static const float SampleRate = 48000.f;
+	static const int32 NumChannels = 2;
+
+	// Filters of a voice, like the per-source filters of the audio mixer.
+	struct FVoice
+	{
+		FInterpolatedLPF LowPassFilter;
+		FInterpolatedHPF HighPassFilter;
+		FBiquadFilterState LowPassStates[NumChannels];
+		FBiquadFilterState HighPassStates[NumChannels];
+		TArray<float> Output;
+	};
+
+	// Returns the cutoff frequencies of each voice for a block. Frequencies change every few blocks, like moving sources.
+	static void GetFrequencies(int32 InVoiceIndex, int32 InBlock, float& OutLowPassFrequency, float& OutHighPassFrequency)
+	{
+		FRandomStream Random(InVoiceIndex * 7919 + InBlock / 4);
+		OutLowPassFrequency = Random.FRandRange(1000.f, 18000.f);
+		OutHighPassFrequency = Random.FRandRange(20.f, 500.f);
+	}
+
+	static void InitVoices(TArray<FVoice>& OutVoices, int32 InNumVoices, int32 InBlockSize)
+	{
+		OutVoices.SetNum(InNumVoices);
+		for (FVoice& Voice : OutVoices)
+		{
+			Voice.LowPassFilter.Init(SampleRate, NumChannels);
+			Voice.HighPassFilter.Init(SampleRate, NumChannels);
+			Voice.Output.SetNumZeroed(InBlockSize * NumChannels);
+		}
+	}
+
+	// Filters every voice separately, returning the time spent filtering.
+	static double RunScalar(TArray<FVoice>& Voices, const TArray<float>& Input, int32 InBlockSize, int32 InNumBlocks)
+	{
+		double Seconds = 0.0;
+		for (int32 Block = 0; Block < InNumBlocks; Block++)
+		{
+			for (int32 VoiceIndex = 0; VoiceIndex < Voices.Num(); VoiceIndex++)
+			{
+				FVoice& Voice = Voices[VoiceIndex];
+				float LowPassFrequency, HighPassFrequency;
+				GetFrequencies(VoiceIndex, Block, LowPassFrequency, HighPassFrequency);
+				Voice.LowPassFilter.StartFrequencyInterpolation(LowPassFrequency, InBlockSize);
+				Voice.HighPassFilter.StartFrequencyInterpolation(HighPassFrequency, InBlockSize);
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 VoiceIndex = 0; VoiceIndex < Voices.Num(); VoiceIndex++)
+			{
+				FVoice& Voice = Voices[VoiceIndex];
+				const float* VoiceInput = &Input[(VoiceIndex * 997 + Block * InBlockSize * NumChannels) % (Input.Num() - InBlockSize * NumChannels)];
+				Voice.LowPassFilter.ProcessAudioBuffer(VoiceInput, Voice.Output.GetData(), InBlockSize * NumChannels);
+				Voice.HighPassFilter.ProcessAudioBuffer(Voice.Output.GetData(), Voice.Output.GetData(), InBlockSize * NumChannels);
+			}
+			Seconds += FPlatformTime::Seconds() - StartTime;
+
+			for (FVoice& Voice : Voices)
+			{
+				Voice.LowPassFilter.StopFrequencyInterpolation();
+				Voice.HighPassFilter.StopFrequencyInterpolation();
+			}
+		}
+		return Seconds;
+	}
+
+	// Filters all voices with batches of InNumLanes filters, the way the audio mixer source manager does.
+	static double RunBatched(TArray<FVoice>& Voices, const TArray<float>& Input, int32 InBlockSize, int32 InNumBlocks, int32 InNumLanes)
+	{
+		FBiquadFilterBatch LowPassBatch(InNumLanes);
+		FBiquadFilterBatch HighPassBatch(InNumLanes);
+
+		double Seconds = 0.0;
+		for (int32 Block = 0; Block < InNumBlocks; Block++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			LowPassBatch.Reset();
+			HighPassBatch.Reset();
+			for (int32 VoiceIndex = 0; VoiceIndex < Voices.Num(); VoiceIndex++)
+			{
+				FVoice& Voice = Voices[VoiceIndex];
+				float LowPassFrequency, HighPassFrequency;
+				GetFrequencies(VoiceIndex, Block, LowPassFrequency, HighPassFrequency);
+				Voice.LowPassFilter.StartFrequencyInterpolation(LowPassFrequency, InBlockSize);
+				Voice.HighPassFilter.StartFrequencyInterpolation(HighPassFrequency, InBlockSize);
+
+				FBiquadBatchChannel LowPassChannel;
+				FBiquadBatchChannel HighPassChannel;
+				Voice.LowPassFilter.GetBiquadCoefficients(LowPassChannel.StartCoefficients, LowPassChannel.EndCoefficients);
+				Voice.HighPassFilter.GetBiquadCoefficients(HighPassChannel.StartCoefficients, HighPassChannel.EndCoefficients);
+				LowPassChannel.Stride = NumChannels;
+				HighPassChannel.Stride = NumChannels;
+
+				const float* VoiceInput = &Input[(VoiceIndex * 997 + Block * InBlockSize * NumChannels) % (Input.Num() - InBlockSize * NumChannels)];
+				for (int32 Channel = 0; Channel < NumChannels; Channel++)
+				{
+					LowPassChannel.Input = VoiceInput + Channel;
+					LowPassChannel.Output = Voice.Output.GetData() + Channel;
+					LowPassChannel.State = &Voice.LowPassStates[Channel];
+					LowPassBatch.AddChannel(LowPassChannel);
+
+					HighPassChannel.Input = Voice.Output.GetData() + Channel;
+					HighPassChannel.Output = Voice.Output.GetData() + Channel;
+					HighPassChannel.State = &Voice.HighPassStates[Channel];
+					HighPassBatch.AddChannel(HighPassChannel);
+				}
+			}
+
+			LowPassBatch.ProcessAudio(InBlockSize);
+			HighPassBatch.ProcessAudio(InBlockSize);
+			Seconds += FPlatformTime::Seconds() - StartTime;
+
+			for (FVoice& Voice : Voices)
+			{
+				Voice.LowPassFilter.StopFrequencyInterpolation();
+				Voice.HighPassFilter.StopFrequencyInterpolation();
+			}
+		}
+		return Seconds;
+	}
+
+	static float GetMaxError(const TArray<FVoice>& InExpected, const TArray<FVoice>& InVoices)
+	{
+		float MaxError = 0.f;
+		for (int32 VoiceIndex = 0; VoiceIndex < InVoices.Num(); VoiceIndex++)
+		{
+			const TArray<float>& Expected = InExpected[VoiceIndex].Output;
+			const TArray<float>& Output = InVoices[VoiceIndex].Output;
+			for (int32 i = 0; i < Output.Num(); i++)
+			{
+				MaxError = FMath::Max(MaxError, FMath::Abs(Expected[i] - Output[i]));
+			}
+		}
+		return MaxError;
+	}
+
+	static void RunBiquadFilterBatchBenchmark(const TArray<FString>& Args)
+	{
+		int32 BlockSize = 256;
+		int32 NumBlocks = 200;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Block="), BlockSize);
+			FParse::Value(*Arg, TEXT("Blocks="), NumBlocks);
+		}
+		BlockSize = FMath::Clamp(BlockSize, 16, 4096);
+		NumBlocks = FMath::Clamp(NumBlocks, 1, 10000);
+
+		FRandomStream Random(1234);
+		TArray<float> Input;
+		Input.SetNumUninitialized(1 << 18);
+		for (float& Sample : Input)
+		{
+			Sample = Random.FRandRange(-1.f, 1.f);
+		}
+
+		UE_LOG(LogSignalProcessing, Display, TEXT("Biquad filter batch benchmark: stereo voices with a LPF and a HPF, %d frame blocks at %.0fHz. Cost is the average time per voice and block, in microseconds."),
+			BlockSize, SampleRate);
+		UE_LOG(LogSignalProcessing, Display, TEXT("%8s %10s %10s %10s %10s %10s"), TEXT("Voices"), TEXT("Scalar"), TEXT("4 Lanes"), TEXT("8 Lanes"), TEXT("16 Lanes"), TEXT("Error"));
+
+		for (const int32 NumVoices : { 64, 256, 1024 })
+		{
+			TArray<FVoice> ScalarVoices;
+			InitVoices(ScalarVoices, NumVoices, BlockSize);
+			const double ScalarSeconds = RunScalar(ScalarVoices, Input, BlockSize, NumBlocks);
+
+			double BatchedSeconds[3];
+			float MaxError = 0.f;
+			int32 LaneIndex = 0;
+			for (const int32 NumLanes : { 4, 8, 16 })
+			{
+				TArray<FVoice> Voices;
+				InitVoices(Voices, NumVoices, BlockSize);
+				BatchedSeconds[LaneIndex++] = RunBatched(Voices, Input, BlockSize, NumBlocks, NumLanes);
+
+				// FInterpolatedHPF keeps different delay terms, so outputs differ slightly while cutoff frequencies change.
+				MaxError = FMath::Max(MaxError, GetMaxError(ScalarVoices, Voices));
+			}
+
+			const double Scale = 1000000.0 / ((double)NumVoices * NumBlocks);
+			UE_LOG(LogSignalProcessing, Display, TEXT("%8d %10.3f %10.3f %10.3f %10.3f %10.1e"),
+				NumVoices, ScalarSeconds * Scale, BatchedSeconds[0] * Scale, BatchedSeconds[1] * Scale, BatchedSeconds[2] * Scale, MaxError);
+		}
+	}
+}
+
+static FAutoConsoleCommand BiquadFilterBatchBenchmarkCmd(
+	TEXT("au.BiquadFilterBatch.Benchmark"),
+	TEXT("Compares the cost per voice of per-voice filters with batched biquad filters at 64, 256 and 1024 voices. Usage: au.BiquadFilterBatch.Benchmark [Block=256] [Blocks=200]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&Audio::BiquadFilterBatchBenchmark::RunBiquadFilterBatchBenchmark));
@@ -63,10 +63,16 @@ namespace Audio
 		}
 
 		// Sort factories by preference. 
-		Factories.Sort([](const IConvolutionAlgorithmFactory& InFactoryA, const IConvolutionAlgorithmFactory& InFactoryB) 
+		Factories.Sort([&InSettings](const IConvolutionAlgorithmFactory& InFactoryA, const IConvolutionAlgorithmFactory& InFactoryB) 
 		{
 			// If InFactoryA has hardware acceleration and InFactoryB does not, then InFactoryA goes earlier.
-			if (InFactoryA.IsHardwareAccelerated() && !InFactoryB.IsHardwareAccelerated())
+			if (InFactoryA.IsHardwareAccelerated() != InFactoryB.IsHardwareAccelerated())
+			{
+				return InFactoryA.IsHardwareAccelerated();
+			}
+
+			// If InFactoryA is better suited to the settings, then InFactoryA goes earlier.
+			if (InFactoryA.GetSettingsPreference(InSettings) > InFactoryB.GetSettingsPreference(InSettings))
 			{
 				return true;
 			}
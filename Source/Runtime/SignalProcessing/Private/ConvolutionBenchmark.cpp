@@ -0,0 +1,168 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "DSP/ConvolutionAlgorithm.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "NonUniformPartitionConvolution.h"
+#include "SignalProcessingModule.h"
+#include "UniformPartitionConvolution.h"
+
+namespace Audio::ConvolutionBenchmark
+{
+	static const float SampleRate = 48000.f;
+
+	struct FResult
+	{
+		double SecondsPerBlock = 0.0;
+		double MaxBlockSeconds = 0.0;
+		TArray<float> Output;
+	};
+
+	// Runs a convolution of each input channel with its own impulse response, like a reverb, and
+	// returns the audio thread cost per block.
+	static FResult RunConvolution(IConvolutionAlgorithm& Convolution, const TArray<float>& ImpulseResponse, const TArray<float>& Input, int32 NumBlocks)
+	{
+		const int32 NumChannels = Convolution.GetNumAudioInputs();
+		const int32 BlockSize = Convolution.GetNumSamplesInBlock();
+
+		for (int32 i = 0; i < NumChannels; i++)
+		{
+			Convolution.SetImpulseResponse(i, ImpulseResponse.GetData(), ImpulseResponse.Num());
+			Convolution.SetMatrixGain(i, i, i, 1.f);
+		}
+
+		TArray<float> OutputBuffer;
+		OutputBuffer.SetNumZeroed(NumChannels * BlockSize);
+		TArray<const float*> InputPtrs;
+		TArray<float*> OutputPtrs;
+		InputPtrs.SetNum(NumChannels);
+		OutputPtrs.SetNum(NumChannels);
+		for (int32 i = 0; i < NumChannels; i++)
+		{
+			OutputPtrs[i] = &OutputBuffer[i * BlockSize];
+		}
+
+		FResult Result;
+		Result.Output.Reserve(NumBlocks * BlockSize);
+
+		double TotalSeconds = 0.0;
+		for (int32 Block = 0; Block < NumBlocks; Block++)
+		{
+			for (int32 i = 0; i < NumChannels; i++)
+			{
+				InputPtrs[i] = &Input[((Block * NumChannels + i) * BlockSize) % (Input.Num() - BlockSize)];
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			Convolution.ProcessAudioBlock(InputPtrs.GetData(), OutputPtrs.GetData());
+			const double BlockSeconds = FPlatformTime::Seconds() - StartTime;
+
+			TotalSeconds += BlockSeconds;
+			Result.MaxBlockSeconds = FMath::Max(Result.MaxBlockSeconds, BlockSeconds);
+			Result.Output.Append(OutputPtrs[0], BlockSize);
+		}
+
+		Result.SecondsPerBlock = TotalSeconds / NumBlocks;
+		return Result;
+	}
+
+	static void RunConvolutionBenchmark(const TArray<FString>& Args)
+	{
+		int32 BlockSize = 256;
+		int32 NumBlocks = 0;
+		int32 MaxChannels = 8;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Block="), BlockSize);
+			FParse::Value(*Arg, TEXT("Blocks="), NumBlocks);
+			FParse::Value(*Arg, TEXT("Channels="), MaxChannels);
+		}
+		BlockSize = FMath::Clamp((int32)FMath::RoundUpToPowerOfTwo(FMath::Max(BlockSize, 1)), 32, 4096);
+		MaxChannels = FMath::Clamp(MaxChannels, 1, 32);
+
+		FRandomStream Random(1234);
+		TArray<float> Input;
+		Input.SetNumUninitialized(1 << 18);
+		for (float& Sample : Input)
+		{
+			Sample = Random.FRandRange(-1.f, 1.f);
+		}
+
+		UE_LOG(LogSignalProcessing, Display, TEXT("Convolution benchmark: %d sample blocks at %.0fHz. Cost is the average audio thread time per block, as a percentage of the block duration."),
+			BlockSize, SampleRate);
+		UE_LOG(LogSignalProcessing, Display, TEXT("%8s %8s %12s %12s %12s %10s %8s"), TEXT("IR"), TEXT("Channels"), TEXT("Uniform"), TEXT("NonUniform"), TEXT("Async"), TEXT("Worst"), TEXT("Error"));
+
+		const double BlockSeconds = BlockSize / SampleRate;
+		for (const float IRSeconds : { 0.5f, 1.f, 2.f, 4.f, 8.f })
+		{
+			// Exponentially decaying noise, like a reverb impulse response.
+			TArray<float> ImpulseResponse;
+			ImpulseResponse.SetNumUninitialized((int32)(IRSeconds * SampleRate));
+			for (int32 i = 0; i < ImpulseResponse.Num(); i++)
+			{
+				ImpulseResponse[i] = Random.FRandRange(-1.f, 1.f) * FMath::Exp(-6.9f * i / ImpulseResponse.Num()) * 0.05f;
+			}
+
+			// Run long enough for the largest partitions to be processed a few times.
+			const int32 NumBlocksToRun = NumBlocks > 0 ? NumBlocks : FMath::Max(256, 4 * ImpulseResponse.Num() / BlockSize);
+
+			for (int32 NumChannels = 1; NumChannels <= MaxChannels; NumChannels *= 2)
+			{
+				FUniformPartitionConvolutionFactory UniformFactory;
+				FConvolutionSettings ConvolutionSettings;
+				ConvolutionSettings.BlockNumSamples = BlockSize;
+				ConvolutionSettings.NumInputChannels = NumChannels;
+				ConvolutionSettings.NumOutputChannels = NumChannels;
+				ConvolutionSettings.NumImpulseResponses = NumChannels;
+				ConvolutionSettings.MaxNumImpulseResponseSamples = ImpulseResponse.Num();
+
+				if (!UniformFactory.AreConvolutionSettingsSupported(ConvolutionSettings))
+				{
+					UE_LOG(LogSignalProcessing, Warning, TEXT("Convolution benchmark: unsupported settings"));
+					return;
+				}
+
+				TUniquePtr<IConvolutionAlgorithm> Uniform = UniformFactory.NewConvolutionAlgorithm(ConvolutionSettings);
+
+				FNonUniformPartitionConvolutionSettings Settings = FNonUniformPartitionConvolutionFactory::SettingsFromConvolutionSettings(ConvolutionSettings);
+				Settings.bProcessLatePartitionsAsync = false;
+				FNonUniformPartitionConvolution NonUniform(Settings);
+				Settings.bProcessLatePartitionsAsync = true;
+				FNonUniformPartitionConvolution NonUniformAsync(Settings);
+
+				if (!Uniform.IsValid() || !NonUniform.IsValid() || !NonUniformAsync.IsValid())
+				{
+					UE_LOG(LogSignalProcessing, Warning, TEXT("Convolution benchmark: failed to create convolutions"));
+					return;
+				}
+
+				const FResult UniformResult = RunConvolution(*Uniform, ImpulseResponse, Input, NumBlocksToRun);
+				const FResult NonUniformResult = RunConvolution(NonUniform, ImpulseResponse, Input, NumBlocksToRun);
+				const FResult AsyncResult = RunConvolution(NonUniformAsync, ImpulseResponse, Input, NumBlocksToRun);
+
+				// Both algorithms compute the same convolution, so outputs should only differ by rounding.
+				float MaxError = 0.f;
+				for (int32 i = 0; i < UniformResult.Output.Num(); i++)
+				{
+					MaxError = FMath::Max(MaxError, FMath::Abs(UniformResult.Output[i] - AsyncResult.Output[i]));
+				}
+
+				UE_LOG(LogSignalProcessing, Display, TEXT("%7.1fs %8d %11.2f%% %11.2f%% %11.2f%% %9.2f%% %8.1e"),
+					IRSeconds, NumChannels,
+					100.0 * UniformResult.SecondsPerBlock / BlockSeconds,
+					100.0 * NonUniformResult.SecondsPerBlock / BlockSeconds,
+					100.0 * AsyncResult.SecondsPerBlock / BlockSeconds,
+					100.0 * AsyncResult.MaxBlockSeconds / BlockSeconds,
+					MaxError);
+			}
+		}
+	}
+}
+
+static FAutoConsoleCommand ConvolutionBenchmarkCmd(
+	TEXT("au.Convolution.Benchmark"),
+	TEXT("Compares the audio thread cost of uniform and non-uniform partition convolution, per impulse response length and channel count. Usage: au.Convolution.Benchmark [Block=256] [Blocks=0] [Channels=8]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&Audio::ConvolutionBenchmark::RunConvolutionBenchmark));
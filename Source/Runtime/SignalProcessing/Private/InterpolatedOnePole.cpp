@@ -113,6 +113,20 @@ namespace Audio
 		}
 	}
 
+	void FInterpolatedLPF::GetBiquadCoefficients(FBiquadCoefficients& OutStartCoefficients, FBiquadCoefficients& OutEndCoefficients) const
+	{
+		// Yn = Xn*(1-B1) + B1*Z1
+		auto ToBiquad = [](float InB1, FBiquadCoefficients& OutCoefficients)
+		{
+			OutCoefficients = FBiquadCoefficients();
+			OutCoefficients.A0 = 1.0f - InB1;
+			OutCoefficients.B1 = -InB1;
+		};
+
+		ToBiquad(B1Curr, OutStartCoefficients);
+		ToBiquad(B1Curr + B1Delta * static_cast<float>(CurrInterpLength), OutEndCoefficients);
+	}
+
 	void FInterpolatedLPF::Reset()
 	{
 		B1Curr = 0.0f;
@@ -213,6 +227,21 @@ namespace Audio
 		}
 	}
 
+	void FInterpolatedHPF::GetBiquadCoefficients(FBiquadCoefficients& OutStartCoefficients, FBiquadCoefficients& OutEndCoefficients) const
+	{
+		// The transfer function of the high-pass output is (1 - A0) * (1 - z^-1) / (1 + (2 * A0 - 1) * z^-1)
+		auto ToBiquad = [](float InA0, FBiquadCoefficients& OutCoefficients)
+		{
+			OutCoefficients = FBiquadCoefficients();
+			OutCoefficients.A0 = 1.0f - InA0;
+			OutCoefficients.A1 = InA0 - 1.0f;
+			OutCoefficients.B1 = 2.0f * InA0 - 1.0f;
+		};
+
+		ToBiquad(A0Curr, OutStartCoefficients);
+		ToBiquad(A0Curr + A0Delta * static_cast<float>(CurrInterpLength), OutEndCoefficients);
+	}
+
 	void FInterpolatedHPF::Reset()
 	{
 		A0Curr = 0.0f;
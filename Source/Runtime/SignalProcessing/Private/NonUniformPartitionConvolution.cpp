@@ -0,0 +1,646 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NonUniformPartitionConvolution.h"
+#include "CoreMinimal.h"
+#include "SignalProcessingModule.h"
+#include "DSP/FloatArrayMath.h"
+#include "HAL/IConsoleManager.h"
+
+static int32 AudioConvolutionAsyncLatePartitionsCVar = 1;
+FAutoConsoleVariableRef CVarAudioConvolutionAsyncLatePartitions(
+	TEXT("au.Convolution.AsyncLatePartitions"),
+	AudioConvolutionAsyncLatePartitionsCVar,
+	TEXT("If non-zero, non-uniform partition convolutions process partitions larger than an audio block on worker threads.\n")
+	TEXT("Only applies to convolutions created after it is changed."),
+	ECVF_Default);
+
+///////////////////////////////////////////////////////////////////////////////
+// Note on stage layout
+//
+// Each stage uses the overlap save method described in UniformPartitionConvolution.cpp
+// with an FFT of twice its partition size P. When the stage has received P new input
+// samples at time T, it transforms the last 2P input samples into its delay line and
+// multiplies the delay line by the transformed partitions, producing P output samples.
+//
+// The first stage covers the first 2 * 4B - B samples of the impulse response, B being
+// the block size, and its output is used straight away. A stage of partition size P
+// starts at impulse response sample 2P - B, so the output computed at time T is needed
+// from time T + P - B onwards, i.e. from the block ending at T + P. Late stages therefore
+// double buffer their output and have P / B blocks to compute the next partition.
+//
+// With a factor of 4 between stages, every stage but the first and last one holds 6
+// partitions.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Audio
+{
+	namespace NonUniformPartitionConvolutionPrivate
+	{
+		// Growth of the partition size from one stage to the next.
+		static const int32 StagePartitionSizeFactor = 4;
+
+		// Number of floats in the expanded form of NumComplexFloats interleaved complex floats.
+		static int32 GetNumExpandedFloats(int32 NumComplexFloats)
+		{
+			return NumComplexFloats * 2;
+		}
+
+		// Expand interleaved complex values [r0, i0, r1, i1, ...] so they can be multiplied without shuffles.
+		//
+		// Each pair of complex values is stored as [r0, r0, r1, r1, -i0, i0, -i1, i1]. A trailing single
+		// complex value is stored as [r, r, -i, i].
+		static void ExpandComplex(const float* RESTRICT InComplex, int32 Num, float* RESTRICT OutExpanded)
+		{
+			check(Num % 2 == 0);
+
+			int32 i = 0;
+			for (; i + 4 <= Num; i += 4)
+			{
+				float* Out = &OutExpanded[i * 2];
+				Out[0] = InComplex[i];
+				Out[1] = InComplex[i];
+				Out[2] = InComplex[i + 2];
+				Out[3] = InComplex[i + 2];
+				Out[4] = -InComplex[i + 1];
+				Out[5] = InComplex[i + 1];
+				Out[6] = -InComplex[i + 3];
+				Out[7] = InComplex[i + 3];
+			}
+
+			if (i < Num)
+			{
+				float* Out = &OutExpanded[i * 2];
+				Out[0] = InComplex[i];
+				Out[1] = InComplex[i];
+				Out[2] = -InComplex[i + 1];
+				Out[3] = InComplex[i + 1];
+			}
+		}
+
+		// Out += InA * InB, InA and Out being interleaved complex values and InB the expanded form of
+		// interleaved complex values. Num is the number of floats in InA and Out.
+		//
+		// Two complex values are processed per vector with two multiply adds:
+		// 	Out += [Ar0, Ai0, Ar1, Ai1] * [Br0, Br0, Br1, Br1]
+		// 	Out += [Ai0, Ar0, Ai1, Ar1] * [-Bi0, Bi0, -Bi1, Bi1]
+		static void ComplexMultiplyAdd(const float* RESTRICT InA, const float* RESTRICT InExpandedB, float* RESTRICT Out, int32 Num)
+		{
+			const int32 NumSimd = Num & ~3;
+
+			int32 i = 0;
+			for (; i + 8 <= NumSimd; i += 8)
+			{
+				const VectorRegister4Float A0 = VectorLoadAligned(&InA[i]);
+				const VectorRegister4Float A1 = VectorLoadAligned(&InA[i + 4]);
+				VectorRegister4Float Out0 = VectorLoadAligned(&Out[i]);
+				VectorRegister4Float Out1 = VectorLoadAligned(&Out[i + 4]);
+
+				Out0 = VectorMultiplyAdd(A0, VectorLoadAligned(&InExpandedB[i * 2]), Out0);
+				Out1 = VectorMultiplyAdd(A1, VectorLoadAligned(&InExpandedB[i * 2 + 8]), Out1);
+				Out0 = VectorMultiplyAdd(VectorSwizzle(A0, 1, 0, 3, 2), VectorLoadAligned(&InExpandedB[i * 2 + 4]), Out0);
+				Out1 = VectorMultiplyAdd(VectorSwizzle(A1, 1, 0, 3, 2), VectorLoadAligned(&InExpandedB[i * 2 + 12]), Out1);
+
+				VectorStoreAligned(Out0, &Out[i]);
+				VectorStoreAligned(Out1, &Out[i + 4]);
+			}
+
+			for (; i < NumSimd; i += 4)
+			{
+				const VectorRegister4Float A = VectorLoadAligned(&InA[i]);
+				VectorRegister4Float VectorOut = VectorLoadAligned(&Out[i]);
+
+				VectorOut = VectorMultiplyAdd(A, VectorLoadAligned(&InExpandedB[i * 2]), VectorOut);
+				VectorOut = VectorMultiplyAdd(VectorSwizzle(A, 1, 0, 3, 2), VectorLoadAligned(&InExpandedB[i * 2 + 4]), VectorOut);
+
+				VectorStoreAligned(VectorOut, &Out[i]);
+			}
+
+			for (; i < Num; i += 2)
+			{
+				const float* B = &InExpandedB[i * 2];
+				// Real output
+				Out[i] += (InA[i] * B[0]) + (InA[i + 1] * B[2]);
+				// Imaginary output
+				Out[i + 1] += (InA[i + 1] * B[1]) + (InA[i] * B[3]);
+			}
+		}
+
+		static void ZeroBuffer(FAlignedFloatBuffer& InBuffer)
+		{
+			FMemory::Memset(InBuffer.GetData(), 0, sizeof(float) * InBuffer.Num());
+		}
+	}
+
+	FNonUniformPartitionConvolution::FNonUniformPartitionConvolution(const FNonUniformPartitionConvolutionSettings& InSettings)
+	:	Settings(InSettings)
+	,	BlockSize(InSettings.BlockNumSamples)
+	,	bIsValid(false)
+	{
+		check(BlockSize > 0);
+		check(FMath::IsPowerOfTwo(BlockSize));
+
+		NumImpulseResponseSamples.Init(0, Settings.NumImpulseResponses);
+
+		InitStages();
+	}
+
+	FNonUniformPartitionConvolution::~FNonUniformPartitionConvolution()
+	{
+		WaitForStages();
+	}
+
+	void FNonUniformPartitionConvolution::InitStages()
+	{
+		using namespace NonUniformPartitionConvolutionPrivate;
+
+		const int32 MaxPartitionSize = FMath::Max(BlockSize, (int32)FMath::RoundUpToPowerOfTwo(FMath::Max(Settings.MaxPartitionSize, 1)));
+		const int32 MaxNumSamples = FMath::Max(Settings.MaxNumImpulseResponseSamples, 1);
+
+		int32 PartitionSize = BlockSize;
+		int32 Offset = 0;
+		while (Offset < MaxNumSamples)
+		{
+			// The next stage starts where it has one partition of time to compute its output.
+			const int32 NextPartitionSize = PartitionSize * StagePartitionSizeFactor;
+			const int32 NextOffset = 2 * NextPartitionSize - BlockSize;
+			const bool bIsLastStage = (NextPartitionSize > MaxPartitionSize) || (NextOffset >= MaxNumSamples);
+
+			FStage& Stage = Stages.AddDefaulted_GetRef();
+			Stage.PartitionSize = PartitionSize;
+			Stage.Offset = Offset;
+			Stage.bIsLate = PartitionSize > BlockSize;
+			Stage.NumPartitions = bIsLastStage ? FMath::DivideAndRoundUp(MaxNumSamples - Offset, PartitionSize) : (NextOffset - Offset) / PartitionSize;
+			Stage.ReadIndex = 0;
+			Stage.WriteIndex = Stage.bIsLate ? 1 : 0;
+
+			Offset += Stage.NumPartitions * PartitionSize;
+			PartitionSize = NextPartitionSize;
+		}
+
+		bIsValid = true;
+		for (FStage& Stage : Stages)
+		{
+			FFFTSettings FFTSettings;
+			FFTSettings.Log2Size = FMath::CountTrailingZeros(Stage.PartitionSize) + 1;
+			FFTSettings.bArrays128BitAligned = true;
+			FFTSettings.bEnableHardwareAcceleration = Settings.bEnableHardwareAcceleration;
+
+			Stage.FFTAlgorithm = FFFTFactory::NewFFTAlgorithm(FFTSettings);
+			if (!Stage.FFTAlgorithm.IsValid())
+			{
+				UE_LOG(LogSignalProcessing, Error, TEXT("Failed to create FFT of %d samples for non-uniform partition convolution"), 2 * Stage.PartitionSize);
+				bIsValid = false;
+				continue;
+			}
+
+			const int32 FFTSize = Stage.FFTAlgorithm->Size();
+			Stage.NumFFTOutputFloats = Stage.FFTAlgorithm->NumOutputFloats();
+
+			Stage.InputHistory.SetNum(Settings.NumInputChannels);
+			Stage.ProcessInput.SetNum(Settings.NumInputChannels);
+			Stage.DelayLines.SetNum(Settings.NumInputChannels);
+			for (int32 i = 0; i < Settings.NumInputChannels; i++)
+			{
+				Stage.InputHistory[i].AddZeroed(FFTSize);
+				Stage.ProcessInput[i].AddZeroed(FFTSize);
+				Stage.DelayLines[i].SetNum(Stage.NumPartitions);
+				for (FAlignedFloatBuffer& Block : Stage.DelayLines[i])
+				{
+					Block.AddZeroed(Stage.NumFFTOutputFloats);
+				}
+			}
+
+			Stage.ImpulseResponsePartitions.SetNum(Settings.NumImpulseResponses);
+			Stage.NumActivePartitions.Init(0, Settings.NumImpulseResponses);
+			for (int32 i = 0; i < Settings.NumImpulseResponses; i++)
+			{
+				Stage.ImpulseResponsePartitions[i].SetNum(Stage.NumPartitions);
+				for (FAlignedFloatBuffer& Block : Stage.ImpulseResponsePartitions[i])
+				{
+					Block.AddZeroed(GetNumExpandedFloats(Stage.NumFFTOutputFloats));
+				}
+			}
+
+			Stage.Accumulators.SetNum(Settings.NumOutputChannels);
+			for (FAlignedFloatBuffer& Accumulator : Stage.Accumulators)
+			{
+				Accumulator.AddZeroed(Stage.NumFFTOutputFloats);
+			}
+			Stage.Product.AddZeroed(Stage.NumFFTOutputFloats);
+			Stage.InverseOutput.AddZeroed(FFTSize);
+
+			for (int32 Buffer = 0; Buffer < 2; Buffer++)
+			{
+				Stage.OutputBlocks[Buffer].SetNum(Settings.NumOutputChannels);
+				for (FAlignedFloatBuffer& Block : Stage.OutputBlocks[Buffer])
+				{
+					Block.AddZeroed(Stage.PartitionSize);
+				}
+				Stage.HasOutput[Buffer].Init(false, Settings.NumOutputChannels);
+			}
+		}
+	}
+
+	bool FNonUniformPartitionConvolution::IsValid() const
+	{
+		return bIsValid;
+	}
+
+	int32 FNonUniformPartitionConvolution::GetNumSamplesInBlock() const
+	{
+		return BlockSize;
+	}
+
+	int32 FNonUniformPartitionConvolution::GetNumAudioInputs() const
+	{
+		return Settings.NumInputChannels;
+	}
+
+	int32 FNonUniformPartitionConvolution::GetNumAudioOutputs() const
+	{
+		return Settings.NumOutputChannels;
+	}
+
+	int32 FNonUniformPartitionConvolution::GetNumStages() const
+	{
+		return Stages.Num();
+	}
+
+	int32 FNonUniformPartitionConvolution::GetStagePartitionSize(int32 InStageIndex) const
+	{
+		return Stages[InStageIndex].PartitionSize;
+	}
+
+	int32 FNonUniformPartitionConvolution::GetStageNumPartitions(int32 InStageIndex) const
+	{
+		return Stages[InStageIndex].NumPartitions;
+	}
+
+	void FNonUniformPartitionConvolution::ProcessAudioBlock(const float* const InSamples[], float* const OutSamples[])
+	{
+		check(bIsValid);
+
+		for (int32 i = 0; i < Settings.NumOutputChannels; i++)
+		{
+			FMemory::Memset(OutSamples[i], 0, sizeof(float) * BlockSize);
+		}
+
+		for (FStage& Stage : Stages)
+		{
+			// Append the block to the second half of the input window.
+			for (int32 i = 0; i < Settings.NumInputChannels; i++)
+			{
+				FMemory::Memcpy(&Stage.InputHistory[i].GetData()[Stage.PartitionSize + Stage.NumBufferedSamples], InSamples[i], sizeof(float) * BlockSize);
+			}
+			Stage.NumBufferedSamples += BlockSize;
+
+			if (Stage.NumBufferedSamples == Stage.PartitionSize)
+			{
+				BeginStagePartition(Stage);
+			}
+
+			// Mix in the part of the stage output for this block.
+			const int32 ReadIndex = Stage.ReadIndex;
+			for (int32 i = 0; i < Settings.NumOutputChannels; i++)
+			{
+				if (Stage.HasOutput[ReadIndex][i])
+				{
+					MixInBufferFast(&Stage.OutputBlocks[ReadIndex][i].GetData()[Stage.ReadPos], OutSamples[i], BlockSize);
+				}
+			}
+			Stage.ReadPos += BlockSize;
+		}
+	}
+
+	void FNonUniformPartitionConvolution::BeginStagePartition(FStage& InStage)
+	{
+		// The previous partition of a late stage must be done before its output is read, and
+		// before its buffers are reused.
+		InStage.Task.Wait();
+
+		const int32 PartitionSize = InStage.PartitionSize;
+		for (int32 i = 0; i < Settings.NumInputChannels; i++)
+		{
+			float* History = InStage.InputHistory[i].GetData();
+			FMemory::Memcpy(InStage.ProcessInput[i].GetData(), History, sizeof(float) * 2 * PartitionSize);
+
+			// Hop of PartitionSize samples for the next window.
+			FMemory::Memcpy(History, &History[PartitionSize], sizeof(float) * PartitionSize);
+		}
+		InStage.NumBufferedSamples = 0;
+		InStage.ReadPos = 0;
+
+		if (InStage.bIsLate)
+		{
+			// Read what was computed one partition ago, and compute the next one in the other buffer.
+			Swap(InStage.ReadIndex, InStage.WriteIndex);
+
+			if (Settings.bProcessLatePartitionsAsync)
+			{
+				InStage.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &InStage]()
+				{
+					ProcessStage(InStage);
+				});
+				return;
+			}
+		}
+
+		ProcessStage(InStage);
+	}
+
+	void FNonUniformPartitionConvolution::ProcessStage(FStage& InStage) const
+	{
+		using namespace NonUniformPartitionConvolutionPrivate;
+
+		const int32 NumFloats = InStage.NumFFTOutputFloats;
+		const int32 Head = InStage.DelayLineHead;
+
+		for (int32 i = 0; i < Settings.NumInputChannels; i++)
+		{
+			InStage.FFTAlgorithm->ForwardRealToComplex(InStage.ProcessInput[i].GetData(), InStage.DelayLines[i][Head].GetData());
+		}
+
+		TArray<bool>& HasOutput = InStage.HasOutput[InStage.WriteIndex];
+		for (int32 i = 0; i < Settings.NumOutputChannels; i++)
+		{
+			HasOutput[i] = false;
+		}
+
+		for (const FGain& Gain : Gains)
+		{
+			const int32 NumActivePartitions = InStage.NumActivePartitions[Gain.ImpulseResponseIndex];
+			if (NumActivePartitions == 0)
+			{
+				continue;
+			}
+
+			const TArray<FAlignedFloatBuffer>& DelayLine = InStage.DelayLines[Gain.InputIndex];
+			const TArray<FAlignedFloatBuffer>& Partitions = InStage.ImpulseResponsePartitions[Gain.ImpulseResponseIndex];
+			FAlignedFloatBuffer& Accumulator = InStage.Accumulators[Gain.OutputIndex];
+
+			if (!HasOutput[Gain.OutputIndex])
+			{
+				ZeroBuffer(Accumulator);
+				HasOutput[Gain.OutputIndex] = true;
+			}
+
+			// Partition k multiplies the input transformed k partitions ago.
+			float* Product = InStage.Product.GetData();
+			ZeroBuffer(InStage.Product);
+			for (int32 k = 0; k < NumActivePartitions; k++)
+			{
+				const int32 DelayIndex = (Head - k + InStage.NumPartitions) % InStage.NumPartitions;
+				ComplexMultiplyAdd(DelayLine[DelayIndex].GetData(), Partitions[k].GetData(), Product, NumFloats);
+			}
+
+			ArrayMixIn(MakeArrayView<const float>(Product, NumFloats), MakeArrayView<float>(Accumulator.GetData(), NumFloats), Gain.Gain);
+		}
+
+		for (int32 i = 0; i < Settings.NumOutputChannels; i++)
+		{
+			if (HasOutput[i])
+			{
+				InStage.FFTAlgorithm->InverseComplexToReal(InStage.Accumulators[i].GetData(), InStage.InverseOutput.GetData());
+
+				// Overlap save method of convolution. Only use 2nd half of output buffer
+				FMemory::Memcpy(InStage.OutputBlocks[InStage.WriteIndex][i].GetData(), &InStage.InverseOutput.GetData()[InStage.PartitionSize], sizeof(float) * InStage.PartitionSize);
+			}
+		}
+
+		InStage.DelayLineHead = (Head + 1) % InStage.NumPartitions;
+	}
+
+	void FNonUniformPartitionConvolution::WaitForStages()
+	{
+		for (FStage& Stage : Stages)
+		{
+			Stage.Task.Wait();
+			Stage.Task = UE::Tasks::FTask();
+		}
+	}
+
+	void FNonUniformPartitionConvolution::ResetAudioHistory()
+	{
+		using namespace NonUniformPartitionConvolutionPrivate;
+
+		WaitForStages();
+
+		for (FStage& Stage : Stages)
+		{
+			for (int32 i = 0; i < Settings.NumInputChannels; i++)
+			{
+				ZeroBuffer(Stage.InputHistory[i]);
+				for (FAlignedFloatBuffer& Block : Stage.DelayLines[i])
+				{
+					ZeroBuffer(Block);
+				}
+			}
+
+			for (int32 Buffer = 0; Buffer < 2; Buffer++)
+			{
+				for (int32 i = 0; i < Settings.NumOutputChannels; i++)
+				{
+					Stage.HasOutput[Buffer][i] = false;
+				}
+			}
+
+			Stage.NumBufferedSamples = 0;
+			Stage.ReadPos = 0;
+			Stage.DelayLineHead = 0;
+		}
+	}
+
+	int32 FNonUniformPartitionConvolution::GetMaxNumImpulseResponseSamples() const
+	{
+		return Settings.MaxNumImpulseResponseSamples;
+	}
+
+	int32 FNonUniformPartitionConvolution::GetNumImpulseResponses() const
+	{
+		return Settings.NumImpulseResponses;
+	}
+
+	int32 FNonUniformPartitionConvolution::GetNumImpulseResponseSamples(int32 InImpulseResponseIndex) const
+	{
+		return NumImpulseResponseSamples[InImpulseResponseIndex];
+	}
+
+	void FNonUniformPartitionConvolution::SetImpulseResponse(int32 InImpulseResponseIndex, const float* InSamples, int32 InNumSamples)
+	{
+		check(InNumSamples >= 0);
+
+		if (InNumSamples > Settings.MaxNumImpulseResponseSamples)
+		{
+			UE_LOG(LogSignalProcessing, Warning, TEXT("Truncating impulse response of %d samples to maximum length of %d samples"), InNumSamples, Settings.MaxNumImpulseResponseSamples);
+			InNumSamples = Settings.MaxNumImpulseResponseSamples;
+		}
+
+		WaitForStages();
+
+		NumImpulseResponseSamples[InImpulseResponseIndex] = InNumSamples;
+		for (FStage& Stage : Stages)
+		{
+			SetStageImpulseResponse(Stage, InImpulseResponseIndex, InSamples, InNumSamples);
+		}
+	}
+
+	void FNonUniformPartitionConvolution::SetStageImpulseResponse(FStage& InStage, int32 InImpulseResponseIndex, const float* InSamples, int32 InNumSamples)
+	{
+		using namespace NonUniformPartitionConvolutionPrivate;
+
+		const int32 PartitionSize = InStage.PartitionSize;
+		const int32 NumActivePartitions = FMath::Clamp(FMath::DivideAndRoundUp(InNumSamples - InStage.Offset, PartitionSize), 0, InStage.NumPartitions);
+		InStage.NumActivePartitions[InImpulseResponseIndex] = NumActivePartitions;
+
+		// Reuse stage buffers not needed outside of processing to transform the partitions.
+		FAlignedFloatBuffer& FFTInput = InStage.InverseOutput;
+		FAlignedFloatBuffer& FFTOutput = InStage.Product;
+
+		TArray<FAlignedFloatBuffer>& Partitions = InStage.ImpulseResponsePartitions[InImpulseResponseIndex];
+		for (int32 k = 0; k < InStage.NumPartitions; k++)
+		{
+			if (k >= NumActivePartitions)
+			{
+				ZeroBuffer(Partitions[k]);
+				continue;
+			}
+
+			// Partitions are zero padded to the FFT size.
+			const int32 ReadPos = InStage.Offset + k * PartitionSize;
+			const int32 NumSamplesToCopy = FMath::Min(PartitionSize, InNumSamples - ReadPos);
+			ZeroBuffer(FFTInput);
+			FMemory::Memcpy(FFTInput.GetData(), &InSamples[ReadPos], sizeof(float) * NumSamplesToCopy);
+
+			InStage.FFTAlgorithm->ForwardRealToComplex(FFTInput.GetData(), FFTOutput.GetData());
+			ExpandComplex(FFTOutput.GetData(), InStage.NumFFTOutputFloats, Partitions[k].GetData());
+		}
+	}
+
+	void FNonUniformPartitionConvolution::SetMatrixGain(int32 InAudioInputIndex, int32 InImpulseResponseIndex, int32 InAudioOutputIndex, float InGain)
+	{
+		WaitForStages();
+
+		const int32 Index = Gains.IndexOfByPredicate([&](const FGain& Gain)
+		{
+			return Gain.InputIndex == InAudioInputIndex && Gain.ImpulseResponseIndex == InImpulseResponseIndex && Gain.OutputIndex == InAudioOutputIndex;
+		});
+
+		if (InGain == 0.f)
+		{
+			// Remove gain entry if it's zero
+			if (Index != INDEX_NONE)
+			{
+				Gains.RemoveAt(Index);
+			}
+		}
+		else if (Index != INDEX_NONE)
+		{
+			Gains[Index].Gain = InGain;
+		}
+		else
+		{
+			Gains.Add({ InAudioInputIndex, InImpulseResponseIndex, InAudioOutputIndex, InGain });
+		}
+	}
+
+	float FNonUniformPartitionConvolution::GetMatrixGain(int32 InAudioInputIndex, int32 InImpulseResponseIndex, int32 InAudioOutputIndex) const
+	{
+		const FGain* Gain = Gains.FindByPredicate([&](const FGain& Entry)
+		{
+			return Entry.InputIndex == InAudioInputIndex && Entry.ImpulseResponseIndex == InImpulseResponseIndex && Entry.OutputIndex == InAudioOutputIndex;
+		});
+
+		return Gain ? Gain->Gain : 0.f;
+	}
+
+
+	FNonUniformPartitionConvolutionFactory::~FNonUniformPartitionConvolutionFactory()
+	{
+	}
+
+	/** Name of this particular factory. */
+	const FName FNonUniformPartitionConvolutionFactory::GetFactoryName() const
+	{
+		static const FName FactoryName(TEXT("NonUniformPartitionConvolutionFactory"));
+		return FactoryName;
+	}
+
+	/** If true, this implementation uses hardware acceleration. */
+	bool FNonUniformPartitionConvolutionFactory::IsHardwareAccelerated() const
+	{
+		return false;
+	}
+
+	/** Returns true if the input settings are supported by this factory. */
+	bool FNonUniformPartitionConvolutionFactory::AreConvolutionSettingsSupported(const FConvolutionSettings& InSettings) const
+	{
+		bool bIsValidNumInputs = InSettings.NumInputChannels > 0;
+		bool bIsValidNumOutputs = InSettings.NumOutputChannels > 0;
+		bool bIsValidNumImpulseResponses = InSettings.NumImpulseResponses > 0;
+		// Block Size must be greater than zero and a power of 2.
+		bool bIsValidBlockSize = (InSettings.BlockNumSamples > 0) && (FMath::CountBits(InSettings.BlockNumSamples) == 1);
+
+		// Impulse responses that fit in the first stage are better served by a uniform partition convolution.
+		bool bIsLongImpulseResponse = bIsValidBlockSize && (InSettings.MaxNumImpulseResponseSamples > 7 * InSettings.BlockNumSamples);
+
+		bool bIsSupported = bIsValidNumInputs;
+		bIsSupported &= bIsValidNumOutputs;
+		bIsSupported &= bIsValidNumImpulseResponses;
+		bIsSupported &= bIsValidBlockSize;
+		bIsSupported &= bIsLongImpulseResponse;
+
+		if (bIsSupported)
+		{
+			// Check if FFFTFactory supports the FFT sizes of the smallest and largest partitions.
+			const FNonUniformPartitionConvolutionSettings Settings = SettingsFromConvolutionSettings(InSettings);
+			const int32 Log2BlockSize = FMath::CountTrailingZeros(InSettings.BlockNumSamples);
+			const int32 Log2MaxPartitionSize = FMath::Max(Log2BlockSize, (int32)FMath::CeilLogTwo(Settings.MaxPartitionSize));
+
+			for (int32 Log2PartitionSize : { Log2BlockSize, Log2MaxPartitionSize })
+			{
+				FFFTSettings FFTSettings;
+				FFTSettings.Log2Size = Log2PartitionSize + 1;
+				FFTSettings.bArrays128BitAligned = true;
+				FFTSettings.bEnableHardwareAcceleration = InSettings.bEnableHardwareAcceleration;
+				bIsSupported &= FFFTFactory::AreFFTSettingsSupported(FFTSettings);
+			}
+		}
+
+		return bIsSupported;
+	}
+
+	/** Preferred over uniform partition convolutions for the long impulse responses it supports. */
+	int32 FNonUniformPartitionConvolutionFactory::GetSettingsPreference(const FConvolutionSettings& InSettings) const
+	{
+		return 1;
+	}
+
+	/** Creates a new Convolution algorithm. */
+	TUniquePtr<IConvolutionAlgorithm> FNonUniformPartitionConvolutionFactory::NewConvolutionAlgorithm(const FConvolutionSettings& InSettings)
+	{
+		check(AreConvolutionSettingsSupported(InSettings));
+
+		TUniquePtr<FNonUniformPartitionConvolution> Convolution = MakeUnique<FNonUniformPartitionConvolution>(SettingsFromConvolutionSettings(InSettings));
+		if (!Convolution->IsValid())
+		{
+			UE_LOG(LogSignalProcessing, Error, TEXT("Failed to create non-uniform partition convolution algorithm due to failed FFT creation"));
+			return TUniquePtr<IConvolutionAlgorithm>();
+		}
+
+		return Convolution;
+	}
+
+	FNonUniformPartitionConvolutionSettings FNonUniformPartitionConvolutionFactory::SettingsFromConvolutionSettings(const FConvolutionSettings& InSettings)
+	{
+		FNonUniformPartitionConvolutionSettings Settings;
+		Settings.NumInputChannels = InSettings.NumInputChannels;
+		Settings.NumOutputChannels = InSettings.NumOutputChannels;
+		Settings.NumImpulseResponses = InSettings.NumImpulseResponses;
+		Settings.MaxNumImpulseResponseSamples = InSettings.MaxNumImpulseResponseSamples;
+		Settings.BlockNumSamples = InSettings.BlockNumSamples;
+		Settings.MaxPartitionSize = FMath::Max(Settings.MaxPartitionSize, InSettings.BlockNumSamples);
+		Settings.bProcessLatePartitionsAsync = AudioConvolutionAsyncLatePartitionsCVar != 0;
+		Settings.bEnableHardwareAcceleration = InSettings.bEnableHardwareAcceleration;
+		return Settings;
+	}
+}
@@ -0,0 +1,237 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DSP/BufferVectorOperations.h"
+#include "DSP/ConvolutionAlgorithm.h"
+#include "DSP/FFTAlgorithm.h"
+#include "Tasks/Task.h"
+
+namespace Audio
+{
+	/** Settings for creating a non-uniform partition convolution. */
+	struct FNonUniformPartitionConvolutionSettings
+	{
+		/** Number of input channels for convolution. */
+		int32 NumInputChannels = 0;
+
+		/** Number of output channels for convolution. */
+		int32 NumOutputChannels = 0;
+
+		/** Number of impulse responses for convolution. */
+		int32 NumImpulseResponses = 0;
+
+		/** Maximum number of samples in an impulse response. */
+		int32 MaxNumImpulseResponseSamples = 0;
+
+		/** Number of samples in an audio block, which is also the size of the first partitions. Must be a power of 2. */
+		int32 BlockNumSamples = 256;
+
+		/** Largest partition size. Partitions grow by a factor of 4 per stage up to this size. Must be a power of 2. */
+		int32 MaxPartitionSize = 8192;
+
+		/** If true, partitions larger than an audio block are processed on worker threads. */
+		bool bProcessLatePartitionsAsync = true;
+
+		/** If true, hardware accelerated FFT algorithms are valid. */
+		bool bEnableHardwareAcceleration = true;
+	};
+
+	/** FNonUniformPartitionConvolution
+	 *
+	 * FNonUniformPartitionConvolution implements a fft based convolution algorithm for long impulse
+	 * responses supporting multiple inputs, impulse responses and outputs.
+	 *
+	 * The impulse response is divided into stages of partitions. The first stage uses partitions of one
+	 * audio block, and each subsequent stage uses partitions 4 times larger than the previous one. Each
+	 * stage keeps a frequency-domain delay line of transformed input blocks, so only one forward FFT per
+	 * input and one inverse FFT per output are performed per stage partition, regardless of the number
+	 * of partitions.
+	 *
+	 * A stage with partitions of P samples starts at impulse response sample 2P - BlockSize. This gives
+	 * it P samples of time to compute its output, which lets later stages run on worker threads while
+	 * subsequent audio blocks are processed. Latency is the same as FUniformPartitionConvolution: one
+	 * audio block.
+	 */
+	class FNonUniformPartitionConvolution : public IConvolutionAlgorithm
+	{
+		public:
+			/** Create a Non-Uniform Partition Convolution Algorithm
+			 *
+			 * @params InSettings - Settings for algorithm.
+			 */
+			FNonUniformPartitionConvolution(const FNonUniformPartitionConvolutionSettings& InSettings);
+
+			/** Destructor. Waits for late partitions being processed. */
+			virtual ~FNonUniformPartitionConvolution();
+
+			/** Returns true if the FFT algorithms of every stage could be created. */
+			bool IsValid() const;
+
+			/** Returns the number of samples in an audio block. */
+			virtual int32 GetNumSamplesInBlock() const override;
+
+			/** Returns number of audio inputs. */
+			virtual int32 GetNumAudioInputs() const override;
+
+			/** Returns number of audio outputs. */
+			virtual int32 GetNumAudioOutputs() const override;
+
+			/** Process one block of audio.
+			 *
+			 * InSamples is processed by the impulse responses. The output is placed in OutSamples.
+			 *
+			 * @params InSamples - A 2D array of input deinterleaved audio samples. InSamples[GetNumAudioInputs()][GetNumSamplesInBlock()]
+			 * @params OutSamples - A 2D array of output deinterleaved audio samples. OutSamples[GetNumAudioOutputs()][GetNumSamplesInBlock()]
+			 *
+			 */
+			virtual void ProcessAudioBlock(const float* const InSamples[], float* const OutSamples[]) override;
+
+			/** Reset internal history buffer for all audio inputs. */
+			virtual void ResetAudioHistory() override;
+
+			/** Maximum supported length of impulse response. */
+			virtual int32 GetMaxNumImpulseResponseSamples() const override;
+
+			/** Return the number of impulse responses. */
+			virtual int32 GetNumImpulseResponses() const override;
+
+			/** Return the number of samples in an impulse response. */
+			virtual int32 GetNumImpulseResponseSamples(int32 InImpulseResponseIndex) const override;
+
+			/** Set impulse response values. */
+			virtual void SetImpulseResponse(int32 InImpulseResponseIndex, const float* InSamples, int32 InNumSamples) override;
+
+			/** Sets the gain between an audio input channel, impulse response and audio output channel.
+			 *
+			 * ([audio inputs] * [impulse responses]) x [gain matrix] = [audio outputs]
+			 */
+			virtual void SetMatrixGain(int32 InAudioInputIndex, int32 InImpulseResponseIndex, int32 InAudioOutputIndex, float InGain) override;
+
+			/** Gets the gain between an audio input channel, impulse response and audio output channel.
+			 *
+			 * ([audio inputs] * [impulse responses]) x [gain matrix] = [audio outputs]
+			 */
+			virtual float GetMatrixGain(int32 InAudioInputIndex, int32 InImpulseResponseIndex, int32 InAudioOutputIndex) const override;
+
+			/** Returns the number of partition stages. */
+			int32 GetNumStages() const;
+
+			/** Returns the number of samples in each partition of a stage. */
+			int32 GetStagePartitionSize(int32 InStageIndex) const;
+
+			/** Returns the number of partitions of a stage. */
+			int32 GetStageNumPartitions(int32 InStageIndex) const;
+
+		private:
+
+			// Non-zero entry of the 3D mixing matrix.
+			struct FGain
+			{
+				int32 InputIndex = 0;
+				int32 ImpulseResponseIndex = 0;
+				int32 OutputIndex = 0;
+				float Gain = 0.f;
+			};
+
+			// Partitions of the same size covering one segment of the impulse responses.
+			struct FStage
+			{
+				// Number of samples in a partition.
+				int32 PartitionSize = 0;
+
+				// Number of partitions in the stage.
+				int32 NumPartitions = 0;
+
+				// First impulse response sample covered by the stage.
+				int32 Offset = 0;
+
+				// True if the output of the stage is computed one partition ahead of being used.
+				bool bIsLate = false;
+
+				TUniquePtr<IFFTAlgorithm> FFTAlgorithm;
+				int32 NumFFTOutputFloats = 0;
+
+				// Number of input samples received since the stage last processed a partition.
+				int32 NumBufferedSamples = 0;
+
+				// Sliding window of 2 * PartitionSize input samples for each input.
+				TArray<FAlignedFloatBuffer> InputHistory;
+
+				// Copy of the input window used while the stage is processed.
+				TArray<FAlignedFloatBuffer> ProcessInput;
+
+				// Frequency-domain delay line of each input, NumPartitions transformed input windows.
+				TArray<TArray<FAlignedFloatBuffer>> DelayLines;
+				int32 DelayLineHead = 0;
+
+				// Transformed partitions of each impulse response. See ExpandComplex() for the layout.
+				TArray<TArray<FAlignedFloatBuffer>> ImpulseResponsePartitions;
+				TArray<int32> NumActivePartitions;
+
+				// Frequency-domain output of each output channel.
+				TArray<FAlignedFloatBuffer> Accumulators;
+				FAlignedFloatBuffer Product;
+				FAlignedFloatBuffer InverseOutput;
+
+				// Time-domain output of each output channel. Late stages write to one buffer while reading the other.
+				TArray<FAlignedFloatBuffer> OutputBlocks[2];
+				TArray<bool> HasOutput[2];
+				int32 ReadIndex = 0;
+				int32 WriteIndex = 0;
+				int32 ReadPos = 0;
+
+				UE::Tasks::FTask Task;
+			};
+
+			// Build the stage layout for the settings.
+			void InitStages();
+
+			// Set the impulse response samples covered by the stage.
+			void SetStageImpulseResponse(FStage& InStage, int32 InImpulseResponseIndex, const float* InSamples, int32 InNumSamples);
+
+			// Called when a stage has received a full partition of input.
+			void BeginStagePartition(FStage& InStage);
+
+			// Transform the stage input and compute its output. May run on a worker thread.
+			void ProcessStage(FStage& InStage) const;
+
+			// Wait for all late stages to finish processing.
+			void WaitForStages();
+
+			FNonUniformPartitionConvolutionSettings Settings;
+
+			int32 BlockSize;
+			bool bIsValid;
+
+			TArray<FStage> Stages;
+			TArray<FGain> Gains;
+			TArray<int32> NumImpulseResponseSamples;
+	};
+
+	/** FNonUniformPartitionConvolutionFactory creates FNonUniformPartitionConvolution algorithms for long impulse responses. */
+	class FNonUniformPartitionConvolutionFactory : public IConvolutionAlgorithmFactory
+	{
+		public:
+			virtual ~FNonUniformPartitionConvolutionFactory();
+
+			/** Name of this particular factory. */
+			virtual const FName GetFactoryName() const override;
+
+			/** If true, this implementation uses hardware acceleration. */
+			virtual bool IsHardwareAccelerated() const override;
+
+			/** Returns true if the input settings are supported by this factory. */
+			virtual bool AreConvolutionSettingsSupported(const FConvolutionSettings& InSettings) const override;
+
+			/** Preferred over uniform partition convolutions for the long impulse responses it supports. */
+			virtual int32 GetSettingsPreference(const FConvolutionSettings& InSettings) const override;
+
+			/** Creates a new Convolution algorithm. */
+			virtual TUniquePtr<IConvolutionAlgorithm> NewConvolutionAlgorithm(const FConvolutionSettings& InSettings) override;
+
+			/** Convert the convolution settings into non-uniform partition convolution settings. */
+			static FNonUniformPartitionConvolutionSettings SettingsFromConvolutionSettings(const FConvolutionSettings& InSettings);
+	};
+}
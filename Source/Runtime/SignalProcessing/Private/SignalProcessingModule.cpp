@@ -7,6 +7,7 @@
 #include "DSP/ConvolutionAlgorithm.h"
 #include "DSP/AudioFFT.h"
 #include "VectorFFT.h"
+#include "NonUniformPartitionConvolution.h"
 #include "UniformPartitionConvolution.h"
 
 namespace Audio
@@ -15,6 +16,7 @@ namespace Audio
 	{
 		FVectorFFTFactory VectorFFTAlgorithmFactory;
 
+		FNonUniformPartitionConvolutionFactory NonUniformPartitionConvolutionFactory;
 		FUniformPartitionConvolutionFactory UniformPartitionConvolutionFactory;
 
 	public:
@@ -25,6 +27,7 @@ namespace Audio
 			IModularFeatures::Get().RegisterModularFeature(IFFTAlgorithmFactory::GetModularFeatureName(), &VectorFFTAlgorithmFactory);
 
 			// Convolution factories to register
+			IModularFeatures::Get().RegisterModularFeature(IConvolutionAlgorithmFactory::GetModularFeatureName(), &NonUniformPartitionConvolutionFactory);
 			IModularFeatures::Get().RegisterModularFeature(IConvolutionAlgorithmFactory::GetModularFeatureName(), &UniformPartitionConvolutionFactory);
 		}
 
@@ -34,6 +37,7 @@ namespace Audio
 			IModularFeatures::Get().UnregisterModularFeature(IFFTAlgorithmFactory::GetModularFeatureName(), &VectorFFTAlgorithmFactory);
 
 			// Convolution factories to unregister
+			IModularFeatures::Get().UnregisterModularFeature(IConvolutionAlgorithmFactory::GetModularFeatureName(), &NonUniformPartitionConvolutionFactory);
 			IModularFeatures::Get().UnregisterModularFeature(IConvolutionAlgorithmFactory::GetModularFeatureName(), &UniformPartitionConvolutionFactory);
 		}
 	};
@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DSP/AlignedBuffer.h"
+#include "DSP/BiQuadFilter.h"
+
+namespace Audio
+{
+	// Coefficients of a biquad using the same difference equation as FBiquad:
+	// y(n) = a0*x(n) + a1*x(n-1) + a2*x(n-2) - b1*y(n-1) - b2*y(n-2)
+	struct FBiquadCoefficients
+	{
+		float A0 = 1.0f;
+		float A1 = 0.0f;
+		float A2 = 0.0f;
+		float B1 = 0.0f;
+		float B2 = 0.0f;
+
+		FBiquadCoefficients() = default;
+
+		FBiquadCoefficients(const FBiquad& InBiquad)
+			: A0(InBiquad.A0)
+			, A1(InBiquad.A1)
+			, A2(InBiquad.A2)
+			, B1(InBiquad.B1)
+			, B2(InBiquad.B2)
+		{
+		}
+	};
+
+	// Delay terms of a biquad. Owned by the user of a filter so its state persists between batches.
+	struct FBiquadFilterState
+	{
+		float X_Z1 = 0.0f;
+		float X_Z2 = 0.0f;
+		float Y_Z1 = 0.0f;
+		float Y_Z2 = 0.0f;
+	};
+
+	// One filter of a batch: a channel of an interleaved buffer, its filter state and coefficients.
+	struct FBiquadBatchChannel
+	{
+		// First sample of the channel to filter, and where to write the result. May be the same buffer.
+		const float* Input = nullptr;
+		float* Output = nullptr;
+
+		// Distance between two consecutive samples of the channel, the number of channels of an interleaved buffer.
+		int32 Stride = 1;
+
+		FBiquadFilterState* State = nullptr;
+
+		// Coefficients before the first frame and on the last frame. Coefficients are linearly interpolated
+		// in between, like the frequency interpolation of FInterpolatedLPF and FInterpolatedHPF.
+		FBiquadCoefficients StartCoefficients;
+		FBiquadCoefficients EndCoefficients;
+	};
+
+	/** FBiquadFilterBatch
+	 *
+	 * Processes many independent biquads, such as the filters of every voice of a mixer, in lockstep.
+	 * Channels are processed in groups of 4, 8 or 16 lanes with one filter per SIMD lane, so the
+	 * recursion of each filter is interleaved with the others instead of being evaluated one sample
+	 * at a time. Input samples are gathered into a structure of arrays scratch buffer before filtering
+	 * and scattered back to each channel output afterwards.
+	 */
+	class FBiquadFilterBatch
+	{
+	public:
+		// Creates a batch processing channels in groups of InNumLanes, rounded to 4, 8 or 16.
+		SIGNALPROCESSING_API FBiquadFilterBatch(int32 InNumLanes = 8);
+
+		// Returns the number of filters evaluated in lockstep.
+		int32 GetNumLanes() const
+		{
+			return NumLanes;
+		}
+
+		// Removes every channel from the batch, keeping allocations.
+		SIGNALPROCESSING_API void Reset();
+
+		// Adds a channel to filter on the next call to ProcessAudio().
+		SIGNALPROCESSING_API void AddChannel(const FBiquadBatchChannel& InChannel);
+
+		// Returns the number of channels added since the last Reset().
+		int32 Num() const
+		{
+			return Channels.Num();
+		}
+
+		// Filters InNumFrames frames of every channel and updates their filter state.
+		SIGNALPROCESSING_API void ProcessAudio(int32 InNumFrames);
+
+	private:
+		template<int32 InNumLanes, bool bInterpolate>
+		void ProcessLanes(const FBiquadBatchChannel* InChannels, int32 InNumChannels, int32 InNumFrames);
+
+		int32 NumLanes;
+		TArray<FBiquadBatchChannel> Channels;
+		FAlignedFloatBuffer Scratch;
+	};
+}
@@ -128,6 +128,10 @@ namespace Audio
 			/** Returns true if the input settings are supported by this factory. */
 			virtual bool AreConvolutionSettingsSupported(const FConvolutionSettings& InSettings) const = 0;
 
+			/** Returns how well suited this factory is to the input settings. Among factories with the same
+			 *  hardware acceleration, those with a higher preference are chosen first. */
+			virtual int32 GetSettingsPreference(const FConvolutionSettings& InSettings) const { return 0; }
+
 			/** Creates a new Convolution algorithm. */
 			virtual TUniquePtr<IConvolutionAlgorithm> NewConvolutionAlgorithm(const FConvolutionSettings& InSettings) = 0;
 	};
@@ -2,6 +2,7 @@
 
 #pragma once
 #include "CoreMinimal.h"
+#include "DSP/BiQuadFilterBatch.h"
 #include "DSP/Dsp.h"
 
 
@@ -40,6 +41,10 @@ namespace Audio
 		// interpolates coefficient and processes a buffer
 		SIGNALPROCESSING_API void ProcessBufferInPlace(float* InOutBuffer, int32 NumSamples);
 
+		// Returns the filter as first order biquad coefficients, before and at the end of the current frequency interpolation.
+		// Used to process the filter in a FBiquadFilterBatch, the delay terms then being kept in a FBiquadFilterState per channel.
+		SIGNALPROCESSING_API void GetBiquadCoefficients(FBiquadCoefficients& OutStartCoefficients, FBiquadCoefficients& OutEndCoefficients) const;
+
 		/*
 			StopFrequencyInterpolation() needs to be called manually when the interpolation should be done.
 			Snaps the coefficient to the target value.
@@ -105,6 +110,10 @@ namespace Audio
 		// interpolates coefficient and processes a buffer
 		SIGNALPROCESSING_API void ProcessAudioBuffer(const float* RESTRICT InputBuffer, float* RESTRICT OutputBuffer, const int32 NumSamples);
 
+		// Returns the filter as first order biquad coefficients, before and at the end of the current frequency interpolation.
+		// Used to process the filter in a FBiquadFilterBatch, the delay terms then being kept in a FBiquadFilterState per channel.
+		SIGNALPROCESSING_API void GetBiquadCoefficients(FBiquadCoefficients& OutStartCoefficients, FBiquadCoefficients& OutEndCoefficients) const;
+
 		/*
 			StopFrequencyInterpolation() needs to be called manually when the interpolation should be done.
 			Snaps the coefficient to the target value.
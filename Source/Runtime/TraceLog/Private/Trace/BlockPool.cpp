@@ -7,6 +7,7 @@
 #include "Platform.h"
 #include "Trace/Detail/Atomic.h"
 #include "Trace/Detail/Writer.inl"
+#include "Trace/Trace.h"
 
 namespace UE {
 namespace Trace {
@@ -15,6 +16,7 @@ namespace Private {
 ////////////////////////////////////////////////////////////////////////////////
 void*		Writer_MemoryAllocate(SIZE_T, uint32);
 void		Writer_MemoryFree(void*, uint32);
+extern FStatistics GTraceStatistics;
 
 
 
@@ -39,12 +41,38 @@ struct FPoolBlockList
 static const uint32						GPoolBlockSize		= 4 << 10;
 static const uint32						GPoolPageSize		= GPoolBlockSize << 4;
 static const uint32						GPoolInitPageSize	= GPoolBlockSize << 6;
+static const uint32						GPoolMaxPageSize	= GPoolBlockSize << 10;
 T_ALIGN static FWriteBuffer* volatile	GPoolFreeList;		// = nullptr;
 T_ALIGN static UPTRINT volatile			GPoolFutex;			// = 0
 T_ALIGN static FPoolPage* volatile		GPoolPageList;		// = nullptr;
 static uint32							GPoolUsage;			// = 0;
+static uint32							GPoolLastPageSize;	// = 0;
+static uint64							GPoolLastGrowTime;	// = 0;
 #undef T_ALIGN
 
+////////////////////////////////////////////////////////////////////////////////
+static uint32 Writer_GetNextPageSize()
+{
+	// Only called by the thread holding GPoolFutex. If the free list ran dry
+	// again soon after the pool last grew then threads are writing events
+	// faster than the worker drains them. Growing by larger pages each time
+	// means fewer threads end up waiting here. Otherwise drop back to the
+	// default size so a single burst doesn't cause large allocations later.
+	uint64 Now = TimeGetTimestamp();
+	uint64 BurstWindow = TimeGetFrequency() / 10;
+
+	uint32 PageSize = GPoolPageSize;
+	if (GPoolLastPageSize != 0 && (Now - GPoolLastGrowTime) < BurstWindow)
+	{
+		PageSize = GPoolLastPageSize << 1;
+		PageSize = (PageSize > GPoolMaxPageSize) ? GPoolMaxPageSize : PageSize;
+	}
+
+	GPoolLastPageSize = PageSize;
+	GPoolLastGrowTime = Now;
+	return PageSize;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 static FPoolBlockList Writer_AllocateBlockList(uint32 PageSize)
 {
@@ -52,6 +80,11 @@ static FPoolBlockList Writer_AllocateBlockList(uint32 PageSize)
 	uint8* PageBase = (uint8*)Writer_MemoryAllocate(PageSize, PLATFORM_CACHE_LINE_SIZE);
 	GPoolUsage += PageSize;
 
+#if TRACE_PRIVATE_STATISTICS
+	GTraceStatistics.BlockPoolAllocated = GPoolUsage;
+	AtomicAddRelaxed(&GTraceStatistics.BlockPoolGrowths, 1u);
+#endif
+
 	uint32 BufferSize = GPoolBlockSize;
 	BufferSize -= sizeof(FWriteBuffer);
 	BufferSize -= sizeof(uint32); // to preceed event data with a small header when sending.
@@ -88,6 +121,7 @@ FWriteBuffer* Writer_AllocateBlockFromPool()
 {
 	// Fetch a new buffer
 	FWriteBuffer* Ret;
+	bool bWaited = false;
 	while (true)
 	{
 		// First we'll try one from the free list
@@ -116,11 +150,18 @@ FWriteBuffer* Writer_AllocateBlockFromPool()
 		{
 			// Someone else is mapping memory so we'll briefly yield and try the
 			// free list again.
+#if TRACE_PRIVATE_STATISTICS
+			if (!bWaited)
+			{
+				AtomicAddRelaxed(&GTraceStatistics.BlockPoolWaits, 1u);
+			}
+#endif
+			bWaited = true;
 			ThreadSleep(0);
 			continue;
 		}
 
-		FPoolBlockList BlockList = Writer_AllocateBlockList(GPoolPageSize);
+		FPoolBlockList BlockList = Writer_AllocateBlockList(Writer_GetNextPageSize());
 		Ret = BlockList.Head;
 
 		// And insert the block list into the freelist. 'Block' is now the last block
@@ -147,12 +188,31 @@ FWriteBuffer* Writer_AllocateBlockFromPool()
 		break;
 	}
 
+#if TRACE_PRIVATE_STATISTICS
+	// Writers running ahead of the worker show up as a high peak of used blocks.
+	uint64 Used = AtomicAddRelaxed(&GTraceStatistics.BlockPoolUsed, uint64(GPoolBlockSize));
+	Used += GPoolBlockSize;
+	if (Used > GTraceStatistics.BlockPoolPeakUsed)
+	{
+		GTraceStatistics.BlockPoolPeakUsed = Used;
+	}
+#endif
+
 	return Ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Writer_FreeBlockListToPool(FWriteBuffer* Head, FWriteBuffer* Tail)
 {
+#if TRACE_PRIVATE_STATISTICS
+	uint64 FreedSize = GPoolBlockSize;
+	for (FWriteBuffer* ListNode = Head; ListNode != Tail; ListNode = AtomicLoadRelaxed(&(ListNode->NextBuffer)))
+	{
+		FreedSize += GPoolBlockSize;
+	}
+	AtomicAddRelaxed(&GTraceStatistics.BlockPoolUsed, uint64(-int64(FreedSize)));
+#endif
+
 	for (FWriteBuffer* ListNode = Tail;; PlatformYield())
 	{
 		FWriteBuffer* FreeListValue = AtomicLoadRelaxed(&GPoolFreeList);
@@ -170,6 +230,7 @@ void Writer_InitializePool()
 {
 	static_assert(GPoolPageSize >= 0x10000, "Page growth must be >= 64KB");
 	static_assert(GPoolInitPageSize >= 0x10000, "Initial page size must be >= 64KB");
+	static_assert(GPoolMaxPageSize / GPoolBlockSize <= 0x10000, "Too many blocks per page");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -180,8 +241,7 @@ void Writer_ShutdownPool()
 	for (auto* Page = AtomicLoadRelaxed(&GPoolPageList); Page != nullptr;)
 	{
 		FPoolPage* NextPage = Page->NextPage;
-		uint32 PageSize = (NextPage == nullptr) ? GPoolBlockSize : GPoolPageSize;
-		Writer_MemoryFree(Page, PageSize);
+		Writer_MemoryFree(Page, Page->AllocSize);
 		Page = NextPage;
 	}
 }
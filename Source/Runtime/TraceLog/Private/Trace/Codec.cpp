@@ -1,6 +1,12 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "CoreTypes.h"
+#include "Trace/Config.h"
+
+#if UE_TRACE_ENABLED
+#	include "Platform.h"
+#	include "Trace/Trace.h"
+#endif
 
 THIRD_PARTY_INCLUDES_START
 #if defined(_MSC_VER)
@@ -26,16 +32,43 @@ namespace UE {
 namespace Trace {
 namespace Private {
 
+#if UE_TRACE_ENABLED && TRACE_PRIVATE_STATISTICS
+extern FStatistics GTraceStatistics;
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// LZ4 treats values below one as its default acceleration of one.
+static int32 GEncodeAcceleration; // = 0
+
+////////////////////////////////////////////////////////////////////////////////
+void SetEncodeAcceleration(int32 Acceleration)
+{
+	GEncodeAcceleration = Acceleration;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int32 Encode(const void* Src, int32 SrcSize, void* Dest, int32 DestSize)
 {
-	return TRACE_PRIVATE_LZ4_NAMESPACE LZ4_compress_fast(
+#if UE_TRACE_ENABLED && TRACE_PRIVATE_STATISTICS
+	uint64 StartTime = TimeGetTimestamp();
+#endif
+
+	int32 EncodedSize = TRACE_PRIVATE_LZ4_NAMESPACE LZ4_compress_fast(
 		(const char*)Src,
 		(char*)Dest,
 		SrcSize,
 		DestSize,
-		1 // increase by 1 for small speed increase
+		GEncodeAcceleration // increase for faster encoding at the cost of ratio
 	);
+
+#if UE_TRACE_ENABLED && TRACE_PRIVATE_STATISTICS
+	uint64 Elapsed = TimeGetTimestamp() - StartTime;
+	GTraceStatistics.BytesEncoded += SrcSize;
+	GTraceStatistics.BytesEncodedOutput += EncodedSize;
+	GTraceStatistics.EncodeTimeNs += (Elapsed * 1000000000ull) / TimeGetFrequency();
+#endif
+
+	return EncodedSize;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 
 #if UE_TRACE_ENABLED
 
+#include "Platform.h"
 #include "Trace/Detail/Protocol.h"
 #include "Trace/Detail/Transport.h"
 
@@ -25,6 +26,7 @@ void*		Writer_MemoryAllocate(SIZE_T, uint32);
 void		Writer_MemoryFree(void*, uint32);
 void		Writer_SendData(uint32, uint8* __restrict, uint32);
 void		Writer_SendDataRaw(const void*, uint32);
+bool		Writer_IsEncoding();
 
 ////////////////////////////////////////////////////////////////////////////////
 // ** See the bottom of this file for an explanation of FPacketRing
@@ -41,6 +43,8 @@ public:
 	void			Shutdown();
 	void			Reset();
 	uint32			GetSize() const;
+	uint32			GetCursor() const;
+	uint32			GetGeneration() const;
 	bool			IsActive() const;
 	FRange			GetBackPackets() const;
 	FRange			GetFrontPackets() const;
@@ -49,14 +53,17 @@ public:
 	template <typename PacketType>
 	PacketType*		Append(uint32 InSize);
 	void			BackUp(uint32 InSize);
+	void			DiscardBefore(uint32 Offset, uint32 InGeneration);
 
 private:
 	FTidPacketBase*	AppendImpl(uint32 InSize);
 	uint8*			Data;
 	uint32			Size;
 	uint32			Cursor;
+	uint32			Front;
 	uint32			Left;
 	uint32			Right;
+	uint32			Generation;
 };
 
 // TraceLog must be ready after value-init so that it can be used before
@@ -81,8 +88,9 @@ void FPacketRing::Shutdown()
 ////////////////////////////////////////////////////////////////////////////////
 void FPacketRing::Reset()
 {
-	Cursor = 0;
+	Cursor = Front = 0;
     Left = Right = Size;
+	++Generation;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -91,6 +99,18 @@ uint32 FPacketRing::GetSize() const
 	return Size;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+uint32 FPacketRing::GetCursor() const
+{
+	return Cursor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint32 FPacketRing::GetGeneration() const
+{
+	return Generation;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool FPacketRing::IsActive() const
 {
@@ -106,7 +126,7 @@ FPacketRing::FRange FPacketRing::GetBackPackets() const
 ////////////////////////////////////////////////////////////////////////////////
 FPacketRing::FRange FPacketRing::GetFrontPackets() const
 {
-	return { Data, Cursor };
+	return { Data + Front, Cursor - Front };
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -141,6 +161,29 @@ void FPacketRing::BackUp(uint32 InSize)
 	Cursor -= InSize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void FPacketRing::DiscardBefore(uint32 Offset, uint32 InGeneration)
+{
+	// Offset must be a packet boundary that Cursor was at during generation
+	// InGeneration. The generation changes each time the front range becomes
+	// the back one, which tells us which of the two ranges Offset is in.
+	if (InGeneration == Generation)
+	{
+		if (Offset >= Front && Offset <= Cursor)
+		{
+			Left = Right;
+			Front = Offset;
+		}
+	}
+	else if (InGeneration + 1 == Generation)
+	{
+		if (Offset > Left && Offset <= Right)
+		{
+			Left = Offset;
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 FTidPacketBase* FPacketRing::AppendImpl(uint32 InSize)
 {
@@ -160,10 +203,11 @@ FTidPacketBase* FPacketRing::AppendImpl(uint32 InSize)
 	// Run off the end of the buffer?
 	if (UNLIKELY(NextCursor > Size))
 	{
-		Left = 0;
+		Left = Front;
 		Right = Cursor;
-		Cursor = 0;
+		Cursor = Front = 0;
 		NextCursor = InSize;
+		++Generation;
 	}
 
 	// Discard old packets until there is space for the new one
@@ -196,7 +240,83 @@ FTidPacketBase* FPacketRing::AppendImpl(uint32 InSize)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-static FPacketRing GPacketRing; // = {};
+// When the tail is bounded in time the ring's cursor is sampled at regular
+// intervals. Packets appended before the newest sample that is older than the
+// time bound are discarded from the ring.
+struct FTailMarker
+{
+	uint64	Timestamp;
+	uint32	Offset;
+	uint32	Generation;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+static const uint32	GTailMarkerCount	= 64;
+static FPacketRing	GPacketRing;		// = {};
+static FTailMarker	GTailMarkers[GTailMarkerCount]; // = {};
+static uint32		GTailMarkerIndex;	// = 0;
+static uint32		GTailSeconds;		// = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+void Writer_SetTailSeconds(uint32 Seconds)
+{
+	GTailSeconds = Seconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_TailDiscardExpired(uint64 Now, uint32 Seconds)
+{
+	uint64 Window = uint64(Seconds) * TimeGetFrequency();
+	if (Now <= Window)
+	{
+		return;
+	}
+
+	// Find the newest marker at or before the cut-off.
+	uint64 CutOff = Now - Window;
+	for (uint32 i = 1; i <= GTailMarkerCount; ++i)
+	{
+		const FTailMarker& Marker = GTailMarkers[(GTailMarkerIndex - i) % GTailMarkerCount];
+		if (Marker.Timestamp == 0)
+		{
+			break;
+		}
+
+		if (Marker.Timestamp <= CutOff)
+		{
+			GPacketRing.DiscardBefore(Marker.Offset, Marker.Generation);
+			break;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_TailUpdateMarkers()
+{
+	uint32 Seconds = GTailSeconds;
+	if (Seconds == 0)
+	{
+		return;
+	}
+
+	// Markers are spaced such that they span about twice the time bound, which
+	// keeps the expired data held by the ring below 1/32 of the bound.
+	uint64 Now = TimeGetTimestamp();
+	uint64 Interval = (uint64(Seconds) * TimeGetFrequency()) / (GTailMarkerCount / 2);
+	const FTailMarker& Last = GTailMarkers[(GTailMarkerIndex - 1) % GTailMarkerCount];
+	if (Last.Timestamp != 0 && (Now - Last.Timestamp) < Interval)
+	{
+		return;
+	}
+
+	FTailMarker& Marker = GTailMarkers[GTailMarkerIndex % GTailMarkerCount];
+	Marker.Timestamp = Now;
+	Marker.Offset = GPacketRing.GetCursor();
+	Marker.Generation = GPacketRing.GetGeneration();
+	++GTailMarkerIndex;
+
+	Writer_TailDiscardExpired(Now, Seconds);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 void Writer_TailAppend(uint32 ThreadId, uint8* __restrict Data, uint32 Size)
@@ -219,13 +339,14 @@ void Writer_TailAppend(uint32 ThreadId, uint8* __restrict Data, uint32 Size)
 
 	// Smaller buffers usually aren't redundant enough to benefit from being
 	// compressed. They often end up being larger.
-	if (Size <= 384)
+	if (Size <= 384 || !Writer_IsEncoding())
 	{
 		auto* Packet = GPacketRing.Append<FTidPacket>(Size);
 		Packet->ThreadId = uint16(ThreadId);
 		::memcpy(Packet->Data, Data, Size);
 
 		Writer_SendDataRaw(Packet, Packet->PacketSize);
+		Writer_TailUpdateMarkers();
 		return;
 	}
 
@@ -241,6 +362,7 @@ void Writer_TailAppend(uint32 ThreadId, uint8* __restrict Data, uint32 Size)
 	Packet->PacketSize -= uint16(BackUp);
 
 	Writer_SendDataRaw(Packet, Packet->PacketSize);
+	Writer_TailUpdateMarkers();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -252,6 +374,11 @@ void Writer_TailOnConnect()
 		return;
 	}
 
+	if (uint32 Seconds = GTailSeconds)
+	{
+		Writer_TailDiscardExpired(TimeGetTimestamp(), Seconds);
+	}
+
 	GPacketRing.IterateRanges([] (const FPacketRing::FRange& Range)
 	{
 		Writer_SendDataRaw(Range.Data, Range.Size);
@@ -368,4 +495,11 @@ The Left-Right range has the oldest packets. Left will eventually advance to mee
 Right at which point the Left-Right range becomes empty The process above repeats
 as if the buffer was being filled for the first time.
 
+When the tail is bounded in time, packets can also expire from the oldest end
+without being overwritten. Expiry advances Left or, once the Left-Right range
+is entirely old, empties it and moves the start of the front range (F) forward.
+The front range is then [Front-Cursor) and becomes the next Left-Right range.
+
+ 0-----------------F[SZ]=======>[SZ]=====>C-----------------------------------|
+
 */
@@ -29,6 +29,8 @@ bool	Writer_IsTracing();
 bool	Writer_IsTracingTo(uint32 (&OutSessionGuid)[4], uint32 (&OutTraceGuid)[4]);
 bool	Writer_Stop();
 uint32	Writer_GetThreadId();
+void	Writer_SetCodec(ECodec);
+void	Writer_SetTailSeconds(uint32);
 
 extern FStatistics GTraceStatistics;
 
@@ -96,6 +98,18 @@ void GetStatistics(FStatistics& Out)
 	Out = Private::GTraceStatistics;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SetCodec(ECodec Codec)
+{
+	Private::Writer_SetCodec(Codec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SetTailSeconds(uint32 Seconds)
+{
+	Private::Writer_SetTailSeconds(Seconds);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool SendTo(const TCHAR* InHost, uint32 Port, uint16 Flags)
 {
@@ -38,8 +38,10 @@ namespace Private {
 
 ////////////////////////////////////////////////////////////////////////////////
 int32			Encode(const void*, int32, void*, int32);
+void			SetEncodeAcceleration(int32);
 void			Writer_SendData(uint32, uint8* __restrict, uint32);
 void			Writer_InitializeTail(int32);
+void			Writer_SetTailSeconds(uint32);
 void			Writer_ShutdownTail();
 void			Writer_TailOnConnect();
 void			Writer_InitializeSharedBuffers();
@@ -86,6 +88,26 @@ TRACELOG_API uint64				GStartCycle;		// = 0;
 TRACELOG_API uint32 volatile	GLogSerial;			// = 0;
 // Counter of calls to Writer_WorkerUpdate to enable regular flushing of output buffers
 static uint32					GUpdateCounter;		// = 0;
+static volatile bool			GEncodeDisabled;	// = false;
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+void Writer_SetCodec(ECodec Codec)
+{
+	// Acceleration used for ECodec::Lz4Fast. Higher values skip more of the
+	// input when searching for matches; Trace.Benchmark reports the trade-off.
+	static const int32 FastAcceleration = 8;
+
+	SetEncodeAcceleration((Codec == ECodec::Lz4Fast) ? FastAcceleration : 1);
+	GEncodeDisabled = (Codec == ECodec::None);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Writer_IsEncoding()
+{
+	return !GEncodeDisabled;
+}
 
 
 
@@ -387,7 +409,7 @@ void Writer_SendData(uint32 ThreadId, uint8* __restrict Data, uint32 Size)
 
 	// Smaller buffers usually aren't redundant enough to benefit from being
 	// compressed. They often end up being larger.
-	if (Size <= 384)
+	if (Size <= 384 || GEncodeDisabled)
 	{
 		Data -= sizeof(FTidPacket);
 		Size += sizeof(FTidPacket);
@@ -831,7 +853,9 @@ void Writer_InternalInitialize()
 ////////////////////////////////////////////////////////////////////////////////
 void Writer_Initialize(const FInitializeDesc& Desc)
 {
+	Writer_SetCodec(Desc.Codec);
 	Writer_InitializeTail(Desc.TailSizeBytes);
+	Writer_SetTailSeconds(Desc.TailSeconds);
 
 	if (Desc.bUseImportantCache)
 	{
@@ -102,10 +102,21 @@ struct FMessageEvent
 
 using OnMessageFunc = void(const FMessageEvent&);
 
+/* How traced data is compressed before being sent or stored in the tail.
+   All codecs produce packets existing analyzers can read. */
+enum class ECodec : uint8
+{
+	Lz4,		// LZ4 with its default acceleration
+	Lz4Fast,	// LZ4 with a high acceleration; cheaper to encode, less compression
+	None,		// Packets are sent uncompressed; no encoding cost, largest output
+};
+
 struct FInitializeDesc
 {
 	uint32			TailSizeBytes		= 4 << 20; // can be set to 0 to disable the tail buffer
+	uint32			TailSeconds			= 0; // if non-zero the tail only holds events of the last N seconds
 	uint32			ThreadSleepTimeInMS = 0;
+	ECodec			Codec				= ECodec::Lz4;
 	bool			bUseWorkerThread	= true;
 	bool			bUseImportantCache	= true;
 	uint32			SessionGuid[4]		= {0,0,0,0}; // leave as zero to generate random
@@ -129,6 +140,14 @@ struct FStatistics
 	uint32		CacheAllocated;	// Total memory allocated in cache buffers
 	uint32		CacheUsed;		// Used cache memory; Important-marked events are stored in the cache.
 	uint32		CacheWaste;		// Unused memory from retired cache buffers
+	uint64		BytesEncoded;		// Traced bytes given to the codec
+	uint64		BytesEncodedOutput;	// Codec output for BytesEncoded
+	uint64		EncodeTimeNs;		// Time spent in the codec
+	uint64		BlockPoolAllocated;	// Memory allocated for the blocks threads write events to
+	uint64		BlockPoolUsed;		// Block memory holding events not yet drained by the worker
+	uint64		BlockPoolPeakUsed;	// Largest BlockPoolUsed seen, i.e. how far writers got ahead of the worker
+	uint32		BlockPoolGrowths;	// Times the block pool ran out of free blocks and allocated a page
+	uint32		BlockPoolWaits;		// Times a writing thread had to wait for another one growing the pool
 };
 
 struct FSendFlags
@@ -146,6 +165,8 @@ UE_TRACE_API void	Shutdown() UE_TRACE_IMPL();
 UE_TRACE_API void	Panic() UE_TRACE_IMPL();
 UE_TRACE_API void	Update() UE_TRACE_IMPL();
 UE_TRACE_API void	GetStatistics(FStatistics& Out) UE_TRACE_IMPL();
+UE_TRACE_API void	SetCodec(ECodec Codec) UE_TRACE_IMPL();
+UE_TRACE_API void	SetTailSeconds(uint32 Seconds) UE_TRACE_IMPL();
 UE_TRACE_API bool	SendTo(const TCHAR* Host, uint32 Port=0, uint16 Flags=FSendFlags::None) UE_TRACE_IMPL(false);
 UE_TRACE_API bool	WriteTo(const TCHAR* Path, uint16 Flags=FSendFlags::None) UE_TRACE_IMPL(false);
 UE_TRACE_API bool	WriteSnapshotTo(const TCHAR* Path) UE_TRACE_IMPL(false);
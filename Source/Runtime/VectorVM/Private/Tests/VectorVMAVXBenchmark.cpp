@@ -0,0 +1,401 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Parse.h"
+#include "VectorVM.h"
+#include "VectorVMPrivate.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && VECTORVM_SUPPORTS_EXPERIMENTAL
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVectorVMAVXBenchmark, "System.Core.Math.Vector VM.AVX2 Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+namespace VectorVMAVXBenchmark
+{
+	struct FOperand
+	{
+		uint16 Index;
+		bool bConstant;
+	};
+
+	/**
+	 * Writes the original VM's bytecode, the same format the Niagara compiler emits and OptimizeVectorVMScript() consumes.
+	 * Every op writes a new temp register, all inputs and outputs use data set 0.
+	 */
+	struct FProgram
+	{
+		const TCHAR* Name = nullptr;
+		TArray<uint8> Bytecode;
+		TArray<uint32> Constants;
+		int32 NumFloatInputs = 0;
+		int32 NumIntInputs = 0;
+		int32 NumFloatOutputs = 0;
+		int32 NumIntOutputs = 0;
+		uint16 NumRegisters = 0;
+		uint16 IndexRegister = 0;
+
+		FOperand ConstFloat(float Value)
+		{
+			union { float f; uint32 i; } Bits = { Value };
+			Constants.Add(Bits.i);
+			return { (uint16)(Constants.Num() - 1), true };
+		}
+
+		FOperand ConstInt(int32 Value)
+		{
+			Constants.Add((uint32)Value);
+			return { (uint16)(Constants.Num() - 1), true };
+		}
+
+		FOperand Op(EVectorVMOp OpCode, std::initializer_list<FOperand> Inputs)
+		{
+			uint8 ConstantMask = 0;
+			int32 InputIdx = 0;
+			for (const FOperand& Input : Inputs)
+			{
+				ConstantMask |= Input.bConstant ? (1 << InputIdx) : 0;
+				++InputIdx;
+			}
+			const FOperand Dst = { NumRegisters++, false };
+			Bytecode.Add((uint8)OpCode);
+			Bytecode.Add(ConstantMask);
+			for (const FOperand& Input : Inputs)
+			{
+				WriteU16(Input.Index);
+			}
+			WriteU16(Dst.Index);
+			return Dst;
+		}
+
+		FOperand ExecIndex()
+		{
+			const FOperand Dst = { NumRegisters++, false };
+			Bytecode.Add((uint8)EVectorVMOp::exec_index);
+			WriteU16(Dst.Index);
+			return Dst;
+		}
+
+		FOperand Input(EVectorVMOp OpCode)
+		{
+			const FOperand Dst = { NumRegisters++, false };
+			Bytecode.Add((uint8)OpCode);
+			WriteU16(0);
+			WriteU16((uint16)(OpCode == EVectorVMOp::inputdata_float ? NumFloatInputs++ : NumIntInputs++));
+			WriteU16(Dst.Index);
+			return Dst;
+		}
+
+		/** Keeps every instance, the VM tests the sign bit of the keep flag */
+		void AcquireIndex()
+		{
+			const FOperand Keep = ConstInt(-1);
+			IndexRegister = NumRegisters++;
+			Bytecode.Add((uint8)EVectorVMOp::acquireindex);
+			Bytecode.Add(1);
+			WriteU16(0);
+			WriteU16(Keep.Index);
+			WriteU16(IndexRegister);
+		}
+
+		void Output(EVectorVMOp OpCode, FOperand Src)
+		{
+			Bytecode.Add((uint8)OpCode);
+			Bytecode.Add(Src.bConstant ? 1 : 0);
+			WriteU16(0);
+			WriteU16(IndexRegister);
+			WriteU16(Src.Index);
+			WriteU16((uint16)(OpCode == EVectorVMOp::outputdata_float ? NumFloatOutputs++ : NumIntOutputs++));
+		}
+
+		void Done()
+		{
+			Bytecode.Add((uint8)EVectorVMOp::done);
+		}
+
+	private:
+		void WriteU16(uint16 Value)
+		{
+			Bytecode.Add((uint8)(Value & 0xFF));
+			Bytecode.Add((uint8)(Value >> 8));
+		}
+	};
+
+	// straight float math, every op here has a native 8 wide implementation
+	static void BuildMathProgram(FProgram& Program)
+	{
+		Program.Name = TEXT("Math");
+		const FOperand A = Program.Input(EVectorVMOp::inputdata_float);
+		const FOperand B = Program.Input(EVectorVMOp::inputdata_float);
+		const FOperand C = Program.Input(EVectorVMOp::inputdata_float);
+		Program.AcquireIndex();
+
+		const FOperand Mad = Program.Op(EVectorVMOp::mad, { A, B, C });
+		const FOperand Half = Program.Op(EVectorVMOp::mul, { Mad, Program.ConstFloat(0.5f) });
+		const FOperand Diff = Program.Op(EVectorVMOp::sub, { Half, A });
+		const FOperand Root = Program.Op(EVectorVMOp::sqrt, { Program.Op(EVectorVMOp::abs, { Diff }) });
+		const FOperand Denom = Program.Op(EVectorVMOp::add, { Program.Op(EVectorVMOp::abs, { B }), Program.ConstFloat(2.0f) });
+		const FOperand Ratio = Program.Op(EVectorVMOp::div, { Root, Denom });
+		const FOperand Clamped = Program.Op(EVectorVMOp::clamp, { Ratio, Program.ConstFloat(-1.0f), Program.ConstFloat(1.0f) });
+		const FOperand Lerped = Program.Op(EVectorVMOp::lerp, { A, B, Program.ConstFloat(0.25f) });
+		const FOperand MinMax = Program.Op(EVectorVMOp::max, { Program.Op(EVectorVMOp::min, { Lerped, C }), Program.Op(EVectorVMOp::neg, { Denom }) });
+		const FOperand Frac = Program.Op(EVectorVMOp::frac, { Program.Op(EVectorVMOp::mul, { MinMax, Program.ConstFloat(0.125f) }) });
+		const FOperand Floor = Program.Op(EVectorVMOp::floor, { MinMax });
+		const FOperand Less = Program.Op(EVectorVMOp::cmplt, { A, B });
+		const FOperand Selected = Program.Op(EVectorVMOp::select, { Less, Frac, Floor });
+		const FOperand Rcp = Program.Op(EVectorVMOp::rcp, { Denom });
+		const FOperand Rsq = Program.Op(EVectorVMOp::rsq, { Denom });
+		const FOperand Index = Program.Op(EVectorVMOp::i2f, { Program.ExecIndex() });
+
+		Program.Output(EVectorVMOp::outputdata_float, Program.Op(EVectorVMOp::add, { Clamped, Selected }));
+		Program.Output(EVectorVMOp::outputdata_float, Program.Op(EVectorVMOp::mad, { Rcp, Rsq, Index }));
+		Program.Output(EVectorVMOp::outputdata_float, Program.Op(EVectorVMOp::sign, { Diff }));
+		Program.Done();
+	}
+
+	// integer and bit ops, including the integer divide which runs 4 wide per half
+	static void BuildIntProgram(FProgram& Program)
+	{
+		Program.Name = TEXT("Int");
+		const FOperand I = Program.Input(EVectorVMOp::inputdata_int32);
+		const FOperand J = Program.Input(EVectorVMOp::inputdata_int32);
+		const FOperand A = Program.Input(EVectorVMOp::inputdata_float);
+		Program.AcquireIndex();
+
+		const FOperand Sum = Program.Op(EVectorVMOp::addi, { I, J });
+		const FOperand Product = Program.Op(EVectorVMOp::muli, { Sum, Program.ConstInt(3) });
+		const FOperand Quotient = Program.Op(EVectorVMOp::divi, { Product, Program.ConstInt(7) });
+		const FOperand Masked = Program.Op(EVectorVMOp::bit_and, { Program.Op(EVectorVMOp::bit_xor, { Quotient, J }), Program.ConstInt(0x00FFFFFF) });
+		const FOperand Shifted = Program.Op(EVectorVMOp::bit_or, { Program.Op(EVectorVMOp::bit_lshift, { Masked, Program.ConstInt(2) }), Program.Op(EVectorVMOp::bit_rshift, { I, Program.ConstInt(3) }) });
+		const FOperand Clamped = Program.Op(EVectorVMOp::clampi, { Program.Op(EVectorVMOp::subi, { Shifted, J }), Program.ConstInt(-100000), Program.ConstInt(100000) });
+		const FOperand Truncated = Program.Op(EVectorVMOp::f2i, { Program.Op(EVectorVMOp::mul, { A, Program.ConstFloat(100.0f) }) });
+		const FOperand Less = Program.Op(EVectorVMOp::cmplti, { Clamped, Truncated });
+		const FOperand Selected = Program.Op(EVectorVMOp::select, { Less, Program.Op(EVectorVMOp::mini, { Clamped, Truncated }), Program.Op(EVectorVMOp::absi, { Truncated }) });
+
+		Program.Output(EVectorVMOp::outputdata_int32, Selected);
+		Program.Output(EVectorVMOp::outputdata_int32, Program.Op(EVectorVMOp::maxi, { Program.Op(EVectorVMOp::negi, { Quotient }), Program.Op(EVectorVMOp::signi, { J }) }));
+		Program.Output(EVectorVMOp::outputdata_float, Program.Op(EVectorVMOp::i2f, { Clamped }));
+		Program.Done();
+	}
+
+	// transcendentals run the 4 wide implementation on each half so they should still match bit for bit
+	static void BuildTranscendentalProgram(FProgram& Program)
+	{
+		Program.Name = TEXT("Transcendental");
+		const FOperand A = Program.Input(EVectorVMOp::inputdata_float);
+		const FOperand B = Program.Input(EVectorVMOp::inputdata_float);
+		Program.AcquireIndex();
+
+		const FOperand Scaled = Program.Op(EVectorVMOp::mul, { A, Program.ConstFloat(0.01f) });
+		const FOperand SinCos = Program.Op(EVectorVMOp::add, { Program.Op(EVectorVMOp::sin, { A }), Program.Op(EVectorVMOp::cos, { B }) });
+		const FOperand Exp = Program.Op(EVectorVMOp::exp, { Scaled });
+		const FOperand Log = Program.Op(EVectorVMOp::log, { Program.Op(EVectorVMOp::add, { Program.Op(EVectorVMOp::abs, { B }), Program.ConstFloat(1.0f) }) });
+		const FOperand Pow = Program.Op(EVectorVMOp::pow, { Program.Op(EVectorVMOp::abs, { Scaled }), Program.ConstFloat(0.75f) });
+		const FOperand Atan2 = Program.Op(EVectorVMOp::atan2, { A, B });
+		const FOperand Mod = Program.Op(EVectorVMOp::fmod, { A, Program.ConstFloat(2.5f) });
+
+		Program.Output(EVectorVMOp::outputdata_float, Program.Op(EVectorVMOp::mad, { SinCos, Exp, Log }));
+		Program.Output(EVectorVMOp::outputdata_float, Program.Op(EVectorVMOp::add, { Pow, Atan2 }));
+		Program.Output(EVectorVMOp::outputdata_float, Mod);
+		Program.Done();
+	}
+
+	/** Registers of data set 0 laid out the way Niagara hands them to the VM: floats, then ints */
+	struct FBuffers
+	{
+		TArray<TArray<uint32>> Inputs;
+		TArray<TArray<uint32>> Outputs;
+		TArray<const uint8*> InputPointers;
+		TArray<const uint8*> OutputPointers;
+
+		void Init(const FProgram& Program, int32 NumInstances, FRandomStream& Random)
+		{
+			const int32 NumInputs = Program.NumFloatInputs + Program.NumIntInputs;
+			const int32 NumOutputs = Program.NumFloatOutputs + Program.NumIntOutputs;
+			Inputs.SetNum(NumInputs);
+			Outputs.SetNum(NumOutputs);
+			InputPointers.SetNum(NumInputs);
+			OutputPointers.SetNum(NumOutputs);
+			for (int32 InputIdx = 0; InputIdx < NumInputs; ++InputIdx)
+			{
+				TArray<uint32>& Input = Inputs[InputIdx];
+				Input.SetNumUninitialized(NumInstances);
+				for (uint32& Value : Input)
+				{
+					if (InputIdx < Program.NumFloatInputs)
+					{
+						union { float f; uint32 i; } Bits = { Random.FRandRange(-100.0f, 100.0f) };
+						Value = Bits.i;
+					}
+					else
+					{
+						Value = (uint32)Random.RandRange(-1000000, 1000000);
+					}
+				}
+				InputPointers[InputIdx] = (const uint8*)Input.GetData();
+			}
+			for (int32 OutputIdx = 0; OutputIdx < NumOutputs; ++OutputIdx)
+			{
+				Outputs[OutputIdx].SetNumZeroed(NumInstances);
+				OutputPointers[OutputIdx] = (const uint8*)Outputs[OutputIdx].GetData();
+			}
+		}
+
+		/** Same inputs as Other with separate outputs, so both paths can be compared */
+		void InitWithInputsOf(const FBuffers& Other, int32 NumInstances)
+		{
+			InputPointers = Other.InputPointers;
+			Outputs.SetNum(Other.Outputs.Num());
+			OutputPointers.SetNum(Other.Outputs.Num());
+			for (int32 OutputIdx = 0; OutputIdx < Outputs.Num(); ++OutputIdx)
+			{
+				Outputs[OutputIdx].SetNumZeroed(NumInstances);
+				OutputPointers[OutputIdx] = (const uint8*)Outputs[OutputIdx].GetData();
+			}
+		}
+	};
+
+	static void Execute(FVectorVMState* VVMState, const FProgram& Program, FBuffers& Buffers, int32 NumInstances)
+	{
+		FDataSetMeta DataSet;
+		DataSet.InputRegisters = TArrayView<uint8 const* RESTRICT const>(Buffers.InputPointers.GetData(), Buffers.InputPointers.Num());
+		DataSet.OutputRegisters = TArrayView<uint8 const* RESTRICT const>(Buffers.OutputPointers.GetData(), Buffers.OutputPointers.Num());
+		DataSet.InputRegisterTypeOffsets[0] = 0;
+		DataSet.InputRegisterTypeOffsets[1] = Program.NumFloatInputs;
+		DataSet.InputRegisterTypeOffsets[2] = Program.NumFloatInputs + Program.NumIntInputs;
+		DataSet.OutputRegisterTypeOffsets[0] = 0;
+		DataSet.OutputRegisterTypeOffsets[1] = Program.NumFloatOutputs;
+		DataSet.OutputRegisterTypeOffsets[2] = Program.NumFloatOutputs + Program.NumIntOutputs;
+		DataSet.InstanceOffset = 0;
+
+		const uint8* ConstantTableData = (const uint8*)Program.Constants.GetData();
+		const int ConstantTableSize = Program.Constants.Num() * sizeof(uint32);
+
+		FVectorVMExecContext ExecCtx = {};
+		ExecCtx.VVMState = VVMState;
+		ExecCtx.DataSets = MakeArrayView(&DataSet, 1);
+		ExecCtx.NumInstances = NumInstances;
+		ExecCtx.ConstantTableData = &ConstantTableData;
+		ExecCtx.ConstantTableSizes = &ConstantTableSize;
+		ExecCtx.ConstantTableCount = 1;
+		ExecVectorVMState(&ExecCtx, nullptr, nullptr);
+	}
+
+	static double SecondsToMs(double Seconds)
+	{
+		return Seconds * 1000.0;
+	}
+}
+
+/**
+ * Runs a few generated VM scripts 4 wide and 8 wide over a range of instance counts, checks that both paths
+ * write bit identical outputs and reports the timings.
+ * Parameters: "Instances=<n>" to run a single instance count, "Iterations=<n>" to change the number of timed runs.
+ */
+bool FVectorVMAVXBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace VectorVMAVXBenchmark;
+
+	VectorVM::Init();
+
+	TArray<int32> InstanceCounts = { 1, 4, 7, 8, 13, 64, 1000, 100000 };
+	int32 NumInstancesParam = 0;
+	int32 NumIterations = 10;
+	if (FParse::Value(*Parameters, TEXT("Instances="), NumInstancesParam) && NumInstancesParam > 0)
+	{
+		InstanceCounts = { NumInstancesParam };
+	}
+	FParse::Value(*Parameters, TEXT("Iterations="), NumIterations);
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	FProgram Programs[3];
+	BuildMathProgram(Programs[0]);
+	BuildIntProgram(Programs[1]);
+	BuildTranscendentalProgram(Programs[2]);
+
+	bool bAnyAVX = false;
+	for (const FProgram& Program : Programs)
+	{
+		FVectorVMOptimizeContext OptimizeContext;
+		FMemory::Memzero(OptimizeContext);
+		OptimizeVectorVMScript(Program.Bytecode.GetData(), Program.Bytecode.Num(), nullptr, 0, &OptimizeContext, VVMFlag_OptOmitStats);
+		if (OptimizeContext.Error.Flags != 0)
+		{
+			AddError(FString::Printf(TEXT("%s: failed to optimize the script, error flags 0x%x"), Program.Name, OptimizeContext.Error.Flags));
+			FreeVectorVMOptimizeContext(&OptimizeContext);
+			continue;
+		}
+
+		// run from the serialized (frozen) form of the script, the way cooked Niagara systems do
+		TArray<uint8> FrozenContextData;
+		FreezeVectorVMOptimizeContext(OptimizeContext, FrozenContextData);
+		FreeVectorVMOptimizeContext(&OptimizeContext);
+		FVectorVMOptimizeContext FrozenContext;
+		ReinterpretVectorVMOptimizeContextData(FrozenContextData, FrozenContext);
+
+		FVectorVMState* VVMState4Wide = AllocVectorVMState(&FrozenContext);
+		FVectorVMState* VVMState8Wide = AllocVectorVMState(&FrozenContext);
+		if (VVMState4Wide == nullptr || VVMState8Wide == nullptr)
+		{
+			AddError(FString::Printf(TEXT("%s: failed to allocate the VM state"), Program.Name));
+			FreeVectorVMState(VVMState4Wide);
+			FreeVectorVMState(VVMState8Wide);
+			continue;
+		}
+		VVMState4Wide->Flags &= ~VVMFlag_SupportsAVX;
+		bAnyAVX |= (VVMState8Wide->Flags & VVMFlag_SupportsAVX) != 0;
+
+		for (int32 NumInstances : InstanceCounts)
+		{
+			FRandomStream Random(NumInstances);
+			FBuffers Buffers4Wide;
+			Buffers4Wide.Init(Program, NumInstances, Random);
+			FBuffers Buffers8Wide;
+			Buffers8Wide.InitWithInputsOf(Buffers4Wide, NumInstances);
+
+			double Seconds4Wide = 0.0;
+			double Seconds8Wide = 0.0;
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				double StartTime = FPlatformTime::Seconds();
+				Execute(VVMState4Wide, Program, Buffers4Wide, NumInstances);
+				Seconds4Wide += FPlatformTime::Seconds() - StartTime;
+
+				StartTime = FPlatformTime::Seconds();
+				Execute(VVMState8Wide, Program, Buffers8Wide, NumInstances);
+				Seconds8Wide += FPlatformTime::Seconds() - StartTime;
+			}
+
+			for (int32 OutputIdx = 0; OutputIdx < Buffers4Wide.Outputs.Num(); ++OutputIdx)
+			{
+				const TArray<uint32>& Expected = Buffers4Wide.Outputs[OutputIdx];
+				const TArray<uint32>& Actual = Buffers8Wide.Outputs[OutputIdx];
+				for (int32 InstanceIdx = 0; InstanceIdx < NumInstances; ++InstanceIdx)
+				{
+					if (Expected[InstanceIdx] != Actual[InstanceIdx])
+					{
+						AddError(FString::Printf(TEXT("%s: output %d of instance %d/%d differs, 4 wide 0x%08x, 8 wide 0x%08x"),
+							Program.Name, OutputIdx, InstanceIdx, NumInstances, Expected[InstanceIdx], Actual[InstanceIdx]));
+						break;
+					}
+				}
+			}
+
+			AddInfo(FString::Printf(TEXT("%-16s %8d instances: 4 wide %8.3fms  8 wide %8.3fms  (%.2fx)"), Program.Name, NumInstances,
+				SecondsToMs(Seconds4Wide / NumIterations), SecondsToMs(Seconds8Wide / NumIterations), Seconds4Wide / FMath::Max(Seconds8Wide, UE_DOUBLE_SMALL_NUMBER)));
+		}
+
+		FreeVectorVMState(VVMState4Wide);
+		FreeVectorVMState(VVMState8Wide);
+	}
+
+	if (!bAnyAVX)
+	{
+		AddWarning(TEXT("AVX2 is not supported on this CPU or not compiled in, both runs used the 4 wide path"));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && VECTORVM_SUPPORTS_EXPERIMENTAL
@@ -107,7 +107,6 @@
 														VVM_INS3_PTRS                                              \
 														uint8 *end = p2 + sizeof(FVecReg) * NumLoops;              \
 														InsPtr += 9;                                               \
-														ptrdiff_t p23d = p3 - p2;                                  \
 														do                                                         \
 														{                                                          \
 															VectorRegister4f r0 = VectorLoad((float *)p0);         \
@@ -116,9 +115,10 @@
 															p1 += Inc1;                                            \
 															VectorRegister4f res = ins_(r0, r1);                   \
 															VectorStoreAligned(res, (float *)p2);                  \
-															VectorStoreAligned(res, (float *)(p2 + p23d));         \
+															VectorStoreAligned(res, (float *)p3);                  \
+															p2 += sizeof(FVecReg);                                 \
 															p3 += sizeof(FVecReg);                                 \
-														} while (p3 < end);                                        \
+														} while (p2 < end);                                        \
 													}
 #	define VVM_execVecIns3f(ins_)					{                                                              \
 														VVMSer_instruction(0, 3)                                   \
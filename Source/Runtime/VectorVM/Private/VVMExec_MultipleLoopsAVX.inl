@@ -1,6 +1,13 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
-#if VECTORVM_SUPPORTS_COMPUTED_GOTO
+//8-wide version of VVMExec_MultipleLoops.inl, only used when the CPU supports AVX2.  The register tables are the same as the 4-wide
+//version: temp registers and inputs advance 16 bytes per 4 instances, constants and no-advance inputs don't advance at all.  Each
+//instruction processes two 4-wide loops at a time and finishes with one 4-wide loop when NumLoops is odd, so everything that isn't
+//an instruction (acquireindex, external functions, outputs) is shared with the 4-wide path.  The _AVX versions of the instructions
+//are in VectorVMExperimental.inl.
+
+//#if VECTORVM_SUPPORTS_COMPUTED_GOTO
+#if 1
 #define VVM_INS0_PTRS	uint8 *p0 = BatchState->RegPtrTable[((uint16 *)InsPtr)[0]];
 
 #define VVM_INS1_PTRS	uint8 *p0 = BatchState->RegPtrTable[((uint16 *)InsPtr)[0]];           \
@@ -40,7 +47,7 @@
 						uint32 Inc1 = (uint32)BatchState->RegIncTable[((uint16 *)InsPtr)[1]]; \
 						uint32 Inc2 = (uint32)BatchState->RegIncTable[((uint16 *)InsPtr)[2]]; \
 						uint32 Inc3 = (uint32)BatchState->RegIncTable[((uint16 *)InsPtr)[3]]; \
-						uint32 Inc3 = (uint32)BatchState->RegIncTable[((uint16 *)InsPtr)[4]];
+						uint32 Inc4 = (uint32)BatchState->RegIncTable[((uint16 *)InsPtr)[4]];
 #define VVM_execCoreSetupIncVars
 #define VVM_execCoreSetupPtrVars
 
@@ -69,266 +76,372 @@
 										uint8 *p2 = BatchState->RegPtrTable[((uint16 *)InsPtr)[2]];
 #endif
 
+//temp registers are only 16 byte aligned.  Register increments are either 16 or 0, in which case the same 4 values go to both halves.
+#define VVM_AVX_LOAD(p, Inc)				((Inc) ? _mm256_loadu_ps((float *)(p)) : _mm256_broadcast_ps((const __m128 *)(p)))
+#define VVM_AVXi_LOAD(p, Inc)				((Inc) ? _mm256_loadu_si256((const __m256i *)(p)) : _mm256_castps_si256(_mm256_broadcast_ps((const __m128 *)(p))))
 
-#	define VVM_execVecIns1f(ins_)					{                                                         \
-														VVMSer_instruction(0, 1)                              \
-														VVM_INS1_PTRS                                         \
-														InsPtr += 5;                                          \
-                                                        uint8 *end = p1 + sizeof(__m256) * NumLoops;          \
-														do                                                    \
-														{                                                     \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);         \
-															p0 += Inc0;                                       \
-															__m256 res = ins_##_AVX(r0);                      \
-															_mm256_store_ps((float *)p1, res);                \
-															p1 += sizeof(__m256);                             \
-														} while (p1 < end);                                   \
+#	define VVM_execVecIns1f(ins_)					{                                                          \
+														VVMSer_instruction(0, 1)                               \
+														VVM_INS1_PTRS                                          \
+														InsPtr += 5;                                           \
+														uint8 *end  = p1 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p1 + sizeof(FVecReg) * (NumLoops & ~1);  \
+														do                                                     \
+														{                                                      \
+															__m256 r0 = VVM_AVX_LOAD(p0, Inc0);                \
+															p0 += Inc0 << 1;                                   \
+															__m256 res = ins_##_AVX(r0);                       \
+															_mm256_storeu_ps((float *)p1, res);                \
+															p1 += sizeof(__m256);                              \
+														} while (p1 < end8);                                   \
+														if (p1 < end)                                          \
+														{                                                      \
+															VectorRegister4f r0 = VectorLoad((float *)p0);     \
+															VectorRegister4f res = ins_(r0);                   \
+															VectorStoreAligned(res, (float *)p1);              \
+														}                                                      \
 													}
-
-#	define VVM_execVecIns2f(ins_)					{                                                         \
-														VVMSer_instruction(0, 2)                              \
-														VVM_INS2_PTRS                                         \
-														InsPtr += 7;                                          \
-                                                        uint8 *end = p2 + sizeof(__m256) * NumLoops;          \
-														do                                                    \
-														{                                                     \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);         \
-															__m256 r1 = _mm256_loadu_ps((float *)p1);         \
-															p0 += Inc0;                                       \
-															p1 += Inc1;                                       \
-															__m256 res = ins_##_AVX(r0, r1);                  \
-															_mm256_store_ps((float *)p2, res);                \
-															p2 += sizeof(__m256);                             \
-														} while (p2 < end);                                   \
+#	define VVM_execVecIns2f(ins_)					{                                                          \
+														VVMSer_instruction(0, 2)                               \
+														VVM_INS2_PTRS                                          \
+														InsPtr += 7;                                           \
+														uint8 *end  = p2 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p2 + sizeof(FVecReg) * (NumLoops & ~1);  \
+														do                                                     \
+														{                                                      \
+															__m256 r0 = VVM_AVX_LOAD(p0, Inc0);                \
+															__m256 r1 = VVM_AVX_LOAD(p1, Inc1);                \
+															p0 += Inc0 << 1;                                   \
+															p1 += Inc1 << 1;                                   \
+															__m256 res = ins_##_AVX(r0, r1);                   \
+															_mm256_storeu_ps((float *)p2, res);                \
+															p2 += sizeof(__m256);                              \
+														} while (p2 < end8);                                   \
+														if (p2 < end)                                          \
+														{                                                      \
+															VectorRegister4f r0 = VectorLoad((float *)p0);     \
+															VectorRegister4f r1 = VectorLoad((float *)p1);     \
+															VectorRegister4f res = ins_(r0, r1);               \
+															VectorStoreAligned(res, (float *)p2);              \
+														}                                                      \
 													}
-#	define VVM_execVecIns2f_2x(ins_)				{                                                         \
-														VVMSer_instruction(0, 3)                              \
-														uint16 *InsPtr16 = (uint16 *)InsPtr;                  \
-														VVM_INS3_PTRS                                         \
-														uint8 *end = p2 + sizeof(__m256) * NumLoops;          \
-														InsPtr += 9;                                          \
-														ptrdiff_t p23d = p3 - p2;                             \
-														do                                                    \
-														{                                                     \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);         \
-															__m256 r1 = _mm256_loadu_ps((float *)p1);         \
-															p0 += Inc0;                                       \
-															p1 += Inc1;                                       \
-															__m256 res = ins_##_AVX(r0, r1);                  \
-															_mm256_store_ps((float *)p2, res);                \
-															_mm256_store_ps((float *)(p2 + p23d), res);       \
-															p3 += sizeof(__m256);                             \
-														} while (p3 < end);                                   \
+#	define VVM_execVecIns2f_2x(ins_)				{                                                          \
+														VVMSer_instruction(0, 3)                               \
+														VVM_INS3_PTRS                                          \
+														InsPtr += 9;                                           \
+														uint8 *end  = p2 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p2 + sizeof(FVecReg) * (NumLoops & ~1);  \
+														do                                                     \
+														{                                                      \
+															__m256 r0 = VVM_AVX_LOAD(p0, Inc0);                \
+															__m256 r1 = VVM_AVX_LOAD(p1, Inc1);                \
+															p0 += Inc0 << 1;                                   \
+															p1 += Inc1 << 1;                                   \
+															__m256 res = ins_##_AVX(r0, r1);                   \
+															_mm256_storeu_ps((float *)p2, res);                \
+															_mm256_storeu_ps((float *)p3, res);                \
+															p2 += sizeof(__m256);                              \
+															p3 += sizeof(__m256);                              \
+														} while (p2 < end8);                                   \
+														if (p2 < end)                                          \
+														{                                                      \
+															VectorRegister4f r0 = VectorLoad((float *)p0);     \
+															VectorRegister4f r1 = VectorLoad((float *)p1);     \
+															VectorRegister4f res = ins_(r0, r1);               \
+															VectorStoreAligned(res, (float *)p2);              \
+															VectorStoreAligned(res, (float *)p3);              \
+														}                                                      \
 													}
-#	define VVM_execVecIns3f(ins_)					{                                                         \
-														VVMSer_instruction(0, 3)                              \
-														uint16 *InsPtr16 = (uint16 *)InsPtr;                  \
-														VVM_INS3_PTRS                                         \
-														uint8 *end = p3 + sizeof(__m256) * NumLoops;          \
-														InsPtr += 9;                                          \
-														do                                                    \
-														{                                                     \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);         \
-															__m256 r1 = _mm256_loadu_ps((float *)p1);         \
-															__m256 r2 = _mm256_loadu_ps((float *)p2);         \
-															p0 += Inc0;                                       \
-															p1 += Inc1;                                       \
-															p2 += Inc2;                                       \
-															__m256 res = ins_##_AVX(r0, r1, r2);              \
-															_mm256_store_ps((float *)p3, res);                \
-															p3 += sizeof(__m256);                             \
-														} while (p3 < end);                                   \
+#	define VVM_execVecIns3f(ins_)					{                                                          \
+														VVMSer_instruction(0, 3)                               \
+														VVM_INS3_PTRS                                          \
+														InsPtr += 9;                                           \
+														uint8 *end  = p3 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p3 + sizeof(FVecReg) * (NumLoops & ~1);  \
+														do                                                     \
+														{                                                      \
+															__m256 r0 = VVM_AVX_LOAD(p0, Inc0);                \
+															__m256 r1 = VVM_AVX_LOAD(p1, Inc1);                \
+															__m256 r2 = VVM_AVX_LOAD(p2, Inc2);                \
+															p0 += Inc0 << 1;                                   \
+															p1 += Inc1 << 1;                                   \
+															p2 += Inc2 << 1;                                   \
+															__m256 res = ins_##_AVX(r0, r1, r2);               \
+															_mm256_storeu_ps((float *)p3, res);                \
+															p3 += sizeof(__m256);                              \
+														} while (p3 < end8);                                   \
+														if (p3 < end)                                          \
+														{                                                      \
+															VectorRegister4f r0 = VectorLoad((float *)p0);     \
+															VectorRegister4f r1 = VectorLoad((float *)p1);     \
+															VectorRegister4f r2 = VectorLoad((float *)p2);     \
+															VectorRegister4f res = ins_(r0, r1, r2);           \
+															VectorStoreAligned(res, (float *)p3);              \
+														}                                                      \
 													}
-#	define VVM_execVecIns4f(ins_)					{                                                         \
-														VVMSer_instruction(0, 4)                              \
-														uint16 *InsPtr16 = (uint16 *)InsPtr;                  \
-														VVM_INS4_PTRS                                         \
-														uint8 *end = p4 + sizeof(__m256) * NumLoops;          \
-														InsPtr += 11;                                         \
-														do                                                    \
-														{                                                     \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);         \
-															__m256 r1 = _mm256_loadu_ps((float *)p1);         \
-															__m256 r2 = _mm256_loadu_ps((float *)p2);         \
-															__m256 r3 = _mm256_loadu_ps((float *)p3);         \
-															p0 += Inc0;                                       \
-															p1 += Inc1;                                       \
-															p2 += Inc2;                                       \
-															p3 += Inc3;                                       \
-															__m256 res = ins_##_AVX(r0, r1, r2, r3);          \
-															_mm256_store_ps((float *)p4, res);                \
-															p4 += sizeof(__m256);                             \
-														} while (p4 < end);                                   \
+#	define VVM_execVecIns4f(ins_)					{                                                          \
+														VVMSer_instruction(0, 4)                               \
+														VVM_INS4_PTRS                                          \
+														InsPtr += 11;                                          \
+														uint8 *end  = p4 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p4 + sizeof(FVecReg) * (NumLoops & ~1);  \
+														do                                                     \
+														{                                                      \
+															__m256 r0 = VVM_AVX_LOAD(p0, Inc0);                \
+															__m256 r1 = VVM_AVX_LOAD(p1, Inc1);                \
+															__m256 r2 = VVM_AVX_LOAD(p2, Inc2);                \
+															__m256 r3 = VVM_AVX_LOAD(p3, Inc3);                \
+															p0 += Inc0 << 1;                                   \
+															p1 += Inc1 << 1;                                   \
+															p2 += Inc2 << 1;                                   \
+															p3 += Inc3 << 1;                                   \
+															__m256 res = ins_##_AVX(r0, r1, r2, r3);           \
+															_mm256_storeu_ps((float *)p4, res);                \
+															p4 += sizeof(__m256);                              \
+														} while (p4 < end8);                                   \
+														if (p4 < end)                                          \
+														{                                                      \
+															VectorRegister4f r0 = VectorLoad((float *)p0);     \
+															VectorRegister4f r1 = VectorLoad((float *)p1);     \
+															VectorRegister4f r2 = VectorLoad((float *)p2);     \
+															VectorRegister4f r3 = VectorLoad((float *)p3);     \
+															VectorRegister4f res = ins_(r0, r1, r2, r3);       \
+															VectorStoreAligned(res, (float *)p4);              \
+														}                                                      \
 													}
-#	define VVM_execVecIns5f(ins_)					{                                                         \
-														VVMSer_instruction(0, 4)                              \
-														uint16 *InsPtr16 = (uint16 *)InsPtr;                  \
-														VVM_INS5_PTRS                                         \
-														uint8 *end = p5 + sizeof(__m256) * NumLoops;          \
-														InsPtr += 13;                                         \
-														do                                                    \
-														{                                                     \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);         \
-															__m256 r1 = _mm256_loadu_ps((float *)p1);         \
-															__m256 r2 = _mm256_loadu_ps((float *)p2);         \
-															__m256 r3 = _mm256_loadu_ps((float *)p3);         \
-															__m256 r4 = _mm256_loadu_ps((float *)p4);         \
-															p0 += Inc0;                                       \
-															p1 += Inc1;                                       \
-															p2 += Inc2;                                       \
-															p3 += Inc3;                                       \
-															p4 += Inc4;                                       \
-															__m256 res = ins_##_AVX(r0, r1, r2, r3, r4);      \
-															_mm256_store_ps((float *)p5, res);                \
-															p5 += sizeof(__m256);                             \
-														} while (p5 < end);                                   \
+#	define VVM_execVecIns5f(ins_)					{                                                          \
+														VVMSer_instruction(0, 4)                               \
+														VVM_INS5_PTRS                                          \
+														InsPtr += 13;                                          \
+														uint8 *end  = p5 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p5 + sizeof(FVecReg) * (NumLoops & ~1);  \
+														do                                                     \
+														{                                                      \
+															__m256 r0 = VVM_AVX_LOAD(p0, Inc0);                \
+															__m256 r1 = VVM_AVX_LOAD(p1, Inc1);                \
+															__m256 r2 = VVM_AVX_LOAD(p2, Inc2);                \
+															__m256 r3 = VVM_AVX_LOAD(p3, Inc3);                \
+															__m256 r4 = VVM_AVX_LOAD(p4, Inc4);                \
+															p0 += Inc0 << 1;                                   \
+															p1 += Inc1 << 1;                                   \
+															p2 += Inc2 << 1;                                   \
+															p3 += Inc3 << 1;                                   \
+															p4 += Inc4 << 1;                                   \
+															__m256 res = ins_##_AVX(r0, r1, r2, r3, r4);       \
+															_mm256_storeu_ps((float *)p5, res);                \
+															p5 += sizeof(__m256);                              \
+														} while (p5 < end8);                                   \
+														if (p5 < end)                                          \
+														{                                                      \
+															VectorRegister4f r0 = VectorLoad((float *)p0);     \
+															VectorRegister4f r1 = VectorLoad((float *)p1);     \
+															VectorRegister4f r2 = VectorLoad((float *)p2);     \
+															VectorRegister4f r3 = VectorLoad((float *)p3);     \
+															VectorRegister4f r4 = VectorLoad((float *)p4);     \
+															VectorRegister4f res = ins_(r0, r1, r2, r3, r4);   \
+															VectorStoreAligned(res, (float *)p5);              \
+														}                                                      \
 													}
-
-
-
-
 #	define VVM_execVecIns1i(ins_)					{                                                          \
 														VVMSer_instruction(1, 1)                               \
 														VVM_INS1_PTRS                                          \
 														InsPtr += 5;                                           \
-														uint8 *end = p1 + sizeof(__m256) * NumLoops;           \
+														uint8 *end  = p1 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p1 + sizeof(FVecReg) * (NumLoops & ~1);  \
 														do                                                     \
 														{                                                      \
-															__m256i r0 = _mm256_loadu_si256((__m256i *)p0);    \
-															p0 += Inc0;                                        \
+															__m256i r0 = VVM_AVXi_LOAD(p0, Inc0);              \
+															p0 += Inc0 << 1;                                   \
 															__m256i res = ins_##_AVX(r0);                      \
-															_mm256_store_si256((__m256i *)p1, res);            \
-															p1 += sizeof(__m256);                              \
-														} while (p1 < end);                                    \
+															_mm256_storeu_si256((__m256i *)p1, res);           \
+															p1 += sizeof(__m256i);                             \
+														} while (p1 < end8);                                   \
+														if (p1 < end)                                          \
+														{                                                      \
+															VectorRegister4i r0 = VectorIntLoad(p0);           \
+															VectorRegister4i res = ins_(r0);                   \
+															VectorIntStoreAligned(res, p1);                    \
+														}                                                      \
 													}
 #	define VVM_execVecIns1i_2x(ins_)				{                                                          \
 														VVMSer_instruction(1, 2)                               \
 														VVM_INS2_PTRS                                          \
 														InsPtr += 7;                                           \
-														uint8 *end = p1 + sizeof(__m256) * NumLoops;           \
+														uint8 *end  = p1 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p1 + sizeof(FVecReg) * (NumLoops & ~1);  \
 														do                                                     \
 														{                                                      \
-															__m256i r0 = _mm256_loadu_si256((__m256i *)p0);    \
-															p0 += Inc0;                                        \
+															__m256i r0 = VVM_AVXi_LOAD(p0, Inc0);              \
+															p0 += Inc0 << 1;                                   \
 															__m256i res = ins_##_AVX(r0);                      \
-															_mm256_store_si256((__m256i *)p1, res);            \
-															_mm256_store_si256((__m256i *)p2, res);            \
-															p1 += sizeof(__m256);                              \
-															p2 += sizeof(__m256);                              \
-														} while (p1 < end);                                    \
+															_mm256_storeu_si256((__m256i *)p1, res);           \
+															_mm256_storeu_si256((__m256i *)p2, res);           \
+															p1 += sizeof(__m256i);                             \
+															p2 += sizeof(__m256i);                             \
+														} while (p1 < end8);                                   \
+														if (p1 < end)                                          \
+														{                                                      \
+															VectorRegister4i r0 = VectorIntLoad(p0);           \
+															VectorRegister4i res = ins_(r0);                   \
+															VectorIntStoreAligned(res, p1);                    \
+															VectorIntStoreAligned(res, p2);                    \
+														}                                                      \
 													}
 #	define VVM_execVecIns2i(ins_)					{                                                          \
 														VVMSer_instruction(1, 2)                               \
 														VVM_INS2_PTRS                                          \
 														InsPtr += 7;                                           \
-														uint8 *end = p2 + sizeof(__m256) * NumLoops;           \
+														uint8 *end  = p2 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p2 + sizeof(FVecReg) * (NumLoops & ~1);  \
 														do                                                     \
 														{                                                      \
-															__m256i r0 = _mm256_loadu_si256((__m256i *)p0);    \
-															__m256i r1 = _mm256_loadu_si256((__m256i *)p1);    \
-															p0 += Inc0;                                        \
-															p1 += Inc1;                                        \
+															__m256i r0 = VVM_AVXi_LOAD(p0, Inc0);              \
+															__m256i r1 = VVM_AVXi_LOAD(p1, Inc1);              \
+															p0 += Inc0 << 1;                                   \
+															p1 += Inc1 << 1;                                   \
 															__m256i res = ins_##_AVX(r0, r1);                  \
-															_mm256_store_si256((__m256i *)p2, res);            \
-															p2 += sizeof(__m256);                              \
-														} while (p2 < end);                                    \
+															_mm256_storeu_si256((__m256i *)p2, res);           \
+															p2 += sizeof(__m256i);                             \
+														} while (p2 < end8);                                   \
+														if (p2 < end)                                          \
+														{                                                      \
+															VectorRegister4i r0 = VectorIntLoad(p0);           \
+															VectorRegister4i r1 = VectorIntLoad(p1);           \
+															VectorRegister4i res = ins_(r0, r1);               \
+															VectorIntStoreAligned(res, p2);                    \
+														}                                                      \
 													}
-
-
 #	define VVM_execVecIns3i(ins_)					{                                                          \
 														VVMSer_instruction(1, 3)                               \
 														VVM_INS3_PTRS                                          \
-														uint16 *InsPtr16 = (uint16 *)InsPtr;                   \
-														uint8 *end = p3 + sizeof(__m256) * NumLoops;           \
 														InsPtr += 9;                                           \
+														uint8 *end  = p3 + sizeof(FVecReg) * NumLoops;         \
+														uint8 *end8 = p3 + sizeof(FVecReg) * (NumLoops & ~1);  \
 														do                                                     \
 														{                                                      \
-															__m256i r0 = _mm256_loadu_si256((__m256i *)p0);    \
-															__m256i r1 = _mm256_loadu_si256((__m256i *)p1);    \
-															__m256i r2 = _mm256_loadu_si256((__m256i *)p2);    \
-															p0 += Inc0;                                        \
-															p1 += Inc1;                                        \
-															p2 += Inc2;                                        \
+															__m256i r0 = VVM_AVXi_LOAD(p0, Inc0);              \
+															__m256i r1 = VVM_AVXi_LOAD(p1, Inc1);              \
+															__m256i r2 = VVM_AVXi_LOAD(p2, Inc2);              \
+															p0 += Inc0 << 1;                                   \
+															p1 += Inc1 << 1;                                   \
+															p2 += Inc2 << 1;                                   \
 															__m256i res = ins_##_AVX(r0, r1, r2);              \
-															_mm256_store_si256((__m256i *)p3, res);            \
-															p3 += sizeof(__m256);                              \
-														} while (p3 < end);                                    \
+															_mm256_storeu_si256((__m256i *)p3, res);           \
+															p3 += sizeof(__m256i);                             \
+														} while (p3 < end8);                                   \
+														if (p3 < end)                                          \
+														{                                                      \
+															VectorRegister4i r0 = VectorIntLoad(p0);           \
+															VectorRegister4i r1 = VectorIntLoad(p1);           \
+															VectorRegister4i r2 = VectorIntLoad(p2);           \
+															VectorRegister4i res = ins_(r0, r1, r2);           \
+															VectorIntStoreAligned(res, p3);                    \
+														}                                                      \
 													}
-#define VVM_execVec_exec_index                      {                                                                                                                               \
-                                                    	VVM_INS0_PTRS                                                                                                               \
-                                                    	VVMSer_instruction(1, 0);                                                                                                   \
-                                                    	InsPtr += 3;                                                                                                                \
-														__m256i Val = _mm256_add_epi32(_mm256_set1_epi32(StartInstanceThisChunk), VVM_m256iConst(ZeroOneTwoThreeFourFiveSixSeven)); \
-                                                    	__m256i Eight = _mm256_set1_epi32(8);                                                                                       \
-                                                    	uint8 *end = p0 + sizeof(__m256) * NumLoops;                                                                                \
-                                                    	do {                                                                                                                        \
-															_mm256_store_si256((__m256i *)p0, Val);                                                                                 \
-                                                    		Val = _mm256_add_epi32(Val, Eight);                                                                                     \
-                                                    		p0 += sizeof(__m256);                                                                                                   \
-                                                    	} while (p0 < end);                                                                                                         \
-                                                    }
-#define VVM_execVec_exec_indexf						{                                                                                                                               \
-                                                    	VVM_INS0_PTRS                                                                                                               \
-                                                    	VVMSer_instruction(1, 0);                                                                                                   \
-                                                    	InsPtr += 3;                                                                                                                \
-														__m256i Val = _mm256_add_epi32(_mm256_set1_epi32(StartInstanceThisChunk), VVM_m256iConst(ZeroOneTwoThreeFourFiveSixSeven)); \
-                                                    	__m256i Eight = _mm256_set1_epi32(8);                                                                                       \
-                                                    	uint8 *end = p0 + sizeof(__m256) * NumLoops;                                                                                \
-                                                    	do {                                                                                                                        \
-															_mm256_store_ps((float *)p0, _mm256_cvtepi32_ps(Val));                                                                  \
-                                                    		Val = _mm256_add_epi32(Val, Eight);                                                                                     \
-                                                    		p0 += sizeof(__m256);                                                                                                   \
-                                                    	} while (p0 < end);                                                                                                         \
-                                                    }
-
-#define VVM_execVec_exec_index_addi                 {                                                                                                                                \
-                                                    	VVM_INS1_PTRS                                                                                                                \
-                                                    	VVMSer_instruction(2, 0);                                                                                                    \
-                                                    	InsPtr += 5;                                                                                                                 \
-                                                    	__m256i Val = _mm256_add_epi32(_mm256_set1_epi32(StartInstanceThisChunk), VVM_m256iConst(ZeroOneTwoThreeFourFiveSixSeven));  \
-                                                    	__m256i Four = _mm256_set1_epi32(8);                                                                                         \
-                                                    	uint8 *end = p1 + sizeof(__m256) * NumLoops;                                                                                 \
-                                                    	do {                                                                                                                         \
-															__m256i r0 = _mm256_loadu_si256((__m256i *)p0);                                                                          \
-															p0 += Inc0;                                                                                                              \
-															_mm256_store_si256((__m256i *)p1, _mm256_add_epi32(Val, r0));                                                            \
-                                                    		Val = _mm256_add_epi32(Val, Four);                                                                                       \
-                                                    		p1 += sizeof(__m256);                                                                                                    \
-                                                    	} while (p1 < end);                                                                                                          \
-                                                    }
-#define VVM_execVec_random_2x						{                                                              \
-														VVMSer_instruction(2, 2)                                   \
-														VVM_INS3_PTRS                                              \
-														uint16 *InsPtr16 = (uint16 *)InsPtr;                       \
-														uint8 *end = p1 + sizeof(__m256) * NumLoops;               \
-														InsPtr += 7;											   \
-														do                                                         \
-														{                                                          \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);              \
-															p0 += Inc0;                                            \
-															__m256 res0 = VVM_random_AVX(r0);                      \
-															__m256 res1 = VVM_random_AVX(r0);                      \
-															_mm256_store_ps((float *)p1, res0);                    \
-															_mm256_store_ps((float *)p2, res1);                    \
-															p1 += sizeof(__m256);                                  \
-															p2 += sizeof(__m256);                                  \
-														} while (p1 < end);                                        \
+#	define VVM_execVec_exec_index					{                                                                                                                                  \
+														VVM_INS0_PTRS                                                                                                                  \
+														VVMSer_instruction(1, 0);                                                                                                      \
+														InsPtr += 3;                                                                                                                   \
+														__m256i Val   = _mm256_add_epi32(_mm256_set1_epi32(StartInstanceThisChunk), VVM_m256iConst(ZeroOneTwoThreeFourFiveSixSeven));  \
+														__m256i Eight = _mm256_set1_epi32(8);                                                                                          \
+														uint8 *end  = p0 + sizeof(FVecReg) * NumLoops;                                                                                 \
+														uint8 *end8 = p0 + sizeof(FVecReg) * (NumLoops & ~1);                                                                          \
+														do                                                                                                                             \
+														{                                                                                                                              \
+															_mm256_storeu_si256((__m256i *)p0, Val);                                                                                   \
+															Val = _mm256_add_epi32(Val, Eight);                                                                                        \
+															p0 += sizeof(__m256i);                                                                                                     \
+														} while (p0 < end8);                                                                                                           \
+														if (p0 < end)                                                                                                                  \
+														{                                                                                                                              \
+															VectorIntStoreAligned(VVM_AVXi_LO(Val), p0);                                                                               \
+														}                                                                                                                              \
 													}
-#define VVM_execVec_sin_cos							{                                                         \
-														VVMSer_instruction(0, 2)                              \
-														VVM_INS2_PTRS                                         \
-														InsPtr += 7;                                          \
-                                                        uint8 *end = p1 + sizeof(__m256) * NumLoops;          \
-														do                                                    \
-														{                                                     \
-															__m256 r0 = _mm256_loadu_ps((float *)p0);         \
-															p0 += Inc0;                                       \
-															VectorSinCos_AVX(r0, (__m256 *)p1, (__m256 *)p2); \
-															p1 += sizeof(__m256);                             \
-															p2 += sizeof(__m256);                             \
-														} while (p1 < end);                                   \
+#	define VVM_execVec_exec_indexf					{                                                                                                                                  \
+														VVM_INS0_PTRS                                                                                                                  \
+														VVMSer_instruction(1, 0);                                                                                                      \
+														InsPtr += 3;                                                                                                                   \
+														__m256i Val   = _mm256_add_epi32(_mm256_set1_epi32(StartInstanceThisChunk), VVM_m256iConst(ZeroOneTwoThreeFourFiveSixSeven));  \
+														__m256i Eight = _mm256_set1_epi32(8);                                                                                          \
+														uint8 *end  = p0 + sizeof(FVecReg) * NumLoops;                                                                                 \
+														uint8 *end8 = p0 + sizeof(FVecReg) * (NumLoops & ~1);                                                                          \
+														do                                                                                                                             \
+														{                                                                                                                              \
+															_mm256_storeu_ps((float *)p0, _mm256_cvtepi32_ps(Val));                                                                    \
+															Val = _mm256_add_epi32(Val, Eight);                                                                                        \
+															p0 += sizeof(__m256i);                                                                                                     \
+														} while (p0 < end8);                                                                                                           \
+														if (p0 < end)                                                                                                                  \
+														{                                                                                                                              \
+															VectorStoreAligned(VectorIntToFloat(VVM_AVXi_LO(Val)), (float *)p0);                                                       \
+														}                                                                                                                              \
+													}
+#	define VVM_execVec_exec_index_addi				{                                                                                                                                  \
+														VVM_INS1_PTRS                                                                                                                  \
+														VVMSer_instruction(2, 0);                                                                                                      \
+														InsPtr += 5;                                                                                                                   \
+														__m256i Val   = _mm256_add_epi32(_mm256_set1_epi32(StartInstanceThisChunk), VVM_m256iConst(ZeroOneTwoThreeFourFiveSixSeven));  \
+														__m256i Eight = _mm256_set1_epi32(8);                                                                                          \
+														uint8 *end  = p1 + sizeof(FVecReg) * NumLoops;                                                                                 \
+														uint8 *end8 = p1 + sizeof(FVecReg) * (NumLoops & ~1);                                                                          \
+														do                                                                                                                             \
+														{                                                                                                                              \
+															__m256i r0 = VVM_AVXi_LOAD(p0, Inc0);                                                                                      \
+															p0 += Inc0 << 1;                                                                                                           \
+															_mm256_storeu_si256((__m256i *)p1, _mm256_add_epi32(Val, r0));                                                             \
+															Val = _mm256_add_epi32(Val, Eight);                                                                                        \
+															p1 += sizeof(__m256i);                                                                                                     \
+														} while (p1 < end8);                                                                                                           \
+														if (p1 < end)                                                                                                                  \
+														{                                                                                                                              \
+															VectorRegister4i r0 = VectorIntLoad(p0);                                                                                   \
+															VectorIntStoreAligned(VectorIntAdd(VVM_AVXi_LO(Val), r0), p1);                                                             \
+														}                                                                                                                              \
+													}
+#	define VVM_execVec_random_2x					{                                                                                                   \
+														VVMSer_instruction(2, 2)                                                                        \
+														VVM_INS2_PTRS                                                                                   \
+														InsPtr += 7;                                                                                    \
+														uint8 *end  = p1 + sizeof(FVecReg) * NumLoops;                                                  \
+														uint8 *end8 = p1 + sizeof(FVecReg) * (NumLoops & ~1);                                           \
+														do                                                                                              \
+														{                                                                                               \
+															__m256 r0 = VVM_AVX_LOAD(p0, Inc0);                                                         \
+															p0 += Inc0 << 1;                                                                            \
+															/*same order as two 4-wide iterations so the random sequence doesn't depend on the width*/  \
+															VectorRegister4f Lo0 = VVM_random(VVM_AVX_LO(r0));                                          \
+															VectorRegister4f Lo1 = VVM_random(VVM_AVX_LO(r0));                                          \
+															VectorRegister4f Hi0 = VVM_random(VVM_AVX_HI(r0));                                          \
+															VectorRegister4f Hi1 = VVM_random(VVM_AVX_HI(r0));                                          \
+															_mm256_storeu_ps((float *)p1, VVM_AVX_COMBINE(Lo0, Hi0));                                   \
+															_mm256_storeu_ps((float *)p2, VVM_AVX_COMBINE(Lo1, Hi1));                                   \
+															p1 += sizeof(__m256);                                                                       \
+															p2 += sizeof(__m256);                                                                       \
+														} while (p1 < end8);                                                                            \
+														if (p1 < end)                                                                                   \
+														{                                                                                               \
+															VectorRegister4f r0 = VectorLoad((float *)p0);                                              \
+															VectorRegister4f res0 = VVM_random(r0);                                                     \
+															VectorRegister4f res1 = VVM_random(r0);                                                     \
+															VectorStoreAligned(res0, (float *)p1);                                                      \
+															VectorStoreAligned(res1, (float *)p2);                                                      \
+														}                                                                                               \
+													}
+//VectorSinCos() only exists 4-wide, so sin_cos runs the same loop as execChunkMultipleLoops()
+#	define VVM_execVec_sin_cos						{                                                                           \
+														VVMSer_instruction(0, 2)                                                \
+														VVM_INS2_PTRS                                                           \
+														InsPtr += 7;                                                            \
+														uint8 *end = p1 + sizeof(FVecReg) * NumLoops;                           \
+														do                                                                      \
+														{                                                                       \
+															VectorRegister4f r0 = VectorLoad((float *)p0);                      \
+															p0 += Inc0;                                                         \
+															VectorSinCos((VectorRegister4f *)p1, (VectorRegister4f *)p2, &r0);  \
+															p1 += sizeof(FVecReg);                                              \
+															p2 += sizeof(FVecReg);                                              \
+														} while (p1 < end);                                                     \
 													}
-
 
 #define VVM_output32					{                                                                                                                         \
 											uint8  RegType            = InsPtr[-1] - (uint8)EVectorVMOp::outputdata_float;										  \
@@ -448,14 +561,21 @@
 											}                                                                                                                                      \
 										}
 
+#if PLATFORM_COMPILER_CLANG
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#endif
 
-UE_DISABLE_OPTIMIZATION_SHIP
 static void execChunkMultipleLoopsAVX(FVectorVMExecContext *ExecCtx, FVectorVMBatchState *BatchState, int StartInstanceThisChunk, int NumInstancesThisChunk, int NumLoops, FVectorVMSerializeState *SerializeState, FVectorVMSerializeState *CmpSerializeState)
 {
 #include "VectorVMExecCore.inl"
 }
-UE_ENABLE_OPTIMIZATION_SHIP
 
+#if PLATFORM_COMPILER_CLANG
+#pragma clang attribute pop
+#endif
+
+#undef VVM_AVX_LOAD
+#undef VVM_AVXi_LOAD
 #undef VVM_execCoreSetupIncVars
 #undef VVM_execCoreSetupPtrVars
 
@@ -473,14 +593,15 @@ UE_ENABLE_OPTIMIZATION_SHIP
 #undef VVM_execVecIns4f
 #undef VVM_execVecIns5f
 #undef VVM_execVecIns1i
+#undef VVM_execVecIns1i_2x
 #undef VVM_execVecIns2i
 #undef VVM_execVecIns3i
 
 #undef VVM_execVec_exec_index
 #undef VVM_execVec_exec_indexf
-#undef VVM_execVec_exec_index_2x
 #undef VVM_execVec_random_2x
 #undef VVM_execVec_exec_index_addi
+#undef VVM_execVec_exec_index_2x
 #undef VVM_execVec_sin_cos
 
 #undef VVM_output32
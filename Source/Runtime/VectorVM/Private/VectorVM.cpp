@@ -283,6 +283,14 @@ static FAutoConsoleVariableRef CVarbBatchPackVMOutput(
 	ECVF_Default
 );
 
+static int32 GbVVMUseAVX2 = 1;
+static FAutoConsoleVariableRef CVarVVMUseAVX2(
+	TEXT("vm.UseAVX2"),
+	GbVVMUseAVX2,
+	TEXT("If > 0 chunks with more than 4 instances will be executed 8 wide on CPUs which support AVX2.\n"),
+	ECVF_Default
+);
+
 #include "VectorVMExperimental.inl"
 
 uint8 VectorVM::GetNumOpCodes()
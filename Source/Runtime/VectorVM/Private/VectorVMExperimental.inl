@@ -305,14 +305,12 @@ static void VVMDefaultFree(void *Ptr, const char *Filename, int LineNumber)
 #define VVM_ALIGN_64(num)           (((size_t)(num) + 63) & ~63)
 #define VVM_ALIGN_CACHELINE(num)	(((size_t)(num) + (VVM_CACHELINE_SIZE - 1)) & ~(VVM_CACHELINE_SIZE - 1))
 
-#if VECTORVM_SUPPORTS_AVX
-#include "ThirdParty/SSEMathFun/avx_mathfun.h"
-#define VVM_PTR_ALIGN    VVM_ALIGN_32
-#define VVM_REG_SIZE     sizeof(__m256)
-#else
+#if VECTORVM_SUPPORTS_AVX && PLATFORM_COMPILER_CLANG && !PLATFORM_WINDOWS
+#include <cpuid.h>
+#endif
+
 #define VVM_PTR_ALIGN    VVM_ALIGN_16
 #define VVM_REG_SIZE     sizeof(FVecReg)
-#endif
 
 //to avoid memset/memcpy when statically initializing sse variables
 #define VVMSet_m128Const(Name, V)                static const MS_ALIGN(16) float VVMConstVec4_##Name##4[4]   GCC_ALIGN(16) = { V, V, V, V }
@@ -326,9 +324,9 @@ static void VVMDefaultFree(void *Ptr, const char *Filename, int LineNumber)
 #if VECTORVM_SUPPORTS_AVX
 #define VVM_m256Const(Name)  (*(__m256 *)&(VVMConstVec8_##Name##8))
 #define VVM_m256iConst(Name) (*(__m256i *)&(VVMConstVec8_##Name##8i))
-#define VVMSet_m256Const(Name, V)                                static const MS_ALIGN(32) float VVMConstVec8_##Name##8[8]   GCC_ALIGN(32) = { V, V, V, V }
+#define VVMSet_m256Const(Name, V)                                static const MS_ALIGN(32) float VVMConstVec8_##Name##8[8]   GCC_ALIGN(32) = { V, V, V, V, V, V, V, V }
 #define VVMSet_m256Const8(Name, V0, V1, V2, V3, V4, V5, V6, V7)  static const MS_ALIGN(32) float VVMConstVec8_##Name##8[8]   GCC_ALIGN(32) = { V0, V1, V2, V3, V4, V5, V6, V7 }
-#define VVMSet_m256iConst(Name, V)                               static const MS_ALIGN(32) uint32 VVMConstVec8_##Name##8i[8] GCC_ALIGN(32) = { V, V, V, V }
+#define VVMSet_m256iConst(Name, V)                               static const MS_ALIGN(32) uint32 VVMConstVec8_##Name##8i[8] GCC_ALIGN(32) = { V, V, V, V, V, V, V, V }
 #define VVMSet_m256iConst8(Name, V0, V1, V2, V3, V4, V5, V6, V7) static const MS_ALIGN(32) uint32 VVMConstVec8_##Name##8i[8] GCC_ALIGN(32) = { V0, V1, V2, V3, V4, V5, V6, V7 }	/* equiv to setr */
 #else
 #define VVM_m256Const(Name)
@@ -359,20 +357,12 @@ VVMSet_m128iConst(  AlmostTwoBits   , 0x3fffffff);
 
 VVMSet_m256Const(   One                                  , 1.f);
 VVMSet_m256Const(   NegativeOne                          , -1.f);
-VVMSet_m256Const(   OneHalf                              , 0.5f);
 VVMSet_m256Const(   Epsilon                              , 1.e-8f);
-VVMSet_m256Const(   HalfPi                               , 3.14159265359f * 0.5f);
-VVMSet_m256Const(   FastSinA                             , 7.5894663844f) ;
-VVMSet_m256Const(   FastSinB                             , 1.6338434578f);
 VVMSet_m256iConst(  FMask                                , 0xFFFFFFFF);
+VVMSet_m256iConst(  AbsMask                              , 0x7FFFFFFF);
+VVMSet_m256iConst(  ShiftMask                            , 31);
 VVMSet_m256iConst(  One                                  , 1);
-VVMSet_m256iConst(  NegativeOne                          , 0xFFFFFFFF);
 VVMSet_m256iConst8( ZeroOneTwoThreeFourFiveSixSeven      , 0, 1, 2, 3, 4, 5, 6, 7);
-VVMSet_m256iConst8( ZeroTwoFourSixEightTenTwelveFourteen , 0, 2, 4, 6, 8, 10, 12, 14);
-VVMSet_m256Const8(  ZeroOneTwoThreeFourFiveSixSeven      , 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
-VVMSet_m256iConst(  RegOffsetMask                        , 0x7FFF);
-VVMSet_m256Const(   RegOneOverTwoPi                      , 1.f / 2.f / 3.14159265359f);
-VVMSet_m256iConst(  AlmostTwoBits                        , 0x3fffffff);
 
 //#ifdef UE_PLATFORM_MATH_SSE
 //#	if UE_PLATFORM_MATH_USE_SVML
@@ -511,259 +501,202 @@ VVMSet_m256iConst(  AlmostTwoBits                        , 0x3fffffff);
 
 
 #if VECTORVM_SUPPORTS_AVX
-#define VVM_select_AVX(m, v0, v1)			_mm256_blendv_ps(v1, v0, m)
-#define VVM_selecti_AVX(m, v0, v1)			_mm256_blendv_epi8(v1, v0, m)
-#define VVM_abs_AVX(v)                      _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(~(1 << 31))))
-#define VVM_pow_AVX(base, exp)               exp256_ps(_mm256_mul_ps(log256_ps(base), exp))
-#define VVM_neg_AVX(v)                      _mm256_sub_ps(_mm256_setzero_ps(), v)
-
-union VVMXXMYMMUnion
-{
-	__m256 ymm;
-	__m128 xmm[2];
-	__m256i ymmi;
-	__m128i xmmi[2];
-};
+//8-wide versions of the instructions above, used by execChunkMultipleLoopsAVX().  Each one has to produce exactly the same bits as
+//its 4-wide counterpart so a script gives the same results whether or not the CPU has AVX2.  Instructions which are exact in IEEE
+//arithmetic map directly to AVX2 instructions.  Everything that goes through an approximation in the platform vector math
+//(transcendentals, fmod, pow) or is done per-lane in scalar code (integer divide) runs the 4-wide version on each 128 bit half.
+#define VVM_AVX_LO(v)                           _mm256_castps256_ps128(v)
+#define VVM_AVX_HI(v)                           _mm256_extractf128_ps(v, 1)
+#define VVM_AVX_COMBINE(lo, hi)                 _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1)
+#define VVM_AVXi_LO(v)                          _mm256_castsi256_si128(v)
+#define VVM_AVXi_HI(v)                          _mm256_extracti128_si256(v, 1)
+#define VVM_AVXi_COMBINE(lo, hi)                _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1)
+#define VVM_AVX_split1(ins_, v)                 VVM_AVX_COMBINE(ins_(VVM_AVX_LO(v)), ins_(VVM_AVX_HI(v)))
+#define VVM_AVX_split2(ins_, v0, v1)            VVM_AVX_COMBINE(ins_(VVM_AVX_LO(v0), VVM_AVX_LO(v1)), ins_(VVM_AVX_HI(v0), VVM_AVX_HI(v1)))
+#define VVM_AVXi_split2(ins_, v0, v1)           VVM_AVXi_COMBINE(ins_(VVM_AVXi_LO(v0), VVM_AVXi_LO(v1)), ins_(VVM_AVXi_HI(v0), VVM_AVXi_HI(v1)))
+#define VVM_AVX_asi(v)                          _mm256_castps_si256(v)
+#define VVM_AVX_asf(v)                          _mm256_castsi256_ps(v)
+
+#define VVM_select_AVX(m, v0, v1)               _mm256_xor_ps(v1, _mm256_and_ps(m, _mm256_xor_ps(v0, v1)))
+#define VVM_selecti_AVX(m, v0, v1)              _mm256_xor_si256(v1, _mm256_and_si256(m, _mm256_xor_si256(v0, v1)))
+#if UE_PLATFORM_MATH_USE_FMA3
+#define VVM_madd_AVX(v0, v1, v2)                _mm256_fmadd_ps(v0, v1, v2)
+#else
+#define VVM_madd_AVX(v0, v1, v2)                _mm256_add_ps(_mm256_mul_ps(v0, v1), v2)
+#endif
+#define VVM_cmplt_AVX(v0, v1)                   _mm256_cmp_ps(v0, v1, _CMP_LT_OS)
+#define VVM_cmple_AVX(v0, v1)                   _mm256_cmp_ps(v0, v1, _CMP_LE_OS)
+#define VVM_cmpgt_AVX(v0, v1)                   _mm256_cmp_ps(v0, v1, _CMP_GT_OS)
+#define VVM_cmpge_AVX(v0, v1)                   _mm256_cmp_ps(v0, v1, _CMP_GE_OS)
+#define VVM_cmpeq_AVX(v0, v1)                   _mm256_cmp_ps(v0, v1, _CMP_EQ_OQ)
+#define VVM_cmpne_AVX(v0, v1)                   _mm256_cmp_ps(v0, v1, _CMP_NEQ_UQ)
+#define VVM_cmplti_AVX(v0, v1)                  _mm256_cmpgt_epi32(v1, v0)
+#define VVM_cmplei_AVX(v0, v1)                  _mm256_xor_si256(_mm256_cmpgt_epi32(v0, v1), VVM_m256iConst(FMask))
+#define VVM_cmpgti_AVX(v0, v1)                  _mm256_cmpgt_epi32(v0, v1)
+#define VVM_cmpgei_AVX(v0, v1)                  _mm256_xor_si256(_mm256_cmpgt_epi32(v1, v0), VVM_m256iConst(FMask))
+#define VVM_cmpeqi_AVX(v0, v1)                  _mm256_cmpeq_epi32(v0, v1)
+#define VVM_cmpnei_AVX(v0, v1)                  _mm256_xor_si256(_mm256_cmpeq_epi32(v0, v1), VVM_m256iConst(FMask))
+#define VVM_f2i_AVX(v)                          _mm256_cvttps_epi32(v)
+#define VVM_i2f_AVX(v)                          _mm256_cvtepi32_ps(v)
+
+#define VVM_NullOp_AVX(v)                       v
+#define VectorAdd_AVX(v0, v1)                   _mm256_add_ps(v0, v1)
+#define VectorSubtract_AVX(v0, v1)              _mm256_sub_ps(v0, v1)
+#define VectorMultiply_AVX(v0, v1)              _mm256_mul_ps(v0, v1)
+#define VectorMultiplyAdd_AVX(v0, v1, v2)       VVM_madd_AVX(v0, v1, v2)
+#define VectorMax_AVX(v0, v1)                   _mm256_max_ps(v0, v1)
+#define VectorMin_AVX(v0, v1)                   _mm256_min_ps(v0, v1)
+#define VectorClamp_AVX(v, vmin, vmax)          _mm256_min_ps(_mm256_max_ps(v, vmin), vmax)
+#define VectorLerp_AVX(v0, v1, a)               VVM_madd_AVX(v1, a, _mm256_mul_ps(v0, _mm256_sub_ps(VVM_m256Const(One), a)))
+#define VectorAbs_AVX(v)                        _mm256_and_ps(v, VVM_AVX_asf(VVM_m256iConst(AbsMask)))
+#define VectorNegate_AVX(v)                     _mm256_sub_ps(_mm256_setzero_ps(), v)
+#define VectorSign_AVX(v)                       VVM_select_AVX(VVM_cmpge_AVX(v, _mm256_setzero_ps()), VVM_m256Const(One), VVM_m256Const(NegativeOne))
+#define VectorSelect_AVX(m, v0, v1)             VVM_select_AVX(m, v0, v1)
+#define VectorCompareLT_AVX(v0, v1)             VVM_cmplt_AVX(v0, v1)
+#define VectorCompareLE_AVX(v0, v1)             VVM_cmple_AVX(v0, v1)
+#define VectorCompareGT_AVX(v0, v1)             VVM_cmpgt_AVX(v0, v1)
+#define VectorCompareGE_AVX(v0, v1)             VVM_cmpge_AVX(v0, v1)
+#define VectorCompareEQ_AVX(v0, v1)             VVM_cmpeq_AVX(v0, v1)
+#define VectorCompareNE_AVX(v0, v1)             VVM_cmpne_AVX(v0, v1)
+#if UE_PLATFORM_MATH_USE_SSE4_1
+#define VectorRound_AVX(v)                      _mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define VectorCeil_AVX(v)                       _mm256_ceil_ps(v)
+#define VectorFloor_AVX(v)                      _mm256_floor_ps(v)
+#define VectorTruncate_AVX(v)                   _mm256_round_ps(v, _MM_FROUND_TRUNC)
+#else //the 4-wide versions don't round in hardware without SSE4.1, so neither can we
+#define VectorRound_AVX(v)                      VVM_AVX_split1(VectorRound, v)
+#define VectorCeil_AVX(v)                       VVM_AVX_split1(VectorCeil, v)
+#define VectorFloor_AVX(v)                      VVM_AVX_split1(VectorFloor, v)
+#define VectorTruncate_AVX(v)                   VVM_AVX_split1(VectorTruncate, v)
+#endif
+#define VectorFractional_AVX(v)                 _mm256_sub_ps(v, VectorTruncate_AVX(v))
+#define VectorMod_AVX(v0, v1)                   VVM_AVX_split2(VectorMod, v0, v1)
 
-//AVX compare macros
-#define VVM_cmplt_AVX(v0, v1)               _mm256_cmp_ps(v0, v1, _CMP_LT_OS)
-#define VVM_cmple_AVX(v0, v1)               _mm256_cmp_ps(v0, v1, _CMP_LE_OS)
-#define VVM_cmpgt_AVX(v0, v1)               _mm256_cmp_ps(v0, v1, _CMP_GT_OS)
-#define VVM_cmpge_AVX(v0, v1)               _mm256_cmp_ps(v0, v1, _CMP_GE_OS)
-#define VVM_cmpeq_AVX(v0, v1)               _mm256_cmp_ps(v0, v1, _CMP_EQ_OQ)
-#define VVM_cmpneq_AVX(v0, v1)              _mm256_cmp_ps(v0, v1, _CMP_NEQ_OQ)
-
-#define VVM_cmplti_AVX(v0, v1)              _mm256_cmpgt_epi32(v1, v0)
-#define VVM_cmplei_AVX(v0, v1)              _mm256_or_si256(_mm256_cmpgt_epi32(v1, v0), _mm256_cmpeq_epi32(v0, v1))
-#define VVM_cmpgti_AVX(v0, v1)              _mm256_cmpgt_epi32(v0, v1)
-#define VVM_cmpgei_AVX(v0, v1)              _mm256_or_si256(_mm256_cmpgt_epi32(v0, v1), _mm256_cmpeq_epi32(v0, v1))
-#define VVM_cmpeqi_AVX(v0, v1)              _mm256_cmpeq_epi32(v0, v1)
-#define VVM_cmpneqi_AVX(v0, v1)             _mm256_xor_si256(_mm256_cmpeq_epi32(v0, v1), VVM_m256iConst(FMask))
-
-#define VVM_vecStep_AVX(v0, v1)             VVM_select_AVX(VVM_cmpge_AVX(_mm256_sub_ps(v0, v1), _mm256_setzero_ps()), VVM_m256Const(One), _mm256_setzero_ps())
-#define VVM_vecFloatToBool_AVX(v)           VVM_cmpgt_AVX  (v, _mm256_setzero_ps())
-#define VVM_vecBoolToFloat_AVX(v)           VVM_select_AVX (v, VVM_m256Const(One), _mm256_setzero_ps());
-#define VVM_vecIntToBool_AVX(v)             VVM_cmpgti_AVX (v, _mm256_setzero_si256())
-#define VVM_vecBoolToInt_AVX(v)             VVM_selecti_AVX(v, _mm256_set1_epi32(1), _mm256_setzero_si256())
-#define VVM_vecACosFast_AVX(v)              VectorATan2_AVX(_mm256_sqrt_ps(_mm256_mul_ps(_mm256_sub_ps(VVM_m256Const(One), v), _mm256_add_ps(VVM_m256Const(One), v))), v)
-//VectorATan2(VectorSqrt(VectorMultiply(VectorSubtract(VVM_m128Const(One), v), VectorAdd(VVM_m128Const(One), v))), v)
+#define VectorIntAdd_AVX(v0, v1)                _mm256_add_epi32(v0, v1)
+#define VectorIntSubtract_AVX(v0, v1)           _mm256_sub_epi32(v0, v1)
+#define VectorIntMultiply_AVX(v0, v1)           _mm256_mullo_epi32(v0, v1)
+#define VectorIntMax_AVX(v0, v1)                _mm256_max_epi32(v0, v1)
+#define VectorIntMin_AVX(v0, v1)                _mm256_min_epi32(v0, v1)
+#define VectorIntClamp_AVX(v, vmin, vmax)       _mm256_min_epi32(_mm256_max_epi32(v, vmin), vmax)
+#define VectorIntAbs_AVX(v)                     _mm256_abs_epi32(v)
+#define VectorIntNegate_AVX(v)                  _mm256_sub_epi32(_mm256_setzero_si256(), v)
+#define VectorIntSign_AVX(v)                    VVM_selecti_AVX(VVM_cmpgei_AVX(v, _mm256_setzero_si256()), VVM_m256iConst(One), VVM_m256iConst(FMask))
+#define VectorIntAnd_AVX(v0, v1)                _mm256_and_si256(v0, v1)
+#define VectorIntOr_AVX(v0, v1)                 _mm256_or_si256(v0, v1)
+#define VectorIntXor_AVX(v0, v1)                _mm256_xor_si256(v0, v1)
+#define VectorIntNot_AVX(v)                     _mm256_xor_si256(v, VVM_m256iConst(FMask))
+#define VectorIntCompareLT_AVX(v0, v1)          VVM_cmplti_AVX(v0, v1)
+#define VectorIntCompareLE_AVX(v0, v1)          VVM_cmplei_AVX(v0, v1)
+#define VectorIntCompareGT_AVX(v0, v1)          VVM_cmpgti_AVX(v0, v1)
+#define VectorIntCompareGE_AVX(v0, v1)          VVM_cmpgei_AVX(v0, v1)
+#define VectorIntCompareEQ_AVX(v0, v1)          VVM_cmpeqi_AVX(v0, v1)
+#define VectorIntCompareNEQ_AVX(v0, v1)         VVM_cmpnei_AVX(v0, v1)
+//the 4-wide shifts are plain uint32 shifts, which only use the low 5 bits of the shift count on x86
+#define VVMIntRShift_AVX(v0, v1)                _mm256_srlv_epi32(v0, _mm256_and_si256(v1, VVM_m256iConst(ShiftMask)))
+#define VVMIntLShift_AVX(v0, v1)                _mm256_sllv_epi32(v0, _mm256_and_si256(v1, VVM_m256iConst(ShiftMask)))
+#define VVMIntDiv_AVX(v0, v1)                   VVM_AVXi_split2(VVMIntDiv, v0, v1)
+#define VVMf2i_AVX(v)                           VVM_f2i_AVX(VVM_AVX_asf(v))
+#define VVMi2f_AVX(v)                           VVM_i2f_AVX(VVM_AVX_asi(v))
+
+#define VVM_tan_AVX(v)                          VVM_AVX_split1(VVM_tan, v)
+#define VVM_atan_AVX(v)                         VVM_AVX_split1(VVM_atan, v)
+#define VVM_atan2_AVX(v0, v1)                   VVM_AVX_split2(VVM_atan2, v0, v1)
+#define VVM_log2_AVX(v)                         VVM_AVX_split1(VVM_log2, v)
+#define VVM_exp_AVX(v)                          VVM_AVX_split1(VVM_exp, v)
+#define VVM_exp2_AVX(v)                         VVM_AVX_split1(VVM_exp2, v)
+#define VVM_sin_AVX(v)                          VVM_AVX_split1(VVM_sin, v)
+#define VVM_cos_AVX(v)                          VVM_AVX_split1(VVM_cos, v)
+
+#define VVM_vecStep_AVX(v0, v1)                 VVM_select_AVX(VVM_cmpge_AVX(_mm256_sub_ps(v0, v1), _mm256_setzero_ps()), VVM_m256Const(One), _mm256_setzero_ps())
+#define VVM_vecFloatToBool_AVX(v)               VVM_cmpgt_AVX(v, _mm256_setzero_ps())
+#define VVM_vecBoolToFloat_AVX(v)               VVM_select_AVX(v, VVM_m256Const(One), _mm256_setzero_ps())
+#define VVM_vecIntToBool_AVX(v)                 _mm256_cmpgt_epi32(v, _mm256_setzero_si256())
+#define VVM_vecBoolToInt_AVX(v)                 VVM_selecti_AVX(v, VVM_m256iConst(One), _mm256_setzero_si256())
+//VectorVMAccuracy::Reciprocal() and Sqrt() are computed with exact divides and square roots, so these don't need to be split
+#define VVM_safeIns_div_AVX(v0, v1)             VVM_select_AVX(VVM_cmpgt_AVX(VectorAbs_AVX(v1), VVM_m256Const(Epsilon)), _mm256_div_ps(v0, v1)                                                  , _mm256_setzero_ps())
+#define VVM_safeIns_rcp_AVX(v)                  VVM_select_AVX(VVM_cmpgt_AVX(VectorAbs_AVX(v) , VVM_m256Const(Epsilon)), _mm256_div_ps(VVM_m256Const(One), v)                                 , _mm256_setzero_ps())
+#define VVM_safe_sqrt_AVX(v)                    VVM_select_AVX(VVM_cmpgt_AVX(v                , VVM_m256Const(Epsilon)), _mm256_div_ps(VVM_m256Const(One), _mm256_div_ps(VVM_m256Const(One), _mm256_sqrt_ps(v))), _mm256_setzero_ps())
+#define VVM_safe_rsq_AVX(v)                     VVM_select_AVX(VVM_cmpgt_AVX(v                , VVM_m256Const(Epsilon)), _mm256_div_ps(VVM_m256Const(One), _mm256_sqrt_ps(v))                   , _mm256_setzero_ps())
+#define VVM_safe_log_AVX(v)                     VVM_AVX_split1(VVM_safe_log, v)
+#define VVM_safe_pow_AVX(v0, v1)                VVM_AVX_split2(VVM_safe_pow, v0, v1)
+#define VVM_vecACosFast_AVX(v)                  VVM_AVX_split1(VVM_vecACosFast, v)
+#define VVM_vecASinFast_AVX(v)                  VVM_AVX_split1(VVM_vecASinFast, v)
+#define VVM_random_AVX(v)                       VVMRandom_AVX(BatchState, v)
+#define VVM_randomi_AVX(v)                      VVMRandomi_AVX(BatchState, v)
 
-//safe instructions -- handle divide by zero "gracefully" by returning 0
-#define VVM_safeIns_div_AVX(v0, v1)        VVM_select_AVX(VVM_cmpgt_AVX(VVM_abs_AVX(v1), VVM_m256Const(Epsilon)), _mm256_div_ps(v0, v1)                 , _mm256_setzero_ps())
-#define VVM_safeIns_rcp_AVX(v)             VVM_select_AVX(VVM_cmpgt_AVX(VVM_abs_AVX(v) , VVM_m256Const(Epsilon)), _mm256_rcp_ps(v)                      , _mm256_setzero_ps())
-#define VVM_safe_sqrt_AVX(v)               VVM_select_AVX(VVM_cmpgt_AVX(v              , VVM_m256Const(Epsilon)), _mm256_sqrt_ps(v)                     , _mm256_setzero_ps())
-#define VVM_safe_log_AVX(v)                VVM_select_AVX(VVM_cmpgt_AVX(v              , _mm256_setzero_ps())   , log256_ps(v)		                    , _mm256_setzero_ps())
-#define VVM_safe_pow_AVX(v0, v1)           VVM_select_AVX(VVM_cmpgt_AVX(v1             , VVM_m256Const(Epsilon)), VVM_pow_AVX(v0, v1)                   , _mm256_setzero_ps())
-#define VVM_safe_rsq_AVX(v)                VVM_select_AVX(VVM_cmpgt_AVX(v              , VVM_m256Const(Epsilon)), _mm256_rsqrt_ps (v)                   , _mm256_setzero_ps())
-#define VVM_random_AVX(v)                  _mm256_mul_ps(_mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(VVMXorwowStep_AVX(BatchState), 9), _mm256_set1_epi32(0x3F800000))), VVM_m256Const(One)), v)
-#define VVM_randomi_AVX(v)                 _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(VVMXorwowStep_AVX(BatchState), 9), _mm256_set1_epi32(0x3F800000))), VVM_m256Const(One)), *(__m256 *)&v))
-
-//new merged instructions	
 #define VVM_cmplt_select_AVX(v0, v1, v2, v3)    VVM_select_AVX(VVM_cmplt_AVX(v0, v1), v2, v3)
 #define VVM_cmple_select_AVX(v0, v1, v2, v3)    VVM_select_AVX(VVM_cmple_AVX(v0, v1), v2, v3)
 #define VVM_cmpeq_select_AVX(v0, v1, v2, v3)    VVM_select_AVX(VVM_cmpeq_AVX(v0, v1), v2, v3)
-#define VVM_cmplti_select_AVX(v0, v1, v2, v3)   VVM_select_AVX(_mm256_castsi256_ps(VVM_cmplti_AVX(*(__m256i *)&v0, *(__m256i *)&v1)), v2, v3)
-#define VVM_cmplei_select_AVX(v0, v1, v2, v3)   VVM_select_AVX(_mm256_castsi256_ps(VVM_cmplei_AVX(*(__m256i *)&v0, *(__m256i *)&v1)), v2, v3)
-#define VVM_cmpeqi_select_AVX(v0, v1, v2, v3)   VVM_select_AVX(_mm256_castsi256_ps(VVM_cmpeqi_AVX(*(__m256i *)&v0, *(__m256i *)&v1)), v2, v3)
-#define VVM_cmplt_logic_and_AVX(v0, v1, v2)     _mm256_castsi256_ps(_mm256_and_si256(_mm256_castps_si256(VVM_cmplt_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmple_logic_and_AVX(v0, v1, v2)     _mm256_castsi256_ps(_mm256_and_si256(_mm256_castps_si256(VVM_cmple_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpgt_logic_and_AVX(v0, v1, v2)     _mm256_castsi256_ps(_mm256_and_si256(_mm256_castps_si256(VVM_cmpgt_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpge_logic_and_AVX(v0, v1, v2)     _mm256_castsi256_ps(_mm256_and_si256(_mm256_castps_si256(VVM_cmpge_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpeq_logic_and_AVX(v0, v1, v2)     _mm256_castsi256_ps(_mm256_and_si256(_mm256_castps_si256(VVM_cmpeq_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpne_logic_and_AVX(v0, v1, v2)     _mm256_castsi256_ps(_mm256_and_si256(_mm256_castps_si256(VVM_cmpneq_AVX(v0, v1)), *(__m256i *)&v2))
+#define VVM_cmplti_select_AVX(v0, v1, v2, v3)   VVM_select_AVX(VVM_AVX_asf(VVM_cmplti_AVX(VVM_AVX_asi(v0), VVM_AVX_asi(v1))), v2, v3)
+#define VVM_cmplei_select_AVX(v0, v1, v2, v3)   VVM_select_AVX(VVM_AVX_asf(VVM_cmplei_AVX(VVM_AVX_asi(v0), VVM_AVX_asi(v1))), v2, v3)
+#define VVM_cmpeqi_select_AVX(v0, v1, v2, v3)   VVM_select_AVX(VVM_AVX_asf(VVM_cmpeqi_AVX(VVM_AVX_asi(v0), VVM_AVX_asi(v1))), v2, v3)
+#define VVM_cmplt_logic_and_AVX(v0, v1, v2)     _mm256_and_ps(VVM_cmplt_AVX(v0, v1), v2)
+#define VVM_cmple_logic_and_AVX(v0, v1, v2)     _mm256_and_ps(VVM_cmple_AVX(v0, v1), v2)
+#define VVM_cmpgt_logic_and_AVX(v0, v1, v2)     _mm256_and_ps(VVM_cmpgt_AVX(v0, v1), v2)
+#define VVM_cmpge_logic_and_AVX(v0, v1, v2)     _mm256_and_ps(VVM_cmpge_AVX(v0, v1), v2)
+#define VVM_cmpeq_logic_and_AVX(v0, v1, v2)     _mm256_and_ps(VVM_cmpeq_AVX(v0, v1), v2)
+#define VVM_cmpne_logic_and_AVX(v0, v1, v2)     _mm256_and_ps(VVM_cmpne_AVX(v0, v1), v2)
 #define VVM_cmplti_logic_and_AVX(v0, v1, v2)    _mm256_and_si256(VVM_cmplti_AVX(v0, v1), v2)
 #define VVM_cmplei_logic_and_AVX(v0, v1, v2)    _mm256_and_si256(VVM_cmplei_AVX(v0, v1), v2)
 #define VVM_cmpgti_logic_and_AVX(v0, v1, v2)    _mm256_and_si256(VVM_cmpgti_AVX(v0, v1), v2)
 #define VVM_cmpgei_logic_and_AVX(v0, v1, v2)    _mm256_and_si256(VVM_cmpgei_AVX(v0, v1), v2)
 #define VVM_cmpeqi_logic_and_AVX(v0, v1, v2)    _mm256_and_si256(VVM_cmpeqi_AVX(v0, v1), v2)
-#define VVM_cmpnei_logic_and_AVX(v0, v1, v2)    _mm256_and_si256(VVM_cmpneqi_AVX(v0, v1), v2)
-#define VVM_cmplt_logic_or_AVX(v0, v1, v2)      _mm256_castsi256_ps(_mm256_or_si256(_mm256_castps_si256(VVM_cmplt_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmple_logic_or_AVX(v0, v1, v2)      _mm256_castsi256_ps(_mm256_or_si256(_mm256_castps_si256(VVM_cmple_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpgt_logic_or_AVX(v0, v1, v2)      _mm256_castsi256_ps(_mm256_or_si256(_mm256_castps_si256(VVM_cmpgt_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpge_logic_or_AVX(v0, v1, v2)      _mm256_castsi256_ps(_mm256_or_si256(_mm256_castps_si256(VVM_cmpge_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpeq_logic_or_AVX(v0, v1, v2)      _mm256_castsi256_ps(_mm256_or_si256(_mm256_castps_si256(VVM_cmpeq_AVX(v0, v1)), *(__m256i *)&v2))
-#define VVM_cmpne_logic_or_AVX(v0, v1, v2)      _mm256_castsi256_ps(_mm256_or_si256(_mm256_castps_si256(VVM_cmpneq_AVX(v0, v1)), *(__m256i *)&v2))
+#define VVM_cmpnei_logic_and_AVX(v0, v1, v2)    _mm256_and_si256(VVM_cmpnei_AVX(v0, v1), v2)
+#define VVM_cmplt_logic_or_AVX(v0, v1, v2)      _mm256_or_ps(VVM_cmplt_AVX(v0, v1), v2)
+#define VVM_cmple_logic_or_AVX(v0, v1, v2)      _mm256_or_ps(VVM_cmple_AVX(v0, v1), v2)
+#define VVM_cmpgt_logic_or_AVX(v0, v1, v2)      _mm256_or_ps(VVM_cmpgt_AVX(v0, v1), v2)
+#define VVM_cmpge_logic_or_AVX(v0, v1, v2)      _mm256_or_ps(VVM_cmpge_AVX(v0, v1), v2)
+#define VVM_cmpeq_logic_or_AVX(v0, v1, v2)      _mm256_or_ps(VVM_cmpeq_AVX(v0, v1), v2)
+#define VVM_cmpne_logic_or_AVX(v0, v1, v2)      _mm256_or_ps(VVM_cmpne_AVX(v0, v1), v2)
 #define VVM_cmplti_logic_or_AVX(v0, v1, v2)     _mm256_or_si256(VVM_cmplti_AVX(v0, v1), v2)
 #define VVM_cmplei_logic_or_AVX(v0, v1, v2)     _mm256_or_si256(VVM_cmplei_AVX(v0, v1), v2)
 #define VVM_cmpgti_logic_or_AVX(v0, v1, v2)     _mm256_or_si256(VVM_cmpgti_AVX(v0, v1), v2)
 #define VVM_cmpgei_logic_or_AVX(v0, v1, v2)     _mm256_or_si256(VVM_cmpgei_AVX(v0, v1), v2)
 #define VVM_cmpeqi_logic_or_AVX(v0, v1, v2)     _mm256_or_si256(VVM_cmpeqi_AVX(v0, v1), v2)
-#define VVM_cmpnei_logic_or_AVX(v0, v1, v2)     _mm256_or_si256(VVM_cmpneqi_AVX(v0, v1), v2)
-#define VVM_mad_add_AVX(v0, v1, v2, v3)         _mm256_add_ps(_mm256_fmadd_ps(v0, v1, v2), v3)
-#define VVM_mad_sub0_AVX(v0, v1, v2, v3)        _mm256_sub_ps(_mm256_fmadd_ps(v0, v1, v2), v3)
-#define VVM_mad_sub1_AVX(v0, v1, v2, v3)        _mm256_sub_ps(v3, _mm256_fmadd_ps(v0, v1, v2))
-#define VVM_mad_mul_AVX(v0, v1, v2, v3)         _mm256_mul_ps(_mm256_fmadd_ps(v0, v1, v2), v3)
-#define VVM_mad_sqrt_AVX(v0, v1, v2)            _mm256_sqrt_ps(_mm256_fmadd_ps(v0, v1, v2))
-#define VVM_mad_mad0_AVX(v0, v1, v2, v3, v4)    _mm256_fmadd_ps(_mm256_fmadd_ps(v0, v1, v2), v3, v4)
-#define VVM_mad_mad1_AVX(v0, v1, v2, v3, v4)    _mm256_fmadd_ps(v3, v4, _mm256_fmadd_ps(v0, v1, v2))
-#define VVM_mul_mad0_AVX(v0, v1, v2, v3)        _mm256_fmadd_ps(_mm256_mul_ps(v0, v1), v2, v3)
-#define VVM_mul_mad1_AVX(v0, v1, v2, v3)        _mm256_fmadd_ps(v2, v3, _mm256_mul_ps(v0, v1))
+#define VVM_cmpnei_logic_or_AVX(v0, v1, v2)     _mm256_or_si256(VVM_cmpnei_AVX(v0, v1), v2)
+#define VVM_mad_add_AVX(v0, v1, v2, v3)         _mm256_add_ps(VVM_madd_AVX(v0, v1, v2), v3)
+#define VVM_mad_sub0_AVX(v0, v1, v2, v3)        _mm256_sub_ps(VVM_madd_AVX(v0, v1, v2), v3)
+#define VVM_mad_sub1_AVX(v0, v1, v2, v3)        _mm256_sub_ps(v3, VVM_madd_AVX(v0, v1, v2))
+#define VVM_mad_mul_AVX(v0, v1, v2, v3)         _mm256_mul_ps(VVM_madd_AVX(v0, v1, v2), v3)
+#define VVM_mad_sqrt_AVX(v0, v1, v2)            _mm256_sqrt_ps(VVM_madd_AVX(v0, v1, v2))
+#define VVM_mad_mad0_AVX(v0, v1, v2, v3, v4)    VVM_madd_AVX(v3, v4, VVM_madd_AVX(v0, v1, v2))
+#define VVM_mad_mad1_AVX(v0, v1, v2, v3, v4)    VVM_madd_AVX(VVM_madd_AVX(v0, v1, v2), v3, v4)
+#define VVM_mul_mad0_AVX(v0, v1, v2, v3)        VVM_madd_AVX(_mm256_mul_ps(v0, v1), v2, v3)
+#define VVM_mul_mad1_AVX(v0, v1, v2, v3)        VVM_madd_AVX(v2, v3, _mm256_mul_ps(v0, v1))
 #define VVM_mul_add_AVX(v0, v1, v2)             _mm256_add_ps(_mm256_mul_ps(v0, v1), v2)
-#define VVM_mul_sub_AVX(v0, v1, v2)             _mm256_sub_ps(_mm256_mul_ps(v0, v1), v2)
+#define VVM_mul_sub0_AVX(v0, v1, v2)            _mm256_sub_ps(_mm256_mul_ps(v0, v1), v2)
+#define VVM_mul_sub1_AVX(v0, v1, v2)            _mm256_sub_ps(v2, _mm256_mul_ps(v0, v1))
 #define VVM_mul_mul_AVX(v0, v1, v2)             _mm256_mul_ps(_mm256_mul_ps(v0, v1), v2)
 #define VVM_mul_max_AVX(v0, v1, v2)             _mm256_max_ps(_mm256_mul_ps(v0, v1), v2)
-#define VVM_add_mad1_AVX(v0, v1, v2, v3)        _mm256_fmadd_ps(v2, v3, _mm256_add_ps(v0, v1))
+#define VVM_add_mad1_AVX(v0, v1, v2, v3)        VVM_madd_AVX(v2, v3, _mm256_add_ps(v0, v1))
 #define VVM_add_add_AVX(v0, v1, v2)             _mm256_add_ps(_mm256_add_ps(v0, v1), v2)
-#define VVM_sub_cmplt1_AVX(v0, v1, v2)			VVM_cmplt_AVX(v2, _mm256_sub_ps(v0, v1))
-#define VVM_sub_neg_AVX(v0, v1)                 VVM_neg_AVX(_mm256_sub_ps(v0, v1))
-#define VVM_sub_mul_AVX(v0, v1, v2)				_mm256_mul_ps(_mm256_sub_ps(v0, v1), v2)
-#define VVM_div_mad0_AVX(v0, v1, v2, v3)        _mm256_fmadd_ps(_mm256_div_ps(v0, v1), v2, v3)
-#define VVM_div_f2i_AVX(v0, v1)                 _mm256_cvttps_epi32(_mm256_div_ps(_mm256_castsi256_ps(v0), _mm256_castsi256_ps(v1)))
-#define VVM_div_mul_AVX(v0, v1, v2)				_mm256_mul_ps(_mm256_div_ps(v0, v1), v2)
-#define VVM_muli_addi_AVX(v0, v1, v2)           _mm256_add_epi32(VectorIntMultiply_AVX(v1, v2), v2)
-#define VVM_addi_bit_rshift_AVX(v0, v1, v2)     _mm256_srlv_epi32(_mm256_add_epi32(v1, v2), v2)
-#define VVM_addi_muli_AVX(v0, v1, v2)           VectorIntMultiply_AVX(_mm256_add_epi32(v1, v2), v2)
-#define VVM_i2f_div0_AVX(v0, v1)                _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(v0)), v1)
-#define VVM_i2f_div1_AVX(v0, v1)                _mm256_div_ps(v1, _mm256_cvtepi32_ps(_mm256_castps_si256(v0))) 
-#define VVM_i2f_mul_AVX(v0, v1)                 _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(v0)), v1)
-#define VVM_i2f_mad0_AVX(v0, v1, v2)            _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(v0)), v1, v2)
-#define VVM_i2f_mad1_AVX(v0, v1, v2)            _mm256_fmadd_ps(v0, v1, _mm256_cvtepi32_ps(_mm256_castps_si256(v2)))
-#define VVM_mul_sub0_AVX(v0, v1, v2)            _mm256_sub_ps(_mm256_mul_ps(v0, v1), v2)
-#define VVM_mul_sub1_AVX(v0, v1, v2)            _mm256_sub_ps(v2, _mm256_mul_ps(v0, v1))
-#define VVM_f2i_select1_AVX(mask, v0, v1)       _mm256_blendv_epi8(v1, _mm256_cvtps_epi32(_mm256_castsi256_ps(v0)), mask)
-#define VVM_f2i_maxi_AVX(v0, v1)                _mm256_max_epi32(_mm256_cvtps_epi32(_mm256_castsi256_ps(v0)), v1)
-#define VVM_f2i_addi_AVX(v0, v1)                _mm256_min_epi32(_mm256_cvtps_epi32(_mm256_castsi256_ps(v0)), v1)
+#define VVM_sub_cmplt1_AVX(v0, v1, v2)          VVM_cmplt_AVX(v2, _mm256_sub_ps(v0, v1))
+#define VVM_sub_neg_AVX(v0, v1)                 VectorNegate_AVX(_mm256_sub_ps(v0, v1))
+#define VVM_sub_mul_AVX(v0, v1, v2)             _mm256_mul_ps(_mm256_sub_ps(v0, v1), v2)
+#define VVM_div_mad0_AVX(v0, v1, v2, v3)        VVM_madd_AVX(VVM_safeIns_div_AVX(v0, v1), v2, v3)
+#define VVM_div_f2i_AVX(v0, v1)                 VVM_f2i_AVX(VVM_safeIns_div_AVX(VVM_AVX_asf(v0), VVM_AVX_asf(v1)))
+#define VVM_div_mul_AVX(v0, v1, v2)             _mm256_mul_ps(VVM_safeIns_div_AVX(v0, v1), v2)
+#define VVM_muli_addi_AVX(v0, v1, v2)           _mm256_add_epi32(_mm256_mullo_epi32(v0, v1), v2)
+#define VVM_addi_bit_rshift_AVX(v0, v1, v2)     VVMIntRShift_AVX(_mm256_add_epi32(v0, v1), v2)
+#define VVM_addi_muli_AVX(v0, v1, v2)           _mm256_mullo_epi32(_mm256_add_epi32(v0, v1), v2)
+#define VVM_i2f_div0_AVX(v0, v1)                VVM_safeIns_div_AVX(VVM_i2f_AVX(VVM_AVX_asi(v0)), v1)
+#define VVM_i2f_div1_AVX(v0, v1)                VVM_safeIns_div_AVX(v1, VVM_i2f_AVX(VVM_AVX_asi(v0)))
+#define VVM_i2f_mul_AVX(v0, v1)                 _mm256_mul_ps(VVM_i2f_AVX(VVM_AVX_asi(v0)), v1)
+#define VVM_i2f_mad0_AVX(v0, v1, v2)            VVM_madd_AVX(VVM_i2f_AVX(VVM_AVX_asi(v0)), v1, v2)
+#define VVM_i2f_mad1_AVX(v0, v1, v2)            VVM_madd_AVX(v0, v1, VVM_i2f_AVX(VVM_AVX_asi(v2)))
+#define VVM_f2i_select1_AVX(mask, v0, v1)       VVM_selecti_AVX(mask, VVM_f2i_AVX(VVM_AVX_asf(v0)), v1)
+#define VVM_f2i_maxi_AVX(v0, v1)                _mm256_max_epi32(VVM_f2i_AVX(VVM_AVX_asf(v0)), v1)
+#define VVM_f2i_addi_AVX(v0, v1)                _mm256_add_epi32(VVM_f2i_AVX(VVM_AVX_asf(v0)), v1)
 #define VVM_fmod_add_AVX(v0, v1, v2)            _mm256_add_ps(VectorMod_AVX(v0, v1), v2)
-#define VVM_bit_and_i2f_AVX(v0, v1)             _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_castps_si256(v0), _mm256_castps_si256(v1)))
+#define VVM_bit_and_i2f_AVX(v0, v1)             VVM_i2f_AVX(_mm256_and_si256(VVM_AVX_asi(v0), VVM_AVX_asi(v1)))
 #define VVM_bit_rshift_bit_and_AVX(v0, v1, v2)  _mm256_and_si256(VVMIntRShift_AVX(v0, v1), v2)
-#define VVM_neg_cmplt_AVX(v0, v1)               VectorCompareLT_AVX(VectorNegate_AVX(v0), v1)
-#define VVM_bit_or_muli_AVX(v0, v1, v2)         VectorIntMultiply_AVX(_mm256_or_si256(v0, v1), v2)
+#define VVM_neg_cmplt_AVX(v0, v1)               VVM_cmplt_AVX(VectorNegate_AVX(v0), v1)
+#define VVM_bit_or_muli_AVX(v0, v1, v2)         _mm256_mullo_epi32(_mm256_or_si256(v0, v1), v2)
 #define VVM_bit_lshift_bit_or_AVX(v0, v1, v2)   _mm256_or_si256(VVMIntLShift_AVX(v0, v1), v2)
 #define VVM_random_add_AVX(v0, v1)              _mm256_add_ps(VVM_random_AVX(v0), v1)
-#define VVM_max_f2i_AVX(v0, v1)                 _mm256_cvtps_epi32(VectorMax_AVX(_mm256_castsi256_ps(v0), _mm256_castsi256_ps(v1)))
-#define VVM_select_mul_AVX(v0, v1, v2, v3)      _mm256_mul_ps(VectorSelect_AVX(v0, v1, v2), v3)
-#define VVM_select_add_AVX(v0, v1, v2, v3)      _mm256_add_ps(VectorSelect_AVX(v0, v1, v2), v3)
-
-
-//instructions called by the VM, named to match UE's style
-#define VectorAdd_AVX(v0, v1)                   _mm256_add_ps(v0, v1)
-#define VectorSubtract_AVX(v0, v1)              _mm256_sub_ps(v0, v1)
-#define VectorMultiply_AVX(v0, v1)              _mm256_mul_ps(v0, v1)
-#define VectorMultiplyAdd_AVX(v0, v1, v2)       _mm256_fmadd_ps(v0, v1, v2)
-#define VectorAbs_AVX(v)                        VVM_abs_AVX(v)
-#define VectorNegate_AVX(v)                     VVM_neg_AVX(v)
-#define VectorExp_AVX(v)                        exp256_ps(v)
-#define VectorExp2_AVX(v)                       _mm256_exp2_ps(v)
-#define VectorLog2_AVX(v)                       log256_ps(v)
-#define VectorSin_AVX(v)                        sin256_ps(v)
-#define VectorCos_AVX(v)                        cos256_ps(v)
-#define VectorLerp_AVX(v0, v1, v2)              _mm256_fmadd_ps(v1, v2, _mm256_mul_ps(v0, _mm256_sub_ps(VVM_m256Const(One), v2)))
-#define VectorCeil_AVX(v)                       _mm256_ceil_ps(v)
-#define VectorFloor_AVX(v)                      _mm256_floor_ps(v)
-#define VectorTruncate_AVX(v)                   _mm256_round_ps(v, _MM_FROUND_TO_NEG_INF |_MM_FROUND_NO_EXC)
-#define VectorFractional_AVX(v)                 _mm256_sub_ps(v, VectorTruncate_AVX(v))
-#define VectorClamp_AVX(v0, v1, v2)             _mm256_min_ps(_mm256_max_ps(v0, v1), v2)
-#define VectorMin_AVX(v0, v1)                   _mm256_min_ps(v0, v1)
-#define VectorMax_AVX(v0, v1)                   _mm256_max_ps(v0, v1)
-#define VectorRound_AVX(v)                      _mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC)
-#define VectorSign_AVX(v)                       _mm256_blendv_ps(VVM_m256Const(NegativeOne), VVM_m256Const(One), _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GT_OS))
-#define VectorSelect_AVX(m, v0, v1)				VVM_select_AVX(m, v0, v1)
-#define VectorCompareLT_AVX(v0, v1)             VVM_cmplt_AVX(v0, v1)
-#define VectorCompareLE_AVX(v0, v1)             VVM_cmple_AVX(v0, v1)
-#define VectorCompareGT_AVX(v0, v1)             VVM_cmpgt_AVX(v0, v1)
-#define VectorCompareGE_AVX(v0, v1)             VVM_cmpge_AVX(v0, v1)
-#define VectorCompareEQ_AVX(v0, v1)             VVM_cmpeq_AVX(v0, v1)
-#define VectorCompareNE_AVX(v0, v1)             VVM_cmpneq_AVX(v0, v1)
-#define VectorIntAdd_AVX(v0, v1)                _mm256_add_epi32(v0, v1)
-#define VectorIntSubtract_AVX(v0, v1)           _mm256_sub_epi32(v0, v1)
-#define VectorIntMultiply_AVX(v0, v1)           _mm256_unpacklo_epi32(_mm256_shuffle_epi32(_mm256_mul_epu32(v0, v1), _MM_SHUFFLE(0, 0, 2, 0)), _mm256_shuffle_epi32(_mm256_mul_epu32(_mm256_srli_si256(v0, 4), _mm256_srli_si256(v1, 4)), _MM_SHUFFLE(0, 0, 2, 0)))
-#define VectorIntClamp_AVX(v0, v1, v2)          _mm256_min_epi32(_mm256_max_epi32(v0, v1), v2)
-#define VectorIntMin_AVX(v0, v1)                _mm256_min_epi32(v0, v1)
-#define VectorIntMax_AVX(v0, v1)                _mm256_max_epi32(v0, v1)
-#define VectorIntAbs_AVX(v)                     _mm256_abs_epi32(v)
-#define VectorIntNegate_AVX(v)                  _mm256_sub_epi32(_mm256_setzero_si256(), v)
-#define VectorIntSign_AVX(v)                    _mm256_blendv_epi8(VVM_m256iConst(NegativeOne), VVM_m256iConst(One), VVM_cmpgei_AVX(v, _mm256_setzero_si256()))
-#define VectorIntCompareLT_AVX(v0, v1)          VVM_cmplti_AVX(v0, v1)
-#define VectorIntCompareLE_AVX(v0, v1)          VVM_cmplei_AVX(v0, v1)
-#define VectorIntCompareGT_AVX(v0, v1)          VVM_cmpgti_AVX(v0, v1)
-#define VectorIntCompareGE_AVX(v0, v1)          VVM_cmpgei_AVX(v0, v1)
-#define VectorIntCompareEQ_AVX(v0, v1)          VVM_cmpeqi_AVX(v0, v1)
-#define VectorIntCompareNEQ_AVX(v0, v1)         VVM_cmpneqi_AVX(v0, v1)
-#define VectorIntAnd_AVX(v0, v1)                _mm256_and_si256(v0, v1)
-#define VectorIntOr_AVX(v0, v1)                 _mm256_or_si256(v0, v1)
-#define VectorIntXor_AVX(v0, v1)                _mm256_xor_si256(v0, v1)
-#define VectorIntNot_AVX(v)                     _mm256_xor_si256(v, VVM_m256iConst(FMask))
-#define VVMIntLShift_AVX(v0, v1)                _mm256_sllv_epi32(v0, v1)
-#define VVMIntRShift_AVX(v0, v1)                _mm256_srlv_epi32(v0, v1)
-#define VVMf2i_AVX(v)                           _mm256_cvttps_epi32(_mm256_castsi256_ps(v))
-#define VVMi2f_AVX(v)                           _mm256_cvtepi32_ps(_mm256_castps_si256(v))
-#define VVM_sincos_AVX(v, OutSin, OutCos)       sincos256_ps(v, OutSin, OutCos)
-
-static inline __m256 VectorTan_AVX(const __m256 &v)
-{
-	VVMXXMYMMUnion U;
-	U.ymm = v;
-	U.xmm[0] = VectorTan(U.xmm[0]);
-	U.xmm[1] = VectorTan(U.xmm[1]);
-	return U.ymm;
-}
-
-static inline __m256 VectorATan_AVX(const __m256 &v)
-{
-	VVMXXMYMMUnion U;
-	U.ymm = v;
-	U.xmm[0] = VectorATan(U.xmm[0]);
-	U.xmm[1] = VectorATan(U.xmm[1]);
-	return U.ymm;
-}
-
-static inline __m256 VectorATan2_AVX(const __m256 &v0, const __m256 &v1)
-{
-	VVMXXMYMMUnion U0, U1;
-	U0.ymm = v0;
-	U1.ymm = v1;
-	U0.xmm[0] = VectorATan2(U0.xmm[0], U1.xmm[0]);
-	U0.xmm[1] = VectorATan2(U0.xmm[1], U1.xmm[1]);
-	return U0.ymm;
-}
-
-static inline __m256 VectorASin_AVX(const __m256 &v)
-{
-	VVMXXMYMMUnion U;
-	U.ymm = v;
-	U.xmm[0] = VectorASin(U.xmm[0]);
-	U.xmm[1] = VectorASin(U.xmm[1]);
-	return U.ymm;
-}
-
-static inline __m256 VectorMod_AVX(const __m256 &v0, const __m256 &v1)
-{
-	VVMXXMYMMUnion U0, U1;
-	U0.ymm = v0;
-	U1.ymm = v1;
-	U0.xmm[0] = VectorMod(U0.xmm[0], U1.xmm[0]);
-	U0.xmm[1] = VectorMod(U0.xmm[1], U1.xmm[1]);
-	return U0.ymm;
-}
-
-struct FVVM_VU8
-{
-	union
-	{
-		__m256i i8;
-		uint32 o8[8];
-	}
-};
-
-static inline __m256i VVMIntDiv_AVX(const __m256i &X, const __m256i &Y)
-{
-	uint32 *v0_8 = (uint32 *)&X;
-	uint32 *v1_8 = (uint32 *)&Y;
-
-    FVVM_VU8 res;
-
-	res.o8[0] = v1_8[0] == 0 ? 0 : (v0_8[0] / v1_8[0]);
-    res.o8[1] = v1_8[1] == 0 ? 0 : (v0_8[1] / v1_8[1]);
-    res.o8[2] = v1_8[2] == 0 ? 0 : (v0_8[2] / v1_8[2]);
-    res.o8[3] = v1_8[3] == 0 ? 0 : (v0_8[3] / v1_8[3]);
-	res.o8[4] = v1_8[4] == 0 ? 0 : (v0_8[4] / v1_8[4]);
-    res.o8[5] = v1_8[5] == 0 ? 0 : (v0_8[5] / v1_8[5]);
-    res.o8[6] = v1_8[6] == 0 ? 0 : (v0_8[6] / v1_8[6]);
-    res.o8[7] = v1_8[7] == 0 ? 0 : (v0_8[7] / v1_8[7]);
-	
-	return res.i8;
-}
-
+#define VVM_max_f2i_AVX(v0, v1)                 VVM_f2i_AVX(_mm256_max_ps(VVM_AVX_asf(v0), VVM_AVX_asf(v1)))
+#define VVM_select_mul_AVX(v0, v1, v2, v3)      _mm256_mul_ps(VVM_select_AVX(v0, v1, v2), v3)
+#define VVM_select_add_AVX(v0, v1, v2, v3)      _mm256_add_ps(VVM_select_AVX(v0, v1, v2), v3)
 
 #endif //VECTORVM_SUPPORTS_AVX
 
@@ -988,35 +921,6 @@ static void vvmFloatCheck(float **vals, uint8 *inc, int num_vals, int num_instan
 	}
 }
 
-#if VECTORVM_SUPPORTS_AVX
-static void SetRegIncTableFor8WideFrom4Wide(FVectorVMExecContext *ExecCtx, FVectorVMBatchState *BatchState)
-{
-	uint8 *TempRegIncTable  = BatchState->RegIncTable;
-	uint8 *InputRegIncTable = BatchState->RegIncTable + ExecCtx->VVMState->NumTempRegisters + ExecCtx->VVMState->NumConstBuffers;
-	for (uint32 i = 0; i < ExecCtx->VVMState->NumTempRegisters; ++i)
-	{
-		TempRegIncTable[i] <<= 1;
-	}
-	for (uint32 i = 0; i < ExecCtx->VVMState->NumInputBuffers; ++i)
-	{
-		InputRegIncTable[i] <<= 1;
-	}
-}
-
-static void SetRegIncTableFor4WideFrom8Wide(FVectorVMExecContext *ExecCtx, FVectorVMBatchState *BatchState)
-{
-	uint8 *TempRegIncTable  = BatchState->RegIncTable;
-	uint8 *InputRegIncTable = BatchState->RegIncTable + ExecCtx->VVMState->NumTempRegisters + ExecCtx->VVMState->NumConstBuffers;
-	for (uint32 i = 0; i < ExecCtx->VVMState->NumTempRegisters; ++i)
-	{
-		TempRegIncTable[i] >>= 1;
-	}
-	for (uint32 i = 0; i < ExecCtx->VVMState->NumInputBuffers; ++i)
-	{
-		InputRegIncTable[i] >>= 1;
-	}
-}
-#endif //VECTORVM_SUPPORTS_AVX
 static uint8 *SetupBatchStatePtrs(FVectorVMExecContext *ExecCtx, FVectorVMBatchState *BatchState)
 {
 	uint8 *BatchDataPtr        = (uint8 *) VVM_ALIGN_64((size_t)BatchState + sizeof(FVectorVMBatchState));
@@ -1151,18 +1055,6 @@ static void SetupRandStateForBatch(FVectorVMBatchState *BatchState)
 	//use psuedo-pcg to setup a state for xorwow
 	for (int i = 0; i < 5; ++i) //loop for xorwow internal state
 	{
-#		if VECTORVM_SUPPORTS_AVX
-		MS_ALIGN(32) uint32 Values[8] GCC_ALIGN(32);
-		for (int j = 0; j < 8; ++j)
-		{
-			uint64 old_state   = pcg_state;
-			pcg_state          = old_state * 6364136223846793005ULL + pcg_inc;
-			uint32 xor_shifted = (uint32)(((old_state >> 18U) ^ old_state) >> 27U);
-			uint32 rot         = old_state >> 59U;
-			Values[j]          = (xor_shifted >> rot) | (xor_shifted << ((0U - rot) & 31));
-		}
-		_mm256_storeu_si256(BatchState->RandState.AVX.State + i, *(__m256i *)Values);
-#		else
 		MS_ALIGN(16) uint32 Values[4] GCC_ALIGN(16);
 		for (int j = 0; j < 4; ++j)
 		{
@@ -1173,7 +1065,6 @@ static void SetupRandStateForBatch(FVectorVMBatchState *BatchState)
 			Values[j]          = (xor_shifted >> rot) | (xor_shifted << ((0U - rot) & 31));
 		}
 		VectorIntStore(*(VectorRegister4i *)Values, BatchState->RandState.State + i);
-#		endif
 	}
 	BatchState->RandState.Counters = MakeVectorRegisterInt64(pcg_inc, pcg_state);
 	BatchState->RandStream.GenerateNewSeed();
@@ -1196,24 +1087,64 @@ static VectorRegister4i VVMXorwowStep(FVectorVMBatchState *BatchState)
 	return Result;
 }
 #if VECTORVM_SUPPORTS_AVX
-static __m256i VVMXorwowStep_AVX(FVectorVMBatchState *BatchState)
+static bool VVMDetectAVX2()
 {
-	__m256i t = BatchState->RandState.AVX.State[4];
-	__m256i s = BatchState->RandState.AVX.State[0];
-	BatchState->RandState.AVX.State[4] = BatchState->RandState.AVX.State[3];
-	BatchState->RandState.AVX.State[3] = BatchState->RandState.AVX.State[2];
-	BatchState->RandState.AVX.State[2] = BatchState->RandState.AVX.State[1];
-	BatchState->RandState.AVX.State[1] = s;
-	t = _mm256_xor_si256(t, _mm256_srli_epi32(t, 2));
-	t = _mm256_xor_si256(t, _mm256_slli_epi32(t, 1));
-	t = _mm256_xor_si256(t, _mm256_xor_si256(s, _mm256_xor_si256(s, _mm256_slli_epi32(s, 4))));
-	BatchState->RandState.AVX.State[0] = t;
-	BatchState->RandState.AVX.Counters = _mm256_add_epi32(BatchState->RandState.AVX.Counters, _mm256_set1_epi32(362437));
-	__m256i Result = _mm256_add_epi32(t, _mm256_loadu_si256(&BatchState->RandState.AVX.Counters));
-	return Result;
+#	if PLATFORM_WINDOWS
+	return FPlatformMisc::HasAVX2InstructionSupport();
+#	else
+	unsigned int Eax, Ebx, Ecx, Edx;
+	//CPUID.(EAX=01H):ECX.OSXSAVE[bit 27] && ECX.AVX[bit 28]
+	const unsigned int OSXSAVE_AVX_BITS = (1 << 27) | (1 << 28);
+	if (!__get_cpuid(1, &Eax, &Ebx, &Ecx, &Edx) || (Ecx & OSXSAVE_AVX_BITS) != OSXSAVE_AVX_BITS)
+	{
+		return false;
+	}
+	//the OS has to save the xmm and ymm state on context switches
+	unsigned int XCR0Lo, XCR0Hi;
+	__asm__ volatile ("xgetbv" : "=a"(XCR0Lo), "=d"(XCR0Hi) : "c"(0));
+	if ((XCR0Lo & 6) != 6)
+	{
+		return false;
+	}
+	//CPUID.(EAX=07H, ECX=0H):EBX.AVX2[bit 5]
+	return __get_cpuid_count(7, 0, &Eax, &Ebx, &Ecx, &Edx) && (Ebx & (1 << 5)) != 0;
+#	endif
 }
+
+static bool VVMHasAVX2()
+{
+	//run cpuid only once
+	static bool bHasAVX2 = VVMDetectAVX2();
+	return bHasAVX2;
+}
+
+#if PLATFORM_COMPILER_CLANG
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
 #endif
 
+//8-wide random numbers are two steps of the 4-wide generator, low half first, so a batch produces the same sequence whether or not
+//it runs with AVX
+static FORCEINLINE __m256 VVMRandom_AVX(FVectorVMBatchState *BatchState, __m256 v)
+{
+	VectorRegister4f Lo = VVM_random(VVM_AVX_LO(v));
+	VectorRegister4f Hi = VVM_random(VVM_AVX_HI(v));
+	return VVM_AVX_COMBINE(Lo, Hi);
+}
+
+static FORCEINLINE __m256i VVMRandomi_AVX(FVectorVMBatchState *BatchState, __m256i v)
+{
+	VectorRegister4i vLo = VVM_AVXi_LO(v);
+	VectorRegister4i vHi = VVM_AVXi_HI(v);
+	VectorRegister4i Lo  = VVM_randomi(vLo);
+	VectorRegister4i Hi  = VVM_randomi(vHi);
+	return VVM_AVXi_COMBINE(Lo, Hi);
+}
+
+#if PLATFORM_COMPILER_CLANG
+#pragma clang attribute pop
+#endif
+#endif //VECTORVM_SUPPORTS_AVX
+
 VECTORVM_API FVectorVMState *AllocVectorVMState(FVectorVMOptimizeContext *OptimizeCtx) {
 	if (OptimizeCtx == nullptr || OptimizeCtx->Error.Line != 0) {
 		return nullptr;
@@ -1281,7 +1212,8 @@ VECTORVM_API FVectorVMState *AllocVectorVMState(FVectorVMOptimizeContext *Optimi
 	}
 
 #	if VECTORVM_SUPPORTS_AVX
-	{ //@TODO check CPUID stuff the Unreal way here
+	if (VVMHasAVX2())
+	{
 		VVMState->Flags |= VVMFlag_SupportsAVX;
 	}
 #	endif
@@ -1323,7 +1255,6 @@ static void ExecVVMBatch(FVectorVMExecContext *ExecCtx, int ExecIdx, FVectorVMSe
 	VVMRAIIPageHandle PageHandle;
 	FVectorVMBatchState *BatchState = (FVectorVMBatchState *)VVMAllocBatch(ExecCtx->VVMState->BatchOverheadSize + ExecCtx->Internal.PerBatchRegisterDataBytesRequired, &PageHandle);
 
-	bool RegIncSetForAVX = false;
 	if (SetupBatchStatePtrs(ExecCtx, BatchState) == nullptr)
 	{
 		return;
@@ -1350,49 +1281,17 @@ static void ExecVVMBatch(FVectorVMExecContext *ExecCtx, int ExecIdx, FVectorVMSe
 			
 			if (NumLoops == 1)
 			{
-#				if VECTORVM_SUPPORTS_AVX
-				if (RegIncSetForAVX) {
-					SetRegIncTableFor4WideFrom8Wide(ExecCtx, BatchState);
-					RegIncSetForAVX = false;
-				}
-#				endif
 				execChunkSingleLoop(ExecCtx, BatchState, StartInstanceThisChunk, NumInstancesThisChunk, SerializeState, CmpSerializeState);
 			}
-			else if (NumLoops >= 1)
+#			if VECTORVM_SUPPORTS_AVX
+			else if ((ExecCtx->VVMState->Flags & VVMFlag_SupportsAVX) && GbVVMUseAVX2)
 			{
-#				if VECTORVM_SUPPORTS_AVX
-				if (NumLoops >= 4 && (ExecCtx->VVMState->Flags & VVMFlag_SupportsAVX))
-				{
-					//SetupBatchPointers sets the register increment table to 16 bytes, with AVX we want 32 bytes.
-					if (!RegIncSetForAVX)
-					{
-						SetRegIncTableFor8WideFrom4Wide(ExecCtx, BatchState);
-						RegIncSetForAVX = true;
-					}
-					int NumAVXLoops = NumLoops / 2;
-					execChunkMultipleLoopsAVX(ExecCtx, BatchState, StartInstanceThisChunk, NumInstancesThisChunk, NumAVXLoops, SerializeState, CmpSerializeState);
-					if (NumAVXLoops * 2 != NumLoops)
-					{
-						check(false); //does this even work!? need to run it to find out
-						//we have an extra single loop to do at the end
-						NumLoops = 1;
-						SetRegIncTableFor4WideFrom8Wide(ExecCtx, BatchState);
-						RegIncSetForAVX = false;
-						execChunkSingleLoop(ExecCtx, BatchState, NumAVXLoops * 8, NumInstancesThisChunk - NumAVXLoops * 8, SerializeState, CmpSerializeState);
-					}
-				}
-				else 
-				{
-					if (RegIncSetForAVX)
-					{
-						SetRegIncTableFor4WideFrom8Wide(ExecCtx, BatchState);
-						RegIncSetForAVX = false;
-					}
-#				else
-				{
-#				endif
-					execChunkMultipleLoops(ExecCtx, BatchState, StartInstanceThisChunk, NumInstancesThisChunk, NumLoops, SerializeState, CmpSerializeState);
-				}
+				execChunkMultipleLoopsAVX(ExecCtx, BatchState, StartInstanceThisChunk, NumInstancesThisChunk, NumLoops, SerializeState, CmpSerializeState);
+			}
+#			endif
+			else
+			{
+				execChunkMultipleLoops(ExecCtx, BatchState, StartInstanceThisChunk, NumInstancesThisChunk, NumLoops, SerializeState, CmpSerializeState);
 			}
 		}
 	
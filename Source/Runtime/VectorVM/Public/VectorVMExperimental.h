@@ -3,7 +3,10 @@
 
 // HEADER_UNIT_SKIP - Not included directly
 
-#define VECTORVM_SUPPORTS_AVX 0
+//the experimental VM can run 8 instances at a time with AVX2 when the CPU supports it, see vm.UseAVX2
+#ifndef VECTORVM_SUPPORTS_AVX
+#define VECTORVM_SUPPORTS_AVX (PLATFORM_DESKTOP && PLATFORM_CPU_X86_FAMILY && PLATFORM_64BITS && PLATFORM_ENABLE_VECTORINTRINSICS)
+#endif
 #define VECTORVM_SUPPORTS_COMPUTED_GOTO 0
 
 //only to be included by VectorVM.h
@@ -459,12 +462,6 @@ struct FVectorVMBatchState
 			VectorRegister4i          State[5]; //xorwor state for random/randomi instructions.  DIs use RandomStream.
 			VectorRegister4i          Counters;
 		};
-#		if VECTORVM_SUPPORTS_AVX
-		struct {
-			__m256i                   State[5];
-			__m256i                   Counters;
-		} AVX;
-#		endif
 	} RandState;
 	FRandomStream             RandStream;
 };